@@ -25,6 +25,9 @@
 #pragma warning(disable : 4731)
 #endif
 
+#include <stddef.h>
+#include "hook.h"
+
 #define RCT2_ADDRESS(address, type)				((type*)(address))
 #define RCT2_GLOBAL(address, type)				(*((type*)(address)))
 #define RCT2_CALLPROC(address)					(((void(*)())(address))())
@@ -592,6 +595,10 @@
  */
 static int RCT2_CALLPROC_X(int address, int _eax, int _ebx, int _ecx, int _edx, int _esi, int _edi, int _ebp)
 {
+	hook_function nativeFunction = hook_get_native(address);
+	if (nativeFunction != NULL)
+		return nativeFunction(&_eax, &_ebx, &_ecx, &_edx, &_esi, &_edi, &_ebp);
+
 	#ifdef _MSC_VER
 	__asm {
 		push ebp
@@ -651,6 +658,10 @@ static int RCT2_CALLPROC_EBPSAFE(int address)
  */
 static int RCT2_CALLFUNC_X(int address, int *_eax, int *_ebx, int *_ecx, int *_edx, int *_esi, int *_edi, int *_ebp)
 {
+	hook_function nativeFunction = hook_get_native(address);
+	if (nativeFunction != NULL)
+		return nativeFunction(_eax, _ebx, _ecx, _edx, _esi, _edi, _ebp);
+
 	#ifdef _MSC_VER
 	__asm {
 		// Store C's base pointer
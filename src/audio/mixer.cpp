@@ -21,9 +21,14 @@
 #include <math.h>
 #include <SDL.h>
 
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif
+
 extern "C" {
 	#include "../config.h"
 	#include "../platform/platform.h"
+	#include "../util/memtrack.h"
 	#include "audio.h"
 	#include "../localisation/localisation.h"
 }
@@ -125,17 +130,23 @@ bool Source_Sample::LoadCSS1(const char* filename, unsigned int offset)
 	utf8 utf8filename[512];
 	win1252_to_utf8(utf8filename, filename, sizeof(utf8filename));
 
-	Unload();
 	SDL_RWops* rw = SDL_RWFromFile(utf8filename, "rb");
 	if (rw == NULL) {
 		log_verbose("Unable to load %s", filename);
 		return false;
 	}
+	bool result = LoadCSS1(rw, offset);
+	SDL_RWclose(rw);
+	return result;
+}
 
+bool Source_Sample::LoadCSS1(SDL_RWops* rw, unsigned int offset)
+{
+	Unload();
+	SDL_RWseek(rw, 0, RW_SEEK_SET);
 	Uint32 numsounds;
 	SDL_RWread(rw, &numsounds, sizeof(numsounds), 1);
 	if (offset > numsounds) {
-		SDL_RWclose(rw);
 		return false;
 	}
 	SDL_RWseek(rw, offset * 4, RW_SEEK_CUR);
@@ -150,14 +161,12 @@ bool Source_Sample::LoadCSS1(const char* filename, unsigned int offset)
 	format.freq = waveformat.nSamplesPerSec;
 	format.format = AUDIO_S16LSB;
 	format.channels = waveformat.nChannels;
-	data = new (std::nothrow) uint8[length];
+	data = (uint8*)memtrack_alloc(MEMTRACK_TAG_AUDIO, length);
 	if (!data) {
 		log_verbose("Unable to allocate data");
-		SDL_RWclose(rw);
 		return false;
 	}
 	SDL_RWread(rw, data, length, 1);
-	SDL_RWclose(rw);
 	return true;
 }
 
@@ -167,7 +176,7 @@ void Source_Sample::Unload()
 		if (issdlwav) {
 			SDL_FreeWAV(data);
 		} else {
-			delete[] data;
+			memtrack_free(data);
 		}
 		data = 0;
 	}
@@ -183,10 +192,10 @@ bool Source_Sample::Convert(AudioFormat format)
 			return false;
 		}
 		cvt.len = length;
-		cvt.buf = (Uint8*)new uint8[cvt.len * cvt.len_mult];
+		cvt.buf = (Uint8*)memtrack_alloc(MEMTRACK_TAG_AUDIO, cvt.len * cvt.len_mult);
 		memcpy(cvt.buf, data, length);
 		if (SDL_ConvertAudio(&cvt) < 0) {
-			delete[] cvt.buf;
+			memtrack_free(cvt.buf);
 			return false;
 		}
 		Unload();
@@ -198,12 +207,28 @@ bool Source_Sample::Convert(AudioFormat format)
 	return false;
 }
 
+// Number of bytes of music kept read ahead of the audio callback and the
+// amount the fill thread reads from the file in one go. 256kB is roughly
+// 1.5 seconds at 44.1kHz 16-bit stereo, enough to ride out an autosave or
+// object load hitting the disk.
+#define STREAM_RING_SIZE (256 * 1024)
+#define STREAM_RING_CHUNK (16 * 1024)
+
 Source_SampleStream::Source_SampleStream()
 {
 	length = 0;
 	rw = NULL;
 	buffer = 0;
 	buffersize = 0;
+	ring = 0;
+	ringreadpos = 0;
+	ringlength = 0;
+	ringstreamoffset = 0;
+	filloffset = 0;
+	seekrequest = -1;
+	fillthreadrunning = false;
+	ringmutex = NULL;
+	fillthread = NULL;
 }
 
 Source_SampleStream::~Source_SampleStream()
@@ -215,14 +240,59 @@ unsigned long Source_SampleStream::Read(unsigned long offset, const uint8** data
 {
 	if (length > buffersize) {
 		if (buffer) {
-			delete[] buffer;
+			memtrack_free(buffer);
 		}
-		buffer = new (std::nothrow) uint8[length];
+		buffer = (uint8*)memtrack_alloc(MEMTRACK_TAG_AUDIO, length);
 		if (!buffer) {
 			return 0;
 		}
 		buffersize = length;
 	}
+
+	if (ring != NULL && fillthreadrunning) {
+		unsigned long copied = 0;
+		SDL_LockMutex(ringmutex);
+		if (ringstreamoffset == Length()) {
+			// Looping playback starts over; the fill thread appends the
+			// start of the track straight after the end
+			ringstreamoffset = 0;
+		}
+		if (offset != ringstreamoffset) {
+			// Playback jumped; drop the ring and have the fill thread start
+			// over from the new position
+			seekrequest = (long)offset;
+			ringstreamoffset = offset;
+			ringreadpos = 0;
+			ringlength = 0;
+		} else {
+			copied = length;
+			if (copied > ringlength) {
+				copied = ringlength;
+			}
+			unsigned long first = copied;
+			if (first > STREAM_RING_SIZE - ringreadpos) {
+				first = STREAM_RING_SIZE - ringreadpos;
+			}
+			memcpy(buffer, &ring[ringreadpos], first);
+			if (copied > first) {
+				memcpy(&buffer[first], ring, copied - first);
+			}
+			ringreadpos = (ringreadpos + copied) % STREAM_RING_SIZE;
+			ringlength -= copied;
+			ringstreamoffset += copied;
+		}
+		SDL_UnlockMutex(ringmutex);
+
+		// On a seek or an underrun this returns 0, mixing a moment of
+		// silence instead of blocking the audio callback on the disk
+		if (copied == 0) {
+			return 0;
+		}
+		*data = buffer;
+		return copied;
+	}
+
+	// No ring buffer could be set up; read from the file directly
 	Sint64 currentposition = SDL_RWtell(rw);
 	if (currentposition == -1) {
 		return 0;
@@ -242,6 +312,70 @@ unsigned long Source_SampleStream::Read(unsigned long offset, const uint8** data
 	return read;
 }
 
+int SDLCALL Source_SampleStream::FillThreadEntry(void* arg)
+{
+	((Source_SampleStream*)arg)->FillLoop();
+	return 0;
+}
+
+void Source_SampleStream::FillLoop()
+{
+	uint8 chunk[STREAM_RING_CHUNK];
+
+	while (fillthreadrunning) {
+		SDL_LockMutex(ringmutex);
+		if (seekrequest != -1) {
+			filloffset = (unsigned long)seekrequest;
+			seekrequest = -1;
+		}
+		unsigned long space = STREAM_RING_SIZE - ringlength;
+		SDL_UnlockMutex(ringmutex);
+
+		if (space < STREAM_RING_CHUNK) {
+			SDL_Delay(10);
+			continue;
+		}
+
+		unsigned long toread = STREAM_RING_CHUNK;
+		if (toread > Length() - filloffset) {
+			toread = Length() - filloffset;
+		}
+		int read = 0;
+		if (toread > 0) {
+			if (SDL_RWseek(rw, databegin + filloffset, RW_SEEK_SET) == -1) {
+				SDL_Delay(100);
+				continue;
+			}
+			read = SDL_RWread(rw, chunk, 1, toread);
+		}
+		if (read <= 0) {
+			// End of the data chunk; looping playback continues at the start
+			filloffset = 0;
+			SDL_Delay(10);
+			continue;
+		}
+
+		SDL_LockMutex(ringmutex);
+		if (seekrequest == -1) {
+			unsigned long writepos = (ringreadpos + ringlength) % STREAM_RING_SIZE;
+			unsigned long first = read;
+			if (first > STREAM_RING_SIZE - writepos) {
+				first = STREAM_RING_SIZE - writepos;
+			}
+			memcpy(&ring[writepos], chunk, first);
+			if ((unsigned long)read > first) {
+				memcpy(ring, &chunk[first], read - first);
+			}
+			ringlength += read;
+			filloffset += read;
+			if (filloffset >= Length()) {
+				filloffset = 0;
+			}
+		}
+		SDL_UnlockMutex(ringmutex);
+	}
+}
+
 bool Source_SampleStream::LoadWAV(SDL_RWops* rw)
 {
 	Unload();
@@ -298,6 +432,23 @@ bool Source_SampleStream::LoadWAV(SDL_RWops* rw)
 	}
 	length = datachunk_size;
 	databegin = SDL_RWtell(rw);
+
+	// Start reading ahead of playback; if the ring cannot be set up the
+	// stream falls back to reading in the audio callback as before
+	ring = (uint8*)memtrack_alloc(MEMTRACK_TAG_AUDIO, STREAM_RING_SIZE);
+	if (ring) {
+		ringmutex = SDL_CreateMutex();
+		ringreadpos = 0;
+		ringlength = 0;
+		ringstreamoffset = 0;
+		filloffset = 0;
+		seekrequest = -1;
+		fillthreadrunning = true;
+		fillthread = SDL_CreateThread(FillThreadEntry, "OpenRCT2 music stream", this);
+		if (fillthread == NULL) {
+			fillthreadrunning = false;
+		}
+	}
 	return true;
 }
 
@@ -325,13 +476,26 @@ Uint32 Source_SampleStream::FindChunk(SDL_RWops* rw, Uint32 wanted_id)
 
 void Source_SampleStream::Unload()
 {
+	if (fillthread) {
+		fillthreadrunning = false;
+		SDL_WaitThread(fillthread, NULL);
+		fillthread = NULL;
+	}
+	if (ringmutex) {
+		SDL_DestroyMutex(ringmutex);
+		ringmutex = NULL;
+	}
+	if (ring) {
+		memtrack_free(ring);
+		ring = 0;
+	}
 	if (rw) {
 		SDL_RWclose(rw);
 		rw = NULL;
 	}
 	length = 0;
 	if (buffer) {
-		delete[] buffer;
+		memtrack_free(buffer);
 		buffer = 0;
 	}
 	buffersize = 0;
@@ -340,6 +504,7 @@ void Source_SampleStream::Unload()
 Channel::Channel()
 {
 	resampler = 0;
+	cachedrate = 1;
 	SetRate(1);
 	SetVolume(SDL_MIX_MAXVOLUME);
 	oldvolume = 0;
@@ -348,6 +513,7 @@ Channel::Channel()
 	SetPan(0.5f);
 	done = true;
 	stopping = false;
+	virtualized = false;
 	source = 0;
 	deletesourceondone = false;
 }
@@ -373,7 +539,13 @@ void Channel::Play(Source& source, int loop = MIXER_LOOP_NONE)
 
 void Channel::SetRate(double rate)
 {
-	Channel::rate = rate;
+	// A source that the sample cache already resampled plays back at
+	// cachedrate, so only the remaining ratio is applied at mix time
+	Channel::rate = rate / cachedrate;
+	if (fabs(Channel::rate - 1.0) < 0.005) {
+		// Under a tenth of a semitone off; not worth the resampler
+		Channel::rate = 1;
+	}
 	if (Channel::rate < 0.001) {
 		Channel::rate = 0.001;
 	}
@@ -433,53 +605,225 @@ bool Channel::SetOffset(unsigned long offset)
 Mixer::Mixer()
 {
 	effectbuffer = 0;
+	deviceid = 0;
+	hasdevicename = false;
+	buffersamples = 0;
+	callbackbudgetus = 0;
+	statcallbacks = 0;
+	statcallbacktotalus = 0;
+	statcallbackpeakus = 0;
+	statunderruns = 0;
+	lifetimeunderruns = 0;
+	tunelastunderruns = 0;
+	tunerecentunderruns = 0;
+	tunecleanticks = 0;
+	startuptuned = false;
 	for (int i = 0; i < countof(css1sources); i++) {
 		css1sources[i] = 0;
 	}
 	for (int i = 0; i < countof(musicsources); i++) {
 		musicsources[i] = 0;
 	}
+	for (int i = 0; i < MIXER_CHANNEL_SLOTS; i++) {
+		channels[i] = 0;
+	}
+	for (int i = 0; i < MIXER_SAMPLE_CACHE_SLOTS; i++) {
+		samplecache[i].source = 0;
+	}
+	samplecacheticks = 0;
 }
 
 void Mixer::Init(const char* device)
 {
 	Close();
+	hasdevicename = false;
+	if (device != NULL) {
+		strncpy(devicename, device, sizeof(devicename) - 1);
+		devicename[sizeof(devicename) - 1] = 0;
+		hasdevicename = true;
+	}
+	int samples = gConfigSound.audio_buffer_samples;
+	if (samples == 0) {
+		// Auto tuned; start in the middle of the range, Update() resizes from
+		// measured callback timing
+		samples = MIXER_BUFFER_SAMPLES_DEFAULT;
+	}
+	samples = clamp(MIXER_BUFFER_SAMPLES_MIN, samples, MIXER_BUFFER_SAMPLES_MAX);
+	statcallbacks = 0;
+	statcallbacktotalus = 0;
+	statcallbackpeakus = 0;
+	statunderruns = 0;
+	lifetimeunderruns = 0;
+	tunelastunderruns = 0;
+	tunerecentunderruns = 0;
+	tunecleanticks = 0;
+	startuptuned = false;
+	OpenDevice(samples);
+	// Load the entire sound effect bank up front from one pass over the
+	// file, so playback never has to touch the disk; music is the only
+	// thing still streamed
+	const char* filename = get_file_path(PATH_ID_CSS1);
+	utf8 utf8filename[512];
+	win1252_to_utf8(utf8filename, filename, sizeof(utf8filename));
+	SDL_RWops* rw = SDL_RWFromFile(utf8filename, "rb");
+	if (rw == NULL) {
+		log_verbose("Unable to load %s", filename);
+	}
+	for (int i = 0; i < countof(css1sources); i++) {
+		Source_Sample* source_sample = new Source_Sample;
+		if (rw != NULL && source_sample->LoadCSS1(rw, i)) {
+			source_sample->Convert(format); // convert to audio output format, saves some cpu usage but requires a bit more memory, optional
+			css1sources[i] = source_sample;
+		} else {
+			css1sources[i] = &source_null;
+			delete source_sample;
+		}
+	}
+	if (rw != NULL) {
+		SDL_RWclose(rw);
+	}
+	SDL_PauseAudioDevice(deviceid, 0);
+}
+
+/**
+ * Opens the audio device with the given buffer size and sizes the mix
+ * scratch buffer to match. The format is pinned so pre-converted sources
+ * stay valid across a buffer resize.
+ */
+bool Mixer::OpenDevice(int samples)
+{
 	SDL_AudioSpec want, have;
 	SDL_zero(want);
 	want.freq = 44100;
 	want.format = AUDIO_S16SYS;
 	want.channels = 2;
-	want.samples = 1024;
+	want.samples = samples;
 	want.callback = Callback;
 	want.userdata = this;
-	deviceid = SDL_OpenAudioDevice(device, 0, &want, &have, 0);
+	deviceid = SDL_OpenAudioDevice(hasdevicename ? devicename : NULL, 0, &want, &have, 0);
+	if (deviceid == 0) {
+		return false;
+	}
 	format.format = have.format;
 	format.channels = have.channels;
 	format.freq = have.freq;
-	const char* filename = get_file_path(PATH_ID_CSS1);
-	for (int i = 0; i < countof(css1sources); i++) {
-		Source_Sample* source_sample = new Source_Sample;
-		if (source_sample->LoadCSS1(filename, i)) {
-			source_sample->Convert(format); // convert to audio output format, saves some cpu usage but requires a bit more memory, optional
-			css1sources[i] = source_sample;
+	// The driver may round the buffer size; budget from what it actually gave
+	buffersamples = have.samples;
+	callbackbudgetus = (uint32)(((uint64)have.samples * 1000000) / have.freq);
+	effectbuffer = (uint8*)memtrack_alloc(MEMTRACK_TAG_AUDIO, have.samples * format.BytesPerSample() * format.channels);
+	return true;
+}
+
+/**
+ * Reopens the audio device with a new buffer size. Channel slots are left
+ * alone; no callback runs between the close and the reopen, so playing
+ * sounds carry straight on from their current offsets.
+ */
+void Mixer::SetBufferSize(int samples)
+{
+	if (deviceid != 0) {
+		SDL_CloseAudioDevice(deviceid);
+		deviceid = 0;
+	}
+	if (effectbuffer) {
+		memtrack_free(effectbuffer);
+		effectbuffer = 0;
+	}
+	lifetimeunderruns += statunderruns;
+	statcallbacks = 0;
+	statcallbacktotalus = 0;
+	statcallbackpeakus = 0;
+	statunderruns = 0;
+	tunelastunderruns = 0;
+	tunerecentunderruns = 0;
+	tunecleanticks = 0;
+	if (!OpenDevice(samples)) {
+		return;
+	}
+	SDL_PauseAudioDevice(deviceid, 0);
+	log_verbose("audio buffer resized to %d samples", buffersamples);
+}
+
+/**
+ * Buffer tuning, called once per logic tick from the main loop. Shortly
+ * after startup the buffer is shrunk if measured callback timing shows the
+ * machine can afford the latency win; after that sustained underruns grow
+ * the buffer and a long clean stretch with plenty of headroom shrinks it
+ * again. A non zero audio_buffer_samples pins the size and disables tuning.
+ */
+void Mixer::Update()
+{
+	uint32 underruns, callbacks, peakUs;
+
+	if (deviceid == 0 || gConfigSound.audio_buffer_samples != 0) {
+		return;
+	}
+
+	underruns = statunderruns;
+	callbacks = statcallbacks;
+	peakUs = statcallbackpeakus;
+
+	if (!startuptuned) {
+		// Let the mix settle for about a second of audio before judging it
+		if (callbacks < 48) {
+			return;
+		}
+		startuptuned = true;
+		if (underruns == 0 && buffersamples > MIXER_BUFFER_SAMPLES_MIN
+			&& peakUs * 4 < callbackbudgetus / 2) {
+			SetBufferSize(buffersamples / 2);
+		}
+		return;
+	}
+
+	if (underruns != tunelastunderruns) {
+		tunerecentunderruns += underruns - tunelastunderruns;
+		tunelastunderruns = underruns;
+		tunecleanticks = 0;
+	} else {
+		tunecleanticks++;
+	}
+
+	// Repeated underruns: the mix is not keeping up, trade latency for safety
+	if (tunerecentunderruns >= 3 && buffersamples < MIXER_BUFFER_SAMPLES_MAX) {
+		SetBufferSize(buffersamples * 2);
+		return;
+	}
+
+	// A clean minute with the worst callback comfortably inside half the
+	// budget: claw the latency back
+	if (tunecleanticks >= 2400 && buffersamples > MIXER_BUFFER_SAMPLES_MIN) {
+		if (peakUs * 4 < callbackbudgetus / 2) {
+			SetBufferSize(buffersamples / 2);
 		} else {
-			css1sources[i] = &source_null;
-			delete source_sample;
+			tunerecentunderruns = 0;
+			tunecleanticks = 0;
 		}
 	}
-	effectbuffer = new uint8[(have.samples * format.BytesPerSample() * format.channels)];
-	SDL_PauseAudioDevice(deviceid, 0);
+}
+
+void Mixer::GetStats(uint32* bufferSamples, uint32* underruns, uint32* callbackPeakUs, uint32* callbackAvgUs)
+{
+	uint32 callbacks = statcallbacks;
+	*bufferSamples = (uint32)buffersamples;
+	*underruns = lifetimeunderruns + statunderruns;
+	*callbackPeakUs = statcallbackpeakus;
+	*callbackAvgUs = callbacks == 0 ? 0 : statcallbacktotalus / callbacks;
 }
 
 void Mixer::Close()
 {
 	Lock();
-	while (channels.begin() != channels.end()) {
-		delete *(channels.begin());
-		channels.erase(channels.begin());
+	for (int i = 0; i < MIXER_CHANNEL_SLOTS; i++) {
+		Channel* channel = (Channel*)SDL_AtomicGetPtr((void**)&channels[i]);
+		if (channel) {
+			SDL_AtomicSetPtr((void**)&channels[i], 0);
+			delete channel;
+		}
 	}
 	Unlock();
 	SDL_CloseAudioDevice(deviceid);
+	deviceid = 0;
 	for (int i = 0; i < countof(css1sources); i++) {
 		if (css1sources[i] && css1sources[i] != &source_null) {
 			delete css1sources[i];
@@ -492,8 +836,14 @@ void Mixer::Close()
 			musicsources[i] = 0;
 		}
 	}
+	for (int i = 0; i < MIXER_SAMPLE_CACHE_SLOTS; i++) {
+		if (samplecache[i].source) {
+			delete samplecache[i].source;
+			samplecache[i].source = 0;
+		}
+	}
 	if (effectbuffer) {
-		delete[] effectbuffer;
+		memtrack_free(effectbuffer);
 		effectbuffer = 0;
 	}
 }
@@ -510,19 +860,159 @@ void Mixer::Unlock()
 
 Channel* Mixer::Play(Source& source, int loop, bool deleteondone, bool deletesourceondone)
 {
-	Lock();
 	Channel* newchannel = new (std::nothrow) Channel;
 	if (newchannel) {
 		newchannel->Play(source, loop);
 		newchannel->deleteondone = deleteondone;
 		newchannel->deletesourceondone = deletesourceondone;
 		newchannel->stopping = false;
-		channels.push_back(newchannel);
+		if (!PublishChannel(newchannel)) {
+			delete newchannel;
+			newchannel = 0;
+		}
+	}
+	return newchannel;
+}
+
+Channel* Mixer::PlayEffect(int id, int loop, bool deleteondone, int volume, float pan, double rate)
+{
+	Source* source = css1sources[id];
+	double cachedrate = 1;
+	// Quantise the rate so nearby pitches share one cache entry; 1/128
+	// steps are well under an audible difference at these rates
+	double snappedrate = (double)((int)(rate * 128 + 0.5)) / 128;
+	if (snappedrate != 1 && format.format == AUDIO_S16SYS) {
+		Source* resampled = GetResampledSample(id, snappedrate);
+		if (resampled) {
+			source = resampled;
+			cachedrate = snappedrate;
+		}
+	}
+	Channel* newchannel = new (std::nothrow) Channel;
+	if (newchannel) {
+		newchannel->Play(*source, loop);
+		newchannel->deleteondone = deleteondone;
+		newchannel->deletesourceondone = false;
+		newchannel->stopping = false;
+		newchannel->cachedrate = cachedrate;
+		newchannel->SetVolume(volume);
+		newchannel->SetPan(pan);
+		newchannel->SetRate(rate);
+		if (!PublishChannel(newchannel)) {
+			delete newchannel;
+			newchannel = 0;
+		}
 	}
-	Unlock();
 	return newchannel;
 }
 
+bool Mixer::PublishChannel(Channel* channel)
+{
+	// Claim a free slot with a compare-and-swap; the channel is fully
+	// initialised before it is published, so the audio callback is never
+	// blocked by a sound starting
+	for (int i = 0; i < MIXER_CHANNEL_SLOTS; i++) {
+		if (SDL_AtomicCASPtr((void**)&channels[i], 0, channel)) {
+			return true;
+		}
+	}
+	// All slots busy, drop the sound
+	return false;
+}
+
+Source* Mixer::GetResampledSample(int id, double rate)
+{
+	for (int i = 0; i < MIXER_SAMPLE_CACHE_SLOTS; i++) {
+		if (samplecache[i].source && samplecache[i].id == id && samplecache[i].rate == rate) {
+			samplecache[i].lastused = ++samplecacheticks;
+			return samplecache[i].source;
+		}
+	}
+
+	Source* base = css1sources[id];
+	if (!base || base == &source_null || MustConvert(*base) || base->Format().format != AUDIO_S16SYS) {
+		return 0;
+	}
+	const uint8* data = 0;
+	if (base->GetSome(0, &data, base->Length()) != base->Length()) {
+		return 0;
+	}
+	int samplesize = format.channels * format.BytesPerSample();
+	int in_frames = base->Length() / samplesize;
+	int out_frames = (int)(in_frames / rate);
+	if (in_frames == 0 || out_frames == 0) {
+		return 0;
+	}
+	uint8* resampleddata = (uint8*)memtrack_alloc(MEMTRACK_TAG_AUDIO, out_frames * samplesize);
+	if (!resampleddata) {
+		return 0;
+	}
+	SpeexResamplerState* resampler = speex_resampler_init(format.channels, format.freq, format.freq, 0, 0);
+	if (!resampler) {
+		memtrack_free(resampleddata);
+		return 0;
+	}
+	speex_resampler_set_rate(resampler, in_frames, out_frames);
+	spx_uint32_t in_len = in_frames;
+	spx_uint32_t out_len = out_frames;
+	speex_resampler_process_interleaved_int(resampler, (const spx_int16_t*)data, &in_len, (spx_int16_t*)resampleddata, &out_len);
+	speex_resampler_destroy(resampler);
+
+	Source_Sample* source_sample = new (std::nothrow) Source_Sample;
+	if (!source_sample) {
+		memtrack_free(resampleddata);
+		return 0;
+	}
+	source_sample->data = resampleddata;
+	source_sample->length = out_len * samplesize;
+	source_sample->format = format;
+	source_sample->issdlwav = false;
+
+	// Pick an empty cache slot, or evict the least recently used entry that
+	// no live channel is still playing from
+	Lock();
+	int slot = -1;
+	for (int i = 0; i < MIXER_SAMPLE_CACHE_SLOTS; i++) {
+		if (!samplecache[i].source) {
+			slot = i;
+			break;
+		}
+	}
+	if (slot == -1) {
+		for (int i = 0; i < MIXER_SAMPLE_CACHE_SLOTS; i++) {
+			bool inuse = false;
+			for (int j = 0; j < MIXER_CHANNEL_SLOTS; j++) {
+				Channel* channel = (Channel*)SDL_AtomicGetPtr((void**)&channels[j]);
+				if (channel && channel->source == samplecache[i].source) {
+					inuse = true;
+					break;
+				}
+			}
+			if (inuse) {
+				continue;
+			}
+			if (slot == -1 || samplecache[i].lastused < samplecache[slot].lastused) {
+				slot = i;
+			}
+		}
+	}
+	if (slot == -1) {
+		// Every entry is being played right now
+		Unlock();
+		delete source_sample;
+		return 0;
+	}
+	if (samplecache[slot].source) {
+		delete samplecache[slot].source;
+	}
+	samplecache[slot].source = source_sample;
+	samplecache[slot].id = id;
+	samplecache[slot].rate = rate;
+	samplecache[slot].lastused = ++samplecacheticks;
+	Unlock();
+	return source_sample;
+}
+
 void Mixer::Stop(Channel& channel)
 {
 	Lock();
@@ -554,16 +1044,76 @@ bool Mixer::LoadMusic(int pathid)
 void SDLCALL Mixer::Callback(void* arg, uint8* stream, int length)
 {
 	Mixer* mixer = (Mixer*)arg;
+	Channel* active[MIXER_CHANNEL_SLOTS];
+	int loudness[MIXER_CHANNEL_SLOTS];
+	int slot[MIXER_CHANNEL_SLOTS];
+	int i, j, numActive = 0, numAudible = 0, mixFloor;
+	uint64 callbackStart = SDL_GetPerformanceCounter();
+
 	memset(stream, 0, length);
-	std::list<Channel*>::iterator i = mixer->channels.begin();
-	while (i != mixer->channels.end()) {
-		mixer->MixChannel(*(*i), stream, length);
-		if (((*i)->done && (*i)->deleteondone) || (*i)->stopping) {
-			delete (*i);
-			i = mixer->channels.erase(i);
+
+	// Channel virtualization: rank the active channels by effective volume
+	// (volume after pan attenuation) so that inaudible channels and, past the
+	// mixed channel cap, the quietest ones only have their position advanced
+	// instead of being resampled and mixed
+	for (i = 0; i < MIXER_CHANNEL_SLOTS; i++) {
+		Channel* channel = (Channel*)SDL_AtomicGetPtr((void**)&mixer->channels[i]);
+		if (!channel) {
+			continue;
+		}
+		active[numActive] = channel;
+		slot[numActive] = i;
+		loudness[numActive] = (int)(channel->volume * max(channel->volume_l, channel->volume_r));
+		if (loudness[numActive] >= MIXER_VIRTUALIZE_VOLUME)
+			numAudible++;
+		numActive++;
+	}
+
+	// When over the cap, find the loudness of the cap-th loudest channel;
+	// only channels at or above it get mixed
+	mixFloor = MIXER_VIRTUALIZE_VOLUME;
+	if (numAudible > MIXER_MAX_MIXED_CHANNELS) {
+		int topLoudness[MIXER_MAX_MIXED_CHANNELS];
+		int numTop = 0;
+		for (i = 0; i < numActive; i++) {
+			if (loudness[i] < MIXER_VIRTUALIZE_VOLUME)
+				continue;
+			// Insertion sort, descending; overflow drops off the end
+			for (j = min(numTop, MIXER_MAX_MIXED_CHANNELS - 1); j > 0 && topLoudness[j - 1] < loudness[i]; j--)
+				topLoudness[j] = topLoudness[j - 1];
+			topLoudness[j] = loudness[i];
+			if (numTop < MIXER_MAX_MIXED_CHANNELS)
+				numTop++;
+		}
+		mixFloor = topLoudness[numTop - 1];
+	}
+
+	for (i = 0; i < numActive; i++) {
+		Channel* channel = active[i];
+		if (loudness[i] >= mixFloor) {
+			channel->virtualized = false;
+			mixer->MixChannel(*channel, stream, length);
 		} else {
-			i++;
+			mixer->AdvanceChannel(*channel, length);
 		}
+		if ((channel->done && channel->deleteondone) || channel->stopping) {
+			// Release the slot before freeing so the game thread can claim
+			// it for a new sound straight away
+			SDL_AtomicSetPtr((void**)&mixer->channels[slot[i]], 0);
+			delete channel;
+		}
+	}
+
+	// A callback that took longer than the real time its buffer covers means
+	// the device ran dry before the next one could start
+	uint32 elapsedUs = (uint32)(((SDL_GetPerformanceCounter() - callbackStart) * 1000000) / SDL_GetPerformanceFrequency());
+	mixer->statcallbacks++;
+	mixer->statcallbacktotalus += elapsedUs;
+	if (elapsedUs > mixer->statcallbackpeakus) {
+		mixer->statcallbackpeakus = elapsedUs;
+	}
+	if (elapsedUs > mixer->callbackbudgetus) {
+		mixer->statunderruns++;
 	}
 }
 
@@ -711,12 +1261,81 @@ void Mixer::MixChannel(Channel& channel, uint8* data, int length)
 	}
 }
 
+/**
+ * Position-only update for a virtualized channel: moves the stream offset as
+ * far as MixChannel would have without reading, resampling or mixing any
+ * data, so the sound picks up at the right spot when it becomes audible
+ * again. The old volumes are held at zero so revival fades in over one
+ * callback instead of clicking.
+ */
+void Mixer::AdvanceChannel(Channel& channel, int length)
+{
+	if (channel.source && channel.source->Length() > 0 && !channel.done) {
+		AudioFormat streamformat = channel.source->Format();
+		int samplesize = format.channels * format.BytesPerSample();
+		int sourcesamplesize = streamformat.channels * streamformat.BytesPerSample();
+		int samples = length / samplesize;
+		double rate = 1;
+		if (format.format == AUDIO_S16SYS) {
+			rate = channel.rate;
+		}
+
+		unsigned long advance = (unsigned long)(samples * rate * streamformat.freq / format.freq) * sourcesamplesize;
+		channel.offset += advance;
+		while (channel.loop != 0 && channel.offset >= channel.source->Length()) {
+			if (channel.loop != -1) {
+				channel.loop--;
+			}
+			channel.offset -= channel.source->Length();
+		}
+		if (channel.loop == 0 && channel.offset >= channel.source->Length()) {
+			channel.offset = channel.source->Length();
+			channel.done = true;
+		}
+
+		channel.virtualized = true;
+		channel.oldvolume = 0;
+		channel.oldvolume_l = 0;
+		channel.oldvolume_r = 0;
+	}
+}
+
 void Mixer::EffectPanS16(Channel& channel, sint16* data, int length)
 {
-	for (int i = 0; i < length * 2; i += 2) {
-		float t = (float)i / (length * 2);
-		data[i] = (sint16)(data[i] * ((1.0 - t) * channel.oldvolume_l + t * channel.volume_l));
-		data[i + 1] = (sint16)(data[i + 1] * ((1.0 - t) * channel.oldvolume_r + t * channel.volume_r));
+	// Interpolate the left/right gains incrementally instead of deriving
+	// them from scratch for every frame
+	float gain_l = channel.oldvolume_l;
+	float gain_r = channel.oldvolume_r;
+	const float step_l = (channel.volume_l - channel.oldvolume_l) / length;
+	const float step_r = (channel.volume_r - channel.oldvolume_r) / length;
+	int i = 0;
+
+#ifdef __SSE2__
+	// Four interleaved stereo frames per iteration; each float lane carries
+	// the ramped gain for its sample
+	const __m128i vZero = _mm_setzero_si128();
+	const __m128 vStep = _mm_setr_ps(step_l * 4, step_r * 4, step_l * 4, step_r * 4);
+	__m128 vGain01 = _mm_setr_ps(gain_l, gain_r, gain_l + step_l, gain_r + step_r);
+	__m128 vGain23 = _mm_setr_ps(gain_l + step_l * 2, gain_r + step_r * 2, gain_l + step_l * 3, gain_r + step_r * 3);
+	for (; i + 8 <= length * 2; i += 8) {
+		__m128i v = _mm_loadu_si128((__m128i*)&data[i]);
+		__m128i vLo = _mm_srai_epi32(_mm_unpacklo_epi16(vZero, v), 16);
+		__m128i vHi = _mm_srai_epi32(_mm_unpackhi_epi16(vZero, v), 16);
+		__m128 vfLo = _mm_mul_ps(_mm_cvtepi32_ps(vLo), vGain01);
+		__m128 vfHi = _mm_mul_ps(_mm_cvtepi32_ps(vHi), vGain23);
+		_mm_storeu_si128((__m128i*)&data[i], _mm_packs_epi32(_mm_cvttps_epi32(vfLo), _mm_cvttps_epi32(vfHi)));
+		vGain01 = _mm_add_ps(vGain01, vStep);
+		vGain23 = _mm_add_ps(vGain23, vStep);
+	}
+	gain_l += step_l * (i / 2);
+	gain_r += step_r * (i / 2);
+#endif
+
+	for (; i < length * 2; i += 2) {
+		data[i] = (sint16)(data[i] * gain_l);
+		data[i + 1] = (sint16)(data[i + 1] * gain_r);
+		gain_l += step_l;
+		gain_r += step_r;
 	}
 }
 
@@ -731,11 +1350,32 @@ void Mixer::EffectPanU8(Channel& channel, uint8* data, int length)
 
 void Mixer::EffectFadeS16(sint16* data, int length, int startvolume, int endvolume)
 {
-	float startvolume_f = (float)startvolume / SDL_MIX_MAXVOLUME;
-	float endvolume_f = (float)endvolume / SDL_MIX_MAXVOLUME;
-	for (int i = 0; i < length; i++) {
-		float t = (float)i / length;
-		data[i] = (sint16)(data[i] * ((1 - t) * startvolume_f + t * endvolume_f));
+	float gain = (float)startvolume / SDL_MIX_MAXVOLUME;
+	const float step = (((float)endvolume / SDL_MIX_MAXVOLUME) - gain) / length;
+	int i = 0;
+
+#ifdef __SSE2__
+	// Eight samples per iteration with per-lane ramped gains
+	const __m128i vZero = _mm_setzero_si128();
+	const __m128 vStep = _mm_set_ps1(step * 8);
+	__m128 vGainLo = _mm_setr_ps(gain, gain + step, gain + step * 2, gain + step * 3);
+	__m128 vGainHi = _mm_setr_ps(gain + step * 4, gain + step * 5, gain + step * 6, gain + step * 7);
+	for (; i + 8 <= length; i += 8) {
+		__m128i v = _mm_loadu_si128((__m128i*)&data[i]);
+		__m128i vLo = _mm_srai_epi32(_mm_unpacklo_epi16(vZero, v), 16);
+		__m128i vHi = _mm_srai_epi32(_mm_unpackhi_epi16(vZero, v), 16);
+		__m128 vfLo = _mm_mul_ps(_mm_cvtepi32_ps(vLo), vGainLo);
+		__m128 vfHi = _mm_mul_ps(_mm_cvtepi32_ps(vHi), vGainHi);
+		_mm_storeu_si128((__m128i*)&data[i], _mm_packs_epi32(_mm_cvttps_epi32(vfLo), _mm_cvttps_epi32(vfHi)));
+		vGainLo = _mm_add_ps(vGainLo, vStep);
+		vGainHi = _mm_add_ps(vGainHi, vStep);
+	}
+	gain += step * i;
+#endif
+
+	for (; i < length; i++) {
+		data[i] = (sint16)(data[i] * gain);
+		gain += step;
 	}
 }
 
@@ -779,20 +1419,22 @@ void Mixer_Init(const char* device)
 	gMixer.Init(device);
 }
 
+void Mixer_Update()
+{
+	gMixer.Update();
+}
+
+void Mixer_GetStats(uint32* bufferSamples, uint32* underruns, uint32* callbackPeakUs, uint32* callbackAvgUs)
+{
+	gMixer.GetStats(bufferSamples, underruns, callbackPeakUs, callbackAvgUs);
+}
+
 void* Mixer_Play_Effect(int id, int loop, int volume, float pan, double rate, int deleteondone)
 {
 	if (id >= countof(gMixer.css1sources)) {
 		return 0;
 	}
-	gMixer.Lock();
-	Channel* channel = gMixer.Play(*gMixer.css1sources[id], loop, deleteondone != 0, false);
-	if (channel) {
-		channel->SetVolume(volume);
-		channel->SetPan(pan);
-		channel->SetRate(rate);
-	}
-	gMixer.Unlock();
-	return channel;
+	return gMixer.PlayEffect(id, loop, deleteondone != 0, volume, pan, rate);
 }
 
 void Mixer_Stop_Channel(void* channel)
@@ -31,11 +31,36 @@
 
 #ifdef __cplusplus
 
-#include <list>
 extern "C" {
 #include <speex/speex_resampler.h>
 }
 
+// Fixed number of channel slots; the slot pointers are handed between the
+// game thread and the audio callback with atomic operations so starting a
+// sound never blocks on the device lock
+#define MIXER_CHANNEL_SLOTS		64
+
+// Number of pre-resampled effect buffers kept at the device rate so
+// repeatedly played effects skip the resampler
+#define MIXER_SAMPLE_CACHE_SLOTS	16
+
+// Channels whose effective volume (volume after pan attenuation, out of
+// SDL_MIX_MAXVOLUME) falls below this are virtualized: their position keeps
+// advancing but they are not resampled or mixed until they become audible
+#define MIXER_VIRTUALIZE_VOLUME		2
+
+// At most this many channels are mixed per callback; when more are audible
+// the loudest win and the rest are virtualized
+#define MIXER_MAX_MIXED_CHANNELS	16
+
+// Bounds for the device buffer size in sample frames. The buffer is tuned
+// automatically from measured callback timing (audio_buffer_samples 0) or
+// pinned by the configuration option; smaller buffers give snappier effect
+// playback, larger ones ride out machines that cannot mix in time
+#define MIXER_BUFFER_SAMPLES_MIN		512
+#define MIXER_BUFFER_SAMPLES_MAX		4096
+#define MIXER_BUFFER_SAMPLES_DEFAULT	1024
+
 struct AudioFormat {
 	int BytesPerSample() const { return (SDL_AUDIO_BITSIZE(format)) / 8; };
 	int freq;
@@ -76,6 +101,7 @@ public:
 	~Source_Sample();
 	bool LoadWAV(const char* filename);
 	bool LoadCSS1(const char* filename, unsigned int offset);
+	bool LoadCSS1(SDL_RWops* rw, unsigned int offset);
 
 	friend class Mixer;
 
@@ -102,12 +128,26 @@ public:
 private:
 	Uint32 FindChunk(SDL_RWops* rw, Uint32 wanted_id);
 	void Unload();
+	static int SDLCALL FillThreadEntry(void* arg);
+	void FillLoop();
 
 	SDL_RWops* rw;
 	Uint64 databegin;
 	uint8* buffer;
 	unsigned long buffersize;
 
+	// Read-ahead ring buffer, filled from the file by a dedicated thread so
+	// that the audio callback never has to wait on the disk
+	uint8* ring;
+	unsigned long ringreadpos;
+	unsigned long ringlength;
+	unsigned long ringstreamoffset;
+	unsigned long filloffset;
+	long seekrequest;
+	volatile bool fillthreadrunning;
+	SDL_mutex* ringmutex;
+	SDL_Thread* fillthread;
+
 protected:
 	unsigned long Read(unsigned long offset, const uint8** data, unsigned long length);
 };
@@ -139,7 +179,9 @@ private:
 	bool deleteondone;
 	bool deletesourceondone;
 	bool stopping;
+	bool virtualized;
 	int oldvolume;
+	double cachedrate; // rate already applied by a pre-resampled source
 	SpeexResamplerState* resampler;
 	Source* source;
 };
@@ -150,9 +192,12 @@ public:
 	Mixer();
 	void Init(const char* device);
 	void Close();
+	void Update();
+	void GetStats(uint32* bufferSamples, uint32* underruns, uint32* callbackPeakUs, uint32* callbackAvgUs);
 	void Lock();
 	void Unlock();
 	Channel* Play(Source& source, int loop, bool deleteondone, bool deletesourceondone);
+	Channel* PlayEffect(int id, int loop, bool deleteondone, int volume, float pan, double rate);
 	void Stop(Channel& channel);
 	bool LoadMusic(int pathid);
 
@@ -160,18 +205,56 @@ public:
 	Source* musicsources[PATH_ID_END];
 
 private:
+	struct CachedSample {
+		Source_Sample* source;
+		int id;
+		double rate;
+		uint32 lastused;
+	};
+
 	static void SDLCALL Callback(void* arg, uint8* data, int length);
 	void MixChannel(Channel& channel, uint8* buffer, int length);
+	void AdvanceChannel(Channel& channel, int length);
 	void EffectPanS16(Channel& channel, sint16* data, int length);
 	void EffectPanU8(Channel& channel, uint8* data, int length);
 	void EffectFadeS16(sint16* data, int length, int startvolume, int endvolume);
 	void EffectFadeU8(uint8* data, int length, int startvolume, int endvolume);
 	bool MustConvert(Source& source);
 	bool Convert(SDL_AudioCVT& cvt, const uint8* data, unsigned long length, uint8** dataout);
+	bool PublishChannel(Channel* channel);
+	Source* GetResampledSample(int id, double rate);
+	bool OpenDevice(int samples);
+	void SetBufferSize(int samples);
 	SDL_AudioDeviceID deviceid;
 	AudioFormat format;
 	uint8* effectbuffer;
-	std::list<Channel*> channels;
+	// Device name Init was given, kept so the device can be reopened with a
+	// different buffer size
+	char devicename[256];
+	bool hasdevicename;
+	// Current buffer size and the real time one buffer of audio covers; a
+	// callback that takes longer than its budget means the device ran dry
+	int buffersamples;
+	uint32 callbackbudgetus;
+	// Written by the audio callback, read by the game thread; reset when the
+	// buffer is resized
+	volatile uint32 statcallbacks;
+	volatile uint32 statcallbacktotalus;
+	volatile uint32 statcallbackpeakus;
+	volatile uint32 statunderruns;
+	// Buffer tuning state, game thread only
+	uint32 lifetimeunderruns;
+	uint32 tunelastunderruns;
+	uint32 tunerecentunderruns;
+	uint32 tunecleanticks;
+	bool startuptuned;
+	// Claimed with a compare-and-swap by the game thread, released by the
+	// audio callback; a null slot is free
+	Channel* channels[MIXER_CHANNEL_SLOTS];
+	// Effect samples pre-resampled to the device rate, keyed by
+	// (sample id, rate); only touched by the game thread
+	CachedSample samplecache[MIXER_SAMPLE_CACHE_SLOTS];
+	uint32 samplecacheticks;
 	Source_Null source_null;
 };
 
@@ -180,6 +263,8 @@ extern "C"
 #endif
 
 void Mixer_Init(const char* device);
+void Mixer_Update();
+void Mixer_GetStats(uint32* bufferSamples, uint32* underruns, uint32* callbackPeakUs, uint32* callbackAvgUs);
 void* Mixer_Play_Effect(int id, int loop, int volume, float pan, double rate, int deleteondone);
 void Mixer_Stop_Channel(void* channel);
 void Mixer_Channel_Volume(void* channel, int volume);
@@ -0,0 +1,311 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <SDL.h>
+#include "addresses.h"
+#include "checkpoint.h"
+#include "config.h"
+#include "game.h"
+#include "object.h"
+#include "park_instance.h"
+#include "platform/platform.h"
+#include "scenario.h"
+#include "util/sawyercoding.h"
+#include "world/map.h"
+
+// Crash resume checkpoints for always-on installations. Every interval the
+// saved game state regions are memcpyed into a persistent snapshot buffer on
+// the game thread and written out raw, without chunk encoding, by a
+// background thread. Two checkpoint files are written alternately so a crash
+// mid-write always leaves the previous one intact, and a session marker file
+// distinguishes a crash from a clean exit: the marker is created with the
+// first checkpoint and removed on shutdown, so if it is still present at
+// startup the newest valid checkpoint is copied straight back over the game
+// state instead of going through an SV6 load and object re-scan.
+
+#define CHECKPOINT_MAGIC 0x504B434F // OCKP
+#define CHECKPOINT_VERSION 1
+#define CHECKPOINT_INTERVAL_TICKS 4096
+
+// Same state regions the saved game chunks cover, see scenario_save_async
+#define CHECKPOINT_GAME_TIME_SIZE 16
+#define CHECKPOINT_MAP_ELEMENTS_SIZE 0x4A85EC
+#define CHECKPOINT_GAME_DATA_SIZE 0x2E8570
+
+typedef struct {
+	uint32 magic;
+	uint32 version;
+	uint32 sequence;
+	uint32 checksum; // over the three state regions, in file order
+	rct_object_entry objects[721];
+} checkpoint_header;
+
+typedef struct {
+	checkpoint_header header;
+	uint8 gameTimeData[CHECKPOINT_GAME_TIME_SIZE];
+	uint8 *mapElements;
+	uint8 *gameData;
+} checkpoint_snapshot;
+
+static checkpoint_snapshot _snapshot;
+static SDL_Thread *_checkpointThread = NULL;
+static volatile int _checkpointActive = 0;
+static uint32 _checkpointSequence = 0;
+static int _sessionMarkerWritten = 0;
+
+static void checkpoint_get_path(char *outPath, int index)
+{
+	platform_get_user_directory(outPath, NULL);
+	sprintf(strchr(outPath, 0), "checkpoint%d.dat", index);
+}
+
+static void checkpoint_get_marker_path(char *outPath)
+{
+	platform_get_user_directory(outPath, NULL);
+	strcat(outPath, "checkpoint.lck");
+}
+
+static int checkpoint_write_thread(void *ptr)
+{
+	char path[MAX_PATH];
+	FILE *file;
+	int success;
+
+	checkpoint_get_path(path, _snapshot.header.sequence & 1);
+	file = fopen(path, "wb");
+	if (file == NULL) {
+		log_error("Unable to write to %s", path);
+		_checkpointActive = 0;
+		return 0;
+	}
+
+	success = fwrite(&_snapshot.header, sizeof(checkpoint_header), 1, file) == 1
+		&& fwrite(_snapshot.gameTimeData, CHECKPOINT_GAME_TIME_SIZE, 1, file) == 1
+		&& fwrite(_snapshot.mapElements, CHECKPOINT_MAP_ELEMENTS_SIZE, 1, file) == 1
+		&& fwrite(_snapshot.gameData, CHECKPOINT_GAME_DATA_SIZE, 1, file) == 1;
+	fclose(file);
+	if (!success)
+		log_error("Unable to write checkpoint %s", path);
+
+	_checkpointActive = 0;
+	return success;
+}
+
+static void checkpoint_session_begin()
+{
+	char path[MAX_PATH];
+	FILE *file;
+
+	checkpoint_get_marker_path(path);
+	file = fopen(path, "wb");
+	if (file != NULL)
+		fclose(file);
+	_sessionMarkerWritten = 1;
+}
+
+/**
+ * Called once per logic tick; captures a snapshot of the game state every
+ * interval and hands it to the write thread.
+ */
+void checkpoint_update()
+{
+	static uint32 ticksUntilCheckpoint = CHECKPOINT_INTERVAL_TICKS;
+
+	if (!gConfigGeneral.crash_checkpoints)
+		return;
+	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) != SCREEN_FLAGS_PLAYING)
+		return;
+	// Only the active park is worth resuming into
+	if (gParkInstanceHeadlessTick)
+		return;
+
+	if (--ticksUntilCheckpoint != 0)
+		return;
+	ticksUntilCheckpoint = CHECKPOINT_INTERVAL_TICKS;
+
+	// Still writing the previous checkpoint; try again next interval
+	if (_checkpointActive)
+		return;
+	if (_checkpointThread != NULL) {
+		SDL_WaitThread(_checkpointThread, NULL);
+		_checkpointThread = NULL;
+	}
+
+	if (_snapshot.mapElements == NULL) {
+		_snapshot.mapElements = malloc(CHECKPOINT_MAP_ELEMENTS_SIZE);
+		_snapshot.gameData = malloc(CHECKPOINT_GAME_DATA_SIZE);
+		if (_snapshot.mapElements == NULL || _snapshot.gameData == NULL) {
+			log_error("Unable to allocate checkpoint snapshot buffers.");
+			SafeFree(_snapshot.mapElements);
+			SafeFree(_snapshot.gameData);
+			return;
+		}
+	}
+
+	if (!_sessionMarkerWritten)
+		checkpoint_session_begin();
+
+	// Same live state preparation scenario_save performs
+	map_reorganise_elements();
+	RCT2_CALLPROC_EBPSAFE(0x0069EBE4);
+	RCT2_CALLPROC_EBPSAFE(0x0069EBA4);
+	RCT2_CALLPROC_EBPSAFE(0x00677552);
+	RCT2_CALLPROC_EBPSAFE(0x00674BCF);
+	scenario_set_saved_view();
+
+	_snapshot.header.magic = CHECKPOINT_MAGIC;
+	_snapshot.header.version = CHECKPOINT_VERSION;
+	_snapshot.header.sequence = ++_checkpointSequence;
+	scenario_get_available_objects(_snapshot.header.objects);
+	memcpy(_snapshot.gameTimeData, (uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR, CHECKPOINT_GAME_TIME_SIZE);
+	memcpy(_snapshot.mapElements, (uint8*)RCT2_ADDRESS_MAP_ELEMENTS, CHECKPOINT_MAP_ELEMENTS_SIZE);
+	memcpy(_snapshot.gameData, (uint8*)0x010E63B8, CHECKPOINT_GAME_DATA_SIZE);
+	_snapshot.header.checksum =
+		sawyercoding_calculate_checksum(_snapshot.gameTimeData, CHECKPOINT_GAME_TIME_SIZE) +
+		sawyercoding_calculate_checksum(_snapshot.mapElements, CHECKPOINT_MAP_ELEMENTS_SIZE) +
+		sawyercoding_calculate_checksum(_snapshot.gameData, CHECKPOINT_GAME_DATA_SIZE);
+
+	_checkpointActive = 1;
+	_checkpointThread = SDL_CreateThread(checkpoint_write_thread, "OpenRCT2 checkpoint", NULL);
+	if (_checkpointThread == NULL)
+		_checkpointActive = 0;
+}
+
+/**
+ * Reads one checkpoint file into buffers. Returns 1 if the file exists and
+ * its header and checksum are intact.
+ */
+static int checkpoint_read(int index, checkpoint_header *header, uint8 *gameTimeData, uint8 *mapElements, uint8 *gameData)
+{
+	char path[MAX_PATH];
+	FILE *file;
+	int success;
+	uint32 checksum;
+
+	checkpoint_get_path(path, index);
+	file = fopen(path, "rb");
+	if (file == NULL)
+		return 0;
+
+	success = fread(header, sizeof(checkpoint_header), 1, file) == 1
+		&& header->magic == CHECKPOINT_MAGIC
+		&& header->version == CHECKPOINT_VERSION
+		&& fread(gameTimeData, CHECKPOINT_GAME_TIME_SIZE, 1, file) == 1
+		&& fread(mapElements, CHECKPOINT_MAP_ELEMENTS_SIZE, 1, file) == 1
+		&& fread(gameData, CHECKPOINT_GAME_DATA_SIZE, 1, file) == 1;
+	fclose(file);
+	if (!success)
+		return 0;
+
+	checksum =
+		sawyercoding_calculate_checksum(gameTimeData, CHECKPOINT_GAME_TIME_SIZE) +
+		sawyercoding_calculate_checksum(mapElements, CHECKPOINT_MAP_ELEMENTS_SIZE) +
+		sawyercoding_calculate_checksum(gameData, CHECKPOINT_GAME_DATA_SIZE);
+	return checksum == header->checksum;
+}
+
+/**
+ * Restores the newest valid checkpoint if the previous session crashed while
+ * one existed. Returns 1 if the game state was restored, in which case the
+ * caller skips the title screen and resumes play.
+ */
+int checkpoint_resume()
+{
+	char path[MAX_PATH];
+	checkpoint_header *headers;
+	uint8 *gameTimeData, *mapElements, *gameData;
+	int i, best, valid[2];
+	checkpoint_header best_header;
+
+	if (!gConfigGeneral.crash_checkpoints)
+		return 0;
+
+	// A marker still present means the last session did not exit cleanly
+	checkpoint_get_marker_path(path);
+	if (!platform_file_exists(path))
+		return 0;
+
+	headers = malloc(2 * sizeof(checkpoint_header));
+	gameTimeData = malloc(2 * CHECKPOINT_GAME_TIME_SIZE);
+	mapElements = malloc(2 * CHECKPOINT_MAP_ELEMENTS_SIZE);
+	gameData = malloc(2 * CHECKPOINT_GAME_DATA_SIZE);
+	if (headers == NULL || gameTimeData == NULL || mapElements == NULL || gameData == NULL) {
+		SafeFree(headers);
+		SafeFree(gameTimeData);
+		SafeFree(mapElements);
+		SafeFree(gameData);
+		return 0;
+	}
+
+	best = -1;
+	for (i = 0; i < 2; i++) {
+		valid[i] = checkpoint_read(
+			i,
+			&headers[i],
+			gameTimeData + i * CHECKPOINT_GAME_TIME_SIZE,
+			mapElements + i * CHECKPOINT_MAP_ELEMENTS_SIZE,
+			gameData + i * CHECKPOINT_GAME_DATA_SIZE
+		);
+		if (valid[i] && (best == -1 || headers[i].sequence > headers[best].sequence))
+			best = i;
+	}
+
+	if (best == -1 || !object_load_entries(headers[best].objects)) {
+		free(headers);
+		free(gameTimeData);
+		free(mapElements);
+		free(gameData);
+		return 0;
+	}
+
+	best_header = headers[best];
+	memcpy((uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR, gameTimeData + best * CHECKPOINT_GAME_TIME_SIZE, CHECKPOINT_GAME_TIME_SIZE);
+	memcpy((uint8*)RCT2_ADDRESS_MAP_ELEMENTS, mapElements + best * CHECKPOINT_MAP_ELEMENTS_SIZE, CHECKPOINT_MAP_ELEMENTS_SIZE);
+	memcpy((uint8*)0x010E63B8, gameData + best * CHECKPOINT_GAME_DATA_SIZE, CHECKPOINT_GAME_DATA_SIZE);
+	free(headers);
+	free(gameTimeData);
+	free(mapElements);
+	free(gameData);
+
+	game_load_init();
+	_checkpointSequence = best_header.sequence;
+
+	log_verbose("resumed from checkpoint %u", best_header.sequence);
+	return 1;
+}
+
+/**
+ * Marks the session as cleanly ended so the next launch does not resume.
+ */
+void checkpoint_session_end()
+{
+	char path[MAX_PATH];
+
+	if (_checkpointThread != NULL) {
+		SDL_WaitThread(_checkpointThread, NULL);
+		_checkpointThread = NULL;
+	}
+
+	if (_sessionMarkerWritten) {
+		checkpoint_get_marker_path(path);
+		platform_file_delete(path);
+		_sessionMarkerWritten = 0;
+	}
+}
@@ -38,6 +38,10 @@ static const char *const usage[] = {
 	"openrct2 <path> [options]",
 	"openrct2 intro [options]",
 	"openrct2 edit [path] [options]",
+	"openrct2 benchmark <path> [--ticks <n>] [options]",
+	"openrct2 benchgfx [options]",
+	"openrct2 screenshot <path> [--zoom <n>] [options]",
+	"openrct2 bundle <scenario> <output> [options]",
 	NULL
 };
 
@@ -48,13 +52,18 @@ static const char *const usage[] = {
  */
 int cmdline_run(const char **argv, int argc)
 {
-	// 
-	int version = 0, verbose = 0, width = 0, height = 0;
+	//
+	int version = 0, verbose = 0, width = 0, height = 0, ticks = 0, zoom = 0;
+	const char *recordPath = NULL, *replayPath = NULL;
 
 	argparse_option_t options[] = {
 		OPT_HELP(),
 		OPT_BOOLEAN('v', "version", &version, "show version information and exit"),
 		OPT_BOOLEAN(0, "verbose", &verbose, "log verbose messages"),
+		OPT_INTEGER(0, "ticks", &ticks, "number of ticks to run the benchmark for"),
+		OPT_INTEGER(0, "zoom", &zoom, "zoom level for the giant screenshot (0 = closest)"),
+		OPT_STRING(0, "record", &recordPath, "record applied game commands to the given log"),
+		OPT_STRING(0, "replay", &replayPath, "replay game commands from the given log (requires the same starting park)"),
 		OPT_END()
 	};
 
@@ -72,6 +81,11 @@ int cmdline_run(const char **argv, int argc)
 	if (verbose)
 		_log_levels[DIAGNOSTIC_LEVEL_VERBOSE] = 1;
 
+	if (recordPath != NULL)
+		strcpy(gOpenRCT2RecordPath, recordPath);
+	if (replayPath != NULL)
+		strcpy(gOpenRCT2ReplayPath, replayPath);
+
 	if (argc != 0) {
 		if (_stricmp(argv[0], "intro") == 0) {
 			gOpenRCT2StartupAction = STARTUP_ACTION_INTRO;
@@ -79,6 +93,49 @@ int cmdline_run(const char **argv, int argc)
 			gOpenRCT2StartupAction = STARTUP_ACTION_EDIT;
 			if (argc >= 2)
 				strcpy(gOpenRCT2StartupActionPath, argv[1]);
+		} else if (_stricmp(argv[0], "benchmark") == 0) {
+			if (argc < 2) {
+				fprintf(stderr, "error: benchmark requires a saved game path\n");
+				return 0;
+			}
+			if (!platform_file_exists(argv[1])) {
+				fprintf(stderr, "error: %s does not exist\n", argv[1]);
+				return 0;
+			}
+			gOpenRCT2StartupAction = STARTUP_ACTION_BENCHMARK;
+			strcpy(gOpenRCT2StartupActionPath, argv[1]);
+			gOpenRCT2Headless = 1;
+			if (ticks > 0)
+				gOpenRCT2BenchmarkTicks = ticks;
+		} else if (_stricmp(argv[0], "benchgfx") == 0) {
+			gOpenRCT2StartupAction = STARTUP_ACTION_BENCHGFX;
+			gOpenRCT2Headless = 1;
+		} else if (_stricmp(argv[0], "screenshot") == 0) {
+			if (argc < 2) {
+				fprintf(stderr, "error: screenshot requires a saved game path\n");
+				return 0;
+			}
+			if (!platform_file_exists(argv[1])) {
+				fprintf(stderr, "error: %s does not exist\n", argv[1]);
+				return 0;
+			}
+			gOpenRCT2StartupAction = STARTUP_ACTION_SCREENSHOT;
+			strcpy(gOpenRCT2StartupActionPath, argv[1]);
+			gOpenRCT2Headless = 1;
+			gOpenRCT2ScreenshotZoom = clamp(0, zoom, 3);
+		} else if (_stricmp(argv[0], "bundle") == 0) {
+			if (argc < 3) {
+				fprintf(stderr, "error: bundle requires a scenario path and an output path\n");
+				return 0;
+			}
+			if (!platform_file_exists(argv[1])) {
+				fprintf(stderr, "error: %s does not exist\n", argv[1]);
+				return 0;
+			}
+			gOpenRCT2StartupAction = STARTUP_ACTION_BUNDLE;
+			strcpy(gOpenRCT2StartupActionPath, argv[1]);
+			strcpy(gOpenRCT2BundleOutputPath, argv[2]);
+			gOpenRCT2Headless = 1;
 		} else {
 			if (platform_file_exists(argv[0])) {
 				gOpenRCT2StartupAction = STARTUP_ACTION_OPEN;
@@ -20,6 +20,7 @@
 
 #include "addresses.h"
 #include "config.h"
+#include "drawing/drawing.h"
 #include "localisation/localisation.h"
 
 // Magic number for original game cfg file
@@ -141,9 +142,13 @@ config_enum_definition _languageEnum[] = {
 config_property_definition _generalDefinitions[] = {
 	{ offsetof(general_configuration, always_show_gridlines),			"always_show_gridlines",		CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
 	{ offsetof(general_configuration, autosave_frequency),				"autosave",						CONFIG_VALUE_TYPE_UINT8,		AUTOSAVE_EVERY_MONTH,			NULL					},
+	{ offsetof(general_configuration, chunked_saves),					"chunked_saves",				CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
 	{ offsetof(general_configuration, confirmation_prompt),				"confirmation_prompt",			CONFIG_VALUE_TYPE_UINT8,		0,								NULL					},
+	{ offsetof(general_configuration, crash_checkpoints),				"crash_checkpoints",			CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
 	{ offsetof(general_configuration, construction_marker_colour),		"construction_marker_colour",	CONFIG_VALUE_TYPE_UINT8,		false,							NULL					},
 	{ offsetof(general_configuration, currency_format),					"currency_format",				CONFIG_VALUE_TYPE_UINT8,		CURRENCY_POUNDS,				_currencyEnum			},
+	{ offsetof(general_configuration, delta_autosaves),					"delta_autosaves",				CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
+	{ offsetof(general_configuration, dynamic_render_quality),			"dynamic_render_quality",		CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
 	{ offsetof(general_configuration, edge_scrolling),					"edge_scrolling",				CONFIG_VALUE_TYPE_BOOLEAN,		true,							NULL					},
 	{ offsetof(general_configuration, fullscreen_mode),					"fullscreen_mode",				CONFIG_VALUE_TYPE_UINT8,		0,								NULL					},
 	{ offsetof(general_configuration, fullscreen_height),				"fullscreen_height",			CONFIG_VALUE_TYPE_SINT32,		-1,								NULL					},
@@ -151,12 +156,23 @@ config_property_definition _generalDefinitions[] = {
 	{ offsetof(general_configuration, game_path),						"game_path",					CONFIG_VALUE_TYPE_STRING,		{ .value_string = NULL },		NULL					},
 	{ offsetof(general_configuration, landscape_smoothing),				"landscape_smoothing",			CONFIG_VALUE_TYPE_BOOLEAN,		true,							NULL					},
 	{ offsetof(general_configuration, language),						"language",						CONFIG_VALUE_TYPE_UINT16,		LANGUAGE_ENGLISH_UK,			_languageEnum			},
+	{ offsetof(general_configuration, litter_cap),						"litter_cap",					CONFIG_VALUE_TYPE_UINT16,		2000,							NULL					},
 	{ offsetof(general_configuration, measurement_format),				"measurement_format",			CONFIG_VALUE_TYPE_UINT8,		MEASUREMENT_FORMAT_IMPERIAL,	_measurementFormatEnum	},
+	{ offsetof(general_configuration, offscreen_misc_update_rate),		"offscreen_misc_update_rate",	CONFIG_VALUE_TYPE_UINT8,		1,								NULL					},
+	{ offsetof(general_configuration, performance_counters),			"performance_counters",			CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
 	{ offsetof(general_configuration, play_intro),						"play_intro",					CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
+	{ offsetof(general_configuration, render_scale),					"render_scale",					CONFIG_VALUE_TYPE_UINT8,		1,								NULL					},
 	{ offsetof(general_configuration, save_plugin_data),				"save_plugin_data",				CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
+	{ offsetof(general_configuration, scalar_kernels),					"scalar_kernels",				CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
 	{ offsetof(general_configuration, screenshot_format),				"screenshot_format",			CONFIG_VALUE_TYPE_UINT8,		SCREENSHOT_FORMAT_PNG,			_screenShotFormatEnum	},
 	{ offsetof(general_configuration, show_height_as_units),			"show_height_as_units",			CONFIG_VALUE_TYPE_BOOLEAN,		false,							NULL					},
+	{ offsetof(general_configuration, sprite_cache_size),				"sprite_cache_size",			CONFIG_VALUE_TYPE_UINT32,		8,								NULL					},
+	{ offsetof(general_configuration, sprite_lod_litter_zoom),			"sprite_lod_litter_zoom",		CONFIG_VALUE_TYPE_UINT8,		2,								NULL					},
+	{ offsetof(general_configuration, sprite_lod_misc_zoom),			"sprite_lod_misc_zoom",			CONFIG_VALUE_TYPE_UINT8,		3,								NULL					},
+	{ offsetof(general_configuration, sprite_lod_peep_zoom),			"sprite_lod_peep_zoom",			CONFIG_VALUE_TYPE_UINT8,		3,								NULL					},
+	{ offsetof(general_configuration, sprite_lod_scenery_zoom),			"sprite_lod_scenery_zoom",		CONFIG_VALUE_TYPE_UINT8,		3,								NULL					},
 	{ offsetof(general_configuration, temperature_format),				"temperature_format",			CONFIG_VALUE_TYPE_UINT8,		TEMPERATURE_FORMAT_C,			_temperatureFormatEnum	},
+	{ offsetof(general_configuration, test_acceleration),				"test_acceleration",			CONFIG_VALUE_TYPE_UINT8,		4,								NULL					},
 	{ offsetof(general_configuration, window_height),					"window_height",				CONFIG_VALUE_TYPE_SINT32,		-1,								NULL					},
 	{ offsetof(general_configuration, window_snap_proximity),			"window_snap_proximity",		CONFIG_VALUE_TYPE_UINT8,		5,								NULL					},
 	{ offsetof(general_configuration, window_width),					"window_width",					CONFIG_VALUE_TYPE_SINT32,		-1,								NULL					},
@@ -174,6 +190,7 @@ config_property_definition _soundDefinitions[] = {
 	{ offsetof(sound_configuration, title_music),						"title_music",					CONFIG_VALUE_TYPE_UINT8,		2,								NULL					},
 	{ offsetof(sound_configuration, sound),								"sound",						CONFIG_VALUE_TYPE_BOOLEAN,		true,							NULL					},
 	{ offsetof(sound_configuration, ride_music),						"ride_music",					CONFIG_VALUE_TYPE_BOOLEAN,		true,							NULL					},
+	{ offsetof(sound_configuration, audio_buffer_samples),				"audio_buffer_samples",			CONFIG_VALUE_TYPE_UINT16,		0,								NULL					},
 };
 
 config_section_definition _sectionDefinitions[] = {
@@ -233,13 +250,21 @@ void config_set_defaults()
 	}
 }
 
+static uint64 _configLastModified;
+
+static void config_get_default_path(utf8 *outPath)
+{
+	platform_get_user_directory(outPath, NULL);
+	strcat(outPath, "config.ini");
+}
+
 bool config_open_default()
 {
 	utf8 path[MAX_PATH];
 
-	platform_get_user_directory(path, NULL);
-	strcat(path, "config.ini");
+	config_get_default_path(path);
 	if (config_open(path)) {
+		_configLastModified = platform_file_get_modified_time(path);
 		config_apply_to_old_addresses();
 		return true;
 	}
@@ -251,9 +276,11 @@ bool config_save_default()
 {
 	utf8 path[MAX_PATH];
 
-	platform_get_user_directory(path, NULL);
-	strcat(path, "config.ini");
+	config_get_default_path(path);
 	if (config_save(path)) {
+		// Remember the modified time of our own write so it does not
+		// trigger a hot reload
+		_configLastModified = platform_file_get_modified_time(path);
 		config_apply_to_old_addresses();
 		return true;
 	}
@@ -261,6 +288,33 @@ bool config_save_default()
 	return false;
 }
 
+/**
+ * Polls the config file for external modification and re-reads it when it has
+ * changed, so that settings edited while the game is running apply without a
+ * restart. Called once per frame, the file check itself is throttled.
+ */
+void config_hot_reload_update()
+{
+	static int pollCounter = 0;
+	utf8 path[MAX_PATH];
+	uint64 modified;
+
+	if (++pollCounter < 40)
+		return;
+	pollCounter = 0;
+
+	config_get_default_path(path);
+	modified = platform_file_get_modified_time(path);
+	if (modified == 0 || modified == _configLastModified)
+		return;
+	_configLastModified = modified;
+
+	if (config_open(path)) {
+		config_apply_to_old_addresses();
+		gfx_invalidate_screen();
+	}
+}
+
 bool config_open(const utf8string path)
 {
 	FILE *file;
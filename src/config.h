@@ -129,6 +129,21 @@ typedef struct {
 	uint16 language;
 	uint8 window_snap_proximity;
 	uint8 autosave_frequency;
+	uint32 sprite_cache_size;
+	uint16 litter_cap;
+	uint8 offscreen_misc_update_rate;
+	uint8 render_scale;
+	uint8 chunked_saves;
+	uint8 delta_autosaves;
+	uint8 crash_checkpoints;
+	uint8 performance_counters;
+	uint8 dynamic_render_quality;
+	uint8 scalar_kernels;
+	uint8 sprite_lod_litter_zoom;
+	uint8 sprite_lod_misc_zoom;
+	uint8 sprite_lod_peep_zoom;
+	uint8 sprite_lod_scenery_zoom;
+	uint8 test_acceleration;
 } general_configuration;
 
 typedef struct {
@@ -143,6 +158,7 @@ typedef struct {
 	uint8 title_music;
 	uint8 sound;
 	uint8 ride_music;
+	uint16 audio_buffer_samples;
 } sound_configuration;
 
 typedef struct {
@@ -159,6 +175,7 @@ extern uint16 gShortcutKeys[SHORTCUT_COUNT];
 void config_set_defaults();
 bool config_open_default();
 bool config_save_default();
+void config_hot_reload_update();
 
 uint16 getLanguage();
 
@@ -0,0 +1,126 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "config.h"
+#include "cpu.h"
+
+// Runtime CPU feature detection for the optimized kernels in drawing, audio
+// and sawyercoding. Each kernel keeps a function pointer per operation,
+// resolved once against these feature bits when its module first runs, so
+// there is no detection cost on the call itself. cpu_has_feature reports no
+// features while the scalar_kernels config option is set, which forces every
+// kernel onto its portable path when diagnosing.
+
+static int _cpuFeatures = 0;
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+
+#ifdef _MSC_VER
+
+#include <intrin.h>
+
+static void cpu_cpuid(int leaf, int subleaf, int *regs)
+{
+	__cpuidex(regs, leaf, subleaf);
+}
+
+static uint64 cpu_xgetbv()
+{
+	return _xgetbv(0);
+}
+
+#else
+
+static void cpu_cpuid(int leaf, int subleaf, int *regs)
+{
+	// ebx is swapped through a spare register as it is reserved when
+	// building position independent code on x86
+	__asm__ __volatile__ (
+		"xchgl %%ebx, %1\n\t"
+		"cpuid\n\t"
+		"xchgl %%ebx, %1"
+		: "=a" (regs[0]), "+r" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+		: "a" (leaf), "c" (subleaf)
+	);
+}
+
+static uint64 cpu_xgetbv()
+{
+	uint32 eax, edx;
+
+	// xgetbv encoded directly, older assemblers do not know the mnemonic
+	__asm__ __volatile__ (
+		".byte 0x0F, 0x01, 0xD0"
+		: "=a" (eax), "=d" (edx)
+		: "c" (0)
+	);
+	return ((uint64)edx << 32) | eax;
+}
+
+#endif
+
+void cpu_initialise()
+{
+	int regs[4];
+	int maxLeaf, ecx1;
+
+	_cpuFeatures = 0;
+
+	cpu_cpuid(0, 0, regs);
+	maxLeaf = regs[0];
+
+	cpu_cpuid(1, 0, regs);
+	ecx1 = regs[2];
+	if (regs[3] & (1 << 26))
+		_cpuFeatures |= CPU_FEATURE_SSE2;
+	if (ecx1 & (1 << 9))
+		_cpuFeatures |= CPU_FEATURE_SSSE3;
+
+	// AVX2 additionally requires the OS to save the wide register state:
+	// OSXSAVE must be on and XCR0 must have the XMM and YMM bits set
+	if (maxLeaf >= 7 && (ecx1 & (1 << 27)) && (cpu_xgetbv() & 6) == 6) {
+		cpu_cpuid(7, 0, regs);
+		if (regs[1] & (1 << 5))
+			_cpuFeatures |= CPU_FEATURE_AVX2;
+	}
+
+	log_verbose(
+		"cpu features:%s%s%s",
+		_cpuFeatures & CPU_FEATURE_SSE2 ? " sse2" : "",
+		_cpuFeatures & CPU_FEATURE_SSSE3 ? " ssse3" : "",
+		_cpuFeatures & CPU_FEATURE_AVX2 ? " avx2" : ""
+	);
+}
+
+#else
+
+void cpu_initialise()
+{
+	_cpuFeatures = 0;
+}
+
+#endif
+
+int cpu_has_feature(int feature)
+{
+	if (gConfigGeneral.scalar_kernels)
+		return 0;
+	return (_cpuFeatures & feature) == feature;
+}
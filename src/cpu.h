@@ -0,0 +1,35 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _CPU_H_
+#define _CPU_H_
+
+#include "common.h"
+
+enum {
+	CPU_FEATURE_SSE2	= (1 << 0),
+	CPU_FEATURE_SSSE3	= (1 << 1),
+	CPU_FEATURE_AVX2	= (1 << 2)
+};
+
+void cpu_initialise();
+int cpu_has_feature(int feature);
+
+#endif
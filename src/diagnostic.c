@@ -21,7 +21,9 @@
 #include <assert.h>
 #include <stdarg.h>
 #include <stdio.h>
-#include "diagnostic.h"
+#include <string.h>
+#include <SDL.h>
+#include "common.h"
 
 int _log_levels[DIAGNOSTIC_LEVEL_COUNT] = { 1, 1, 1, 0 };
 int _log_location_enabled = 1;
@@ -33,49 +35,161 @@ const char * _level_strings[] = {
 	"VERBOSE"
 };
 
+// Warning and verbose messages are queued here and written to stderr by a
+// background thread, so that turning on verbose diagnostics does not stall
+// the game tick on console output. Fatal and error messages bypass the
+// queue and are written synchronously so they cannot be lost if the game
+// goes down. When the queue is full or the per-second limit is hit,
+// messages are dropped and counted instead of blocking the caller.
+#define LOG_RING_SIZE 256
+#define LOG_MESSAGE_MAX 512
+#define LOG_RATE_LIMIT 200
+
+typedef struct {
+	int level;
+	char text[LOG_MESSAGE_MAX];
+} log_message;
+
+static log_message _logRing[LOG_RING_SIZE];
+static int _logRingHead = 0;
+static int _logRingTail = 0;
+static int _logDropped = 0;
+static uint32 _logRateWindowStart = 0;
+static int _logRateCount = 0;
+static SDL_mutex *_logMutex = NULL;
+static SDL_Thread *_logThread = NULL;
+static volatile int _logThreadRunning = 0;
+
+static int diagnostic_thread_entry(void *arg)
+{
+	log_message message;
+	int dropped;
+
+	for (;;) {
+		SDL_LockMutex(_logMutex);
+		if (_logRingTail == _logRingHead) {
+			dropped = _logDropped;
+			_logDropped = 0;
+			SDL_UnlockMutex(_logMutex);
+			if (dropped != 0)
+				fprintf(stderr, "WARNING: dropped %d queued log messages\n", dropped);
+			if (!_logThreadRunning)
+				break;
+			SDL_Delay(10);
+			continue;
+		}
+		message = _logRing[_logRingTail % LOG_RING_SIZE];
+		_logRingTail++;
+		SDL_UnlockMutex(_logMutex);
+		fprintf(stderr, "%s\n", message.text);
+	}
+	return 0;
+}
+
+/**
+ * Queues a formatted message for the background writer. Returns 0 when the
+ * writer is not running, in which case the caller writes synchronously.
+ */
+static int diagnostic_enqueue(int diagnosticLevel, const char *text)
+{
+	log_message *message;
+	uint32 now;
+
+	if (!_logThreadRunning)
+		return 0;
+
+	SDL_LockMutex(_logMutex);
+	now = SDL_GetTicks();
+	if (now - _logRateWindowStart >= 1000) {
+		_logRateWindowStart = now;
+		_logRateCount = 0;
+	}
+	if (++_logRateCount > LOG_RATE_LIMIT || _logRingHead - _logRingTail >= LOG_RING_SIZE) {
+		_logDropped++;
+		SDL_UnlockMutex(_logMutex);
+		return 1;
+	}
+
+	message = &_logRing[_logRingHead % LOG_RING_SIZE];
+	message->level = diagnosticLevel;
+	strncpy(message->text, text, LOG_MESSAGE_MAX - 1);
+	message->text[LOG_MESSAGE_MAX - 1] = 0;
+	_logRingHead++;
+	SDL_UnlockMutex(_logMutex);
+	return 1;
+}
+
+void diagnostic_log_init()
+{
+	if (_logThread != NULL)
+		return;
+
+	_logMutex = SDL_CreateMutex();
+	_logThreadRunning = 1;
+	_logThread = SDL_CreateThread(diagnostic_thread_entry, "OpenRCT2 log writer", NULL);
+	if (_logThread == NULL)
+		_logThreadRunning = 0;
+}
+
+void diagnostic_log_dispose()
+{
+	if (_logThread == NULL)
+		return;
+
+	_logThreadRunning = 0;
+	SDL_WaitThread(_logThread, NULL);
+	SDL_DestroyMutex(_logMutex);
+	_logThread = NULL;
+	_logMutex = NULL;
+}
+
 void diagnostic_log(int diagnosticLevel, const char *format, ...)
 {
-	FILE *stream;
+	char line[LOG_MESSAGE_MAX];
 	va_list args;
+	int offset;
 
 	if (!_log_levels[diagnosticLevel])
 		return;
 
-	stream = stderr;
-
 	// Level
-	fprintf(stream, "%s: ", _level_strings[diagnosticLevel]);
+	offset = snprintf(line, sizeof(line), "%s: ", _level_strings[diagnosticLevel]);
 
 	// Message
 	va_start(args, format);
-	vfprintf(stream, format, args);
+	vsnprintf(line + offset, sizeof(line) - offset, format, args);
 	va_end(args);
 
-	// Line terminator
-	fprintf(stream, "\n");
+	if (diagnosticLevel >= DIAGNOSTIC_LEVEL_WARNING && diagnostic_enqueue(diagnosticLevel, line))
+		return;
+
+	fprintf(stderr, "%s\n", line);
 }
 
 void diagnostic_log_with_location(int diagnosticLevel, const char *file, const char *function, int line, const char *format, ...)
 {
-	FILE *stream;
+	char buffer[LOG_MESSAGE_MAX];
 	va_list args;
+	int offset;
 
 	if (!_log_levels[diagnosticLevel])
 		return;
 
-	stream = stderr;
-
 	// Level and source code information
 	if (_log_location_enabled)
-		fprintf(stream, "%s[%s:%d (%s)]: ", _level_strings[diagnosticLevel], file, line, function);
+		offset = snprintf(buffer, sizeof(buffer), "%s[%s:%d (%s)]: ", _level_strings[diagnosticLevel], file, line, function);
 	else
-		fprintf(stream, "%s: ", _level_strings[diagnosticLevel]);
+		offset = snprintf(buffer, sizeof(buffer), "%s: ", _level_strings[diagnosticLevel]);
+	if (offset > (int)sizeof(buffer) - 1)
+		offset = sizeof(buffer) - 1;
 
 	// Message
 	va_start(args, format);
-	vfprintf(stream, format, args);
+	vsnprintf(buffer + offset, sizeof(buffer) - offset, format, args);
 	va_end(args);
 
-	// Line terminator
-	fprintf(stream, "\n");
+	if (diagnosticLevel >= DIAGNOSTIC_LEVEL_WARNING && diagnostic_enqueue(diagnosticLevel, buffer))
+		return;
+
+	fprintf(stderr, "%s\n", buffer);
 }
\ No newline at end of file
@@ -31,6 +31,8 @@ enum {
 
 extern int _log_levels[DIAGNOSTIC_LEVEL_COUNT];
 
+void diagnostic_log_init();
+void diagnostic_log_dispose();
 void diagnostic_log(int diagnosticLevel, const char *format, ...);
 void diagnostic_log_with_location(int diagnosticLevel, const char *file, const char *function, int line, const char *format, ...);
 
@@ -0,0 +1,173 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "../addresses.h"
+#include "../platform/platform.h"
+#include "drawing.h"
+
+// Micro-benchmark for the software blitters, run by the benchgfx startup
+// action. Each workload hammers one drawing path into an offscreen buffer
+// and reports megapixels per second, so a blitter change can be measured in
+// isolation instead of eyeballing the frame time of a busy park.
+//
+// The workloads are synthetic but standardised: the sprites are picked from
+// g1.dat by scanning for the largest plain BMP and RLE images, so successive
+// runs against the same data files exercise identical pixels.
+
+#define BENCH_SURFACE_WIDTH 640
+#define BENCH_SURFACE_HEIGHT 480
+#define BENCH_MIN_SECONDS 0.25
+#define BENCH_MIN_CALLS 16
+
+typedef void (*bench_func)(rct_drawpixelinfo *dpi, int arg);
+
+static rct_drawpixelinfo _benchDpi;
+
+static void benchgfx_fill_rect(rct_drawpixelinfo *dpi, int colour)
+{
+	gfx_fill_rect(dpi, 0, 0, dpi->width - 1, dpi->height - 1, colour);
+}
+
+static void benchgfx_sprite(rct_drawpixelinfo *dpi, int image_id)
+{
+	gfx_draw_sprite(dpi, image_id, dpi->width / 2, dpi->height / 2, 2);
+}
+
+static void benchgfx_string(rct_drawpixelinfo *dpi, int colour)
+{
+	gfx_draw_string(dpi, "The quick brown fox jumps over the lazy dog", colour, 4, 4);
+}
+
+/**
+ * Runs one workload until it has accumulated a stable amount of work and
+ * prints its throughput. pixelsPerCall is the number of pixels a single call
+ * touches; the blitters clip but every workload draws fully inside the
+ * surface, so the nominal size is the drawn size.
+ */
+static void benchgfx_run(const char *name, bench_func func, int arg, double pixelsPerCall)
+{
+	uint64 start, frequency;
+	double seconds;
+	int i, calls;
+
+	frequency = SDL_GetPerformanceFrequency();
+
+	// Warm up so one-off costs (remap palette cache fills, page faults on the
+	// surface) do not land in the timed region
+	for (i = 0; i < 4; i++)
+		func(&_benchDpi, arg);
+
+	calls = 0;
+	start = SDL_GetPerformanceCounter();
+	do {
+		func(&_benchDpi, arg);
+		calls++;
+		seconds = (double)(SDL_GetPerformanceCounter() - start) / frequency;
+	} while (seconds < BENCH_MIN_SECONDS || calls < BENCH_MIN_CALLS);
+
+	printf("  %-22s %8.1f MP/s  (%d calls in %.3f seconds)\n",
+		name, (pixelsPerCall * calls) / seconds / 1000000.0, calls, seconds);
+}
+
+/**
+ * Finds the largest g1 sprite drawn with the given compression so the sprite
+ * workloads spend their time in the row loops rather than in per-call setup.
+ * Returns -1 if no suitable sprite exists (e.g. g1.dat failed to load).
+ */
+static int benchgfx_find_sprite(bool rle)
+{
+	rct_g1_element *g1Elements = RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element);
+	int i, area, bestIndex, bestArea;
+
+	bestIndex = -1;
+	bestArea = 0;
+	for (i = 0; i < 29294; i++) {
+		rct_g1_element *g1 = &g1Elements[i];
+		if (g1->offset == NULL)
+			continue;
+		if (((g1->flags & G1_FLAG_RLE_COMPRESSION) != 0) != rle)
+			continue;
+		if (!rle && !(g1->flags & G1_FLAG_BMP))
+			continue;
+		if (g1->width <= 0 || g1->width > BENCH_SURFACE_WIDTH / 2)
+			continue;
+		if (g1->height <= 0 || g1->height > BENCH_SURFACE_HEIGHT / 2)
+			continue;
+
+		area = g1->width * g1->height;
+		if (area > bestArea) {
+			bestArea = area;
+			bestIndex = i;
+		}
+	}
+	return bestIndex;
+}
+
+/**
+ * Runs the standard workload set over every drawing path and reports the
+ * throughput of each. Requires rct2_init to have run so the g1 elements and
+ * palettes are loaded.
+ */
+void gfx_benchmark()
+{
+	rct_g1_element *g1Elements = RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element);
+	int bmpIndex, rleIndex;
+	double spritePixels, rectPixels;
+
+	_benchDpi.bits = malloc(BENCH_SURFACE_WIDTH * BENCH_SURFACE_HEIGHT);
+	_benchDpi.x = 0;
+	_benchDpi.y = 0;
+	_benchDpi.width = BENCH_SURFACE_WIDTH;
+	_benchDpi.height = BENCH_SURFACE_HEIGHT;
+	_benchDpi.pitch = 0;
+	_benchDpi.zoom_level = 0;
+	gfx_clear(&_benchDpi, 0x0A0A0A0A);
+
+	rectPixels = BENCH_SURFACE_WIDTH * BENCH_SURFACE_HEIGHT;
+	benchgfx_run("fill_rect", benchgfx_fill_rect, 1, rectPixels);
+	benchgfx_run("fill_rect crosshatch", benchgfx_fill_rect, 0x1000000 | 1, rectPixels);
+	benchgfx_run("fill_rect translucent", benchgfx_fill_rect, 0x2000000 | 47, rectPixels);
+
+	bmpIndex = benchgfx_find_sprite(false);
+	if (bmpIndex != -1) {
+		spritePixels = g1Elements[bmpIndex].width * g1Elements[bmpIndex].height;
+		benchgfx_run("sprite bmp", benchgfx_sprite, bmpIndex, spritePixels);
+	}
+
+	rleIndex = benchgfx_find_sprite(true);
+	if (rleIndex != -1) {
+		spritePixels = g1Elements[rleIndex].width * g1Elements[rleIndex].height;
+		benchgfx_run("sprite rle", benchgfx_sprite, rleIndex, spritePixels);
+		benchgfx_run("sprite rle remap", benchgfx_sprite,
+			rleIndex | (IMAGE_TYPE_USE_PALETTE << 28) | (2 << 19), spritePixels);
+		benchgfx_run("sprite rle remap 2", benchgfx_sprite,
+			rleIndex | (IMAGE_TYPE_UNKNOWN << 28) | (12 << 24) | (2 << 19), spritePixels);
+		benchgfx_run("sprite rle ghost", benchgfx_sprite,
+			rleIndex | (IMAGE_TYPE_MIX_BACKGROUND << 28) | (47 << 19), spritePixels);
+	}
+
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_FONT_SPRITE_BASE, uint16) = 224;
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_FONT_FLAGS, uint16) = 0;
+	benchgfx_run("draw_string", benchgfx_string, 1,
+		gfx_get_string_width("The quick brown fox jumps over the lazy dog") * 10);
+
+	free(_benchDpi.bits);
+	_benchDpi.bits = NULL;
+}
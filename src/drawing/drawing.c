@@ -20,10 +20,14 @@
 
 #include "../addresses.h"
 #include "../common.h"
+#include "../game.h"
 #include "../localisation/localisation.h"
+#include "../interface/viewport.h"
 #include "../interface/window.h"
 #include "../platform/platform.h"
 #include "../object.h"
+#include "../util/memtrack.h"
+#include "../util/util.h"
 #include "../world/water.h"
 #include "drawing.h"
 
@@ -33,6 +37,20 @@ int gLastDrawStringY;
 
 uint8 _screenDirtyBlocks[5120];
 
+// Two-level dirty tracking over the flat block grid: one bit per block so the
+// per-frame scan can skip clean spans a word at a time, plus a bounding box so
+// a frame where nothing changed exits without touching the grid at all.
+// The redraw scan reads only this grid, so its row count has to follow the
+// screen height; rows are grown on demand since there is no resize hook here.
+#define DIRTY_BITS_WORDS 8 // 8 * 32 = 256 block columns
+static uint32 (*_screenDirtyBits)[DIRTY_BITS_WORDS] = NULL;
+static int _screenDirtyBitsRows = 0;
+static bool _screenDirtyAny = false;
+static int _screenDirtyLeft = 0x7FFFFFFF;
+static int _screenDirtyTop = 0x7FFFFFFF;
+static int _screenDirtyRight = -1;
+static int _screenDirtyBottom = -1;
+
 #define MAX_RAIN_PIXELS 0xFFFE
 uint32 rainPixels[MAX_RAIN_PIXELS];
 
@@ -266,9 +284,14 @@ void gfx_invalidate_screen()
  */
 void gfx_set_dirty_blocks(int left, int top, int right, int bottom)
 {
-	int x, y;
+	int x, y, rows;
 	uint8 *screenDirtyBlocks = RCT2_ADDRESS(0x00EDE408, uint8);
 
+	// Invalidations are suppressed while a turbo tick batch runs; the batch
+	// invalidates the whole screen afterwards for its preview frame
+	if (gGameTurboActive)
+		return;
+
 	left = max(left, 0);
 	top = max(top, 0);
 	right = min(right, RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_WIDTH, sint16));
@@ -290,6 +313,134 @@ void gfx_set_dirty_blocks(int left, int top, int right, int bottom)
 	for (y = top; y <= bottom; y++)
 		for (x = left; x <= right; x++)
 			screenDirtyBlocks[y * RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_COLUMNS, sint32) + x] = 0xFF;
+
+	// Grow the bit grid when an invalidation reaches below the rows
+	// allocated so far (first use, or the window got taller). The fixed
+	// column capacity covers 16K pixels of width, so only rows need to
+	// track the resolution; right is clamped to it all the same so the
+	// bounding box can never walk the scan off the end of a row.
+	if (bottom >= _screenDirtyBitsRows) {
+		rows = max(bottom + 1, RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_ROWS, sint32));
+		_screenDirtyBits = memtrack_realloc(MEMTRACK_TAG_DRAWING, _screenDirtyBits, rows * sizeof(*_screenDirtyBits));
+		memset(_screenDirtyBits + _screenDirtyBitsRows, 0, (rows - _screenDirtyBitsRows) * sizeof(*_screenDirtyBits));
+		_screenDirtyBitsRows = rows;
+	}
+	right = min(right, (DIRTY_BITS_WORDS * 32) - 1);
+
+	// Mirror into the bit grid and grow the dirty bounding box
+	for (y = top; y <= bottom; y++)
+		for (x = left; x <= right; x++)
+			_screenDirtyBits[y][x >> 5] |= 1u << (x & 31);
+
+	_screenDirtyAny = true;
+	_screenDirtyLeft = min(_screenDirtyLeft, left);
+	_screenDirtyTop = min(_screenDirtyTop, top);
+	_screenDirtyRight = max(_screenDirtyRight, right);
+	_screenDirtyBottom = max(_screenDirtyBottom, bottom);
+}
+
+/**
+ * Returns nonzero if any dirty block not yet redrawn intersects the given
+ * screen region.
+ */
+int gfx_region_is_dirty(int left, int top, int right, int bottom)
+{
+	int x, y;
+	uint8 *screenDirtyBlocks = RCT2_ADDRESS(0x00EDE408, uint8);
+
+	left = max(left, 0);
+	top = max(top, 0);
+	right = min(right, RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_WIDTH, sint16));
+	bottom = min(bottom, RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_HEIGHT, sint16));
+
+	if (left >= right)
+		return 0;
+	if (top >= bottom)
+		return 0;
+
+	right--;
+	bottom--;
+
+	left >>= RCT2_GLOBAL(0x009ABDF0, sint8);
+	right >>= RCT2_GLOBAL(0x009ABDF0, sint8);
+	top >>= RCT2_GLOBAL(0x009ABDF1, sint8);
+	bottom >>= RCT2_GLOBAL(0x009ABDF1, sint8);
+
+	for (y = top; y <= bottom; y++)
+		for (x = left; x <= right; x++)
+			if (screenDirtyBlocks[y * RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_COLUMNS, sint32) + x] != 0)
+				return 1;
+
+	return 0;
+}
+
+// Frame-scoped scratch arena for transient drawing allocations such as
+// clipped dpis. Allocating is a bump of an offset and everything is thrown
+// away in one go at the start of the next frame, so paint code pays no
+// malloc/free per temporary and cannot fragment the heap over long
+// sessions. If a frame ever outgrows the arena the remainder comes from
+// the heap and is released on the same schedule.
+#define GFX_SCRATCH_SIZE (64 * 1024)
+#define GFX_SCRATCH_MAX_OVERFLOW 64
+
+static uint8 _gfxScratch[GFX_SCRATCH_SIZE];
+static int _gfxScratchOffset = 0;
+static void *_gfxScratchOverflow[GFX_SCRATCH_MAX_OVERFLOW];
+static int _gfxScratchOverflowCount = 0;
+
+void *gfx_scratch_alloc(int size)
+{
+	void *result;
+
+	size = (size + 3) & ~3;
+	if (_gfxScratchOffset + size <= GFX_SCRATCH_SIZE) {
+		result = &_gfxScratch[_gfxScratchOffset];
+		_gfxScratchOffset += size;
+		return result;
+	}
+
+	if (_gfxScratchOverflowCount >= GFX_SCRATCH_MAX_OVERFLOW)
+		return NULL;
+
+	result = rct2_malloc(size);
+	if (result != NULL)
+		_gfxScratchOverflow[_gfxScratchOverflowCount++] = result;
+	return result;
+}
+
+void gfx_scratch_reset()
+{
+	int i;
+
+	for (i = 0; i < _gfxScratchOverflowCount; i++)
+		rct2_free(_gfxScratchOverflow[i]);
+	_gfxScratchOverflowCount = 0;
+	_gfxScratchOffset = 0;
+}
+
+// Whether the screen buffer has changed since it was last presented; starts
+// true so the first pass always presents
+static bool _presentPending = true;
+
+/**
+ * Marks the screen buffer as needing to be presented again. Used by code that
+ * draws to the screen without going through the dirty block grid (rain, the
+ * intro, the profiler overlay) and by palette and window surface changes.
+ */
+void gfx_request_present()
+{
+	_presentPending = true;
+}
+
+/**
+ * Returns whether a present is needed and clears the request; called once per
+ * pass by the main loop to decide whether to push the buffer to the window.
+ */
+bool gfx_take_present_request()
+{
+	bool pending = _presentPending;
+	_presentPending = false;
+	return pending;
 }
 
 /**
@@ -299,30 +450,61 @@ void gfx_set_dirty_blocks(int left, int top, int right, int bottom)
 void gfx_draw_all_dirty_blocks()
 {
 	int x, y, xx, yy, columns, rows;
-	uint8 *screenDirtyBlocks = RCT2_ADDRESS(0x00EDE408, uint8);
+	uint32 bits;
+
+	gfx_scratch_reset();
 
-	for (x = 0; x < RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_COLUMNS, sint32); x++) {
-		for (y = 0; y < RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_ROWS, sint32); y++) {
-			if (screenDirtyBlocks[y * RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_COLUMNS, sint32) + x] == 0)
+	if (!_screenDirtyAny)
+		return;
+	_screenDirtyAny = false;
+	_presentPending = true;
+
+	for (y = _screenDirtyTop; y <= _screenDirtyBottom; y++) {
+		x = _screenDirtyLeft;
+		while (x <= _screenDirtyRight) {
+			// Skip clean spans a word at a time
+			bits = _screenDirtyBits[y][x >> 5] >> (x & 31);
+			if (bits == 0) {
+				x = ((x >> 5) + 1) << 5;
 				continue;
+			}
+			x += bitscanforward(bits);
+			if (x > _screenDirtyRight)
+				break;
 
 			// Determine columns
-			for (xx = x; xx < RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_COLUMNS, sint32); xx++)
-				if (screenDirtyBlocks[y * RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_COLUMNS, sint32) + xx] == 0)
+			for (xx = x; xx <= _screenDirtyRight; xx++)
+				if (!(_screenDirtyBits[y][xx >> 5] & (1u << (xx & 31))))
 					break;
 			columns = xx - x;
 
-			// Check rows
-			for (yy = y; yy < RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_ROWS, sint32); yy++)
+			// Extend down while every column in the run remains dirty
+			for (yy = y + 1; yy <= _screenDirtyBottom; yy++)
 				for (xx = x; xx < x + columns; xx++)
-					if (screenDirtyBlocks[yy * RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_COLUMNS, sint32) + xx] == 0)
+					if (!(_screenDirtyBits[yy][xx >> 5] & (1u << (xx & 31))))
 						goto endRowCheck;
-			
+
 		endRowCheck:
 			rows = yy - y;
 			gfx_draw_dirty_blocks(x, y, columns, rows);
+			x += columns;
 		}
 	}
+
+	// Reset the bounding box for the next frame
+	_screenDirtyLeft = 0x7FFFFFFF;
+	_screenDirtyTop = 0x7FFFFFFF;
+	_screenDirtyRight = -1;
+	_screenDirtyBottom = -1;
+}
+
+// Cumulative count of dirty grid blocks redrawn, for the performance counter
+// export; collectors derive a redraw rate from successive samples
+static uint32 _dirtyBlocksDrawn;
+
+uint32 gfx_get_dirty_blocks_drawn()
+{
+	return _dirtyBlocksDrawn;
 }
 
 static void gfx_draw_dirty_blocks(int x, int y, int columns, int rows)
@@ -330,10 +512,15 @@ static void gfx_draw_dirty_blocks(int x, int y, int columns, int rows)
 	int left, top, right, bottom;
 	uint8 *screenDirtyBlocks = RCT2_ADDRESS(0x00EDE408, uint8);
 
+	_dirtyBlocksDrawn += columns * rows;
+
 	// Unset dirty blocks
-	for (top = y; top < y + rows; top++)
-		for (left = x; left < x + columns; left++)
+	for (top = y; top < y + rows; top++) {
+		for (left = x; left < x + columns; left++) {
 			screenDirtyBlocks[top * RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_COLUMNS, sint32) + left] = 0;
+			_screenDirtyBits[top][left >> 5] &= ~(1u << (left & 31));
+		}
+	}
 
 	// Determine region in pixels
 	left = max(0, x * RCT2_GLOBAL(RCT2_ADDRESS_DIRTY_BLOCK_WIDTH, sint16));
@@ -364,6 +551,8 @@ void gfx_redraw_screen_rect(short left, short top, short right, short bottom)
 	// Unsure what this does
 	RCT2_CALLPROC_X(0x00683326, left, top, right - 1, bottom - 1, 0, 0, 0);
 
+	viewport_paint_share_reset();
+
 	windowDPI->bits = screenDPI->bits + left + ((screenDPI->width + screenDPI->pitch) * top);
 	windowDPI->x = left;
 	windowDPI->y = top;
@@ -393,7 +582,11 @@ void gfx_redraw_screen_rect(short left, short top, short right, short bottom)
 */
 rct_drawpixelinfo* clip_drawpixelinfo(rct_drawpixelinfo* dpi, int left, int width, int top, int height)
 {
-	rct_drawpixelinfo* newDrawPixelInfo = rct2_malloc(sizeof(rct_drawpixelinfo));
+	// The clipped dpi lives in the frame scratch arena; callers must not
+	// free it and must not keep it across frames
+	rct_drawpixelinfo* newDrawPixelInfo = gfx_scratch_alloc(sizeof(rct_drawpixelinfo));
+	if (newDrawPixelInfo == NULL)
+		return NULL;
 
 	int right = left + width;
 	int bottom = top + height;
@@ -440,7 +633,6 @@ rct_drawpixelinfo* clip_drawpixelinfo(rct_drawpixelinfo* dpi, int left, int widt
 		return newDrawPixelInfo;
 	}
 
-	rct2_free(newDrawPixelInfo);
 	return NULL;
 }
 
@@ -468,39 +660,125 @@ void gfx_draw_rain(int left, int top, int width, int height, sint32 x_start, sin
 	uint32 pixel_offset = (dpi->pitch + dpi->width)*top + left;
 	uint8 pattern_y_pos = pattern_start_y_offset % pattern_y_space;
 
+	uint8* screen_bits = dpi->bits;
+
 	//Stores the colours of changed pixels
-	uint32* pixel_store = rainPixels;
-	pixel_store += RCT2_GLOBAL(RCT2_ADDRESS_NO_RAIN_PIXELS, uint32);
+	uint32 num_pixels = RCT2_GLOBAL(RCT2_ADDRESS_NO_RAIN_PIXELS, uint32);
+	uint32* pixel_store = rainPixels + num_pixels;
 
 	for (; height != 0; height--){
 
 		uint8 pattern_x = pattern[pattern_y_pos * 2];
 		if (pattern_x != 0xFF){
-			if (RCT2_GLOBAL(RCT2_ADDRESS_NO_RAIN_PIXELS, uint32) < (MAX_RAIN_PIXELS - (uint32)width)){
+			// The store is full for any remaining row of this width too
+			if (num_pixels >= (MAX_RAIN_PIXELS - (uint32)width))
+				break;
 
-				int final_pixel_offset = width + pixel_offset;
+			int final_pixel_offset = width + pixel_offset;
 
-				int x_pixel_offset = pixel_offset;
-				x_pixel_offset += ((uint8)(pattern_x - pattern_start_x_offset)) % pattern_x_space;
+			int x_pixel_offset = pixel_offset;
+			x_pixel_offset += ((uint8)(pattern_x - pattern_start_x_offset)) % pattern_x_space;
 
-				uint8 pattern_pixel = pattern[pattern_y_pos * 2 + 1];
-				for (; x_pixel_offset < final_pixel_offset; x_pixel_offset += pattern_x_space){
-					uint8 current_pixel = dpi->bits[x_pixel_offset];
-					dpi->bits[x_pixel_offset] = pattern_pixel;
-					RCT2_GLOBAL(RCT2_ADDRESS_NO_RAIN_PIXELS, uint32)++;
+			uint8 pattern_pixel = pattern[pattern_y_pos * 2 + 1];
+			for (; x_pixel_offset < final_pixel_offset; x_pixel_offset += pattern_x_space){
+				uint8 current_pixel = screen_bits[x_pixel_offset];
+				screen_bits[x_pixel_offset] = pattern_pixel;
+				num_pixels++;
+
+				//Store colour and position
+				*pixel_store++ = (x_pixel_offset << 8) | current_pixel;
 
-					//Store colour and position
-					*pixel_store++ = (x_pixel_offset << 8) | current_pixel;
-					
-				}
 			}
 		}
 
 		pixel_offset += dpi->pitch + dpi->width;
 
 		pattern_y_pos++;
-		pattern_y_pos %= pattern_y_space;
+		if (pattern_y_pos >= pattern_y_space)
+			pattern_y_pos = 0;
 	}
+
+	RCT2_GLOBAL(RCT2_ADDRESS_NO_RAIN_PIXELS, uint32) = num_pixels;
+}
+
+// Save-under stash for the picked-up peep: the screen pixels the sprite will
+// cover are copied aside just before it is drawn over the presented frame and
+// copied back at the start of the next one. Previously the covered rectangle
+// was pushed through gfx_set_dirty_blocks instead, which forced a full world
+// repaint under the pointer on every mouse move.
+static uint8 *_pickedupPeepStash = NULL;
+static uint32 _pickedupPeepStashCapacity = 0;
+static int _pickedupPeepStashX, _pickedupPeepStashY;
+static int _pickedupPeepStashWidth, _pickedupPeepStashHeight;
+static bool _pickedupPeepStashValid = false;
+
+/**
+ * Stashes the screen pixels the picked-up peep sprite is about to cover.
+ * Called immediately before the sprite is drawn, after all dirty blocks for
+ * the frame have been redrawn, so the stash is never stale when it is
+ * restored.
+ */
+void pickedup_peep_stash(int sprite, int x, int y)
+{
+	rct_drawpixelinfo *dpi = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
+	rct_g1_element *g1_elements = &RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[sprite & 0x7FFFF];
+	int stride = dpi->width + dpi->pitch;
+	int i;
+
+	int left = x + g1_elements->x_offset;
+	int top = y + g1_elements->y_offset;
+	int right = min(left + g1_elements->width, dpi->width);
+	int bottom = min(top + g1_elements->height, dpi->height);
+	left = max(left, 0);
+	top = max(top, 0);
+	if (left >= right || top >= bottom)
+		return;
+
+	int width = right - left;
+	int height = bottom - top;
+	uint32 size = width * height;
+	if (size > _pickedupPeepStashCapacity) {
+		if (_pickedupPeepStash != NULL)
+			memtrack_free(_pickedupPeepStash);
+		_pickedupPeepStash = (uint8*)memtrack_alloc(MEMTRACK_TAG_DRAWING, size);
+		_pickedupPeepStashCapacity = _pickedupPeepStash != NULL ? size : 0;
+		if (_pickedupPeepStash == NULL)
+			return;
+	}
+
+	for (i = 0; i < height; i++)
+		memcpy(_pickedupPeepStash + i * width, dpi->bits + (top + i) * stride + left, width);
+
+	_pickedupPeepStashX = left;
+	_pickedupPeepStashY = top;
+	_pickedupPeepStashWidth = width;
+	_pickedupPeepStashHeight = height;
+	_pickedupPeepStashValid = true;
+}
+
+static void pickedup_peep_restore()
+{
+	rct_drawpixelinfo *dpi = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
+	int stride = dpi->width + dpi->pitch;
+	int i;
+
+	if (!_pickedupPeepStashValid)
+		return;
+	_pickedupPeepStashValid = false;
+
+	// The screen may have been resized since the stash was taken
+	if (_pickedupPeepStashX + _pickedupPeepStashWidth > dpi->width ||
+		_pickedupPeepStashY + _pickedupPeepStashHeight > dpi->height)
+		return;
+
+	for (i = 0; i < _pickedupPeepStashHeight; i++) {
+		memcpy(
+			dpi->bits + (_pickedupPeepStashY + i) * stride + _pickedupPeepStashX,
+			_pickedupPeepStash + i * _pickedupPeepStashWidth,
+			_pickedupPeepStashWidth
+		);
+	}
+	RCT2_GLOBAL(0x009E2C78, uint32) = 1;
 }
 
 /**
@@ -510,40 +788,29 @@ void gfx_draw_rain(int left, int top, int width, int height, sint32 x_start, sin
 void redraw_peep_and_rain()
 {
 	if (RCT2_GLOBAL(0x009ABDF2, uint32) != 0) {
-		int sprite = RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_SPRITE, sint32);
-		if (sprite != -1) {
-			sprite = sprite & 0x7FFFF;
-			
-			rct_g1_element *g1_elements = &RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[sprite];
-			int left = RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_X, sint16) + g1_elements->x_offset;
-			int top = RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_Y, sint16) + g1_elements->y_offset;
-			int right = left + g1_elements->width;
-			int bottom = top + g1_elements->height;
-			
-			gfx_set_dirty_blocks(left, top, right, bottom);
-		}
-
+		// Rain is drawn over the peep, so it is restored first
 		int rain_no_pixels = RCT2_GLOBAL(RCT2_ADDRESS_NO_RAIN_PIXELS, uint32);
-		if (rain_no_pixels == 0) {
-			return;
-		}
-		rct_window *window = window_get_main();
-		uint32 numPixels = window->width * window->height;
-		
-		uint32 *rain_pixels = rainPixels;
-		if (rain_pixels) {
-			uint8 *screen_pixels = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo)->bits;
-			for (int i = 0; i < rain_no_pixels; i++) {
-				uint32 pixel = rain_pixels[i];
-				//HACK
-				if (pixel >> 8 > numPixels) {
-					log_verbose("Pixel error, skipping rain draw in this frame");
-					break;
+		if (rain_no_pixels != 0) {
+			rct_window *window = window_get_main();
+			uint32 numPixels = window->width * window->height;
+
+			uint32 *rain_pixels = rainPixels;
+			if (rain_pixels) {
+				uint8 *screen_pixels = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo)->bits;
+				for (int i = 0; i < rain_no_pixels; i++) {
+					uint32 pixel = rain_pixels[i];
+					//HACK
+					if (pixel >> 8 > numPixels) {
+						log_verbose("Pixel error, skipping rain draw in this frame");
+						break;
+					}
+					screen_pixels[pixel >> 8] = pixel & 0xFF;
 				}
-				screen_pixels[pixel >> 8] = pixel & 0xFF;
+				RCT2_GLOBAL(0x009E2C78, uint32) = 1;
 			}
-			RCT2_GLOBAL(0x009E2C78, uint32) = 1;
 		}
+
+		pickedup_peep_restore();
 	}
 	RCT2_GLOBAL(RCT2_ADDRESS_NO_RAIN_PIXELS, uint32) = 0;
 }
@@ -23,6 +23,8 @@
 
 #include "../common.h"
 
+struct format_arg;
+
 // Size: 0x10
 typedef struct {
 	char* bits;			// 0x00
@@ -48,6 +50,12 @@ typedef struct {
 enum{
 	G1_FLAG_BMP = (1 << 0), //No invisible sections
 	G1_FLAG_RLE_COMPRESSION = (1<<2),
+	// Runtime-only flags, never present in the data files. Set together by the
+	// first uncompressed draw of a sprite: the image has been scanned for
+	// transparent pixels and, if FULLY_OPAQUE is also set, contains none, so
+	// blits can copy whole rows without testing each pixel.
+	G1_FLAG_OPACITY_SCANNED = (1 << 14),
+	G1_FLAG_FULLY_OPAQUE = (1 << 15),
 };
 
 enum{
@@ -65,9 +73,15 @@ extern int gLastDrawStringX;
 extern int gLastDrawStringY;
 
 // 
+void *gfx_scratch_alloc(int size);
+void gfx_scratch_reset();
 rct_drawpixelinfo* clip_drawpixelinfo(rct_drawpixelinfo* dpi, int left, int width, int top, int height);
 void gfx_set_dirty_blocks(int left, int top, int right, int bottom);
+int gfx_region_is_dirty(int left, int top, int right, int bottom);
 void gfx_draw_all_dirty_blocks();
+uint32 gfx_get_dirty_blocks_drawn();
+void gfx_request_present();
+bool gfx_take_present_request();
 void gfx_redraw_screen_rect(short left, short top, short right, short bottom);
 void gfx_invalidate_scrollingtext(int x, int y, int base_height, int clearance_height);
 void gfx_invalidate_screen();
@@ -87,22 +101,30 @@ void gfx_draw_line(rct_drawpixelinfo *dpi, int x1, int y1, int x2, int y2, int c
 // rect
 void gfx_fill_rect(rct_drawpixelinfo *dpi, int left, int top, int right, int bottom, int colour);
 void gfx_fill_rect_inset(rct_drawpixelinfo* dpi, short left, short top, short right, short bottom, int colour, short _si);
+int gfx_sse2_available();
 
 // sprite
 int gfx_load_g1();
 void gfx_bmp_sprite_to_buffer(uint8* palette_pointer, uint8* unknown_pointer, uint8* source_pointer, uint8* dest_pointer, rct_g1_element* source_image, rct_drawpixelinfo *dest_dpi, int height, int width, int image_type);
 void gfx_rle_sprite_to_buffer(uint8* source_bits_pointer, uint8* dest_bits_pointer, uint8* palette_pointer, rct_drawpixelinfo *dpi, int image_type, int source_y_start, int height, int source_x_start, int width);
 void gfx_draw_sprite(rct_drawpixelinfo *dpi, int image_id, int x, int y, uint32 tertiary_colour);
+void gfx_invalidate_decoded_sprite_cache();
+void gfx_generate_sprite_mips(int firstIndex, int count);
 void gfx_draw_sprite_palette_set(rct_drawpixelinfo *dpi, int image_id, int x, int y, uint8* palette_pointer, uint8* unknown_pointer);
 
+// benchgfx
+void gfx_benchmark();
+
 // string
 void gfx_load_character_widths();
 int clip_text(char *buffer, int width);
 int gfx_wrap_string(char* buffer, int width, int* num_lines, int* font_height);
+int gfx_clip_string(char* buffer, int width);
 int gfx_get_string_width(char *buffer);
 int gfx_get_string_width_new_lined(char* buffer);
 void gfx_draw_string(rct_drawpixelinfo *dpi, char *buffer, int colour, int x, int y);
 void gfx_draw_string_left(rct_drawpixelinfo *dpi, int format, void *args, int colour, int x, int y);
+void gfx_draw_string_left_args(rct_drawpixelinfo *dpi, int format, const struct format_arg *args, int count, int colour, int x, int y);
 void gfx_draw_string_left_clipped(rct_drawpixelinfo *dpi, int format, void *args, int colour, int x, int y, int width);
 int gfx_draw_string_left_wrapped(rct_drawpixelinfo *dpi, void *args, int x, int y, int width, int format, int colour);
 void draw_string_left_underline(rct_drawpixelinfo *dpi, int format, void *args, int colour, int x, int y);
@@ -117,5 +139,6 @@ void draw_string_right_underline(rct_drawpixelinfo *dpi, int format, void *args,
 // rain
 void update_rain_animation();
 void redraw_peep_and_rain();
+void pickedup_peep_stash(int sprite, int x, int y);
 
 #endif
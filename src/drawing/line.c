@@ -116,6 +116,8 @@ void gfx_draw_line(rct_drawpixelinfo *dpi, int x1, int y1, int x2, int y2, int c
 	}
 
 	int delta_x = x2 - x1;
+	if (delta_x <= 0)
+		return;
 	int delta_y = abs(y2 - y1);
 	int error = delta_x / 2;
 	int y_step;
@@ -125,14 +127,67 @@ void gfx_draw_line(rct_drawpixelinfo *dpi, int x1, int y1, int x2, int y2, int c
 	if (y1 < y2)y_step = 1;
 	else y_step = -1;
 
-	for (int x = x1, x_start = x1, no_pixels = 1; x < x2; ++x,++no_pixels){
+	// Clip bounds along the stepping (major) axis and the other (minor)
+	// axis, in the post swap coordinate space
+	int majorMin, majorMax, minorMin, minorMax;
+	if (steep) {
+		majorMin = dpi->y;
+		minorMin = dpi->x;
+		majorMax = majorMin + dpi->height - 1;
+		minorMax = minorMin + dpi->width - 1;
+	} else {
+		majorMin = dpi->x;
+		minorMin = dpi->y;
+		majorMax = majorMin + dpi->width - 1;
+		minorMax = minorMin + dpi->height - 1;
+	}
+
+	// Jump analytically to just before the left clip edge instead of
+	// stepping pixel by pixel towards it: the number of minor axis steps
+	// taken over any prefix of the line follows directly from the
+	// accumulated error. Resuming one pixel early lets the loop replay the
+	// span boundary there, as spans overlap their successor by one pixel
+	int x = x1;
+	int no_pixels = 1;
+	if (x < majorMin - 1) {
+		int skip = (majorMin - 1) - x;
+		int ySteps = 0;
+		if (skip * delta_y > error)
+			ySteps = (skip * delta_y - error + delta_x - 1) / delta_x;
+		y += ySteps * y_step;
+		error += ySteps * delta_x - skip * delta_y;
+		x = majorMin - 1;
+		// The counter runs one ahead after a minor axis step
+		if (ySteps != 0)
+			no_pixels = 2;
+	}
+	int x_start = x;
+
+	// Stop stepping at the right clip edge; the span cut there is emitted
+	// after the loop
+	int xEnd = x2;
+	if (xEnd > majorMax + 1)
+		xEnd = majorMax + 1;
+
+	int pitch = dpi->width + dpi->pitch;
+	uint8 *bits = (uint8*)dpi->bits;
+
+	for (; x < xEnd; ++x, ++no_pixels){
 		//Vertical lines are drawn 1 pixel at a time
-		if (steep)gfx_draw_line_on_buffer(dpi, colour, x, y, 1);
+		if (steep && x >= majorMin && y >= minorMin && y <= minorMax)
+			bits[(x - majorMin) * pitch + (y - minorMin)] = colour;
 
 		error -= delta_y;
 		if (error < 0){
 			//Non vertical lines are drawn with as many pixels in a horizontal line as possible
-			if (!steep)gfx_draw_line_on_buffer(dpi, colour, y, x_start, no_pixels);
+			if (!steep && y >= minorMin && y <= minorMax){
+				int spanStart = x_start < majorMin ? majorMin : x_start;
+				int spanEnd = x_start + no_pixels - 1;
+				if (spanEnd > majorMax)
+					spanEnd = majorMax;
+				if (spanEnd >= spanStart)
+					memset(bits + (y - minorMin) * pitch + (spanStart - majorMin), colour & 0xFF, spanEnd - spanStart + 1);
+			}
 
 			//Reset non vertical line vars
 			x_start = x + 1;
@@ -142,9 +197,20 @@ void gfx_draw_line(rct_drawpixelinfo *dpi, int x1, int y1, int x2, int y2, int c
 		}
 
 		//Catch the case of the last line
-		if (x + 1 == x2 && !steep){
-			gfx_draw_line_on_buffer(dpi, colour, y, x_start, no_pixels);
+		if (x + 1 == x2 && !steep && y >= minorMin && y <= minorMax){
+			int spanStart = x_start < majorMin ? majorMin : x_start;
+			int spanEnd = x_start + no_pixels - 1;
+			if (spanEnd > majorMax)
+				spanEnd = majorMax;
+			if (spanEnd >= spanStart)
+				memset(bits + (y - minorMin) * pitch + (spanStart - majorMin), colour & 0xFF, spanEnd - spanStart + 1);
 		}
 	}
-	return;
+
+	// The line continues past the right clip edge; emit the visible part of
+	// the span it was cut in
+	if (!steep && xEnd < x2 && x_start <= majorMax && y >= minorMin && y <= minorMax){
+		int spanStart = x_start < majorMin ? majorMin : x_start;
+		memset(bits + (y - minorMin) * pitch + (spanStart - majorMin), colour & 0xFF, majorMax - spanStart + 1);
+	}
 }
\ No newline at end of file
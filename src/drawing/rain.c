@@ -19,6 +19,7 @@
  *****************************************************************************/
 
 #include "../addresses.h"
+#include "../interface/rendergovernor.h"
 #include "../interface/window.h"
 #include "drawing.h"
 
@@ -155,20 +156,35 @@ void update_rain_animation()
 	if (RCT2_GLOBAL(0x009ABDF2, uint8) == 0)
 		return;
 
-	// Draw picked-up peep
+	// Draw picked-up peep, stashing the pixels it covers so the next frame
+	// can put them back without invalidating anything
 	if (RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_SPRITE, uint32) != 0xFFFFFFFF) {
+		pickedup_peep_stash(
+			RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_SPRITE, uint32),
+			RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_X, sint16),
+			RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_Y, sint16)
+		);
 		gfx_draw_sprite(
 			(rct_drawpixelinfo*)RCT2_ADDRESS_SCREEN_DPI,
 			RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_SPRITE, uint32),
 			RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_X, sint16),
 			RCT2_GLOBAL(RCT2_ADDRESS_PICKEDUP_PEEP_Y, sint16), 0
 		);
+		gfx_request_present();
 	}
 
 	// Get rain draw function and draw rain
 	uint32 draw_rain_func = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_RAIN_LEVEL, uint8);
-	if (draw_rain_func > 0 && !(RCT2_GLOBAL(0x009DEA6F, uint8) & 1))
+	// Rain goes through the unbuffered overlay path, so it is one of the
+	// cheapest effects for the render governor to shed under load
+	if (gRenderGovernorLevel >= 3)
+		draw_rain_func = 0;
+	else if (gRenderGovernorLevel >= 2 && draw_rain_func > 1)
+		draw_rain_func = 1;
+	if (draw_rain_func > 0 && !(RCT2_GLOBAL(0x009DEA6F, uint8) & 1)) {
 		draw_rain_animation(draw_rain_func);
+		gfx_request_present();
+	}
 }
 
 /**
@@ -18,10 +18,83 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+#include <SDL.h>
 #include "../addresses.h"
 #include "../common.h"
 #include "drawing.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// Whether the SSE2 fill kernels may be used, determined on first fill
+static int _sse2Available = -1;
+
+int gfx_sse2_available()
+{
+	if (_sse2Available < 0)
+		_sse2Available = SDL_HasSSE2();
+	return _sse2Available;
+}
+
+#ifdef __SSE2__
+
+/**
+ * Fills every other pixel of a row, starting at parity (0 or 1), by blending a
+ * colour vector into the destination under an alternating byte mask.
+ */
+static void gfx_fill_rect_hatch_row_sse2(uint8 *dst, int width, uint8 colour, int parity)
+{
+	int i;
+	__m128i vMask, vColour, v;
+	uint8 maskBytes[16];
+
+	for (i = 0; i < 16; i++)
+		maskBytes[i] = ((i + parity) & 1) ? 0 : 0xFF;
+	vMask = _mm_loadu_si128((__m128i*)maskBytes);
+	vColour = _mm_and_si128(_mm_set1_epi8(colour), vMask);
+
+	while (width >= 16) {
+		v = _mm_loadu_si128((__m128i*)dst);
+		v = _mm_or_si128(_mm_andnot_si128(vMask, v), vColour);
+		_mm_storeu_si128((__m128i*)dst, v);
+		dst += 16;
+		width -= 16;
+	}
+	for (i = 0; i < width; i++)
+		if (((i + parity) & 1) == 0)
+			dst[i] = colour;
+}
+
+/**
+ * Fills the pixels of a row selected by a 16 bit repeating pattern. The
+ * pattern repeats every 16 pixels so it expands to exactly one byte mask.
+ */
+static void gfx_fill_rect_pattern_row_sse2(uint8 *dst, int width, uint8 colour, uint16 pattern, int patternX)
+{
+	int i;
+	__m128i vMask, vColour, v;
+	uint8 maskBytes[16];
+
+	for (i = 0; i < 16; i++)
+		maskBytes[i] = (pattern & (1 << ((patternX + i) & 15))) ? 0xFF : 0;
+	vMask = _mm_loadu_si128((__m128i*)maskBytes);
+	vColour = _mm_and_si128(_mm_set1_epi8(colour), vMask);
+
+	while (width >= 16) {
+		v = _mm_loadu_si128((__m128i*)dst);
+		v = _mm_or_si128(_mm_andnot_si128(vMask, v), vColour);
+		_mm_storeu_si128((__m128i*)dst, v);
+		dst += 16;
+		width -= 16;
+	}
+	for (i = 0; i < width; i++)
+		if (maskBytes[i])
+			dst[i] = colour;
+}
+
+#endif // __SSE2__
+
 /**
  *
  *  rct2: 0x00678AD4
@@ -79,7 +152,18 @@ void gfx_fill_rect(rct_drawpixelinfo *dpi, int left, int top, int right, int bot
 		// 00678B2E    00678BE5
 		//Cross hatching
 		uint8* dest_pointer = (start_y * (dpi->width + dpi->pitch)) + start_x + dpi->bits;
-	
+
+#ifdef __SSE2__
+		if (gfx_sse2_available()) {
+			for (int i = 0; i < height; ++i) {
+				gfx_fill_rect_hatch_row_sse2(dest_pointer, width, colour & 0xFF, cross_pattern & 1);
+				cross_pattern ^= 1;
+				dest_pointer += dpi->width + dpi->pitch;
+			}
+			return;
+		}
+#endif
+
 		uint32 ecx;
 		for (int i = 0; i < height; ++i) {
 			uint8* next_dest_pointer = dest_pointer + dpi->width + dpi->pitch;
@@ -140,6 +224,17 @@ void gfx_fill_rect(rct_drawpixelinfo *dpi, int left, int top, int right, int bot
 		uint16* pattern_pointer;
 		pattern_pointer = RCT2_ADDRESS(0x0097FEFC,uint16*)[colour >> 28]; // or possibly uint8)[esi*4] ?
 
+#ifdef __SSE2__
+		if (gfx_sse2_available()) {
+			for (int no_lines = height; no_lines > 0; no_lines--) {
+				gfx_fill_rect_pattern_row_sse2((uint8*)dest_pointer, width, colour & 0xFF, pattern_pointer[pattern_y], pattern_x);
+				pattern_y = (pattern_y + 1) % 16;
+				dest_pointer += dpi->width + dpi->pitch;
+			}
+			return;
+		}
+#endif
+
 		for (int no_lines = height; no_lines > 0; no_lines--) {
 			char* next_dest_pointer = dest_pointer + dpi->width + dpi->pitch;
 			uint16 pattern = pattern_pointer[pattern_y]; 
@@ -20,53 +20,518 @@
 
 #include "../addresses.h"
 #include "../common.h"
+#include "../config.h"
+#include "../platform/platform.h"
+#include "../util/memtrack.h"
 #include "drawing.h"
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 typedef struct {
 	uint32 num_entries;
 	uint32 total_size;
 } rct_g1_header;
 
 void *_g1Buffer = NULL;
+static uint32 _g1NumEntries = 0;
+static file_mapping _g1FileMapping;
+
+// Cache of fully decoded RLE sprites so hot images (peep frames mostly) blit
+// row by row instead of re-walking the run length stream every draw. Entries
+// are hashed by image index and evicted least recently used once the byte
+// budget (general.sprite_cache_size, in MiB) is exceeded.
+#define DECODED_SPRITE_HASH_SIZE 1024
+
+typedef struct decoded_sprite {
+	sint32 imageElement;
+	uint32 size;
+	uint8 *bits;
+	struct decoded_sprite *nextHash;
+	struct decoded_sprite *lruPrev;
+	struct decoded_sprite *lruNext;
+} decoded_sprite;
+
+static decoded_sprite *_decodedSpriteHash[DECODED_SPRITE_HASH_SIZE];
+static decoded_sprite *_decodedSpriteLruHead = NULL;
+static decoded_sprite *_decodedSpriteLruTail = NULL;
+static uint32 _decodedSpriteCacheSize = 0;
+
+static void decoded_sprite_lru_unlink(decoded_sprite *sprite)
+{
+	if (sprite->lruPrev != NULL)
+		sprite->lruPrev->lruNext = sprite->lruNext;
+	else
+		_decodedSpriteLruHead = sprite->lruNext;
+	if (sprite->lruNext != NULL)
+		sprite->lruNext->lruPrev = sprite->lruPrev;
+	else
+		_decodedSpriteLruTail = sprite->lruPrev;
+}
+
+static void decoded_sprite_lru_push_front(decoded_sprite *sprite)
+{
+	sprite->lruPrev = NULL;
+	sprite->lruNext = _decodedSpriteLruHead;
+	if (_decodedSpriteLruHead != NULL)
+		_decodedSpriteLruHead->lruPrev = sprite;
+	_decodedSpriteLruHead = sprite;
+	if (_decodedSpriteLruTail == NULL)
+		_decodedSpriteLruTail = sprite;
+}
+
+static void decoded_sprite_evict(decoded_sprite *sprite)
+{
+	decoded_sprite **link = &_decodedSpriteHash[sprite->imageElement & (DECODED_SPRITE_HASH_SIZE - 1)];
+	while (*link != sprite)
+		link = &(*link)->nextHash;
+	*link = sprite->nextHash;
+
+	decoded_sprite_lru_unlink(sprite);
+	_decodedSpriteCacheSize -= sprite->size;
+	memtrack_free(sprite->bits);
+	memtrack_free(sprite);
+}
+
+void gfx_invalidate_decoded_sprite_cache()
+{
+	while (_decodedSpriteLruTail != NULL)
+		decoded_sprite_evict(_decodedSpriteLruTail);
+}
+
+static void gfx_decode_rle_sprite(rct_g1_element *g1, uint8 *bits)
+{
+	int y;
+
+	memset(bits, 0, g1->width * g1->height);
+	for (y = 0; y < g1->height; y++) {
+		uint8 *src = g1->offset + ((uint16*)g1->offset)[y];
+		uint8 *dstRow = bits + (y * g1->width);
+		int lastRun = 0;
+		while (!lastRun) {
+			int numPixels = *src++;
+			int xOffset = *src++;
+			lastRun = numPixels & 0x80;
+			numPixels &= 0x7F;
+			memcpy(dstRow + xOffset, src, numPixels);
+			src += numPixels;
+		}
+	}
+}
+
+/**
+ * Returns a raw width * height bitmap for an RLE compressed g1 element, where
+ * zero means transparent. Only base g1 images are cached; object images are
+ * loaded and unloaded behind our back so they fall back to the RLE blitter.
+ */
+static uint8 *gfx_get_decoded_rle_sprite(int imageElement, rct_g1_element *g1)
+{
+	decoded_sprite *sprite;
+	uint32 budget = gConfigGeneral.sprite_cache_size << 20;
+
+	if (budget == 0 || imageElement >= (int)_g1NumEntries)
+		return NULL;
+
+	for (sprite = _decodedSpriteHash[imageElement & (DECODED_SPRITE_HASH_SIZE - 1)]; sprite != NULL; sprite = sprite->nextHash) {
+		if (sprite->imageElement == imageElement) {
+			if (sprite != _decodedSpriteLruHead) {
+				decoded_sprite_lru_unlink(sprite);
+				decoded_sprite_lru_push_front(sprite);
+			}
+			return sprite->bits;
+		}
+	}
+
+	sprite = memtrack_alloc(MEMTRACK_TAG_DRAWING, sizeof(decoded_sprite));
+	sprite->imageElement = imageElement;
+	sprite->size = g1->width * g1->height;
+	sprite->bits = memtrack_alloc(MEMTRACK_TAG_DRAWING, sprite->size);
+	gfx_decode_rle_sprite(g1, sprite->bits);
+
+	sprite->nextHash = _decodedSpriteHash[imageElement & (DECODED_SPRITE_HASH_SIZE - 1)];
+	_decodedSpriteHash[imageElement & (DECODED_SPRITE_HASH_SIZE - 1)] = sprite;
+	decoded_sprite_lru_push_front(sprite);
+	_decodedSpriteCacheSize += sprite->size;
+
+	while (_decodedSpriteCacheSize > budget && _decodedSpriteLruTail != sprite)
+		decoded_sprite_evict(_decodedSpriteLruTail);
+
+	return sprite->bits;
+}
+
+// Generated mip levels (2x, 4x and 8x point sampled reductions) for g1
+// elements without an authored zoomed variant (flag 1<<4 and zoomed_offset
+// only cover some images), so zoomed out views read 1/4 to 1/64 of the
+// pixels instead of decimating the full resolution sprite on every draw.
+// Kept in a native side table because the g1 element table lives at a fixed
+// address with no spare capacity for extra entries.
+#define SPRITE_MIP_LEVELS 3
+#define SPRITE_MIP_CACHE_VERSION 1
+
+typedef struct {
+	// offset is NULL for levels that were not generated; when share is set
+	// the offsets point into a reference counted entry shared with other
+	// images that decoded to the same pixels
+	rct_g1_element levels[SPRITE_MIP_LEVELS];
+	struct mip_share_entry *share;
+} sprite_mips;
+
+// Similar objects frequently carry identical frames (common across the
+// tracked ride set especially), and each loaded copy would otherwise get its
+// own generated mip chain. Chains are deduplicated by a content hash of the
+// decoded source pixels and reference counted, so repeated frames share one
+// set of reduced bitmaps; that also keeps the zoomed blitters touching the
+// same memory for repeated sprites. The source payloads themselves live in
+// the object chunks, which the original exe allocates and frees, so those
+// cannot be shared from here.
+#define MIP_SHARE_HASH_SIZE 1024
+
+typedef struct mip_share_entry {
+	uint64 hash;
+	sint16 width, height;
+	uint32 refCount;
+	rct_g1_element levels[SPRITE_MIP_LEVELS];
+	struct mip_share_entry *nextHash;
+} mip_share_entry;
+
+static mip_share_entry *_mipShareHash[MIP_SHARE_HASH_SIZE];
+
+static uint64 mip_share_hash_bits(const uint8 *bits, int size)
+{
+	// 64 bit FNV-1a; a 32 bit hash has a realistic birthday collision
+	// chance over the tens of thousands of images a park can load
+	uint64 hash = 14695981039346656037ULL;
+	int i;
+
+	for (i = 0; i < size; i++) {
+		hash ^= bits[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+static mip_share_entry *mip_share_find(uint64 hash, sint16 width, sint16 height)
+{
+	mip_share_entry *entry;
+
+	for (entry = _mipShareHash[(uint32)hash & (MIP_SHARE_HASH_SIZE - 1)]; entry != NULL; entry = entry->nextHash)
+		if (entry->hash == hash && entry->width == width && entry->height == height)
+			return entry;
+
+	return NULL;
+}
+
+static void mip_share_release(mip_share_entry *entry)
+{
+	mip_share_entry **link;
+	int level;
+
+	if (--entry->refCount != 0)
+		return;
+
+	link = &_mipShareHash[(uint32)entry->hash & (MIP_SHARE_HASH_SIZE - 1)];
+	while (*link != entry)
+		link = &(*link)->nextHash;
+	*link = entry->nextHash;
+
+	for (level = 0; level < SPRITE_MIP_LEVELS; level++)
+		memtrack_free(entry->levels[level].offset);
+	memtrack_free(entry);
+}
+
+static sprite_mips *_spriteMips = NULL;
+static uint32 _spriteMipsCapacity = 0;
+
+static void sprite_mips_ensure_capacity(uint32 capacity)
+{
+	if (capacity <= _spriteMipsCapacity)
+		return;
+
+	_spriteMips = memtrack_realloc(MEMTRACK_TAG_DRAWING, _spriteMips, capacity * sizeof(sprite_mips));
+	memset(_spriteMips + _spriteMipsCapacity, 0, (capacity - _spriteMipsCapacity) * sizeof(sprite_mips));
+	_spriteMipsCapacity = capacity;
+}
+
+static void sprite_mips_free(sprite_mips *mips)
+{
+	int level;
+
+	if (mips->share != NULL) {
+		// The bitmaps belong to the shared entry
+		mip_share_release(mips->share);
+		mips->share = NULL;
+		for (level = 0; level < SPRITE_MIP_LEVELS; level++)
+			mips->levels[level].offset = NULL;
+		return;
+	}
+
+	for (level = 0; level < SPRITE_MIP_LEVELS; level++) {
+		memtrack_free(mips->levels[level].offset);
+		mips->levels[level].offset = NULL;
+	}
+}
+
+static rct_g1_element *gfx_get_sprite_mip(int imageElement, int level)
+{
+	rct_g1_element *mip;
+
+	if ((uint32)imageElement >= _spriteMipsCapacity)
+		return NULL;
+
+	mip = &_spriteMips[imageElement].levels[level - 1];
+	return mip->offset != NULL ? mip : NULL;
+}
+
+/**
+ * Generates the mip chain for a range of g1 elements. Also called when an
+ * object image directory is loaded; object slots are reused, so overwriting
+ * the range drops whatever was generated for the previous occupant.
+ */
+void gfx_generate_sprite_mips(int firstIndex, int count)
+{
+	rct_g1_element *g1Elements = RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element);
+	int i, level, x, y;
+
+	sprite_mips_ensure_capacity(firstIndex + count);
+	for (i = firstIndex; i < firstIndex + count; i++) {
+		sprite_mips *mips = &_spriteMips[i];
+		rct_g1_element *g1 = &g1Elements[i];
+		mip_share_entry *entry;
+		uint64 hash;
+		uint8 *bits;
+
+		sprite_mips_free(mips);
+
+		// Images with an authored zoomed variant (or that are skipped when
+		// zoomed) already have a cheap path; palettes and the 0x02 packed
+		// format are never drawn zoomed out
+		if (g1->flags & ((1 << 4) | (1 << 5) | 0x02))
+			continue;
+		if (g1->offset == NULL || g1->width < 2 || g1->height < 2)
+			continue;
+
+		// Start from a raw width * height bitmap where zero is transparent
+		bits = malloc(g1->width * g1->height);
+		if (g1->flags & G1_FLAG_RLE_COMPRESSION)
+			gfx_decode_rle_sprite(g1, bits);
+		else
+			memcpy(bits, g1->offset, g1->width * g1->height);
+
+		// An image with the same pixels may have been seen before; adopt
+		// its chain rather than generating another copy. The draw offsets
+		// are per image, so those come from this element
+		hash = mip_share_hash_bits(bits, g1->width * g1->height);
+		entry = mip_share_find(hash, g1->width, g1->height);
+		if (entry != NULL) {
+			entry->refCount++;
+			mips->share = entry;
+			for (level = 1; level <= SPRITE_MIP_LEVELS; level++) {
+				mips->levels[level - 1] = entry->levels[level - 1];
+				mips->levels[level - 1].x_offset = g1->x_offset / (1 << level);
+				mips->levels[level - 1].y_offset = g1->y_offset / (1 << level);
+			}
+			free(bits);
+			continue;
+		}
+
+		for (level = 1; level <= SPRITE_MIP_LEVELS; level++) {
+			rct_g1_element *mip = &mips->levels[level - 1];
+			int zoom_amount = 1 << level;
+			int mipWidth = (g1->width + zoom_amount - 1) >> level;
+			int mipHeight = (g1->height + zoom_amount - 1) >> level;
+			uint8 *mipBits = memtrack_alloc(MEMTRACK_TAG_DRAWING, mipWidth * mipHeight);
+
+			// Point sample every 2^level-th pixel, the same stride the
+			// blitters use when decimating a full resolution sprite
+			for (y = 0; y < mipHeight; y++)
+				for (x = 0; x < mipWidth; x++)
+					mipBits[y * mipWidth + x] = bits[(y << level) * g1->width + (x << level)];
+
+			mip->offset = mipBits;
+			mip->width = mipWidth;
+			mip->height = mipHeight;
+			mip->x_offset = g1->x_offset / zoom_amount;
+			mip->y_offset = g1->y_offset / zoom_amount;
+			//Transparent pixels are zero, which the bmp loops skip
+			mip->flags = G1_FLAG_BMP;
+			mip->zoomed_offset = 0;
+		}
+		free(bits);
+
+		// Register the fresh chain so further identical images share it
+		entry = memtrack_alloc(MEMTRACK_TAG_DRAWING, sizeof(mip_share_entry));
+		entry->hash = hash;
+		entry->width = g1->width;
+		entry->height = g1->height;
+		entry->refCount = 1;
+		for (level = 0; level < SPRITE_MIP_LEVELS; level++)
+			entry->levels[level] = mips->levels[level];
+		entry->nextHash = _mipShareHash[(uint32)hash & (MIP_SHARE_HASH_SIZE - 1)];
+		_mipShareHash[(uint32)hash & (MIP_SHARE_HASH_SIZE - 1)] = entry;
+		mips->share = entry;
+	}
+}
+
+static void sprite_mips_cache_path(char *path)
+{
+	platform_get_user_directory(path, NULL);
+	strcat(path, "g1mips.dat");
+}
+
+/**
+ * Loads the base g1 mip chain from the disk cache. Returns 0 if the cache is
+ * missing or was generated from a different g1.dat.
+ */
+static int sprite_mips_load_cache(rct_g1_header *header)
+{
+	char path[MAX_PATH];
+	FILE *file;
+	uint32 fileHeader[3];
+	unsigned int i;
+	int level, success;
+
+	sprite_mips_cache_path(path);
+	file = fopen(path, "rb");
+	if (file == NULL)
+		return 0;
+
+	if (fread(fileHeader, sizeof(fileHeader), 1, file) != 1 ||
+		fileHeader[0] != SPRITE_MIP_CACHE_VERSION ||
+		fileHeader[1] != header->total_size ||
+		fileHeader[2] != header->num_entries
+	) {
+		fclose(file);
+		return 0;
+	}
+
+	sprite_mips_ensure_capacity(header->num_entries);
+	success = 1;
+	for (i = 0; success && i < header->num_entries; i++) {
+		for (level = 0; level < SPRITE_MIP_LEVELS; level++) {
+			rct_g1_element *mip = &_spriteMips[i].levels[level];
+			sint16 sizes[4];
+
+			if (fread(sizes, sizeof(sizes), 1, file) != 1) {
+				success = 0;
+				break;
+			}
+			if (sizes[0] == 0)
+				continue;
+
+			mip->width = sizes[0];
+			mip->height = sizes[1];
+			mip->x_offset = sizes[2];
+			mip->y_offset = sizes[3];
+			mip->flags = G1_FLAG_BMP;
+			mip->zoomed_offset = 0;
+			mip->offset = memtrack_alloc(MEMTRACK_TAG_DRAWING, mip->width * mip->height);
+			if (fread(mip->offset, mip->width * mip->height, 1, file) != 1) {
+				success = 0;
+				break;
+			}
+		}
+	}
+	fclose(file);
+
+	if (!success) {
+		log_error("%s is truncated, regenerating", path);
+		for (i = 0; i < header->num_entries; i++)
+			sprite_mips_free(&_spriteMips[i]);
+	}
+	return success;
+}
+
+static void sprite_mips_save_cache(rct_g1_header *header)
+{
+	char path[MAX_PATH];
+	FILE *file;
+	uint32 fileHeader[3] = { SPRITE_MIP_CACHE_VERSION, header->total_size, header->num_entries };
+	unsigned int i;
+	int level;
+
+	sprite_mips_cache_path(path);
+	file = fopen(path, "wb");
+	if (file == NULL) {
+		log_error("Unable to write %s", path);
+		return;
+	}
+
+	fwrite(fileHeader, sizeof(fileHeader), 1, file);
+	for (i = 0; i < header->num_entries; i++) {
+		for (level = 0; level < SPRITE_MIP_LEVELS; level++) {
+			rct_g1_element *mip = &_spriteMips[i].levels[level];
+			sint16 sizes[4] = { 0, 0, 0, 0 };
+
+			if (mip->offset != NULL) {
+				sizes[0] = mip->width;
+				sizes[1] = mip->height;
+				sizes[2] = mip->x_offset;
+				sizes[3] = mip->y_offset;
+			}
+			fwrite(sizes, sizeof(sizes), 1, file);
+			if (mip->offset != NULL)
+				fwrite(mip->offset, mip->width * mip->height, 1, file);
+		}
+	}
+	fclose(file);
+	log_verbose("g1 sprite mips cached to %s", path);
+}
 
 /**
- * 
+ *
  *  rct2: 0x00678998
  */
 int gfx_load_g1()
 {
 	log_verbose("loading g1 graphics");
 
-	FILE *file;
 	rct_g1_header header;
 	unsigned int i;
+	uint32 tableSize;
 
 	rct_g1_element *g1Elements = RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element);
 
-	file = fopen(get_file_path(PATH_ID_G1), "rb");
-	if (file != NULL) {
-		if (fread(&header, 8, 1, file) == 1) {
-			// number of elements is stored in g1.dat, but because the entry headers are static, this can't be variable until
-			// made into a dynamic array
-			header.num_entries = 29294;
+	// The file is mapped rather than read. The element table is copied into
+	// the fixed address table everything indexes, but the pixel data stays
+	// in the mapping, so sprites get paged in by the OS as they are first
+	// drawn instead of all being read and held resident up front. Nothing
+	// writes through the element offsets, so a read only view suffices.
+	if (platform_file_map(get_file_path(PATH_ID_G1), &_g1FileMapping)) {
+		memcpy(&header, _g1FileMapping.data, 8);
 
-			// Read element headers
-			fread(g1Elements, header.num_entries * sizeof(rct_g1_element), 1, file);
+		// number of elements is stored in g1.dat, but because the entry headers are static, this can't be variable until
+		// made into a dynamic array
+		header.num_entries = 29294;
 
-			// Read element data
-			_g1Buffer = rct2_malloc(header.total_size);
-			fread(_g1Buffer, header.total_size, 1, file);
+		tableSize = header.num_entries * sizeof(rct_g1_element);
+		if (_g1FileMapping.size >= 8 + tableSize + header.total_size) {
+			// Copy element headers
+			memcpy(g1Elements, _g1FileMapping.data + 8, tableSize);
 
-			fclose(file);
+			// Element data stays in the mapping
+			_g1Buffer = _g1FileMapping.data + 8 + tableSize;
 
 			// Fix entry data offsets
 			for (i = 0; i < header.num_entries; i++)
 				g1Elements[i].offset += (int)_g1Buffer;
 
+			_g1NumEntries = header.num_entries;
+			gfx_invalidate_decoded_sprite_cache();
+
+			// Generating mips over the whole base table takes a noticeable
+			// time, so the result is kept on disk keyed on the g1 data size.
+			// Generation touches every sprite, so only runs with a cold mip
+			// cache pay for paging the whole file in at startup.
+			if (!sprite_mips_load_cache(&header)) {
+				gfx_generate_sprite_mips(0, header.num_entries);
+				sprite_mips_save_cache(&header);
+			}
+
 			// Successful
 			return 1;
 		}
-		fclose(file);
+		platform_file_unmap(&_g1FileMapping);
 	}
 
 	// Unsuccessful
@@ -74,6 +539,58 @@ int gfx_load_g1()
 	return 0;
 }
 
+/**
+ * Determines, once per sprite, whether an uncompressed image contains any
+ * transparent pixels. Fully opaque images let gfx_bmp_sprite_to_buffer copy
+ * whole rows without testing each pixel; UI panels and icons hit that path
+ * constantly. The result is cached in two runtime-only g1 flags.
+ */
+static void gfx_bmp_scan_opacity(rct_g1_element *g1)
+{
+	if (g1->flags & G1_FLAG_OPACITY_SCANNED)
+		return;
+	g1->flags |= G1_FLAG_OPACITY_SCANNED;
+
+	int count = g1->width * g1->height;
+	uint8 *pixels = g1->offset;
+	for (int i = 0; i < count; i++){
+		if (pixels[i] == 0)
+			return;
+	}
+	g1->flags |= G1_FLAG_FULLY_OPAQUE;
+}
+
+#ifdef __SSE2__
+
+/**
+ * Copies one clipped row of an uncompressed sprite, sixteen pixels at a time,
+ * keeping the destination wherever the source is transparent.
+ */
+static void gfx_bmp_copy_row_sse2(uint8 *dst, const uint8 *src, int width)
+{
+	const __m128i zero = _mm_setzero_si128();
+	int i = 0;
+
+	for (; i + 16 <= width; i += 16){
+		__m128i pixels = _mm_loadu_si128((const __m128i*)(src + i));
+		__m128i transparent = _mm_cmpeq_epi8(pixels, zero);
+		int mask = _mm_movemask_epi8(transparent);
+		if (mask == 0xFFFF)
+			continue;
+		if (mask != 0){
+			__m128i dest = _mm_loadu_si128((const __m128i*)(dst + i));
+			pixels = _mm_or_si128(_mm_and_si128(transparent, dest), _mm_andnot_si128(transparent, pixels));
+		}
+		_mm_storeu_si128((__m128i*)(dst + i), pixels);
+	}
+	for (; i < width; i++){
+		if (src[i])
+			dst[i] = src[i];
+	}
+}
+
+#endif // __SSE2__
+
 /**
  * Copies a sprite onto the buffer. There is no compression used on the sprite
  * image.
@@ -110,6 +627,47 @@ void gfx_bmp_sprite_to_buffer(uint8* palette_pointer, uint8* unknown_pointer, ui
 		}
 
 		//image colour adjusted?
+
+		//Unzoomed remaps translate four pixels per source word; a single
+		//compare skips fully transparent spans without touching the palette.
+		//Only valid while palette entry 0 keeps 0 transparent, which every
+		//remap table does, but check rather than assume.
+		if (zoom_level == 0 && palette_pointer[0] == 0){
+			for (; height > 0; height--){
+				uint8* next_source_pointer = source_pointer + (uint32)source_image->width;
+				uint8* next_dest_pointer = dest_pointer + dest_dpi->width + dest_dpi->pitch;
+				int no_pixels = width;
+
+				for (; no_pixels >= 4; no_pixels -= 4, source_pointer += 4, dest_pointer += 4){
+					uint32 quad = *((uint32*)source_pointer);
+					uint8 pixel;
+					if (quad == 0)
+						continue;
+					pixel = palette_pointer[quad & 0xFF];
+					if (pixel)
+						dest_pointer[0] = pixel;
+					pixel = palette_pointer[(quad >> 8) & 0xFF];
+					if (pixel)
+						dest_pointer[1] = pixel;
+					pixel = palette_pointer[(quad >> 16) & 0xFF];
+					if (pixel)
+						dest_pointer[2] = pixel;
+					pixel = palette_pointer[quad >> 24];
+					if (pixel)
+						dest_pointer[3] = pixel;
+				}
+				for (; no_pixels > 0; no_pixels--, source_pointer++, dest_pointer++){
+					uint8 pixel = palette_pointer[*source_pointer];
+					if (pixel){
+						*dest_pointer = pixel;
+					}
+				}
+				source_pointer = next_source_pointer;
+				dest_pointer = next_dest_pointer;
+			}
+			return;
+		}
+
 		for (; height > 0; height -= zoom_amount){
 			uint8* next_source_pointer = source_pointer + (uint32)(source_image->width * zoom_amount);
 			uint8* next_dest_pointer = dest_pointer + (dest_dpi->width / zoom_amount) + dest_dpi->pitch;
@@ -130,6 +688,50 @@ void gfx_bmp_sprite_to_buffer(uint8* palette_pointer, uint8* unknown_pointer, ui
 	//Mix with background. It only uses source pointer for
 	//telling if it needs to be drawn not for colour.
 	if (image_type & IMAGE_TYPE_MIX_BACKGROUND){//Not tested
+		//A fully opaque source shades every destination pixel, so the source
+		//does not need to be read at all
+		if (zoom_level == 0 && (source_image->flags & G1_FLAG_FULLY_OPAQUE)){
+			for (; height > 0; height--){
+				for (int i = 0; i < width; i++)
+					dest_pointer[i] = palette_pointer[dest_pointer[i]];
+				dest_pointer += dest_dpi->width + dest_dpi->pitch;
+			}
+			return;
+		}
+
+		//Unzoomed blends test four source bytes per word; the source only
+		//masks which destination pixels get shaded, so transparent spans
+		//skip with a single compare
+		if (zoom_level == 0){
+			for (; height > 0; height--){
+				uint8* next_source_pointer = source_pointer + (uint32)source_image->width;
+				uint8* next_dest_pointer = dest_pointer + dest_dpi->width + dest_dpi->pitch;
+				int no_pixels = width;
+
+				for (; no_pixels >= 4; no_pixels -= 4, source_pointer += 4, dest_pointer += 4){
+					uint32 quad = *((uint32*)source_pointer);
+					if (quad == 0)
+						continue;
+					if (quad & 0xFF)
+						dest_pointer[0] = palette_pointer[dest_pointer[0]];
+					if (quad & 0xFF00)
+						dest_pointer[1] = palette_pointer[dest_pointer[1]];
+					if (quad & 0xFF0000)
+						dest_pointer[2] = palette_pointer[dest_pointer[2]];
+					if (quad & 0xFF000000)
+						dest_pointer[3] = palette_pointer[dest_pointer[3]];
+				}
+				for (; no_pixels > 0; no_pixels--, source_pointer++, dest_pointer++){
+					if (*source_pointer){
+						*dest_pointer = palette_pointer[*dest_pointer];
+					}
+				}
+				source_pointer = next_source_pointer;
+				dest_pointer = next_dest_pointer;
+			}
+			return;
+		}
+
 		for (; height > 0; height -= zoom_amount){
 			uint8* next_source_pointer = source_pointer + (uint32)(source_image->width * zoom_amount);
 			uint8* next_dest_pointer = dest_pointer + (dest_dpi->width / zoom_amount) + dest_dpi->pitch;
@@ -187,6 +789,31 @@ void gfx_bmp_sprite_to_buffer(uint8* palette_pointer, uint8* unknown_pointer, ui
 	}
 
 	//Basic bitmap with no draw pixels
+	//The caller has already resolved the clip rectangle into row geometry, so
+	//at zoom 0 each row is a pure span copy: fully opaque images (flagged by
+	//gfx_bmp_scan_opacity on first draw) need no transparency tests at all
+	//and the rest go through the SSE2 masked copy when available
+	if (zoom_level == 0){
+		if (source_image->flags & G1_FLAG_FULLY_OPAQUE){
+			for (; height > 0; height--){
+				memcpy(dest_pointer, source_pointer, width);
+				source_pointer += source_image->width;
+				dest_pointer += dest_dpi->width + dest_dpi->pitch;
+			}
+			return;
+		}
+#ifdef __SSE2__
+		if (gfx_sse2_available()){
+			for (; height > 0; height--){
+				gfx_bmp_copy_row_sse2(dest_pointer, source_pointer, width);
+				source_pointer += source_image->width;
+				dest_pointer += dest_dpi->width + dest_dpi->pitch;
+			}
+			return;
+		}
+#endif
+	}
+
 	for (; height > 0; height -= zoom_amount){
 		uint8* next_source_pointer = source_pointer + (uint32)(source_image->width * zoom_amount);
 		uint8* next_dest_pointer = dest_pointer + (dest_dpi->width / zoom_amount) + dest_dpi->pitch;
@@ -286,24 +913,70 @@ void gfx_rle_sprite_to_buffer(uint8* source_bits_pointer, uint8* dest_bits_point
 			//Finally after all those checks, copy the image onto the drawing surface
 			//If the image type is not a basic one we require to mix the pixels
 			if (image_type & IMAGE_TYPE_USE_PALETTE){//In the .exe these are all unraveled loops
-				for (; no_pixels > 0; no_pixels -= zoom_amount, source_pointer += zoom_amount, dest_pointer++){
-					uint8 al = *source_pointer;
-					uint8 ah = *dest_pointer;
-					if (image_type & IMAGE_TYPE_MIX_BACKGROUND)
-						al = palette_pointer[(((uint16)al << 8) | ah) - 0x100];
-					else
-						al = palette_pointer[al];
-					*dest_pointer = al;
+				if (image_type & IMAGE_TYPE_MIX_BACKGROUND){
+					if (zoom_amount == 1){
+						//The blend table is indexed by source and destination
+						//together; runs are opaque so it applies four pixels
+						//at a time with no per pixel test
+						for (; no_pixels >= 4; no_pixels -= 4, source_pointer += 4, dest_pointer += 4){
+							dest_pointer[0] = palette_pointer[(((uint16)source_pointer[0] << 8) | dest_pointer[0]) - 0x100];
+							dest_pointer[1] = palette_pointer[(((uint16)source_pointer[1] << 8) | dest_pointer[1]) - 0x100];
+							dest_pointer[2] = palette_pointer[(((uint16)source_pointer[2] << 8) | dest_pointer[2]) - 0x100];
+							dest_pointer[3] = palette_pointer[(((uint16)source_pointer[3] << 8) | dest_pointer[3]) - 0x100];
+						}
+						for (; no_pixels > 0; no_pixels--, source_pointer++, dest_pointer++){
+							*dest_pointer = palette_pointer[(((uint16)*source_pointer << 8) | *dest_pointer) - 0x100];
+						}
+					}
+					else{
+						for (; no_pixels > 0; no_pixels -= zoom_amount, source_pointer += zoom_amount, dest_pointer++){
+							uint8 al = *source_pointer;
+							uint8 ah = *dest_pointer;
+							al = palette_pointer[(((uint16)al << 8) | ah) - 0x100];
+							*dest_pointer = al;
+						}
+					}
+				}
+				else if (zoom_amount == 1){
+					//Pixels inside a data section are all opaque, so the
+					//remap needs no per pixel test and can be unravelled
+					//four at a time like the .exe loops
+					for (; no_pixels >= 4; no_pixels -= 4, source_pointer += 4, dest_pointer += 4){
+						dest_pointer[0] = palette_pointer[source_pointer[0]];
+						dest_pointer[1] = palette_pointer[source_pointer[1]];
+						dest_pointer[2] = palette_pointer[source_pointer[2]];
+						dest_pointer[3] = palette_pointer[source_pointer[3]];
+					}
+					for (; no_pixels > 0; no_pixels--, source_pointer++, dest_pointer++){
+						*dest_pointer = palette_pointer[*source_pointer];
+					}
+				}
+				else{
+					for (; no_pixels > 0; no_pixels -= zoom_amount, source_pointer += zoom_amount, dest_pointer++){
+						*dest_pointer = palette_pointer[*source_pointer];
+					}
 				}
 			}
 			else if (image_type & IMAGE_TYPE_MIX_BACKGROUND){//In the .exe these are all unraveled loops
 				//Doesnt use source pointer ??? mix with background only?
 				//Not Tested
-				
-				for (; no_pixels > 0; no_pixels -= zoom_amount, dest_pointer++){
-					uint8 pixel = *dest_pointer;
-					pixel = palette_pointer[pixel];
-					*dest_pointer = pixel;
+				if (zoom_amount == 1){
+					for (; no_pixels >= 4; no_pixels -= 4, dest_pointer += 4){
+						dest_pointer[0] = palette_pointer[dest_pointer[0]];
+						dest_pointer[1] = palette_pointer[dest_pointer[1]];
+						dest_pointer[2] = palette_pointer[dest_pointer[2]];
+						dest_pointer[3] = palette_pointer[dest_pointer[3]];
+					}
+					for (; no_pixels > 0; no_pixels--, dest_pointer++){
+						*dest_pointer = palette_pointer[*dest_pointer];
+					}
+				}
+				else{
+					for (; no_pixels > 0; no_pixels -= zoom_amount, dest_pointer++){
+						uint8 pixel = *dest_pointer;
+						pixel = palette_pointer[pixel];
+						*dest_pointer = pixel;
+					}
 				}
 			}
 			else
@@ -319,6 +992,36 @@ void gfx_rle_sprite_to_buffer(uint8* source_bits_pointer, uint8* dest_bits_point
 	}
 }
 
+//Remapped draws assemble their palette by copying colour ranges out of the
+//g1 palette elements into a scratch table on every call. The source palettes
+//never change after gfx_load_g1, so the fused table only depends on the
+//colour combination; a small direct mapped cache keyed on it skips the
+//assembly for the combinations that repeat all frame (peeps and vehicles).
+#define REMAP_PALETTE_CACHE_SIZE 128
+
+typedef struct {
+	uint32 key;
+	uint8 palette[256];
+} remap_palette_cache_entry;
+
+static remap_palette_cache_entry _remapPaletteCache[REMAP_PALETTE_CACHE_SIZE];
+
+static uint8* remap_palette_cache_get(uint32 key)
+{
+	remap_palette_cache_entry *entry = &_remapPaletteCache[key & (REMAP_PALETTE_CACHE_SIZE - 1)];
+	if (entry->key == key)
+		return entry->palette;
+	return NULL;
+}
+
+static uint8* remap_palette_cache_add(uint32 key, uint8 *palette)
+{
+	remap_palette_cache_entry *entry = &_remapPaletteCache[key & (REMAP_PALETTE_CACHE_SIZE - 1)];
+	entry->key = key;
+	memcpy(entry->palette, palette, 256);
+	return entry->palette;
+}
+
 /**
  *
  *  rct2: 0x0067A28E
@@ -366,19 +1069,27 @@ void gfx_draw_sprite(rct_drawpixelinfo *dpi, int image_id, int x, int y, uint32
 	else if (image_type && !(image_type & IMAGE_TYPE_USE_PALETTE)){
 		RCT2_GLOBAL(0x9E3CDC, uint32) = 0;
 		unknown_pointer = NULL;
-		palette_pointer = RCT2_ADDRESS(0x9ABF0C, uint8);
 
-		uint32 primary_offset = palette_to_g1_offset[(image_id >> 19) & 0x1F];
-		uint32 secondary_offset = palette_to_g1_offset[(image_id >> 24) & 0x1F];
-		uint32 tertiary_offset = palette_to_g1_offset[tertiary_colour];
+		//Colour bits 19-28 cover primary and secondary below
+		uint32 remap_key = 0x80000000 | ((uint32)tertiary_colour << 10) | ((image_id >> 19) & 0x3FF);
+		palette_pointer = remap_palette_cache_get(remap_key);
+		if (palette_pointer == NULL){
+			palette_pointer = RCT2_ADDRESS(0x9ABF0C, uint8);
 
-		rct_g1_element* primary_colour = &RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[primary_offset];
-		rct_g1_element* secondary_colour = &RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[secondary_offset];
-		rct_g1_element* tertiary_colour = &RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[tertiary_offset];
+			uint32 primary_offset = palette_to_g1_offset[(image_id >> 19) & 0x1F];
+			uint32 secondary_offset = palette_to_g1_offset[(image_id >> 24) & 0x1F];
+			uint32 tertiary_offset = palette_to_g1_offset[tertiary_colour];
 
-		memcpy(palette_pointer + 0xF3, &primary_colour->offset[0xF3], 12);
-		memcpy(palette_pointer + 0xCA, &secondary_colour->offset[0xF3], 12);
-		memcpy(palette_pointer + 0x2E, &tertiary_colour->offset[0xF3], 12);
+			rct_g1_element* primary_colour = &RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[primary_offset];
+			rct_g1_element* secondary_colour = &RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[secondary_offset];
+			rct_g1_element* tertiary_colour = &RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[tertiary_offset];
+
+			memcpy(palette_pointer + 0xF3, &primary_colour->offset[0xF3], 12);
+			memcpy(palette_pointer + 0xCA, &secondary_colour->offset[0xF3], 12);
+			memcpy(palette_pointer + 0x2E, &tertiary_colour->offset[0xF3], 12);
+
+			palette_pointer = remap_palette_cache_add(remap_key, palette_pointer);
+		}
 
 		//image_id
 		RCT2_GLOBAL(0xEDF81C, uint32) |= 0x20000000;
@@ -388,19 +1099,25 @@ void gfx_draw_sprite(rct_drawpixelinfo *dpi, int image_id, int x, int y, uint32
 		RCT2_GLOBAL(0x9E3CDC, uint32) = 0;
 		unknown_pointer = NULL;
 
-		palette_pointer = RCT2_ADDRESS(0x9ABE0C, uint8);
+		uint32 remap_key = 0x40000000 | ((image_id >> 19) & 0x3FF);
+		palette_pointer = remap_palette_cache_get(remap_key);
+		if (palette_pointer == NULL){
+			palette_pointer = RCT2_ADDRESS(0x9ABE0C, uint8);
+
+			//Top
+			int top_type = (image_id >> 19) & 0x1f;
+			uint32 top_offset = palette_to_g1_offset[top_type]; //RCT2_ADDRESS(0x97FCBC, uint32)[top_type];
+			rct_g1_element top_palette = RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[top_offset];
+			memcpy(palette_pointer + 0xF3, top_palette.offset + 0xF3, 12);
+
+			//Trousers
+			int trouser_type = (image_id >> 24) & 0x1f;
+			uint32 trouser_offset = palette_to_g1_offset[trouser_type]; //RCT2_ADDRESS(0x97FCBC, uint32)[trouser_type];
+			rct_g1_element trouser_palette = RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[trouser_offset];
+			memcpy(palette_pointer + 0xCA, trouser_palette.offset + 0xF3, 12);
 
-		//Top
-		int top_type = (image_id >> 19) & 0x1f;
-		uint32 top_offset = palette_to_g1_offset[top_type]; //RCT2_ADDRESS(0x97FCBC, uint32)[top_type];
-		rct_g1_element top_palette = RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[top_offset];
-		memcpy(palette_pointer + 0xF3, top_palette.offset + 0xF3, 12);
-		
-		//Trousers
-		int trouser_type = (image_id >> 24) & 0x1f;
-		uint32 trouser_offset = palette_to_g1_offset[trouser_type]; //RCT2_ADDRESS(0x97FCBC, uint32)[trouser_type];
-		rct_g1_element trouser_palette = RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element)[trouser_offset];
-		memcpy(palette_pointer + 0xCA, trouser_palette.offset + 0xF3, 12);
+			palette_pointer = remap_palette_cache_add(remap_key, palette_pointer);
+		}
 	}
 
 	//For backwards compatibility
@@ -409,6 +1126,8 @@ void gfx_draw_sprite(rct_drawpixelinfo *dpi, int image_id, int x, int y, uint32
 	gfx_draw_sprite_palette_set(dpi, image_id, x, y, palette_pointer, unknown_pointer);
 }
 
+static void gfx_draw_sprite_element(rct_drawpixelinfo *dpi, rct_g1_element *g1_source, int image_element, int x, int y, uint8* palette_pointer, uint8* unknown_pointer, int image_type);
+
 /*
 * rct: 0x0067A46E
 * image_id (ebx) and also (0x00EDF81C)
@@ -456,6 +1175,37 @@ void gfx_draw_sprite_palette_set(rct_drawpixelinfo *dpi, int image_id, int x, in
 		return;
 	}
 
+	if (dpi->zoom_level){
+		//Images without an authored zoomed variant use a generated mip; the
+		//deepest available level is drawn with a proportionally scaled dpi,
+		//the same way the authored variants recurse above
+		int mip_level = min(dpi->zoom_level, SPRITE_MIP_LEVELS);
+		rct_g1_element* mip = gfx_get_sprite_mip(image_element, mip_level);
+		if (mip != NULL){
+			rct_drawpixelinfo zoomed_dpi = {
+				.bits = dpi->bits,
+				.x = dpi->x >> mip_level,
+				.y = dpi->y >> mip_level,
+				.height = dpi->height >> mip_level,
+				.width = dpi->width >> mip_level,
+				.pitch = dpi->pitch,
+				.zoom_level = dpi->zoom_level - mip_level
+			};
+			gfx_draw_sprite_element(&zoomed_dpi, mip, -1, x >> mip_level, y >> mip_level, palette_pointer, unknown_pointer, image_type);
+			return;
+		}
+	}
+
+	gfx_draw_sprite_element(dpi, g1_source, image_element, x, y, palette_pointer, unknown_pointer, image_type);
+}
+
+/**
+ * Draws a g1 element that has already been looked up (or, for generated mips,
+ * one that has no slot in the g1 table at all, in which case image_element is
+ * negative). This is the tail of gfx_draw_sprite_palette_set.
+ */
+static void gfx_draw_sprite_element(rct_drawpixelinfo *dpi, rct_g1_element *g1_source, int image_element, int x, int y, uint8* palette_pointer, uint8* unknown_pointer, int image_type)
+{
 	//Its used super often so we will define it to a seperate variable.
 	int zoom_level = dpi->zoom_level;
 	int zoom_amount = 1 << zoom_level;
@@ -559,6 +1309,21 @@ void gfx_draw_sprite_palette_set(rct_drawpixelinfo *dpi, int image_id, int x, in
 	dest_pointer += ((dpi->width / zoom_amount) + dpi->pitch)*dest_start_y + dest_start_x;
 	
 	if (g1_source->flags & G1_FLAG_RLE_COMPRESSION){
+		if (zoom_level == 0){
+			//At zoom 0 the RLE and uncompressed clipping maths agree, so hot
+			//sprites can be blitted from the decoded sprite cache instead of
+			//re-walking the run length stream.
+			uint8* decoded_bits = gfx_get_decoded_rle_sprite(image_element, g1_source);
+			if (decoded_bits != NULL){
+				rct_g1_element decoded_element = *g1_source;
+				decoded_element.offset = decoded_bits;
+				//Transparent pixels are zero, which the bmp loops skip
+				decoded_element.flags |= G1_FLAG_BMP;
+				uint8* decoded_source_pointer = decoded_bits + g1_source->width*source_start_y + source_start_x;
+				gfx_bmp_sprite_to_buffer(palette_pointer, unknown_pointer, decoded_source_pointer, dest_pointer, &decoded_element, dpi, height, width, image_type);
+				return;
+			}
+		}
 		//We have to use a different method to move the source pointer for
 		//rle encoded sprites so that will be handled within this function
 		gfx_rle_sprite_to_buffer(g1_source->offset, dest_pointer, palette_pointer, dpi, image_type, source_start_y, height, source_start_x, width);
@@ -569,6 +1334,7 @@ void gfx_draw_sprite_palette_set(rct_drawpixelinfo *dpi, int image_id, int x, in
 	source_pointer += g1_source->width*source_start_y + source_start_x;
 
 	if (!(g1_source->flags & 0x02)){
+		gfx_bmp_scan_opacity(g1_source);
 		gfx_bmp_sprite_to_buffer(palette_pointer, unknown_pointer, source_pointer, dest_pointer, g1_source, dpi, height, width, image_type);
 		return;
 	}
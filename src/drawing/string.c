@@ -19,16 +19,95 @@
  *****************************************************************************/
 
 #include "../addresses.h"
+#include "../common.h"
 #include "../localisation/localisation.h"
 #include "../sprites.h"
 #include "drawing.h"
 
+// Cache of shaped glyph runs for plain strings (no format or colour codes),
+// so static UI labels stop paying the per character switch and width lookup
+// every repaint. Runs are positioned relative to the string origin and keyed
+// on (text, font sprite base); the palette is applied at draw time so one run
+// serves every colour. Direct mapped, stale entries are simply overwritten.
+#define GLYPH_RUN_CACHE_SIZE 512
+#define GLYPH_RUN_MAX_LENGTH 64
+
+typedef struct {
+	uint32 hash;
+	sint16 fontSpriteBase;
+	uint16 numGlyphs;
+	uint16 advance;
+	char text[GLYPH_RUN_MAX_LENGTH + 1];
+	uint16 charOffsets[GLYPH_RUN_MAX_LENGTH];
+	uint16 xOffsets[GLYPH_RUN_MAX_LENGTH];
+} glyph_run;
+
+static glyph_run *_glyphRunCache[GLYPH_RUN_CACHE_SIZE];
+
+static uint32 glyph_run_hash(const char *text, sint16 fontSpriteBase)
+{
+	uint32 hash = 2166136261u ^ (uint32)fontSpriteBase;
+	while (*text != 0) {
+		hash ^= (uint8)*text++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**
+ * Returns the cached glyph run for a string, building it if necessary, or
+ * NULL if the string is not cacheable (contains format codes or is too long).
+ */
+static glyph_run *glyph_run_get(const char *text, sint16 fontSpriteBase)
+{
+	int i, length;
+	uint32 hash;
+	uint16 advance;
+	glyph_run *run;
+
+	for (length = 0; text[length] != 0; length++) {
+		uint8 c = (uint8)text[length];
+		if (c < 0x20 || (c >= FORMAT_COLOUR_CODE_START && c <= FORMAT_COLOUR_CODE_END))
+			return NULL;
+		if (length >= GLYPH_RUN_MAX_LENGTH)
+			return NULL;
+	}
+
+	hash = glyph_run_hash(text, fontSpriteBase);
+	run = _glyphRunCache[hash & (GLYPH_RUN_CACHE_SIZE - 1)];
+	if (run != NULL && run->hash == hash && run->fontSpriteBase == fontSpriteBase && strcmp(run->text, text) == 0)
+		return run;
+
+	if (run == NULL) {
+		run = malloc(sizeof(glyph_run));
+		_glyphRunCache[hash & (GLYPH_RUN_CACHE_SIZE - 1)] = run;
+	}
+	run->hash = hash;
+	run->fontSpriteBase = fontSpriteBase;
+	run->numGlyphs = length;
+	strcpy(run->text, text);
+
+	advance = 0;
+	for (i = 0; i < length; i++) {
+		uint16 charOffset = (uint8)text[i] - 0x20 + fontSpriteBase;
+		run->charOffsets[i] = charOffset;
+		run->xOffsets[i] = advance;
+		advance += RCT2_ADDRESS(RCT2_ADDRESS_FONT_CHAR_WIDTH, uint8)[charOffset] & 0xFF;
+	}
+	run->advance = advance;
+	return run;
+}
+
 /**
  *
  *  rct2: 0x006C19AC
  */
 void gfx_load_character_widths(){
 
+	// Character widths are about to change, drop any shaped runs
+	for (int i = 0; i < GLYPH_RUN_CACHE_SIZE; i++)
+		SafeFree(_glyphRunCache[i]);
+
 	uint8* char_width_pointer = RCT2_ADDRESS(RCT2_ADDRESS_FONT_CHAR_WIDTH, uint8);
 	for (int char_set_offset = 0; char_set_offset < 4*0xE0; char_set_offset+=0xE0){
 		for (uint8 c = 0; c < 0xE0; c++, char_width_pointer++){
@@ -171,8 +250,17 @@ int gfx_get_string_width(char* buffer)
 	// Width of string
 	int width;
 	rct_g1_element g1_element;
-	
+	glyph_run *run;
+
 	current_font_sprite_base = RCT2_ADDRESS(RCT2_ADDRESS_CURRENT_FONT_SPRITE_BASE, uint16);
+
+	// Plain strings are answered from the shaped run cache. Cached runs
+	// contain no font change codes, so the current font base is untouched
+	// and the memoised advance is the exact width.
+	run = glyph_run_get(buffer, *current_font_sprite_base);
+	if (run != NULL)
+		return run->advance;
+
 	width = 0;
 
 	for (uint8* curr_char = (uint8*)buffer; *curr_char != (uint8)0; curr_char++) {
@@ -711,6 +799,20 @@ void gfx_draw_string_left(rct_drawpixelinfo *dpi, int format, void *args, int co
 	gfx_draw_string(dpi, buffer, colour, x, y);
 }
 
+/**
+ * As gfx_draw_string_left, but formatting from typed argument spans so the
+ * caller does not stage values through the common format args block.
+ */
+void gfx_draw_string_left_args(rct_drawpixelinfo *dpi, int format, const format_arg *args, int count, int colour, int x, int y)
+{
+	char* buffer;
+
+	buffer = RCT2_ADDRESS(RCT2_ADDRESS_COMMON_STRING_FORMAT_BUFFER, char);
+	format_string_args(buffer, format, args, count);
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_FONT_SPRITE_BASE, uint16) = 0xE0;
+	gfx_draw_string(dpi, buffer, colour, x, y);
+}
+
 /**
  * Changes the palette so that the next character changes colour
  */
@@ -857,6 +959,24 @@ void gfx_draw_string(rct_drawpixelinfo *dpi, char *buffer, int colour, int x, in
 		skip_char = 1;
 	}
 
+	// Fast path: plain strings replay a cached glyph run with the palette
+	// that has just been set up, skipping the per character processing.
+	glyph_run *run = glyph_run_get(buffer, *current_font_sprite_base);
+	if (run != NULL) {
+		RCT2_GLOBAL(0x00EDF81C, uint32) = (IMAGE_TYPE_USE_PALETTE << 28);
+		for (int i = 0; i < run->numGlyphs; i++) {
+			int glyph_x = x + run->xOffsets[i];
+			if (glyph_x >= dpi->x + dpi->width)
+				break;
+			if (glyph_x + 0x1A < dpi->x)
+				continue;
+			gfx_draw_sprite_palette_set(dpi, ((IMAGE_TYPE_USE_PALETTE << 28) | run->charOffsets[i]) + SPR_CHAR_START, glyph_x, y, palette_pointer, NULL);
+		}
+		gLastDrawStringX = x + run->advance;
+		gLastDrawStringY = y;
+		return;
+	}
+
 	for (uint8 al = *buffer; al > 0; ++buffer, al = *buffer) {
 
 		// Skip to the next printing character
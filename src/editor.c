@@ -23,6 +23,7 @@
 #include "drawing/drawing.h"
 #include "editor.h"
 #include "game.h"
+#include "game_state.h"
 #include "interface/window.h"
 #include "interface/viewport.h"
 #include "localisation/date.h"
@@ -34,7 +35,10 @@
 #include "platform/platform.h"
 #include "rct1.h"
 #include "ride/ride.h"
+#include "ride/ride_stats.h"
+#include "ride/station.h"
 #include "scenario.h"
+#include "statehash.h"
 #include "util/sawyercoding.h"
 #include "util/util.h"
 #include "world/banner.h"
@@ -338,7 +342,8 @@ static int editor_load_landscape_from_sc4(const char *path)
 static int editor_read_s6(const char *path)
 {
 	int i, j;
-	FILE *file;
+	file_mapping fm;
+	sawyercoding_reader reader;
 	rct_s6_header *s6Header = (rct_s6_header*)0x009E34E4;
 	rct_s6_info *s6Info = (rct_s6_info*)0x0141F570;
 
@@ -347,10 +352,9 @@ static int editor_read_s6(const char *path)
 
 	log_verbose("loading landscape, %s", path);
 
-	file = fopen(path, "rb");
-	if (file != NULL) {
-		if (!sawyercoding_validate_checksum(file)) {
-			fclose(file);
+	if (platform_file_map(path, &fm)) {
+		if (!sawyercoding_validate_checksum_buffer(fm.data, fm.size)) {
+			platform_file_unmap(&fm);
 			RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) = 255;
 			RCT2_GLOBAL(RCT2_ADDRESS_ERROR_STRING_ID, uint16) = STR_FILE_CONTAINS_INVALID_DATA;
 
@@ -358,11 +362,13 @@ static int editor_read_s6(const char *path)
 			return 0;
 		}
 
+		sawyercoding_reader_init(&reader, fm.data, fm.size);
+
 		// Read first chunk
-		sawyercoding_read_chunk(file, (uint8*)s6Header);
+		sawyercoding_reader_read_chunk(&reader, (uint8*)s6Header);
 		if (s6Header->type == S6_TYPE_SCENARIO) {
 			// Read second chunk
-			sawyercoding_read_chunk(file, (uint8*)s6Info);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)s6Info);
 
 			if (s6Info->var_000 == 255)
 				s6Info->var_000 = 1;
@@ -376,50 +382,50 @@ static int editor_read_s6(const char *path)
 		if (s6Header->num_packed_objects > 0) {
 			j = 0;
 			for (i = 0; i < s6Header->num_packed_objects; i++)
-				j += object_load_packed(file);
+				j += object_load_packed(&reader);
 			if (j > 0)
 				object_list_load();
 		}
 
-		uint8 load_success = object_read_and_load_entries(file);
+		uint8 load_success = object_read_and_load_entries(&reader);
 
 		// Read flags (16 bytes). Loads:
 		//	RCT2_ADDRESS_CURRENT_MONTH_YEAR
 		//	RCT2_ADDRESS_CURRENT_MONTH_TICKS
 		//	RCT2_ADDRESS_SCENARIO_TICKS
-		sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR);
+		sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR);
 
 		// Read map elements
 		memset((void*)RCT2_ADDRESS_MAP_ELEMENTS, 0, MAX_MAP_ELEMENTS * sizeof(rct_map_element));
-		sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_MAP_ELEMENTS);
+		sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_MAP_ELEMENTS);
 
 		// Read game data, including sprites
-		sawyercoding_read_chunk(file, (uint8*)0x010E63B8);
+		sawyercoding_reader_read_chunk(&reader, (uint8*)0x010E63B8);
 
 		if (s6Header->type == S6_TYPE_SCENARIO) {
 			// Read number of guests in park and something else
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_GUESTS_IN_PARK);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_GUESTS_IN_PARK);
 
 			// Read ?
-			sawyercoding_read_chunk(file, (uint8*)0x01357BC8);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)0x01357BC8);
 
 			// Read park rating
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_CURRENT_PARK_RATING);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_CURRENT_PARK_RATING);
 
 			// Read ?
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_ACTIVE_RESEARCH_TYPES);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_ACTIVE_RESEARCH_TYPES);
 
 			// Read ?
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_CURRENT_EXPENDITURE);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_CURRENT_EXPENDITURE);
 
 			// Read ?
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_CURRENT_PARK_VALUE);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_CURRENT_PARK_VALUE);
 
 			// Read more game data, including research items and rides
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_COMPLETED_COMPANY_VALUE);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_COMPLETED_COMPANY_VALUE);
 		}
 
-		fclose(file);
+		platform_file_unmap(&fm);
 		if (!load_success){
 			log_error("failed to load all entries.");
 			set_load_objects_fail_reason();
@@ -430,6 +436,18 @@ static int editor_read_s6(const char *path)
 
 		reset_loaded_objects();
 		map_update_tile_pointers();
+		game_state_sync_from_legacy();
+		peep_thought_counters_invalidate();
+		staff_patrol_index_invalidate();
+		user_string_table_invalidate();
+		finance_history_invalidate();
+		editor_object_flags_invalidate();
+		ride_stats_invalidate();
+		ride_station_element_hints_invalidate();
+		ride_index_cache_invalidate();
+		park_size_invalidate();
+		park_appeal_invalidate();
+		statehash_invalidate();
 		map_remove_all_rides();
 
 		// 
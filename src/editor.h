@@ -47,4 +47,6 @@ void sub_6BD3A4();
 
 void editor_open_windows_for_current_step();
 
+void editor_object_flags_invalidate();
+
 #endif
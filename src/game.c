@@ -20,10 +20,13 @@
  
 #include "addresses.h"
 #include "audio/audio.h"
+#include "checkpoint.h"
 #include "config.h"
 #include "game.h"
+#include "game_state.h"
 #include "editor.h"
 #include "world/footpath.h"
+#include "world/path_heat.h"
 #include "input.h"
 #include "localisation/localisation.h"
 #include "interface/screenshot.h"
@@ -35,20 +38,29 @@
 #include "management/news_item.h"
 #include "management/research.h"
 #include "object.h"
+#include "openrct2.h"
+#include "park_instance.h"
 #include "peep/peep.h"
 #include "peep/staff.h"
 #include "platform/platform.h"
 #include "ride/ride.h"
 #include "ride/ride_ratings.h"
+#include "ride/ride_stats.h"
+#include "ride/station.h"
 #include "ride/vehicle.h"
 #include "scenario.h"
+#include "statehash.h"
 #include "title.h"
 #include "tutorial.h"
+#include "util/rng.h"
+#include "util/savecontainer.h"
 #include "util/sawyercoding.h"
 #include "util/util.h"
+#include "util/workerpool.h"
 #include "windows/error.h"
 #include "windows/tooltip.h"
 #include "world/climate.h"
+#include "world/map.h"
 #include "world/map_animation.h"
 #include "world/park.h"
 #include "world/scenery.h"
@@ -56,15 +68,51 @@
 #include "world/water.h"
 
 int gGameSpeed = 1;
+int gGameTurboActive = 0;
+
+// Target wall time of one turbo tick batch; long enough to saturate the core
+// with simulation, short enough that input and OS events stay responsive
+#define TURBO_BATCH_MS 250
+
+// Interval between the preview frames turbo refreshes the screen with
+#define TURBO_PREVIEW_MS 1000
+
+static uint64 _turboLastPreview = 0;
+
+uint64 gGameLogicPhaseTime[GAME_LOGIC_PHASE_COUNT];
+uint32 gGameLogicPhaseTicks = 0;
+
+const char *gGameLogicPhaseNames[GAME_LOGIC_PHASE_COUNT] = {
+	"map",
+	"peep",
+	"vehicle",
+	"ride",
+	"ratings",
+	"other"
+};
+
+/**
+ * Accumulates the time since phaseStart against the given phase and returns
+ * the start time for the next phase.
+ */
+static uint64 game_logic_phase_end(int phase, uint64 phaseStart)
+{
+	uint64 now = SDL_GetPerformanceCounter();
+	gGameLogicPhaseTime[phase] += now - phaseStart;
+	return now;
+}
 
 void game_increase_game_speed()
 {
-	gGameSpeed = min(8, gGameSpeed + 1);
+	gGameSpeed = min(GAME_SPEED_TURBO, gGameSpeed + 1);
 }
 
 void game_reduce_game_speed()
 {
 	gGameSpeed = max(1, gGameSpeed - 1);
+	// Leaving turbo: bring the suppressed screen content back up to date
+	if (gGameSpeed == GAME_SPEED_TURBO - 1)
+		gfx_invalidate_screen();
 }
 
 /**
@@ -207,6 +255,32 @@ void update_palette_effects()
 	}
 }
 
+/**
+ * Runs one turbo tick batch: as many ticks as fit in the batch budget, with
+ * the per tick window events, invalidations and tick driven audio suppressed
+ * so the core is saturated with simulation alone. The multi rate update
+ * schedules inside game_logic_update apply as normal. The screen is
+ * refreshed from a full invalidation once a second as a progress preview;
+ * everything else redraws when turbo is left.
+ */
+static void game_update_turbo()
+{
+	uint64 frequency = SDL_GetPerformanceFrequency();
+	uint64 start = SDL_GetPerformanceCounter();
+	uint64 budget = (frequency * TURBO_BATCH_MS) / 1000;
+
+	gGameTurboActive = 1;
+	do {
+		game_logic_update();
+	} while (SDL_GetPerformanceCounter() - start < budget);
+	gGameTurboActive = 0;
+
+	if (SDL_GetPerformanceCounter() - _turboLastPreview >= (frequency * TURBO_PREVIEW_MS) / 1000) {
+		_turboLastPreview = SDL_GetPerformanceCounter();
+		gfx_invalidate_screen();
+	}
+}
+
 void game_update()
 {
 	int i, numUpdates;
@@ -229,7 +303,9 @@ void game_update()
 
 	// Update the game one or more times
 	if (RCT2_GLOBAL(RCT2_ADDRESS_GAME_PAUSED, uint8) == 0) {
-		for (i = 0; i < numUpdates; i++) {
+		if (gGameSpeed == GAME_SPEED_TURBO) {
+			game_update_turbo();
+		} else for (i = 0; i < numUpdates; i++) {
 			game_logic_update();
 			start_title_music();
 
@@ -255,6 +331,10 @@ void game_update()
 		}
 	}
 
+	// Give background park instances their tick budget for this frame
+	if (RCT2_GLOBAL(RCT2_ADDRESS_GAME_PAUSED, uint8) == 0)
+		park_instance_update();
+
 	RCT2_GLOBAL(0x009A8C28, uint8) = 0;
 
 	RCT2_GLOBAL(RCT2_ADDRESS_INPUT_FLAGS, uint32) &= ~INPUT_FLAG_VIEWPORT_SCROLLING;
@@ -286,7 +366,10 @@ void game_update()
 	RCT2_GLOBAL(0x0141F568, uint8) = RCT2_GLOBAL(0x0013CA740, uint8);
 	game_handle_input();
 
-	update_palette_effects();
+	// Frozen while render idle so an unchanged screen stops being presented;
+	// the water animation picks up again on the first input
+	if (!gRenderIdle)
+		update_palette_effects();
 	update_rain_animation();
 
 	stop_completed_sounds(); // removes other sounds that are no longer playing, this is normally called somewhere in rct2_init
@@ -298,38 +381,79 @@ void game_update()
 	}
 }
 
+static void game_command_replay_update();
+
 void game_logic_update()
 {
+	uint64 t;
+
+	if (!gParkInstanceHeadlessTick)
+		game_command_replay_update();
+
 	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, sint32)++;
 	RCT2_GLOBAL(RCT2_ADDRESS_SCENARIO_TICKS, sint32)++;
 	RCT2_GLOBAL(0x009DEA66, sint16)++;
 	if (RCT2_GLOBAL(0x009DEA66, sint16) == 0)
 		RCT2_GLOBAL(0x009DEA66, sint16)--;
 
+	// Seed the counter based streams from this tick's RNG state before any
+	// subsystem draws from them
+	rng_streams_tick_begin();
+
+	t = SDL_GetPerformanceCounter();
+	if (!gParkInstanceHeadlessTick)
+		game_command_queue_flush();
 	sub_68B089();
 	scenario_update();
 	climate_update();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_OTHER, t);
 	map_update_tiles();
 	sub_6A876D();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_MAP, t);
 	peep_update_all();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_PEEP, t);
 	vehicle_update_all();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_VEHICLE, t);
 	sprite_misc_update_all();
+	litter_enforce_cap();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_OTHER, t);
 	ride_update_all();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_RIDE, t);
 	park_update();
 	research_update();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_OTHER, t);
 	ride_ratings_update_all();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_RATINGS, t);
 	ride_measurements_update();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_RIDE, t);
 	map_animation_invalidate_all();
-	vehicle_sounds_update();
-	peep_update_crowd_noise();
-	climate_update_sound();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_MAP, t);
+	if (!gParkInstanceHeadlessTick && !gGameTurboActive)
+		vehicle_sounds_update();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_VEHICLE, t);
+	if (!gParkInstanceHeadlessTick && !gGameTurboActive)
+		peep_update_crowd_noise();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_PEEP, t);
+	if (!gParkInstanceHeadlessTick && !gGameTurboActive)
+		climate_update_sound();
 	news_item_update_current();
 	editor_open_windows_for_current_step();
 
 	// Update windows
-	window_dispatch_update_all();
+	if (!gParkInstanceHeadlessTick && !gGameTurboActive)
+		window_dispatch_update_all();
+
+	// Headless background ticks are skipped: the active park's state span is
+	// byte identical again once it is swapped back in, so the rolling hashes
+	// stay correct without rehashing anything
+	if (!gParkInstanceHeadlessTick)
+		statehash_update();
 
-	if (RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) != 0) {
+	checkpoint_update();
+	t = game_logic_phase_end(GAME_LOGIC_PHASE_OTHER, t);
+	gGameLogicPhaseTicks++;
+
+	if (!gParkInstanceHeadlessTick && RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) != 0) {
 		rct_string_id title_text = STR_UNABLE_TO_LOAD_FILE;
 		rct_string_id body_text = RCT2_GLOBAL(RCT2_ADDRESS_ERROR_STRING_ID, uint16);
 		if (RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) == 254) {
@@ -364,6 +488,100 @@ static int game_check_affordability(int cost)
 static uint32 game_do_command_table[58];
 static GAME_COMMAND_POINTER* new_game_command_table[58];
 
+// Game command record / replay. Recording logs every top level applied
+// command together with the tick it executed on; replaying that log
+// against the same starting save injects the commands on the same ticks,
+// so the simulation follows bit for bit the same path and tick-time
+// profiles can be compared across builds on an identical workload. The log
+// does not embed the save, so record and replay must both be started from
+// the same park file.
+typedef struct {
+	uint32 tick;
+	sint32 eax, ebx, ecx, edx, esi, edi, ebp;
+} game_command_log_entry;
+
+static FILE *_commandRecordFile = NULL;
+static FILE *_commandReplayFile = NULL;
+static game_command_log_entry _commandReplayNext;
+static bool _commandReplayHasNext = false;
+static bool _commandReplaying = false;
+
+int game_command_record_begin(const char *path)
+{
+	if (_commandRecordFile != NULL)
+		return 0;
+
+	_commandRecordFile = fopen(path, "wb");
+	return _commandRecordFile != NULL;
+}
+
+void game_command_record_end()
+{
+	if (_commandRecordFile != NULL) {
+		fclose(_commandRecordFile);
+		_commandRecordFile = NULL;
+	}
+}
+
+int game_command_replay_begin(const char *path)
+{
+	if (_commandReplayFile != NULL)
+		return 0;
+
+	_commandReplayFile = fopen(path, "rb");
+	if (_commandReplayFile == NULL)
+		return 0;
+
+	_commandReplayHasNext = fread(&_commandReplayNext, sizeof(_commandReplayNext), 1, _commandReplayFile) == 1;
+	return 1;
+}
+
+void game_command_replay_end()
+{
+	if (_commandReplayFile != NULL) {
+		fclose(_commandReplayFile);
+		_commandReplayFile = NULL;
+	}
+	_commandReplayHasNext = false;
+}
+
+static void game_command_log(int eax, int ebx, int ecx, int edx, int esi, int edi, int ebp)
+{
+	game_command_log_entry entry;
+
+	entry.tick = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
+	entry.eax = eax;
+	entry.ebx = ebx;
+	entry.ecx = ecx;
+	entry.edx = edx;
+	entry.esi = esi;
+	entry.edi = edi;
+	entry.ebp = ebp;
+	fwrite(&entry, sizeof(entry), 1, _commandRecordFile);
+}
+
+/**
+ * Executes any replayed commands that are due on the current tick. Called
+ * at the top of game_logic_update, before the tick counters advance, which
+ * is the position the recorded commands originally executed from.
+ */
+static void game_command_replay_update()
+{
+	game_command_log_entry entry;
+
+	if (!_commandReplayHasNext)
+		return;
+
+	while (_commandReplayHasNext && _commandReplayNext.tick <= RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32)) {
+		entry = _commandReplayNext;
+		_commandReplayHasNext = fread(&_commandReplayNext, sizeof(_commandReplayNext), 1, _commandReplayFile) == 1;
+
+		_commandReplaying = true;
+		game_do_command(entry.eax, entry.ebx, entry.ecx, entry.edx, entry.esi, entry.edi, entry.ebp);
+		_commandReplaying = false;
+	}
+}
+
 /**
  * 
  *  rct2: 0x006677F2
@@ -386,9 +604,11 @@ int game_do_command(int eax, int ebx, int ecx, int edx, int esi, int edi, int eb
 int game_do_command_p(int command, int *eax, int *ebx, int *ecx, int *edx, int *esi, int *edi, int *ebp)
 {
 	int cost, flags, insufficientFunds;
-	int original_ebx, original_edx, original_esi, original_edi, original_ebp;
+	int original_eax, original_ebx, original_ecx, original_edx, original_esi, original_edi, original_ebp;
 
 	*esi = command;
+	original_eax = *eax;
+	original_ecx = *ecx;
 	original_ebx = *ebx;
 	original_edx = *edx;
 	original_esi = *esi;
@@ -457,6 +677,25 @@ int game_do_command_p(int command, int *eax, int *ebx, int *ecx, int *edx, int *
 				}
 			}
 
+			// An applied command may have changed the world, so let the
+			// ratings crawl revisit the rides and drop any cached
+			// surface heights
+			ride_ratings_invalidate_all();
+			map_element_height_invalidate_cache();
+			map_surface_element_cache_invalidate();
+			map_ownership_bitmaps_invalidate();
+			viewport_interaction_cache_invalidate();
+			editor_object_flags_invalidate();
+			ride_stats_invalidate();
+			ride_station_element_hints_invalidate();
+			ride_index_cache_invalidate();
+			park_size_invalidate();
+			park_appeal_invalidate();
+
+			// Log the applied command with its original arguments
+			if (_commandRecordFile != NULL && !_commandReplaying)
+				game_command_log(original_eax, original_ebx, original_ecx, original_edx, original_esi, original_edi, original_ebp);
+
 			return cost;
 		}
 	}
@@ -473,6 +712,92 @@ int game_do_command_p(int command, int *eax, int *ebx, int *ecx, int *edx, int *
 	return MONEY32_UNDEFINED;
 }
 
+// Deferred game command queue. Commands enqueued here execute in submission
+// order at the start of the next logic update instead of immediately, so a
+// tool can hand over a burst of work without interleaving command execution
+// with input handling, and so every deferred command passes through a single
+// well defined point in the tick, which any future replay or network play
+// will need.
+#define GAME_COMMAND_QUEUE_SIZE 64
+
+typedef struct {
+	int eax, ebx, ecx, edx, esi, edi, ebp;
+} queued_game_command;
+
+static queued_game_command _gameCommandQueue[GAME_COMMAND_QUEUE_SIZE];
+static int _gameCommandQueueLength = 0;
+
+// Returns false if the queue is full, in which case the caller should fall
+// back to issuing the command synchronously
+bool game_command_enqueue(int eax, int ebx, int ecx, int edx, int esi, int edi, int ebp)
+{
+	queued_game_command *command;
+
+	if (_gameCommandQueueLength == GAME_COMMAND_QUEUE_SIZE)
+		return false;
+
+	command = &_gameCommandQueue[_gameCommandQueueLength++];
+	command->eax = eax;
+	command->ebx = ebx;
+	command->ecx = ecx;
+	command->edx = edx;
+	command->esi = esi;
+	command->edi = edi;
+	command->ebp = ebp;
+	return true;
+}
+
+/**
+ * Runs the queued commands without applying them and sums their costs.
+ * Returns MONEY32_UNDEFINED if any command in the queue would fail.
+ */
+money32 game_command_queue_estimate()
+{
+	int i;
+	money32 cost, totalCost;
+	queued_game_command command;
+
+	totalCost = 0;
+	for (i = 0; i < _gameCommandQueueLength; i++) {
+		command = _gameCommandQueue[i];
+		cost = game_do_command(
+			command.eax,
+			command.ebx & ~GAME_COMMAND_FLAG_APPLY,
+			command.ecx,
+			command.edx,
+			command.esi,
+			command.edi,
+			command.ebp
+		);
+		if (cost == MONEY32_UNDEFINED)
+			return MONEY32_UNDEFINED;
+		totalCost += cost;
+	}
+	return totalCost;
+}
+
+void game_command_queue_flush()
+{
+	int i;
+	queued_game_command command;
+
+	// A flushed command may enqueue further commands; they run in the same
+	// flush because the loop re-reads the length
+	for (i = 0; i < _gameCommandQueueLength; i++) {
+		command = _gameCommandQueue[i];
+		game_do_command(
+			command.eax,
+			command.ebx,
+			command.ecx,
+			command.edx,
+			command.esi,
+			command.edi,
+			command.ebp
+		);
+	}
+	_gameCommandQueueLength = 0;
+}
+
 void pause_toggle()
 {
 	RCT2_GLOBAL(RCT2_ADDRESS_GAME_PAUSED, uint32) ^= 1;
@@ -588,21 +913,176 @@ static void load_landscape()
 	}
 }
 
+// Context for decoding the two large classic chunks on the worker pool; the
+// readers are positioned at each chunk's header by a skip scan beforehand
+typedef struct {
+	sawyercoding_reader readers[2];
+	uint8 *dests[2];
+	int results[2];
+} game_load_chunk_context;
+
+static void game_load_chunk_job(void *context, int index)
+{
+	game_load_chunk_context *ctx = (game_load_chunk_context*)context;
+	ctx->results[index] = sawyercoding_reader_read_chunk(&ctx->readers[index], ctx->dests[index]);
+}
+
+// Context for decoding the two large container sections on the worker pool
+typedef struct {
+	const uint8 *data;
+	const save_container_section *sections[2];
+	uint8 *dests[2];
+	int results[2];
+} game_load_container_context;
+
+static void game_load_container_job(void *context, int index)
+{
+	game_load_container_context *ctx = (game_load_container_context*)context;
+	ctx->results[index] = save_container_decode(ctx->data, ctx->sections[index], ctx->dests[index]);
+}
+
+/**
+ * Reads the chunks of a chunked container saved game into the same fixed
+ * addresses the classic stream decodes into. Sections carry their own
+ * checksums, so there is no whole file checksum pass, and the two large
+ * sections (map elements and game data) decode in parallel.
+ */
+static int game_load_save_container_chunks(const uint8 *data, uint32 size, uint8 *load_success)
+{
+	const save_container_section *section;
+	sawyercoding_reader reader;
+	game_load_container_context ctx;
+
+	// S6 header
+	section = save_container_find(data, size, SAVE_SECTION_S6_HEADER);
+	if (section == NULL || save_container_decode(data, section, (uint8*)0x009E34E4) < 0)
+		return 0;
+
+	// Object entries; the section holds a standard chunk, so the object
+	// loader's reader consumes it in place
+	section = save_container_find(data, size, SAVE_SECTION_OBJECTS);
+	if (section == NULL)
+		return 0;
+	sawyercoding_reader_init(&reader, data + section->offset, section->encodedLength);
+	*load_success = object_read_and_load_entries(&reader);
+
+	// Flags (16 bytes)
+	section = save_container_find(data, size, SAVE_SECTION_GAME_TIME);
+	if (section == NULL || save_container_decode(data, section, (uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR) < 0)
+		return 0;
+
+	// Map elements and game data are independent, decode them in parallel
+	ctx.data = data;
+	ctx.sections[0] = save_container_find(data, size, SAVE_SECTION_MAP_ELEMENTS);
+	ctx.sections[1] = save_container_find(data, size, SAVE_SECTION_GAME_DATA);
+	if (ctx.sections[0] == NULL || ctx.sections[1] == NULL)
+		return 0;
+
+	memset((void*)RCT2_ADDRESS_MAP_ELEMENTS, 0, MAX_MAP_ELEMENTS * sizeof(rct_map_element));
+	ctx.dests[0] = (uint8*)RCT2_ADDRESS_MAP_ELEMENTS;
+	ctx.dests[1] = (uint8*)0x010E63B8;
+	worker_pool_run(game_load_container_job, &ctx, 2);
+	if (ctx.results[0] < 0 || ctx.results[1] < 0)
+		return 0;
+
+	// The classic path decodes the game data chunk last, leaving its length
+	// in the decoded length global
+	RCT2_GLOBAL(0x009E3828, uint32) = ctx.results[1];
+	return 1;
+}
+
+/**
+ * Loads a delta autosave: decodes the full container base it was diffed
+ * against, then applies the delta's span sections over the base's map
+ * elements and game data. The base is the sibling file without the _delta
+ * name suffix; the checksum stored in the delta header must match the base's
+ * section checksums, so a delta never applies to the wrong base.
+ */
+static int game_load_save_delta(const char *path, const uint8 *data, uint32 size, uint8 *load_success)
+{
+	char basePath[MAX_PATH];
+	file_mapping baseFm;
+	const save_container_section *section;
+	uint8 *spans;
+	char *suffix;
+	int spansLength, result = 0;
+
+	strcpy(basePath, path);
+	suffix = strstr(basePath, "_delta.sv6");
+	if (suffix == NULL)
+		return 0;
+	strcpy(suffix, ".sv6");
+
+	if (!platform_file_map(basePath, &baseFm)) {
+		log_error("unable to open delta base %s", basePath);
+		return 0;
+	}
+	if (!save_container_is(baseFm.data, baseFm.size)) {
+		platform_file_unmap(&baseFm);
+		return 0;
+	}
+	if (save_container_checksum(baseFm.data, baseFm.size) != save_delta_base_checksum(data)) {
+		log_error("delta save does not match its base, %s", basePath);
+		platform_file_unmap(&baseFm);
+		return 0;
+	}
+
+	if (!game_load_save_container_chunks(baseFm.data, baseFm.size, load_success)) {
+		platform_file_unmap(&baseFm);
+		return 0;
+	}
+	platform_file_unmap(&baseFm);
+
+	// The header and game time come whole from the delta; the object list is
+	// the base's, deltas are only written while it is unchanged
+	section = save_delta_find(data, size, SAVE_SECTION_S6_HEADER);
+	if (section == NULL || save_container_decode(data, section, (uint8*)0x009E34E4) < 0)
+		return 0;
+	section = save_delta_find(data, size, SAVE_SECTION_GAME_TIME);
+	if (section == NULL || save_container_decode(data, section, (uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR) < 0)
+		return 0;
+
+	section = save_delta_find(data, size, SAVE_SECTION_MAP_ELEMENTS | SAVE_SECTION_DELTA_FLAG);
+	if (section == NULL)
+		return 0;
+	spans = malloc(section->decodedLength);
+	if (spans == NULL)
+		return 0;
+	spansLength = save_container_decode(data, section, spans);
+	if (spansLength >= 0)
+		result = save_delta_apply(spans, spansLength, (uint8*)RCT2_ADDRESS_MAP_ELEMENTS, 0x4A85EC);
+	free(spans);
+	if (!result)
+		return 0;
+
+	section = save_delta_find(data, size, SAVE_SECTION_GAME_DATA | SAVE_SECTION_DELTA_FLAG);
+	if (section == NULL)
+		return 0;
+	spans = malloc(section->decodedLength);
+	if (spans == NULL)
+		return 0;
+	spansLength = save_container_decode(data, section, spans);
+	result = 0;
+	if (spansLength >= 0)
+		result = save_delta_apply(spans, spansLength, (uint8*)0x010E63B8, 0x2E8570);
+	free(spans);
+	return result;
+}
+
 /**
- * 
+ *
  *  rct2: 0x00675E1B
  */
 int game_load_save(const char *path)
 {
-	rct_window *mainWindow;
-	FILE *file;
+	file_mapping fm;
+	sawyercoding_reader reader;
 	int i, j;
 
 	log_verbose("loading saved game, %s", path);
 
 	strcpy((char*)0x0141EF68, path);
-	file = fopen(path, "rb");
-	if (file == NULL) {
+	if (!platform_file_map(path, &fm)) {
 		log_error("unable to open %s", path);
 
 		RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) = 255;
@@ -610,45 +1090,84 @@ int game_load_save(const char *path)
 		return 0;
 	}
 
-	if (!sawyercoding_validate_checksum(file)) {
-		fclose(file);
-
-		log_error("invalid checksum, %s", path);
-
-		RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) = 255;
-		RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_STRING_ID, uint16) = STR_FILE_CONTAINS_INVALID_DATA;
-		return 0;
-	}
-
 	rct_s6_header *s6Header = (rct_s6_header*)0x009E34E4;
 	rct_s6_info *s6Info = (rct_s6_info*)0x0141F570;
+	uint8 load_success;
+
+	if (save_container_is(fm.data, fm.size)) {
+		// Chunked container saved game, see scenario_save_container
+		i = game_load_save_container_chunks(fm.data, fm.size, &load_success);
+		platform_file_unmap(&fm);
+		if (!i) {
+			log_error("corrupt chunked save, %s", path);
+
+			RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) = 255;
+			RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_STRING_ID, uint16) = STR_FILE_CONTAINS_INVALID_DATA;
+			return 0;
+		}
+	} else if (save_delta_is(fm.data, fm.size)) {
+		// Delta autosave against a container base, see scenario_save_async
+		i = game_load_save_delta(path, fm.data, fm.size, &load_success);
+		platform_file_unmap(&fm);
+		if (!i) {
+			log_error("corrupt or unmatched delta save, %s", path);
+
+			RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) = 255;
+			RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_STRING_ID, uint16) = STR_FILE_CONTAINS_INVALID_DATA;
+			return 0;
+		}
+	} else {
+		if (!sawyercoding_validate_checksum_buffer(fm.data, fm.size)) {
+			platform_file_unmap(&fm);
+
+			log_error("invalid checksum, %s", path);
 
-	// Read first chunk
-	sawyercoding_read_chunk(file, (uint8*)s6Header);
-	if (s6Header->type == S6_TYPE_SAVEDGAME) {
-		// Read packed objects
-		if (s6Header->num_packed_objects > 0) {
-			j = 0;
-			for (i = 0; i < s6Header->num_packed_objects; i++)
-				j += object_load_packed(file);
-			if (j > 0)
-				object_list_load();
+			RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) = 255;
+			RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_STRING_ID, uint16) = STR_FILE_CONTAINS_INVALID_DATA;
+			return 0;
+		}
+
+		sawyercoding_reader_init(&reader, fm.data, fm.size);
+
+		// Read first chunk
+		sawyercoding_reader_read_chunk(&reader, (uint8*)s6Header);
+		if (s6Header->type == S6_TYPE_SAVEDGAME) {
+			// Read packed objects
+			if (s6Header->num_packed_objects > 0) {
+				j = 0;
+				for (i = 0; i < s6Header->num_packed_objects; i++)
+					j += object_load_packed(&reader);
+				if (j > 0)
+					object_list_load();
+			}
 		}
-	}
 
-	uint8 load_success = object_read_and_load_entries(file);
+		load_success = object_read_and_load_entries(&reader);
 
-	// Read flags (16 bytes)
-	sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR);
+		// Read flags (16 bytes)
+		sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR);
 
-	// Read map elements
-	memset((void*)RCT2_ADDRESS_MAP_ELEMENTS, 0, MAX_MAP_ELEMENTS * sizeof(rct_map_element));
-	sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_MAP_ELEMENTS);
+		memset((void*)RCT2_ADDRESS_MAP_ELEMENTS, 0, MAX_MAP_ELEMENTS * sizeof(rct_map_element));
 
-	// Read game data, including sprites
-	sawyercoding_read_chunk(file, (uint8*)0x010E63B8);
+		// The map element and game data chunks are independent once their
+		// offsets are known, so scan past the map element chunk header and
+		// decode both concurrently on the worker pool
+		game_load_chunk_context ctx;
+		ctx.readers[0] = reader;
+		ctx.dests[0] = (uint8*)RCT2_ADDRESS_MAP_ELEMENTS;
+		ctx.dests[1] = (uint8*)0x010E63B8;
+		if (sawyercoding_reader_skip_chunk(&reader)) {
+			ctx.readers[1] = reader;
+			worker_pool_run(game_load_chunk_job, &ctx, 2);
+			RCT2_GLOBAL(0x009E3828, uint32) = ctx.results[1];
+		} else {
+			// Truncated stream, decode serially so the reads fail in order
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_MAP_ELEMENTS);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)0x010E63B8);
+		}
 
-	fclose(file);
+		platform_file_unmap(&fm);
+	}
 
 	// Check expansion pack
 	// RCT2_CALLPROC_EBPSAFE(0x006757E6);
@@ -666,10 +1185,35 @@ int game_load_save(const char *path)
 		return 0;//This never gets called
 	}
 
-	// The rest is the same as in scenario load and play
+	game_load_init();
+	return 1;
+}
+
+/**
+ * Initialises the game from freshly loaded saved game state: fixes up the
+ * loaded globals, then recreates the main viewport from the saved view.
+ * Shared by the saved game loader and the crash checkpoint restore.
+ */
+void game_load_init()
+{
+	rct_window *mainWindow;
+
 	reset_loaded_objects();
 	map_update_tile_pointers();
 	reset_0x69EBE4();
+	game_state_sync_from_legacy();
+	peep_thought_counters_invalidate();
+	staff_patrol_index_invalidate();
+	user_string_table_invalidate();
+	finance_history_invalidate();
+	editor_object_flags_invalidate();
+	ride_stats_invalidate();
+	ride_station_element_hints_invalidate();
+	ride_index_cache_invalidate();
+	park_size_invalidate();
+	park_appeal_invalidate();
+	statehash_invalidate();
+	path_heat_reset();
 	RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) = SCREEN_FLAGS_PLAYING;
 	viewport_init_all();
 	game_create_windows();
@@ -706,7 +1250,6 @@ int game_load_save(const char *path)
 	gfx_invalidate_screen();
 
 	scenario_set_filename((char*)0x0135936C);
-	return 1;
 }
 
 /*
@@ -812,7 +1355,7 @@ void game_autosave()
 	platform_get_user_directory(path, "save");
 	strcat(path, "autosave.sv6");
 
-	scenario_save(path, 0x80000000);
+	scenario_save_async(path);
 }
 
 /**
@@ -91,6 +91,32 @@ typedef void (GAME_COMMAND_POINTER)(int* eax, int* ebx, int* ecx, int* edx, int*
 
 extern int gGameSpeed;
 
+// The speed above the fastest fixed multiplier: ticks run in wall time sized
+// batches with window events, invalidations and tick driven audio suppressed,
+// refreshing the screen from a periodic preview frame instead
+#define GAME_SPEED_TURBO 9
+
+// Nonzero while a turbo tick batch is executing
+extern int gGameTurboActive;
+
+// Subsystem phases of game_logic_update that are timed individually
+enum {
+	GAME_LOGIC_PHASE_MAP,
+	GAME_LOGIC_PHASE_PEEP,
+	GAME_LOGIC_PHASE_VEHICLE,
+	GAME_LOGIC_PHASE_RIDE,
+	GAME_LOGIC_PHASE_RATINGS,
+	GAME_LOGIC_PHASE_OTHER,
+	GAME_LOGIC_PHASE_COUNT
+};
+
+extern const char *gGameLogicPhaseNames[GAME_LOGIC_PHASE_COUNT];
+
+// Accumulated time per phase in performance counter units, and the number of
+// ticks accumulated over; reset both to take a new measurement
+extern uint64 gGameLogicPhaseTime[GAME_LOGIC_PHASE_COUNT];
+extern uint32 gGameLogicPhaseTicks;
+
 void game_increase_game_speed();
 void game_reduce_game_speed();
 
@@ -103,11 +129,21 @@ void update_palette_effects();
 int game_do_command(int eax, int ebx, int ecx, int edx, int esi, int edi, int ebp);
 int game_do_command_p(int command, int *eax, int *ebx, int *ecx, int *edx, int *esi, int *edi, int *ebp);
 
+bool game_command_enqueue(int eax, int ebx, int ecx, int edx, int esi, int edi, int ebp);
+money32 game_command_queue_estimate();
+void game_command_queue_flush();
+
+int game_command_record_begin(const char *path);
+void game_command_record_end();
+int game_command_replay_begin(const char *path);
+void game_command_replay_end();
+
 void game_increase_game_speed();
 void game_reduce_game_speed();
 
 void game_load_or_quit_no_save_prompt();
 int game_load_save(const char *path);
+void game_load_init();
 void game_pause_toggle(int *eax, int *ebx, int *ecx, int *edx, int *esi, int *edi, int *ebp);
 void pause_toggle();
 char save_game();
@@ -0,0 +1,70 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "addresses.h"
+#include "game_state.h"
+
+rct_game_state gGameState;
+
+/**
+ * Reads the migrated state groups from their legacy data segment addresses.
+ * Called after a saved game or scenario has been deserialised into the data
+ * segment.
+ */
+void game_state_sync_from_legacy()
+{
+	rct_climate_state *climate = &gGameState.climate;
+
+	climate->current_climate = RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE, uint8);
+	climate->current_weather = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER, sint8);
+	climate->current_temperature = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TEMPERATURE, sint8);
+	climate->current_weather_effect = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_EFFECT, sint8);
+	climate->current_weather_gloom = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_GLOOM, sint8);
+	climate->current_rain_level = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_RAIN_LEVEL, sint8);
+	climate->next_weather = RCT2_GLOBAL(0x013CA74B, uint8);
+	climate->next_temperature = RCT2_GLOBAL(0x013CA74D, sint8);
+	climate->next_weather_effect = RCT2_GLOBAL(0x013CA74F, sint8);
+	climate->next_weather_gloom = RCT2_GLOBAL(0x013CA751, sint8);
+	climate->next_rain_level = RCT2_GLOBAL(0x013CA753, sint8);
+	climate->update_timer = RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE_UPDATE_TIMER, sint16);
+}
+
+/**
+ * Mirrors the migrated state groups back to their legacy data segment
+ * addresses, for the original executable, native code that has not been
+ * migrated yet and the saved game serialiser.
+ */
+void game_state_sync_to_legacy()
+{
+	rct_climate_state *climate = &gGameState.climate;
+
+	RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE, uint8) = climate->current_climate;
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER, sint8) = climate->current_weather;
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TEMPERATURE, sint8) = climate->current_temperature;
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_EFFECT, sint8) = climate->current_weather_effect;
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_GLOOM, sint8) = climate->current_weather_gloom;
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_RAIN_LEVEL, sint8) = climate->current_rain_level;
+	RCT2_GLOBAL(0x013CA74B, uint8) = climate->next_weather;
+	RCT2_GLOBAL(0x013CA74D, sint8) = climate->next_temperature;
+	RCT2_GLOBAL(0x013CA74F, sint8) = climate->next_weather_effect;
+	RCT2_GLOBAL(0x013CA751, sint8) = climate->next_weather_gloom;
+	RCT2_GLOBAL(0x013CA753, sint8) = climate->next_rain_level;
+	RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE_UPDATE_TIMER, sint16) = climate->update_timer;
+}
@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _GAME_STATE_H_
+#define _GAME_STATE_H_
+
+#include "common.h"
+
+/**
+ * Native store for game state that is being migrated out of the original
+ * executable's data segment. State groups are moved here one subsystem at a
+ * time so their working set is packed into a few cache lines instead of being
+ * scattered across the segment, and so they stop depending on 32-bit absolute
+ * addresses.
+ *
+ * The original executable and not yet migrated native code still read the
+ * legacy addresses, and the saved game format serialises the data segment
+ * directly, so each group is mirrored back with game_state_sync_to_legacy
+ * whenever it changes and picked up with game_state_sync_from_legacy after a
+ * saved game or scenario has been loaded.
+ */
+
+typedef struct {
+	uint8 current_climate;
+	sint8 current_weather;
+	sint8 current_temperature;
+	sint8 current_weather_effect;
+	sint8 current_weather_gloom;
+	sint8 current_rain_level;
+	uint8 next_weather;
+	sint8 next_temperature;
+	sint8 next_weather_effect;
+	sint8 next_weather_gloom;
+	sint8 next_rain_level;
+	sint16 update_timer;
+} rct_climate_state;
+
+typedef struct {
+	rct_climate_state climate;
+} rct_game_state;
+
+extern rct_game_state gGameState;
+
+void game_state_sync_from_legacy();
+void game_state_sync_to_legacy();
+
+#endif
@@ -25,6 +25,61 @@ void* g_hooktableaddress = 0;
 int g_hooktableoffset = 0;
 int g_maxhooks = 1000;
 
+// Registry of natively implemented routines, probed by RCT2_CALLPROC_X and
+// RCT2_CALLFUNC_X before falling back to the assembly trampoline. Open
+// addressed on the low bits of the address and kept at most half full, so a
+// lookup for an unregistered address usually stops at the first slot.
+#define MAX_NATIVE_HOOKS 512
+
+typedef struct {
+	int address;
+	hook_function function;
+	unsigned int callcount;
+} native_hook;
+
+static native_hook g_nativehooks[MAX_NATIVE_HOOKS];
+static int g_numnativehooks = 0;
+
+static native_hook *hook_native_find(int address)
+{
+	int slot = (address >> 2) & (MAX_NATIVE_HOOKS - 1);
+	for (;;) {
+		native_hook *hook = &g_nativehooks[slot];
+		if (hook->function == NULL || hook->address == address)
+			return hook;
+		slot = (slot + 1) & (MAX_NATIVE_HOOKS - 1);
+	}
+}
+
+void hook_register_native(int address, hook_function function)
+{
+	native_hook *hook;
+
+	if (g_numnativehooks >= MAX_NATIVE_HOOKS / 2)
+		return;
+
+	hook = hook_native_find(address);
+	if (hook->function == NULL)
+		g_numnativehooks++;
+	hook->address = address;
+	hook->function = function;
+	hook->callcount = 0;
+}
+
+hook_function hook_get_native(int address)
+{
+	native_hook *hook = hook_native_find(address);
+	if (hook->function == NULL)
+		return NULL;
+	hook->callcount++;
+	return hook->function;
+}
+
+unsigned int hook_get_native_call_count(int address)
+{
+	return hook_native_find(address)->callcount;
+}
+
 void hookfunc(int address, int newaddress, int stacksize, int registerargs[], int registersreturned)
 {
 	int i = 0;
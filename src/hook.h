@@ -34,4 +34,16 @@ enum REGISTER_ARGS {
 
 void addhook(int address, int newaddress, int stacksize, int registerargs[], int registersreturned);
 
+// Dispatch registry for natively implemented routines. Addresses registered
+// here are called directly by RCT2_CALLPROC_X / RCT2_CALLFUNC_X instead of
+// marshalling every register through the assembly trampoline. Registers are
+// passed in and out through the pointer arguments, mirroring RCT2_CALLFUNC_X;
+// the return value is the emulated flags register. Call counts are kept per
+// registered address so porting effort can be focused on the hottest hooks.
+typedef int (*hook_function)(int *_eax, int *_ebx, int *_ecx, int *_edx, int *_esi, int *_edi, int *_ebp);
+
+void hook_register_native(int address, hook_function function);
+hook_function hook_get_native(int address);
+unsigned int hook_get_native_call_count(int address);
+
 #endif
\ No newline at end of file
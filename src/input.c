@@ -47,6 +47,16 @@ static rct_windownumber _dragWindowNumber;
 static int _dragWidgetIndex;
 static int _originalWindowWidth, _originalWindowHeight;
 
+// Mouse motion is already coalesced to the latest position by the time it
+// reaches here, but hover resolution still probes what is under the cursor
+// every tick, and the viewport part of that probe is a paint pass. Remember
+// where the cursor was last resolved so a stationary cursor skips the probe;
+// it is re-run on a short interval anyway to pick up the screen changing
+// underneath (scrolling, animation), and immediately after any click.
+static int _mouseOverLastX = -1;
+static int _mouseOverLastY = -1;
+static uint8 _mouseOverRevalidateDelay;
+
 typedef struct {
 	uint32 x, y;
 	uint32 state; //1 = LeftDown 2 = LeftUp 3 = RightDown 4 = RightUp
@@ -113,6 +123,7 @@ void game_handle_input()
 				break;
 
 			game_handle_input_mouse(x, y, state & 0xFF);
+			_mouseOverRevalidateDelay = 0;
 		}
 
 		if (RCT2_GLOBAL(RCT2_ADDRESS_INPUT_FLAGS, uint32) & INPUT_FLAG_5) {
@@ -123,7 +134,14 @@ void game_handle_input()
 			y = clamp(0, y, RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_HEIGHT, sint16) - 1);
 
 			game_handle_input_mouse(x, y, state);
-			process_mouse_over(x, y);
+			if (x != _mouseOverLastX || y != _mouseOverLastY || _mouseOverRevalidateDelay == 0) {
+				_mouseOverLastX = x;
+				_mouseOverLastY = y;
+				_mouseOverRevalidateDelay = 4;
+				process_mouse_over(x, y);
+			} else {
+				_mouseOverRevalidateDelay--;
+			}
 			process_mouse_tool(x, y);
 		}
 	}
@@ -533,7 +551,8 @@ static void input_scroll_begin(rct_window *w, int widgetIndex, int x, int y)
 		break;
 	}
 	widget_scroll_update_thumbs(w, widgetIndex);
-	window_invalidate_by_number(widgetIndex, w->classification);
+	// Only the scroll widget needs repainting, not the whole window
+	widget_invalidate(w, widgetIndex);
 }
 
 static void input_scroll_continue(rct_window *w, int widgetIndex, int state, int x, int y)
@@ -21,6 +21,7 @@
 #include "../addresses.h"
 #include "../localisation/date.h"
 #include "../localisation/localisation.h"
+#include "../management/finance.h"
 #include "graph.h"
 
 static void graph_draw_months_uint8(rct_drawpixelinfo *dpi, uint8 *history, int count, int baseX, int baseY)
@@ -99,7 +100,61 @@ void graph_draw_uint8(rct_drawpixelinfo *dpi, uint8 *history, int count, int bas
 	graph_draw_line_b_uint8(dpi, history, count, baseX, baseY);
 }
 
-static void graph_draw_months_money32(rct_drawpixelinfo *dpi, money32 *history, int count, int baseX, int baseY)
+// Cached series derived from a money history. The finance histories only
+// move when the weekly update shifts them, so the y offset of every point
+// (which is independent of where the graph is drawn) is computed once per
+// history and reused by every paint until the finance history generation
+// changes. An offset of GRAPH_POINT_UNDEFINED marks a gap in the history.
+#define GRAPH_SERIES_CACHE_SIZE 4
+#define GRAPH_SERIES_MAX_POINTS 128
+#define GRAPH_POINT_UNDEFINED 0x7FFF
+
+typedef struct {
+	money32 *history;
+	int count;
+	int modifier;
+	int offset;
+	uint32 generation;
+	sint16 points[GRAPH_SERIES_MAX_POINTS];
+} graph_series;
+
+static graph_series _graphSeriesCache[GRAPH_SERIES_CACHE_SIZE];
+static int _graphSeriesCacheNext = 0;
+
+static graph_series *graph_series_get_money32(money32 *history, int count, int modifier, int offset)
+{
+	graph_series *series;
+	uint32 generation;
+	int i;
+
+	generation = finance_history_generation();
+	for (i = 0; i < GRAPH_SERIES_CACHE_SIZE; i++) {
+		series = &_graphSeriesCache[i];
+		if (series->history == history && series->count == count &&
+			series->modifier == modifier && series->offset == offset &&
+			series->generation == generation
+		)
+			return series;
+	}
+
+	series = &_graphSeriesCache[_graphSeriesCacheNext];
+	_graphSeriesCacheNext = (_graphSeriesCacheNext + 1) % GRAPH_SERIES_CACHE_SIZE;
+
+	series->history = history;
+	series->count = count;
+	series->modifier = modifier;
+	series->offset = offset;
+	series->generation = generation;
+	for (i = 0; i < count && i < GRAPH_SERIES_MAX_POINTS; i++) {
+		if (history[i] == MONEY32_UNDEFINED)
+			series->points[i] = GRAPH_POINT_UNDEFINED;
+		else
+			series->points[i] = 170 - 6 - ((((history[i] >> modifier) + offset) * 170) / 256);
+	}
+	return series;
+}
+
+static void graph_draw_months_money32(rct_drawpixelinfo *dpi, graph_series *series, int count, int baseX, int baseY)
 {
 	int i, x, y, yearOver32, currentMonth, currentDay;
 
@@ -109,7 +164,7 @@ static void graph_draw_months_money32(rct_drawpixelinfo *dpi, money32 *history,
 	x = baseX;
 	y = baseY;
 	for (i = count - 1; i >= 0; i--) {
-		if (history[i] != 0x80000000 && yearOver32 % 4 == 0) {
+		if (series->points[i] != GRAPH_POINT_UNDEFINED && yearOver32 % 4 == 0) {
 			// Draw month text
 			sint32 monthFormat = ((yearOver32 / 4) + 8) % 8 + STR_MONTH_SHORT_MAR;
 			gfx_draw_string_centred(dpi, 2222, x, y - 10, 0, &monthFormat);
@@ -123,14 +178,14 @@ static void graph_draw_months_money32(rct_drawpixelinfo *dpi, money32 *history,
 	}
 }
 
-static void graph_draw_line_a_money32(rct_drawpixelinfo *dpi, money32 *history, int count, int baseX, int baseY, int modifier, int offset)
+static void graph_draw_line_a_money32(rct_drawpixelinfo *dpi, graph_series *series, int count, int baseX, int baseY)
 {
 	int i, x, y, lastX, lastY;
 	lastX = -1;
 	x = baseX;
 	for (i = count - 1; i >= 0; i--) {
-		if (history[i] != 0x80000000) {
-			y = baseY + 170 - 6 - ((((history[i] >> modifier) + offset) * 170) / 256);
+		if (series->points[i] != GRAPH_POINT_UNDEFINED) {
+			y = baseY + series->points[i];
 
 			if (lastX != -1) {
 				gfx_draw_line(dpi, lastX + 1, lastY + 1, x + 1, y + 1, 10);
@@ -146,15 +201,15 @@ static void graph_draw_line_a_money32(rct_drawpixelinfo *dpi, money32 *history,
 	}
 }
 
-static void graph_draw_line_b_money32(rct_drawpixelinfo *dpi, money32 *history, int count, int baseX, int baseY, int modifier, int offset)
+static void graph_draw_line_b_money32(rct_drawpixelinfo *dpi, graph_series *series, int count, int baseX, int baseY)
 {
 	int i, x, y, lastX, lastY;
 
 	lastX = -1;
 	x = baseX;
 	for (i = count - 1; i >= 0; i--) {
-		if (history[i] != 0x80000000) {
-			y = baseY + 170 - 6 - ((((history[i] >> modifier) + offset) * 170) / 256);
+		if (series->points[i] != GRAPH_POINT_UNDEFINED) {
+			y = baseY + series->points[i];
 
 			if (lastX != -1)
 				gfx_draw_line(dpi, lastX, lastY, x, y, 21);
@@ -170,7 +225,64 @@ static void graph_draw_line_b_money32(rct_drawpixelinfo *dpi, money32 *history,
 
 void graph_draw_money32(rct_drawpixelinfo *dpi, money32 *history, int count, int baseX, int baseY, int modifier, int offset)
 {
-	graph_draw_months_money32(dpi, history, count, baseX, baseY);
-	graph_draw_line_a_money32(dpi, history, count, baseX, baseY, modifier, offset);
-	graph_draw_line_b_money32(dpi, history, count, baseX, baseY, modifier, offset);
+	graph_series *series = graph_series_get_money32(history, count, modifier, offset);
+
+	graph_draw_months_money32(dpi, series, count, baseX, baseY);
+	graph_draw_line_a_money32(dpi, series, count, baseX, baseY);
+	graph_draw_line_b_money32(dpi, series, count, baseX, baseY);
+}
+
+/**
+ * Returns the y axis scale (log2 of the highest absolute value) for the
+ * given money history, cached until the finance history generation changes.
+ */
+int graph_get_money32_y_axis_scale(money32 *history, int count, int maxPixels)
+{
+	typedef struct {
+		money32 *history;
+		int count;
+		int maxPixels;
+		int scale;
+		uint32 generation;
+	} graph_scale;
+
+	static graph_scale cache[GRAPH_SERIES_CACHE_SIZE];
+	static int cacheNext = 0;
+
+	graph_scale *entry;
+	money32 value;
+	uint32 generation;
+	int i, scale;
+
+	generation = finance_history_generation();
+	for (i = 0; i < GRAPH_SERIES_CACHE_SIZE; i++) {
+		entry = &cache[i];
+		if (entry->history == history && entry->count == count &&
+			entry->maxPixels == maxPixels && entry->generation == generation
+		)
+			return entry->scale;
+	}
+
+	scale = 0;
+	for (i = 0; i < count; i++) {
+		value = history[i];
+		if (value == MONEY32_UNDEFINED)
+			continue;
+
+		// Keep halving until the value fits into the pixel range
+		value = abs(value) >> scale;
+		while (value > maxPixels) {
+			value /= 2;
+			scale++;
+		}
+	}
+
+	entry = &cache[cacheNext];
+	cacheNext = (cacheNext + 1) % GRAPH_SERIES_CACHE_SIZE;
+	entry->history = history;
+	entry->count = count;
+	entry->maxPixels = maxPixels;
+	entry->scale = scale;
+	entry->generation = generation;
+	return entry->scale;
 }
\ No newline at end of file
@@ -26,5 +26,6 @@
 
 void graph_draw_uint8(rct_drawpixelinfo *dpi, uint8 *history, int count, int baseX, int baseY);
 void graph_draw_money32(rct_drawpixelinfo *dpi, money32 *history, int count, int baseX, int baseY, int modifier, int offset);
+int graph_get_money32_y_axis_scale(money32 *history, int count, int maxPixels);
 
 #endif
\ No newline at end of file
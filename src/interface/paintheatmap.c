@@ -0,0 +1,159 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "../addresses.h"
+#include "../drawing/drawing.h"
+#include "../platform/platform.h"
+#include "paintheatmap.h"
+
+// Paint cost heatmap. Viewports are painted in 32 pixel columns, so that is
+// the granularity costs are collected at: each painted column reports its
+// wall time and how many paint structs it generated, keyed by screen
+// position, and the overlay tints each column's area by its smoothed cost.
+// While the overlay is up the whole screen is invalidated every frame, both
+// so the tint is applied over a fresh world and so every column keeps
+// sampling; the overlay is for finding what is expensive, not for measuring
+// how cheap an idle frame is.
+#define PAINT_HEATMAP_MAX_COLUMNS 256
+
+typedef struct {
+	float ms;
+	float paintStructs;
+	sint16 x;
+	sint16 y;
+	sint16 width;
+	sint16 height;
+} paint_heatmap_cell;
+
+int gPaintHeatmapEnabled = 0;
+
+static paint_heatmap_cell _cells[PAINT_HEATMAP_MAX_COLUMNS];
+
+static double _msPerCount = 0;
+
+static float paint_heatmap_counts_to_ms(uint64 counts)
+{
+	if (_msPerCount == 0)
+		_msPerCount = 1000.0 / SDL_GetPerformanceFrequency();
+	return (float)(counts * _msPerCount);
+}
+
+void paint_heatmap_toggle()
+{
+	gPaintHeatmapEnabled = !gPaintHeatmapEnabled;
+	memset(_cells, 0, sizeof(_cells));
+	if (!gPaintHeatmapEnabled) {
+		// Repaint over the overlay
+		gfx_invalidate_screen();
+	}
+}
+
+/**
+ * Records one painted viewport column. x, y, width and height are the screen
+ * area the column covered; smaller viewports painting over the same columns
+ * simply take the cells over, which is what the overlay should show anyway.
+ */
+void paint_heatmap_column_record(int x, int y, int width, int height, uint64 timeCounts, int paintStructs)
+{
+	paint_heatmap_cell *cell;
+	float ms;
+
+	if (!gPaintHeatmapEnabled)
+		return;
+	if (x < 0 || x / 32 >= PAINT_HEATMAP_MAX_COLUMNS)
+		return;
+
+	// Columns are serialised by the viewport paint mutex, so plain writes
+	// are safe here
+	cell = &_cells[x / 32];
+	ms = paint_heatmap_counts_to_ms(timeCounts);
+	cell->ms += (ms - cell->ms) * 0.25f;
+	cell->paintStructs += (paintStructs - cell->paintStructs) * 0.25f;
+	cell->x = x;
+	cell->y = y;
+	cell->width = width;
+	cell->height = height;
+}
+
+/**
+ * Returns the remap colour to tint a column with, or -1 for a column too
+ * cheap to bother tinting. Same ramp as the path heat overlay; thresholds
+ * are sized against the 25 ms frame budget spread over a screen or two of
+ * 32 pixel columns.
+ */
+static int paint_heatmap_column_colour(float ms)
+{
+	if (ms < 0.05f)
+		return -1;
+	if (ms >= 2.0f)
+		return 28; // bright red
+	if (ms >= 1.0f)
+		return 21; // dark orange
+	if (ms >= 0.5f)
+		return 18; // yellow
+	return 14; // bright green
+}
+
+/**
+ * Draws the tint directly onto the screen buffer, after the windows have
+ * painted and before the buffer is presented.
+ */
+void paint_heatmap_draw()
+{
+	rct_drawpixelinfo *dpi = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
+	paint_heatmap_cell *cell;
+	char buffer[64];
+	int i, colour, hottestIndex;
+	float hottestMs;
+
+	if (!gPaintHeatmapEnabled)
+		return;
+
+	// The overlay bypasses the dirty block grid
+	gfx_request_present();
+
+	hottestIndex = -1;
+	hottestMs = 0;
+	for (i = 0; i < PAINT_HEATMAP_MAX_COLUMNS; i++) {
+		cell = &_cells[i];
+		if (cell->width == 0 || cell->height == 0)
+			continue;
+
+		// Glass palettes sit at 44 + remap colour
+		colour = paint_heatmap_column_colour(cell->ms);
+		if (colour != -1)
+			gfx_fill_rect(dpi, cell->x, cell->y, cell->x + cell->width - 1, cell->y + cell->height - 1, 0x2000000 | (44 + colour));
+
+		if (cell->ms > hottestMs) {
+			hottestMs = cell->ms;
+			hottestIndex = i;
+		}
+	}
+
+	if (hottestIndex != -1) {
+		sprintf(buffer, "hottest column %6.2f ms, %d paint structs", hottestMs, (int)_cells[hottestIndex].paintStructs);
+		gfx_draw_string(dpi, buffer, 21, 10, 16);
+	}
+
+	// The tint darkens whatever the windows last painted, so force a full
+	// repaint before the next application; this is also what keeps every
+	// column producing a fresh sample each frame
+	gfx_invalidate_screen();
+}
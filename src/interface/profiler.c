@@ -0,0 +1,275 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "../addresses.h"
+#include "../drawing/drawing.h"
+#include "../game.h"
+#include "../platform/platform.h"
+#include "../util/memtrack.h"
+#include "profiler.h"
+
+// Captures how one frame spent its time: the update and draw wall time and
+// the per-phase deltas of the game logic counters, all in milliseconds
+typedef struct {
+	float update;
+	float draw;
+	float phases[GAME_LOGIC_PHASE_COUNT];
+} profiler_frame;
+
+int gProfilerEnabled = 0;
+
+// Set while the performance counter export is active, so the frame history
+// keeps recording even when the overlay itself is hidden
+int gProfilerExternalCollect = 0;
+
+static profiler_frame _frameHistory[PROFILER_HISTORY_SIZE];
+static int _frameHistoryIndex = 0;
+
+static uint64 _frameStart;
+static uint64 _updateEnd;
+static uint64 _phaseTimeSnapshot[GAME_LOGIC_PHASE_COUNT];
+
+static double _msPerCount = 0;
+
+static float profiler_counts_to_ms(uint64 counts)
+{
+	if (_msPerCount == 0)
+		_msPerCount = 1000.0 / SDL_GetPerformanceFrequency();
+	return (float)(counts * _msPerCount);
+}
+
+void profiler_frame_begin()
+{
+	if (!gProfilerEnabled && !gProfilerExternalCollect)
+		return;
+
+	_frameStart = SDL_GetPerformanceCounter();
+	memcpy(_phaseTimeSnapshot, gGameLogicPhaseTime, sizeof(_phaseTimeSnapshot));
+}
+
+void profiler_update_done()
+{
+	if (!gProfilerEnabled && !gProfilerExternalCollect)
+		return;
+
+	_updateEnd = SDL_GetPerformanceCounter();
+}
+
+void profiler_frame_end()
+{
+	profiler_frame *frame;
+	int i;
+
+	if (!gProfilerEnabled && !gProfilerExternalCollect)
+		return;
+
+	frame = &_frameHistory[_frameHistoryIndex];
+	_frameHistoryIndex = (_frameHistoryIndex + 1) % PROFILER_HISTORY_SIZE;
+
+	frame->update = profiler_counts_to_ms(_updateEnd - _frameStart);
+	frame->draw = profiler_counts_to_ms(SDL_GetPerformanceCounter() - _updateEnd);
+	for (i = 0; i < GAME_LOGIC_PHASE_COUNT; i++)
+		frame->phases[i] = profiler_counts_to_ms(gGameLogicPhaseTime[i] - _phaseTimeSnapshot[i]);
+}
+
+// Smoothed frame pacing figures from the main loop: how long the hybrid
+// wait slept or spun and how far past its target the frame was delivered.
+// Pacing runs per draw pass rather than per logic frame, so these are kept
+// as exponential averages instead of entries in the frame history.
+static float _pacingWaitMs;
+static float _pacingDriftMs;
+
+void profiler_pacing_report(uint64 waitCounts, sint64 driftCounts)
+{
+	float waitMs, driftMs;
+
+	if (!gProfilerEnabled)
+		return;
+
+	waitMs = profiler_counts_to_ms(waitCounts);
+	driftMs = driftCounts < 0 ? -profiler_counts_to_ms(-driftCounts) : profiler_counts_to_ms(driftCounts);
+	_pacingWaitMs += (waitMs - _pacingWaitMs) * 0.1f;
+	_pacingDriftMs += (driftMs - _pacingDriftMs) * 0.1f;
+}
+
+void profiler_toggle()
+{
+	gProfilerEnabled = !gProfilerEnabled;
+	if (gProfilerEnabled) {
+		memset(_frameHistory, 0, sizeof(_frameHistory));
+		_frameHistoryIndex = 0;
+		_pacingWaitMs = 0;
+		_pacingDriftMs = 0;
+	} else {
+		// Repaint over the overlay
+		gfx_invalidate_screen();
+	}
+}
+
+/**
+ * Averages the rolling history into a single frame.
+ */
+static void profiler_get_average(profiler_frame *average)
+{
+	int i, j;
+
+	memset(average, 0, sizeof(*average));
+	for (i = 0; i < PROFILER_HISTORY_SIZE; i++) {
+		average->update += _frameHistory[i].update;
+		average->draw += _frameHistory[i].draw;
+		for (j = 0; j < GAME_LOGIC_PHASE_COUNT; j++)
+			average->phases[j] += _frameHistory[i].phases[j];
+	}
+	average->update /= PROFILER_HISTORY_SIZE;
+	average->draw /= PROFILER_HISTORY_SIZE;
+	for (j = 0; j < GAME_LOGIC_PHASE_COUNT; j++)
+		average->phases[j] /= PROFILER_HISTORY_SIZE;
+}
+
+/**
+ * Copies the rolling frame history, oldest first, together with the averaged
+ * per phase times, for consumers outside the overlay (the performance counter
+ * export). The update and draw arrays must hold PROFILER_HISTORY_SIZE entries
+ * and phaseAverageMs must hold GAME_LOGIC_PHASE_COUNT. Returns the number of
+ * frames copied.
+ */
+int profiler_get_history(float *updateMs, float *drawMs, float *phaseAverageMs)
+{
+	profiler_frame average;
+	int i;
+
+	for (i = 0; i < PROFILER_HISTORY_SIZE; i++) {
+		profiler_frame *frame = &_frameHistory[(_frameHistoryIndex + i) % PROFILER_HISTORY_SIZE];
+		updateMs[i] = frame->update;
+		drawMs[i] = frame->draw;
+	}
+
+	profiler_get_average(&average);
+	for (i = 0; i < GAME_LOGIC_PHASE_COUNT; i++)
+		phaseAverageMs[i] = average.phases[i];
+
+	return PROFILER_HISTORY_SIZE;
+}
+
+/**
+ * Draws the overlay directly onto the screen buffer, after the windows have
+ * painted and before the buffer is presented.
+ */
+void profiler_draw()
+{
+	rct_drawpixelinfo *dpi = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
+	profiler_frame average;
+	char buffer[64];
+	int i, x, y, barHeight;
+	float frameMs;
+
+	if (!gProfilerEnabled)
+		return;
+
+	// The overlay bypasses the dirty block grid
+	gfx_request_present();
+
+	profiler_get_average(&average);
+
+	x = 10;
+	y = 30;
+
+	// Backing panel; two pixels per histogram bar
+	gfx_fill_rect(dpi, x - 4, y - 4, x + PROFILER_HISTORY_SIZE * 2 + 4, y + (GAME_LOGIC_PHASE_COUNT + MEMTRACK_TAG_COUNT + 5) * 10 + 54, 0);
+
+	sprintf(buffer, "update  %6.2f ms", average.update);
+	gfx_draw_string(dpi, buffer, 21, x, y);
+	y += 10;
+	sprintf(buffer, "draw    %6.2f ms", average.draw);
+	gfx_draw_string(dpi, buffer, 21, x, y);
+	y += 10;
+	sprintf(buffer, "wait    %6.2f ms", _pacingWaitMs);
+	gfx_draw_string(dpi, buffer, 21, x, y);
+	y += 10;
+	sprintf(buffer, "drift   %6.2f ms", _pacingDriftMs);
+	gfx_draw_string(dpi, buffer, 21, x, y);
+	y += 10;
+	for (i = 0; i < GAME_LOGIC_PHASE_COUNT; i++) {
+		sprintf(buffer, " %-7s %6.2f ms", gGameLogicPhaseNames[i], average.phases[i]);
+		gfx_draw_string(dpi, buffer, 21, x, y);
+		y += 10;
+	}
+
+	// Tagged heap usage, current and peak kilobytes per subsystem
+	for (i = 0; i < MEMTRACK_TAG_COUNT; i++) {
+		uint32 currentBytes, peakBytes, blockCount;
+		memtrack_get_stats(i, &currentBytes, &peakBytes, &blockCount);
+		sprintf(buffer, "%-9s %6u / %6u KiB", memtrack_tag_name(i), currentBytes / 1024, peakBytes / 1024);
+		gfx_draw_string(dpi, buffer, 21, x, y);
+		y += 10;
+	}
+	y += 4;
+
+	// Rolling histogram of total frame times, oldest bar on the left,
+	// one pixel per millisecond with a line at the 25 ms frame budget
+	barHeight = 50;
+	gfx_fill_rect(dpi, x, y + barHeight - 25, x + PROFILER_HISTORY_SIZE * 2 - 1, y + barHeight - 25, 138);
+	for (i = 0; i < PROFILER_HISTORY_SIZE; i++) {
+		profiler_frame *frame = &_frameHistory[(_frameHistoryIndex + i) % PROFILER_HISTORY_SIZE];
+		frameMs = frame->update + frame->draw;
+		if (frameMs > barHeight)
+			frameMs = (float)barHeight;
+		gfx_fill_rect(dpi, x + i * 2, y + barHeight - (int)frameMs, x + i * 2 + 1, y + barHeight, frameMs >= 25 ? 171 : 144);
+	}
+}
+
+/**
+ * Dumps the rolling history to profile.csv in the user directory, oldest
+ * frame first. Returns 1 on success.
+ */
+int profiler_export_csv()
+{
+	char path[MAX_PATH];
+	FILE *file;
+	int i, j;
+
+	platform_get_user_directory(path, NULL);
+	strcat(path, "profile.csv");
+
+	file = fopen(path, "w");
+	if (file == NULL) {
+		log_error("Unable to write %s", path);
+		return 0;
+	}
+
+	fprintf(file, "frame,update_ms,draw_ms");
+	for (j = 0; j < GAME_LOGIC_PHASE_COUNT; j++)
+		fprintf(file, ",%s_ms", gGameLogicPhaseNames[j]);
+	fprintf(file, "\n");
+
+	for (i = 0; i < PROFILER_HISTORY_SIZE; i++) {
+		profiler_frame *frame = &_frameHistory[(_frameHistoryIndex + i) % PROFILER_HISTORY_SIZE];
+		fprintf(file, "%d,%.3f,%.3f", i, frame->update, frame->draw);
+		for (j = 0; j < GAME_LOGIC_PHASE_COUNT; j++)
+			fprintf(file, ",%.3f", frame->phases[j]);
+		fprintf(file, "\n");
+	}
+
+	fclose(file);
+	log_verbose("profiler history written to %s", path);
+
+	memtrack_export_csv();
+	return 1;
+}
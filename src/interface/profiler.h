@@ -0,0 +1,41 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _PROFILER_H_
+#define _PROFILER_H_
+
+#include "../common.h"
+
+// Number of frames kept in the rolling history and drawn in the histogram
+#define PROFILER_HISTORY_SIZE 96
+
+extern int gProfilerEnabled;
+extern int gProfilerExternalCollect;
+
+void profiler_frame_begin();
+void profiler_update_done();
+void profiler_frame_end();
+void profiler_pacing_report(uint64 waitCounts, sint64 driftCounts);
+void profiler_toggle();
+int profiler_get_history(float *updateMs, float *drawMs, float *phaseAverageMs);
+void profiler_draw();
+int profiler_export_csv();
+
+#endif
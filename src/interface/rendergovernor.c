@@ -0,0 +1,82 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <SDL.h>
+#include "../config.h"
+#include "rendergovernor.h"
+
+// Budget for the work portion of a 25ms logic frame; sustained frames above
+// it degrade quality a level, frames below the restore threshold bring it
+// back. The gap between the two provides hysteresis, and each change is held
+// for a few seconds so the level cannot flap during brief load spikes such
+// as fireworks.
+#define FRAME_BUDGET_MS		22.0f
+#define FRAME_RESTORE_MS	14.0f
+#define LEVEL_HOLD_TICKS	120
+
+int gRenderGovernorLevel = 0;
+
+static uint64 _frameStart;
+static float _frameAverageMs;
+static int _holdTicks;
+static double _msPerCount = 0;
+
+void render_governor_frame_begin()
+{
+	if (!gConfigGeneral.dynamic_render_quality) {
+		gRenderGovernorLevel = 0;
+		return;
+	}
+
+	_frameStart = SDL_GetPerformanceCounter();
+}
+
+/**
+ * Feeds the frame's work time (update, paint and present) into a smoothed
+ * average and moves the degradation level towards whatever keeps that
+ * average inside budget. Called once per logic frame from the main loop.
+ */
+void render_governor_frame_end()
+{
+	float frameMs;
+
+	if (!gConfigGeneral.dynamic_render_quality)
+		return;
+
+	if (_msPerCount == 0)
+		_msPerCount = 1000.0 / SDL_GetPerformanceFrequency();
+	frameMs = (float)((SDL_GetPerformanceCounter() - _frameStart) * _msPerCount);
+	_frameAverageMs += (frameMs - _frameAverageMs) * 0.1f;
+
+	if (_holdTicks > 0) {
+		_holdTicks--;
+		return;
+	}
+
+	if (_frameAverageMs > FRAME_BUDGET_MS && gRenderGovernorLevel < RENDER_GOVERNOR_MAX_LEVEL) {
+		gRenderGovernorLevel++;
+		_holdTicks = LEVEL_HOLD_TICKS;
+		log_verbose("render governor degraded to level %d (%.1fms frames)", gRenderGovernorLevel, _frameAverageMs);
+	} else if (_frameAverageMs < FRAME_RESTORE_MS && gRenderGovernorLevel > 0) {
+		gRenderGovernorLevel--;
+		_holdTicks = LEVEL_HOLD_TICKS;
+		log_verbose("render governor restored to level %d (%.1fms frames)", gRenderGovernorLevel, _frameAverageMs);
+	}
+}
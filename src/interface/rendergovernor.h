@@ -0,0 +1,38 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _RENDERGOVERNOR_H_
+#define _RENDERGOVERNOR_H_
+
+#include "../common.h"
+
+// Degradation ladder engaged as sustained frame time exceeds budget:
+//   0 - full quality
+//   1 - sprite level of detail thresholds pulled in one zoom level
+//   2 - heavy rain downgraded, world painted at half resolution
+//   3 - rain skipped, world painted at quarter resolution
+#define RENDER_GOVERNOR_MAX_LEVEL 3
+
+extern int gRenderGovernorLevel;
+
+void render_governor_frame_begin();
+void render_governor_frame_end();
+
+#endif
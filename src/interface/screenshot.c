@@ -8,12 +8,12 @@
  * it under the terms of the GNU General Public License as published by
  * the Free Software Foundation, either version 3 of the License, or
  * (at your option) any later version.
- 
+
  * This program is distributed in the hope that it will be useful,
  * but WITHOUT ANY WARRANTY; without even the implied warranty of
  * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
  * GNU General Public License for more details.
- 
+
  * You should have received a copy of the GNU General Public License
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
@@ -27,15 +27,40 @@
 #include "../localisation/localisation.h"
 #include "../platform/platform.h"
 #include "../windows/error.h"
+#include "../world/map.h"
 #include "screenshot.h"
+#include "viewport.h"
 
 static const char *_screenshot_format_extension[] = { ".bmp", ".png" };
 
-static int screenshot_dump_bmp();
-static int screenshot_dump_png();
+// A captured frame waiting to be encoded and written by the writer thread.
+// The framebuffer is copied row by row into a stride padded staging buffer so
+// the game can keep drawing while the encode runs.
+typedef struct {
+	uint8 *pixels;
+	int width, height, stride;
+	uint8 palette[256 * 4];
+	int format;
+	char path[MAX_PATH];
+} screenshot_job;
+
+#define SCREENSHOT_QUEUE_SIZE 4
+
+static screenshot_job *_queue[SCREENSHOT_QUEUE_SIZE];
+static int _queueNextIndex = 0;
+static int _queueCount = 0;
+
+static SDL_Thread *_writerThread = NULL;
+static SDL_mutex *_writerMutex = NULL;
+static SDL_cond *_writerWake = NULL;
+static bool _writerShuttingDown = false;
+
+static int screenshot_writer_entry(void *unused);
+static int screenshot_write_bmp(screenshot_job *job);
+static int screenshot_write_png(screenshot_job *job);
 
 /**
- * 
+ *
  *  rct2: 0x006E3AEC
  */
 void screenshot_check()
@@ -94,16 +119,145 @@ static int screenshot_get_next_path(char *path, int format)
 	return -1;
 }
 
+#pragma region Writer thread
+
+static void screenshot_writer_start()
+{
+	if (_writerMutex != NULL)
+		return;
+
+	_writerMutex = SDL_CreateMutex();
+	_writerWake = SDL_CreateCond();
+	_writerShuttingDown = false;
+	_writerThread = SDL_CreateThread(screenshot_writer_entry, "OpenRCT2 screenshot writer", NULL);
+}
+
+/**
+ * Flushes any queued screenshots and stops the writer thread. Queued captures
+ * are still written out, so nothing is lost on exit.
+ */
+void screenshot_writer_dispose()
+{
+	if (_writerMutex == NULL)
+		return;
+
+	SDL_LockMutex(_writerMutex);
+	_writerShuttingDown = true;
+	SDL_CondBroadcast(_writerWake);
+	SDL_UnlockMutex(_writerMutex);
+
+	SDL_WaitThread(_writerThread, NULL);
+	_writerThread = NULL;
+
+	SDL_DestroyCond(_writerWake);
+	SDL_DestroyMutex(_writerMutex);
+	_writerWake = NULL;
+	_writerMutex = NULL;
+}
+
+static int screenshot_writer_entry(void *unused)
+{
+	screenshot_job *job;
+
+	SDL_LockMutex(_writerMutex);
+	for (;;) {
+		while (!_writerShuttingDown && _queueCount == 0)
+			SDL_CondWait(_writerWake, _writerMutex);
+		if (_queueCount == 0)
+			break;
+
+		job = _queue[_queueNextIndex];
+		_queueNextIndex = (_queueNextIndex + 1) % SCREENSHOT_QUEUE_SIZE;
+		_queueCount--;
+
+		SDL_UnlockMutex(_writerMutex);
+		if (job->format == SCREENSHOT_FORMAT_BMP)
+			screenshot_write_bmp(job);
+		else
+			screenshot_write_png(job);
+		free(job->pixels);
+		free(job);
+		SDL_LockMutex(_writerMutex);
+	}
+	SDL_UnlockMutex(_writerMutex);
+	return 0;
+}
+
+static int screenshot_writer_push(screenshot_job *job)
+{
+	int tail;
+
+	screenshot_writer_start();
+
+	SDL_LockMutex(_writerMutex);
+	if (_queueCount == SCREENSHOT_QUEUE_SIZE) {
+		// The writer can not keep up; drop this capture rather than stall
+		// the simulation waiting for a slot.
+		SDL_UnlockMutex(_writerMutex);
+		log_error("Screenshot queue is full, dropping capture.");
+		return 0;
+	}
+	tail = (_queueNextIndex + _queueCount) % SCREENSHOT_QUEUE_SIZE;
+	_queue[tail] = job;
+	_queueCount++;
+	SDL_CondSignal(_writerWake);
+	SDL_UnlockMutex(_writerMutex);
+	return 1;
+}
+
+#pragma endregion
+
+/**
+ * Copies the framebuffer and palette into a staging job and hands it to the
+ * writer thread, so the encode and file write do not block the game.
+ */
 int screenshot_dump()
 {
-	switch (gConfigGeneral.screenshot_format) {
-	case SCREENSHOT_FORMAT_BMP:
-		return screenshot_dump_bmp();
-	case SCREENSHOT_FORMAT_PNG:
-		return screenshot_dump_png();
-	default:
+	rct_drawpixelinfo *dpi = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
+	screenshot_job *job;
+	uint8 *row;
+	int y, index, format;
+
+	format = gConfigGeneral.screenshot_format;
+	if (format != SCREENSHOT_FORMAT_BMP && format != SCREENSHOT_FORMAT_PNG)
+		return -1;
+
+	job = malloc(sizeof(screenshot_job));
+	if (job == NULL)
+		return -1;
+
+	// Get a free screenshot path
+	if ((index = screenshot_get_next_path(job->path, format)) == -1) {
+		free(job);
+		return -1;
+	}
+
+	job->format = format;
+	job->width = RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_WIDTH, uint16);
+	job->height = RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_HEIGHT, uint16);
+	job->stride = (job->width + 3) & ~3;
+	memcpy(job->palette, RCT2_ADDRESS(0x01424680, uint8), sizeof(job->palette));
+
+	job->pixels = malloc(job->stride * job->height);
+	if (job->pixels == NULL) {
+		free(job);
+		return -1;
+	}
+
+	// Copy the framebuffer rows into the stride padded staging buffer
+	memset(job->pixels, 0, job->stride * job->height);
+	for (y = 0; y < dpi->height; y++) {
+		row = dpi->bits + y * (dpi->width + dpi->pitch);
+		memcpy(job->pixels + y * job->stride, row, dpi->width);
+	}
+
+	if (!screenshot_writer_push(job)) {
+		free(job->pixels);
+		free(job);
 		return -1;
 	}
+
+	return index;
 }
 
 // Bitmap header structs, for cross platform purposes
@@ -130,111 +284,83 @@ typedef struct {
 } BitmapInfoHeader;
 
 /**
- * 
+ *
  *  rct2: 0x00683D20
  */
-int screenshot_dump_bmp()
+static int screenshot_write_bmp(screenshot_job *job)
 {
 	BitmapFileHeader header;
 	BitmapInfoHeader info;
 
-	int i, y, index, width, height, stride;
-	char *buffer, path[MAX_PATH], *row;
+	int i, y;
+	char buffer[246 * 4];
 	FILE *fp;
 	unsigned int bytesWritten;
 
-	// Get a free screenshot path
-	if ((index = screenshot_get_next_path(path, SCREENSHOT_FORMAT_BMP)) == -1)
-		return -1;
-
 	// Open binary file for writing
-	if ((fp = fopen(path, "wb")) == NULL){
-		return -1;
+	if ((fp = fopen(job->path, "wb")) == NULL){
+		return 0;
 	}
 
-	// Allocate buffer
-	buffer = malloc(0xFFFF);
-	if (buffer == NULL) {
-		//CloseHandle(hFile);
-		fclose(fp);
-		return -1;
-	}
-
-	// Get image size
-	width = RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_WIDTH, uint16);
-	height = RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_HEIGHT, uint16);
-	stride = (width + 3) & 0xFFFFFFFC;
-
 	// File header
 	memset(&header, 0, sizeof(header));
 	header.bfType = 0x4D42;
-	header.bfSize = height * stride + 1038;
+	header.bfSize = job->height * job->stride + 1038;
 	header.bfOffBits = 1038;
 
 	bytesWritten = fwrite(&header, sizeof(BitmapFileHeader), 1, fp);
 	if (bytesWritten != 1) {
 		fclose(fp);
-		free(buffer);
+		return 0;
 	}
 
 	// Info header
 	memset(&info, 0, sizeof(info));
 	info.biSize = sizeof(info);
-	info.biWidth = width;
-	info.biHeight = height;
+	info.biWidth = job->width;
+	info.biHeight = job->height;
 	info.biPlanes = 1;
 	info.biBitCount = 8;
 	info.biXPelsPerMeter = 2520;
 	info.biYPelsPerMeter = 2520;
 	info.biClrUsed = 246;
 
-	bytesWritten=fwrite(&info, sizeof(BitmapInfoHeader), 1, fp); 
+	bytesWritten = fwrite(&info, sizeof(BitmapInfoHeader), 1, fp);
 	if (bytesWritten != 1) {
 		fclose(fp);
-		free(buffer);
+		return 0;
 	}
 
 	// Palette
 	memset(buffer, 0, 246 * 4);
 	for (i = 0; i < 246; i++) {
-		buffer[i * 4 + 0] = RCT2_ADDRESS(0x01424680, uint8)[i * 4 + 0];
-		buffer[i * 4 + 1] = RCT2_ADDRESS(0x01424680, uint8)[i * 4 + 1];
-		buffer[i * 4 + 2] = RCT2_ADDRESS(0x01424680, uint8)[i * 4 + 2];
+		buffer[i * 4 + 0] = job->palette[i * 4 + 0];
+		buffer[i * 4 + 1] = job->palette[i * 4 + 1];
+		buffer[i * 4 + 2] = job->palette[i * 4 + 2];
 	}
 
-	bytesWritten = fwrite(buffer, sizeof(char), 246*4,  fp);
-	if (bytesWritten != 246*4){
+	bytesWritten = fwrite(buffer, sizeof(char), 246 * 4, fp);
+	if (bytesWritten != 246 * 4){
 		fclose(fp);
-		free(buffer);
+		return 0;
 	}
 
 	// Image, save upside down
-	rct_drawpixelinfo *dpi = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
-	for (y = dpi->height - 1; y >= 0; y--) {
-		row = dpi->bits + y * (dpi->width + dpi->pitch);
-
-		memset(buffer, 0, stride);
-		memcpy(buffer, row, dpi->width);
-
-		bytesWritten=fwrite(buffer, sizeof(char), stride, fp);
-		if (bytesWritten != stride){
+	for (y = job->height - 1; y >= 0; y--) {
+		bytesWritten = fwrite(job->pixels + y * job->stride, sizeof(char), job->stride, fp);
+		if (bytesWritten != job->stride){
 			fclose(fp);
-			free(buffer);
+			return 0;
 		}
 	}
 
 	fclose(fp);
-	free(buffer);
-
-	return index;
+	return 1;
 }
 
-int screenshot_dump_png()
+static int screenshot_write_png(screenshot_job *job)
 {
-	rct_drawpixelinfo *dpi = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
-
-	int i, index, width, height, stride;
-	char path[MAX_PATH] = "";
+	int i;
 	unsigned int error;
 	unsigned char r, g, b, a = 255;
 
@@ -242,35 +368,147 @@ int screenshot_dump_png()
 	size_t pngSize;
 	LodePNGState state;
 
-	// Get a free screenshot path
-	if ((index = screenshot_get_next_path(path, SCREENSHOT_FORMAT_PNG)) == -1)
-		return -1;
-
-
 	lodepng_state_init(&state);
 	state.info_raw.colortype = LCT_PALETTE;
 
-	// Get image size
-	width = RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_WIDTH, uint16);
-	height = RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_HEIGHT, uint16);
-	stride = (width + 3) & ~3;
-
 	for (i = 0; i < 256; i++) {
-		b = RCT2_ADDRESS(0x01424680, uint8)[i * 4 + 0];
-		g = RCT2_ADDRESS(0x01424680, uint8)[i * 4 + 1];
-		r = RCT2_ADDRESS(0x01424680, uint8)[i * 4 + 2];
+		b = job->palette[i * 4 + 0];
+		g = job->palette[i * 4 + 1];
+		r = job->palette[i * 4 + 2];
 
 		lodepng_palette_add(&state.info_raw, r, g, b, a);
 	}
 
-	error = lodepng_encode(&png, &pngSize, dpi->bits, stride, dpi->height, &state);
+	error = lodepng_encode(&png, &pngSize, job->pixels, job->stride, job->height, &state);
 	if (error) {
 		log_error("Unable to save screenshot, %u: %s", lodepng_error_text(error));
-		index = -1;
-	} else {
-		lodepng_save_file(png, pngSize, path);
+		free(png);
+		return 0;
 	}
 
+	lodepng_save_file(png, pngSize, job->path);
 	free(png);
+	return 1;
+}
+
+#define GIANT_SCREENSHOT_STRIP_HEIGHT 384
+
+/**
+ * Renders the entire map at the given zoom level into a BMP file, painting
+ * one horizontal strip at a time so the full multi-hundred-MB image is never
+ * held in memory. Each strip goes through viewport_paint, which dispatches
+ * its 32 pixel columns to the worker pool.
+ *
+ * The file is written as a top-down BMP (negative height), which is the only
+ * indexed format we can stream strip by strip; lodepng needs the whole image
+ * up front.
+ */
+int screenshot_giant(int zoom)
+{
+	rct_viewport viewport;
+	rct_drawpixelinfo dpi;
+	BitmapFileHeader header;
+	BitmapInfoHeader info;
+	char path[MAX_PATH], buffer[246 * 4];
+	uint8 *strip;
+	FILE *fp;
+	int i, index, mapSize, width, height, stride, centreX, centreY, z;
+	int top, rows, viewX, viewY;
+
+	if ((index = screenshot_get_next_path(path, SCREENSHOT_FORMAT_BMP)) == -1)
+		return -1;
+
+	// Image covers the full map plus a margin for tall scenery and rides
+	mapSize = RCT2_GLOBAL(RCT2_ADDRESS_MAP_SIZE, uint16);
+	width = ((mapSize * 64) >> zoom) + 8;
+	height = ((mapSize * 32) >> zoom) + 128;
+	stride = (width + 3) & ~3;
+
+	viewport.x = 0;
+	viewport.y = 0;
+	viewport.width = width;
+	viewport.height = height;
+	viewport.view_width = width << zoom;
+	viewport.view_height = height << zoom;
+	viewport.zoom = zoom;
+	viewport.var_11 = 0;
+	viewport.flags = 0;
+
+	// Centre the view on the middle of the map
+	centreX = (mapSize / 2) * 32 + 16;
+	centreY = (mapSize / 2) * 32 + 16;
+	z = map_element_height(centreX, centreY) & 0xFFFF;
+	center_2d_coordinates(centreX, centreY, z, &viewX, &viewY, &viewport);
+	viewport.view_x = viewX;
+	viewport.view_y = viewY;
+
+	strip = malloc(stride * GIANT_SCREENSHOT_STRIP_HEIGHT);
+	if (strip == NULL)
+		return -1;
+
+	if ((fp = fopen(path, "wb")) == NULL) {
+		free(strip);
+		return -1;
+	}
+
+	// File header
+	memset(&header, 0, sizeof(header));
+	header.bfType = 0x4D42;
+	header.bfSize = height * stride + 1038;
+	header.bfOffBits = 1038;
+	fwrite(&header, sizeof(BitmapFileHeader), 1, fp);
+
+	// Info header, negative height makes the rows top-down so they can be
+	// streamed in paint order
+	memset(&info, 0, sizeof(info));
+	info.biSize = sizeof(info);
+	info.biWidth = width;
+	info.biHeight = -height;
+	info.biPlanes = 1;
+	info.biBitCount = 8;
+	info.biXPelsPerMeter = 2520;
+	info.biYPelsPerMeter = 2520;
+	info.biClrUsed = 246;
+	fwrite(&info, sizeof(BitmapInfoHeader), 1, fp);
+
+	// Palette
+	memset(buffer, 0, 246 * 4);
+	for (i = 0; i < 246; i++) {
+		buffer[i * 4 + 0] = RCT2_ADDRESS(0x01424680, uint8)[i * 4 + 0];
+		buffer[i * 4 + 1] = RCT2_ADDRESS(0x01424680, uint8)[i * 4 + 1];
+		buffer[i * 4 + 2] = RCT2_ADDRESS(0x01424680, uint8)[i * 4 + 2];
+	}
+	fwrite(buffer, sizeof(char), 246 * 4, fp);
+
+	// Paint and write the image one strip at a time
+	for (top = 0; top < height; top += GIANT_SCREENSHOT_STRIP_HEIGHT) {
+		rows = min(GIANT_SCREENSHOT_STRIP_HEIGHT, height - top);
+
+		dpi.bits = strip;
+		dpi.x = 0;
+		dpi.y = top;
+		dpi.width = width;
+		dpi.height = rows;
+		dpi.pitch = stride - width;
+		dpi.zoom_level = 0;
+		memset(strip, 0, stride * rows);
+
+		viewport_paint(
+			&viewport, &dpi,
+			viewport.view_x,
+			viewport.view_y + (top << zoom),
+			viewport.view_x + viewport.view_width,
+			viewport.view_y + ((top + rows) << zoom)
+		);
+
+		if (fwrite(strip, sizeof(char), stride * rows, fp) != stride * rows) {
+			fclose(fp);
+			free(strip);
+			return -1;
+		}
+	}
+
+	fclose(fp);
+	free(strip);
 	return index;
-}
\ No newline at end of file
+}
@@ -23,5 +23,7 @@
 
 void screenshot_check();
 int screenshot_dump();
+int screenshot_giant(int zoom);
+void screenshot_writer_dispose();
 
 #endif
\ No newline at end of file
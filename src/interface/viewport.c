@@ -18,15 +18,20 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  *****************************************************************************/
 
+#include <SDL.h>
 #include "../addresses.h"
 #include "../config.h"
 #include "../drawing/drawing.h"
+#include "../util/workerpool.h"
 #include "../localisation/localisation.h"
 #include "../sprites.h"
 #include "../world/map.h"
+#include "../world/path_heat.h"
 #include "../world/sprite.h"
 #include "../world/banner.h"
 #include "../world/scenery.h"
+#include "paintheatmap.h"
+#include "rendergovernor.h"
 #include "viewport.h"
 #include "window.h"
 
@@ -85,6 +90,8 @@ void viewport_init_all()
 	int i, d;
 	rct_g1_element *g1_element;
 
+	viewport_interaction_cache_invalidate();
+
 	// Palette from sprites?
 	d = 0;
 	for (i = 4915; i < 4947; i++) {
@@ -305,6 +312,79 @@ void sub_689174(sint16* x, sint16* y, sint16 *z)
 //
 //}
 
+/**
+ * Pans a viewport by shifting its retained screen pixels and repainting only
+ * the edge strips the pan exposed. Works at every zoom level since the pan
+ * offsets arrive in screen pixels. Falls back to a full repaint when the
+ * retained pixels cannot be trusted: the pan moved further than the viewport
+ * size, another window overlaps it, or undrawn dirty blocks intersect it.
+ *
+ *  rct2: 0x006E7FF3
+ */
+void sub_6E7FF3(rct_window* w, rct_viewport* viewport, sint16 x_diff, sint16 y_diff)
+{
+	rct_drawpixelinfo *screenDPI = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
+	uint8 *src, *dst;
+	int left, top, right, bottom;
+	int blitLeft, blitTop, blitRight, blitBottom;
+	int y, width, stride;
+
+	left = viewport->x;
+	top = viewport->y;
+	right = viewport->x + viewport->width;
+	bottom = viewport->y + viewport->height;
+
+	if (
+		abs(x_diff) >= viewport->width ||
+		abs(y_diff) >= viewport->height ||
+		window_is_region_overlapped(w, left, top, right, bottom) ||
+		gfx_region_is_dirty(left, top, right, bottom)
+	) {
+		gfx_redraw_screen_rect(left, top, right, bottom);
+		return;
+	}
+
+	// Destination rectangle of the retained pixels; the source is the same
+	// rectangle offset back by the pan
+	blitLeft = left + max(0, x_diff);
+	blitRight = right + min(0, x_diff);
+	blitTop = top + max(0, y_diff);
+	blitBottom = bottom + min(0, y_diff);
+
+	width = blitRight - blitLeft;
+	stride = screenDPI->width + screenDPI->pitch;
+	if (y_diff <= 0) {
+		// Source rows are below their destination; copy top to bottom
+		src = screenDPI->bits + ((blitTop - y_diff) * stride) + (blitLeft - x_diff);
+		dst = screenDPI->bits + (blitTop * stride) + blitLeft;
+		for (y = blitTop; y < blitBottom; y++) {
+			memmove(dst, src, width);
+			src += stride;
+			dst += stride;
+		}
+	} else {
+		// Source rows are above their destination; copy bottom to top
+		src = screenDPI->bits + ((blitBottom - 1 - y_diff) * stride) + (blitLeft - x_diff);
+		dst = screenDPI->bits + ((blitBottom - 1) * stride) + blitLeft;
+		for (y = blitTop; y < blitBottom; y++) {
+			memmove(dst, src, width);
+			src -= stride;
+			dst -= stride;
+		}
+	}
+
+	// Repaint the exposed edge strips
+	if (x_diff > 0)
+		gfx_redraw_screen_rect(left, top, left + x_diff, bottom);
+	else if (x_diff < 0)
+		gfx_redraw_screen_rect(right + x_diff, top, right, bottom);
+
+	if (y_diff > 0)
+		gfx_redraw_screen_rect(left, top, right, top + y_diff);
+	else if (y_diff < 0)
+		gfx_redraw_screen_rect(left, bottom + y_diff, right, bottom);
+}
+
 void sub_6E7F34(rct_window* w, rct_viewport* viewport, sint16 x_diff, sint16 y_diff){
 	//RCT2_CALLPROC_X(0x6E7F34, 0, 0, 0, x_diff, (int)viewport, (int)w, y_diff);
 	rct_window* orignal_w = w;
@@ -338,7 +418,7 @@ void sub_6E7F34(rct_window* w, rct_viewport* viewport, sint16 x_diff, sint16 y_d
 	}
 
 	w = orignal_w;
-	RCT2_CALLPROC_X(0x6E7FF3, 0, 0, 0, x_diff, (int)viewport, (int)w, y_diff);
+	sub_6E7FF3(w, viewport, x_diff, y_diff);
 }
 
 void sub_6E7DE1(sint16 x, sint16 y, rct_window* w, rct_viewport* viewport){
@@ -559,6 +639,105 @@ void viewport_update_position(rct_window *window)
 	//RCT2_CALLPROC_X(0x6E7DE1, x, y, 0, 0, (int)window, (int)viewport, 0);
 }
 
+// View regions already painted during the current screen redraw. When
+// several viewport windows show overlapping map regions at the same zoom
+// and flags, later viewports copy the shared region from the earlier one's
+// screen pixels instead of repainting it. The list resets at the start of
+// each gfx_redraw_screen_rect, so every entry was painted from the same
+// game state as the viewport consulting it.
+#define VIEWPORT_SHARE_MAX_REGIONS 8
+
+typedef struct {
+	rct_viewport *viewport;
+	int viewLeft, viewTop, viewRight, viewBottom;
+} viewport_share_region;
+
+static viewport_share_region _viewportShareRegions[VIEWPORT_SHARE_MAX_REGIONS];
+static int _viewportShareRegionCount;
+
+void viewport_paint_share_reset()
+{
+	_viewportShareRegionCount = 0;
+}
+
+static void viewport_paint_share_record(rct_viewport *viewport, int left, int top, int right, int bottom)
+{
+	viewport_share_region *region;
+
+	if (_viewportShareRegionCount == VIEWPORT_SHARE_MAX_REGIONS)
+		return;
+
+	region = &_viewportShareRegions[_viewportShareRegionCount++];
+	region->viewport = viewport;
+	region->viewLeft = left;
+	region->viewTop = top;
+	region->viewRight = right;
+	region->viewBottom = bottom;
+}
+
+/**
+ * Attempts to satisfy a viewport paint by copying the pixels of a viewport
+ * already painted this redraw which covers the same view region at the same
+ * zoom and flags. The donor pixels must still belong to the donor on screen,
+ * so any window overlapping them disqualifies it. Returns nonzero when the
+ * region was copied.
+ */
+static int viewport_paint_from_donor(rct_viewport *viewport, int left, int top, int right, int bottom)
+{
+	rct_drawpixelinfo *screenDPI = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
+	viewport_share_region *region;
+	rct_viewport *donor;
+	rct_window *owner;
+	uint8 *src, *dst;
+	int i, y, srcX, srcY, dstX, dstY, width, height, stride, zoomMask;
+
+	for (i = 0; i < _viewportShareRegionCount; i++) {
+		region = &_viewportShareRegions[i];
+		donor = region->viewport;
+		if (donor == viewport)
+			continue;
+		if (donor->zoom != viewport->zoom || donor->flags != viewport->flags)
+			continue;
+		if (left < region->viewLeft || right > region->viewRight)
+			continue;
+		if (top < region->viewTop || bottom > region->viewBottom)
+			continue;
+
+		// Both view origins must land on the same sub-pixel phase, otherwise
+		// the region does not map to whole pixels in both viewports
+		zoomMask = (1 << viewport->zoom) - 1;
+		if ((donor->view_x ^ viewport->view_x) & zoomMask)
+			continue;
+		if ((donor->view_y ^ viewport->view_y) & zoomMask)
+			continue;
+
+		srcX = donor->x + ((left - donor->view_x) >> donor->zoom);
+		srcY = donor->y + ((top - donor->view_y) >> donor->zoom);
+		dstX = viewport->x + ((left - viewport->view_x) >> viewport->zoom);
+		dstY = viewport->y + ((top - viewport->view_y) >> viewport->zoom);
+		width = (right - left) >> viewport->zoom;
+		height = (bottom - top) >> viewport->zoom;
+
+		owner = window_get_viewport_owner(donor);
+		if (owner == NULL)
+			continue;
+		if (window_is_region_overlapped(owner, srcX, srcY, srcX + width, srcY + height))
+			continue;
+
+		stride = screenDPI->width + screenDPI->pitch;
+		src = screenDPI->bits + (srcY * stride) + srcX;
+		dst = screenDPI->bits + (dstY * stride) + dstX;
+		for (y = 0; y < height; y++) {
+			memcpy(dst, src, width);
+			src += stride;
+			dst += stride;
+		}
+		return 1;
+	}
+
+	return 0;
+}
+
 /**
  *
  *  rct2: 0x00685C02
@@ -569,6 +748,127 @@ void viewport_update_position(rct_window *window)
  *  edi: dpi
  *  ebp: bottom
  */
+// Internal render scale. The main world viewport can be painted at half or
+// quarter resolution into a scratch buffer by raising the zoom level, then
+// integer upscaled to the screen; the UI and all other viewports stay
+// native. The scratch pixel grid is anchored to view coordinates so pixels
+// moved by viewport scrolling keep matching freshly painted ones.
+static uint8 *_renderScaleBuffer = NULL;
+static int _renderScaleBufferSize = 0;
+
+/**
+ * Zoom level used for the level of detail checks; the render governor pulls
+ * the thresholds in by a level while it is degrading quality.
+ */
+static int viewport_lod_zoom(rct_drawpixelinfo *dpi)
+{
+	return dpi->zoom_level + (gRenderGovernorLevel >= 1 ? 1 : 0);
+}
+
+static int viewport_render_scale_shift(rct_viewport *viewport)
+{
+	int scale, shift;
+
+	scale = gConfigGeneral.render_scale;
+	// The render governor engages reduced resolution under sustained load
+	if (gRenderGovernorLevel >= 2)
+		scale = max(scale, gRenderGovernorLevel >= 3 ? 4 : 2);
+	if (scale <= 1)
+		return 0;
+	// Only the main world viewport; window viewports are small and the UI
+	// around them stays native
+	if (viewport != g_viewport_list)
+		return 0;
+
+	shift = scale >= 4 ? 2 : 1;
+	// The paint code cannot go beyond zoom level 3
+	if (viewport->zoom + shift > 3)
+		shift = 3 - viewport->zoom;
+	return shift;
+}
+
+/**
+ * Paints a view rect at reduced resolution by painting with the zoom level
+ * raised by scaleShift into a scratch buffer, then writing each scratch
+ * pixel out as a square block of screen pixels. The rect is in view
+ * coordinates, as for viewport_paint.
+ */
+static void viewport_paint_scaled(rct_viewport *viewport, rct_drawpixelinfo *dpi, int left, int top, int right, int bottom, int scaleShift)
+{
+	rct_viewport scaledViewport;
+	rct_drawpixelinfo scaledDpi;
+	int scaledZoom = viewport->zoom + scaleShift;
+	int viewMask = (1 << scaledZoom) - 1;
+	int scratchWidth, scratchHeight, size;
+	int vxAligned, vyAligned, cxOff, cyOff;
+	int dstLeft, dstTop, dstRight, dstBottom, dstPitch, dx, dy;
+
+	// Pad the view rect out to whole low resolution pixels so the upscaled
+	// blocks fully cover the requested area
+	left &= ~viewMask;
+	top &= ~viewMask;
+	right = (right + viewMask) & ~viewMask;
+	bottom = (bottom + viewMask) & ~viewMask;
+
+	scratchWidth = (viewport->width >> scaleShift) + 2;
+	scratchHeight = (viewport->height >> scaleShift) + 2;
+	size = scratchWidth * scratchHeight;
+	if (size > _renderScaleBufferSize) {
+		free(_renderScaleBuffer);
+		_renderScaleBuffer = malloc(size);
+		_renderScaleBufferSize = size;
+	}
+
+	scaledViewport = *viewport;
+	scaledViewport.x = 0;
+	scaledViewport.y = 0;
+	scaledViewport.zoom = scaledZoom;
+
+	scaledDpi.bits = (char*)_renderScaleBuffer;
+	scaledDpi.x = 0;
+	scaledDpi.y = 0;
+	scaledDpi.width = scratchWidth;
+	scaledDpi.height = scratchHeight;
+	scaledDpi.pitch = 0;
+	scaledDpi.zoom_level = 0;
+
+	viewport_paint(&scaledViewport, &scaledDpi, left, top, right, bottom);
+
+	// Both paint paths align against the view origin truncated to their own
+	// pixel size; the difference maps a screen pixel onto its scratch pixel
+	vxAligned = viewport->view_x & ~((1 << viewport->zoom) - 1);
+	vyAligned = viewport->view_y & ~((1 << viewport->zoom) - 1);
+	cxOff = (vxAligned - (viewport->view_x & ~viewMask)) >> viewport->zoom;
+	cyOff = (vyAligned - (viewport->view_y & ~viewMask)) >> viewport->zoom;
+
+	// Destination rect in screen coordinates, clipped to the dpi and the
+	// viewport
+	dstLeft = ((left - vxAligned) >> viewport->zoom) + viewport->x;
+	dstTop = ((top - vyAligned) >> viewport->zoom) + viewport->y;
+	dstRight = ((right - vxAligned) >> viewport->zoom) + viewport->x;
+	dstBottom = ((bottom - vyAligned) >> viewport->zoom) + viewport->y;
+	dstLeft = max(dstLeft, max(dpi->x, viewport->x));
+	dstTop = max(dstTop, max(dpi->y, viewport->y));
+	dstRight = min(dstRight, min(dpi->x + dpi->width, viewport->x + viewport->width));
+	dstBottom = min(dstBottom, min(dpi->y + dpi->height, viewport->y + viewport->height));
+
+	dstPitch = dpi->width + dpi->pitch;
+	for (dy = dstTop; dy < dstBottom; dy++) {
+		uint8 *srcRow = _renderScaleBuffer + ((dy - viewport->y + cyOff) >> scaleShift) * scratchWidth;
+		uint8 *dst = (uint8*)dpi->bits + (dy - dpi->y) * dstPitch + (dstLeft - dpi->x);
+
+		for (dx = dstLeft; dx < dstRight; ) {
+			int sx = (dx - viewport->x + cxOff) >> scaleShift;
+			int runEnd = (((sx + 1) << scaleShift) - cxOff) + viewport->x;
+			if (runEnd > dstRight)
+				runEnd = dstRight;
+			memset(dst, srcRow[sx], runEnd - dx);
+			dst += runEnd - dx;
+			dx = runEnd;
+		}
+	}
+}
+
 void viewport_render(rct_drawpixelinfo *dpi, rct_viewport *viewport, int left, int top, int right, int bottom)
 {
 	if (right <= viewport->x) return;
@@ -594,13 +894,32 @@ void viewport_render(rct_drawpixelinfo *dpi, rct_viewport *viewport, int left, i
 	bottom += viewport->view_y;
 
 	int height = bottom - top;
+
+	int scaleShift = viewport_render_scale_shift(viewport);
+	if (scaleShift != 0) {
+		// Scaled paints bypass the donor share: their screen pixels go
+		// through the upscaler rather than being painted in place, so they
+		// are not valid copy sources for native resolution viewports
+		while (height > 384) {
+			viewport_paint_scaled(viewport, dpi, left, top, right, top + 384, scaleShift);
+			top += 384;
+			height -= 384;
+		}
+		viewport_paint_scaled(viewport, dpi, left, top, right, bottom, scaleShift);
+		return;
+	}
+
 	if (height > 384){
 		//Paint
-		viewport_paint(viewport, dpi, left, top, right, top + 384);
+		if (!viewport_paint_from_donor(viewport, left, top, right, top + 384))
+			viewport_paint(viewport, dpi, left, top, right, top + 384);
+		viewport_paint_share_record(viewport, left, top, right, top + 384);
 		top += 384;
 	}
 	//Paint
-	viewport_paint(viewport, dpi, left, top, right, bottom);
+	if (!viewport_paint_from_donor(viewport, left, top, right, bottom))
+		viewport_paint(viewport, dpi, left, top, right, bottom);
+	viewport_paint_share_record(viewport, left, top, right, bottom);
 
 #ifdef DEBUG_SHOW_DIRTY_BOX
 	if (viewport != g_viewport_list){
@@ -633,12 +952,14 @@ void sub_0x68615B(int ebp){
  * Part of 0x688485
  */
 void paint_attached_ps(paint_struct* ps, paint_struct* attached_ps, rct_drawpixelinfo* dpi){
+	uint16 view_flags = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16);
+
 	for (; attached_ps; attached_ps = attached_ps->next_attached_ps){
 		sint16 x = attached_ps->attached_x + ps->x;
 		sint16 y = attached_ps->attached_y + ps->y;
 
 		int image_id = attached_ps->image_id;
-		if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & VIEWPORT_FLAG_SEETHROUGH_RIDES){
+		if (view_flags & VIEWPORT_FLAG_SEETHROUGH_RIDES){
 			if (ps->sprite_type == 3){
 				if (image_id & 0x40000000){
 					image_id &= 0x7FFFF;
@@ -647,7 +968,7 @@ void paint_attached_ps(paint_struct* ps, paint_struct* attached_ps, rct_drawpixe
 			}
 		}
 
-		if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & VIEWPORT_FLAG_SEETHROUGH_SCENERY){
+		if (view_flags & VIEWPORT_FLAG_SEETHROUGH_SCENERY){
 			if (ps->sprite_type == 5){
 				if (image_id & 0x40000000){
 					image_id &= 0x7FFFF;
@@ -671,6 +992,7 @@ void sub_688485(){
 	rct_drawpixelinfo* dpi = RCT2_GLOBAL(0x140E9A8, rct_drawpixelinfo*);
 	paint_struct* ps = RCT2_GLOBAL(0xEE7884, paint_struct*);
 	paint_struct* previous_ps = ps->var_24;
+	uint16 view_flags = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16);
 
 	for (ps = ps->var_24; ps;){
 		sint16 x = ps->x;
@@ -686,7 +1008,7 @@ void sub_688485(){
 			}
 		}
 		int image_id = ps->image_id;
-		if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & VIEWPORT_FLAG_SEETHROUGH_RIDES){
+		if (view_flags & VIEWPORT_FLAG_SEETHROUGH_RIDES){
 			if (ps->sprite_type == 3){
 				if (!(image_id & 0x40000000)){
 					image_id &= 0x7FFFF;
@@ -694,7 +1016,7 @@ void sub_688485(){
 				}
 			}
 		}
-		if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & VIEWPORT_FLAG_UNDERGROUND_INSIDE){
+		if (view_flags & VIEWPORT_FLAG_UNDERGROUND_INSIDE){
 			if (ps->sprite_type == 9){
 				if (!(image_id & 0x40000000)){
 					image_id &= 0x7FFFF;
@@ -702,7 +1024,7 @@ void sub_688485(){
 				}
 			}
 		}
-		if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & VIEWPORT_FLAG_SEETHROUGH_SCENERY){
+		if (view_flags & VIEWPORT_FLAG_SEETHROUGH_SCENERY){
 			if (ps->sprite_type == 10 || ps->sprite_type == 12 || ps->sprite_type == 9 || ps->sprite_type == 5){
 				if (!(image_id & 0x40000000)){
 					image_id &= 0x7FFFF;
@@ -710,6 +1032,17 @@ void sub_688485(){
 				}
 			}
 		}
+		if (view_flags & VIEWPORT_FLAG_PATH_HEAT){
+			if (ps->sprite_type == 6 && !(image_id & 0x40000000)){
+				// Tint path tiles by accumulated pathfinding cost; the glass
+				// recolour palettes start at 0x70
+				int heatColour = path_heat_tile_colour(ps->map_x >> 5, ps->map_y >> 5);
+				if (heatColour != -1){
+					image_id &= 0x7FFFF;
+					image_id |= 0x40000000 | ((0x70 + heatColour) << 19);
+				}
+			}
+		}
 
 		if (!(ps->var_1A & 1))
 			gfx_draw_sprite(dpi, image_id, x, y, ps->var_04);
@@ -841,15 +1174,35 @@ void sub_0x69E8B0(uint32 eax, uint32 ecx){
 	eax = (eax & 0x1FE0) << 3 | (ecx >> 5);
 	int sprite_idx = RCT2_ADDRESS(0xF1EF60, uint16)[eax];
 	if (sprite_idx == SPRITE_INDEX_NULL) return;
-	
+
+	sint16 dpi_left = dpi->x;
+	sint16 dpi_top = dpi->y;
+	sint16 dpi_right = dpi->x + dpi->width;
+	sint16 dpi_bottom = dpi->y + dpi->height;
+
 	for (rct_sprite* spr = &g_sprite_list[sprite_idx]; sprite_idx != SPRITE_INDEX_NULL; sprite_idx = spr->unknown.next_in_quadrant){
 		spr = &g_sprite_list[sprite_idx];
-		dpi = RCT2_GLOBAL(0x140E9A8, rct_drawpixelinfo*);
 
-		if (dpi->y + dpi->height <= spr->unknown.sprite_top) continue;
-		if (spr->unknown.sprite_bottom <= dpi->y)continue;
-		if (dpi->x + dpi->width <= spr->unknown.sprite_left)continue;
-		if (spr->unknown.sprite_right <= dpi->x)continue;
+		if (dpi_bottom <= spr->unknown.sprite_top) continue;
+		if (spr->unknown.sprite_bottom <= dpi_top)continue;
+		if (dpi_right <= spr->unknown.sprite_left)continue;
+		if (spr->unknown.sprite_right <= dpi_left)continue;
+
+		// Level of detail culling: sprite classes that are sub pixel at far
+		// zoom levels can be dropped a level before the engine stops painting
+		// sprites altogether. Defaults only drop litter; thresholds are
+		// configurable for overview heavy uses such as attract mode.
+		switch (spr->unknown.sprite_identifier){
+		case SPRITE_IDENTIFIER_PEEP:
+			if (viewport_lod_zoom(dpi) >= gConfigGeneral.sprite_lod_peep_zoom) continue;
+			break;
+		case SPRITE_IDENTIFIER_MISC:
+			if (viewport_lod_zoom(dpi) >= gConfigGeneral.sprite_lod_misc_zoom) continue;
+			break;
+		case SPRITE_IDENTIFIER_LITTER:
+			if (viewport_lod_zoom(dpi) >= gConfigGeneral.sprite_lod_litter_zoom) continue;
+			break;
+		}
 
 		int ebx = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_ROTATION, uint32);
 		RCT2_GLOBAL(0x9DE578, uint32) = (uint32)spr;
@@ -885,6 +1238,103 @@ void sub_0x69E8B0(uint32 eax, uint32 ecx){
 	//return;
 }
 
+// The scrolling sign bitmap cache at 0x9C3840 keys on the scroll offset,
+// so a sign that is actually scrolling misses every frame and the text was
+// re-rasterised from the format codes each time. Flatten each unique
+// formatted string once into a strip of pixel columns (one glyph bit mask
+// and one colour per column); per frame compositing then copies columns
+// from the strip into the sign bitmap at the scroll offset.
+#define SCROLLING_TEXT_STRIP_CACHE_SIZE 32
+#define SCROLLING_TEXT_STRIP_MAX_WIDTH 1024
+
+typedef struct {
+	rct_string_id string_id;
+	uint32 string_args_0;
+	uint32 string_args_1;
+	uint32 lru;
+	uint16 width;
+	uint8 columns[SCROLLING_TEXT_STRIP_MAX_WIDTH];
+	uint8 colours[SCROLLING_TEXT_STRIP_MAX_WIDTH];
+} scrolling_text_strip;
+
+static scrolling_text_strip _scrollingTextStrips[SCROLLING_TEXT_STRIP_CACHE_SIZE];
+static uint32 _scrollingTextStripTicks;
+
+/**
+ * Drops every cached strip. Called when the user string table changes, as
+ * strips key on the string id and format arguments, which both stay the
+ * same when a sign or banner is renamed into a reused string slot.
+ */
+void scrolling_text_invalidate()
+{
+	int i;
+
+	for (i = 0; i < SCROLLING_TEXT_STRIP_CACHE_SIZE; i++)
+		_scrollingTextStrips[i].lru = 0;
+	_scrollingTextStripTicks = 0;
+}
+
+static scrolling_text_strip *scrolling_text_strip_get(rct_string_id string_id)
+{
+	int i, offs, al, edi, charWidth;
+	uint8 colour, *ch, *glyph;
+	uint32 args0, args1;
+	scrolling_text_strip *strip, *oldest;
+
+	args0 = RCT2_GLOBAL(RCT2_ADDRESS_COMMON_FORMAT_ARGS, uint32_t);
+	args1 = RCT2_GLOBAL(0x13CE956, uint32_t);
+
+	_scrollingTextStripTicks++;
+	oldest = &_scrollingTextStrips[0];
+	for (i = 0; i < SCROLLING_TEXT_STRIP_CACHE_SIZE; i++) {
+		strip = &_scrollingTextStrips[i];
+		if (strip->lru < oldest->lru)
+			oldest = strip;
+		if (strip->lru != 0 && strip->string_id == string_id &&
+			strip->string_args_0 == args0 && strip->string_args_1 == args1
+		) {
+			strip->lru = _scrollingTextStripTicks;
+			return strip;
+		}
+	}
+
+	strip = oldest;
+	strip->string_id = string_id;
+	strip->string_args_0 = args0;
+	strip->string_args_1 = args1;
+	strip->lru = _scrollingTextStripTicks;
+	strip->width = 0;
+
+	format_string(RCT2_ADDRESS(RCT2_ADDRESS_COMMON_STRING_FORMAT_BUFFER, char), string_id, (void*)RCT2_ADDRESS_COMMON_FORMAT_ARGS);
+
+	al = RCT2_GLOBAL(0x13CE959, uint8_t);
+	edi = al & 0x7F;
+	offs = (al >= 0x80) ? 2 : 0;
+	colour = RCT2_ADDRESS(0x0141FC47, uint8_t)[offs + edi * 8];
+
+	for (ch = RCT2_ADDRESS(RCT2_ADDRESS_COMMON_STRING_FORMAT_BUFFER, uint8); *ch != 0; ch++) {
+		al = *ch;
+		if (al <= FORMAT_COLOUR_CODE_END && al >= FORMAT_COLOUR_CODE_START) {
+			colour = RCT2_ADDRESS(RCT2_GLOBAL(0x9FF048, uint32_t), uint8_t)[(al - FORMAT_COLOUR_CODE_START) * 4];
+			continue;
+		}
+		if (al < 0x20)
+			continue;
+
+		al -= 0x20;
+		charWidth = RCT2_ADDRESS(0x141EBA8, uint8_t)[al];
+		glyph = &(RCT2_ADDRESS(0xF4393C, uint8)[al * 8]);
+		for (i = 0; i < charWidth; i++) {
+			if (strip->width >= SCROLLING_TEXT_STRIP_MAX_WIDTH)
+				return strip;
+			strip->columns[strip->width] = glyph[i];
+			strip->colours[strip->width] = colour;
+			strip->width++;
+		}
+	}
+	return strip;
+}
+
 /*rct2: 0x006C42D9*/
 int sub_6C42D9(rct_string_id string_id, int scroll, int ebp)
 {
@@ -920,51 +1370,22 @@ int sub_6C42D9(rct_string_id string_id, int scroll, int ebp)
 	*((uint32_t*)(unknown_pointer + 0x0E)) = RCT2_GLOBAL(0x9D7A80, uint32_t);
 	unknown_pointer += 0x12;
 	memset(unknown_pointer, 0, 0x280 * 4);
-	format_string(RCT2_ADDRESS(RCT2_ADDRESS_COMMON_STRING_FORMAT_BUFFER, char), string_id, (void*)RCT2_ADDRESS_COMMON_FORMAT_ARGS);
-	int al = RCT2_GLOBAL(0x13CE959, uint8_t);
-	int edi = al & 0x7F;
-	int offs = 0;
-	if (al >= 0x80) offs = 2;
-	RCT2_GLOBAL(0x9D7A8C, uint8_t) = RCT2_ADDRESS(0x0141FC47, uint8_t)[offs + edi * 8];
+	scrolling_text_strip* strip = scrolling_text_strip_get(string_id);
 	int16_t* unk = RCT2_ADDRESS(0x992FB8, uint16_t*)[ebp];
-	uint8_t* format_result = RCT2_ADDRESS(RCT2_ADDRESS_COMMON_STRING_FORMAT_BUFFER, uint8_t);
-	while (true)
+	if (strip->width != 0)
 	{
-		al = *format_result;
-		format_result++;
-		if (al == 0)
-		{
-			format_result = RCT2_ADDRESS(RCT2_ADDRESS_COMMON_STRING_FORMAT_BUFFER, char);
-			continue;
-		}
-		if (al <= FORMAT_COLOUR_CODE_END && al >= FORMAT_COLOUR_CODE_START)
-		{
-			al -= FORMAT_COLOUR_CODE_START;
-			RCT2_GLOBAL(0x9D7A8C, uint8_t) = RCT2_ADDRESS(RCT2_GLOBAL(0x9FF048, uint32_t), uint8_t)[al * 4];
-			continue;
-		}
-		if (al < 0x20) continue;
-		al -= 0x20;
-		int edx = RCT2_ADDRESS(0x141EBA8, uint8_t)[al];
-		uint8_t* unk2 = &(RCT2_ADDRESS(0xF4393C, uint8)[al * 8]);
+		int col = scroll;
 		while (true)
 		{
-			if (scroll != 0)
-			{
-				scroll--;
-				unk2++;
-				edx--;
-				if (edx == 0) break;
-			}
-			else
+			int16_t eax = *unk;
+			if (eax == -1) break;
+			if (eax > -1)
 			{
-				int16_t eax = *unk;
-				if (eax == -1) return RCT2_GLOBAL(0x9D7A84, uint32_t) + 0x606;
-				if (eax > -1)
+				int ah = strip->columns[col % strip->width];
+				if (ah != 0)
 				{
 					uint8_t* dst = &unknown_pointer[eax];
-					int ah = *unk2;
-					int al = RCT2_GLOBAL(0x9D7A8C, uint8_t);
+					int al = strip->colours[col % strip->width];
 					while (true)
 					{
 						if (ah & 1) *dst = al;
@@ -973,13 +1394,12 @@ int sub_6C42D9(rct_string_id string_id, int scroll, int ebp)
 						if (ah == 0) break;
 					}
 				}
-				unk2++;
-				unk++;
-				edx--;
-				if (edx == 0)  break;
 			}
+			unk++;
+			col++;
 		}
 	}
+	return RCT2_GLOBAL(0x9D7A84, uint32_t) + 0x606;
 }
 
 /* rct2: 0x006B9CC4 */
@@ -1029,6 +1449,75 @@ void viewport_banner_paint_setup(uint32_t direction, int edx, rct_map_element* m
 		0x1500, sub_6C42D9(string_id, scroll, ebp), 0, edx + 22, 1, 1, 0);
 }
 
+// Deciding whether a tile can be culled from paint setup needs the tallest
+// element on the tile (or its water level), which used to be recomputed by
+// walking the tile's element chain for every tile in every column of every
+// frame. The height is a pure function of the tile contents, so it is cached
+// per tile and dropped when the tile is invalidated. Retaining whole painted
+// tiles is not possible yet; the per-element painters still run in the
+// original code against a shared scratch arena that is rebuilt each column.
+static uint8 _tilePaintCullHeight[256 * 256];
+
+// Lowest corner of each tile's surface, filled during the same walk as the
+// cull height. An element whose clearance stays at or below it is fully
+// buried: nothing below the lowest surface corner can be visible unless the
+// viewport shows the underground, so its paint setup can be skipped outright
+static uint8 _tilePaintSurfaceBase[256 * 256];
+
+static int viewport_tile_paint_cull_height(int tileIndex, rct_map_element *mapElement)
+{
+	rct_map_element *element;
+	int height, surfaceBase;
+
+	height = _tilePaintCullHeight[tileIndex];
+	if (height != 0)
+		return height;
+
+	element = mapElement;
+	height = element->clearance_height;
+	surfaceBase = 0;
+	if (map_element_get_type(element) == MAP_ELEMENT_TYPE_SURFACE)
+		surfaceBase = element->base_height;
+	while (!map_element_is_last_for_tile(element)) {
+		element++;
+		height = max(height, element->clearance_height);
+		if (map_element_get_type(element) == MAP_ELEMENT_TYPE_SURFACE)
+			surfaceBase = element->base_height;
+	}
+	if (map_element_get_type(element) == MAP_ELEMENT_TYPE_SURFACE &&
+		(element->properties.surface.terrain & MAP_ELEMENT_WATER_HEIGHT_MASK) != 0)
+	{
+		height = (element->properties.surface.terrain & MAP_ELEMENT_WATER_HEIGHT_MASK) << 1;
+	}
+
+	_tilePaintCullHeight[tileIndex] = height;
+	_tilePaintSurfaceBase[tileIndex] = surfaceBase;
+	return height;
+}
+
+/**
+ * Drops the cached paint cull height for the given tile. Called whenever the
+ * tile's contents change.
+ */
+void viewport_tile_paint_cache_invalidate(int x, int y)
+{
+	if (x < 0 || x >= 256 || y < 0 || y >= 256)
+		return;
+
+	_tilePaintCullHeight[(y * 256) + x] = 0;
+	_tilePaintSurfaceBase[(y * 256) + x] = 0;
+}
+
+/**
+ * Drops every cached paint cull height. Called when the map is initialised
+ * or its element layout is rebuilt wholesale (loading a park, compacting).
+ */
+void viewport_tile_paint_cache_reset()
+{
+	memset(_tilePaintCullHeight, 0, sizeof(_tilePaintCullHeight));
+	memset(_tilePaintSurfaceBase, 0, sizeof(_tilePaintSurfaceBase));
+}
+
 /*rct2: 0x0068B35F*/
 void sub_68B35F(int ax, int cx)
 {
@@ -1112,34 +1601,37 @@ void sub_68B35F(int ax, int cx)
 		int bx = dx + 52;
 		if (bx > dpi->y)
 		{
-			rct_map_element* element = map_element;//push map_element
-			bx = element->clearance_height;
-			if (!map_element_is_last_for_tile(element))
-			{
-				while (true)
-				{
-					element++;
-					bx = max(bx, element->clearance_height);
-					if (map_element_is_last_for_tile(element)) break;
-				}
-			}
-			if (map_element_get_type(element) == MAP_ELEMENT_TYPE_SURFACE &&
-				(element->properties.surface.terrain & MAP_ELEMENT_WATER_HEIGHT_MASK) != 0)
-			{
-				bx = (element->properties.surface.terrain & MAP_ELEMENT_WATER_HEIGHT_MASK) << 1;
-			}
+			bx = viewport_tile_paint_cull_height(esi / 4, map_element);
 			bx <<= 3;
 			dx -= bx;
 			dx -= 32;
-			element = map_element;//pop map_element
 			dx -= dpi->height;
 			if (dx < dpi->y)
 			{
 				RCT2_GLOBAL(0x9DE568, uint16_t) = ax;
 				RCT2_GLOBAL(0x9DE56C, uint16_t) = cx;
 				RCT2_GLOBAL(0x9DE57C, uint16_t) = 0;
+
+				// Without underground view, elements fully buried under the
+				// tile's surface are provably invisible at any rotation and
+				// can be skipped before any paint struct is allocated
+				int cullBase = 0;
+				if (!(RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16_t) & VIEWPORT_FLAG_UNDERGROUND_INSIDE))
+					cullBase = _tilePaintSurfaceBase[esi / 4];
+
 				while (true)
 				{
+					if (cullBase != 0 &&
+						map_element->clearance_height <= cullBase &&
+						map_element_get_type(map_element) != MAP_ELEMENT_TYPE_SURFACE &&
+						!(map_element->flags & 0x10)) // not a construction ghost
+					{
+						int buriedStop = map_element_is_last_for_tile(map_element);
+						map_element++;
+						if (buriedStop) break;
+						continue;
+					}
+
 					int direction = (map_element->type + RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_ROTATION, uint32_t)) & MAP_ELEMENT_DIRECTION_MASK;
 					dx = map_element->base_height * 8;
 					uint32_t dword_9DE574 = RCT2_GLOBAL(0x9DE574, uint32_t);
@@ -1157,6 +1649,13 @@ void sub_68B35F(int ax, int cx)
 						RCT2_CALLPROC_X(0x6C4794, 0, 0, direction, dx, (int)map_element, 0, 0);
 						break;
 					case MAP_ELEMENT_TYPE_SCENERY:
+						// Tiny scenery is sub pixel at far zoom; skippable
+						// below the configured level of detail threshold
+						if (viewport_lod_zoom(dpi) >= gConfigGeneral.sprite_lod_scenery_zoom) {
+							rct_scenery_entry *sceneryEntry = g_smallSceneryEntries[map_element->properties.scenery.type];
+							if (sceneryEntry->small_scenery.height <= 16)
+								break;
+						}
 						RCT2_CALLPROC_X(0x6DFF47, 0, 0, direction, dx, (int)map_element, 0, 0);
 						break;
 					case MAP_ELEMENT_TYPE_ENTRANCE:
@@ -1488,6 +1987,106 @@ void sub_688217()
 		sub_688217_helper(eax & 0xFFFF, 0);
 }
 
+/**
+ * Paints one 32 pixel wide column of a viewport. Extracted from the column
+ * loop in viewport_paint so columns can be dispatched as worker pool jobs.
+ */
+static void viewport_paint_column(rct_drawpixelinfo *dpi2, int x)
+{
+	int start_x = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_X, uint16);
+	int width_col = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_WIDTH, uint16);
+	uint8 *bits_pointer = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_BITS_PTR, uint8*);
+	int pitch = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_PITCH, uint16);
+	int zoom = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_ZOOM, uint16);
+	if (x >= start_x){
+		int left_pitch = x - start_x;
+		width_col -= left_pitch;
+		bits_pointer += left_pitch >> zoom;
+		pitch += left_pitch >> zoom;
+		start_x = x;
+	}
+
+	int paint_right = start_x + width_col;
+	if (paint_right >= x + 32){
+		int right_pitch = paint_right - x - 32;
+		paint_right -= right_pitch;
+		pitch += right_pitch >> zoom;
+	}
+	width_col = paint_right - start_x;
+	dpi2->x = start_x;
+	dpi2->width = width_col;
+	dpi2->bits = bits_pointer;
+	dpi2->pitch = pitch;
+
+	if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & 0x3001){
+		uint8 colour = 0x0A;
+		if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & 0x4000){
+			colour = 0;
+		}
+		gfx_clear(dpi2, colour);
+	}
+	RCT2_GLOBAL(0xEE7880, uint32) = 0xF1A4CC;
+	RCT2_GLOBAL(0x140E9A8, uint32) = (int)dpi2;
+	sub_0x68615B(0xEE788C); //Memory copy
+	sub_0x68B6C2();
+	//RCT2_CALLPROC_X(0x68B6C2, 0, 0, 0, 0, 0, 0, 0); //Big function call 4 rotation versions
+	sub_688217();
+	//RCT2_CALLPROC_X(0x688217, start_x, ebx, ecx, (int)bits_pointer, esi, (int)dpi2, ebp); //Move memory
+	sub_688485();
+	//RCT2_CALLPROC_EBPSAFE(0x688485); //Big function call
+
+	int weather_colour = RCT2_ADDRESS(0x98195C, uint32)[RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_GLOOM, uint8)];
+	if ((weather_colour != -1) && (!(RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & 0x4000)) && (!(RCT2_GLOBAL(0x9DEA6F, uint8) & 1))){
+		gfx_fill_rect(dpi2, dpi2->x, dpi2->y, dpi2->width + dpi2->x - 1, dpi2->height + dpi2->y - 1, weather_colour);
+	}
+	RCT2_CALLPROC_EBPSAFE(0x6860C3); //string related
+}
+
+typedef struct {
+	rct_drawpixelinfo *dpi;
+	int firstColumnX;
+
+	// Screen area the paint region covers, for the paint cost heatmap:
+	// screenX is where firstColumnX lands on screen and each column advances
+	// by (32 >> zoom) pixels from there
+	int screenX;
+	int screenY;
+	int screenHeight;
+	int zoom;
+} viewport_paint_column_args;
+
+static SDL_mutex *_viewportPaintMutex = NULL;
+
+static void viewport_paint_column_job(void *context, int index)
+{
+	viewport_paint_column_args *args = (viewport_paint_column_args*)context;
+	int columnX = args->firstColumnX + (index * 32);
+	uint64 paintStart = 0;
+
+	// The paint session (0x00EE7880) and the column dpi still live at fixed
+	// RCT2 addresses shared with the original code, so concurrent columns must
+	// be serialised for now. Once the paint session is native and re-entrant
+	// this lock can be removed and the columns will run truly in parallel.
+	SDL_LockMutex(_viewportPaintMutex);
+	if (gPaintHeatmapEnabled)
+		paintStart = SDL_GetPerformanceCounter();
+	viewport_paint_column(args->dpi, columnX);
+	if (gPaintHeatmapEnabled) {
+		// The arena pointer is still where paint struct generation left it,
+		// so the number of structs the column produced falls out of it
+		int paintStructs = (RCT2_GLOBAL(0x00EE7888, uint32) - 0xEE788C) / 0x34;
+		paint_heatmap_column_record(
+			args->screenX + (((columnX - args->firstColumnX)) >> args->zoom),
+			args->screenY,
+			32 >> args->zoom,
+			args->screenHeight,
+			SDL_GetPerformanceCounter() - paintStart,
+			paintStructs
+		);
+	}
+	SDL_UnlockMutex(_viewportPaintMutex);
+}
+
 /**
  *
  *  rct2:0x00685CBF
@@ -1538,60 +2137,22 @@ void viewport_paint(rct_viewport* viewport, rct_drawpixelinfo* dpi, int left, in
 	dpi2->height = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_HEIGHT, uint16);
 	dpi2->zoom_level = (uint8)RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_ZOOM, uint16);
 
-	//Splits the screen into 32 pixel columns and renders them.
-	for (x = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_X, uint16) & 0xFFFFFFE0;
-		x < RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_X, uint16) + RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_WIDTH, uint16);
-		x += 32){
-
-		int start_x = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_X, uint16);
-		int width_col = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_WIDTH, uint16);
-		bits_pointer = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_BITS_PTR, uint8*);
-		int pitch = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_PITCH, uint16);
-		int zoom = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_ZOOM, uint16);
-		if (x >= start_x){
-			int left_pitch = x - start_x;
-			width_col -= left_pitch;
-			bits_pointer += left_pitch >> zoom;
-			pitch += left_pitch >> zoom;
-			start_x = x;
-		}
+	//Splits the screen into 32 pixel columns and dispatches them to the worker
+	//pool so wide windows are not painted by a single core.
+	viewport_paint_column_args args;
+	args.dpi = dpi2;
+	args.firstColumnX = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_X, uint16) & 0xFFFFFFE0;
+	args.screenX = x - ((RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_X, uint16) - args.firstColumnX) >> viewport->zoom);
+	args.screenY = y;
+	args.screenHeight = height >> viewport->zoom;
+	args.zoom = viewport->zoom;
+	int paintEnd = RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_X, uint16) + RCT2_GLOBAL(RCT2_ADDRESS_VIEWPORT_PAINT_WIDTH, uint16);
+	int columnCount = (paintEnd - args.firstColumnX + 31) / 32;
 
-		int paint_right = start_x + width_col;
-		if (paint_right >= x + 32){
-			int right_pitch = paint_right - x - 32;
-			paint_right -= right_pitch;
-			pitch += right_pitch >> zoom;
-		}
-		width_col = paint_right - start_x;
-		dpi2->x = start_x;
-		dpi2->width = width_col;
-		dpi2->bits = bits_pointer;
-		dpi2->pitch = pitch;
-
-		if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & 0x3001){
-			uint8 colour = 0x0A;
-			if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & 0x4000){
-				colour = 0;
-			}
-			gfx_clear(dpi2, colour);
-		}
-		RCT2_GLOBAL(0xEE7880, uint32) = 0xF1A4CC;
-		RCT2_GLOBAL(0x140E9A8, uint32) = (int)dpi2;
-		int ebp = 0, ebx = 0, esi = 0, ecx = 0;
-		sub_0x68615B(0xEE788C); //Memory copy
-		sub_0x68B6C2();
-		//RCT2_CALLPROC_X(0x68B6C2, 0, 0, 0, 0, 0, 0, 0); //Big function call 4 rotation versions
-		sub_688217();
-		//RCT2_CALLPROC_X(0x688217, start_x, ebx, ecx, (int)bits_pointer, esi, (int)dpi2, ebp); //Move memory
-		sub_688485();
-		//RCT2_CALLPROC_EBPSAFE(0x688485); //Big function call
-
-		int weather_colour = RCT2_ADDRESS(0x98195C, uint32)[RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_GLOOM, uint8)];
-		if ((weather_colour != -1) && (!(RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_VIEWPORT_FLAGS, uint16) & 0x4000)) && (!(RCT2_GLOBAL(0x9DEA6F, uint8) & 1))){
-			gfx_fill_rect(dpi2, dpi2->x, dpi2->y, dpi2->width + dpi2->x - 1, dpi2->height + dpi2->y - 1, weather_colour);
-		}
-		RCT2_CALLPROC_EBPSAFE(0x6860C3); //string related
-	}
+	if (_viewportPaintMutex == NULL)
+		_viewportPaintMutex = SDL_CreateMutex();
+
+	worker_pool_run(viewport_paint_column_job, &args, columnCount);
 
 	//RCT2_CALLPROC_X(0x00685CBF, left, top, 0, right, (int)viewport, (int)dpi, bottom);
 }
@@ -1943,6 +2504,41 @@ void sub_68862C()
 	}
 }
 
+// Results of recent hit tests, so the hover and tooltip queries that fire on
+// every mouse movement do not repeat the interaction paint pass while the
+// cursor stays within the same 4x4 pixel block. The hit test visits single
+// pixels, so answers are cached at the queried pixel's block and a movement
+// to a neighbouring block simply misses and paints again. Entries are only
+// trusted for the tick they were taken in and are dropped explicitly when an
+// applied game command changes the world without the tick advancing.
+#define INTERACTION_CACHE_SIZE 16
+
+typedef struct {
+	uint32 generation;
+	uint32 tick;
+	rct_viewport *viewport;
+	sint16 view_x, view_y;
+	sint16 blockX, blockY;
+	uint16 flags;
+	uint8 zoom;
+	uint8 interactionType;
+	sint16 x, y;
+	rct_map_element *mapElement;
+} interaction_cache_entry;
+
+static interaction_cache_entry _interactionCache[INTERACTION_CACHE_SIZE];
+static int _interactionCacheNextSlot = 0;
+static uint32 _interactionCacheGeneration = 1;
+
+/**
+ * Drops all cached hit test results. Called whenever the world changes
+ * outside the normal tick advance (e.g. a game command applied while paused).
+ */
+void viewport_interaction_cache_invalidate()
+{
+	_interactionCacheGeneration++;
+}
+
 /**
  *
  *  rct2: 0x00685ADC
@@ -1957,6 +2553,11 @@ void sub_68862C()
  */
 void get_map_coordinates_from_pos(int screenX, int screenY, int flags, int *x, int *y, int *interactionType, rct_map_element **mapElement, rct_viewport **viewport)
 {
+	interaction_cache_entry *entry;
+	sint16 blockX = screenX >> 2;
+	sint16 blockY = screenY >> 2;
+	int i;
+
 	RCT2_GLOBAL(0x9AC154, uint16_t) = flags & 0xFFFF;
 	RCT2_GLOBAL(0x9AC148, uint8_t) = 0;
 	rct_window* window = window_find_from_point(screenX, screenY);
@@ -1969,6 +2570,29 @@ void get_map_coordinates_from_pos(int screenX, int screenY, int flags, int *x, i
 		screenY -= (int)myviewport->y;
 		if (screenX >= 0 && screenX < (int)myviewport->width && screenY >= 0 && screenY < (int)myviewport->height)
 		{
+			// Check for a cached answer from this tick. The viewport scroll
+			// position and zoom are part of the key so scrolling between
+			// ticks misses naturally.
+			for (i = 0; i < INTERACTION_CACHE_SIZE; i++) {
+				entry = &_interactionCache[i];
+				if (
+					entry->generation == _interactionCacheGeneration &&
+					entry->tick == RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) &&
+					entry->viewport == myviewport &&
+					entry->view_x == myviewport->view_x &&
+					entry->view_y == myviewport->view_y &&
+					entry->zoom == myviewport->zoom &&
+					entry->blockX == blockX &&
+					entry->blockY == blockY &&
+					entry->flags == (uint16)(flags & 0xFFFF)
+				) {
+					RCT2_GLOBAL(0x9AC148, uint8_t) = entry->interactionType;
+					RCT2_GLOBAL(0x9AC14C, int16_t) = entry->x;
+					RCT2_GLOBAL(0x9AC14E, int16_t) = entry->y;
+					RCT2_GLOBAL(0x9AC150, rct_map_element*) = entry->mapElement;
+					goto found;
+				}
+			}
 			screenX <<= myviewport->zoom;
 			screenY <<= myviewport->zoom;
 			screenX += (int)myviewport->view_x;
@@ -1990,7 +2614,25 @@ void get_map_coordinates_from_pos(int screenX, int screenY, int flags, int *x, i
 			sub_0x68B6C2();
 			sub_688217();
 			sub_68862C();
+
+			// Remember the answer for further queries in this block
+			entry = &_interactionCache[_interactionCacheNextSlot];
+			_interactionCacheNextSlot = (_interactionCacheNextSlot + 1) % INTERACTION_CACHE_SIZE;
+			entry->generation = _interactionCacheGeneration;
+			entry->tick = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
+			entry->viewport = myviewport;
+			entry->view_x = myviewport->view_x;
+			entry->view_y = myviewport->view_y;
+			entry->zoom = myviewport->zoom;
+			entry->blockX = blockX;
+			entry->blockY = blockY;
+			entry->flags = (uint16)(flags & 0xFFFF);
+			entry->interactionType = RCT2_GLOBAL(0x9AC148, uint8_t);
+			entry->x = RCT2_GLOBAL(0x9AC14C, int16_t);
+			entry->y = RCT2_GLOBAL(0x9AC14E, int16_t);
+			entry->mapElement = RCT2_GLOBAL(0x9AC150, rct_map_element*);
 		}
+	found:
 		if (viewport != NULL) *viewport = myviewport;
 	}
 	if (interactionType != NULL) *interactionType = RCT2_GLOBAL(0x9AC148, uint8_t);
@@ -41,7 +41,7 @@ enum {
 	VIEWPORT_FLAG_HIDE_BASE = (1 << 12),
 	VIEWPORT_FLAG_HIDE_VERTICAL = (1 << 13),
 	VIEWPORT_FLAG_INVISIBLE_SPRITES = (1 << 14),
-	VIEWPORT_FLAG_15 = (1 << 15)
+	VIEWPORT_FLAG_PATH_HEAT = (1 << 15)
 };
 
 enum {
@@ -97,9 +97,14 @@ void viewport_update_pointers();
 void viewport_update_position(rct_window *window);
 void viewport_render(rct_drawpixelinfo *dpi, rct_viewport *viewport, int left, int top, int right, int bottom);
 void viewport_paint(rct_viewport* viewport, rct_drawpixelinfo* dpi, int left, int top, int right, int bottom);
+void viewport_paint_share_reset();
+void viewport_tile_paint_cache_invalidate(int x, int y);
+void viewport_tile_paint_cache_reset();
 
 void sub_689174(sint16* x, sint16* y, sint16 *z);
 
+void scrolling_text_invalidate();
+
 rct_xy16 screen_coord_to_viewport_coord(rct_viewport *viewport, uint16 x, uint16 y);
 rct_xy16 viewport_coord_to_map_coord(int x, int y, int z);
 void sub_688972(int screenX, int screenY, sint16 *x, sint16 *y, rct_viewport **viewport);
@@ -114,6 +119,7 @@ void hide_construction_rights();
 void viewport_set_visibility(uint8 mode);
 
 void get_map_coordinates_from_pos(int screenX, int screenY, int flags, int *x, int *y, int *interactionType, rct_map_element **mapElement, rct_viewport **viewport);
+void viewport_interaction_cache_invalidate();
 
 int viewport_interaction_get_item_left(int x, int y, viewport_interaction_info *info);
 int viewport_interaction_left_over(int x, int y);
@@ -24,6 +24,7 @@
 #include "../drawing/drawing.h"
 #include "../input.h"
 #include "../platform/platform.h"
+#include "../util/memtrack.h"
 #include "../world/map.h"
 #include "../world/sprite.h"
 #include "widget.h"
@@ -62,6 +63,264 @@ float window_scroll_locations[][2] = {
 
 static void window_all_wheel_input();
 static int window_draw_split(rct_window *w, int left, int top, int right, int bottom);
+static bool window_class_is_absent(rct_windowclass cls);
+
+// Per class open window counts, see window_class_is_absent
+static uint8 _windowClassCounts[256];
+static int _windowClassCountsSeen = -1;
+
+// Pending invalidation rects for each window slot. Widget code invalidates
+// the same window many times per tick, so rather than pushing every rect
+// through gfx_set_dirty_blocks immediately they are coalesced per window and
+// flushed once in window_update_all before the dirty blocks are drawn. A few
+// separate rects are kept per window so two dirty widgets at opposite ends
+// of a window do not dirty everything between them; a new rect merges into
+// any rect it touches, and when the slots run out everything collapses into
+// a single union. The rects are in screen coordinates, so they stay valid if
+// the window moves or closes before the flush.
+#define WINDOW_INVALIDATION_MAX_RECTS 4
+
+typedef struct {
+	sint16 left, top, right, bottom;
+} window_invalidation_rect;
+
+typedef struct {
+	int count;
+	window_invalidation_rect rects[WINDOW_INVALIDATION_MAX_RECTS];
+} window_invalidation;
+
+static window_invalidation _windowInvalidations[MAX_NUMBER_WINDOWS];
+
+static void window_invalidation_queue(rct_window *w, sint16 left, sint16 top, sint16 right, sint16 bottom)
+{
+	window_invalidation *invalidation = &_windowInvalidations[w - g_window_list];
+	window_invalidation_rect *rect;
+	int i;
+
+	// Merge into a pending rect this one overlaps or touches
+	for (i = 0; i < invalidation->count; i++) {
+		rect = &invalidation->rects[i];
+		if (left > rect->right || right < rect->left)
+			continue;
+		if (top > rect->bottom || bottom < rect->top)
+			continue;
+
+		rect->left = min(rect->left, left);
+		rect->top = min(rect->top, top);
+		rect->right = max(rect->right, right);
+		rect->bottom = max(rect->bottom, bottom);
+		return;
+	}
+
+	if (invalidation->count < WINDOW_INVALIDATION_MAX_RECTS) {
+		rect = &invalidation->rects[invalidation->count++];
+		rect->left = left;
+		rect->top = top;
+		rect->right = right;
+		rect->bottom = bottom;
+		return;
+	}
+
+	// Out of slots; collapse everything into a single union
+	rect = &invalidation->rects[0];
+	for (i = 1; i < invalidation->count; i++) {
+		rect->left = min(rect->left, invalidation->rects[i].left);
+		rect->top = min(rect->top, invalidation->rects[i].top);
+		rect->right = max(rect->right, invalidation->rects[i].right);
+		rect->bottom = max(rect->bottom, invalidation->rects[i].bottom);
+	}
+	rect->left = min(rect->left, left);
+	rect->top = min(rect->top, top);
+	rect->right = max(rect->right, right);
+	rect->bottom = max(rect->bottom, bottom);
+	invalidation->count = 1;
+}
+
+/**
+ * Pushes all pending invalidation rects through gfx_set_dirty_blocks. Besides
+ * the per frame flush this must also run before windows are shuffled between
+ * slots, so that a pending rect is never attributed to a different window.
+ */
+static void window_invalidation_flush_all()
+{
+	int i, j;
+
+	for (i = 0; i < MAX_NUMBER_WINDOWS; i++) {
+		window_invalidation *invalidation = &_windowInvalidations[i];
+
+		for (j = 0; j < invalidation->count; j++) {
+			window_invalidation_rect *rect = &invalidation->rects[j];
+			gfx_set_dirty_blocks(rect->left, rect->top, rect->right, rect->bottom);
+		}
+		invalidation->count = 0;
+	}
+}
+
+// Rendered widget chrome for each window slot. Frames, image buttons, group
+// boxes and the close box depend only on the widget definitions, the window
+// colours and the input focus, yet are re-rasterized on every invalidation -
+// for the larger windows that is dozens of fill and sprite calls whenever a
+// single stat label ticks. Each slot keeps the chrome rendered into a window
+// sized bitmap together with a hash of everything that fed the pixels;
+// window_draw_widgets blits the bitmap and only draws the remaining
+// (dynamic) widgets on top. The pixels do not depend on the window position,
+// so moving a window keeps its backing, and because every input is part of
+// the key there is no invalidation call to forget.
+typedef struct {
+	uint32 key;
+	sint16 width, height;
+	uint8 *bits;
+} window_chrome_store;
+
+static window_chrome_store _windowChromeStores[MAX_NUMBER_WINDOWS];
+
+static bool window_chrome_widget_is_static(rct_widget *widget)
+{
+	switch (widget->type) {
+	case WWT_FRAME:
+	case WWT_RESIZE:
+	case WWT_IMGBTN:
+	case WWT_4:
+	case WWT_FLATBTN:
+	case WWT_GROUPBOX:
+	case WWT_CLOSEBOX:
+		return true;
+	default:
+		// Everything else renders formatted text, animates (tabs and colour
+		// buttons) or paints caller supplied content (scrolls, viewports),
+		// so it cannot be keyed on the widget bytes alone
+		return false;
+	}
+}
+
+static uint32 window_chrome_hash_bytes(uint32 hash, const void *data, int size)
+{
+	const uint8 *bytes = data;
+	int i;
+
+	for (i = 0; i < size; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+static uint32 window_chrome_hash(rct_window *w)
+{
+	uint32 hash = 2166136261U;
+	rct_widget *widget;
+	sint32 toolWidget, downWidget, hoverWidget;
+	int inputState;
+
+	hash = window_chrome_hash_bytes(hash, &w->flags, sizeof(w->flags));
+	hash = window_chrome_hash_bytes(hash, w->colours, sizeof(w->colours));
+	hash = window_chrome_hash_bytes(hash, &w->disabled_widgets, sizeof(w->disabled_widgets));
+	hash = window_chrome_hash_bytes(hash, &w->pressed_widgets, sizeof(w->pressed_widgets));
+	hash = window_chrome_hash_bytes(hash, &w->width, sizeof(w->width));
+	hash = window_chrome_hash_bytes(hash, &w->height, sizeof(w->height));
+	hash = window_chrome_hash_bytes(hash, &w->min_width, sizeof(w->min_width) * 4);
+	for (widget = w->widgets; widget->type != WWT_LAST; widget++)
+		hash = window_chrome_hash_bytes(hash, widget, sizeof(rct_widget));
+
+	// Pressed, hovered and active tool appearance comes from the input
+	// globals rather than the window; fold them in as the affected widget
+	// index so unrelated input changes do not churn the backing
+	toolWidget = -1;
+	if ((RCT2_GLOBAL(RCT2_ADDRESS_INPUT_FLAGS, uint32) & INPUT_FLAG_TOOL_ACTIVE)
+		&& RCT2_GLOBAL(RCT2_ADDRESS_TOOL_WINDOWCLASS, rct_windowclass) == w->classification
+		&& RCT2_GLOBAL(RCT2_ADDRESS_TOOL_WINDOWNUMBER, rct_windownumber) == w->number
+	)
+		toolWidget = RCT2_GLOBAL(RCT2_ADDRESS_TOOL_WIDGETINDEX, sint32);
+
+	downWidget = -1;
+	inputState = RCT2_GLOBAL(RCT2_ADDRESS_INPUT_STATE, uint8);
+	if ((inputState == INPUT_STATE_WIDGET_PRESSED || inputState == INPUT_STATE_DROPDOWN_ACTIVE)
+		&& (RCT2_GLOBAL(RCT2_ADDRESS_INPUT_FLAGS, uint32) & INPUT_FLAG_WIDGET_PRESSED)
+		&& RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_DOWN_WINDOWCLASS, rct_windowclass) == w->classification
+		&& RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_DOWN_WINDOWNUMBER, rct_windownumber) == w->number
+	)
+		downWidget = RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_DOWN_WIDGETINDEX, sint32);
+
+	hoverWidget = -1;
+	if (RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_OVER_WINDOWCLASS, rct_windowclass) == w->classification
+		&& RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_OVER_WINDOWNUMBER, rct_windownumber) == w->number
+	)
+		hoverWidget = RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_OVER_WIDGETINDEX, sint32);
+
+	hash = window_chrome_hash_bytes(hash, &toolWidget, sizeof(toolWidget));
+	hash = window_chrome_hash_bytes(hash, &downWidget, sizeof(downWidget));
+	hash = window_chrome_hash_bytes(hash, &hoverWidget, sizeof(hoverWidget));
+	return hash;
+}
+
+/**
+ * Blits the retained chrome bitmap for w into dpi, re-rasterizing it first if
+ * anything that feeds the chrome pixels changed. Returns false if the window
+ * cannot use a backing, in which case the caller draws every widget live.
+ */
+static bool window_chrome_composite(rct_window *w, rct_drawpixelinfo *dpi)
+{
+	window_chrome_store *store = &_windowChromeStores[w - g_window_list];
+	rct_drawpixelinfo backingDpi;
+	rct_widget *widget;
+	uint32 key;
+	int widgetIndex, left, top, right, bottom, y;
+	uint8 *src, *dst;
+
+	// The backing covers the full window, so the first widget must be a
+	// frame filling it or unrendered pixels would show through
+	if (w->flags & WF_TRANSPARENT)
+		return false;
+	widget = w->widgets;
+	if (widget->type != WWT_FRAME || widget->left != 0 || widget->top != 0)
+		return false;
+	if (widget->right != w->width - 1 || widget->bottom != w->height - 1)
+		return false;
+
+	key = window_chrome_hash(w);
+	if (store->bits == NULL || store->key != key || store->width != w->width || store->height != w->height) {
+		if (store->bits == NULL || store->width != w->width || store->height != w->height) {
+			memtrack_free(store->bits);
+			store->bits = memtrack_alloc(MEMTRACK_TAG_WINDOWS, w->width * w->height);
+		}
+
+		backingDpi.bits = store->bits;
+		backingDpi.x = w->x;
+		backingDpi.y = w->y;
+		backingDpi.width = w->width;
+		backingDpi.height = w->height;
+		backingDpi.pitch = 0;
+		backingDpi.zoom_level = 0;
+
+		widgetIndex = 0;
+		for (widget = w->widgets; widget->type != WWT_LAST; widget++) {
+			if (window_chrome_widget_is_static(widget))
+				widget_draw(&backingDpi, w, widgetIndex);
+			widgetIndex++;
+		}
+
+		store->key = key;
+		store->width = w->width;
+		store->height = w->height;
+	}
+
+	// Blit the rows of the backing that fall inside the draw region
+	left = max(w->x, dpi->x);
+	top = max(w->y, dpi->y);
+	right = min(w->x + w->width, dpi->x + dpi->width);
+	bottom = min(w->y + w->height, dpi->y + dpi->height);
+	if (left >= right || top >= bottom)
+		return true;
+
+	src = store->bits + ((top - w->y) * store->width) + (left - w->x);
+	dst = dpi->bits + ((top - dpi->y) * (dpi->width + dpi->pitch)) + (left - dpi->x);
+	for (y = top; y < bottom; y++) {
+		memcpy(dst, src, right - left);
+		src += store->width;
+		dst += dpi->width + dpi->pitch;
+	}
+	return true;
+}
 
 int window_get_widget_index(rct_window *w, rct_widget *widget)
 {
@@ -129,18 +388,50 @@ rct_widget *window_get_scroll_widget(rct_window *w, int scrollIndex)
 	return NULL;
 }
 
+/**
+ * Update events are dispatched to every open window 40 times a second, but
+ * several window classes do nothing at all in their update handler. Declare
+ * a reduced dispatch interval (in update ticks) for those classes so the
+ * per-frame event cost stops scaling with how many of them are open.
+ * Classes that animate from their update handler must stay at every tick,
+ * otherwise their animations slow down.
+ */
+static int window_class_update_interval(rct_windowclass cls)
+{
+	switch (cls) {
+	case WC_ABOUT:
+	case WC_PUBLISHER_CREDITS:
+	case WC_MUSIC_CREDITS:
+	case WC_SAVE_PROMPT:
+	case WC_DEMOLISH_RIDE_PROMPT:
+	case WC_KEYBOARD_SHORTCUT_LIST:
+	case WC_CHANGE_KEYBOARD_SHORTCUT:
+	case WC_TITLE_EXIT:
+		return 8;
+	default:
+		return 1;
+	}
+}
+
 /**
  * 
  *  rct2: 0x006ED7B0
  */
 void window_dispatch_update_all()
 {
+	int tick, interval;
 	rct_window *w;
 
 	RCT2_GLOBAL(0x01423604, sint32)++;
 	RCT2_GLOBAL(RCT2_ADDRESS_TOOLTIP_NOT_SHOWN_TICKS, sint16)++;
-	for (w = RCT2_LAST_WINDOW; w >= g_window_list; w--)
+	tick = RCT2_GLOBAL(0x01423604, sint32);
+	for (w = RCT2_LAST_WINDOW; w >= g_window_list; w--) {
+		interval = window_class_update_interval(w->classification);
+		if (interval > 1 && ((tick + w->number) % interval) != 0)
+			continue;
+
 		window_event_update_call(w);
+	}
 
 	RCT2_CALLPROC_EBPSAFE(0x006EE411);	// handle_text_input
 }
@@ -160,6 +451,7 @@ void window_update_all()
 	if (RCT2_GLOBAL(0x009ABDF2, sint8) == 0)
 		return;
 
+	window_invalidation_flush_all();
 	gfx_draw_all_dirty_blocks();
 
 	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++)
@@ -372,8 +664,10 @@ rct_window *window_create(int x, int y, int width, int height, uint32 *event_han
 	}
 
 	// Move w to new window slot
-	if (w != RCT2_NEW_WINDOW)
+	if (w != RCT2_NEW_WINDOW) {
+		window_invalidation_flush_all();
 		*RCT2_NEW_WINDOW = *w;
+	}
 
 	// Setup window
 	w->classification = cls;
@@ -412,6 +706,8 @@ rct_window *window_create(int x, int y, int width, int height, uint32 *event_han
 	w->var_4AE = 0;
 	RCT2_NEW_WINDOW++;
 
+	_windowClassCountsSeen = -1;
+
 	window_invalidate(w);
 	return w;
 }
@@ -481,11 +777,14 @@ void window_close(rct_window* window)
 	window_invalidate(window);
 
 	// Remove window from list and reshift all windows
+	window_invalidation_flush_all();
 	RCT2_NEW_WINDOW--;
 	num_windows = (RCT2_NEW_WINDOW - window);
 	if (num_windows > 0)
 		memmove(window, window + 1, num_windows * sizeof(rct_window));
 
+	_windowClassCountsSeen = -1;
+
 	viewport_update_pointers();
 }
 
@@ -498,6 +797,9 @@ void window_close_by_class(rct_windowclass cls)
 {
 	rct_window *w;
 
+	if (window_class_is_absent(cls))
+		return;
+
 	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++) {
 		if (w->classification == cls) {
 			window_close(w);
@@ -515,7 +817,10 @@ void window_close_by_class(rct_windowclass cls)
 void window_close_by_number(rct_windowclass cls, rct_windownumber number)
 {
 	rct_window* w;
-	
+
+	if (window_class_is_absent(cls))
+		return;
+
 	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++) {
 		if (w->classification == cls && w->number == number) {
 			window_close(w);
@@ -524,6 +829,31 @@ void window_close_by_number(rct_windowclass cls, rct_windownumber number)
 	}
 }
 
+static void window_class_counts_rebuild()
+{
+	rct_window *w;
+
+	memset(_windowClassCounts, 0, sizeof(_windowClassCounts));
+	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++)
+		_windowClassCounts[w->classification]++;
+	_windowClassCountsSeen = (int)(RCT2_NEW_WINDOW - g_window_list);
+}
+
+/**
+ * Returns whether no window of the given class is open, so the by class and
+ * by number searches can skip scanning the window list entirely. They are
+ * called constantly for classes that are rarely open, e.g. every peep state
+ * change looks for that peep's window. Original code paths can create and
+ * close windows too, so the counts are rebuilt whenever the window count
+ * differs from the last rebuild, and native create/close force a rebuild.
+ */
+static bool window_class_is_absent(rct_windowclass cls)
+{
+	if (_windowClassCountsSeen != (int)(RCT2_NEW_WINDOW - g_window_list))
+		window_class_counts_rebuild();
+	return _windowClassCounts[cls] == 0;
+}
+
 /**
  * Finds the first window with the specified window class.
  *  rct2: 0x006EA8A0
@@ -534,6 +864,9 @@ rct_window *window_find_by_class(rct_windowclass cls)
 {
 	rct_window *w;
 
+	if (window_class_is_absent(cls))
+		return NULL;
+
 	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++)
 		if (w->classification == cls)
 			return w;
@@ -551,7 +884,10 @@ rct_window *window_find_by_class(rct_windowclass cls)
 rct_window *window_find_by_number(rct_windowclass cls, rct_windownumber number)
 {
 	rct_window *w;
-	
+
+	if (window_class_is_absent(cls))
+		return NULL;
+
 	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++)
 		if (w->classification == cls && w->number == number)
 			return w;
@@ -682,7 +1018,7 @@ int window_find_widget_from_point(rct_window *w, int x, int y)
 void window_invalidate(rct_window *window)
 {
 	if (window != NULL)
-		gfx_set_dirty_blocks(window->x, window->y, window->x + window->width, window->y + window->height);
+		window_invalidation_queue(window, window->x, window->y, window->x + window->width, window->y + window->height);
 }
 
 /**
@@ -694,6 +1030,9 @@ void window_invalidate_by_class(rct_windowclass cls)
 {
 	rct_window* w;
 
+	if (window_class_is_absent(cls))
+		return;
+
 	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++)
 		if (w->classification == cls)
 			window_invalidate(w);
@@ -710,6 +1049,9 @@ void window_invalidate_by_number(rct_windowclass cls, rct_windownumber number)
 {
 	rct_window* w;
 
+	if (window_class_is_absent(cls))
+		return;
+
 	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++)
 		if (w->classification == cls && w->number == number)
 			window_invalidate(w);
@@ -727,7 +1069,7 @@ void widget_invalidate(rct_window *w, int widgetIndex)
 	if (widget->left == -2)
 		return;
 
-	gfx_set_dirty_blocks(w->x + widget->left, w->y + widget->top, w->x + widget->right + 1, w->y + widget->bottom + 1);
+	window_invalidation_queue(w, w->x + widget->left, w->y + widget->top, w->x + widget->right + 1, w->y + widget->bottom + 1);
 }
 
 /**
@@ -736,7 +1078,10 @@ void widget_invalidate(rct_window *w, int widgetIndex)
 void widget_invalidate_by_class(rct_windowclass cls, int widgetIndex)
 {
 	rct_window* w;
-	
+
+	if (window_class_is_absent(cls))
+		return;
+
 	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++)
 		if (w->classification == cls)
 			widget_invalidate(w, widgetIndex);
@@ -752,7 +1097,10 @@ void widget_invalidate_by_class(rct_windowclass cls, int widgetIndex)
 void widget_invalidate_by_number(rct_windowclass cls, rct_windownumber number, int widgetIndex)
 {
 	rct_window* w;
-	
+
+	if (window_class_is_absent(cls))
+		return;
+
 	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++)
 		if (w->classification == cls && w->number == number)
 			widget_invalidate(w, widgetIndex);
@@ -882,6 +1230,7 @@ rct_window *window_bring_to_front(rct_window *w)
 			break;
 
 		if (v >= g_window_list && w != v) {
+		window_invalidation_flush_all();
 		do {
 			t = *w;
 			*w = *(w + 1);
@@ -1027,6 +1376,20 @@ rct_window *window_get_main()
 	return NULL;
 }
 
+/**
+ * Returns the window that owns the given viewport, or NULL if there is none.
+ */
+rct_window *window_get_viewport_owner(rct_viewport *viewport)
+{
+	rct_window* w;
+
+	for (w = g_window_list; w < RCT2_NEW_WINDOW; w++)
+		if (w->viewport == viewport)
+			return w;
+
+	return NULL;
+}
+
 /**
  * Based on 
  * rct2: 0x696ee9 & 0x66842F & 0x006AF3B3
@@ -1404,7 +1767,72 @@ static int window_draw_split(rct_window *w, int left, int top, int right, int bo
 }
 
 /**
- * 
+ * Returns nonzero if the given screen region is entirely covered by opaque
+ * windows above w in the z-order. Mirrors the region splitting that
+ * window_draw_split performs when deciding what actually needs painting.
+ */
+int window_is_region_occluded(rct_window *w, int left, int top, int right, int bottom)
+{
+	rct_window* topwindow;
+	int coverLeft, coverRight;
+
+	if (left >= right || top >= bottom)
+		return 1;
+
+	for (topwindow = w + 1; topwindow < RCT2_NEW_WINDOW; topwindow++) {
+		// Check if this window overlaps the region
+		if (topwindow->x >= right || topwindow->y >= bottom)
+			continue;
+		if (topwindow->x + topwindow->width <= left || topwindow->y + topwindow->height <= top)
+			continue;
+		if (topwindow->flags & WF_TRANSPARENT)
+			continue;
+
+		// The strips this window leaves uncovered must each be occluded too.
+		// Windows below topwindow were already found not to overlap the
+		// region, so the recursion only needs to consider windows above it.
+		coverLeft = max(left, topwindow->x);
+		coverRight = min(right, topwindow->x + topwindow->width);
+		if (left < coverLeft && !window_is_region_occluded(topwindow, left, top, coverLeft, bottom))
+			return 0;
+		if (coverRight < right && !window_is_region_occluded(topwindow, coverRight, top, right, bottom))
+			return 0;
+		if (top < topwindow->y && !window_is_region_occluded(topwindow, coverLeft, top, coverRight, topwindow->y))
+			return 0;
+		if (bottom > topwindow->y + topwindow->height && !window_is_region_occluded(topwindow, coverLeft, topwindow->y + topwindow->height, coverRight, bottom))
+			return 0;
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * Returns nonzero if any window above w in the z-order overlaps the given
+ * screen region at all. Unlike window_is_region_occluded this rejects
+ * partial and transparent overlap too; it answers whether the pixels in the
+ * region still belong solely to w.
+ */
+int window_is_region_overlapped(rct_window *w, int left, int top, int right, int bottom)
+{
+	rct_window* topwindow;
+
+	if (left >= right || top >= bottom)
+		return 0;
+
+	for (topwindow = w + 1; topwindow < RCT2_NEW_WINDOW; topwindow++) {
+		if (topwindow->x >= right || topwindow->y >= bottom)
+			continue;
+		if (topwindow->x + topwindow->width <= left || topwindow->y + topwindow->height <= top)
+			continue;
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ *
  *  rct2: 0x006EB15C
  *
  * @param window (esi)
@@ -1414,6 +1842,7 @@ void window_draw_widgets(rct_window *w, rct_drawpixelinfo *dpi)
 {
 	rct_widget *widget;
 	int widgetIndex;
+	bool chrome;
 
 	// RCT2_CALLPROC_X(0x006EB15C, 0, 0, 0, 0, w, dpi, 0);
 	// return;
@@ -1423,8 +1852,17 @@ void window_draw_widgets(rct_window *w, rct_drawpixelinfo *dpi)
 
 	//todo: some code missing here? Between 006EB18C and 006EB260
 
+	// Static chrome comes from the retained backing when possible; only the
+	// dynamic widgets are rasterized on top of it
+	chrome = window_chrome_composite(w, dpi);
+
 	widgetIndex = 0;
 	for (widget = w->widgets; widget->type != WWT_LAST; widget++) {
+		if (chrome && window_chrome_widget_is_static(widget)) {
+			widgetIndex++;
+			continue;
+		}
+
 		// Check if widget is outside the draw region
 		if (w->x + widget->left < dpi->x + dpi->width && w->x + widget->right >= dpi->x)
 			if (w->y + widget->top < dpi->y + dpi->height && w->y + widget->bottom >= dpi->y)
@@ -1457,11 +1895,101 @@ void window_set_position(rct_window *w, int x, int y)
 	window_move_position(w, x - w->x, y - w->y);
 }
 
+/**
+ * Moves a dragged window by copying its already rendered pixels to the new
+ * position, so only the thin strips it exposes need repainting. Invalidating
+ * the old and new rects instead repaints the full window plus the viewport
+ * behind it on every mouse delta, which is what makes dragging large windows
+ * over a busy park view stutter. Returns false when the copy cannot be done
+ * safely and the caller must fall back to full invalidation.
+ */
+static bool window_move_position_blit(rct_window *w, int dx, int dy)
+{
+	rct_drawpixelinfo *screenDPI = RCT2_ADDRESS(RCT2_ADDRESS_SCREEN_DPI, rct_drawpixelinfo);
+	rct_window *topwindow;
+	int screenWidth, screenHeight, stride, y;
+	int oldX, oldY, newX, newY;
+	uint8 *src, *dst;
+
+	// Only worth the care during an actual drag; windows also move when they
+	// are auto positioned at creation, before they were ever painted
+	if (RCT2_GLOBAL(RCT2_ADDRESS_INPUT_STATE, uint8) != INPUT_STATE_POSITIONING_WINDOW)
+		return false;
+	if (w->flags & WF_TRANSPARENT)
+		return false;
+
+	oldX = w->x;
+	oldY = w->y;
+	newX = oldX + dx;
+	newY = oldY + dy;
+
+	// Both rects must be entirely on screen; a partially clipped window has
+	// pixels that were never rendered
+	screenWidth = RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_WIDTH, sint16);
+	screenHeight = RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_HEIGHT, sint16);
+	if (oldX < 0 || oldY < 0 || oldX + w->width > screenWidth || oldY + w->height > screenHeight)
+		return false;
+	if (newX < 0 || newY < 0 || newX + w->width > screenWidth || newY + w->height > screenHeight)
+		return false;
+
+	// No window above w may overlap either rect, otherwise its pixels would
+	// be copied along; transparent ones count too since their blend depends
+	// on what is behind them
+	for (topwindow = w + 1; topwindow < RCT2_NEW_WINDOW; topwindow++) {
+		if (topwindow->x >= max(oldX, newX) + w->width || topwindow->y >= max(oldY, newY) + w->height)
+			continue;
+		if (topwindow->x + topwindow->width <= min(oldX, newX) || topwindow->y + topwindow->height <= min(oldY, newY))
+			continue;
+		return false;
+	}
+
+	// Bring the screen buffer up to date before copying from it
+	window_invalidation_flush_all();
+	gfx_draw_all_dirty_blocks();
+
+	// Copy the window pixels, row order chosen so overlapping rects are safe
+	stride = screenDPI->width + screenDPI->pitch;
+	if (dy <= 0) {
+		src = screenDPI->bits + (oldY * stride) + oldX;
+		dst = screenDPI->bits + (newY * stride) + newX;
+		for (y = 0; y < w->height; y++, src += stride, dst += stride)
+			memmove(dst, src, w->width);
+	} else {
+		src = screenDPI->bits + ((oldY + w->height - 1) * stride) + oldX;
+		dst = screenDPI->bits + ((newY + w->height - 1) * stride) + newX;
+		for (y = 0; y < w->height; y++, src -= stride, dst -= stride)
+			memmove(dst, src, w->width);
+	}
+
+	// Translate window and viewport
+	w->x = newX;
+	w->y = newY;
+	if (w->viewport != NULL) {
+		w->viewport->x += dx;
+		w->viewport->y += dy;
+	}
+
+	// Repaint just the strips of background the window uncovered
+	if (dx > 0)
+		gfx_set_dirty_blocks(oldX, oldY, min(newX, oldX + w->width), oldY + w->height);
+	else if (dx < 0)
+		gfx_set_dirty_blocks(max(newX + w->width, oldX), oldY, oldX + w->width, oldY + w->height);
+	if (dy > 0)
+		gfx_set_dirty_blocks(oldX, oldY, oldX + w->width, min(newY, oldY + w->height));
+	else if (dy < 0)
+		gfx_set_dirty_blocks(oldX, max(newY + w->height, oldY), oldX + w->width, oldY + w->height);
+
+	return true;
+}
+
 void window_move_position(rct_window *w, int dx, int dy)
 {
 	if (dx == 0 && dy == 0)
 		return;
 
+	if (window_move_position_blit(w, dx, dy))
+		return;
+
 	// Invalidate old region
 	window_invalidate(w);
 
@@ -1894,7 +2422,7 @@ void window_invalidate_pressed_image_buttons(rct_window *w)
 			continue;
 
 		if (widget_is_pressed(w, widgetIndex) || widget_is_active_tool(w, widgetIndex))
-			gfx_set_dirty_blocks(w->x, w->y, w->x + w->width, w->y + w->height);
+			window_invalidation_queue(w, w->x, w->y, w->x + w->width, w->y + w->height);
 	}
 }
 
@@ -470,6 +470,7 @@ void window_push_others_right(rct_window *w);
 void window_push_others_below(rct_window *w1);
 
 rct_window *window_get_main();
+rct_window *window_get_viewport_owner(rct_viewport *viewport);
 
 void window_scroll_to_viewport(rct_window *w);
 void window_scroll_to_location(rct_window *w, int x, int y, int z);
@@ -480,6 +481,8 @@ void window_zoom_out(rct_window *w);
 void window_show_textinput(rct_window *w, int widgetIndex, uint16 title, uint16 text, int value);
 
 void window_draw(rct_window *w, int left, int top, int right, int bottom);
+int window_is_region_occluded(rct_window *w, int left, int top, int right, int bottom);
+int window_is_region_overlapped(rct_window *w, int left, int top, int right, int bottom);
 void window_draw_widgets(rct_window *w, rct_drawpixelinfo *dpi);
 void window_draw_viewport(rct_drawpixelinfo *dpi, rct_window *w);
 
@@ -518,7 +521,9 @@ void window_water_open();
 void window_staff_list_open();
 void window_guest_list_open();
 void window_guest_list_open_with_filter(int type, int index);
+void window_guest_list_mark_dirty();
 void window_map_open();
+void window_map_invalidate_map_image();
 void window_options_open();
 void window_shortcut_keys_open();
 void window_shortcut_change_open(int selected_key);
@@ -45,6 +45,9 @@ void intro_update()
 	screen_intro_process_mouse_input();
 	screen_intro_process_keyboard_input();
 
+	// The intro draws straight to the screen buffer every tick
+	gfx_request_present();
+
 	RCT2_GLOBAL(0x009E2C78, int) = 1;
 	switch ((*part)) {
 	case 8:
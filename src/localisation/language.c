@@ -19,6 +19,7 @@
  *****************************************************************************/
 
 #include "../addresses.h"
+#include "../platform/platform.h"
 #include "localisation.h"
 #include "../object.h"
 
@@ -60,7 +61,36 @@ char *language_buffer = NULL;
 int language_num_strings = 0;
 char **language_strings = NULL;
 
+// A language pack is compiled once into a flat file in the user directory:
+// a header, a string-id-to-offset table and the token-converted string data.
+// Subsequent opens map that file read only and point language_strings
+// straight into the mapping, so switching language costs no parse and no
+// heap copy of the string data. The cache records the source file's
+// modified time and is rebuilt whenever the .txt changes.
+#define LANGUAGE_CACHE_MAGIC 0x43474E4C // "LNGC"
+#define LANGUAGE_CACHE_VERSION 1
+#define LANGUAGE_CACHE_OFFSET_NULL 0xFFFFFFFF
+
+typedef struct {
+	uint32 magic;
+	uint32 version;
+	uint32 num_strings;
+	uint32 data_size;
+	uint64 source_modified;
+} rct_language_cache_header;
+
+static file_mapping _languageFileMapping;
+
 static int language_open_file(const char *filename);
+static int language_cache_load(const char *cachePath, const char *sourcePath);
+static void language_cache_save(const char *cachePath, const char *sourcePath);
+
+static void language_get_cache_path(char *outPath, int id)
+{
+	platform_get_user_directory(outPath, NULL);
+	strcat(outPath, language_filenames[id]);
+	strcat(outPath, ".lng");
+}
 
 static int utf8_get_next(char *char_ptr, char **nextchar_ptr)
 {
@@ -102,13 +132,21 @@ const char *language_get_string(rct_string_id id)
 int language_open(int id)
 {
 	char filename[_MAX_PATH];
+	char cachePath[_MAX_PATH];
 
 	language_close();
 	if (id == LANGUAGE_UNDEFINED)
 		return 1;
 
 	sprintf(filename, "data/language/%s.txt", language_filenames[id]);
+	language_get_cache_path(cachePath, id);
+	if (language_cache_load(cachePath, filename)) {
+		gCurrentLanguage = id;
+		return 1;
+	}
+
 	if (language_open_file(filename)) {
+		language_cache_save(cachePath, filename);
 		gCurrentLanguage = id;
 		return 1;
 	}
@@ -222,8 +260,119 @@ static int language_open_file(const char *filename)
 	return 1;
 }
 
+/**
+ * Maps the compiled language pack and points the string table into it.
+ * Returns 0 when there is no compiled pack, it has a different layout or the
+ * source .txt has been modified since it was written; the caller then parses
+ * the source and recompiles.
+ */
+static int language_cache_load(const char *cachePath, const char *sourcePath)
+{
+	rct_language_cache_header *header;
+	uint32 *offsets;
+	char *data;
+	uint32 dataSize;
+	uint64 sourceModified;
+	int i, stringIndex;
+
+	sourceModified = platform_file_get_modified_time(sourcePath);
+
+	if (!platform_file_map(cachePath, &_languageFileMapping))
+		return 0;
+
+	if (_languageFileMapping.size < sizeof(rct_language_cache_header) + (STR_COUNT * sizeof(uint32)))
+		goto invalid;
+
+	header = (rct_language_cache_header*)_languageFileMapping.data;
+	if (
+		header->magic != LANGUAGE_CACHE_MAGIC ||
+		header->version != LANGUAGE_CACHE_VERSION ||
+		header->num_strings != STR_COUNT ||
+		header->source_modified != sourceModified ||
+		sourceModified == 0
+	) {
+		goto invalid;
+	}
+
+	offsets = (uint32*)(_languageFileMapping.data + sizeof(rct_language_cache_header));
+	data = (char*)(offsets + STR_COUNT);
+	dataSize = _languageFileMapping.size - sizeof(rct_language_cache_header) - (STR_COUNT * sizeof(uint32));
+	if (header->data_size != dataSize)
+		goto invalid;
+
+	language_strings = calloc(STR_COUNT, sizeof(char*));
+	stringIndex = 0;
+	for (i = 0; i < STR_COUNT; i++) {
+		if (offsets[i] == LANGUAGE_CACHE_OFFSET_NULL)
+			continue;
+		if (offsets[i] >= dataSize) {
+			free(language_strings);
+			language_strings = NULL;
+			goto invalid;
+		}
+
+		language_strings[i] = data + offsets[i];
+		stringIndex++;
+	}
+	language_num_strings = stringIndex;
+	return 1;
+
+invalid:
+	platform_file_unmap(&_languageFileMapping);
+	return 0;
+}
+
+/**
+ * Writes the parsed string table out as a compiled language pack so the next
+ * open can map it directly. Failure is not an error; the pack is only a
+ * cache.
+ */
+static void language_cache_save(const char *cachePath, const char *sourcePath)
+{
+	FILE *file;
+	rct_language_cache_header header;
+	uint32 *offsets;
+	int i;
+
+	header.magic = LANGUAGE_CACHE_MAGIC;
+	header.version = LANGUAGE_CACHE_VERSION;
+	header.num_strings = STR_COUNT;
+	header.data_size = 0;
+	header.source_modified = platform_file_get_modified_time(sourcePath);
+	if (header.source_modified == 0)
+		return;
+
+	offsets = malloc(STR_COUNT * sizeof(uint32));
+	for (i = 0; i < STR_COUNT; i++) {
+		if (language_strings[i] == NULL) {
+			offsets[i] = LANGUAGE_CACHE_OFFSET_NULL;
+		} else {
+			offsets[i] = header.data_size;
+			header.data_size += strlen(language_strings[i]) + 1;
+		}
+	}
+
+	file = fopen(cachePath, "wb");
+	if (file == NULL) {
+		free(offsets);
+		return;
+	}
+
+	fwrite(&header, sizeof(header), 1, file);
+	fwrite(offsets, sizeof(uint32), STR_COUNT, file);
+	for (i = 0; i < STR_COUNT; i++)
+		if (language_strings[i] != NULL)
+			fwrite(language_strings[i], strlen(language_strings[i]) + 1, 1, file);
+	fclose(file);
+	free(offsets);
+}
+
 void language_close()
 {
+	if (_languageFileMapping.data != NULL)
+		platform_file_unmap(&_languageFileMapping);
+	_languageFileMapping.data = NULL;
+
 	if (language_buffer != NULL)
 		free(language_buffer);
 	language_buffer = NULL;
@@ -235,6 +384,8 @@ void language_close()
 	language_num_strings = 0;
 
 	gCurrentLanguage = LANGUAGE_UNDEFINED;
+
+	format_string_cache_reset();
 }
 
 const int OpenRCT2LangIdToObjectLangId[] = {
@@ -127,8 +127,192 @@ const char *format_get_token(char code)
 
 #pragma endregion
 
-void format_string_part_from_raw(char **dest, const char *src, char **args);
-void format_string_part(char **dest, rct_string_id format, char **args);
+// Argument stream for the formatter. Arguments come either from one flat
+// byte block (the RCT2_ADDRESS_COMMON_FORMAT_ARGS staging pattern) or from a
+// list of typed spans read in place from caller memory.
+typedef struct {
+	char *flat;				// flat argument block, used when spans is NULL
+	const format_arg *spans;
+	int numSpans;
+	int spanIndex;
+	int spanOffset;			// byte offset within the current span
+} format_args;
+
+void format_string_part_from_raw(char **dest, const char *src, format_args *args);
+void format_string_part(char **dest, rct_string_id format, format_args *args);
+void format_string_code(unsigned char format_code, char **dest, format_args *args);
+
+static const void *format_args_pop(format_args *args, int size)
+{
+	static const uint32 zero = 0;
+	const char *data;
+
+	if (args->spans == NULL) {
+		data = args->flat;
+		args->flat += size;
+		return data;
+	}
+
+	// Values never split across spans; a span without enough bytes left to
+	// satisfy the read is exhausted and the next one is used
+	while (args->spanIndex < args->numSpans &&
+			args->spanOffset + size > args->spans[args->spanIndex].size) {
+		args->spanIndex++;
+		args->spanOffset = 0;
+	}
+	if (args->spanIndex == args->numSpans)
+		return &zero;
+
+	data = (const char*)args->spans[args->spanIndex].data + args->spanOffset;
+	args->spanOffset += size;
+	return data;
+}
+
+static uint16 format_args_pop16(format_args *args)
+{
+	return *((const uint16*)format_args_pop(args, 2));
+}
+
+static uint32 format_args_pop32(format_args *args)
+{
+	return *((const uint32*)format_args_pop(args, 4));
+}
+
+static void format_args_push16(format_args *args)
+{
+	if (args->spans == NULL) {
+		args->flat -= 2;
+	} else if (args->spanOffset >= 2) {
+		args->spanOffset -= 2;
+	} else if (args->spanIndex > 0) {
+		args->spanIndex--;
+		args->spanOffset = 0;
+	}
+}
+
+static void format_args_skip(format_args *args, int size)
+{
+	while (size > 0) {
+		format_args_pop(args, 2);
+		size -= 2;
+	}
+}
+
+#pragma region Format string compilation cache
+
+// A format template is compiled once into a short program of literal copies
+// and format code invocations, so formatting the same string every frame no
+// longer rescans the template byte by byte. Programs are keyed by string id
+// and generation stamped; the whole cache is reset whenever the language or
+// the loaded objects rewrite the string tables underneath us.
+typedef struct {
+	uint8 code;		// format code to execute, or 0 for a literal copy
+	uint16 offset;	// offset of the literal run within the template
+	uint16 length;	// length of the literal run, including inline operands
+} rct_format_op;
+
+static rct_format_op *_formatOps = NULL;
+static int _formatOpsCount = 0;
+static int _formatOpsCapacity = 0;
+
+static uint32 _formatProgramStart[STR_COUNT];
+static uint16 _formatProgramLength[STR_COUNT];
+static uint16 _formatProgramGeneration[STR_COUNT];
+static uint16 _formatCacheGeneration = 1;
+
+void format_string_cache_reset()
+{
+	_formatCacheGeneration++;
+	if (_formatCacheGeneration == 0)
+		_formatCacheGeneration = 1;
+	_formatOpsCount = 0;
+}
+
+/**
+ * Returns the current cache generation so callers memoizing formatted output
+ * can tell when the string tables have been rewritten underneath them.
+ */
+uint16 format_string_cache_generation()
+{
+	return _formatCacheGeneration;
+}
+
+static int format_ops_append(uint8 code, uint16 offset, uint16 length)
+{
+	rct_format_op *op;
+
+	if (_formatOpsCount >= _formatOpsCapacity) {
+		int newCapacity = max(512, _formatOpsCapacity * 2);
+		rct_format_op *newOps = realloc(_formatOps, newCapacity * sizeof(rct_format_op));
+		if (newOps == NULL)
+			return 0;
+
+		_formatOps = newOps;
+		_formatOpsCapacity = newCapacity;
+	}
+
+	op = &_formatOps[_formatOpsCount++];
+	op->code = code;
+	op->offset = offset;
+	op->length = length;
+	return 1;
+}
+
+/**
+ * Compiles the template for the given string id into a program of literal
+ * copies and format code invocations. Returns 0 if the program could not be
+ * stored, in which case the caller interprets the raw template instead.
+ */
+static int format_string_compile(rct_string_id format, const char *src)
+{
+	unsigned char code;
+	int i, runStart, start;
+
+	start = _formatOpsCount;
+	i = 0;
+	runStart = 0;
+	for (;;) {
+		if (i > 0xFFFA)
+			return 0;
+
+		code = src[i];
+		if (code < ' ') {
+			if (code == 0) {
+				// Include the terminator in the final literal run
+				i++;
+				break;
+			} else if (code <= 4) {
+				i += 2;
+			} else if (code <= 16) {
+				i++;
+			} else if (code <= 22) {
+				i += 3;
+			} else {
+				i += 5;
+			}
+		} else if (code <= 'z' || code >= 142) {
+			i++;
+		} else {
+			// Flush the literal run, then the format code
+			if (i > runStart && !format_ops_append(0, runStart, i - runStart))
+				return 0;
+			if (!format_ops_append(code, 0, 0))
+				return 0;
+
+			i++;
+			runStart = i;
+		}
+	}
+	if (i > runStart && !format_ops_append(0, runStart, i - runStart))
+		return 0;
+
+	_formatProgramStart[format] = start;
+	_formatProgramLength[format] = _formatOpsCount - start;
+	_formatProgramGeneration[format] = _formatCacheGeneration;
+	return 1;
+}
+
+#pragma endregion
 
 void format_integer(char **dest, long long value)
 {
@@ -346,8 +530,8 @@ void format_currency_2dp(char **dest, long long value)
 void format_date(char **dest, uint16 value)
 {
 	uint16 args[] = { date_get_month(value), date_get_year(value) + 1 };
-	uint16 *argsRef = args;
-	format_string_part(dest, 2736, (char**)&argsRef);
+	format_args fargs = { (char*)args, NULL, 0, 0, 0 };
+	format_string_part(dest, 2736, &fargs);
 	(*dest)--;
 }
 
@@ -360,8 +544,8 @@ void format_length(char **dest, sint16 value)
 		stringId--;
 	}
 
-	uint16 *argRef = &value;
-	format_string_part(dest, stringId, (char**)&argRef);
+	format_args fargs = { (char*)&value, NULL, 0, 0, 0 };
+	format_string_part(dest, stringId, &fargs);
 }
 
 void format_velocity(char **dest, uint16 value)
@@ -373,8 +557,8 @@ void format_velocity(char **dest, uint16 value)
 		stringId++;
 	}
 
-	uint16 *argRef = &value;
-	format_string_part(dest, stringId, (char**)&argRef);
+	format_args fargs = { (char*)&value, NULL, 0, 0, 0 };
+	format_string_part(dest, stringId, &fargs);
 }
 
 void format_duration(char **dest, uint16 value)
@@ -384,6 +568,7 @@ void format_duration(char **dest, uint16 value)
 	uint16 args[] = { minutes, seconds };
 	uint16 *argsRef = &args[1];
 	rct_string_id stringId = 2720;
+	format_args fargs = { NULL, NULL, 0, 0, 0 };
 
 	if (minutes > 0) {
 		stringId += 2;
@@ -396,7 +581,8 @@ void format_duration(char **dest, uint16 value)
 	if (seconds != 1)
 		stringId++;
 
-	format_string_part(dest, stringId, (char**)&argsRef);
+	fargs.flat = (char*)argsRef;
+	format_string_part(dest, stringId, &fargs);
 }
 
 void format_realtime(char **dest, uint16 value)
@@ -406,6 +592,7 @@ void format_realtime(char **dest, uint16 value)
 	uint16 args[] = { hours, minutes };
 	uint16 *argsRef = &args[1];
 	rct_string_id stringId = 2726;
+	format_args fargs = { NULL, NULL, 0, 0, 0 };
 
 	if (hours > 0) {
 		stringId += 2;
@@ -418,133 +605,118 @@ void format_realtime(char **dest, uint16 value)
 	if (minutes != 1)
 		stringId++;
 
-	format_string_part(dest, stringId, (char**)&argsRef);
+	fargs.flat = (char*)argsRef;
+	format_string_part(dest, stringId, &fargs);
 }
 
-void format_string_code(unsigned char format_code, char **dest, char **args)
+void format_string_code(unsigned char format_code, char **dest, format_args *args)
 {
 	int value;
 
 	switch (format_code) {
 	case FORMAT_COMMA32:
 		// Pop argument
-		value = *((sint32*)*args);
-		*args += 4;
+		value = (sint32)format_args_pop32(args);
 
 		format_comma_separated_integer(dest, value);
 		break;
 	case FORMAT_INT32:
 		// Pop argument
-		value = *((sint32*)*args);
-		*args += 4;
+		value = (sint32)format_args_pop32(args);
 
 		format_integer(dest, value);
 		break;
 	case FORMAT_COMMA2DP32:
 		// Pop argument
-		value = *((sint32*)*args);
-		*args += 4;
+		value = (sint32)format_args_pop32(args);
 
 		format_comma_separated_fixed_2dp(dest, value);
 		break;
 	case FORMAT_COMMA16:
 		// Pop argument
-		value = *((sint16*)*args);
-		*args += 2;
+		value = (sint16)format_args_pop16(args);
 
 		format_comma_separated_integer(dest, value);
 		break;
 	case FORMAT_UINT16:
 		// Pop argument
-		value = *((uint16*)*args);
-		*args += 2;
+		value = format_args_pop16(args);
 
 		format_integer(dest, value);
 		break;
 	case FORMAT_CURRENCY2DP:
 		// Pop argument
-		value = *((sint32*)*args);
-		*args += 4;
+		value = (sint32)format_args_pop32(args);
 
 		format_currency_2dp(dest, value);
 		break;
 	case FORMAT_CURRENCY:
 		// Pop argument
-		value = *((sint32*)*args);
-		*args += 4;
+		value = (sint32)format_args_pop32(args);
 
 		format_currency(dest, value);
 		break;
 	case FORMAT_STRINGID:
 	case FORMAT_STRINGID2:
 		// Pop argument
-		value = *((uint16*)*args);
-		*args += 2;
+		value = format_args_pop16(args);
 
 		format_string_part(dest, value, args);
 		(*dest)--;
 		break;
 	case FORMAT_STRING:
 		// Pop argument
-		value = *((uint32*)*args);
-		*args += 4;
+		value = format_args_pop32(args);
 
 		strcpy(*dest, (char*)value);
 		*dest += strlen(*dest);
 		break;
 	case FORMAT_MONTHYEAR:
 		// Pop argument
-		value = *((uint16*)*args);
-		*args += 2;
+		value = format_args_pop16(args);
 
 		format_date(dest, value);
 		break;
 	case FORMAT_MONTH:
 		// Pop argument
-		value = *((uint16*)*args);
-		*args += 2;
+		value = format_args_pop16(args);
 
 		strcpy(*dest, language_get_string(STR_MONTH_MARCH + date_get_month(value)));
 		*dest += strlen(*dest);
 		break;
 	case FORMAT_VELOCITY:
 		// Pop argument
-		value = *((sint16*)*args);
-		*args += 2;
+		value = (sint16)format_args_pop16(args);
 
 		format_velocity(dest, value);
 		break;
 	case FORMAT_POP16:
-		*args += 2;
+		format_args_skip(args, 2);
 		break;
 	case FORMAT_PUSH16:
-		*args -= 2;
+		format_args_push16(args);
 		break;
 	case FORMAT_DURATION:
 		// Pop argument
-		value = *((uint16*)*args);
-		*args += 2;
+		value = format_args_pop16(args);
 
 		format_duration(dest, value);
 		break;
 	case FORMAT_REALTIME:
 		// Pop argument
-		value = *((uint16*)*args);
-		*args += 2;
+		value = format_args_pop16(args);
 
 		format_realtime(dest, value);
 		break;
 	case FORMAT_LENGTH:
 		// Pop argument
-		value = *((sint16*)*args);
-		*args += 2;
+		value = (sint16)format_args_pop16(args);
 
 		format_length(dest, value);
 		break;
 	case FORMAT_SPRITE:
 		// Pop argument
-		value = *((uint32*)*args);
-		*args += 4;
+		value = format_args_pop32(args);
 
 		*(*dest)++ = 23;
 		*((uint32*)(*dest)) = value;
@@ -553,7 +725,7 @@ void format_string_code(unsigned char format_code, char **dest, char **args)
 	}
 }
 
-void format_string_part_from_raw(char **dest, const char *src, char **args)
+void format_string_part_from_raw(char **dest, const char *src, format_args *args)
 {
 	unsigned char code;
 	while (1) {
@@ -588,19 +760,39 @@ void format_string_part_from_raw(char **dest, const char *src, char **args)
 	}
 }
 
-void format_string_part(char **dest, rct_string_id format, char **args)
+void format_string_part(char **dest, rct_string_id format, format_args *args)
 {
 	if (format == (rct_string_id)STR_NONE) {
 		**dest = 0;
 	} else if (format < 0x8000) {
 		// Language string
-		format_string_part_from_raw(dest, language_get_string(format), args);
+		const char *src = language_get_string(format);
+		uint32 opIndex, opEnd;
+
+		if (_formatProgramGeneration[format] != _formatCacheGeneration && !format_string_compile(format, src)) {
+			format_string_part_from_raw(dest, src, args);
+			return;
+		}
+
+		// Iterate by index; a format code such as STRINGID can recursively
+		// compile another string and grow the op arena under us
+		opIndex = _formatProgramStart[format];
+		opEnd = opIndex + _formatProgramLength[format];
+		for (; opIndex < opEnd; opIndex++) {
+			rct_format_op *op = &_formatOps[opIndex];
+			if (op->code == 0) {
+				memcpy(*dest, src + op->offset, op->length);
+				*dest += op->length;
+			} else {
+				format_string_code(op->code, dest, args);
+			}
+		}
 	} else if (format < 0x9000) {
 		// Custom string
 		format -= 0x8000;
 
 		// Bits 10, 11 represent number of bytes to pop off arguments
-		*args += (format & 0xC00) >> 9;
+		format_args_skip(args, (format & 0xC00) >> 9);
 		format &= ~0xC00;
 
 		strcpy(*dest, RCT2_ADDRESS(0x135A8F4 + (format * 32), char));
@@ -614,7 +806,7 @@ void format_string_part(char **dest, rct_string_id format, char **args)
 		);
 		*dest = strchr(*dest, 0) + 1;
 
-		*args += 4;
+		format_args_skip(args, 4);
 	} else {
 		// ?
 		RCT2_CALLPROC_EBPSAFE(RCT2_ADDRESS(0x0095AFB8, uint32)[format]);
@@ -631,7 +823,18 @@ void format_string_part(char **dest, rct_string_id format, char **args)
 void format_string(char *dest, rct_string_id format, void *args)
 {
 	// RCT2_CALLPROC_X(0x006C2555, format, 0, (int)args, 0, 0, (int)dest, 0);
-	format_string_part(&dest, format, (char**)&args);
+	format_args fargs = { (char*)args, NULL, 0, 0, 0 };
+	format_string_part(&dest, format, &fargs);
+}
+
+/**
+ * Writes a formatted string to a buffer, reading arguments in place from the
+ * given typed spans instead of a staged copy in the common format args block.
+ */
+void format_string_args(char *dest, rct_string_id format, const format_arg *args, int count)
+{
+	format_args fargs = { NULL, args, count, 0, 0 };
+	format_string_part(&dest, format, &fargs);
 }
 
 /**
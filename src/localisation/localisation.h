@@ -26,7 +26,19 @@
 #include "language.h"
 #include "string_ids.h"
 
+// A typed view of one format argument, read in place from caller memory so
+// values no longer have to be staged through the common format args block.
+typedef struct format_arg {
+	const void *data;
+	uint16 size;
+} format_arg;
+
+#define FORMAT_ARG(x) { &(x), sizeof(x) }
+
 void format_string(char *dest, rct_string_id format, void *args);
+void format_string_args(char *dest, rct_string_id format, const format_arg *args, int count);
+void format_string_cache_reset();
+uint16 format_string_cache_generation();
 void generate_string_file();
 void error_string_quit(int error, rct_string_id format);
 int get_string_length(char* buffer);
@@ -34,6 +46,7 @@ int get_string_length(char* buffer);
 void user_string_clear_all();
 rct_string_id user_string_allocate(int base, const char *text);
 void user_string_free(rct_string_id id);
+void user_string_table_invalidate();
 
 int win1252_to_utf8(utf8string dst, const char *src, int maxBufferLength);
 
@@ -19,10 +19,49 @@
  *****************************************************************************/
 
 #include "../addresses.h"
+#include "../interface/viewport.h"
 #include "localisation.h"
 
 char *gUserStrings = (char*)0x0135A8F4;
 
+// Stack of known-free slot indexes so allocation does not have to scan the
+// whole table. Original code paths and loaded saves still write the table
+// directly, so entries are hints that have to be checked before use.
+static uint16 _freeIndexes[MAX_USER_STRINGS];
+static int _numFreeIndexes;
+static bool _freeIndexesValid = false;
+
+static void user_string_rebuild_free_list()
+{
+	int i;
+
+	_numFreeIndexes = 0;
+	for (i = MAX_USER_STRINGS - 1; i >= 0; i--)
+		if (gUserStrings[i * USER_STRING_MAX_LENGTH] == 0)
+			_freeIndexes[_numFreeIndexes++] = i;
+	_freeIndexesValid = true;
+}
+
+void user_string_table_invalidate()
+{
+	_freeIndexesValid = false;
+	scrolling_text_invalidate();
+}
+
+static bool user_string_exists(const char *text)
+{
+	int i;
+
+	for (i = 0; i < MAX_USER_STRINGS; i++) {
+		const char *userString = &gUserStrings[i * USER_STRING_MAX_LENGTH];
+		if (userString[0] == 0)
+			continue;
+		if (strcmp(userString, text) == 0)
+			return true;
+	}
+	return false;
+}
+
 /**
  *
  *  rct2: 0x006C4209
@@ -30,25 +69,59 @@ char *gUserStrings = (char*)0x0135A8F4;
 void user_string_clear_all()
 {
 	memset(gUserStrings, 0, MAX_USER_STRINGS * USER_STRING_MAX_LENGTH);
+	_freeIndexesValid = false;
 }
 
 /**
- * 
+ *
  *  rct2: 0x006C421D
  */
 rct_string_id user_string_allocate(int base, const char *text)
 {
-	int eax, ebx, ecx, edx, esi, edi, ebp;
+	int i, highBits;
+	char *userString;
+	bool allowDuplicates, rebuilt;
+
+	highBits = (base & 0x7F) << 9;
+	allowDuplicates = base & 0x80;
+
+	if (!allowDuplicates && user_string_exists(text)) {
+		RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_TEXT, uint16) = 3093; // Chosen name in use already
+		return 0;
+	}
 
-	ecx = base;
-	edi = (int)text;
-	RCT2_CALLFUNC_X(0x006C421D, &eax, &ebx, &ecx, &edx, &esi, &edi, &ebp);
-	
-	return eax & 0xFFFF;
+	rebuilt = false;
+	if (!_freeIndexesValid) {
+		user_string_rebuild_free_list();
+		rebuilt = true;
+	}
+	for (;;) {
+		while (_numFreeIndexes > 0) {
+			i = _freeIndexes[--_numFreeIndexes];
+			userString = &gUserStrings[i * USER_STRING_MAX_LENGTH];
+			if (userString[0] != 0) {
+				// Slot was taken by an original code path, drop the stale hint
+				continue;
+			}
+			strncpy(userString, text, USER_STRING_MAX_LENGTH - 1);
+			userString[USER_STRING_MAX_LENGTH - 1] = 0;
+			return 0x8000 + (i | highBits);
+		}
+
+		// Original code paths may have freed slots without telling us, rescan
+		// once before reporting the table as full
+		if (rebuilt)
+			break;
+		user_string_rebuild_free_list();
+		rebuilt = true;
+	}
+
+	RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_TEXT, uint16) = 3094; // Too many names defined
+	return 0;
 }
 
 /**
- * 
+ *
  *  rct2: 0x006C42AC
  */
 void user_string_free(rct_string_id id)
@@ -58,4 +131,10 @@ void user_string_free(rct_string_id id)
 
 	id %= MAX_USER_STRINGS;
 	gUserStrings[id * USER_STRING_MAX_LENGTH] = 0;
+	if (_freeIndexesValid && _numFreeIndexes < MAX_USER_STRINGS)
+		_freeIndexes[_numFreeIndexes++] = id;
+
+	// A rename can reallocate the slot that was just freed, which keeps the
+	// string id unchanged, so cached sign strips have to be dropped
+	scrolling_text_invalidate();
 }
\ No newline at end of file
@@ -58,13 +58,18 @@ int award_is_positive(int type)
 
 #pragma region Award checks
 
+/** Number of guests currently thinking untidy thoughts. */
+static int award_count_untidy_thoughts()
+{
+	return
+		peep_fresh_thought_count(PEEP_THOUGHT_TYPE_BAD_LITTER) +
+		peep_fresh_thought_count(PEEP_THOUGHT_TYPE_PATH_DISGUSTING) +
+		peep_fresh_thought_count(PEEP_THOUGHT_TYPE_VANDALISM);
+}
+
 /** More than 1/16 of the total guests must be thinking untidy thoughts. */
 static int award_is_deserved_most_untidy(int awardType, int activeAwardTypes)
 {
-	uint16 spriteIndex;
-	rct_peep *peep;
-	int negativeCount;
-
 	if (activeAwardTypes & (1 << PARK_AWARD_MOST_BEAUTIFUL))
 		return 0;
 	if (activeAwardTypes & (1 << PARK_AWARD_BEST_STAFF))
@@ -72,59 +77,22 @@ static int award_is_deserved_most_untidy(int awardType, int activeAwardTypes)
 	if (activeAwardTypes & (1 << PARK_AWARD_MOST_TIDY))
 		return 0;
 
-	negativeCount = 0;
-	FOR_ALL_GUESTS(spriteIndex, peep) {
-		if (peep->var_2A != 0)
-			continue;
-
-		if (peep->thoughts[0].var_2 > 5)
-			continue;
-
-		if (peep->thoughts[0].type == PEEP_THOUGHT_TYPE_BAD_LITTER ||
-			peep->thoughts[0].type == PEEP_THOUGHT_TYPE_PATH_DISGUSTING ||
-			peep->thoughts[0].type == PEEP_THOUGHT_TYPE_VANDALISM
-		) {
-			negativeCount++;
-		}
-	}
-
-	return (negativeCount > RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16) / 16);
+	return (award_count_untidy_thoughts() > RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16) / 16);
 }
 
 /** More than 1/64 of the total guests must be thinking tidy thoughts and less than 6 guests thinking untidy thoughts. */
 static int award_is_deserved_most_tidy(int awardType, int activeAwardTypes)
 {
-	uint16 spriteIndex;
-	rct_peep *peep;
 	int positiveCount;
-	int negativeCount;
 
 	if (activeAwardTypes & (1 << PARK_AWARD_MOST_UNTIDY))
 		return 0;
 	if (activeAwardTypes & (1 << PARK_AWARD_MOST_DISAPPOINTING))
 		return 0;
 
-	positiveCount = 0;
-	negativeCount = 0;
-	FOR_ALL_GUESTS(spriteIndex, peep) {
-		if (peep->var_2A != 0)
-			continue;
-
-		if (peep->thoughts[0].var_2 > 5)
-			continue;
-
-		if (peep->thoughts[0].type == PEEP_THOUGHT_VERY_CLEAN)
-			positiveCount++;
+	positiveCount = peep_fresh_thought_count(PEEP_THOUGHT_VERY_CLEAN);
 
-		if (peep->thoughts[0].type == PEEP_THOUGHT_TYPE_BAD_LITTER ||
-			peep->thoughts[0].type == PEEP_THOUGHT_TYPE_PATH_DISGUSTING ||
-			peep->thoughts[0].type == PEEP_THOUGHT_TYPE_VANDALISM
-		) {
-			negativeCount++;
-		}
-	}
-
-	return (negativeCount <= 5 && positiveCount > RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16) / 64);
+	return (award_count_untidy_thoughts() <= 5 && positiveCount > RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16) / 64);
 }
 
 /** At least 6 open roller coasters. */
@@ -168,37 +136,16 @@ static int award_is_deserved_best_value(int awardType, int activeAwardTypes)
 /** More than 1/128 of the total guests must be thinking scenic thoughts and less than 16 untidy thoughts. */
 static int award_is_deserved_most_beautiful(int awardType, int activeAwardTypes)
 {
-	uint16 spriteIndex;
-	rct_peep *peep;
 	int positiveCount;
-	int negativeCount;
 
 	if (activeAwardTypes & (1 << PARK_AWARD_MOST_UNTIDY))
 		return 0;
 	if (activeAwardTypes & (1 << PARK_AWARD_MOST_DISAPPOINTING))
 		return 0;
 
-	positiveCount = 0;
-	negativeCount = 0;
-	FOR_ALL_GUESTS(spriteIndex, peep) {
-		if (peep->var_2A != 0)
-			continue;
-
-		if (peep->thoughts[0].var_2 > 5)
-			continue;
-
-		if (peep->thoughts[0].type == PEEP_THOUGHT_TYPE_SCENERY)
-			positiveCount++;
+	positiveCount = peep_fresh_thought_count(PEEP_THOUGHT_TYPE_SCENERY);
 
-		if (peep->thoughts[0].type == PEEP_THOUGHT_TYPE_BAD_LITTER ||
-			peep->thoughts[0].type == PEEP_THOUGHT_TYPE_PATH_DISGUSTING ||
-			peep->thoughts[0].type == PEEP_THOUGHT_TYPE_VANDALISM
-		) {
-			negativeCount++;
-		}
-	}
-
-	return (negativeCount <= 15 && positiveCount > RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16) / 128);
+	return (award_count_untidy_thoughts() <= 15 && positiveCount > RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16) / 128);
 }
 
 /** Entrance fee is more than total ride value. */
@@ -218,20 +165,10 @@ static int award_is_deserved_worse_value(int awardType, int activeAwardTypes)
 /** No more than 2 people who think the vandalism is bad and no crashes. */
 static int award_is_deserved_safest(int awardType, int activeAwardTypes)
 {
-	int i, peepsWhoDislikeVandalism;
-	uint16 spriteIndex;
-	rct_peep *peep;
+	int i;
 	rct_ride *ride;
 
-	peepsWhoDislikeVandalism = 0;
-	FOR_ALL_GUESTS(spriteIndex, peep) {
-		if (peep->var_2A != 0)
-			continue;
-		if (peep->thoughts[0].var_2 <= 5 && peep->thoughts[0].type == PEEP_THOUGHT_TYPE_VANDALISM)
-			peepsWhoDislikeVandalism++;
-	}
-
-	if (peepsWhoDislikeVandalism > 2)
+	if (peep_fresh_thought_count(PEEP_THOUGHT_TYPE_VANDALISM) > 2)
 		return 0;
 
 	// Check for rides that have crashed maybe?
@@ -272,12 +209,10 @@ static int award_is_deserved_best_staff(int awardType, int activeAwardTypes)
 /** At least 7 shops, 4 unique, one shop per 128 guests and no more than 12 hungry guests. */
 static int award_is_deserved_best_food(int awardType, int activeAwardTypes)
 {
-	int i, hungryPeeps, shops, uniqueShops;
+	int i, shops, uniqueShops;
 	uint64 shopTypes;
 	rct_ride *ride;
 	rct_ride_type *rideType;
-	uint16 spriteIndex;
-	rct_peep *peep;
 
 	if (activeAwardTypes & (1 << PARK_AWARD_WORST_FOOD))
 		return 0;
@@ -302,28 +237,16 @@ static int award_is_deserved_best_food(int awardType, int activeAwardTypes)
 	if (shops < 7 || uniqueShops < 4 || shops < RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16) / 128)
 		return 0;
 
-	// Count hungry peeps
-	hungryPeeps = 0;
-	FOR_ALL_GUESTS(spriteIndex, peep) {
-		if (peep->var_2A != 0)
-			continue;
-
-		if (peep->thoughts[0].var_2 <= 5 && peep->thoughts[0].type == PEEP_THOUGHT_TYPE_HUNGRY)
-			hungryPeeps++;
-	}
-
-	return (hungryPeeps <= 12);
+	return (peep_fresh_thought_count(PEEP_THOUGHT_TYPE_HUNGRY) <= 12);
 }
 
 /** No more than 2 unique shops, less than one shop per 256 guests and more than 15 hungry guests. */
 static int award_is_deserved_worst_food(int awardType, int activeAwardTypes)
 {
-	int i, hungryPeeps, shops, uniqueShops;
+	int i, shops, uniqueShops;
 	uint64 shopTypes;
 	rct_ride *ride;
 	rct_ride_type *rideType;
-	uint16 spriteIndex;
-	rct_peep *peep;
 
 	if (activeAwardTypes & (1 << PARK_AWARD_BEST_FOOD))
 		return 0;
@@ -348,26 +271,14 @@ static int award_is_deserved_worst_food(int awardType, int activeAwardTypes)
 	if (uniqueShops > 2 || shops > RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16) / 256)
 		return 0;
 
-	// Count hungry peeps
-	hungryPeeps = 0;
-	FOR_ALL_GUESTS(spriteIndex, peep) {
-		if (peep->var_2A != 0)
-			continue;
-
-		if (peep->thoughts[0].var_2 <= 5 && peep->thoughts[0].type == PEEP_THOUGHT_TYPE_HUNGRY)
-			hungryPeeps++;
-	}
-
-	return (hungryPeeps > 15);
+	return (peep_fresh_thought_count(PEEP_THOUGHT_TYPE_HUNGRY) > 15);
 }
 
 /** At least 4 restrooms, 1 restroom per 128 guests and no more than 16 guests who think they need the restroom. */
 static int award_is_deserved_best_restrooms(int awardType, int activeAwardTypes)
 {
-	unsigned int i, numRestrooms, guestsWhoNeedRestroom;
+	unsigned int i, numRestrooms;
 	rct_ride *ride;
-	uint16 spriteIndex;
-	rct_peep *peep;
 
 	// Count open restrooms
 	numRestrooms = 0;
@@ -383,17 +294,8 @@ static int award_is_deserved_best_restrooms(int awardType, int activeAwardTypes)
 	if (numRestrooms < RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16) / 128U)
 		return 0;
 
-	// Count number of guests who are thinking they need the restroom
-	guestsWhoNeedRestroom = 0;
-	FOR_ALL_GUESTS(spriteIndex, peep) {
-		if (peep->var_2A != 0)
-			continue;
-
-		if (peep->thoughts[0].var_2 <= 5 && peep->thoughts[0].type == PEEP_THOUGHT_TYPE_BATHROOM)
-			guestsWhoNeedRestroom++;
-	}
-
-	return (guestsWhoNeedRestroom <= 16);
+	// No more than 16 guests can be thinking they need the restroom
+	return (peep_fresh_thought_count(PEEP_THOUGHT_TYPE_BATHROOM) <= 16);
 }
 
 /** More than half of the rides have satisfication <= 6 and park rating <= 650. */
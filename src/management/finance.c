@@ -141,6 +141,21 @@ void finance_pay_ride_upkeep()
 	}
 }
 
+// Bumped whenever a finance history series changes (the weekly shift, a
+// reset or a loaded game), so graph drawing can reuse series derived from
+// the histories until they actually move
+static uint32 _financeHistoryGeneration = 0;
+
+void finance_history_invalidate()
+{
+	_financeHistoryGeneration++;
+}
+
+uint32 finance_history_generation()
+{
+	return _financeHistoryGeneration;
+}
+
 void finance_reset_history()
 {
 	int i;
@@ -149,6 +164,7 @@ void finance_reset_history()
 		RCT2_ADDRESS(RCT2_ADDRESS_WEEKLY_PROFIT_HISTORY, money32)[i] = MONEY32_UNDEFINED;
 		RCT2_ADDRESS(RCT2_ADDRESS_PARK_VALUE_HISTORY, money32)[i] = MONEY32_UNDEFINED;
 	}
+	finance_history_invalidate();
 }
 
 /**
@@ -50,6 +50,8 @@ void finance_pay_research();
 void finance_pay_interest();
 void finance_pay_ride_upkeep();
 void finance_reset_history();
+void finance_history_invalidate();
+uint32 finance_history_generation();
 void finance_init();
 void finance_update_daily_profit();
 void sub_69E869();
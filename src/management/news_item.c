@@ -94,7 +94,14 @@ void news_item_update_current()
 	if (newsItems[0].type == 0)
 		return;
 
-	window_game_bottom_toolbar_invalidate_news_item();
+	// The ticker drawing only changes while it is still revealing text or
+	// while a peep portrait is animating in the subject button; once it has
+	// settled there is nothing to redraw until the item closes
+	if (newsItems[0].type == NEWS_ITEM_PEEP ||
+		newsItems[0].type == NEWS_ITEM_PEEP_ON_RIDE ||
+		newsItems[0].ticks <= (int)strlen(newsItems[0].text) + 2
+	)
+		window_game_bottom_toolbar_invalidate_news_item();
 
 	// Update the current news item
 	newsItems[0].ticks++;
@@ -156,15 +163,33 @@ void news_item_close_current()
  */
 static int news_item_get_new_history_slot()
 {
+	// Cached position of the first free history slot, so closing a news item
+	// does not rescan the history each time. -1 forces a rescan; the cache is
+	// also revalidated against the list itself, which covers a different
+	// history arriving with a loaded game.
+	static int _nextHistorySlot = -1;
+
 	int i;
 	rct_news_item *newsItems = RCT2_ADDRESS(RCT2_ADDRESS_NEWS_ITEM_LIST, rct_news_item);
 
-	// Find an available history news item slot
-	for (i = 11; i < 61; i++)
-		if (newsItems[i].type == NEWS_ITEM_NULL)
-			return i;
+	if (_nextHistorySlot < 11 || _nextHistorySlot > 61 ||
+		(_nextHistorySlot > 11 && newsItems[_nextHistorySlot - 1].type == NEWS_ITEM_NULL) ||
+		(_nextHistorySlot < 61 && newsItems[_nextHistorySlot].type != NEWS_ITEM_NULL)
+	) {
+		// Find the first available history news item slot
+		_nextHistorySlot = 61;
+		for (i = 11; i < 61; i++) {
+			if (newsItems[i].type == NEWS_ITEM_NULL) {
+				_nextHistorySlot = i;
+				break;
+			}
+		}
+	}
+
+	if (_nextHistorySlot < 61)
+		return _nextHistorySlot++;
 
-	// Dequeue the first history news item, shift history up
+	// History is full; dequeue the first history news item, shift history up
 	for (i = 11; i < 60; i++)
 		newsItems[i] = newsItems[i + 1];
 	return 60;
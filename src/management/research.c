@@ -217,6 +217,7 @@ void research_finish_item(sint32 entryIndex)
 		}
 
 		research_invalidate_related_windows();
+		init_scenery_invalidate();
 		init_scenery();
 	}
 }
@@ -305,6 +306,7 @@ void sub_684AC3(){
 	for (int i = 0; i < 56; i++){
 		RCT2_ADDRESS(0x01357BD0, uint32)[i] = -1;
 	}
+	init_scenery_invalidate();
 
 	for (int i = 0; i < 19; ++i){
 		rct_scenery_set_entry* scenery_set = g_scenerySetEntries[i];
@@ -24,6 +24,7 @@
 #include "platform/platform.h"
 #include "ride/ride.h"
 #include "util/sawyercoding.h"
+#include "util/workerpool.h"
 #include "drawing/drawing.h"
 #include "world/footpath.h"
 #include "world/water.h"
@@ -31,6 +32,8 @@
 #include "world/scenery.h"
 #include "scenario.h"
 
+static int object_calculate_checksum_slices(const rct_object_entry *entry, const char *data, int dataLength, int numSlices);
+
 int object_load_entry(const char *path, rct_object_entry *outEntry)
 {
 	FILE *file;
@@ -48,9 +51,14 @@ int object_load_entry(const char *path, rct_object_entry *outEntry)
 	return 1;
 }
 
-int object_load_file(int groupIndex, const rct_object_entry *entry, int* chunkSize, const rct_object_entry *installedObject)
+/**
+ * Reads and decodes an object file into a plain malloc'd buffer and verifies
+ * its checksum, without touching the object lists or the image table. Safe to
+ * call from the worker pool; the serial part of loading happens afterwards in
+ * object_load_from_chunk.
+ */
+int object_read_file(const rct_object_entry *entry, const rct_object_entry *installedObject, rct_object_entry *outEntry, uint8 **outChunk, int *chunkSize)
 {
-	uint8 objectType;
 	rct_object_entry openedEntry;
 	char path[260];
 	FILE *file;
@@ -79,27 +87,43 @@ int object_load_file(int groupIndex, const rct_object_entry *entry, int* chunkSi
 	char *chunk;
 
 	if (*chunkSize == 0xFFFFFFFF) {
-		chunk = rct2_malloc(0x600000);
+		chunk = malloc(0x600000);
 		*chunkSize = sawyercoding_read_chunk(file, chunk);
-		chunk = rct2_realloc(chunk, *chunkSize);
+		chunk = realloc(chunk, *chunkSize);
 	}
 	else {
-		chunk = rct2_malloc(*chunkSize);
+		chunk = malloc(*chunkSize);
 		*chunkSize = sawyercoding_read_chunk(file, chunk);
 	}
 	fclose(file);
 
 
 
-	// Calculate and check checksum
-	if (object_calculate_checksum(&openedEntry, chunk, *chunkSize) != openedEntry.checksum) {
+	// Calculate and check checksum, in a single slice so nested use of the
+	// worker pool is avoided when this itself runs as a pool job
+	if (object_calculate_checksum_slices(&openedEntry, chunk, *chunkSize, 1) != openedEntry.checksum) {
 		log_error("Object Load failed due to checksum failure.");
 		RCT2_GLOBAL(0x00F42BD9, uint8) = 2;
-		rct2_free(chunk);
+		free(chunk);
 		return 0;
 	}
 
-	objectType = openedEntry.flags & 0x0F;
+	*outEntry = openedEntry;
+	*outChunk = (uint8*)chunk;
+	return 1;
+}
+
+/**
+ * Performs the paint test on a decoded object chunk and installs it into its
+ * entry group. The chunk must come from the RCT2 heap. This must run on the
+ * main thread, in saved game entry order, so that images are appended to the
+ * image table deterministically.
+ */
+int object_load_from_chunk(int groupIndex, const rct_object_entry *openedEntry, uint8 *chunk, int chunkSize)
+{
+	uint8 objectType;
+
+	objectType = openedEntry->flags & 0x0F;
 
 	if (object_paint(objectType, 2, 0, objectType, 0, (int)chunk, 0, 0)) {
 		log_error("Object Load failed due to paint failure.");
@@ -130,16 +154,33 @@ int object_load_file(int groupIndex, const rct_object_entry *entry, int* chunkSi
 
 	rct_object_entry_extended* extended_entry = &object_entry_groups[objectType].entries[groupIndex];
 
-	memcpy(extended_entry, &openedEntry, sizeof(rct_object_entry));
-	extended_entry->chunk_size = *chunkSize;
+	memcpy(extended_entry, openedEntry, sizeof(rct_object_entry));
+	extended_entry->chunk_size = chunkSize;
 
-	RCT2_GLOBAL(RCT2_ADDRESS_CURR_OBJECT_CHUNK_POINTER, char*) = chunk;
+	RCT2_GLOBAL(RCT2_ADDRESS_CURR_OBJECT_CHUNK_POINTER, char*) = (char*)chunk;
 
 	if (RCT2_GLOBAL(0x9ADAFD, uint8) != 0)
 		object_paint(objectType, 0, groupIndex, objectType, 0, (int)chunk, 0, 0);
 	return 1;
 }
 
+int object_load_file(int groupIndex, const rct_object_entry *entry, int* chunkSize, const rct_object_entry *installedObject)
+{
+	rct_object_entry openedEntry;
+	uint8 *scratch, *chunk;
+
+	if (!object_read_file(entry, installedObject, &openedEntry, &scratch, chunkSize))
+		return 0;
+
+	// The read stage decodes into a plain malloc'd buffer so it can run off
+	// the main thread, but the installed chunk must come from the RCT2 heap
+	chunk = rct2_malloc(*chunkSize);
+	memcpy(chunk, scratch, *chunkSize);
+	free(scratch);
+
+	return object_load_from_chunk(groupIndex, &openedEntry, chunk, *chunkSize);
+}
+
 /**
  *
  *  rct2: 0x006A985D
@@ -209,16 +250,17 @@ int write_object_file(FILE *file, rct_object_entry* entry){
 *
 *  rct2: 0x006AA2B7
 */
-int object_load_packed(FILE *file)
+int object_load_packed(sawyercoding_reader *reader)
 {
 	object_unload_all();
 
 	rct_object_entry entry;
 
-	fread(&entry, 16, 1, file);
+	if (!sawyercoding_reader_read(reader, &entry, 16))
+		return 0;
 
 	uint8* chunk = rct2_malloc(0x600000);
-	uint32 chunkSize = sawyercoding_read_chunk(file, chunk);
+	uint32 chunkSize = sawyercoding_reader_read_chunk(reader, chunk);
 	chunk = rct2_realloc(chunk, chunkSize);
 
 	if (chunk == NULL){
@@ -361,12 +403,64 @@ int object_entry_compare(const rct_object_entry *a, const rct_object_entry *b)
 	return 1;
 }
 
-int object_calculate_checksum(const rct_object_entry *entry, const char *data, int dataLength)
+// The object checksum XORs each data byte into the low byte of the running
+// value and rotates it left by 11 bits. 32 bytes advance the rotation by 352
+// bits, a whole number of words, so the rotation pattern repeats with a
+// period of 32: all bytes at the same index modulo 32 can be XOR folded
+// together first, a word at a time, with the 32 per-position rotations
+// applied once at the end. The fold is order-independent, so large chunks
+// are additionally sliced across the worker pool.
+#define OBJECT_CHECKSUM_MAX_SLICES		8
+#define OBJECT_CHECKSUM_PARALLEL_SIZE	0x40000
+
+typedef struct {
+	const uint8 *data;
+	int dataLength;
+	int sliceLength;
+	uint8 accumulators[OBJECT_CHECKSUM_MAX_SLICES][32];
+} object_checksum_job;
+
+static void object_checksum_accumulate(const uint8 *data, int dataLength, uint8 *accumulator)
+{
+	int i, numBlocks;
+	uint32 *acc32 = (uint32*)accumulator;
+	const uint32 *data32 = (const uint32*)data;
+
+	numBlocks = dataLength / 32;
+	for (i = 0; i < numBlocks; i++) {
+		acc32[0] ^= data32[0];
+		acc32[1] ^= data32[1];
+		acc32[2] ^= data32[2];
+		acc32[3] ^= data32[3];
+		acc32[4] ^= data32[4];
+		acc32[5] ^= data32[5];
+		acc32[6] ^= data32[6];
+		acc32[7] ^= data32[7];
+		data32 += 8;
+	}
+	for (i = numBlocks * 32; i < dataLength; i++)
+		accumulator[i & 31] ^= data[i];
+}
+
+static void object_checksum_job_func(void *context, int index)
+{
+	object_checksum_job *job = (object_checksum_job*)context;
+	int start = index * job->sliceLength;
+	int length = min(job->sliceLength, job->dataLength - start);
+
+	if (length <= 0)
+		return;
+
+	object_checksum_accumulate(job->data + start, length, job->accumulators[index]);
+}
+
+static int object_calculate_checksum_slices(const rct_object_entry *entry, const char *data, int dataLength, int numSlices)
 {
-	int i;
+	int i, shift;
 	const char *eee = (char*)entry;
 	int checksum = 0xF369A75B;
 	char *ccc = (char*)&checksum;
+	object_checksum_job job;
 
 	*ccc ^= eee[0];
 	checksum = rol32(checksum, 11);
@@ -374,14 +468,40 @@ int object_calculate_checksum(const rct_object_entry *entry, const char *data, i
 		*ccc ^= eee[i];
 		checksum = rol32(checksum, 11);
 	}
-	for (i = 0; i < dataLength; i++) {
-		*ccc ^= data[i];
-		checksum = rol32(checksum, 11);
+
+	memset(&job, 0, sizeof(job));
+	job.data = (const uint8*)data;
+	job.dataLength = dataLength;
+
+	// Slices must start on a 32 byte boundary so the fold positions line up
+	job.sliceLength = ((((dataLength + numSlices - 1) / numSlices) + 31) / 32) * 32;
+	worker_pool_run(object_checksum_job_func, &job, numSlices);
+
+	for (i = 1; i < numSlices; i++)
+		for (shift = 0; shift < 32; shift++)
+			job.accumulators[0][shift] ^= job.accumulators[i][shift];
+
+	// Byte i of the data contributes rol32(byte, 11 * (dataLength - i))
+	shift = (11 * dataLength) & 31;
+	if (shift != 0)
+		checksum = rol32(checksum, shift);
+	for (i = 0; i < 32; i++) {
+		shift = (11 * ((dataLength - i) & 31)) & 31;
+		checksum ^= shift == 0 ? job.accumulators[0][i] : rol32(job.accumulators[0][i], shift);
 	}
 
 	return checksum;
 }
 
+int object_calculate_checksum(const rct_object_entry *entry, const char *data, int dataLength)
+{
+	int numSlices = 1;
+	if (dataLength >= OBJECT_CHECKSUM_PARALLEL_SIZE)
+		numSlices = clamp(1, worker_pool_get_thread_count() + 1, OBJECT_CHECKSUM_MAX_SLICES);
+
+	return object_calculate_checksum_slices(entry, data, dataLength, numSlices);
+}
+
 /* rct2: 0x006A9ED1 */
 int object_chunk_load_image_directory(uint8_t** chunk)
 {
@@ -411,6 +531,10 @@ int object_chunk_load_image_directory(uint8_t** chunk)
 	}
 
 	*chunk = ((uint8*)g1_source) + length_of_data;
+
+	// Generate zoom mips for the freshly loaded images
+	gfx_generate_sprite_mips(image_start_no, no_images);
+
 	return image_start_no;
 }
 
@@ -873,8 +997,6 @@ int paint_small_scenery(int flags, int ebx, int ecx, int edx, rct_drawpixelinfo*
 
 				gfx_draw_sprite(dpi, image_id, x, y, 0);
 			}
-
-			rct2_free(dpi);
 		}
 	}
 	return flags;
@@ -1044,7 +1166,6 @@ int paint_wall(int flags, int ebx, int ecx, int edx, rct_drawpixelinfo* dpi, int
 
 				gfx_draw_sprite(dpi, image_id, x, y, 0);
 			}
-			rct2_free(dpi);
 		}
 	}
 	return flags;
@@ -1367,8 +1488,6 @@ int paint_park_entrance_entry(int flags, int ebx, int ecx, int edx, rct_drawpixe
 			gfx_draw_sprite(dpi, image_id + 1, 24, 68, ebp);
 			gfx_draw_sprite(dpi, image_id, 56, 84, ebp);
 			gfx_draw_sprite(dpi, image_id + 2, 88, 100, ebp);
-
-			rct2_free(dpi);
 		}
 	}
 	return flags;
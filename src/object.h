@@ -22,6 +22,7 @@
 #define _OBJECT_H_
 
 #include "common.h"
+#include "util/sawyercoding.h"
 
 // First 0xF of rct_object_entry->flags
 typedef enum{
@@ -72,12 +73,17 @@ extern rct_object_entry_group object_entry_groups[];
 int object_load_entry(const char *path, rct_object_entry *outEntry);
 void object_list_load();
 void set_load_objects_fail_reason();
-int object_read_and_load_entries(FILE *file);
-int object_load_packed(FILE *file);
+int object_read_and_load_entries(sawyercoding_reader *reader);
+int object_load_entries(rct_object_entry *entries);
+int object_write_bundled_entries(FILE *file, rct_object_entry *entries);
+int object_load_bundled_entries(sawyercoding_reader *reader, rct_object_entry *entries, int numObjects);
+int object_load_packed(sawyercoding_reader *reader);
 void object_unload_all();
 
 int object_load(int groupIndex, rct_object_entry *entry, int* chunk_size);
 int object_load_file(int groupIndex, const rct_object_entry *entry, int* chunkSize, const rct_object_entry *installedObject);
+int object_read_file(const rct_object_entry *entry, const rct_object_entry *installedObject, rct_object_entry *outEntry, uint8 **outChunk, int *chunkSize);
+int object_load_from_chunk(int groupIndex, const rct_object_entry *openedEntry, uint8 *chunk, int chunkSize);
 void object_unload(int groupIndex, rct_object_entry_extended *entry);
 int object_get_scenario_text(rct_object_entry *entry);
 void object_free_scenario_text();
@@ -92,6 +98,18 @@ int find_object_in_entry_group(rct_object_entry* entry, uint8* entry_type, uint8
 
 rct_object_entry *object_list_find(rct_object_entry *entry);
 
+// One record per installed object in the name search index, partitioned by
+// object type. flagsIndex is the object's position in the installed list,
+// which is also its index into the editor object selection flags.
+typedef struct {
+	rct_object_entry *entry;
+	uint32 flagsIndex;
+	char name[80];
+} rct_object_name_index_entry;
+
+int object_name_index_get(int objectType, rct_object_name_index_entry **outEntries);
+int object_name_index_search(int objectType, const char *query, int *outIndices, int maxResults);
+
 char *object_get_name(rct_object_entry *entry);
 
 #endif
\ No newline at end of file
@@ -21,15 +21,23 @@
 #include "addresses.h"
 #include "localisation/localisation.h"
 #include "object.h"
+#include "object_preview.h"
 #include "platform/platform.h"
 #include "ride/track.h"
+#include "util/memtrack.h"
 #include "util/sawyercoding.h"
+#include "util/workerpool.h"
 #include "game.h"
 
 #define OBJECT_ENTRY_GROUP_COUNT 11
 #define OBJECT_ENTRY_COUNT 721
 
+// Layout version of plugin.dat; bump whenever rct_plugin_header or the
+// appended file index change shape so stale caches are rebuilt.
+#define OBJECT_LIST_CACHE_VERSION 1
+
 typedef struct {
+	uint32 version;
 	uint32 total_files;
 	uint32 total_file_size;
 	uint32 date_modified_checksum;
@@ -37,6 +45,21 @@ typedef struct {
 	uint32 object_list_no_items;
 } rct_plugin_header;
 
+// One record per file in the object directory, appended to plugin.dat after
+// the installed object list. When the directory has changed, files whose
+// size and modified date still match their record are copied straight out of
+// the old cache instead of being opened and parsed again.
+typedef struct {
+	uint64 last_modified;
+	uint32 size;
+	uint32 entry_offset; // offset of the entry in the installed object list, -1 if the file failed to parse
+	char path[MAX_PATH];
+} rct_object_index_entry;
+
+static rct_object_index_entry *_objectFileIndex = NULL;
+static uint32 _objectFileIndexCount = 0;
+static uint32 _objectFileIndexCapacity = 0;
+
 // 98DA00
 int object_entry_group_counts[] = {
 	128,	// rides
@@ -84,8 +107,12 @@ rct_object_entry_group object_entry_groups[] = {
 
 static int object_list_cache_load(int totalFiles, uint64 totalFileSize, int fileDateModifiedChecksum);
 static int object_list_cache_save(int fileCount, uint64 totalFileSize, int fileDateModifiedChecksum, int currentItemOffset);
+static int object_list_cache_load_stale(uint8 **outList, uint32 *outListSize, rct_object_index_entry **outIndex, uint32 *outIndexCount);
+static void object_file_index_add(const file_info *fileInfo, uint32 entryOffset);
+static rct_object_entry *object_file_index_find_unchanged(uint8 *oldList, uint32 oldListSize, rct_object_index_entry *oldIndex, uint32 oldIndexCount, const file_info *fileInfo);
 
 void object_list_create_hash_table();
+static void object_list_create_name_index();
 static uint32 install_object_entry(rct_object_entry* entry, rct_object_entry* installed_entry, const char* path);
 
 static void get_plugin_path(char *outPath)
@@ -164,13 +191,21 @@ static void object_list_examine()
 	}
 	object_list_sort();
 
-	// Create a search index
+	// Create the search indices
 	object_list_create_hash_table();
+	object_list_create_name_index();
+
+	// Entries may now refer to different object data
+	object_preview_cache_invalidate();
 }
 
 /* rct2: 0x006A9FC0 */
 void reset_loaded_objects()
 {
+	// Object resource strings are written into the game's string table, so
+	// any compiled format programs may now be stale
+	format_string_cache_reset();
+
 	reset_type_to_ride_entry_index_map();
 
 	RCT2_GLOBAL(RCT2_ADDRESS_TOTAL_NO_IMAGES, uint32) = 0xF26E;
@@ -235,6 +270,14 @@ void object_list_load()
 	if (object_list_cache_load(totalFiles, totalFileSize, fileDateModifiedChecksum))
 		return;
 
+	// The directory has changed, but most files usually have not. Pull the
+	// stale cache back in so unchanged files can be copied from it instead
+	// of being opened and parsed again.
+	uint8 *oldList = NULL;
+	uint32 oldListSize = 0, oldIndexCount = 0;
+	rct_object_index_entry *oldIndex = NULL;
+	object_list_cache_load_stale(&oldList, &oldListSize, &oldIndex, &oldIndexCount);
+
 	// Reload object list
 
 	// RCT2_ADDRESS_CONFIG_FIRST_TIME_LOAD_OBJECTS used to control if this was the first time loading objects
@@ -261,6 +304,7 @@ void object_list_load()
 	uint32 fileCount = 0;
 	uint32 current_item_offset = 0;
 	RCT2_GLOBAL(RCT2_ADDRESS_ORIGINAL_RCT2_OBJECT_COUNT, uint32) = 0;
+	_objectFileIndexCount = 0;
 
 	log_verbose("building cache of available objects...");
 
@@ -271,9 +315,14 @@ void object_list_load()
 		while (platform_enumerate_files_next(enumFileHandle, &enumFileInfo)) {
 			fileCount++;
 
-			if ((installed_buffer_size - current_item_offset) <= 2842){
-				installed_buffer_size += 0x1000;
-				RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, void*) = rct2_realloc(RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, void*), installed_buffer_size);			
+			rct_object_entry *unchangedEntry = object_file_index_find_unchanged(oldList, oldListSize, oldIndex, oldIndexCount, &enumFileInfo);
+			int requiredSpace = 2842;
+			if (unchangedEntry != NULL)
+				requiredSpace = max(requiredSpace, object_get_length(unchangedEntry));
+
+			if ((int)(installed_buffer_size - current_item_offset) <= requiredSpace){
+				installed_buffer_size += max(0x1000, requiredSpace);
+				RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, void*) = rct2_realloc(RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, void*), installed_buffer_size);
 				if (RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, int) == -1){
 					log_error("Failed to allocate memory for object list");
 					rct2_exit_reason(835, 3162);
@@ -281,20 +330,40 @@ void object_list_load()
 				}
 			}
 
+			rct_object_entry* installed_entry = (rct_object_entry*)(RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, uint8*) + current_item_offset);
+
+			if (unchangedEntry != NULL) {
+				// File unchanged since the stale cache was written, reuse
+				// its entry without opening the file
+				int entrySize = object_get_length(unchangedEntry);
+				memcpy(installed_entry, unchangedEntry, entrySize);
+				object_file_index_add(&enumFileInfo, current_item_offset);
+				current_item_offset += entrySize;
+				RCT2_GLOBAL(RCT2_ADDRESS_OBJECT_LIST_NO_ITEMS, uint32)++;
+				if ((installed_entry->flags & 0xF0) == 0x80)
+					RCT2_GLOBAL(RCT2_ADDRESS_ORIGINAL_RCT2_OBJECT_COUNT, uint32)++;
+				continue;
+			}
+
 			char path[MAX_PATH];
 			subsitute_path(path, RCT2_ADDRESS(RCT2_ADDRESS_OBJECT_DATA_PATH, char), enumFileInfo.path);
 
 			rct_object_entry entry;
-			if (!object_load_entry(path, &entry))
+			if (!object_load_entry(path, &entry)) {
+				object_file_index_add(&enumFileInfo, 0xFFFFFFFF);
 				continue;
+			}
 
-			rct_object_entry* installed_entry = (rct_object_entry*)(RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, uint8*) + current_item_offset);
-
-			current_item_offset += install_object_entry(&entry, installed_entry, enumFileInfo.path);
+			uint32 entrySize = install_object_entry(&entry, installed_entry, enumFileInfo.path);
+			object_file_index_add(&enumFileInfo, entrySize == 0 ? 0xFFFFFFFF : current_item_offset);
+			current_item_offset += entrySize;
 		}
 		platform_enumerate_files_end(enumFileHandle);
 	}
 
+	memtrack_free(oldList);
+	memtrack_free(oldIndex);
+
 	reset_loaded_objects();
 
 	object_list_cache_save(fileCount, totalFileSize, fileDateModifiedChecksum, current_item_offset);
@@ -326,6 +395,7 @@ static int object_list_cache_load(int totalFiles, uint64 totalFileSize, int file
 	if (fread(&pluginHeader, sizeof(rct_plugin_header), 1, file) == 1) {
 		// Check if object repository has changed in anyway
 		if (
+			pluginHeader.version == OBJECT_LIST_CACHE_VERSION &&
 			pluginHeader.total_files == totalFiles &&
 			pluginHeader.total_file_size == totalFileSize &&
 			pluginHeader.date_modified_checksum == fileDateModifiedChecksum
@@ -366,6 +436,7 @@ static int object_list_cache_save(int fileCount, uint64 totalFileSize, int fileD
 	
 	log_verbose("saving object list cache (plugin.dat)");
 
+	pluginHeader.version = OBJECT_LIST_CACHE_VERSION;
 	pluginHeader.total_files = fileCount | 0x01000000;
 	pluginHeader.total_file_size = (uint32)totalFileSize;
 	pluginHeader.date_modified_checksum = fileDateModifiedChecksum;
@@ -381,10 +452,105 @@ static int object_list_cache_save(int fileCount, uint64 totalFileSize, int fileD
 
 	fwrite(&pluginHeader, sizeof(rct_plugin_header), 1, file);
 	fwrite(RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, uint8*), pluginHeader.object_list_size, 1, file);
+	fwrite(&_objectFileIndexCount, sizeof(uint32), 1, file);
+	if (_objectFileIndexCount > 0)
+		fwrite(_objectFileIndex, sizeof(rct_object_index_entry), _objectFileIndexCount, file);
 	fclose(file);
 	return 1;
 }
 
+/**
+ * Reads plugin.dat back in even though the object directory no longer matches
+ * it, so that the rescan can copy entries for files that have not changed.
+ * Returns 1 on success; the caller owns the returned buffers.
+ */
+static int object_list_cache_load_stale(uint8 **outList, uint32 *outListSize, rct_object_index_entry **outIndex, uint32 *outIndexCount)
+{
+	char path[MAX_PATH];
+	FILE *file;
+	rct_plugin_header pluginHeader;
+	uint8 *list;
+	rct_object_index_entry *index;
+	uint32 indexCount;
+
+	get_plugin_path(path);
+	file = fopen(path, "rb");
+	if (file == NULL)
+		return 0;
+
+	if (fread(&pluginHeader, sizeof(rct_plugin_header), 1, file) != 1 || pluginHeader.version != OBJECT_LIST_CACHE_VERSION) {
+		fclose(file);
+		return 0;
+	}
+
+	list = memtrack_alloc(MEMTRACK_TAG_OBJECTS, pluginHeader.object_list_size);
+	if (fread(list, pluginHeader.object_list_size, 1, file) != 1) {
+		memtrack_free(list);
+		fclose(file);
+		return 0;
+	}
+
+	if (fread(&indexCount, sizeof(uint32), 1, file) != 1 || indexCount == 0) {
+		memtrack_free(list);
+		fclose(file);
+		return 0;
+	}
+
+	index = memtrack_alloc(MEMTRACK_TAG_OBJECTS, indexCount * sizeof(rct_object_index_entry));
+	if (fread(index, sizeof(rct_object_index_entry), indexCount, file) != indexCount) {
+		memtrack_free(list);
+		memtrack_free(index);
+		fclose(file);
+		return 0;
+	}
+
+	fclose(file);
+	*outList = list;
+	*outListSize = pluginHeader.object_list_size;
+	*outIndex = index;
+	*outIndexCount = indexCount;
+	return 1;
+}
+
+static void object_file_index_add(const file_info *fileInfo, uint32 entryOffset)
+{
+	rct_object_index_entry *indexEntry;
+
+	if (_objectFileIndexCount == _objectFileIndexCapacity) {
+		_objectFileIndexCapacity = max(256, _objectFileIndexCapacity * 2);
+		_objectFileIndex = memtrack_realloc(MEMTRACK_TAG_OBJECTS, _objectFileIndex, _objectFileIndexCapacity * sizeof(rct_object_index_entry));
+	}
+
+	indexEntry = &_objectFileIndex[_objectFileIndexCount++];
+	memset(indexEntry, 0, sizeof(rct_object_index_entry));
+	indexEntry->last_modified = fileInfo->last_modified;
+	indexEntry->size = (uint32)fileInfo->size;
+	indexEntry->entry_offset = entryOffset;
+	strncpy(indexEntry->path, fileInfo->path, MAX_PATH - 1);
+}
+
+/**
+ * Looks a file up in the stale cache index. Returns its installed object
+ * entry if the file's size and modified date are unchanged, otherwise NULL.
+ */
+static rct_object_entry *object_file_index_find_unchanged(uint8 *oldList, uint32 oldListSize, rct_object_index_entry *oldIndex, uint32 oldIndexCount, const file_info *fileInfo)
+{
+	uint32 i;
+	rct_object_index_entry *indexEntry;
+
+	for (i = 0; i < oldIndexCount; i++) {
+		indexEntry = &oldIndex[i];
+		if (_stricmp(indexEntry->path, fileInfo->path) != 0)
+			continue;
+		if (indexEntry->last_modified != fileInfo->last_modified || indexEntry->size != (uint32)fileInfo->size)
+			return NULL;
+		if (indexEntry->entry_offset == 0xFFFFFFFF || indexEntry->entry_offset >= oldListSize)
+			return NULL;
+		return (rct_object_entry*)(oldList + indexEntry->entry_offset);
+	}
+	return NULL;
+}
+
 static int check_object_entry(rct_object_entry *entry)
 {
 	uint32 *dwords = (uint32*)entry;
@@ -428,18 +594,69 @@ void set_load_objects_fail_reason(){
  * 
  *  rct2: 0x006AA0C6
  */
-int object_read_and_load_entries(FILE *file)
+int object_read_and_load_entries(sawyercoding_reader *reader)
 {
-	object_unload_all();
+	rct_object_entry *entries;
+	int result;
 
-	int i, j;
+	// Read all the object entries
+	entries = malloc(OBJECT_ENTRY_COUNT * sizeof(rct_object_entry));
+	sawyercoding_reader_read_chunk(reader, (uint8*)entries);
+
+	result = object_load_entries(entries);
+	free(entries);
+	return result;
+}
+
+// Context for reading and decoding the object files of a saved game's entry
+// table on the worker pool, ahead of the serial commit in object_load_entries
+typedef struct {
 	rct_object_entry *entries;
+	rct_object_entry *installedObjects[OBJECT_ENTRY_COUNT];
+	rct_object_entry openedEntries[OBJECT_ENTRY_COUNT];
+	uint8 *chunks[OBJECT_ENTRY_COUNT];
+	int chunkSizes[OBJECT_ENTRY_COUNT];
+} object_load_entries_context;
+
+static void object_load_entries_job(void *context, int index)
+{
+	object_load_entries_context *ctx = (object_load_entries_context*)context;
+
+	if (ctx->installedObjects[index] == NULL)
+		return;
+
+	// Leaves chunks[index] NULL on failure so the serial loop below retries
+	// the entry on the plain path, setting the error state in entry order
+	object_read_file(
+		&ctx->entries[index], ctx->installedObjects[index],
+		&ctx->openedEntries[index], &ctx->chunks[index], &ctx->chunkSizes[index]
+	);
+}
+
+/**
+ * Loads every object named in a saved game's entry table, one entry per
+ * object slot with unused slots zeroed.
+ */
+int object_load_entries(rct_object_entry *entries)
+{
+	int i, j;
+	object_load_entries_context *ctx = NULL;
+
+	object_unload_all();
 
 	log_verbose("loading required objects");
 
-	// Read all the object entries
-	entries = malloc(OBJECT_ENTRY_COUNT * sizeof(rct_object_entry));
-	sawyercoding_read_chunk(file, (uint8*)entries);
+	// Read, decode and checksum the object files concurrently, then commit
+	// them into the object lists and image table serially in entry order so
+	// the result is identical to a serial load
+	if (worker_pool_get_thread_count() > 0) {
+		ctx = calloc(1, sizeof(object_load_entries_context));
+		ctx->entries = entries;
+		for (i = 0; i < OBJECT_ENTRY_COUNT; i++)
+			if (check_object_entry(&entries[i]))
+				ctx->installedObjects[i] = object_list_find(&entries[i]);
+		worker_pool_run(object_load_entries_job, ctx, OBJECT_ENTRY_COUNT);
+	}
 
 	uint8 load_fail = 0;
 	// Load each object
@@ -456,14 +673,27 @@ int object_read_and_load_entries(FILE *file)
 		}
 
 		// Load the obect
-		if (!object_load(entryGroupIndex, &entries[i], NULL)) {
+		int loaded;
+		if (ctx != NULL && ctx->chunks[i] != NULL) {
+			// Copy the decoded data onto the RCT2 heap and install it
+			uint8 *chunk = rct2_malloc(ctx->chunkSizes[i]);
+			memcpy(chunk, ctx->chunks[i], ctx->chunkSizes[i]);
+			free(ctx->chunks[i]);
+			ctx->chunks[i] = NULL;
+			RCT2_GLOBAL(0xF42B64, uint32) = entryGroupIndex;
+			loaded = object_load_from_chunk(entryGroupIndex, &ctx->openedEntries[i], chunk, ctx->chunkSizes[i]);
+		} else {
+			loaded = object_load(entryGroupIndex, &entries[i], NULL);
+		}
+		if (!loaded) {
 			log_error("failed to load entry: %.8s", entries[i].name);
 			memcpy((char*)0x13CE952, &entries[i], sizeof(rct_object_entry));
 			load_fail = 1;
 		}
 	}
 
-	free(entries);	
+	free(ctx);
+
 	if (load_fail){
 		object_unload_all();
 		RCT2_GLOBAL(0x14241BC, uint32) = 0;
@@ -474,7 +704,107 @@ int object_read_and_load_entries(FILE *file)
 	return 1;
 }
 
+/**
+ * Writes the object data for every object named in a scenario's entry table
+ * to a bundle file, in entry table order. Each object is written as its
+ * directory entry followed by an encoded chunk, the same shape as an object
+ * file, and is checksum verified on the way through. Returns the number of
+ * objects written, or -1 if an object is missing from the installed library.
+ */
+int object_write_bundled_entries(FILE *file, rct_object_entry *entries)
+{
+	rct_object_entry *installedObject;
+	rct_object_entry openedEntry;
+	sawyercoding_chunk_header chunkHeader;
+	uint8 *chunk, *encodeBuffer;
+	int i, chunkSize, encodedSize, numObjects = 0;
+
+	encodeBuffer = malloc(0x600000);
+	for (i = 0; i < OBJECT_ENTRY_COUNT; i++) {
+		if (!check_object_entry(&entries[i]))
+			continue;
+
+		installedObject = object_list_find(&entries[i]);
+		if (installedObject == NULL) {
+			log_error("object not installed: %.8s", entries[i].name);
+			free(encodeBuffer);
+			return -1;
+		}
+		if (!object_read_file(&entries[i], installedObject, &openedEntry, &chunk, &chunkSize)) {
+			log_error("failed to read object: %.8s", entries[i].name);
+			free(encodeBuffer);
+			return -1;
+		}
+
+		chunkHeader.encoding = object_entry_group_encoding[openedEntry.flags & 0x0F];
+		chunkHeader.length = chunkSize;
+		encodedSize = sawyercoding_write_chunk_buffer(encodeBuffer, chunk, chunkHeader);
+		free(chunk);
 
+		fwrite(&openedEntry, sizeof(rct_object_entry), 1, file);
+		fwrite(encodeBuffer, 1, encodedSize, file);
+		numObjects++;
+	}
+	free(encodeBuffer);
+	return numObjects;
+}
+
+/**
+ * Loads every object named in a bundled scenario's entry table straight from
+ * the bundle's own object section, so nothing is resolved against the
+ * installed object library and no further files are opened. The reader is
+ * positioned at the first bundled object; the objects were written in entry
+ * table order at export, which keeps the image table identical to a library
+ * load. Chunk checksums were verified when the bundle was exported, so only
+ * the paint test runs here.
+ */
+int object_load_bundled_entries(sawyercoding_reader *reader, rct_object_entry *entries, int numObjects)
+{
+	rct_object_entry openedEntry;
+	int i, j, objectIndex = 0;
+
+	object_unload_all();
+
+	log_verbose("loading bundled objects");
+
+	for (i = 0; i < OBJECT_ENTRY_COUNT; i++) {
+		if (!check_object_entry(&entries[i]))
+			continue;
+
+		if (objectIndex++ >= numObjects
+			|| !sawyercoding_reader_read(reader, &openedEntry, sizeof(rct_object_entry))
+			|| !object_entry_compare(&openedEntry, &entries[i])
+		) {
+			log_error("bundled object data does not match the entry table");
+			object_unload_all();
+			return 0;
+		}
+
+		uint8 *chunk = rct2_malloc(0x600000);
+		int chunkSize = sawyercoding_reader_read_chunk(reader, chunk);
+		chunk = rct2_realloc(chunk, chunkSize);
+
+		// Get entry group index
+		int entryGroupIndex = i;
+		for (j = 0; j < countof(object_entry_group_counts); j++) {
+			if (entryGroupIndex < object_entry_group_counts[j])
+				break;
+			entryGroupIndex -= object_entry_group_counts[j];
+		}
+
+		RCT2_GLOBAL(0xF42B64, uint32) = entryGroupIndex;
+		if (!object_load_from_chunk(entryGroupIndex, &openedEntry, chunk, chunkSize)) {
+			log_error("failed to load bundled entry: %.8s", openedEntry.name);
+			memcpy((char*)0x13CE952, &entries[i], sizeof(rct_object_entry));
+			object_unload_all();
+			RCT2_GLOBAL(0x14241BC, uint32) = 0;
+			return 0;
+		}
+	}
+
+	log_verbose("finished loading bundled objects");
+	return 1;
+}
 
 /**
  * 
@@ -494,6 +824,103 @@ void object_unload_all()
 
 
 
+#pragma region Object name search index
+
+// Lowercase name index over the installed object list, partitioned by object
+// type. The editor object selection window iterates and text searches one
+// object type at a time; the index lets it do that directly instead of
+// walking every variable length entry in the list and lowercasing names per
+// comparison. Rebuilt together with the hash table after every repository
+// scan.
+static rct_object_name_index_entry *_objectNameIndex = NULL;
+static int _objectNameIndexStart[OBJECT_ENTRY_GROUP_COUNT + 1];
+
+static void object_list_create_name_index()
+{
+	rct_object_entry *entry;
+	rct_object_name_index_entry *indexEntry;
+	int i, j, objectType, numObjects, countByType[OBJECT_ENTRY_GROUP_COUNT];
+	char *name;
+
+	numObjects = RCT2_GLOBAL(RCT2_ADDRESS_OBJECT_LIST_NO_ITEMS, sint32);
+
+	if (_objectNameIndex != NULL)
+		free(_objectNameIndex);
+	_objectNameIndex = calloc(numObjects, sizeof(rct_object_name_index_entry));
+
+	// Count the objects of each type, then turn the counts into partition
+	// bounds
+	memset(countByType, 0, sizeof(countByType));
+	entry = RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, rct_object_entry*);
+	for (i = 0; i < numObjects; i++) {
+		countByType[entry->flags & 0x0F]++;
+		entry = object_get_next(entry);
+	}
+	_objectNameIndexStart[0] = 0;
+	for (i = 0; i < OBJECT_ENTRY_GROUP_COUNT; i++)
+		_objectNameIndexStart[i + 1] = _objectNameIndexStart[i] + countByType[i];
+
+	// Fill the partitions, preserving the sorted list order within each
+	memset(countByType, 0, sizeof(countByType));
+	entry = RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, rct_object_entry*);
+	for (i = 0; i < numObjects; i++) {
+		objectType = entry->flags & 0x0F;
+		indexEntry = &_objectNameIndex[_objectNameIndexStart[objectType] + countByType[objectType]];
+		countByType[objectType]++;
+
+		indexEntry->entry = entry;
+		indexEntry->flagsIndex = i;
+		name = object_get_name(entry);
+		for (j = 0; j < (int)sizeof(indexEntry->name) - 1 && name[j] != 0; j++)
+			indexEntry->name[j] = tolower(name[j]);
+		indexEntry->name[j] = 0;
+
+		entry = object_get_next(entry);
+	}
+}
+
+/**
+ * Returns the number of installed objects of the given type and points
+ * outEntries at their partition of the name index.
+ */
+int object_name_index_get(int objectType, rct_object_name_index_entry **outEntries)
+{
+	if (_objectNameIndex == NULL)
+		return 0;
+
+	*outEntries = &_objectNameIndex[_objectNameIndexStart[objectType]];
+	return _objectNameIndexStart[objectType + 1] - _objectNameIndexStart[objectType];
+}
+
+/**
+ * Finds the objects of the given type whose name contains the query, case
+ * insensitively. Writes their indices within the type's partition to
+ * outIndices and returns how many matched.
+ */
+int object_name_index_search(int objectType, const char *query, int *outIndices, int maxResults)
+{
+	rct_object_name_index_entry *entries;
+	char lowerQuery[80];
+	int i, numEntries, numResults;
+
+	numEntries = object_name_index_get(objectType, &entries);
+	if (numEntries == 0)
+		return 0;
+
+	for (i = 0; i < (int)sizeof(lowerQuery) - 1 && query[i] != 0; i++)
+		lowerQuery[i] = tolower(query[i]);
+	lowerQuery[i] = 0;
+
+	numResults = 0;
+	for (i = 0; i < numEntries && numResults < maxResults; i++)
+		if (strstr(entries[i].name, lowerQuery) != NULL)
+			outIndices[numResults++] = i;
+
+	return numResults;
+}
+
+#pragma endregion
+
 uint32 _installedObjectHashTableSize;
 rct_object_entry ** _installedObjectHashTable = NULL;
 uint32 _installedObjectHashTableCollisions;
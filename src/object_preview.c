@@ -0,0 +1,173 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "addresses.h"
+#include "object_preview.h"
+#include "util/memtrack.h"
+
+// Rendered object previews for the selection windows. The preview used to be
+// rasterized from the object's freshly loaded images on every window paint
+// while an entry was highlighted; it is now drawn once into an offscreen
+// buffer and blitted on later paints. The cache is keyed by object entry and
+// bounded, recycling the least recently used slot once full, so browsing
+// back and forth over the same objects stays cheap.
+#define OBJECT_PREVIEW_SIZE 112
+#define OBJECT_PREVIEW_CACHE_CAPACITY 64
+
+typedef struct {
+	rct_object_entry entry;
+	uint8 *bits;
+	uint32 lastUsed;
+} object_preview_slot;
+
+static object_preview_slot _previewSlots[OBJECT_PREVIEW_CACHE_CAPACITY];
+static uint32 _previewUseCounter = 0;
+
+static object_preview_slot *object_preview_find(rct_object_entry *entry)
+{
+	object_preview_slot *slot;
+	int i;
+
+	for (i = 0; i < OBJECT_PREVIEW_CACHE_CAPACITY; i++) {
+		slot = &_previewSlots[i];
+		if (slot->bits != NULL && object_entry_compare(&slot->entry, entry))
+			return slot;
+	}
+	return NULL;
+}
+
+static object_preview_slot *object_preview_acquire()
+{
+	object_preview_slot *slot, *oldest;
+	int i;
+
+	oldest = &_previewSlots[0];
+	for (i = 0; i < OBJECT_PREVIEW_CACHE_CAPACITY; i++) {
+		slot = &_previewSlots[i];
+		if (slot->bits == NULL) {
+			slot->bits = memtrack_alloc(MEMTRACK_TAG_WINDOWS, OBJECT_PREVIEW_SIZE * OBJECT_PREVIEW_SIZE);
+			return slot;
+		}
+		if (slot->lastUsed < oldest->lastUsed)
+			oldest = slot;
+	}
+	return oldest;
+}
+
+static void object_preview_render(object_preview_slot *slot, rct_object_entry *entry, int type, void *stexEntry)
+{
+	rct_drawpixelinfo previewDpi;
+
+	// Pixel 0 is left as transparent so the blit composes over whatever
+	// background the window painted
+	memset(slot->bits, 0, OBJECT_PREVIEW_SIZE * OBJECT_PREVIEW_SIZE);
+
+	previewDpi.bits = (char*)slot->bits;
+	previewDpi.x = 0;
+	previewDpi.y = 0;
+	previewDpi.width = OBJECT_PREVIEW_SIZE;
+	previewDpi.height = OBJECT_PREVIEW_SIZE;
+	previewDpi.pitch = 0;
+	previewDpi.zoom_level = 0;
+
+	object_paint(type, 3, type, OBJECT_PREVIEW_SIZE / 2, OBJECT_PREVIEW_SIZE / 2, 0, (int)&previewDpi, (int)stexEntry);
+
+	slot->entry = *entry;
+}
+
+static void object_preview_blit(object_preview_slot *slot, rct_drawpixelinfo *dpi, int x, int y)
+{
+	uint8 *source, *dest;
+	int left, top, right, bottom, sourceX, sourceY, width, height, i, j;
+
+	left = x - OBJECT_PREVIEW_SIZE / 2;
+	top = y - OBJECT_PREVIEW_SIZE / 2;
+	right = left + OBJECT_PREVIEW_SIZE;
+	bottom = top + OBJECT_PREVIEW_SIZE;
+
+	sourceX = 0;
+	sourceY = 0;
+	if (left < dpi->x) {
+		sourceX = dpi->x - left;
+		left = dpi->x;
+	}
+	if (top < dpi->y) {
+		sourceY = dpi->y - top;
+		top = dpi->y;
+	}
+	if (right > dpi->x + dpi->width)
+		right = dpi->x + dpi->width;
+	if (bottom > dpi->y + dpi->height)
+		bottom = dpi->y + dpi->height;
+
+	width = right - left;
+	height = bottom - top;
+	if (width <= 0 || height <= 0)
+		return;
+
+	source = slot->bits + (sourceY * OBJECT_PREVIEW_SIZE) + sourceX;
+	dest = (uint8*)dpi->bits + ((top - dpi->y) * (dpi->width + dpi->pitch)) + (left - dpi->x);
+	for (i = 0; i < height; i++) {
+		for (j = 0; j < width; j++) {
+			if (source[j] != 0)
+				dest[j] = source[j];
+		}
+		source += OBJECT_PREVIEW_SIZE;
+		dest += dpi->width + dpi->pitch;
+	}
+}
+
+/**
+ * Draws the preview of the given object centred on x, y, rendering it into
+ * the cache first if this is the first time it is shown. stexEntry is the
+ * loaded temporary chunk the preview paint functions read from, as passed to
+ * object_paint.
+ */
+void object_preview_paint(rct_object_entry *entry, int type, void *stexEntry, rct_drawpixelinfo *dpi, int x, int y)
+{
+	object_preview_slot *slot;
+
+	slot = object_preview_find(entry);
+	if (slot == NULL) {
+		slot = object_preview_acquire();
+		object_preview_render(slot, entry, type, stexEntry);
+	}
+	slot->lastUsed = ++_previewUseCounter;
+
+	object_preview_blit(slot, dpi, x, y);
+}
+
+/**
+ * Drops every cached preview. Called when the installed object list is
+ * rebuilt, after which an entry may refer to different object data.
+ */
+void object_preview_cache_invalidate()
+{
+	int i;
+
+	for (i = 0; i < OBJECT_PREVIEW_CACHE_CAPACITY; i++) {
+		if (_previewSlots[i].bits != NULL) {
+			memtrack_free(_previewSlots[i].bits);
+			_previewSlots[i].bits = NULL;
+		}
+		_previewSlots[i].lastUsed = 0;
+	}
+	_previewUseCounter = 0;
+}
@@ -21,22 +21,43 @@
 #include "addresses.h"
 #include "audio/audio.h"
 #include "audio/mixer.h"
+#include "checkpoint.h"
 #include "cmdline.h"
 #include "config.h"
+#include "cpu.h"
+#include "drawing/drawing.h"
 #include "editor.h"
+#include "game.h"
+#include "interface/paintheatmap.h"
+#include "interface/profiler.h"
+#include "interface/rendergovernor.h"
+#include "interface/screenshot.h"
 #include "localisation/localisation.h"
 #include "openrct2.h"
+#include "perfcounters.h"
 #include "platform/platform.h"
+#include "scenario.h"
 #include "util/sawyercoding.h"
+#include "util/workerpool.h"
 #include "world/mapgen.h"
 
 int gOpenRCT2StartupAction = STARTUP_ACTION_TITLE;
 char gOpenRCT2StartupActionPath[512] = { 0 };
+int gOpenRCT2Headless = 0;
+int gOpenRCT2BenchmarkTicks = 4096;
+int gOpenRCT2ScreenshotZoom = 0;
+char gOpenRCT2BundleOutputPath[512] = { 0 };
+char gOpenRCT2RecordPath[512] = { 0 };
+char gOpenRCT2ReplayPath[512] = { 0 };
+int gRenderIdle = 0;
 
 /** If set, will end the OpenRCT2 game loop. Intentially private to this module so that the flag can not be set back to 0. */
 int _finished;
 
 static void openrct2_loop();
+static void openrct2_benchmark();
+static void openrct2_benchgfx();
+static void openrct2_giant_screenshot();
 
 static void openrct2_copy_files_over(const char *originalDirectory, const char *newDirectory, const char *extension)
 {
@@ -146,7 +167,11 @@ void openrct2_launch()
 
 	openrct2_copy_original_user_files_over();
 
+	cpu_initialise();
 	Mixer_Init(NULL);
+	worker_pool_initialise(0);
+	diagnostic_log_init();
+	perfcounters_init();
 
 	switch (gOpenRCT2StartupAction) {
 	case STARTUP_ACTION_INTRO:
@@ -154,7 +179,12 @@ void openrct2_launch()
 		break;
 	case STARTUP_ACTION_TITLE:
 		RCT2_GLOBAL(RCT2_ADDRESS_RUN_INTRO_TICK_PART, uint8) = 0;
-		RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) = SCREEN_FLAGS_TITLE_DEMO;
+		// Resume straight into the park if the previous session crashed with
+		// checkpoints enabled, otherwise fall through to the title screen
+		if (checkpoint_resume())
+			RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) = SCREEN_FLAGS_PLAYING;
+		else
+			RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) = SCREEN_FLAGS_TITLE_DEMO;
 		break;
 	case STARTUP_ACTION_OPEN:
 		assert(gOpenRCT2StartupActionPath != NULL);
@@ -170,10 +200,40 @@ void openrct2_launch()
 			editor_load_landscape(gOpenRCT2StartupActionPath);
 		}
 		break;
+	case STARTUP_ACTION_BENCHMARK:
+	case STARTUP_ACTION_SCREENSHOT:
+		rct2_open_file(gOpenRCT2StartupActionPath);
+
+		RCT2_GLOBAL(RCT2_ADDRESS_RUN_INTRO_TICK_PART, uint8) = 0;
+		RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) = SCREEN_FLAGS_PLAYING;
+		break;
 	}
 
-	log_verbose("begin openrct2 loop");
-	openrct2_loop();
+	if (strlen(gOpenRCT2RecordPath) != 0 && !game_command_record_begin(gOpenRCT2RecordPath))
+		log_error("Unable to record game commands to %s", gOpenRCT2RecordPath);
+	if (strlen(gOpenRCT2ReplayPath) != 0 && !game_command_replay_begin(gOpenRCT2ReplayPath))
+		log_error("Unable to replay game commands from %s", gOpenRCT2ReplayPath);
+
+	if (gOpenRCT2StartupAction == STARTUP_ACTION_BUNDLE) {
+		if (!scenario_bundle_export(gOpenRCT2StartupActionPath, gOpenRCT2BundleOutputPath))
+			gExitCode = 1;
+	} else if (gOpenRCT2StartupAction == STARTUP_ACTION_BENCHMARK) {
+		openrct2_benchmark();
+	} else if (gOpenRCT2StartupAction == STARTUP_ACTION_BENCHGFX) {
+		openrct2_benchgfx();
+	} else if (gOpenRCT2StartupAction == STARTUP_ACTION_SCREENSHOT) {
+		openrct2_giant_screenshot();
+	} else {
+		log_verbose("begin openrct2 loop");
+		openrct2_loop();
+	}
+	game_command_record_end();
+	game_command_replay_end();
+	checkpoint_session_end();
+	screenshot_writer_dispose();
+	perfcounters_dispose();
+	worker_pool_dispose();
+	diagnostic_log_dispose();
 	platform_free();
 
 	// HACK Some threads are still running which causes the game to not terminate. Investigation required!
@@ -181,27 +241,97 @@ void openrct2_launch()
 }
 
 /**
- * Run the main game loop until the finished flag is set at 40fps (25ms interval).
+ * Waits until the performance counter reaches target. SDL_Delay only promises
+ * millisecond granularity (and often worse), so the wait sleeps in 1ms steps
+ * while more than two milliseconds remain and spins the rest, which lands
+ * within a few microseconds of the target without burning a whole core.
+ * Returns the counter value when the wait ended.
+ */
+static uint64 openrct2_wait_until(uint64 target, uint64 frequency)
+{
+	uint64 now, spinThreshold;
+
+	spinThreshold = (frequency * 2) / 1000;
+	now = SDL_GetPerformanceCounter();
+	while (now < target) {
+		if (target - now > spinThreshold)
+			SDL_Delay(1);
+		now = SDL_GetPerformanceCounter();
+	}
+	return now;
+}
+
+/**
+ * Run the main game loop until the finished flag is set. Game logic runs at
+ * the fixed 40fps rate (25ms interval), but messages are processed and the
+ * screen is presented on every pass so redraws requested between logic ticks
+ * (window moves, resizes, invalidations) are not held back for the next tick.
+ *
+ * Draw passes are paced against an absolute schedule on the performance
+ * counter rather than a relative SDL_Delay: each pass targets the previous
+ * target plus the interval, so sleep overshoot on one frame is taken out of
+ * the next instead of accumulating, and delivery stays even against the
+ * display refresh. If a pass overruns its whole slot the schedule resnaps to
+ * now rather than bursting to catch up.
  */
 static void openrct2_loop()
 {
 	uint32 currentTick, ticksElapsed, lastTick = 0;
+	uint64 frequency, interval, idleInterval, nextFrame, waitStart, now;
+
+	frequency = SDL_GetPerformanceFrequency();
+	interval = frequency / 125;
+	idleInterval = frequency / 10;
+	nextFrame = SDL_GetPerformanceCounter() + interval;
 
 	_finished = 0;
 	do {
 		currentTick = SDL_GetTicks();
+		platform_process_messages();
+		worker_pool_pump();
+
 		ticksElapsed = currentTick - lastTick;
-		if (ticksElapsed < 25) {
-			if (ticksElapsed < 15)
-				SDL_Delay(15 - ticksElapsed);
-			continue;
+		if (ticksElapsed >= 25) {
+			lastTick = currentTick;
+
+			profiler_frame_begin();
+			render_governor_frame_begin();
+			rct2_update();
+			profiler_update_done();
+			profiler_draw();
+			paint_heatmap_draw();
+			if (gfx_take_present_request())
+				platform_draw();
+			profiler_frame_end();
+			render_governor_frame_end();
+			Mixer_Update();
+			perfcounters_update();
+		} else {
+			// Between logic ticks nothing repaints the screen buffer, so a
+			// present is only needed when something else (a palette upload,
+			// a window expose) requested one
+			if (gfx_take_present_request())
+				platform_draw();
 		}
 
-		lastTick = currentTick;
+		// Idle render mode: the game is paused and no input has arrived for
+		// a couple of seconds, so the pacing floor drops and the palette
+		// effects freeze (game.c skips them while gRenderIdle is set, which
+		// is what lets the presents stop on parks with water). The first
+		// event after ends the idle cadence, at worst one widened interval
+		// late.
+		gRenderIdle = RCT2_GLOBAL(RCT2_ADDRESS_GAME_PAUSED, uint8) != 0 &&
+			RCT2_GLOBAL(RCT2_ADDRESS_RUN_INTRO_TICK_PART, uint8) == 0 &&
+			currentTick - platform_get_last_input_tick() > 2000;
 
-		platform_process_messages();
-		rct2_update();
-		platform_draw();
+		// Idle until the next draw pass is due
+		waitStart = SDL_GetPerformanceCounter();
+		now = openrct2_wait_until(nextFrame, frequency);
+		profiler_pacing_report(now - waitStart, (sint64)(now - nextFrame));
+
+		nextFrame += gRenderIdle ? idleInterval : interval;
+		if (now > nextFrame)
+			nextFrame = now + (gRenderIdle ? idleInterval : interval);
 	} while (!_finished);
 }
 
@@ -211,4 +341,71 @@ static void openrct2_loop()
 void openrct2_finish()
 {
 	_finished = 1;
+}
+
+/**
+ * Runs the loaded park for the requested number of ticks flat-out with no
+ * drawing or frame pacing and reports ticks per second along with the time
+ * spent in each game logic phase.
+ */
+static void openrct2_benchmark()
+{
+	uint64 start, end, frequency;
+	double seconds, totalPhaseTime;
+	int i, ticks;
+
+	ticks = gOpenRCT2BenchmarkTicks;
+	printf("Benchmarking %d ticks of %s\n", ticks, gOpenRCT2StartupActionPath);
+
+	memset(gGameLogicPhaseTime, 0, sizeof(gGameLogicPhaseTime));
+	gGameLogicPhaseTicks = 0;
+
+	frequency = SDL_GetPerformanceFrequency();
+	start = SDL_GetPerformanceCounter();
+	for (i = 0; i < ticks; i++)
+		game_logic_update();
+	end = SDL_GetPerformanceCounter();
+
+	seconds = (double)(end - start) / frequency;
+	printf("%d ticks in %.3f seconds (%.1f ticks/sec)\n", ticks, seconds, ticks / seconds);
+
+	totalPhaseTime = 0;
+	for (i = 0; i < GAME_LOGIC_PHASE_COUNT; i++)
+		totalPhaseTime += (double)gGameLogicPhaseTime[i];
+	for (i = 0; i < GAME_LOGIC_PHASE_COUNT; i++) {
+		double phaseSeconds = (double)gGameLogicPhaseTime[i] / frequency;
+		printf("  %-8s %8.3f ms/tick  %5.1f%%\n",
+			gGameLogicPhaseNames[i],
+			phaseSeconds * 1000.0 / ticks,
+			totalPhaseTime == 0 ? 0 : (double)gGameLogicPhaseTime[i] * 100.0 / totalPhaseTime
+		);
+	}
+}
+
+/**
+ * Runs the drawing path micro-benchmarks and exits. No park is loaded; the
+ * workloads only need the g1 data that rct2_init brings in.
+ */
+static void openrct2_benchgfx()
+{
+	printf("Benchmarking drawing paths\n");
+	gfx_benchmark();
+}
+
+/**
+ * Renders the loaded park as a single giant screenshot and exits.
+ */
+static void openrct2_giant_screenshot()
+{
+	int index;
+
+	printf("Rendering giant screenshot of %s (zoom %d)\n", gOpenRCT2StartupActionPath, gOpenRCT2ScreenshotZoom);
+
+	index = screenshot_giant(gOpenRCT2ScreenshotZoom);
+	if (index == -1) {
+		fprintf(stderr, "Failed to render giant screenshot.\n");
+		gExitCode = 1;
+	} else {
+		printf("Saved giant screenshot as SCR%d.bmp\n", index);
+	}
 }
\ No newline at end of file
@@ -27,12 +27,38 @@ enum {
 	STARTUP_ACTION_INTRO,
 	STARTUP_ACTION_TITLE,
 	STARTUP_ACTION_OPEN,
-	STARTUP_ACTION_EDIT
+	STARTUP_ACTION_EDIT,
+	STARTUP_ACTION_BENCHMARK,
+	STARTUP_ACTION_BENCHGFX,
+	STARTUP_ACTION_SCREENSHOT,
+	STARTUP_ACTION_BUNDLE
 };
 
 extern int gOpenRCT2StartupAction;
 extern char gOpenRCT2StartupActionPath[512];
 
+// Hides the game window and suppresses drawing, for running the simulation
+// on its own (e.g. the tick benchmark or fast-forwarding a park)
+extern int gOpenRCT2Headless;
+
+// Number of ticks to run for the benchmark startup action
+extern int gOpenRCT2BenchmarkTicks;
+
+// Zoom level for the giant screenshot startup action
+extern int gOpenRCT2ScreenshotZoom;
+
+// Output path for the scenario bundle startup action
+extern char gOpenRCT2BundleOutputPath[512];
+
+// Paths of the game command log to record to / replay from, empty when
+// recording or replaying is not requested
+extern char gOpenRCT2RecordPath[512];
+extern char gOpenRCT2ReplayPath[512];
+
+// Set by the main loop while the game is paused with no recent input; render
+// work collapses to event driven repaints at a reduced pass rate
+extern int gRenderIdle;
+
 void openrct2_launch();
 void openrct2_finish();
 
@@ -0,0 +1,243 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "addresses.h"
+#include "editor.h"
+#include "game.h"
+#include "game_state.h"
+#include "localisation/localisation.h"
+#include "management/finance.h"
+#include "object.h"
+#include "park_instance.h"
+#include "peep/peep.h"
+#include "peep/staff.h"
+#include "ride/ride_stats.h"
+#include "ride/station.h"
+#include "scenario.h"
+#include "world/map.h"
+#include "world/park.h"
+#include "world/sprite.h"
+
+// Multiple resident park instances in one process. The simulation still runs
+// against the original executable's data segment, so parks cannot tick
+// concurrently on worker threads until the game_state migration covers the
+// whole simulation; instead each inactive park is kept resident as a copy of
+// the saved game state span and background parks are time sliced on the game
+// thread: their span is swapped over the live state, ticked headless for
+// their configured budget, then swapped back out. The object library, g1
+// data and decoded sprite caches are all shared, which is the per-process
+// memory the separate-process setup pays for today. Swapping parks whose
+// object entry tables differ reloads objects, so headless ticking is only
+// performed for parks whose table matches the loaded one.
+
+// Same state span the title park prefetch decodes into: 16 bytes of game
+// time then the map element chunk span, which also covers the game data
+// region, see scenario_save
+#define PARK_STATE_BASE 0x00F663A8
+#define PARK_STATE_SIZE (16 + 0x4A85EC)
+
+typedef struct {
+	int inUse;
+	int ticksPerFrame;
+	int objectsMismatchLogged;
+	rct_object_entry objects[721];
+	uint8 *state;
+} park_instance;
+
+static park_instance _parkInstances[PARK_INSTANCE_MAX_SLOTS];
+
+// Scratch span for exchanging the live state with a background park
+static uint8 *_swapState = NULL;
+
+int gParkInstanceHeadlessTick = 0;
+
+static void park_instance_capture(park_instance *instance)
+{
+	scenario_get_available_objects(instance->objects);
+	memcpy(instance->state, (void*)PARK_STATE_BASE, PARK_STATE_SIZE);
+}
+
+// Fixes up everything derived from the state span after another park's span
+// has been copied over it; the same set of fixups the loaders run
+static void park_instance_state_fixup()
+{
+	map_update_tile_pointers();
+	reset_0x69EBE4();
+	game_state_sync_from_legacy();
+	peep_thought_counters_invalidate();
+	staff_patrol_index_invalidate();
+	user_string_table_invalidate();
+	finance_history_invalidate();
+	editor_object_flags_invalidate();
+	ride_stats_invalidate();
+	ride_station_element_hints_invalidate();
+	ride_index_cache_invalidate();
+	park_size_invalidate();
+	park_appeal_invalidate();
+}
+
+static void park_instance_restore(park_instance *instance)
+{
+	memcpy((void*)PARK_STATE_BASE, instance->state, PARK_STATE_SIZE);
+	park_instance_state_fixup();
+}
+
+static int park_instance_objects_match(park_instance *instance)
+{
+	rct_object_entry loaded[721];
+
+	scenario_get_available_objects(loaded);
+	return memcmp(loaded, instance->objects, sizeof(loaded)) == 0;
+}
+
+/**
+ * Stores the live park into a free slot so another park can be loaded over
+ * it. Returns the slot index, or -1 if no slot or memory is available.
+ */
+int park_instance_store()
+{
+	park_instance *instance;
+	int i;
+
+	for (i = 0; i < PARK_INSTANCE_MAX_SLOTS; i++)
+		if (!_parkInstances[i].inUse)
+			break;
+	if (i == PARK_INSTANCE_MAX_SLOTS)
+		return -1;
+
+	instance = &_parkInstances[i];
+	if (instance->state == NULL) {
+		instance->state = malloc(PARK_STATE_SIZE);
+		if (instance->state == NULL)
+			return -1;
+	}
+
+	park_instance_capture(instance);
+	instance->inUse = 1;
+	instance->ticksPerFrame = 0;
+	instance->objectsMismatchLogged = 0;
+	return i;
+}
+
+/**
+ * Swaps the live park with the park in slot: the live state is captured into
+ * the slot and the slot's state becomes live, reloading objects if the two
+ * parks use different object sets. Returns 1 on success.
+ */
+int park_instance_switch(int slot)
+{
+	park_instance *instance = &_parkInstances[slot];
+	rct_object_entry liveObjects[721];
+	uint8 *liveState;
+	int reloadObjects;
+
+	if (!instance->inUse)
+		return 0;
+
+	liveState = malloc(PARK_STATE_SIZE);
+	if (liveState == NULL)
+		return 0;
+
+	reloadObjects = !park_instance_objects_match(instance);
+	if (reloadObjects && !object_load_entries(instance->objects)) {
+		free(liveState);
+		return 0;
+	}
+
+	scenario_get_available_objects(liveObjects);
+	memcpy(liveState, (void*)PARK_STATE_BASE, PARK_STATE_SIZE);
+
+	park_instance_restore(instance);
+
+	memcpy(instance->objects, liveObjects, sizeof(liveObjects));
+	memcpy(instance->state, liveState, PARK_STATE_SIZE);
+	instance->objectsMismatchLogged = 0;
+	free(liveState);
+
+	if (reloadObjects)
+		reset_loaded_objects();
+
+	game_load_init();
+	return 1;
+}
+
+void park_instance_discard(int slot)
+{
+	park_instance *instance = &_parkInstances[slot];
+
+	instance->inUse = 0;
+	instance->ticksPerFrame = 0;
+	SafeFree(instance->state);
+}
+
+/**
+ * Sets how many simulation ticks slot receives per rendered frame while it
+ * is in the background; 0 pauses it.
+ */
+void park_instance_set_headless_rate(int slot, int ticksPerFrame)
+{
+	_parkInstances[slot].ticksPerFrame = ticksPerFrame;
+}
+
+/**
+ * Gives every background park its tick budget for this frame. Called once
+ * per frame from game_update, after the active park has updated.
+ */
+void park_instance_update()
+{
+	park_instance *instance;
+	int i, tick;
+
+	for (i = 0; i < PARK_INSTANCE_MAX_SLOTS; i++) {
+		instance = &_parkInstances[i];
+		if (!instance->inUse || instance->ticksPerFrame <= 0)
+			continue;
+
+		// Reloading objects twice a frame is not viable; parks with a
+		// different object set only advance when made active
+		if (!park_instance_objects_match(instance)) {
+			if (!instance->objectsMismatchLogged) {
+				log_warning("park instance %d uses a different object set, not ticking it in the background", i);
+				instance->objectsMismatchLogged = 1;
+			}
+			continue;
+		}
+
+		if (_swapState == NULL) {
+			_swapState = malloc(PARK_STATE_SIZE);
+			if (_swapState == NULL)
+				return;
+		}
+
+		// Park the active state aside, tick the background park headless
+		// against the live span, then bring the active state back
+		memcpy(_swapState, (void*)PARK_STATE_BASE, PARK_STATE_SIZE);
+		park_instance_restore(instance);
+
+		gParkInstanceHeadlessTick = 1;
+		for (tick = 0; tick < instance->ticksPerFrame; tick++)
+			game_logic_update();
+		gParkInstanceHeadlessTick = 0;
+
+		memcpy(instance->state, (void*)PARK_STATE_BASE, PARK_STATE_SIZE);
+		memcpy((void*)PARK_STATE_BASE, _swapState, PARK_STATE_SIZE);
+		park_instance_state_fixup();
+	}
+}
@@ -0,0 +1,38 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _PARK_INSTANCE_H_
+#define _PARK_INSTANCE_H_
+
+#include "common.h"
+
+#define PARK_INSTANCE_MAX_SLOTS 4
+
+// Set while a background park is being ticked; game_logic_update skips the
+// player facing work (command queue, window updates) when it is up
+extern int gParkInstanceHeadlessTick;
+
+int park_instance_store();
+int park_instance_switch(int slot);
+void park_instance_discard(int slot);
+void park_instance_set_headless_rate(int slot, int ticksPerFrame);
+void park_instance_update();
+
+#endif
@@ -21,19 +21,24 @@
 #include "../addresses.h"
 #include "../audio/audio.h"
 #include "../audio/mixer.h"
+#include "../interface/viewport.h"
 #include "../interface/window.h"
 #include "../localisation/localisation.h"
 #include "../management/news_item.h"
 #include "../ride/ride.h"
+#include "../ride/ride_stats.h"
 #include "../scenario.h"
 #include "../sprites.h"
 #include "../world/sprite.h"
 #include "../world/scenery.h"
 #include "../management/marketing.h"
+#include "../util/workerpool.h"
 #include "peep.h"
 #include "staff.h"
 
 static void peep_update(rct_peep *peep);
+static bool peep_update_decide(rct_peep *peep, unsigned int *outStepsToTake);
+static void peep_update_commit(rct_peep *peep, unsigned int stepsToTake, bool runStateMachine);
 static int peep_has_empty_container(rct_peep* peep);
 static int peep_has_food_standard_flag(rct_peep* peep);
 static int peep_has_food_extra_flag(rct_peep* peep);
@@ -88,31 +93,277 @@ int peep_get_staff_count()
  *
  *  rct2: 0x0068F0A9
  */
-void peep_update_all()
+// One peep's slot in the phase separated tick, see peep_update_all
+typedef struct {
+	rct_peep *peep;
+	unsigned int stepsToTake;
+	bool runStateMachine;
+	bool fullUpdate;
+	uint8 thoughtBefore;
+	bool thoughtExcusedBefore;
+} peep_update_entry;
+
+static peep_update_entry _peepUpdateList[MAX_SPRITES];
+
+// Running tallies of guests in the park whose newest thought is still fresh
+// (var_2 <= 5), indexed by thought type. Maintained incrementally as peeps
+// tick so the weekly problem warnings and the monthly award checks do not
+// have to walk every guest. The excused tally is the subset already heading
+// to a ride which fixes the complaint (a food stall for hungry guests etc.),
+// which the problem warnings leave out of their counts.
+static uint16 _freshThoughtCounts[256];
+static uint16 _freshThoughtExcusedCounts[256];
+static bool _freshThoughtCountsValid = false;
+
+// Set while peep_update_all commits; the commit loop re-tallies each peep it
+// touches in bulk, so thought inserts from inside it must not adjust twice
+static bool _peepUpdateCommitting = false;
+
+// Returns the thought type the given peep currently contributes to the fresh
+// thought tallies, or PEEP_THOUGHT_TYPE_NONE if it contributes nothing
+static uint8 peep_fresh_thought_type(rct_peep *peep, bool *outExcused)
+{
+	rct_ride *ride;
+
+	*outExcused = false;
+	if (peep->type != PEEP_TYPE_GUEST || peep->var_2A != 0)
+		return PEEP_THOUGHT_TYPE_NONE;
+	if (peep->thoughts[0].type == PEEP_THOUGHT_TYPE_NONE || peep->thoughts[0].var_2 > 5)
+		return PEEP_THOUGHT_TYPE_NONE;
+
+	if (peep->guest_heading_to_ride_id != 255) {
+		ride = &g_ride_list[peep->guest_heading_to_ride_id];
+		switch (peep->thoughts[0].type) {
+		case PEEP_THOUGHT_TYPE_HUNGRY:
+			*outExcused = ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_SELLS_FOOD);
+			break;
+		case PEEP_THOUGHT_TYPE_THIRSTY:
+			*outExcused = ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_SELLS_DRINKS);
+			break;
+		case PEEP_THOUGHT_TYPE_BATHROOM:
+			*outExcused = ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_IS_BATHROOM);
+			break;
+		}
+	}
+	return peep->thoughts[0].type;
+}
+
+static void peep_fresh_thought_counts_apply(uint8 beforeType, bool beforeExcused, uint8 afterType, bool afterExcused)
+{
+	if (!_freshThoughtCountsValid)
+		return;
+	if (beforeType == afterType && beforeExcused == afterExcused)
+		return;
+
+	if (beforeType != PEEP_THOUGHT_TYPE_NONE) {
+		_freshThoughtCounts[beforeType]--;
+		if (beforeExcused)
+			_freshThoughtExcusedCounts[beforeType]--;
+	}
+	if (afterType != PEEP_THOUGHT_TYPE_NONE) {
+		_freshThoughtCounts[afterType]++;
+		if (afterExcused)
+			_freshThoughtExcusedCounts[afterType]++;
+	}
+}
+
+static void peep_fresh_thought_counts_rebuild()
+{
+	uint16 spriteIndex;
+	rct_peep *peep;
+	bool excused;
+	uint8 type;
+
+	memset(_freshThoughtCounts, 0, sizeof(_freshThoughtCounts));
+	memset(_freshThoughtExcusedCounts, 0, sizeof(_freshThoughtExcusedCounts));
+	FOR_ALL_GUESTS(spriteIndex, peep) {
+		type = peep_fresh_thought_type(peep, &excused);
+		if (type != PEEP_THOUGHT_TYPE_NONE) {
+			_freshThoughtCounts[type]++;
+			if (excused)
+				_freshThoughtExcusedCounts[type]++;
+		}
+	}
+	_freshThoughtCountsValid = true;
+}
+
+// Per peep summary of which thought types are present, indexed by sprite
+// index like the spatial side tables in sprite.c. Bit (type & 31) is set
+// when a thought of that type is in the peep's list, so the duplicate scans
+// in peep_insert_new_thought and peep_stop_purchase_thought can skip peeps
+// that definitely do not hold the type. Two types sharing a bit only cost
+// the scan that previously always ran.
+static uint32 _peepThoughtTypeMasks[MAX_SPRITES];
+static bool _peepThoughtTypeMasksValid = false;
+
+static uint32 peep_thought_mask_from_list(rct_peep *peep)
 {
 	int i;
+	uint32 mask = 0;
+
+	for (i = 0; i < PEEP_MAX_THOUGHTS; i++) {
+		if (peep->thoughts[i].type == PEEP_THOUGHT_TYPE_NONE)
+			break;
+		mask |= 1 << (peep->thoughts[i].type & 31);
+	}
+	return mask;
+}
+
+// Recomputed from the list rather than adjusted so a sprite slot reused by a
+// new peep sheds any bits left behind by the previous occupant
+static void peep_thought_mask_update(rct_peep *peep)
+{
+	if (_peepThoughtTypeMasksValid)
+		_peepThoughtTypeMasks[peep->sprite_index] = peep_thought_mask_from_list(peep);
+}
+
+static bool peep_thought_mask_may_contain(rct_peep *peep, uint8 thought_type)
+{
 	uint16 spriteIndex;
-	rct_peep* peep;	
+	rct_peep *otherPeep;
+
+	if (!_peepThoughtTypeMasksValid) {
+		memset(_peepThoughtTypeMasks, 0, sizeof(_peepThoughtTypeMasks));
+		FOR_ALL_PEEPS(spriteIndex, otherPeep)
+			_peepThoughtTypeMasks[spriteIndex] = peep_thought_mask_from_list(otherPeep);
+		_peepThoughtTypeMasksValid = true;
+	}
+	return (_peepThoughtTypeMasks[peep->sprite_index] & (1 << (thought_type & 31))) != 0;
+}
+
+void peep_thought_counters_invalidate()
+{
+	_freshThoughtCountsValid = false;
+	_peepThoughtTypeMasksValid = false;
+}
+
+uint16 peep_fresh_thought_count(int thoughtType)
+{
+	if (!_freshThoughtCountsValid)
+		peep_fresh_thought_counts_rebuild();
+	return _freshThoughtCounts[thoughtType];
+}
+
+static void peep_update_decide_job(void *context, int index)
+{
+	peep_update_entry *entry = &_peepUpdateList[index];
+
+	// Capture the fresh thought summary before this peep mutates anything.
+	// The thought list is cold data at the far end of the struct, so
+	// scanning it here keeps those cache lines out of the serial gather
+	// loop; no other job touches this peep and commits run after all jobs,
+	// so the capture still precedes every change this tick can make.
+	entry->thoughtBefore = peep_fresh_thought_type(entry->peep, &entry->thoughtExcusedBefore);
+
+	// Peeps at their 1-in-128 slot run 0x0068F41A first, which can change
+	// the fields the decide phase reads, so they are handled entirely in
+	// the commit phase.
+	if (entry->fullUpdate)
+		return;
+	entry->runStateMachine = peep_update_decide(entry->peep, &entry->stepsToTake);
+}
+
+// Tallies of the guest numbers the park rating needs, taken in the commit
+// loop where each peep's cache lines are already hot, so the five-second
+// rating recomputation does not sweep every guest again. Stamped with the
+// tick they were taken in; calculate_park_rating falls back to its own
+// sweep when they are stale (park just loaded, editor).
+static int _peepRatingHappyGuests = 0;
+static int _peepRatingLostGuests = 0;
+static uint32 _peepRatingTick = 0xFFFFFFFF;
+
+bool peep_rating_totals_get(int *numHappyGuests, int *numLostGuests)
+{
+	if (_peepRatingTick != RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32))
+		return false;
+
+	*numHappyGuests = _peepRatingHappyGuests;
+	*numLostGuests = _peepRatingLostGuests;
+	return true;
+}
+
+void peep_update_all()
+{
+	int i, count;
+	int numHappyGuests, numLostGuests;
+	uint16 spriteIndex;
+	rct_peep* peep;
 
 	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & 0x0E)
 		return;
 
+	// Gather the peep list up front; peeps can be removed during the commit
+	// phase without upsetting the iteration
+	count = 0;
 	spriteIndex = RCT2_GLOBAL(RCT2_ADDRESS_SPRITES_START_PEEP, uint16);
-	i = 0;
 	while (spriteIndex != SPRITE_INDEX_NULL) {
 		peep = &(g_sprite_list[spriteIndex].peep);
 		spriteIndex = peep->next;
 
-		if ((i & 0x7F) != (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) & 0x7F)) {
-			peep_update(peep);
-		} else {
-			RCT2_CALLPROC_X(0x0068F41A, 0, 0, 0, i, (int)peep, 0, 0);
-			if (peep->linked_list_type_offset == SPRITE_LINKEDLIST_OFFSET_PEEP)
-				peep_update(peep);
+		_peepUpdateList[count].peep = peep;
+		_peepUpdateList[count].fullUpdate =
+			(count & 0x7F) == (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) & 0x7F);
+		count++;
+	}
+
+	// Parallel decide phase: per-peep only reads and writes
+	worker_pool_run(peep_update_decide_job, NULL, count);
+
+	// Serial commit phase: everything that touches shared state. Sprite
+	// invalidations are merged per map quadrant and flushed once after the
+	// loop; peeps crowd the same quadrants, so this collapses thousands of
+	// per-sprite viewport walks into a few hundred
+	sprite_invalidate_batch_begin();
+	numHappyGuests = 0;
+	numLostGuests = 0;
+	_peepUpdateCommitting = true;
+	for (i = 0; i < count; i++) {
+		peep_update_entry *entry = &_peepUpdateList[i];
+		uint8 thoughtAfter;
+		bool thoughtExcusedAfter;
+
+		peep = entry->peep;
+
+		// An earlier commit this tick may have removed the peep
+		if (peep->linked_list_type_offset == SPRITE_LINKEDLIST_OFFSET_PEEP) {
+			if (entry->fullUpdate) {
+				RCT2_CALLPROC_X(0x0068F41A, 0, 0, 0, i, (int)peep, 0, 0);
+				if (peep->linked_list_type_offset == SPRITE_LINKEDLIST_OFFSET_PEEP)
+					peep_update(peep);
+			} else {
+				peep_update_commit(peep, entry->stepsToTake, entry->runStateMachine);
+			}
 		}
 
-		i++;
+		// Re-tally the fresh thought counters from whatever this tick did
+		// to the peep: thought inserts, ageing in the decide phase,
+		// entering or leaving the park, or removal
+		if (peep->linked_list_type_offset == SPRITE_LINKEDLIST_OFFSET_PEEP) {
+			thoughtAfter = peep_fresh_thought_type(peep, &thoughtExcusedAfter);
+
+			// Tally the rating inputs from the peep's post-update state,
+			// mirroring the conditions of the rating's own guest sweep
+			if (peep->type == PEEP_TYPE_GUEST && peep->var_2A == 0) {
+				if (peep->happiness > 128)
+					numHappyGuests++;
+				if ((peep->flags & PEEP_FLAGS_LEAVING_PARK) && peep->var_C6 <= 89)
+					numLostGuests++;
+			}
+		} else {
+			thoughtAfter = PEEP_THOUGHT_TYPE_NONE;
+			thoughtExcusedAfter = false;
+		}
+		peep_fresh_thought_counts_apply(
+			entry->thoughtBefore, entry->thoughtExcusedBefore,
+			thoughtAfter, thoughtExcusedAfter
+		);
 	}
+	_peepUpdateCommitting = false;
+	sprite_invalidate_batch_end();
+
+	_peepRatingHappyGuests = numHappyGuests;
+	_peepRatingLostGuests = numLostGuests;
+	_peepRatingTick = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
 }
 
 /* some sort of check to see if peep is connected to the ground?? */
@@ -257,9 +508,36 @@ void peep_check_cant_find_exit(rct_peep* peep){
 	if (--peep->var_C6 == 0) peep->var_C6 = 90;
 }
 
-/* rct2: 0x6939EB 
+// Flat (sprite_type, action_sprite_type) indexed cache of the frame offset
+// arrays the vanilla data reaches through two pointer tables (0x982708).
+// That data is static in the exe image, so entries are filled on first use
+// and never expire; the per-tick lookup for every animated peep becomes a
+// single array read. Each cached pointer keeps the vanilla layout: byte 0
+// is the frame count, the offsets follow from byte 1.
+#define PEEP_ANIMATION_CACHE_TYPES 64
+static const uint8 *_peepAnimationFrameCache[PEEP_ANIMATION_CACHE_TYPES][PEEP_ANIMATION_CACHE_TYPES];
+
+static const uint8 *peep_animation_frames(int spriteType, int actionSpriteType)
+{
+	const uint8 *frames;
+
+	if (spriteType < PEEP_ANIMATION_CACHE_TYPES && actionSpriteType < PEEP_ANIMATION_CACHE_TYPES) {
+		frames = _peepAnimationFrameCache[spriteType][actionSpriteType];
+		if (frames != NULL)
+			return frames;
+	}
+
+	uint32 *edi = RCT2_ADDRESS(0x982708, uint32*)[spriteType * 2];
+	frames = (uint8*)(edi[actionSpriteType * 2 + 1]);
+	if (spriteType < PEEP_ANIMATION_CACHE_TYPES && actionSpriteType < PEEP_ANIMATION_CACHE_TYPES)
+		_peepAnimationFrameCache[spriteType][actionSpriteType] = frames;
+
+	return frames;
+}
+
+/* rct2: 0x6939EB
  * Also used to move peeps to the correct position to
- * start an action. Returns 1 if the correct destination 
+ * start an action. Returns 1 if the correct destination
  * has not yet been reached. xy_distance is how close the
  * peep is to the target.
  */
@@ -298,8 +576,7 @@ int peep_update_action(sint16* x, sint16* y, sint16* xy_distance, rct_peep* peep
 		*x = peep->x + RCT2_ADDRESS(0x981D7C, uint16)[direction / 4];
 		*y = peep->y + RCT2_ADDRESS(0x981D7E, uint16)[direction / 4];
 		peep->no_action_frame_no++;
-		uint32* edi = RCT2_ADDRESS(0x982708, uint32*)[peep->sprite_type * 2];
-		uint8* _edi = (uint8*)(edi[peep->action_sprite_type * 2 + 1]);
+		const uint8* _edi = peep_animation_frames(peep->sprite_type, peep->action_sprite_type);
 		if (peep->no_action_frame_no >= *_edi){
 			peep->no_action_frame_no = 0;
 		}
@@ -307,8 +584,7 @@ int peep_update_action(sint16* x, sint16* y, sint16* xy_distance, rct_peep* peep
 		return 1;
 	}
 	
-	uint32* edi = RCT2_ADDRESS(0x982708, uint32*)[peep->sprite_type * 2];
-	uint8* _edi = (uint8*)(edi[peep->action_sprite_type * 2 + 1]);
+	const uint8* _edi = peep_animation_frames(peep->sprite_type, peep->action_sprite_type);
 	peep->action_frame++;
 	int ebx = _edi[peep->action_frame + 1];
 
@@ -557,6 +833,7 @@ void peep_window_state_update(rct_peep* peep){
 			ride->window_invalidate_flags |= RIDE_INVALIDATE_RIDE_MAIN | RIDE_INVALIDATE_RIDE_LIST;
 		}
 
+		window_guest_list_mark_dirty();
 		window_invalidate_by_class(WC_GUEST_LIST);
 	}
 	else{
@@ -579,6 +856,7 @@ void peep_sprite_remove(rct_peep* peep){
 	window_close_by_number(WC_FIRE_PROMPT, peep->sprite_identifier);
 
 	if (peep->type == PEEP_TYPE_GUEST){
+		window_guest_list_mark_dirty();
 		window_invalidate_by_class(WC_GUEST_LIST);
 
 		news_item_disable_news(NEWS_ITEM_PEEP_ON_RIDE, peep->sprite_index);
@@ -845,9 +1123,28 @@ void peep_update_sitting(rct_peep* peep){
 	}
 }
 
+// Guests deep in a ride queue spend nearly every tick standing still behind
+// the guest ahead, yet each one runs the full movement and animation pass.
+// Once a queuing guest has come to rest it is flipped into a cheap follow
+// mode that skips that pass and only keeps the queue timers and boredom
+// behaviours ticking. A guest leaving the queue is the advance event: it
+// wakes the whole queue so everyone steps forward, and a periodic safety
+// wake catches anything the event model misses.
+static uint8 _peepQueueFollowMode[MAX_SPRITES];
+
+static void peep_queue_wake_all(rct_ride *ride, int station)
+{
+	uint16 spriteIndex = ride->first_peep_in_queue[station];
+	while (spriteIndex != 0xFFFF) {
+		rct_peep *queue_peep = GET_PEEP(spriteIndex);
+		_peepQueueFollowMode[spriteIndex] = 0;
+		spriteIndex = queue_peep->next_in_queue;
+	}
+}
+
 /**
  *
- * rct2: 0x006966A9 
+ * rct2: 0x006966A9
  */
 void remove_peep_from_queue(rct_peep* peep)
 {
@@ -855,6 +1152,10 @@ void remove_peep_from_queue(rct_peep* peep)
 
 	uint8 cur_station = peep->current_ride_station;
 	ride->queue_length[cur_station]--;
+
+	// The queue advances; everyone behind steps forward
+	peep_queue_wake_all(ride, cur_station);
+
 	if (peep->sprite_index == ride->first_peep_in_queue[cur_station])
 	{
 		ride->first_peep_in_queue[cur_station] = peep->next_in_queue;
@@ -1191,6 +1492,7 @@ void peep_update_ride_sub_state_1(rct_peep* peep){
 			peep->destination_tolerence = 3;
 
 			ride->var_120++;
+			ride_stats_record_customer(peep->current_ride);
 			RCT2_CALLPROC_X(0x00695444, 0, 0, 0, peep->current_ride, (int)peep, 0, 0);
 			peep->sub_state = 17;
 			return;
@@ -1218,6 +1520,7 @@ void peep_update_ride_sub_state_1(rct_peep* peep){
 		peep->current_car = 0;
 
 		ride->var_120++;
+		ride_stats_record_customer(peep->current_ride);
 		RCT2_CALLPROC_X(0x00695444, 0, 0, 0, peep->current_ride, (int)peep, 0, 0);
 		peep->sub_state = 14;
 		return;
@@ -1563,6 +1866,7 @@ static void peep_update_ride_sub_state_5(rct_peep* peep){
 
 		vehicle->num_peeps++;
 		ride->var_120++;
+		ride_stats_record_customer(peep->current_ride);
 
 		vehicle->var_46 += seated_peep->var_41;
 		invalidate_sprite((rct_sprite*)seated_peep);
@@ -1578,6 +1882,7 @@ static void peep_update_ride_sub_state_5(rct_peep* peep){
 
 	vehicle->num_peeps++;
 	ride->var_120++;
+	ride_stats_record_customer(peep->current_ride);
 
 	vehicle->var_46 += peep->var_41;
 	invalidate_sprite((rct_sprite*)vehicle);
@@ -2626,11 +2931,13 @@ static void peep_update_fixing(int steps, rct_peep* peep){
  */
 static void peep_update_queuing(rct_peep* peep){
 	if (!sub_68F3AE(peep)){
+		_peepQueueFollowMode[peep->sprite_index] = 0;
 		remove_peep_from_queue(peep);
 		return;
 	}
 	rct_ride* ride = GET_RIDE(peep->current_ride);
 	if (ride->status == RIDE_STATUS_CLOSED || ride->status == RIDE_STATUS_TESTING){
+		_peepQueueFollowMode[peep->sprite_index] = 0;
 		remove_peep_from_queue(peep);
 		peep_decrement_num_riders(peep);
 		peep->state = PEEP_STATE_1;
@@ -2639,6 +2946,7 @@ static void peep_update_queuing(rct_peep* peep){
 	}
 
 	if (peep->sub_state != 10){
+		_peepQueueFollowMode[peep->sprite_index] = 0;
 		if (peep->next_in_queue == 0xFFFF){
 			//Happens every time peep goes onto ride.
 			peep->destination_tolerence = 0;
@@ -2658,7 +2966,60 @@ static void peep_update_queuing(rct_peep* peep){
 		return;
 	}
 
+	// The fidget animations in the full pass are gated on this boundary, so
+	// wake into it just before; it doubles as a safety net in case a queue
+	// advance event was ever missed
+	if (_peepQueueFollowMode[peep->sprite_index] && !((uint16)(peep->time_in_queue + 1) & 0x3F)){
+		_peepQueueFollowMode[peep->sprite_index] = 0;
+	}
+
+	if (_peepQueueFollowMode[peep->sprite_index]){
+		// Follow mode: the guest is at rest behind the guest ahead, so the
+		// movement and animation pass has nothing to do. Keep the queue
+		// timers and the boredom behaviours running; anything that needs the
+		// action machinery drops back to the full pass.
+		if (peep->time_in_queue < 0xFFFF)
+			peep->time_in_queue++;
+
+		if (peep->sprite_type == 0){
+			if (peep->time_in_queue >= 2000 && (0xFFFF & scenario_rand()) <= 119){
+				// Eat Food/Look at watch
+				_peepQueueFollowMode[peep->sprite_index] = 0;
+				peep->action = PEEP_ACTION_EAT_FOOD;
+				peep->action_frame = 0;
+				peep->action_sprite_image_offset = 0;
+				sub_693B58(peep);
+				invalidate_sprite((rct_sprite*)peep);
+			}
+			if (peep->time_in_queue >= 3500 && (0xFFFF & scenario_rand()) <= 93)
+			{
+				//Create the ive been waiting in line ages thought
+				peep_insert_new_thought(peep, PEEP_THOUGHT_TYPE_QUEUING_AGES, peep->current_ride);
+			}
+		}
+		if (peep->time_in_queue < 4300) return;
+
+		if (peep->happiness <= 65 && (0xFFFF & scenario_rand()) < 2184){
+			//Give up queueing for the ride
+			_peepQueueFollowMode[peep->sprite_index] = 0;
+			peep->sprite_direction ^= (1 << 4);
+			invalidate_sprite((rct_sprite*)peep);
+			remove_peep_from_queue(peep);
+			peep_decrement_num_riders(peep);
+			peep->state = PEEP_STATE_1;
+			peep_window_state_update(peep);
+		}
+		return;
+	}
+
+	sint16 restX = peep->x, restY = peep->y;
 	RCT2_CALLPROC_X(0x693C9E, 0, 0, 0, 0, (int)peep, 0, 0);
+	// A guest that did not move, is not mid action and has settled into the
+	// standing animation has caught up with the guest ahead; follow it
+	// cheaply until the queue advances
+	if (peep->action >= 0xFE && peep->var_6F == 2 && peep->x == restX && peep->y == restY){
+		_peepQueueFollowMode[peep->sprite_index] = 1;
+	}
 	if (peep->action < 0xFE)return;
 	if (peep->sprite_type == 0){
 		if (peep->time_in_queue >= 2000 && (0xFFFF & scenario_rand()) <= 119){
@@ -4240,6 +4601,7 @@ static void peep_update_thoughts(rct_peep* peep){
 					// Clear top thought, push others up
 					memmove(&peep->thoughts[i], &peep->thoughts[i + 1], sizeof(rct_peep_thought)*(PEEP_MAX_THOUGHTS - i - 1));
 					peep->thoughts[PEEP_MAX_THOUGHTS - 1].type = PEEP_THOUGHT_TYPE_NONE;
+					peep_thought_mask_update(peep);
 				}
 			}
 		}
@@ -4260,11 +4622,14 @@ static void peep_update_thoughts(rct_peep* peep){
  *
  *  rct2: 0x0068FC1E
  */
-static void peep_update(rct_peep *peep)
+/**
+ * Decide phase of the peep tick. This may only read and write the peep it is
+ * given (no map, RNG, audio or other sprite access) because it is run from
+ * worker pool jobs with one job per peep. Returns whether the state machine
+ * needs to run in the commit phase and stores the step count for it.
+ */
+static bool peep_update_decide(rct_peep *peep, unsigned int *outStepsToTake)
 {
-	//RCT2_CALLPROC_X(0x0068FC1E, 0, 0, 0, 0, (int)peep, 0, 0); return;
-	//return;
-
 	if (peep->type == PEEP_TYPE_GUEST) {
 		if (peep->previous_ride != 255)
 			if (++peep->previous_ride_time_out >= 720)
@@ -4284,10 +4649,20 @@ static void peep_update(rct_peep *peep)
 		if (peep->state == PEEP_STATE_QUEUING)
 			stepsToTake += stepsToTake / 2;
 	}
+	*outStepsToTake = stepsToTake;
 
 	unsigned int carryCheck = peep->var_73 + stepsToTake;
 	peep->var_73 = carryCheck;
-	if (carryCheck <= 255) {
+	return carryCheck > 255;
+}
+
+/**
+ * Commit phase of the peep tick; everything here may touch shared state and
+ * therefore runs serially.
+ */
+static void peep_update_commit(rct_peep *peep, unsigned int stepsToTake, bool runStateMachine)
+{
+	if (!runStateMachine) {
 		// loc_68FD3A
 		RCT2_CALLPROC_X(0x0068FD3A, 0, 0, 0, 0, (int)peep, 0, 0);
 	} else {
@@ -4368,13 +4743,22 @@ static void peep_update(rct_peep *peep)
 			peep_update_fixing(stepsToTake, peep);
 			break;
 			//There shouldnt be any more
-		default:		
+		default:
 			assert(0);
 			break;
 		}
 	}
 }
 
+static void peep_update(rct_peep *peep)
+{
+	unsigned int stepsToTake;
+	bool runStateMachine;
+
+	runStateMachine = peep_update_decide(peep, &stepsToTake);
+	peep_update_commit(peep, stepsToTake, runStateMachine);
+}
+
 
 /**
  *
@@ -4382,71 +4766,31 @@ static void peep_update(rct_peep *peep)
  **/
 void peep_problem_warnings_update()
 {
-	rct_peep* peep;
-	rct_ride* ride;
-	uint16 spriteIndex;
 	uint16 guests_in_park = RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16);
-	int hunger_counter = 0, lost_counter = 0, noexit_counter = 0, thirst_counter = 0,
-		litter_counter = 0, disgust_counter = 0, bathroom_counter = 0 ,vandalism_counter = 0;
+	int hunger_counter, lost_counter, noexit_counter, thirst_counter,
+		litter_counter, disgust_counter, bathroom_counter, vandalism_counter;
 	static int warning_throttle[7] = { 0, 0, 0, 0, 0, 0, 0 };
+	static int rebuild_counter = 0;
 
 	RCT2_GLOBAL(RCT2_ADDRESS_RIDE_COUNT, sint16) = ride_get_count(); // refactor this to somewhere else
 
-	FOR_ALL_GUESTS(spriteIndex, peep) {
-		if (peep->var_2A != 0 || peep->thoughts[0].var_2 > 5)
-			continue;
-
-		switch (peep->thoughts[0].type) {
-		case PEEP_THOUGHT_TYPE_LOST: //0x10
-			lost_counter++;
-			break;
-
-		case PEEP_THOUGHT_TYPE_HUNGRY: // 0x14
-			if (peep->guest_heading_to_ride_id == -1){
-				hunger_counter++;
-				break;
-			}
-			ride = &g_ride_list[peep->guest_heading_to_ride_id];
-			if (!ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_SELLS_FOOD))
-				hunger_counter++;
-			break;
-
-		case PEEP_THOUGHT_TYPE_THIRSTY:
-			if (peep->guest_heading_to_ride_id == -1){
-				thirst_counter++;
-				break;
-			}
-			ride = &g_ride_list[peep->guest_heading_to_ride_id];
-			if (!ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_SELLS_DRINKS))
-				thirst_counter++;
-			break;
-
-		case PEEP_THOUGHT_TYPE_BATHROOM:
-			if (peep->guest_heading_to_ride_id == -1){
-				bathroom_counter++;
-				break;
-			}
-			ride = &g_ride_list[peep->guest_heading_to_ride_id];
-			if (!ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_IS_BATHROOM))
-				bathroom_counter++;
-			break;
-
-		case PEEP_THOUGHT_TYPE_BAD_LITTER: // 0x1a
-			litter_counter++;
-			break;
-		case PEEP_THOUGHT_TYPE_CANT_FIND_EXIT: // 0x1b
-			noexit_counter++;
-			break;
-		case PEEP_THOUGHT_TYPE_PATH_DISGUSTING: // 0x1f
-			disgust_counter++;
-			break;
-		case PEEP_THOUGHT_TYPE_VANDALISM: //0x21
-			vandalism_counter++;
-			break;
-		default:
-			break;
-		}
-	}
+	// The fresh thought tallies are maintained as peeps tick, but rare
+	// paths (one peep's commit mutating another already committed peep)
+	// can nudge them off; re-walk the guest list occasionally to correct
+	// any drift.
+	if (!_freshThoughtCountsValid || ++rebuild_counter >= 8) {
+		rebuild_counter = 0;
+		peep_fresh_thought_counts_rebuild();
+	}
+
+	lost_counter = _freshThoughtCounts[PEEP_THOUGHT_TYPE_LOST];
+	hunger_counter = _freshThoughtCounts[PEEP_THOUGHT_TYPE_HUNGRY] - _freshThoughtExcusedCounts[PEEP_THOUGHT_TYPE_HUNGRY];
+	thirst_counter = _freshThoughtCounts[PEEP_THOUGHT_TYPE_THIRSTY] - _freshThoughtExcusedCounts[PEEP_THOUGHT_TYPE_THIRSTY];
+	bathroom_counter = _freshThoughtCounts[PEEP_THOUGHT_TYPE_BATHROOM] - _freshThoughtExcusedCounts[PEEP_THOUGHT_TYPE_BATHROOM];
+	litter_counter = _freshThoughtCounts[PEEP_THOUGHT_TYPE_BAD_LITTER];
+	noexit_counter = _freshThoughtCounts[PEEP_THOUGHT_TYPE_CANT_FIND_EXIT];
+	disgust_counter = _freshThoughtCounts[PEEP_THOUGHT_TYPE_PATH_DISGUSTING];
+	vandalism_counter = _freshThoughtCounts[PEEP_THOUGHT_TYPE_VANDALISM];
 	// could maybe be packed into a loop, would lose a lot of clarity though
 	if (warning_throttle[0])
 		--warning_throttle[0];
@@ -4508,7 +4852,6 @@ void peep_problem_warnings_update()
 void peep_update_crowd_noise()
 {
 	rct_viewport *viewport;
-	uint16 spriteIndex;
 	rct_peep *peep;
 	int visiblePeeps;
 
@@ -4528,22 +4871,57 @@ void peep_update_crowd_noise()
 	if (viewport == (rct_viewport*)-1)
 		return;
 
-	// Count the number of peeps visible
+	// Count the number of peeps visible. Rather than sweeping the whole
+	// guest list, unproject the view rectangle corners at the lowest and
+	// highest land heights to get a world-space bounding box and only test
+	// the guests in the spatial index cells it covers; each candidate still
+	// gets the same per-sprite screen rectangle test as before.
 	visiblePeeps = 0;
 
-	FOR_ALL_GUESTS(spriteIndex, peep) {
-		if (peep->sprite_left == (sint16)0x8000)
-			continue;
-		if (viewport->view_x > peep->sprite_right)
-			continue;
-		if (viewport->view_x + viewport->view_width < peep->sprite_left)
-			continue;
-		if (viewport->view_y > peep->sprite_bottom)
-			continue;
-		if (viewport->view_y + viewport->view_height < peep->sprite_top)
-			continue;
+	int worldLeft = 0x7FFFFFFF, worldTop = 0x7FFFFFFF;
+	int worldRight = -0x7FFFFFFF, worldBottom = -0x7FFFFFFF;
+	for (int corner = 0; corner < 4; corner++) {
+		int viewX = viewport->view_x + ((corner & 1) ? viewport->view_width : 0);
+		int viewY = viewport->view_y + ((corner & 2) ? viewport->view_height : 0);
+		for (int z = 0; z <= 2048; z += 2048) {
+			rct_xy16 mapPos = viewport_coord_to_map_coord(viewX, viewY, z);
+			worldLeft = min(worldLeft, mapPos.x);
+			worldTop = min(worldTop, mapPos.y);
+			worldRight = max(worldRight, mapPos.x);
+			worldBottom = max(worldBottom, mapPos.y);
+		}
+	}
+
+	// Margin for the sprite extents around the anchor position
+	worldLeft = clamp(0, worldLeft - 128, 8191);
+	worldTop = clamp(0, worldTop - 128, 8191);
+	worldRight = clamp(0, worldRight + 128, 8191);
+	worldBottom = clamp(0, worldBottom + 128, 8191);
+
+	for (int worldY = worldTop & ~127; worldY <= worldBottom; worldY += 128) {
+		for (int worldX = worldLeft & ~127; worldX <= worldRight; worldX += 128) {
+			const sprite_spatial_cell *cell = sprite_spatial_cell_get(worldX, worldY);
+			for (int i = 0; i < cell->count; i++) {
+				rct_sprite *sprite = &g_sprite_list[cell->indices[i]];
+				if (sprite->unknown.sprite_identifier != SPRITE_IDENTIFIER_PEEP)
+					continue;
+				peep = &sprite->peep;
+				if (peep->type != PEEP_TYPE_GUEST)
+					continue;
+				if (peep->sprite_left == (sint16)0x8000)
+					continue;
+				if (viewport->view_x > peep->sprite_right)
+					continue;
+				if (viewport->view_x + viewport->view_width < peep->sprite_left)
+					continue;
+				if (viewport->view_y > peep->sprite_bottom)
+					continue;
+				if (viewport->view_y + viewport->view_height < peep->sprite_top)
+					continue;
 
-		visiblePeeps += peep->state == PEEP_STATE_QUEUING ? 1 : 2;
+				visiblePeeps += peep->state == PEEP_STATE_QUEUING ? 1 : 2;
+			}
+		}
 	}
 
 	// This function doesn't account for the fact that the screen might be so big that 100 peeps could potentially be very
@@ -5226,6 +5604,13 @@ static int peep_should_find_bench(rct_peep* peep){
  */
 void peep_insert_new_thought(rct_peep *peep, uint8 thought_type, uint8 thought_arguments){
 	uint8 action = RCT2_ADDRESS(0x981DB0, uint16)[thought_type] & 0xFF;
+	uint8 thoughtBefore = PEEP_THOUGHT_TYPE_NONE;
+	bool thoughtExcusedBefore = false;
+
+	// The peep tick re-tallies the fresh thought counters itself; only
+	// account for inserts from outside it (awards, windows, etc.)
+	if (!_peepUpdateCommitting)
+		thoughtBefore = peep_fresh_thought_type(peep, &thoughtExcusedBefore);
 
 	if (action != 0xFF && peep->action >= 254){
 			peep->action = action;
@@ -5235,17 +5620,19 @@ void peep_insert_new_thought(rct_peep *peep, uint8 thought_type, uint8 thought_a
 			invalidate_sprite((rct_sprite*)peep);
 	}
 	
-	for (int i = 0; i < PEEP_MAX_THOUGHTS; ++i){
-		rct_peep_thought* thought = &peep->thoughts[i];
-		// Remove the oldest thought by setting it to NONE.
-		if (thought->type == PEEP_THOUGHT_TYPE_NONE) break;
-
-		if (thought->type == thought_type && thought->item == thought_arguments){
-			// If the thought type has not changed then we need to move
-			// it to the top of the thought list. This is done by first removing the
-			// existing thought and placing it at the top.
-			memmove(thought, thought + 1, sizeof(rct_peep_thought)*(PEEP_MAX_THOUGHTS - i - 1));
-			break;
+	if (peep_thought_mask_may_contain(peep, thought_type)) {
+		for (int i = 0; i < PEEP_MAX_THOUGHTS; ++i){
+			rct_peep_thought* thought = &peep->thoughts[i];
+			// Remove the oldest thought by setting it to NONE.
+			if (thought->type == PEEP_THOUGHT_TYPE_NONE) break;
+
+			if (thought->type == thought_type && thought->item == thought_arguments){
+				// If the thought type has not changed then we need to move
+				// it to the top of the thought list. This is done by first removing the
+				// existing thought and placing it at the top.
+				memmove(thought, thought + 1, sizeof(rct_peep_thought)*(PEEP_MAX_THOUGHTS - i - 1));
+				break;
+			}
 		}
 	}
 
@@ -5255,8 +5642,15 @@ void peep_insert_new_thought(rct_peep *peep, uint8 thought_type, uint8 thought_a
 	peep->thoughts[0].item = thought_arguments;
 	peep->thoughts[0].var_2 = 0;
 	peep->thoughts[0].var_3 = 0;
+	peep_thought_mask_update(peep);
 
 	peep->var_45 |= (1 << 0);
+
+	if (!_peepUpdateCommitting) {
+		bool thoughtExcusedAfter;
+		uint8 thoughtAfter = peep_fresh_thought_type(peep, &thoughtExcusedAfter);
+		peep_fresh_thought_counts_apply(thoughtBefore, thoughtExcusedBefore, thoughtAfter, thoughtExcusedAfter);
+	}
 }
 
 /* rct2: 0x00699FE3 
@@ -5282,6 +5676,9 @@ static void peep_stop_purchase_thought(rct_peep* peep, uint8 ride_type){
 	}
 
 	//Remove the related thought
+	if (!peep_thought_mask_may_contain(peep, thought_type))
+		return;
+
 	for (int i = 0; i < PEEP_MAX_THOUGHTS; ++i){
 		rct_peep_thought* thought = &peep->thoughts[i];
 
@@ -5296,6 +5693,7 @@ static void peep_stop_purchase_thought(rct_peep* peep, uint8 ride_type){
 		peep->var_45 |= (1 << 0);
 		i--;
 	}
+	peep_thought_mask_update(peep);
 }
 
 void peep_set_map_tooltip(rct_peep *peep)
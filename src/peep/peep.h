@@ -557,7 +557,10 @@ enum {
 int peep_get_staff_count();
 int peep_can_be_picked_up(rct_peep* peep);
 void peep_update_all();
+bool peep_rating_totals_get(int *numHappyGuests, int *numLostGuests);
 void peep_problem_warnings_update();
+uint16 peep_fresh_thought_count(int thoughtType);
+void peep_thought_counters_invalidate();
 void peep_update_crowd_noise();
 void peep_update_days_in_queue();
 void peep_applause();
@@ -23,10 +23,150 @@
 #include "../interface/viewport.h"
 #include "../localisation/string_ids.h"
 #include "../management/finance.h"
+#include "../util/util.h"
 #include "../world/sprite.h"
 #include "peep.h"
 #include "staff.h"
 
+// Spatial index over staff patrol areas. For every 4x4 patrol quad a bitmask
+// records which staff ids cover it (staff with no patrol area cover every
+// quad), so dispatch queries only have to test the handful of staff whose
+// area contains the location instead of walking the whole staff list.
+// Rebuilt lazily after hiring, firing or patrol area edits.
+#define PATROL_INDEX_QUAD_COUNT (64 * 64)
+#define PATROL_INDEX_WORD_COUNT ((STAFF_MAX_COUNT + 31) / 32)
+
+static uint32 _patrolIndex[PATROL_INDEX_QUAD_COUNT][PATROL_INDEX_WORD_COUNT];
+static uint16 _patrolIndexSpriteIndexes[STAFF_MAX_COUNT];
+static bool _patrolIndexValid = false;
+
+static void staff_patrol_index_rebuild()
+{
+	uint16 spriteIndex;
+	rct_peep *peep;
+	uint32 *patrolBits;
+	int i, quad, staffId;
+
+	memset(_patrolIndex, 0, sizeof(_patrolIndex));
+	for (i = 0; i < STAFF_MAX_COUNT; i++)
+		_patrolIndexSpriteIndexes[i] = SPRITE_INDEX_NULL;
+
+	FOR_ALL_STAFF(spriteIndex, peep) {
+		staffId = peep->staff_id;
+		if (staffId >= STAFF_MAX_COUNT)
+			continue;
+
+		_patrolIndexSpriteIndexes[staffId] = peep->sprite_index;
+
+		if (!(RCT2_ADDRESS(RCT2_ADDRESS_STAFF_MODE_ARRAY, uint8)[staffId] & 2)) {
+			// No patrol area set, the staff member roams the whole park
+			for (quad = 0; quad < PATROL_INDEX_QUAD_COUNT; quad++)
+				_patrolIndex[quad][staffId >> 5] |= 1 << (staffId & 0x1F);
+		} else {
+			// Patrol quad n is bit n of the staff member's patrol bitmap
+			patrolBits = (uint32*)(0x013B0E72 + staffId * (64 * 64 / 8));
+			for (quad = 0; quad < PATROL_INDEX_QUAD_COUNT; quad++)
+				if (patrolBits[quad >> 5] & (1 << (quad & 0x1F)))
+					_patrolIndex[quad][staffId >> 5] |= 1 << (staffId & 0x1F);
+		}
+	}
+	_patrolIndexValid = true;
+}
+
+// Bounding box of each staff member's patrol area in patrol quad
+// coordinates, so location queries can reject anywhere outside the area
+// without touching the bitmap. Mechanics test their patrol area for every
+// path decision, which made the bit tests add up in staff heavy parks.
+// Rebuilt lazily after the same events that invalidate the quad index.
+typedef struct {
+	uint8 min_x, min_y, max_x, max_y;
+	bool empty;
+} staff_patrol_bounds;
+
+static staff_patrol_bounds _patrolBounds[STAFF_MAX_COUNT];
+static bool _patrolBoundsValid = false;
+
+static void staff_patrol_bounds_rebuild()
+{
+	staff_patrol_bounds *bounds;
+	uint32 *patrolBits, bits;
+	int staffId, word, quad, quadX, quadY;
+
+	for (staffId = 0; staffId < STAFF_MAX_COUNT; staffId++) {
+		bounds = &_patrolBounds[staffId];
+		bounds->empty = true;
+		bounds->min_x = 255;
+		bounds->min_y = 255;
+		bounds->max_x = 0;
+		bounds->max_y = 0;
+
+		patrolBits = (uint32*)(0x013B0E72 + staffId * (64 * 64 / 8));
+		for (word = 0; word < (64 * 64) / 32; word++) {
+			bits = patrolBits[word];
+			while (bits != 0) {
+				quad = (word << 5) + bitscanforward(bits);
+				bits &= bits - 1;
+
+				quadX = quad & 63;
+				quadY = (quad >> 6) & 63;
+				bounds->min_x = min(bounds->min_x, quadX);
+				bounds->min_y = min(bounds->min_y, quadY);
+				bounds->max_x = max(bounds->max_x, quadX);
+				bounds->max_y = max(bounds->max_y, quadY);
+				bounds->empty = false;
+			}
+		}
+	}
+	_patrolBoundsValid = true;
+}
+
+void staff_patrol_index_invalidate()
+{
+	_patrolIndexValid = false;
+	_patrolBoundsValid = false;
+}
+
+/**
+ * Gathers the staff of the given type whose patrol area contains the given
+ * location (x and y in world coordinates). outSpriteIndexes must have room
+ * for STAFF_MAX_COUNT entries; returns the number written.
+ */
+int staff_get_patrol_area_candidates(int staffType, int x, int y, uint16 *outSpriteIndexes)
+{
+	rct_peep *peep;
+	uint32 bits;
+	uint16 spriteIndex;
+	int i, quad, staffId, count;
+
+	if (!_patrolIndexValid)
+		staff_patrol_index_rebuild();
+
+	quad = ((x & 0x1F80) >> 7) | ((y & 0x1F80) >> 1);
+	count = 0;
+	for (i = 0; i < PATROL_INDEX_WORD_COUNT; i++) {
+		bits = _patrolIndex[quad][i];
+		while (bits != 0) {
+			staffId = (i << 5) + bitscanforward(bits);
+			bits &= bits - 1;
+
+			spriteIndex = _patrolIndexSpriteIndexes[staffId];
+			if (spriteIndex == SPRITE_INDEX_NULL)
+				continue;
+
+			// Guard against the sprite having been removed or reused
+			// without the index hearing about it
+			peep = GET_PEEP(spriteIndex);
+			if (peep->type != PEEP_TYPE_STAFF || peep->staff_id != staffId)
+				continue;
+			if (peep->staff_type != staffType)
+				continue;
+
+			outSpriteIndexes[count++] = spriteIndex;
+		}
+	}
+	return count;
+}
+
 /**
  *
  *  rct2: 0x00669E55
@@ -205,6 +345,8 @@ void game_command_hire_new_staff_member(int* eax, int* ebx, int* ecx, int* edx,
 			int addr = 0x013B0E72 + (newStaffId << 9) + edi * 4;
 			RCT2_GLOBAL(addr, uint32) = 0;
 		}
+
+		staff_patrol_index_invalidate();
 	}
 
 	*ebx = 0;
@@ -279,6 +421,7 @@ void game_command_set_staff_patrol(int *eax, int *ebx, int *ecx, int *edx, int *
 			}
 		}
 		staff_update_greyed_patrol_areas();
+		staff_patrol_index_invalidate();
 	}
 	*ebx = 0;
 }
@@ -296,6 +439,7 @@ void game_command_fire_staff_member(int *eax, int *ebx, int *ecx, int *edx, int
 		rct_peep *peep = &g_sprite_list[sprite_id].peep;
 		remove_peep_from_ride(peep);
 		peep_sprite_remove(peep);
+		staff_patrol_index_invalidate();
 	}
 	*ebx = 0;
 }
@@ -360,8 +504,22 @@ int staff_is_location_in_patrol_area(rct_peep *peep, int x, int y)
 	// Patrol quads are stored in a bit map (8 patrol quads per byte)
 	// Each patrol quad is 4x4
 	// Therefore there are in total 64 x 64 patrol quads in the 256 x 256 map
+	staff_patrol_bounds *bounds;
+	int quadX = (x & 0x1F80) >> 7;
+	int quadY = (y & 0x1F80) >> 7;
+
+	if (!_patrolBoundsValid)
+		staff_patrol_bounds_rebuild();
+
+	bounds = &_patrolBounds[peep->staff_id];
+	if (bounds->empty ||
+		quadX < bounds->min_x || quadX > bounds->max_x ||
+		quadY < bounds->min_y || quadY > bounds->max_y
+	)
+		return 0;
+
 	int patrolOffset = peep->staff_id * (64 * 64 / 8);
-	int patrolIndex = ((x & 0x1F80) >> 7) | ((y & 0x1F80) >> 1);
+	int patrolIndex = (quadX) | (quadY << 6);
 	int mask = 1 << (patrolIndex & 0x1F);
 	int base = patrolIndex >> 5;
 
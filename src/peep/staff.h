@@ -58,6 +58,8 @@ void game_command_fire_staff_member(int *eax, int *ebx, int *ecx, int *edx, int
 void update_staff_colour(uint8 staffType, uint16 color);
 uint16 hire_new_staff_member(uint8 staffType);
 void staff_update_greyed_patrol_areas();
+void staff_patrol_index_invalidate();
+int staff_get_patrol_area_candidates(int staffType, int x, int y, uint16 *outSpriteIndexes);
 int mechanic_is_location_in_patrol(rct_peep *mechanic, int x, int y);
 void staff_reset_stats();
 
@@ -0,0 +1,130 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "addresses.h"
+#include "audio/audio.h"
+#include "audio/mixer.h"
+#include "config.h"
+#include "drawing/drawing.h"
+#include "game.h"
+#include "interface/profiler.h"
+#include "perfcounters.h"
+#include "platform/platform.h"
+#include "statehash.h"
+#include "world/sprite.h"
+
+static shared_memory _sharedMemory;
+static perf_counters_block *_block = NULL;
+
+/**
+ * Publishes the performance counter block as a named shared memory segment so
+ * external collectors can scrape it without attaching to the process. Enabled
+ * with the performance_counters configuration option; keeps the profiler's
+ * frame history recording even while the overlay is hidden.
+ */
+void perfcounters_init()
+{
+	if (!gConfigGeneral.performance_counters)
+		return;
+
+	if (!platform_shared_memory_create(PERF_COUNTERS_MAPPING_NAME, sizeof(perf_counters_block), &_sharedMemory)) {
+		log_error("Unable to create performance counter segment %s", PERF_COUNTERS_MAPPING_NAME);
+		return;
+	}
+
+	_block = (perf_counters_block*)_sharedMemory.data;
+	memset(_block, 0, sizeof(*_block));
+	_block->magic = PERF_COUNTERS_MAGIC;
+	_block->version = PERF_COUNTERS_VERSION;
+	_block->spritesMax = MAX_SPRITES;
+	_block->numPhases = min(GAME_LOGIC_PHASE_COUNT, PERF_COUNTERS_MAX_PHASES);
+
+	gProfilerExternalCollect = 1;
+	log_verbose("performance counters published as %s", PERF_COUNTERS_MAPPING_NAME);
+}
+
+void perfcounters_dispose()
+{
+	if (_block == NULL)
+		return;
+
+	gProfilerExternalCollect = 0;
+	_block = NULL;
+	platform_shared_memory_close(&_sharedMemory);
+}
+
+static int perfcounters_compare_float(const void *a, const void *b)
+{
+	float fa = *(const float*)a, fb = *(const float*)b;
+	return fa < fb ? -1 : fa > fb ? 1 : 0;
+}
+
+static uint32 perfcounters_ms_to_us(float ms)
+{
+	return (uint32)(ms * 1000.0f);
+}
+
+/**
+ * Refreshes the published block from the profiler history and the live
+ * gauges. Called once per logic tick from the main loop; collectors see a
+ * consistent snapshot by re-reading until the sequence is stable and even.
+ */
+void perfcounters_update()
+{
+	float updateMs[PROFILER_HISTORY_SIZE], drawMs[PROFILER_HISTORY_SIZE];
+	float phaseMs[GAME_LOGIC_PHASE_COUNT];
+	int numFrames;
+	uint32 i;
+
+	if (_block == NULL)
+		return;
+
+	numFrames = profiler_get_history(updateMs, drawMs, phaseMs);
+	qsort(updateMs, numFrames, sizeof(float), perfcounters_compare_float);
+	qsort(drawMs, numFrames, sizeof(float), perfcounters_compare_float);
+
+	_block->sequence++;
+
+	_block->ticks = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
+	_block->guestsInPark = RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16);
+	_block->spritesInUse = MAX_SPRITES - RCT2_GLOBAL(0x13573C8, uint16);
+	_block->dirtyBlocksDrawn = gfx_get_dirty_blocks_drawn();
+
+	_block->updateP50Us = perfcounters_ms_to_us(updateMs[numFrames / 2]);
+	_block->updateP95Us = perfcounters_ms_to_us(updateMs[(numFrames * 95) / 100]);
+	_block->updateMaxUs = perfcounters_ms_to_us(updateMs[numFrames - 1]);
+	_block->drawP50Us = perfcounters_ms_to_us(drawMs[numFrames / 2]);
+	_block->drawP95Us = perfcounters_ms_to_us(drawMs[(numFrames * 95) / 100]);
+	_block->drawMaxUs = perfcounters_ms_to_us(drawMs[numFrames - 1]);
+
+	for (i = 0; i < _block->numPhases; i++)
+		_block->phaseAverageUs[i] = perfcounters_ms_to_us(phaseMs[i]);
+
+	_block->stateDigestValid = statehash_valid();
+	_block->stateDigest = gStateHashDigest;
+	_block->stateDigestMap = gStateHashMap;
+	_block->stateDigestSprites = gStateHashSprites;
+	_block->stateDigestRides = gStateHashRides;
+
+	Mixer_GetStats(&_block->audioBufferSamples, &_block->audioUnderruns,
+		&_block->audioCallbackPeakUs, &_block->audioCallbackAvgUs);
+
+	_block->sequence++;
+}
@@ -0,0 +1,87 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _PERFCOUNTERS_H_
+#define _PERFCOUNTERS_H_
+
+#include "common.h"
+
+#define PERF_COUNTERS_MAPPING_NAME	"OpenRCT2_perfcounters"
+#define PERF_COUNTERS_MAGIC			0x32435250	// "PRC2"
+#define PERF_COUNTERS_VERSION		3
+
+// Number of phase slots reserved in the block; independent of
+// GAME_LOGIC_PHASE_COUNT so the layout does not shift when phases are added
+#define PERF_COUNTERS_MAX_PHASES	16
+
+// Layout of the shared performance counter block, scraped by external
+// collectors via the named shared memory segment. The layout is append only:
+// add new fields at the end and bump the version. sequence is even while the
+// block is consistent and odd while it is being rewritten, so collectors
+// should re-read until they see the same even sequence before and after.
+typedef struct {
+	uint32 magic;
+	uint32 version;
+	uint32 sequence;
+	uint32 ticks;				// current game tick counter
+
+	// Gauges
+	uint32 guestsInPark;
+	uint32 spritesInUse;
+	uint32 spritesMax;
+	uint32 dirtyBlocksDrawn;	// cumulative dirty grid blocks redrawn
+
+	// Tick durations over the profiler's rolling history, in microseconds
+	uint32 updateP50Us;
+	uint32 updateP95Us;
+	uint32 updateMaxUs;
+	uint32 drawP50Us;
+	uint32 drawP95Us;
+	uint32 drawMaxUs;
+
+	// Average game logic phase times over the history, in microseconds, in
+	// the order of the GAME_LOGIC_PHASE enum
+	uint32 numPhases;
+	uint32 phaseAverageUs[PERF_COUNTERS_MAX_PHASES];
+
+	// Version 2: rolling state hashes maintained by statehash.c. Zero in
+	// stateDigestValid means the hashes are still converging after a load.
+	// Equal digests on equal ticks across a record/replay pair mean the
+	// simulations agree.
+	uint32 stateDigestValid;
+	uint32 stateDigest;
+	uint32 stateDigestMap;
+	uint32 stateDigestSprites;
+	uint32 stateDigestRides;
+
+	// Version 3: audio mixer buffer telemetry, see audio/mixer.cpp. The
+	// buffer size adapts at runtime; underruns count callbacks that missed
+	// their real time deadline, cumulative across resizes.
+	uint32 audioBufferSamples;
+	uint32 audioUnderruns;
+	uint32 audioCallbackPeakUs;
+	uint32 audioCallbackAvgUs;
+} perf_counters_block;
+
+void perfcounters_init();
+void perfcounters_dispose();
+void perfcounters_update();
+
+#endif
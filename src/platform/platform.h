@@ -41,6 +41,19 @@ typedef struct {
 	uint64 last_modified;
 } file_info;
 
+typedef struct {
+	uint8 *data;
+	uint32 size;
+	void *handle;		// Platform specific
+	void *mapHandle;	// Platform specific
+} file_mapping;
+
+typedef struct {
+	uint8 *data;
+	uint32 size;
+	void *handle;		// Platform specific
+} shared_memory;
+
 typedef struct {
 	int x, y;
 	unsigned char left, middle, right, any;
@@ -77,6 +90,7 @@ void platform_update_palette(char* colours, int start_index, int num_colours);
 void platform_set_fullscreen_mode(int mode);
 void platform_set_cursor(char cursor);
 void platform_process_messages();
+uint32 platform_get_last_input_tick();
 int platform_scancode_to_rct_keycode(int sdl_key);
 void platform_start_text_input(char* buffer, int max_length);
 void platform_stop_text_input();
@@ -84,6 +98,7 @@ void platform_stop_text_input();
 // Platform specific definitions
 char platform_get_path_separator();
 int platform_file_exists(const char *path);
+uint64 platform_file_get_modified_time(const char *path);
 int platform_directory_exists(const char *path);
 int platform_ensure_directory_exists(const char *path);
 int platform_lock_single_instance();
@@ -96,6 +111,10 @@ void platform_enumerate_directories_end(int handle);
 int platform_file_copy(const char *srcPath, const char *dstPath);
 int platform_file_move(const char *srcPath, const char *dstPath);
 int platform_file_delete(const char *path);
+int platform_file_map(const char *path, file_mapping *fm);
+void platform_file_unmap(file_mapping *fm);
+int platform_shared_memory_create(const char *name, uint32 size, shared_memory *sm);
+void platform_shared_memory_close(shared_memory *sm);
 void platform_hide_cursor();
 void platform_show_cursor();
 void platform_get_cursor_position(int *x, int *y);
@@ -110,6 +129,14 @@ uint16 platform_get_locale_language();
 uint8 platform_get_locale_measurement_format();
 uint8 platform_get_locale_temperature_format();
 
+// Unix specific definitions
+#ifndef _WIN32
+	// Fixes the case of each path component against the file system, using
+	// cached directory listings, so RCT2's case-mangled data filenames
+	// resolve without a directory scan per open.
+	bool platform_resolve_path_case(utf8 *path);
+#endif
+
 // Windows specific definitions
 #ifdef _WIN32
 	// Defining WIN32_LEAN_AND_MEAN breaks dsound.h in audio.h (uncomment when dsound is finally removed)
@@ -25,8 +25,12 @@
 #include "../cursors.h"
 #include "../drawing/drawing.h"
 #include "../interface/keyboard_shortcut.h"
+#include "../interface/paintheatmap.h"
+#include "../interface/profiler.h"
+#include "../interface/viewport.h"
 #include "../interface/window.h"
 #include "../input.h"
+#include "../openrct2.h"
 #include "platform.h"
 
 typedef void(*update_palette_func)(char*, int, int);
@@ -48,12 +52,15 @@ SDL_Window *gWindow;
 
 static SDL_Surface *_surface;
 static SDL_Palette *_palette;
+static SDL_Color _paletteColours[256];
+static bool _paletteUploadAll = true;
 static int _screenBufferSize;
 static void *_screenBuffer;
 static SDL_Cursor* _cursors[CURSOR_COUNT];
 static const int _fullscreen_modes[] = { 0, SDL_WINDOW_FULLSCREEN, SDL_WINDOW_FULLSCREEN_DESKTOP };
 static unsigned int _lastGestureTimestamp;
 static float _gestureRadius;
+static uint32 _lastInputTick;
 
 static void platform_create_window();
 static void platform_load_cursors();
@@ -200,6 +207,7 @@ static void platform_resize(int width, int height)
 
 	_surface = SDL_CreateRGBSurface(0, width, height, 8, 0, 0, 0, 0);
 	_palette = SDL_AllocPalette(256);
+	_paletteUploadAll = true;
 
 	if (!_surface || !_palette) {
 		RCT2_ERROR("%p || %p == NULL %s", _surface, _palette, SDL_GetError());
@@ -264,28 +272,44 @@ static void platform_resize(int width, int height)
 
 void platform_update_palette(char* colours, int start_index, int num_colours)
 {
-	SDL_Color base[256];
-	SDL_Surface *surface;
-	int i;
-
-	surface = SDL_GetWindowSurface(gWindow);
-	if (!surface) {
-		RCT2_ERROR("SDL_GetWindowSurface failed %s", SDL_GetError());
-		exit(1);
+	int i, start, count;
+
+	// The first update after (re)creating the palette must upload every
+	// entry, afterwards only the range the caller changed needs converting
+	// and uploading. The palette effects run every frame but only touch a
+	// handful of entries, so this avoids rebuilding all 256 each time.
+	if (_paletteUploadAll) {
+		_paletteUploadAll = false;
+		start = 0;
+		count = 256;
+	} else {
+		start = start_index;
+		count = num_colours;
 	}
 
-	for (i = 0; i < 256; i++) {
-		base[i].r = colours[2];
-		base[i].g = colours[1];
-		base[i].b = colours[0];
-		base[i].a = 0;
-		colours += 4;
+	for (i = start; i < start + count; i++) {
+		_paletteColours[i].r = colours[(i * 4) + 2];
+		_paletteColours[i].g = colours[(i * 4) + 1];
+		_paletteColours[i].b = colours[(i * 4) + 0];
+		_paletteColours[i].a = 0;
 	}
 
-	if (SDL_SetPaletteColors(_palette, base, 0, 256)) {
+	if (SDL_SetPaletteColors(_palette, &_paletteColours[start], start, count)) {
 		RCT2_ERROR("SDL_SetPaletteColors failed %s", SDL_GetError());
 		exit(1);
 	}
+
+	// A palette change alters what the unchanged buffer looks like on screen
+	gfx_request_present();
+}
+
+/**
+ * Returns the SDL tick of the most recent event, for the idle render mode's
+ * input idleness check.
+ */
+uint32 platform_get_last_input_tick()
+{
+	return _lastInputTick;
 }
 
 void platform_process_messages()
@@ -300,6 +324,12 @@ void platform_process_messages()
 	gCursorState.old = 0;
 
 	while (SDL_PollEvent(&e)) {
+		// Any event counts as activity for the idle render mode, and window
+		// events can expose a stale surface
+		_lastInputTick = SDL_GetTicks();
+		if (e.type == SDL_WINDOWEVENT)
+			gfx_request_present();
+
 		switch (e.type) {
 		case SDL_QUIT:
 // 			rct2_finish();
@@ -365,6 +395,28 @@ void platform_process_messages()
 
 			gLastKeyPressed = e.key.keysym.sym;
 			gKeysPressed[e.key.keysym.scancode] = 1;
+			if (e.key.keysym.sym == SDLK_F10) {
+				// Frame profiler overlay; shift dumps the history to CSV
+				if (e.key.keysym.mod & KMOD_SHIFT)
+					profiler_export_csv();
+				else
+					profiler_toggle();
+				break;
+			}
+			if (e.key.keysym.sym == SDLK_F11) {
+				// Pathfinding cost heatmap over footpath tiles; shift
+				// toggles the paint cost heatmap instead
+				if (e.key.keysym.mod & KMOD_SHIFT) {
+					paint_heatmap_toggle();
+				} else {
+					rct_window *mainWindow = window_get_main();
+					if (mainWindow != NULL) {
+						mainWindow->viewport->flags ^= VIEWPORT_FLAG_PATH_HEAT;
+						window_invalidate(mainWindow);
+					}
+				}
+				break;
+			}
 			if (e.key.keysym.sym == SDLK_RETURN && e.key.keysym.mod & KMOD_ALT) {
 				int targetMode = gConfigGeneral.fullscreen_mode == 0 ? 2 : 0;
 				platform_set_fullscreen_mode(targetMode);
@@ -496,7 +548,8 @@ static void platform_create_window()
 
 	// Create window in window first rather than fullscreen so we have the display the window is on first
 	gWindow = SDL_CreateWindow(
-		"OpenRCT2", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height, SDL_WINDOW_RESIZABLE
+		"OpenRCT2", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, width, height,
+		gOpenRCT2Headless ? SDL_WINDOW_HIDDEN : SDL_WINDOW_RESIZABLE
 	);
 	if (!gWindow) {
 		log_fatal("SDL_CreateWindow failed %s", SDL_GetError());
@@ -510,7 +563,8 @@ static void platform_create_window()
 	platform_resize(width, height);
 
 	platform_update_fullscreen_resolutions();
-	platform_set_fullscreen_mode(gConfigGeneral.fullscreen_mode);
+	if (!gOpenRCT2Headless)
+		platform_set_fullscreen_mode(gConfigGeneral.fullscreen_mode);
 }
 
 int platform_scancode_to_rct_keycode(int sdl_key)
@@ -21,8 +21,15 @@
 #ifndef _WIN32
 #ifndef __APPLE__
 
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
 #include "../cmdline.h"
 #include "../openrct2.h"
+#include "../util/util.h"
+#include "platform.h"
 
 /**
  * Unix, linux and fallback entry point to OpenRCT2.
@@ -31,7 +38,7 @@
 // {
 //     if (cmdline_run(argv, argc))
 //       openrct2_launch();
-// 
+//
 //     return gExitCode;
 // }
 
@@ -40,5 +47,163 @@ char platform_get_path_separator()
 	return '/';
 }
 
+// RCT2's data files are referenced with inconsistent casing, which on a case
+// sensitive file system would need a directory scan for every open. Each
+// scanned directory listing is cached and lookups are answered from it; a
+// cached listing is revalidated by the directory's mtime, so files added or
+// renamed outside the game are picked up without a rescan per open.
+#define DIRECTORY_CASE_CACHE_SIZE 16
+
+typedef struct {
+	char path[MAX_PATH];
+	time_t mtime;
+	int num_entries;
+	char **entries;
+	uint32 lru;
+} directory_case_cache;
+
+static directory_case_cache _directoryCaseCache[DIRECTORY_CASE_CACHE_SIZE];
+static uint32 _directoryCaseCacheTicks;
+
+static void directory_case_cache_clear(directory_case_cache *cache)
+{
+	int i;
+
+	for (i = 0; i < cache->num_entries; i++)
+		free(cache->entries[i]);
+	free(cache->entries);
+	cache->entries = NULL;
+	cache->num_entries = 0;
+	cache->path[0] = 0;
+	cache->lru = 0;
+}
+
+static bool directory_case_cache_build(directory_case_cache *cache, const char *directory, time_t mtime)
+{
+	int capacity;
+	DIR *dir;
+	struct dirent *entry;
+
+	dir = opendir(directory);
+	if (dir == NULL)
+		return false;
+
+	capacity = 64;
+	cache->entries = malloc(capacity * sizeof(char*));
+	cache->num_entries = 0;
+	while ((entry = readdir(dir)) != NULL) {
+		if (cache->num_entries == capacity) {
+			capacity *= 2;
+			cache->entries = realloc(cache->entries, capacity * sizeof(char*));
+		}
+		cache->entries[cache->num_entries++] = strdup(entry->d_name);
+	}
+	closedir(dir);
+
+	strcpy(cache->path, directory);
+	cache->mtime = mtime;
+	return true;
+}
+
+static directory_case_cache *directory_case_cache_get(const char *directory)
+{
+	int i;
+	struct stat statInfo;
+	directory_case_cache *cache, *lru;
+
+	if (stat(directory, &statInfo) != 0)
+		return NULL;
+
+	_directoryCaseCacheTicks++;
+	lru = &_directoryCaseCache[0];
+	for (i = 0; i < DIRECTORY_CASE_CACHE_SIZE; i++) {
+		cache = &_directoryCaseCache[i];
+		if (cache->lru < lru->lru)
+			lru = cache;
+		if (cache->lru != 0 && strcmp(cache->path, directory) == 0) {
+			cache->lru = _directoryCaseCacheTicks;
+			if (cache->mtime == statInfo.st_mtime)
+				return cache;
+
+			// Directory changed on disk, rebuild the listing
+			directory_case_cache_clear(cache);
+			cache->lru = _directoryCaseCacheTicks;
+			if (!directory_case_cache_build(cache, directory, statInfo.st_mtime)) {
+				cache->lru = 0;
+				return NULL;
+			}
+			return cache;
+		}
+	}
+
+	cache = lru;
+	directory_case_cache_clear(cache);
+	cache->lru = _directoryCaseCacheTicks;
+	if (!directory_case_cache_build(cache, directory, statInfo.st_mtime)) {
+		cache->lru = 0;
+		return NULL;
+	}
+	return cache;
+}
+
+/**
+ * Fixes the case of each component of path so that it names an existing file
+ * on a case sensitive file system, using the cached directory listings.
+ * Returns true and rewrites path in place if every component resolved.
+ */
+bool platform_resolve_path_case(utf8 *path)
+{
+	int i;
+	char buffer[MAX_PATH], resolved[MAX_PATH], *component, *nextComponent;
+	directory_case_cache *cache;
+
+	// Common case, the path is already correct
+	if (access(path, F_OK) == 0)
+		return true;
+
+	if (strlen(path) >= MAX_PATH)
+		return false;
+	strcpy(buffer, path);
+	strcpy(resolved, buffer[0] == '/' ? "/" : "");
+
+	component = buffer;
+	while (*component == '/')
+		component++;
+	for (; component != NULL && *component != 0; component = nextComponent) {
+		nextComponent = strchr(component, '/');
+		if (nextComponent != NULL) {
+			*nextComponent++ = 0;
+			while (*nextComponent == '/')
+				nextComponent++;
+		}
+
+		char candidate[MAX_PATH];
+		if (strlen(resolved) + strlen(component) + 2 > MAX_PATH)
+			return false;
+		sprintf(candidate, "%s%s%s", resolved, resolved[0] == 0 || resolved[strlen(resolved) - 1] == '/' ? "" : "/", component);
+		if (access(candidate, F_OK) == 0) {
+			strcpy(resolved, candidate);
+			continue;
+		}
+
+		cache = directory_case_cache_get(resolved[0] == 0 ? "." : resolved);
+		if (cache == NULL)
+			return false;
+		for (i = 0; i < cache->num_entries; i++)
+			if (strcicmp(cache->entries[i], component) == 0)
+				break;
+		if (i == cache->num_entries)
+			return false;
+
+		if (strlen(resolved) + strlen(cache->entries[i]) + 2 > MAX_PATH)
+			return false;
+		sprintf(candidate, "%s%s%s", resolved, resolved[0] == 0 || resolved[strlen(resolved) - 1] == '/' ? "" : "/", cache->entries[i]);
+		strcpy(resolved, candidate);
+	}
+
+	strcpy(path, resolved);
+	return true;
+}
+
 #endif
 #endif
\ No newline at end of file
@@ -279,6 +279,99 @@ int platform_file_delete(const char *path)
 	return DeleteFileA(path);
 }
 
+uint64 platform_file_get_modified_time(const char *path)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+
+	if (!GetFileAttributesEx(path, GetFileExInfoStandard, &data))
+		return 0;
+	return ((uint64)data.ftLastWriteTime.dwHighDateTime << 32ULL) | (uint64)data.ftLastWriteTime.dwLowDateTime;
+}
+
+/**
+ * Maps a whole file into memory, read only. Returns 1 on success; the mapping
+ * must be released again with platform_file_unmap.
+ */
+int platform_file_map(const char *path, file_mapping *fm)
+{
+	HANDLE hFile, hMap;
+	DWORD size;
+	void *data;
+
+	hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+		return 0;
+
+	size = GetFileSize(hFile, NULL);
+	if (size == INVALID_FILE_SIZE || size == 0) {
+		CloseHandle(hFile);
+		return 0;
+	}
+
+	hMap = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (hMap == NULL) {
+		CloseHandle(hFile);
+		return 0;
+	}
+
+	data = MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+	if (data == NULL) {
+		CloseHandle(hMap);
+		CloseHandle(hFile);
+		return 0;
+	}
+
+	fm->data = data;
+	fm->size = size;
+	fm->handle = hFile;
+	fm->mapHandle = hMap;
+	return 1;
+}
+
+void platform_file_unmap(file_mapping *fm)
+{
+	UnmapViewOfFile(fm->data);
+	CloseHandle((HANDLE)fm->mapHandle);
+	CloseHandle((HANDLE)fm->handle);
+	fm->data = NULL;
+	fm->size = 0;
+}
+
+/**
+ * Creates (or opens, if it already exists) a named pagefile backed shared
+ * memory segment that other local processes can open by the same name.
+ * Returns 1 on success; the segment must be released again with
+ * platform_shared_memory_close.
+ */
+int platform_shared_memory_create(const char *name, uint32 size, shared_memory *sm)
+{
+	HANDLE hMap;
+	void *data;
+
+	hMap = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, size, name);
+	if (hMap == NULL)
+		return 0;
+
+	data = MapViewOfFile(hMap, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if (data == NULL) {
+		CloseHandle(hMap);
+		return 0;
+	}
+
+	sm->data = data;
+	sm->size = size;
+	sm->handle = hMap;
+	return 1;
+}
+
+void platform_shared_memory_close(shared_memory *sm)
+{
+	UnmapViewOfFile(sm->data);
+	CloseHandle((HANDLE)sm->handle);
+	sm->data = NULL;
+	sm->size = 0;
+}
+
 void platform_hide_cursor()
 {
 	ShowCursor(FALSE);
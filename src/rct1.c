@@ -24,10 +24,12 @@
 #include "localisation/localisation.h"
 #include "management/finance.h"
 #include "object.h"
+#include "platform/platform.h"
 #include "rct1.h"
 #include "scenario.h"
 #include "util/sawyercoding.h"
 #include "util/util.h"
+#include "util/workerpool.h"
 #include "world/climate.h"
 #include "world/map.h"
 #include "world/scenery.h"
@@ -56,12 +58,48 @@ static void read(void *dst, void *src, int length)
 	memcpy(dst, src, length);
 }
 
+// Decoded S4 cache. The decode dominates the import of a classic park, so
+// the last decoded file is kept around; re-importing it (common when trying
+// out conversion settings over an archive) skips the read and decode
+// entirely. The conversion itself still runs, as it rewrites global state.
+static rct1_s4 *_decodedS4Cache;
+static char _decodedS4CachePath[MAX_PATH];
+static uint64 _decodedS4CacheModified;
+
+static bool rct1_decoded_cache_get(const char *path, rct1_s4 *s4)
+{
+	if (_decodedS4Cache == NULL)
+		return false;
+	if (_stricmp(path, _decodedS4CachePath) != 0)
+		return false;
+	if (platform_file_get_modified_time(path) != _decodedS4CacheModified)
+		return false;
+
+	memcpy(s4, _decodedS4Cache, sizeof(rct1_s4));
+	return true;
+}
+
+static void rct1_decoded_cache_set(const char *path, rct1_s4 *s4)
+{
+	if (strlen(path) >= MAX_PATH)
+		return;
+
+	if (_decodedS4Cache == NULL)
+		_decodedS4Cache = malloc(sizeof(rct1_s4));
+	memcpy(_decodedS4Cache, s4, sizeof(rct1_s4));
+	strcpy(_decodedS4CachePath, path);
+	_decodedS4CacheModified = platform_file_get_modified_time(path);
+}
+
 bool rct1_read_sc4(const char *path, rct1_s4 *s4)
 {
 	char *buffer, *decodedBuffer;
 	long length, decodedLength;
 	bool success;
 
+	if (rct1_decoded_cache_get(path, s4))
+		return true;
+
 	if (!readentirefile(path, (void**)&buffer, &length)) {
 		RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) = 255;
 		RCT2_GLOBAL(RCT2_ADDRESS_ERROR_STRING_ID, uint16) = 3011;
@@ -76,6 +114,7 @@ bool rct1_read_sc4(const char *path, rct1_s4 *s4)
 		sawyercoding_decode_sc4(buffer, decodedBuffer, length);
 	if (decodedLength == sizeof(rct1_s4)) {
 		memcpy(s4, decodedBuffer, sizeof(rct1_s4));
+		rct1_decoded_cache_set(path, s4);
 		success = true;
 	} else {
 		success = false;
@@ -92,6 +131,9 @@ bool rct1_read_sv4(const char *path, rct1_s4 *s4)
 	long length, decodedLength;
 	bool success;
 
+	if (rct1_decoded_cache_get(path, s4))
+		return true;
+
 	if (!readentirefile(path, (void**)&buffer, &length)) {
 		RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) = 255;
 		RCT2_GLOBAL(RCT2_ADDRESS_ERROR_STRING_ID, uint16) = 3011;
@@ -102,6 +144,7 @@ bool rct1_read_sv4(const char *path, rct1_s4 *s4)
 	decodedLength = sawyercoding_decode_sv4(buffer, decodedBuffer, length);
 	if (decodedLength == sizeof(rct1_s4)) {
 		memcpy(s4, decodedBuffer, sizeof(rct1_s4));
+		rct1_decoded_cache_set(path, s4);
 		success = true;
 	} else {
 		success = false;
@@ -113,61 +156,89 @@ bool rct1_read_sv4(const char *path, rct1_s4 *s4)
 }
 
 /**
- *
- *  rct2: 0x0069EEA0
+ * The import copies independent tables into disjoint global ranges, so the
+ * copies run as worker pool jobs. Each job keeps its internal ordering (a
+ * table read followed by fixups of that table), but no job reads or writes
+ * another job's destination range.
  */
-void rct1_import_s4(rct1_s4 *s4)
+static void rct1_import_s4_job(void *context, int index)
 {
+	rct1_s4 *s4 = context;
 	int i;
 	rct_banner *banner;
 
-	read((void*)RCT2_ADDRESS_CURRENT_MONTH_YEAR, &s4->month, 16);
-	memset((void*)RCT2_ADDRESS_MAP_ELEMENTS, 0, 0x30000 * sizeof(rct_map_element));
-	read((void*)RCT2_ADDRESS_MAP_ELEMENTS, s4->map_elements, sizeof(s4->map_elements));
-	read((void*)0x010E63B8, &s4->unk_counter, 4 + sizeof(s4->sprites));
-
-	for (i = 0; i < MAX_BANNERS; i++)
-		gBanners[i].type = 255;
-
-	read((void*)0x013573BC, &s4->next_sprite_index, 12424);
-
-	for (i = 0; i < MAX_BANNERS; i++) {
-		banner = &gBanners[i];
-		if (banner->type != 255 && banner->string_idx != 3458)
-			banner->string_idx = 778;
-	}
-
-	read((void*)0x0135A8F4, &s4->string_table, 0x2F51C);
-	memset((void*)0x013CA672, 0, 204);
-	read((void*)0x0138B580, &s4->map_animations, 0x258F2);
-	read((void*)0x013C6A72, &s4->patrol_areas, sizeof(s4->patrol_areas));
-
-	char *esi = (char*)0x13C6A72;
-	char *edi = (char*)0x13B0E72;
-	int ebx, edx = 116;
-	do {
-		ebx = 32;
+	switch (index) {
+	case 0:
+		// Map elements; the largest single copy
+		memset((void*)RCT2_ADDRESS_MAP_ELEMENTS, 0, 0x30000 * sizeof(rct_map_element));
+		read((void*)RCT2_ADDRESS_MAP_ELEMENTS, s4->map_elements, sizeof(s4->map_elements));
+		break;
+	case 1:
+		// Sprites
+		read((void*)0x010E63B8, &s4->unk_counter, 4 + sizeof(s4->sprites));
+		break;
+	case 2:
+		// Sprite indices and banners
+		for (i = 0; i < MAX_BANNERS; i++)
+			gBanners[i].type = 255;
+
+		read((void*)0x013573BC, &s4->next_sprite_index, 12424);
+
+		for (i = 0; i < MAX_BANNERS; i++) {
+			banner = &gBanners[i];
+			if (banner->type != 255 && banner->string_idx != 3458)
+				banner->string_idx = 778;
+		}
+		break;
+	case 3:
+		// User strings and map animations
+		read((void*)0x0135A8F4, &s4->string_table, 0x2F51C);
+		read((void*)0x0138B580, &s4->map_animations, 0x258F2);
+		break;
+	case 4:
+		// Patrol areas; the expanded copy below reads from the packed table
+		// this read fills in, so both stay in the same job
+		read((void*)0x013C6A72, &s4->patrol_areas, sizeof(s4->patrol_areas));
+
+		char *esi = (char*)0x13C6A72;
+		char *edi = (char*)0x13B0E72;
+		int ebx, edx = 116;
 		do {
-			memcpy(edi, esi, 4); esi += 4; edi += 4;
-			memset(edi, 0, 4); edi += 4;
-		} while (--ebx > 0);
-		memset(edi, 0, 64); edi += 64;
-	} while (--edx > 0);
-	edi += 0xA800;
-	
-	edx = 4;
-	do {
-		ebx = 32;
+			ebx = 32;
+			do {
+				memcpy(edi, esi, 4); esi += 4; edi += 4;
+				memset(edi, 0, 4); edi += 4;
+			} while (--ebx > 0);
+			memset(edi, 0, 64); edi += 64;
+		} while (--edx > 0);
+		edi += 0xA800;
+
+		edx = 4;
 		do {
-			memcpy(edi, esi, 4); esi += 4; edi += 4;
-			memset(edi, 0, 4); edi += 4;
-		} while (--ebx);
-		memset(edi, 0, 64); edi += 64;
-	} while (--edx);
-
-	read((void*)0x013CA672, &s4->unk_1F42AA, 116);
-	read((void*)0x013CA73A, &s4->unk_1F431E, 4);
-	read((void*)0x013CA73E, &s4->unk_1F4322, 0x41EA);
+			ebx = 32;
+			do {
+				memcpy(edi, esi, 4); esi += 4; edi += 4;
+				memset(edi, 0, 4); edi += 4;
+			} while (--ebx);
+			memset(edi, 0, 64); edi += 64;
+		} while (--edx);
+
+		memset((void*)0x013CA672, 0, 204);
+		read((void*)0x013CA672, &s4->unk_1F42AA, 116);
+		read((void*)0x013CA73A, &s4->unk_1F431E, 4);
+		read((void*)0x013CA73E, &s4->unk_1F4322, 0x41EA);
+		break;
+	}
+}
+
+/**
+ *
+ *  rct2: 0x0069EEA0
+ */
+void rct1_import_s4(rct1_s4 *s4)
+{
+	read((void*)RCT2_ADDRESS_CURRENT_MONTH_YEAR, &s4->month, 16);
+	worker_pool_run(rct1_import_s4_job, s4, 5);
 }
 
 /**
@@ -349,18 +420,18 @@ static void rct1_load_default_objects()
 static void rct1_fix_terrain()
 {
 	rct_map_element *element;
-	map_element_iterator it;
+	map_tile_span_iterator it;
 
-	map_element_iterator_begin(&it);
-	while (map_element_iterator_next(&it)) {
-		element = it.element;
+	map_tile_span_iterator_begin(&it);
+	while (map_tile_span_iterator_next(&it)) {
+		for (element = it.first; element <= it.last; element++) {
+			if (map_element_get_type(element) != MAP_ELEMENT_TYPE_SURFACE)
+				continue;
 
-		if (map_element_get_type(element) != MAP_ELEMENT_TYPE_SURFACE)
-			continue;
-		
-		// Convert terrain
-		map_element_set_terrain(element, RCT1TerrainConvertTable[map_element_get_terrain(element)]);
-		map_element_set_terrain_edge(element, RCT1TerrainEdgeConvertTable[map_element_get_terrain_edge(element)]);
+			// Convert terrain
+			map_element_set_terrain(element, RCT1TerrainConvertTable[map_element_get_terrain(element)]);
+			map_element_set_terrain_edge(element, RCT1TerrainEdgeConvertTable[map_element_get_terrain_edge(element)]);
+		}
 	}
 }
 
@@ -371,23 +442,23 @@ static void rct1_fix_terrain()
 static void rct1_fix_scenery()
 {
 	rct_map_element *element;
-	map_element_iterator it;
-
-	map_element_iterator_begin(&it);
-	while (map_element_iterator_next(&it)) {
-		element = it.element;
-
-		if (map_element_get_type(element) != MAP_ELEMENT_TYPE_SCENERY)
-			continue;
-
-		switch (element->properties.scenery.type) {
-		case 157:	// TGE1	(Geometric Sculpture)
-		case 162:	// TGE2	(Geometric Sculpture)
-		case 168:	// TGE3	(Geometric Sculpture)
-		case 170:	// TGE4	(Geometric Sculpture)
-		case 171:	// TGE5	(Geometric Sculpture)
-			element->properties.scenery.colour_2 = 2;
-			break;
+	map_tile_span_iterator it;
+
+	map_tile_span_iterator_begin(&it);
+	while (map_tile_span_iterator_next(&it)) {
+		for (element = it.first; element <= it.last; element++) {
+			if (map_element_get_type(element) != MAP_ELEMENT_TYPE_SCENERY)
+				continue;
+
+			switch (element->properties.scenery.type) {
+			case 157:	// TGE1	(Geometric Sculpture)
+			case 162:	// TGE2	(Geometric Sculpture)
+			case 168:	// TGE3	(Geometric Sculpture)
+			case 170:	// TGE4	(Geometric Sculpture)
+			case 171:	// TGE5	(Geometric Sculpture)
+				element->properties.scenery.colour_2 = 2;
+				break;
+			}
 		}
 	}
 }
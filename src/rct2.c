@@ -92,6 +92,7 @@ int rct2_init()
 
 	ride_list_item item = { 253, 0 };
 	track_load_list(item);
+	track_blocks_init();
 
 	gfx_load_g1();
 	gfx_load_character_widths();
@@ -335,6 +336,8 @@ void rct2_update_2()
 	if (RCT2_GLOBAL(RCT2_ADDRESS_ON_TUTORIAL, uint8) != 0)
 		RCT2_GLOBAL(0x009DE588, sint16) = 31;
 
+	config_hot_reload_update();
+
 	// TODO: screenshot countdown process
 
 	// check_cmdline_arg();
@@ -36,9 +36,11 @@
 #include "../windows/error.h"
 #include "../world/banner.h"
 #include "../world/map.h"
+#include "../world/park.h"
 #include "../world/sprite.h"
 #include "ride.h"
 #include "ride_data.h"
+#include "ride_stats.h"
 #include "track.h"
 #include "station.h"
 
@@ -164,15 +166,57 @@ uint8 *get_ride_entry_indices_for_ride_type(uint8 rideType)
 	return entryIndexList;
 }
 
-int ride_get_count()
+#pragma region Active ride index cache
+
+// Cached indices of the non null ride slots, so FOR_ALL_RIDES only visits
+// allocated rides instead of scanning all 255 slots on every enumeration.
+// The table itself cannot grow while the exe still owns it (uint8 ride
+// indices are baked into exe code and the save format), but almost every
+// consumer only needs the live slots. Everything that creates or deletes a
+// ride funnels through a game command, a load or one of the native deletion
+// sites, all of which invalidate the cache.
+static uint8 _activeRideIndices[MAX_RIDES];
+static int _activeRideCount = -1;
+
+void ride_index_cache_invalidate()
 {
-	rct_ride *ride;
-	int i, count = 0;
+	_activeRideCount = -1;
+}
 
-	FOR_ALL_RIDES(i, ride)
-		count++;
+/**
+ * Returns the number of active rides, rebuilding the index cache if a ride
+ * has been created or deleted since it was last built.
+ */
+int ride_active_count()
+{
+	int i;
 
-	return count;
+	if (_activeRideCount == -1) {
+		_activeRideCount = 0;
+		for (i = 0; i < MAX_RIDES; i++)
+			if (g_ride_list[i].type != RIDE_TYPE_NULL)
+				_activeRideIndices[_activeRideCount++] = i;
+	}
+	return _activeRideCount;
+}
+
+/**
+ * Returns the ride index of the nth active ride, ascending. Deliberately does
+ * not rebuild the cache: FOR_ALL_RIDES snapshots the count when the loop
+ * begins, so a loop body that deletes rides keeps enumerating the original
+ * list (deleted entries are filtered by the RIDE_TYPE_NULL check) and one
+ * that creates rides sees them on the next enumeration.
+ */
+uint8 ride_active_get(int n)
+{
+	return _activeRideIndices[n];
+}
+
+#pragma endregion
+
+int ride_get_count()
+{
+	return ride_active_count();
 }
 
 int ride_get_total_queue_length(rct_ride *ride)
@@ -352,42 +396,24 @@ int track_get_next(rct_xy_element *input, rct_xy_element *output)
 int ride_find_track_gap(rct_xy_element *input, rct_xy_element *output)
 {
 	int rideIndex;
-	rct_xy_element trackElement, nextTrackElement;
-	rct_map_element *loopTrackElement;
+	rct_track_layout layout;
 	rct_ride *ride;
 	rct_window *w;
 
-	trackElement = *input;
-	rideIndex = trackElement.element->properties.track.ride_index;
+	rideIndex = input->element->properties.track.ride_index;
 	ride = GET_RIDE(rideIndex);
 
 	if (ride->type == RIDE_TYPE_MAZE)
 		return 0;
-	
+
 	w = window_find_by_class(WC_RIDE_CONSTRUCTION);
-	if (w != NULL && RCT2_GLOBAL(0x00F440A6, uint8) != 0 && RCT2_GLOBAL(0x00F440A7, uint8) == rideIndex)
+	if (w != NULL && RCT2_GLOBAL(0x00F440A6, uint8) != 0 && RCT2_GLOBAL(0x00F440A7, uint8) == rideIndex) {
 		sub_6C9627();
-
-	loopTrackElement = NULL;
-	while (1) {
-		if (!track_get_next(&trackElement, &nextTrackElement)) {
-			*output = trackElement;
-			return 1;
-		}
-
-		if (!track_is_connected_by_shape(trackElement.element, nextTrackElement.element)) {
-			*output = nextTrackElement;
-			return 1;
-		}
-
-		trackElement = nextTrackElement;
-		if (loopTrackElement == NULL)
-			loopTrackElement = trackElement.element;
-		else if (loopTrackElement == trackElement.element)
-			break;
+		track_layout_cache_invalidate();
 	}
 
-	return 0;
+	track_layout_compile(input, &layout);
+	return track_layout_find_gap(&layout, output);
 }
 
 /**
@@ -489,6 +515,8 @@ void ride_init_all()
 		ride_measurement = GET_RIDE_MEASUREMENT(i);
 		ride_measurement->ride_index = 255;
 	}
+
+	ride_index_cache_invalidate();
 }
 
 /**
@@ -1079,25 +1107,91 @@ int sub_6CC3FB(int rideIndex)
  *
  *  rct2: 0x006ABE4C
  */
+// Ride totals for the park rating, taken during ride_update_all and stamped
+// with the tick; calculate_park_rating sweeps the rides itself when stale
+static int _rideRatingNumRides = 0;
+static int _rideRatingNumExcitingRides = 0;
+static int _rideRatingUptimeTotal = 0;
+static int _rideRatingExcitementTotal = 0;
+static int _rideRatingIntensityTotal = 0;
+static uint32 _rideRatingTick = 0xFFFFFFFF;
+
+// Set once per ride_update_all sweep; the breakdown and inspection cadences
+// are shared by every ride so they need not be re-derived per ride
+static bool _rideBreakdownUpdateDue = false;
+static bool _rideInspectionUpdateDue = false;
+
+bool ride_rating_totals_get(int *numRides, int *uptimeTotal, int *numExcitingRides, int *excitementTotal, int *intensityTotal)
+{
+	if (_rideRatingTick != RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32))
+		return false;
+
+	*numRides = _rideRatingNumRides;
+	*uptimeTotal = _rideRatingUptimeTotal;
+	*numExcitingRides = _rideRatingNumExcitingRides;
+	*excitementTotal = _rideRatingExcitementTotal;
+	*intensityTotal = _rideRatingIntensityTotal;
+	return true;
+}
+
 void ride_update_all()
 {
 	rct_s6_info *s6Info = (rct_s6_info*)0x0141F570;
 	rct_ride *ride;
-	int i;
+	int i, numRides, numExcitingRides, uptimeTotal, excitementTotal, intensityTotal;
 
 	// Remove all rides if scenario editor
 	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_SCENARIO_EDITOR) {
-		if (s6Info->var_000 <= 2)
+		if (s6Info->var_000 <= 2) {
 			FOR_ALL_RIDES(i, ride)
 				ride->type = RIDE_TYPE_NULL;
+			ride_index_cache_invalidate();
+		}
 		return;
 	}
 
 	window_update_viewport_ride_music();
 
-	// Update rides
-	FOR_ALL_RIDES(i, ride)
+	// Breakdown rolls and inspection countdowns run on fixed shared cadences
+	// (every 256th and 2048th tick); decide that once per sweep so the other
+	// 255 of 256 ticks the per-ride update does not even call into them. A
+	// per-ride timing wheel was rejected: the breakdown roll consumes
+	// scenario_rand in ride table order and the counters it advances are
+	// saved state shown in the UI, so rides cannot be visited off-cadence
+	// without desyncing the random stream.
+	_rideBreakdownUpdateDue =
+		!(RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) & 255) &&
+		!(RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_TRACK_DESIGNER);
+	_rideInspectionUpdateDue =
+		!(RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) & 2047) &&
+		!(RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_TRACK_DESIGNER);
+
+	// Update rides, tallying the totals the park rating needs while the
+	// ride structs are hot so the rating does not sweep them again
+	numRides = 0;
+	numExcitingRides = 0;
+	uptimeTotal = 0;
+	excitementTotal = 0;
+	intensityTotal = 0;
+	FOR_ALL_RIDES(i, ride) {
 		ride_update(i);
+		if (ride->type == RIDE_TYPE_NULL)
+			continue;
+
+		uptimeTotal += 100 - ride->downtime;
+		if (ride->excitement != -1) {
+			excitementTotal += ride->excitement / 8;
+			intensityTotal += ride->intensity / 8;
+			numExcitingRides++;
+		}
+		numRides++;
+	}
+	_rideRatingNumRides = numRides;
+	_rideRatingNumExcitingRides = numExcitingRides;
+	_rideRatingUptimeTotal = uptimeTotal;
+	_rideRatingExcitementTotal = excitementTotal;
+	_rideRatingIntensityTotal = intensityTotal;
+	_rideRatingTick = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
 
 	ride_music_update_final();
 }
@@ -1126,6 +1220,8 @@ static void ride_update(int rideIndex)
 	if (ride->var_122 >= 960) {
 		ride->var_122 = 0;
 
+		ride_stats_bucket_rotated(rideIndex);
+
 		ride->var_136 = ride->var_134;
 		ride->var_134 = ride->running_cost;
 		ride->running_cost = ride->age;
@@ -1152,14 +1248,16 @@ static void ride_update(int rideIndex)
 	else if (ride->type == RIDE_TYPE_SPIRAL_SLIDE)
 		ride_spiral_slide_update(ride);
 
-	ride_breakdown_update(rideIndex);
+	if (_rideBreakdownUpdateDue)
+		ride_breakdown_update(rideIndex);
 
 	// Various things include news messages
 	if (ride->lifecycle_flags & (RIDE_LIFECYCLE_BREAKDOWN_PENDING | RIDE_LIFECYCLE_BROKEN_DOWN | RIDE_LIFECYCLE_DUE_INSPECTION))
 		if (((RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) >> 1) & 255) == rideIndex)
 			ride_breakdown_status_update(rideIndex);
 
-	ride_inspection_update(ride);
+	if (_rideInspectionUpdateDue)
+		ride_inspection_update(ride);
 }
 
 /**
@@ -1278,10 +1376,8 @@ static void ride_inspection_update(rct_ride *ride)
 {
 	int i;
 
-	if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) & 2047)
-		return;
-	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_TRACK_DESIGNER)
-		return;
+	// Only called on every 2048th tick outside the track designer, see
+	// ride_update_all
 
 	ride->last_inspection++;
 	if (ride->last_inspection == 0)
@@ -1343,11 +1439,9 @@ static void ride_breakdown_update(int rideIndex)
 	int breakdownReason, unreliabilityAccumulator;
 	rct_ride *ride = GET_RIDE(rideIndex);
 
-	if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) & 255)
-		return;
-	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_TRACK_DESIGNER)
-		return;
-	
+	// Only called on every 256th tick outside the track designer, see
+	// ride_update_all
+
 	if (ride->lifecycle_flags & (RIDE_LIFECYCLE_BROKEN_DOWN | RIDE_LIFECYCLE_CRASHED))
 		ride->var_19C++;
 
@@ -1586,12 +1680,14 @@ static void ride_mechanic_status_update(int rideIndex, int mechanicStatus)
 			ride->window_invalidate_flags |= RIDE_INVALIDATE_RIDE_MAINTENANCE | RIDE_INVALIDATE_RIDE_LIST | RIDE_INVALIDATE_RIDE_MAIN;
 			ride->mechanic_status = RIDE_MECHANIC_STATUS_CALLING;
 			ride->breakdown_reason = breakdownReason;
+			park_appeal_ride_update(rideIndex);
 			ride_breakdown_add_news_item(rideIndex);
 		}
 		break;
 	case RIDE_MECHANIC_STATUS_CALLING:
 		if (RideAvailableBreakdowns[ride->type] == 0) {
 			ride->lifecycle_flags &= ~(RIDE_LIFECYCLE_BREAKDOWN_PENDING | RIDE_LIFECYCLE_BROKEN_DOWN | RIDE_LIFECYCLE_DUE_INSPECTION);
+			park_appeal_ride_update(rideIndex);
 			break;
 		}
 
@@ -1700,6 +1796,37 @@ rct_peep *ride_find_closest_mechanic(rct_ride *ride, int forInspection)
 	return find_closest_mechanic(x, y, forInspection);
 }
 
+/** Whether the given mechanic can currently be dispatched to x, y. */
+static bool mechanic_can_be_dispatched(rct_peep *peep, int x, int y, int forInspection)
+{
+	if (peep->staff_type != STAFF_TYPE_MECHANIC)
+		return false;
+
+	if (!forInspection) {
+		if (peep->state == PEEP_STATE_HEADING_TO_INSPECTION){
+			if (peep->sub_state >= 4)
+				return false;
+		}
+		else if (peep->state != PEEP_STATE_PATROLLING)
+			return false;
+
+		if (!(peep->staff_orders & STAFF_ORDERS_FIX_RIDES))
+			return false;
+	} else {
+		if (peep->state != PEEP_STATE_PATROLLING || !(peep->staff_orders & STAFF_ORDERS_INSPECT_RIDES))
+			return false;
+	}
+
+	if (map_is_location_in_park(x, y))
+		if (!mechanic_is_location_in_patrol(peep, x & 0xFFE0, y & 0xFFE0))
+			return false;
+
+	if (peep->x == (sint16)0x8000)
+		return false;
+
+	return true;
+}
+
 /**
  *
  *  rct2: 0x006B774B (forInspection = 0)
@@ -1710,43 +1837,43 @@ rct_peep *find_closest_mechanic(int x, int y, int forInspection)
 	unsigned int closestDistance, distance;
 	uint16 spriteIndex;
 	rct_peep *peep, *closestMechanic;
-		
-	closestDistance = -1;
-	FOR_ALL_STAFF(spriteIndex, peep) {
-		if (peep->staff_type != STAFF_TYPE_MECHANIC)
-			continue;
+	uint16 candidates[STAFF_MAX_COUNT];
+	int i, numCandidates;
 
-		if (!forInspection) {
-			if (peep->state == PEEP_STATE_HEADING_TO_INSPECTION){
-				if (peep->sub_state >= 4)
-					continue;
-			}
-			else if (peep->state != PEEP_STATE_PATROLLING)
+	closestDistance = -1;
+	closestMechanic = NULL;
+
+	if (map_is_location_in_park(x, y)) {
+		// The patrol index narrows the search down to mechanics whose
+		// patrol area covers the location (or who roam the whole park)
+		numCandidates = staff_get_patrol_area_candidates(STAFF_TYPE_MECHANIC, x & 0xFFE0, y & 0xFFE0, candidates);
+		for (i = 0; i < numCandidates; i++) {
+			peep = GET_PEEP(candidates[i]);
+			if (!mechanic_can_be_dispatched(peep, x, y, forInspection))
 				continue;
 
-			if (!(peep->staff_orders & STAFF_ORDERS_FIX_RIDES))
-				continue;
-		} else {
-			if (peep->state != PEEP_STATE_PATROLLING || !(peep->staff_orders & STAFF_ORDERS_INSPECT_RIDES))
-				continue;
+			// Should probably be euclidean or manhattan distance, this seems a bit naive
+			distance = max(abs(peep->x - x), abs(peep->y - y));
+			if (distance < closestDistance) {
+				closestDistance = distance;
+				closestMechanic = peep;
+			}
 		}
-
-		if (map_is_location_in_park(x, y))
-			if (!mechanic_is_location_in_patrol(peep, x & 0xFFE0, y & 0xFFE0))
+	} else {
+		// Outside the park every mechanic's patrol area applies
+		FOR_ALL_STAFF(spriteIndex, peep) {
+			if (!mechanic_can_be_dispatched(peep, x, y, forInspection))
 				continue;
-		
-		if (peep->x == (sint16)0x8000)
-			continue;
 
-		// Should probably be euclidean or manhattan distance, this seems a bit naive
-		distance = max(abs(peep->x - x), abs(peep->y - y));
-		if (distance < closestDistance) {
-			closestDistance = distance;
-			closestMechanic = peep;
+			distance = max(abs(peep->x - x), abs(peep->y - y));
+			if (distance < closestDistance) {
+				closestDistance = distance;
+				closestMechanic = peep;
+			}
 		}
 	}
 
-	return closestDistance == -1 ? NULL : closestMechanic;
+	return closestMechanic;
 }
 
 rct_peep *ride_get_assigned_mechanic(rct_ride *ride)
@@ -1987,16 +2114,43 @@ void ride_measurements_update()
 
 rct_ride_measurement *ride_get_existing_measurement(int rideIndex)
 {
-	int i;
+	rct_ride *ride;
 	rct_ride_measurement *measurement;
 
-	for (i = 0; i < MAX_RIDE_MEASUREMENTS; i++) {
-		measurement = GET_RIDE_MEASUREMENT(i);
-		if (measurement->ride_index == rideIndex)
-			return measurement;
-	}
+	// The ride records which measurement slot it owns, so no scan of the
+	// slots is needed. The graph widget looks its measurement up every
+	// update and paint, so this path should stay trivial.
+	ride = GET_RIDE(rideIndex);
+	if (ride->measurement_index == 255)
+		return NULL;
 
-	return NULL;
+	measurement = GET_RIDE_MEASUREMENT(ride->measurement_index);
+	if (measurement->ride_index != rideIndex)
+		return NULL;
+
+	return measurement;
+}
+
+/**
+ * Advances the measurement of a single ride by one sample. Accelerated
+ * testing runs several physics steps per tick and calls this after each
+ * extra one, so the ring buffers fill at the accelerated rate instead of
+ * sampling every Nth step.
+ */
+void ride_measurement_accelerated_update(int rideIndex)
+{
+	rct_ride *ride;
+	rct_ride_measurement *measurement;
+
+	ride = GET_RIDE(rideIndex);
+	if (!(ride->lifecycle_flags & RIDE_LIFECYCLE_ON_TRACK))
+		return;
+
+	measurement = ride_get_existing_measurement(rideIndex);
+	if (measurement == NULL || !(measurement->flags & RIDE_MEASUREMENT_FLAG_RUNNING))
+		return;
+
+	ride_measurement_update(measurement);
 }
 
 int ride_get_free_measurement()
@@ -3023,50 +3177,52 @@ int ride_check_block_brakes(rct_xy_element *input, rct_xy_element *output)
 {
 	// return RCT2_CALLPROC_X(0x006D3319, x, 0, y, 0, (int)mapElement, 0, 0) & 0x100;
 
-	int rideIndex, type;
-	rct_xy_element trackElement, nextTrackElement;
-	rct_map_element *loopTrackElement;
+	int rideIndex, type, i, nextIndex;
+	rct_track_segment *segment, *next;
+	rct_track_layout layout;
 	rct_window *w;
 
-	trackElement = *input;
-	rideIndex = trackElement.element->properties.track.ride_index;
+	rideIndex = input->element->properties.track.ride_index;
 	w = window_find_by_class(WC_RIDE_CONSTRUCTION);
-	if (w != NULL && RCT2_GLOBAL(0x00F440A6, uint8) != 0 && RCT2_GLOBAL(0x00F440A7, uint8) == rideIndex)
+	if (w != NULL && RCT2_GLOBAL(0x00F440A6, uint8) != 0 && RCT2_GLOBAL(0x00F440A7, uint8) == rideIndex) {
 		sub_6C9627();
+		track_layout_cache_invalidate();
+	}
 
-	loopTrackElement = NULL;
-	while (1) {
-		if (!track_get_next(&trackElement, &nextTrackElement)) {
-			// Not sure why this is the case...
-			RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_TEXT, uint16) = STR_BLOCK_BRAKES_CANNOT_BE_USED_DIRECTLY_AFTER_STATION;
-			*output = trackElement;
-			return 0;
-		}
+	track_layout_compile(input, &layout);
+	for (i = 0; i < layout.num_segments; i++) {
+		segment = &layout.segments[i];
 
-		if (nextTrackElement.element->properties.track.type == 216) {
-			type = trackElement.element->properties.track.type;
-			if (type == 1) {
+		nextIndex = i + 1;
+		if (nextIndex == layout.num_segments) {
+			if (!layout.is_circuit) {
+				// Not sure why this is the case...
 				RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_TEXT, uint16) = STR_BLOCK_BRAKES_CANNOT_BE_USED_DIRECTLY_AFTER_STATION;
-				*output = nextTrackElement;
-				return 0;
-			}
-			if (type == 216) {
-				RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_TEXT, uint16) = STR_BLOCK_BRAKES_CANNOT_BE_USED_DIRECTLY_AFTER_EACH_OTHER;
-				*output = nextTrackElement;
+				output->x = segment->x;
+				output->y = segment->y;
+				output->element = segment->element;
 				return 0;
 			}
-			if ((trackElement.element->type & 0x80) && type != 209 && type != 210) {
-				RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_TEXT, uint16) = STR_BLOCK_BRAKES_CANNOT_BE_USED_DIRECTLY_AFTER_THE_TOP_OF_THIS_LIFT_HILL;
-				*output = nextTrackElement;
+			nextIndex = 0;
+		}
+		next = &layout.segments[nextIndex];
+
+		if (next->track_type == 216) {
+			type = segment->track_type;
+			if (type == 1 || type == 216 || ((segment->element->type & 0x80) && type != 209 && type != 210)) {
+				output->x = next->x;
+				output->y = next->y;
+				output->element = next->element;
+				if (type == 1) {
+					RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_TEXT, uint16) = STR_BLOCK_BRAKES_CANNOT_BE_USED_DIRECTLY_AFTER_STATION;
+				} else if (type == 216) {
+					RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_TEXT, uint16) = STR_BLOCK_BRAKES_CANNOT_BE_USED_DIRECTLY_AFTER_EACH_OTHER;
+				} else {
+					RCT2_GLOBAL(RCT2_ADDRESS_GAME_COMMAND_ERROR_TEXT, uint16) = STR_BLOCK_BRAKES_CANNOT_BE_USED_DIRECTLY_AFTER_THE_TOP_OF_THIS_LIFT_HILL;
+				}
 				return 0;
 			}
 		}
-
-		trackElement = nextTrackElement;
-		if (loopTrackElement == NULL)
-			loopTrackElement = trackElement.element;
-		else if (loopTrackElement == trackElement.element)
-			break;
 	}
 
 	return 1;
@@ -3778,6 +3934,7 @@ void game_command_demolish_ride(int *eax, int *ebx, int *ecx, int *edx, int *esi
 
 			user_string_free(ride->name);
 			ride->type = RIDE_TYPE_NULL;
+			ride_index_cache_invalidate();
 			window_invalidate_by_class(WC_RIDE_LIST);
 			RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_PARK_VALUE, money32) = calculate_park_value();
 			RCT2_GLOBAL(0x009DEA5E, uint16) = x;
@@ -714,21 +714,28 @@ extern rct_ride* g_ride_list;
 #define GET_RIDE_ENTRY(x) RCT2_ADDRESS(RCT2_ADDRESS_RIDE_ENTRIES, rct_ride_type*)[x]
 
 /**
- * Helper macro loop for enumerating through all the non null rides.
+ * Helper macro loop for enumerating through all the non null rides, backed by
+ * the active ride index cache so only allocated slots are visited. The count
+ * is snapshotted when the loop begins: rides deleted by the body are skipped
+ * by the null check, rides created by the body appear on the next enumeration.
  */
 #define FOR_ALL_RIDES(i, ride) \
-	for (i = 0; i < MAX_RIDES; i++) \
-		if ((ride = &g_ride_list[i])->type != RIDE_TYPE_NULL)
+	for (int _rideNum = 0, _rideCount = ride_active_count(); _rideNum < _rideCount; _rideNum++) \
+		if ((i = ride_active_get(_rideNum)), (ride = &g_ride_list[i])->type != RIDE_TYPE_NULL)
 
 extern const uint8 gRideClassifications[255];
 
 int ride_get_count();
+int ride_active_count();
+uint8 ride_active_get(int n);
+void ride_index_cache_invalidate();
 int ride_get_total_queue_length(rct_ride *ride);
 int ride_get_max_queue_time(rct_ride *ride);
 void ride_init_all();
 void reset_all_ride_build_dates();
 void ride_update_favourited_stat();
 void ride_update_all();
+bool ride_rating_totals_get(int *numRides, int *uptimeTotal, int *numExcitingRides, int *excitementTotal, int *intensityTotal);
 void ride_check_all_reachable();
 void ride_update_popularity(rct_ride* ride, uint8 pop_amount);
 int sub_6CAF80(int rideIndex, rct_xy_element *output);
@@ -748,6 +755,7 @@ uint8 *get_ride_entry_indices_for_ride_type(uint8 rideType);
 void reset_type_to_ride_entry_index_map();
 void ride_measurement_clear(rct_ride *ride);
 void ride_measurements_update();
+void ride_measurement_accelerated_update(int rideIndex);
 rct_ride_measurement *ride_get_measurement(int rideIndex, rct_string_id *message);
 void ride_breakdown_add_news_item(int rideIndex);
 rct_peep *ride_find_closest_mechanic(rct_ride *ride, int forInspection);
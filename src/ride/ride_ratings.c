@@ -21,6 +21,7 @@
 #include "../addresses.h"
 #include "../interface/window.h"
 #include "../world/map.h"
+#include "../world/park.h"
 #include "ride.h"
 #include "ride_data.h"
 #include "ride_ratings.h"
@@ -39,6 +40,31 @@ typedef void (*ride_ratings_calculation)(rct_ride *ride);
 #define _rideRatingsState				RCT2_GLOBAL(0x0138B591, uint8)
 #define _rideRatingsCurrentRide			RCT2_GLOBAL(0x0138B590, uint8)
 
+// Rides flagged here still need a ratings recalculation. The crawl only
+// visits flagged rides, so when nothing in the park has changed the state
+// machine idles instead of continuously re-walking every track layout.
+static uint8 _rideRatingsDirty[(MAX_RIDES + 7) / 8];
+
+static bool ride_ratings_is_dirty(int rideIndex)
+{
+	return _rideRatingsDirty[rideIndex >> 3] & (1 << (rideIndex & 7));
+}
+
+static void ride_ratings_clear_dirty(int rideIndex)
+{
+	_rideRatingsDirty[rideIndex >> 3] &= ~(1 << (rideIndex & 7));
+}
+
+void ride_ratings_invalidate(int rideIndex)
+{
+	_rideRatingsDirty[rideIndex >> 3] |= 1 << (rideIndex & 7);
+}
+
+void ride_ratings_invalidate_all()
+{
+	memset(_rideRatingsDirty, 0xFF, sizeof(_rideRatingsDirty));
+}
+
 static const ride_ratings_calculation ride_ratings_calculate_func_table[91];
 
 static void ride_ratings_update_state_0();
@@ -74,6 +100,14 @@ void ride_ratings_update_all()
 	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_SCENARIO_EDITOR)
 		return;
 
+	// Ratings and value drift with ride age, so refresh everything
+	// periodically even without edits
+	static bool firstUpdate = true;
+	if (firstUpdate || (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) & 0x1FFF) == 0) {
+		firstUpdate = false;
+		ride_ratings_invalidate_all();
+	}
+
 	switch (_rideRatingsState) {
 	case RIDE_RATINGS_STATE_FIND_NEXT_RIDE:
 		ride_ratings_update_state_0();
@@ -103,14 +137,23 @@ void ride_ratings_update_all()
 static void ride_ratings_update_state_0()
 {
 	rct_ride *ride;
+	int i;
 
-	_rideRatingsCurrentRide += 1;
-	if (_rideRatingsCurrentRide == 255)
-		_rideRatingsCurrentRide = 0;
+	// Only rides whose ratings have been invalidated are worth visiting
+	for (i = 0; i < MAX_RIDES; i++) {
+		_rideRatingsCurrentRide += 1;
+		if (_rideRatingsCurrentRide == 255)
+			_rideRatingsCurrentRide = 0;
 
-	ride = GET_RIDE(_rideRatingsCurrentRide);
-	if (ride->type != RIDE_TYPE_NULL && ride->status != RIDE_STATUS_CLOSED)
-		_rideRatingsState = RIDE_RATINGS_STATE_INITIALISE;
+		if (!ride_ratings_is_dirty(_rideRatingsCurrentRide))
+			continue;
+
+		ride = GET_RIDE(_rideRatingsCurrentRide);
+		if (ride->type != RIDE_TYPE_NULL && ride->status != RIDE_STATUS_CLOSED) {
+			_rideRatingsState = RIDE_RATINGS_STATE_INITIALISE;
+			return;
+		}
+	}
 }
 
 /**
@@ -285,6 +328,10 @@ static void ride_ratings_update_state_3()
 	RCT2_CALLPROC_X(0x00655F64, 0, 0, 0, 0, 0, (int)ride, 0);
 	ride_ratings_calculate_value(ride);
 
+	// Fresh ratings and value change the ride's guest generation appeal
+	park_appeal_ride_update(_rideRatingsCurrentRide);
+
+	ride_ratings_clear_dirty(_rideRatingsCurrentRide);
 	window_invalidate_by_number(WC_RIDE, _rideRatingsCurrentRide);
 	_rideRatingsState = RIDE_RATINGS_STATE_FIND_NEXT_RIDE;
 }
@@ -25,5 +25,7 @@
 #include "ride.h"
 
 void ride_ratings_update_all();
+void ride_ratings_invalidate(int rideIndex);
+void ride_ratings_invalidate_all();
 
 #endif
\ No newline at end of file
@@ -0,0 +1,112 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "../addresses.h"
+#include "ride.h"
+#include "ride_stats.h"
+
+// Customers per hour used to be re-derived on every ride window paint by
+// summing the ten rolling five minute buckets. This keeps the figure as a
+// running aggregate instead: boarding events bump it immediately and the
+// bucket rotation in ride_update adjusts it by the bucket that falls out of
+// the window, so paints are a field load.
+typedef struct {
+	// 12x the ten completed buckets plus the in-progress one, so the figure
+	// moves as soon as a guest boards instead of at the next rotation
+	sint32 customersPerHour;
+	// Boardings recorded through the native hook since the last rotation.
+	// Some boarding paths still run inside original code and only show up in
+	// the ride's own bucket counter; the difference is reconciled when the
+	// bucket rotates.
+	sint16 bucketRecorded;
+	bool valid;
+} ride_stats_entry;
+
+static ride_stats_entry _rideStats[MAX_RIDES];
+
+static ride_stats_entry *ride_stats_get(int rideIndex)
+{
+	ride_stats_entry *stats = &_rideStats[rideIndex];
+	if (!stats->valid) {
+		rct_ride *ride = GET_RIDE(rideIndex);
+		stats->customersPerHour = 12 * (
+			ride->var_124 +
+			ride->var_126 +
+			ride->var_128 +
+			ride->var_12A +
+			ride->var_12C +
+			ride->var_12E +
+			ride->age +
+			ride->running_cost +
+			ride->var_134 +
+			ride->var_136 +
+			ride->var_120
+		);
+		stats->bucketRecorded = ride->var_120;
+		stats->valid = true;
+	}
+	return stats;
+}
+
+/**
+ * Forgets all ride statistic aggregates so they are re-derived from the ride
+ * counters on next use. Called when a park is loaded and when an applied game
+ * command may have reset a ride.
+ */
+void ride_stats_invalidate()
+{
+	int i;
+
+	for (i = 0; i < MAX_RIDES; i++)
+		_rideStats[i].valid = false;
+}
+
+/**
+ * Records a guest boarding (or making a purchase at a stall) so the customers
+ * per hour aggregate reflects it immediately.
+ */
+void ride_stats_record_customer(int rideIndex)
+{
+	ride_stats_entry *stats = ride_stats_get(rideIndex);
+
+	stats->bucketRecorded++;
+	stats->customersPerHour += 12;
+}
+
+/**
+ * Adjusts the aggregate for a bucket rotation. Must be called from
+ * ride_update before the buckets are shifted: the in-progress bucket
+ * (var_120) enters the window and the oldest one (var_136) falls out. Any
+ * boardings that happened inside original code and bypassed
+ * ride_stats_record_customer are picked up here.
+ */
+void ride_stats_bucket_rotated(int rideIndex)
+{
+	rct_ride *ride = GET_RIDE(rideIndex);
+	ride_stats_entry *stats = ride_stats_get(rideIndex);
+
+	stats->customersPerHour += 12 * ((ride->var_120 - stats->bucketRecorded) - ride->var_136);
+	stats->bucketRecorded = 0;
+}
+
+sint32 ride_stats_customers_per_hour(int rideIndex)
+{
+	return ride_stats_get(rideIndex)->customersPerHour;
+}
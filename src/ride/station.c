@@ -30,6 +30,25 @@ static void ride_update_station_race(rct_ride *ride, int stationIndex);
 static void ride_race_init_vehicle_speeds(rct_ride *ride);
 static void ride_invalidate_station_start(rct_ride *ride, int stationIndex, int dl);
 
+// Hint of where each station's start track element sits within its tile's
+// element list, so the per-tick station updates do not walk the tile every
+// time. The hint is an element index from the tile's first element, 0xFF
+// when unknown; it is verified against the element before use and re-derived
+// on a mismatch. The verification cannot detect every way a tile can change
+// under the hint, so the hints are dropped whenever a game command is
+// applied; tiles do not change between commands (the incremental map element
+// reorganisation moves whole tiles and keeps the order within them).
+static uint8 _stationElementIndexHint[MAX_RIDES][4];
+
+/**
+ * Forgets all station element hints. Called when a park is loaded and when an
+ * applied game command may have changed the map.
+ */
+void ride_station_element_hints_invalidate()
+{
+	memset(_stationElementIndexHint, 0xFF, sizeof(_stationElementIndexHint));
+}
+
 /**
  *
  *  rct2: 0x006ABFFB
@@ -301,21 +320,37 @@ static void ride_invalidate_station_start(rct_ride *ride, int stationIndex, int
 
 rct_map_element *ride_get_station_start_track_element(rct_ride *ride, int stationIndex)
 {
-	int x, y, z;
-	rct_map_element *mapElement;
+	int x, y, z, rideIndex;
+	uint8 hint;
+	rct_map_element *mapElement, *firstElement;
 
 	x = ride->station_starts[stationIndex] & 0xFF;
 	y = ride->station_starts[stationIndex] >> 8;
 	z = ride->station_heights[stationIndex];
+	rideIndex = ride - GET_RIDE(0);
+
+	firstElement = map_get_first_element_at(x, y);
+
+	// Try the hinted element first; the index within a tile only moves when
+	// the tile's contents change, and a wrong hint fails the check below
+	hint = _stationElementIndexHint[rideIndex][stationIndex];
+	if (hint != 0xFF) {
+		mapElement = firstElement + hint;
+		if (map_element_get_type(mapElement) == MAP_ELEMENT_TYPE_TRACK && z == mapElement->base_height)
+			return mapElement;
+	}
 
 	// Find the station track element
-	mapElement = map_get_first_element_at(x, y);
+	mapElement = firstElement;
 	do {
-		if (map_element_get_type(mapElement) == MAP_ELEMENT_TYPE_TRACK && z == mapElement->base_height)
+		if (map_element_get_type(mapElement) == MAP_ELEMENT_TYPE_TRACK && z == mapElement->base_height) {
+			_stationElementIndexHint[rideIndex][stationIndex] = (uint8)(mapElement - firstElement);
 			return mapElement;
+		}
 
 	} while (!map_element_is_last_for_tile(mapElement++));
 
+	_stationElementIndexHint[rideIndex][stationIndex] = 0xFF;
 	return NULL;
 }
 
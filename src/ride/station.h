@@ -26,6 +26,7 @@
 #include "ride.h"
 
 void ride_update_station(rct_ride *ride, int stationIndex);
+void ride_station_element_hints_invalidate();
 rct_map_element *ride_get_station_start_track_element(rct_ride *ride, int stationIndex);
 rct_map_element *ride_get_station_exit_element(rct_ride *ride, int x, int y, int z);
 
@@ -38,6 +38,64 @@
  */
 const rct_trackdefinition *gTrackDefinitions = (rct_trackdefinition*)0x00997C9D;
 
+// Flattened copies of the exe's preview track block lists (the pointer
+// tables at 0x00994638 for track and 0x00994A38 for flat rides, each entry
+// pointing at a variable length sequence array). All sequences are packed
+// into one contiguous buffer per table with a direct offset per track type,
+// so consumers stepping a piece's blocks read sequential native memory
+// instead of chasing pointers into the exe image. Built once at startup;
+// the authoritative tables ship inside the exe, so this cannot be generated
+// at build time.
+static rct_preview_track *_flatTrackBlocks[2] = { NULL, NULL };
+static uint32 _flatTrackBlockOffsets[2][256];
+
+void track_blocks_init()
+{
+	static const uint32 tableAddresses[2] = { 0x00994638, 0x00994A38 };
+	rct_preview_track *source, *block;
+	uint32 table, type, count, total;
+
+	for (table = 0; table < 2; table++) {
+		// First pass to size the buffer, sequences include their terminator
+		total = 0;
+		for (type = 0; type < 256; type++) {
+			source = ((rct_preview_track**)tableAddresses[table])[type];
+			count = 1;
+			if (source != NULL)
+				for (block = source; block->var_00 != 255; block++)
+					count++;
+			total += count;
+		}
+
+		free(_flatTrackBlocks[table]);
+		_flatTrackBlocks[table] = malloc(total * sizeof(rct_preview_track));
+
+		total = 0;
+		for (type = 0; type < 256; type++) {
+			_flatTrackBlockOffsets[table][type] = total;
+			source = ((rct_preview_track**)tableAddresses[table])[type];
+			if (source != NULL)
+				for (block = source; block->var_00 != 255; block++)
+					_flatTrackBlocks[table][total++] = *block;
+
+			// Terminator entry, consumers stop on var_00 == 255
+			memset(&_flatTrackBlocks[table][total], 0xFF, sizeof(rct_preview_track));
+			total++;
+		}
+	}
+}
+
+/**
+ * Returns the first preview block of the given track piece; the blocks are
+ * contiguous and terminated by an entry with var_00 == 255.
+ */
+const rct_preview_track *track_block_get(int trackType, int isFlatRide)
+{
+	int table = isFlatRide ? 1 : 0;
+
+	return &_flatTrackBlocks[table][_flatTrackBlockOffsets[table][trackType & 0xFF]];
+}
+
 // TODO This table is incorrect or at least missing 69 elements. There should be 256 in total!
 const rct_trackdefinition gTrackDefinitions_INCORRECT[] = {
     // TYPE							VANGLE END					VANGLE START				BANK END				BANK START				SPECIAL
@@ -610,13 +668,31 @@ rct_track_td6* load_track_design(const char *path)
 	return track_design;
 }
 
+// The loaded design cache was 4 entries at fixed addresses; all of its
+// consumers are native now, so the index bookkeeping lives here and the
+// cache holds TRACK_DESIGN_CACHE_SIZE designs. The design storage itself is
+// still allocated by the track list windows at RCT2_ADDRESS_TRACK_DESIGN_CACHE.
+static int _trackDesignIndexCache[TRACK_DESIGN_CACHE_SIZE];
+static uint32 _trackDesignNextIndexCache;
+
 /* rct2: 0x006D1DCE*/
 void reset_track_list_cache(){
-	int* track_list_cache = RCT2_ADDRESS(RCT2_ADDRESS_TRACK_DESIGN_INDEX_CACHE, int);
-	for (int i = 0; i < 4; ++i){
-		track_list_cache[i] = -1;
+	for (int i = 0; i < TRACK_DESIGN_CACHE_SIZE; ++i){
+		_trackDesignIndexCache[i] = -1;
+	}
+	_trackDesignNextIndexCache = 0;
+}
+
+/**
+ * Returns whether the design at the given list index is already loaded, so
+ * callers can prefetch without forcing a load themselves.
+ */
+int track_design_index_is_cached(int index){
+	for (int i = 0; i < TRACK_DESIGN_CACHE_SIZE; ++i){
+		if (_trackDesignIndexCache[i] == index)
+			return 1;
 	}
-	RCT2_GLOBAL(RCT2_ADDRESS_TRACK_DESIGN_NEXT_INDEX_CACHE, uint32) = 0;
+	return 0;
 }
 
 /* rct2: 0x006D1C68 */
@@ -856,6 +932,7 @@ int sub_6D2189(int* cost, uint8* ride_id){
 		RCT2_GLOBAL(RCT2_ADDRESS_TRACK_PREVIEW_ROTATION, uint8) = backup_rotation;
 		user_string_free(ride->name);
 		ride->type = RIDE_TYPE_NULL;
+		ride_index_cache_invalidate();
 		RCT2_GLOBAL(0x009D8150, uint8) &= ~1;
 		return 0;
 	}
@@ -866,6 +943,7 @@ void sub_6D235B(uint8 ride_id){
 	rct_ride* ride = GET_RIDE(ride_id);
 	user_string_free(ride->name);
 	ride->type = RIDE_TYPE_NULL;
+	ride_index_cache_invalidate();
 }
 
 /* rct2: 0x006D1EF0 */
@@ -1009,8 +1087,8 @@ rct_track_design *track_get_info(int index, uint8** preview)
 	trackDesign = NULL;
 
 	// Check if track design has already been loaded
-	for (i = 0; i < 4; i++) {
-		if (index == RCT2_ADDRESS(RCT2_ADDRESS_TRACK_DESIGN_INDEX_CACHE, uint32)[i]) {
+	for (i = 0; i < TRACK_DESIGN_CACHE_SIZE; i++) {
+		if (index == _trackDesignIndexCache[i]) {
 			trackDesign = &RCT2_GLOBAL(RCT2_ADDRESS_TRACK_DESIGN_CACHE, rct_track_design*)[i];
 			break;
 		}
@@ -1018,11 +1096,11 @@ rct_track_design *track_get_info(int index, uint8** preview)
 
 	if (trackDesign == NULL) {
 		// Load track design
-		i = RCT2_GLOBAL(RCT2_ADDRESS_TRACK_DESIGN_NEXT_INDEX_CACHE, uint32)++;
-		if (RCT2_GLOBAL(RCT2_ADDRESS_TRACK_DESIGN_NEXT_INDEX_CACHE, uint32) >= 4)
-			RCT2_GLOBAL(RCT2_ADDRESS_TRACK_DESIGN_NEXT_INDEX_CACHE, uint32) = 0;
+		i = _trackDesignNextIndexCache++;
+		if (_trackDesignNextIndexCache >= TRACK_DESIGN_CACHE_SIZE)
+			_trackDesignNextIndexCache = 0;
 
-		RCT2_ADDRESS(RCT2_ADDRESS_TRACK_DESIGN_INDEX_CACHE, uint32)[i] = index;
+		_trackDesignIndexCache[i] = index;
 
 		char track_path[MAX_PATH] = { 0 };
 		subsitute_path(track_path, (char*)RCT2_ADDRESS_TRACKS_PATH, trackDesignList + (index * 128));
@@ -1171,6 +1249,132 @@ int track_is_connected_by_shape(rct_map_element *a, rct_map_element *b)
 	return aBank == bBank && aAngle == bAngle;
 }
 
+// Scratch buffer and one-entry cache for the most recently compiled track
+// layout. Track cannot change between the repeated walks of a single
+// validation pass (the game is single threaded and modifications run through
+// game commands), so compiles of the same start element within one tick
+// reuse the previous walk. Callers that resynchronise construction state
+// before walking must invalidate the cache first.
+static rct_track_segment *_trackLayoutSegments = NULL;
+static int _trackLayoutCapacity = 0;
+static rct_track_layout _trackLayoutCached;
+static rct_xy_element _trackLayoutCachedBegin;
+static uint32 _trackLayoutCachedTicks;
+static bool _trackLayoutCacheValid = false;
+
+void track_layout_cache_invalidate()
+{
+	_trackLayoutCacheValid = false;
+}
+
+static void track_layout_append(rct_track_layout *layout, rct_xy_element *piece)
+{
+	rct_track_segment *segment;
+
+	if (layout->num_segments == _trackLayoutCapacity) {
+		_trackLayoutCapacity = max(256, _trackLayoutCapacity * 2);
+		_trackLayoutSegments = realloc(_trackLayoutSegments, _trackLayoutCapacity * sizeof(rct_track_segment));
+		layout->segments = _trackLayoutSegments;
+	}
+	segment = &layout->segments[layout->num_segments++];
+	segment->x = piece->x;
+	segment->y = piece->y;
+	segment->z = piece->element->base_height;
+	segment->track_type = piece->element->properties.track.type;
+	segment->element = piece->element;
+}
+
+/**
+ * Walks the track from the given piece and produces a flat segment array.
+ * The layout borrows a shared scratch buffer, so it is only valid until the
+ * next compile. Unlike ride_find_track_gap the walk continues past pieces
+ * joined with mismatching shapes; the first such break is recorded instead.
+ */
+int track_layout_compile(rct_xy_element *begin, rct_track_layout *outLayout)
+{
+	rct_track_layout *layout;
+	rct_xy_element current, next;
+
+	if (
+		_trackLayoutCacheValid &&
+		_trackLayoutCachedTicks == RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) &&
+		_trackLayoutCachedBegin.element == begin->element &&
+		_trackLayoutCachedBegin.x == begin->x &&
+		_trackLayoutCachedBegin.y == begin->y
+	) {
+		*outLayout = _trackLayoutCached;
+		return 1;
+	}
+
+	layout = &_trackLayoutCached;
+	layout->segments = _trackLayoutSegments;
+	layout->num_segments = 0;
+	layout->is_circuit = false;
+	layout->has_open_end = false;
+	layout->has_shape_break = false;
+
+	current = *begin;
+	track_layout_append(layout, &current);
+	for (;;) {
+		if (!track_get_next(&current, &next)) {
+			layout->has_open_end = true;
+			layout->open_end = current;
+			break;
+		}
+
+		if (!layout->has_shape_break && !track_is_connected_by_shape(current.element, next.element)) {
+			layout->has_shape_break = true;
+			layout->shape_break = next;
+		}
+
+		// The closure check against the second piece as well matches the
+		// original walks, which only guarded against revisiting the piece
+		// they reached after their first step
+		if (
+			next.element == layout->segments[0].element ||
+			(layout->num_segments >= 2 && next.element == layout->segments[1].element)
+		) {
+			layout->is_circuit = true;
+			break;
+		}
+
+		// Should never happen on a well formed track; bail rather than
+		// walking a cycle that misses the closure check forever
+		if (layout->num_segments >= 0x10000) {
+			layout->has_open_end = true;
+			layout->open_end = current;
+			break;
+		}
+
+		track_layout_append(layout, &next);
+		current = next;
+	}
+
+	_trackLayoutCachedBegin = *begin;
+	_trackLayoutCachedTicks = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
+	_trackLayoutCacheValid = true;
+	*outLayout = *layout;
+	return 1;
+}
+
+/**
+ * Returns whether the compiled track has a gap, either an open end or two
+ * pieces joined with mismatching shapes, and outputs the piece to show for
+ * it. Mirrors what ride_find_track_gap reports.
+ */
+int track_layout_find_gap(rct_track_layout *layout, rct_xy_element *output)
+{
+	if (layout->has_shape_break) {
+		*output = layout->shape_break;
+		return 1;
+	}
+	if (layout->has_open_end) {
+		*output = layout->open_end;
+		return 1;
+	}
+	return 0;
+}
+
 /* Based on rct2: 0x006D2897 */
 int copy_scenery_to_track(uint8** track_pointer){
 	rct_track_scenery* track_scenery = (rct_track_scenery*)(*track_pointer - 1);
@@ -1363,8 +1567,8 @@ rct_track_design *temp_track_get_info(char* path, uint8** preview)
 	trackDesign = NULL;
 
 	// Check if track design has already been loaded
-	for (i = 0; i < 4; i++) {
-		if (RCT2_ADDRESS(RCT2_ADDRESS_TRACK_DESIGN_INDEX_CACHE, uint32)[i] == 0) {
+	for (i = 0; i < TRACK_DESIGN_CACHE_SIZE; i++) {
+		if (_trackDesignIndexCache[i] == 0) {
 			trackDesign = &RCT2_GLOBAL(RCT2_ADDRESS_TRACK_DESIGN_CACHE, rct_track_design*)[i];
 			break;
 		}
@@ -1372,11 +1576,11 @@ rct_track_design *temp_track_get_info(char* path, uint8** preview)
 
 	if (trackDesign == NULL) {
 		// Load track design
-		i = RCT2_GLOBAL(RCT2_ADDRESS_TRACK_DESIGN_NEXT_INDEX_CACHE, uint32)++;
-		if (RCT2_GLOBAL(RCT2_ADDRESS_TRACK_DESIGN_NEXT_INDEX_CACHE, uint32) >= 4)
-			RCT2_GLOBAL(RCT2_ADDRESS_TRACK_DESIGN_NEXT_INDEX_CACHE, uint32) = 0;
+		i = _trackDesignNextIndexCache++;
+		if (_trackDesignNextIndexCache >= TRACK_DESIGN_CACHE_SIZE)
+			_trackDesignNextIndexCache = 0;
 
-		RCT2_ADDRESS(RCT2_ADDRESS_TRACK_DESIGN_INDEX_CACHE, uint32)[i] = 0;
+		_trackDesignIndexCache[i] = 0;
 
 		rct_track_td6* loaded_track = NULL;
 
@@ -92,6 +92,10 @@ enum{
 
 #define TRACK_PREVIEW_IMAGE_SIZE (370 * 217)
 
+// Number of loaded designs (with pre-rendered previews) kept in memory while
+// a track list window is open
+#define TRACK_DESIGN_CACHE_SIZE 16
+
 /* size: 0x2 */
 typedef struct{
 	uint8 body_colour;
@@ -408,6 +412,9 @@ enum {
 
 extern const rct_trackdefinition *gTrackDefinitions;
 
+void track_blocks_init();
+const rct_preview_track *track_block_get(int trackType, int isFlatRide);
+
 void track_load_list(ride_list_item item);
 int sub_67726A(const char *path);
 rct_track_design *track_get_info(int index, uint8** preview);
@@ -416,7 +423,33 @@ rct_track_td6* load_track_design(const char *path);
 int track_rename(const char *text);
 int track_delete();
 void reset_track_list_cache();
+int track_design_index_is_cached(int index);
 int track_is_connected_by_shape(rct_map_element *a, rct_map_element *b);
+
+// Compiled flat representation of a ride's track, produced by walking the
+// circuit once with track_get_next. Consumers iterate the segment array
+// instead of chasing map elements tile by tile for every pass.
+typedef struct {
+	uint16 x;				// world coordinates of the piece origin
+	uint16 y;
+	uint8 z;				// base height of the element
+	uint8 track_type;
+	rct_map_element *element;
+} rct_track_segment;
+
+typedef struct {
+	rct_track_segment *segments;
+	int num_segments;
+	bool is_circuit;			// the last segment joins back onto the start
+	bool has_open_end;			// the walk ended on a piece with no next
+	bool has_shape_break;		// a piece is not connected to its successor by shape
+	rct_xy_element open_end;	// last piece, when has_open_end
+	rct_xy_element shape_break;	// first misconnected successor, when has_shape_break
+} rct_track_layout;
+
+int track_layout_compile(rct_xy_element *begin, rct_track_layout *outLayout);
+int track_layout_find_gap(rct_track_layout *layout, rct_xy_element *output);
+void track_layout_cache_invalidate();
 int sub_6D01B3(int bl, int x, int y, int z);
 int save_track_design(uint8 rideIndex);
 int install_track(char* source_path, char* dest_name);
@@ -21,6 +21,7 @@
 #include "../addresses.h"
 #include "../audio/audio.h"
 #include "../audio/mixer.h"
+#include "../config.h"
 #include "../interface/viewport.h"
 #include "../world/sprite.h"
 #include "ride.h"
@@ -160,6 +161,18 @@ int sub_6BC2F3(rct_vehicle* vehicle)
 	return result + 300;
 }
 
+// Vehicles which finished their last update with an active sound id.
+// Collected as a side product of vehicle_update_all so that
+// vehicle_sounds_update only examines vehicles which can actually be heard
+// instead of walking the entire vehicle sprite list every tick. The audible
+// set is then still capped at the channel budget by the sorted insertion in
+// vehicle_update_sound_params. Until vehicle_update_all has run (e.g.
+// straight after loading a park) the list is invalid and the full scan is
+// used instead.
+static uint16 _vehicleSoundCandidates[MAX_SPRITES];
+static int _vehicleSoundCandidateCount = 0;
+static bool _vehicleSoundCandidatesValid = false;
+
 /**
 *
 *  rct2: 0x006BBC6B
@@ -195,8 +208,18 @@ void vehicle_sounds_update()
 		//label12:
 			//RCT2_GLOBAL(0x00F438B0, rct_vehicle_sound_params**) = &RCT2_GLOBAL(0x00F438B4, rct_vehicle_sound_params*);
 			gVehicleSoundParamsListEnd = &gVehicleSoundParamsList[0];
-			for (uint16 i = RCT2_GLOBAL(RCT2_ADDRESS_SPRITES_START_VEHICLE, uint16); i != SPRITE_INDEX_NULL; i = g_sprite_list[i].vehicle.next) {
-				vehicle_update_sound_params(&g_sprite_list[i].vehicle);
+			if (_vehicleSoundCandidatesValid) {
+				for (int j = 0; j < _vehicleSoundCandidateCount; j++) {
+					rct_vehicle* vehicle = &g_sprite_list[_vehicleSoundCandidates[j]].vehicle;
+
+					// The candidate may have been removed since it was collected
+					if (vehicle->linked_list_type_offset == SPRITE_LINKEDLIST_OFFSET_VEHICLE)
+						vehicle_update_sound_params(vehicle);
+				}
+			} else {
+				for (uint16 i = RCT2_GLOBAL(RCT2_ADDRESS_SPRITES_START_VEHICLE, uint16); i != SPRITE_INDEX_NULL; i = g_sprite_list[i].vehicle.next) {
+					vehicle_update_sound_params(&g_sprite_list[i].vehicle);
+				}
 			}
 			//for (rct_vehicle_sound* vehicle_sound = &RCT2_GLOBAL(RCT2_ADDRESS_VEHICLE_SOUND_LIST, rct_vehicle_sound); vehicle_sound != &RCT2_GLOBAL(0x009AF42C, rct_vehicle_sound); vehicle_sound++) {
 			for(int i = 0; i < countof(gVehicleSoundList); i++){
@@ -540,14 +563,141 @@ void vehicle_sounds_update()
 	}
 }
 
+// Vehicle sprite indices for one tick, grouped by the ride they belong to.
+// Vehicles on different rides share almost no state, so each group is a
+// self-contained unit of work.
+//
+// The groups run sequentially in ride index order on the calling thread.
+// Updating a vehicle still calls through to original code, which consumes
+// the shared scenario RNG; any other ordering (a worker pool in particular)
+// makes the RNG draw order scheduler-dependent and diverges the simulation
+// between runs, breaking command replay and the tick state hash. Dispatch
+// can only move off this thread once vehicle_update is native and its RNG
+// use sits on the per-entity streams.
+static uint16 _vehicleSpriteList[MAX_SPRITES];
+static uint16 _vehicleUpdateList[MAX_SPRITES];
+static struct { int start; int count; } _vehicleRideGroups[MAX_RIDES + 1];
+static int _vehicleRideGroupJobs[MAX_RIDES + 1];
+
+// Set once a vehicle has been updated this tick, so the train walk and the
+// orphan sweep below never update a car twice
+static uint8 _vehicleUpdateDone[MAX_SPRITES];
+
+static void vehicle_update_car(rct_vehicle *vehicle)
+{
+	// The update of an earlier vehicle may have removed this one
+	if (vehicle->linked_list_type_offset != SPRITE_LINKEDLIST_OFFSET_VEHICLE)
+		return;
+
+	vehicle_update(vehicle);
+
+	if (vehicle->sound1_id != (uint8)-1 || vehicle->sound2_id != (uint8)-1)
+		_vehicleSoundCandidates[_vehicleSoundCandidateCount++] = vehicle->sprite_index;
+}
+
+static void vehicle_update_group_pass(int start, int count)
+{
+	int i, steps;
+	uint16 spriteIndex, nextSpriteIndex;
+	rct_vehicle *vehicle;
+
+	// Advance whole trains front to back: the cars of a train sit chained
+	// through next_vehicle_on_train and share their ride and track state,
+	// so updating them consecutively keeps that state hot instead of
+	// hopping between trains in sprite list order
+	for (i = 0; i < count; i++) {
+		spriteIndex = _vehicleUpdateList[start + i];
+		vehicle = &(g_sprite_list[spriteIndex].vehicle);
+		if (_vehicleUpdateDone[spriteIndex])
+			continue;
+		if (vehicle->var_01 != 0)
+			continue;
+
+		steps = 0;
+		while (spriteIndex != SPRITE_INDEX_NULL && steps++ < count) {
+			if (_vehicleUpdateDone[spriteIndex])
+				break;
+			_vehicleUpdateDone[spriteIndex] = 1;
+
+			// The update may remove vehicles, so fetch the chain first
+			vehicle = &(g_sprite_list[spriteIndex].vehicle);
+			nextSpriteIndex = vehicle->next_vehicle_on_train;
+			vehicle_update_car(vehicle);
+			spriteIndex = nextSpriteIndex;
+		}
+	}
+
+	// Anything not reachable through a train head (orphaned cars)
+	for (i = 0; i < count; i++) {
+		spriteIndex = _vehicleUpdateList[start + i];
+		if (_vehicleUpdateDone[spriteIndex])
+			continue;
+		_vehicleUpdateDone[spriteIndex] = 1;
+		vehicle_update_car(&(g_sprite_list[spriteIndex].vehicle));
+	}
+}
+
 /**
- * 
+ * Accelerated testing: a ride under test carries no passengers and its
+ * vehicles interact with almost nothing outside the ride, so the whole test
+ * cycle can run several physics steps per tick, turning minutes of waiting
+ * for stats into seconds. The measurement ring is advanced after each extra
+ * pass so the graphs fill at the accelerated rate too. The update still
+ * calls through to original code against the fixed address state, so the
+ * extra passes run here, serialised with the normal ones; a private
+ * simulation over the compiled track has to wait until vehicle_update is
+ * native.
+ */
+static void vehicle_update_testing_extra_passes(int rideIndex, int start, int count)
+{
+	rct_ride *ride;
+	int pass, extraPasses, i;
+
+	extraPasses = (int)gConfigGeneral.test_acceleration - 1;
+	if (extraPasses <= 0)
+		return;
+
+	for (pass = 0; pass < extraPasses; pass++) {
+		// Re-check each pass; an earlier one may have finished the test or
+		// crashed a train
+		ride = GET_RIDE(rideIndex);
+		if (ride->status != RIDE_STATUS_TESTING)
+			break;
+		if (ride->lifecycle_flags & (RIDE_LIFECYCLE_BROKEN_DOWN | RIDE_LIFECYCLE_CRASHED))
+			break;
+
+		for (i = 0; i < count; i++)
+			_vehicleUpdateDone[_vehicleUpdateList[start + i]] = 0;
+		vehicle_update_group_pass(start, count);
+
+		ride_measurement_accelerated_update(rideIndex);
+	}
+}
+
+static void vehicle_update_ride_group(int rideIndex)
+{
+	int start, count;
+
+	start = _vehicleRideGroups[rideIndex].start;
+	count = _vehicleRideGroups[rideIndex].count;
+
+	vehicle_update_group_pass(start, count);
+	if (rideIndex < MAX_RIDES)
+		vehicle_update_testing_extra_passes(rideIndex, start, count);
+}
+
+/**
+ *
  *  rct2: 0x006D4204
  */
 void vehicle_update_all()
 {
 	uint16 sprite_index;
 	rct_vehicle *vehicle;
+	int i, count, offset, numJobs, rideIndex;
+
+	_vehicleSoundCandidateCount = 0;
+	_vehicleSoundCandidatesValid = false;
 
 	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_SCENARIO_EDITOR)
 		return;
@@ -555,14 +705,42 @@ void vehicle_update_all()
 	if ((RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_TRACK_DESIGNER) && RCT2_GLOBAL(0x0141F570, uint8) != 6)
 		return;
 
+	// Count the vehicles on each ride. Rides with an invalid index go in the
+	// overflow group at MAX_RIDES.
+	for (i = 0; i <= MAX_RIDES; i++)
+		_vehicleRideGroups[i].count = 0;
 
+	count = 0;
 	sprite_index = RCT2_GLOBAL(RCT2_ADDRESS_SPRITES_START_VEHICLE, uint16);
 	while (sprite_index != SPRITE_INDEX_NULL) {
 		vehicle = &(g_sprite_list[sprite_index].vehicle);
+		_vehicleSpriteList[count++] = sprite_index;
+		_vehicleUpdateDone[sprite_index] = 0;
+		_vehicleRideGroups[min(vehicle->ride, MAX_RIDES)].count++;
 		sprite_index = vehicle->next;
+	}
 
-		vehicle_update(vehicle);
+	// Lay the groups out back to back and scatter the vehicles into them in
+	// list order
+	offset = 0;
+	numJobs = 0;
+	for (i = 0; i <= MAX_RIDES; i++) {
+		_vehicleRideGroups[i].start = offset;
+		offset += _vehicleRideGroups[i].count;
+		if (_vehicleRideGroups[i].count > 0)
+			_vehicleRideGroupJobs[numJobs++] = i;
+		_vehicleRideGroups[i].count = 0;
+	}
+	for (i = 0; i < count; i++) {
+		vehicle = &(g_sprite_list[_vehicleSpriteList[i]].vehicle);
+		rideIndex = min(vehicle->ride, MAX_RIDES);
+		_vehicleUpdateList[_vehicleRideGroups[rideIndex].start + _vehicleRideGroups[rideIndex].count++] = _vehicleSpriteList[i];
 	}
+
+	for (i = 0; i < numJobs; i++)
+		vehicle_update_ride_group(_vehicleRideGroupJobs[i]);
+
+	_vehicleSoundCandidatesValid = true;
 }
 
 /**
@@ -20,7 +20,9 @@
 
 #include "addresses.h"
 #include "config.h"
+#include "editor.h"
 #include "game.h"
+#include "game_state.h"
 #include "interface/viewport.h"
 #include "localisation/date.h"
 #include "localisation/localisation.h"
@@ -33,8 +35,12 @@
 #include "peep/staff.h"
 #include "platform/platform.h"
 #include "ride/ride.h"
+#include "ride/ride_stats.h"
+#include "ride/station.h"
 #include "scenario.h"
+#include "statehash.h"
 #include "title.h"
+#include "util/savecontainer.h"
 #include "util/sawyercoding.h"
 #include "util/util.h"
 #include "world/map.h"
@@ -60,6 +66,14 @@ int scenario_load_basic(const char *path, rct_s6_header *header, rct_s6_info *in
 
 	file = fopen(path, "rb");
 	if (file != NULL) {
+		// A bundle carries its own header; the classic stream it embeds is at
+		// the recorded offset
+		scenario_bundle_header bundleHeader;
+		if (fread(&bundleHeader, sizeof(bundleHeader), 1, file) == 1 && bundleHeader.magic == SCENARIO_BUNDLE_MAGIC)
+			fseek(file, bundleHeader.scenarioOffset, SEEK_SET);
+		else
+			fseek(file, 0, SEEK_SET);
+
 		// Read first chunk
 		sawyercoding_read_chunk(file, (uint8*)header);
 		if (header->type == S6_TYPE_SCENARIO) {
@@ -98,15 +112,26 @@ int scenario_load(const char *path)
 {
 	log_verbose("loading scenario, %s", path);
 
-	FILE *file;
+	file_mapping fm;
+	sawyercoding_reader reader;
 	int i, j;
 	rct_s6_header *s6Header = (rct_s6_header*)0x009E34E4;
 	rct_s6_info *s6Info = (rct_s6_info*)0x0141F570;
 
-	file = fopen(path, "rb");
-	if (file != NULL) {
-		if (!sawyercoding_validate_checksum(file)) {
-			fclose(file);
+	if (platform_file_map(path, &fm)) {
+		// A bundle carries its own object data ahead of an unmodified classic
+		// scenario stream, see scenario_bundle_export
+		scenario_bundle_header *bundleHeader = NULL;
+		uint8 *scenarioData = fm.data;
+		uint32 scenarioSize = fm.size;
+		if (fm.size >= sizeof(scenario_bundle_header) && *((uint32*)fm.data) == SCENARIO_BUNDLE_MAGIC) {
+			bundleHeader = (scenario_bundle_header*)fm.data;
+			scenarioData += bundleHeader->scenarioOffset;
+			scenarioSize -= bundleHeader->scenarioOffset;
+		}
+
+		if (!sawyercoding_validate_checksum_buffer(scenarioData, scenarioSize)) {
+			platform_file_unmap(&fm);
 			RCT2_GLOBAL(RCT2_ADDRESS_ERROR_TYPE, uint8) = 255;
 			RCT2_GLOBAL(RCT2_ADDRESS_ERROR_STRING_ID, uint16) = STR_FILE_CONTAINS_INVALID_DATA;
 
@@ -114,58 +139,81 @@ int scenario_load(const char *path)
 			return 0;
 		}
 
+		sawyercoding_reader_init(&reader, scenarioData, scenarioSize);
+
 		// Read first chunk
-		sawyercoding_read_chunk(file, (uint8*)s6Header);
+		sawyercoding_reader_read_chunk(&reader, (uint8*)s6Header);
 		if (s6Header->type == S6_TYPE_SCENARIO) {
 			// Read second chunk
-			sawyercoding_read_chunk(file, (uint8*)s6Info);
-
-			// Read packed objects
-			if (s6Header->num_packed_objects > 0) {
+			sawyercoding_reader_read_chunk(&reader, (uint8*)s6Info);
+
+			// Read packed objects. A bundle carries every required object
+			// itself, including any the scenario packs, so its packed object
+			// section is walked over instead of installed
+			if (s6Header->num_packed_objects > 0 && bundleHeader != NULL) {
+				rct_object_entry packedEntry;
+				for (i = 0; i < s6Header->num_packed_objects; i++) {
+					sawyercoding_reader_read(&reader, &packedEntry, sizeof(packedEntry));
+					sawyercoding_reader_skip_chunk(&reader);
+				}
+			} else if (s6Header->num_packed_objects > 0) {
 				j = 0;
 				for (i = 0; i < s6Header->num_packed_objects; i++)
-					j += object_load_packed(file);
+					j += object_load_packed(&reader);
 				if (j > 0)
 					object_list_load();
 			}
 
-			uint8 load_success = object_read_and_load_entries(file);
+			uint8 load_success;
+			if (bundleHeader != NULL) {
+				// Load the objects from the bundle's own object section; the
+				// entry table chunk still has to be consumed from the stream
+				rct_object_entry *entries = malloc(721 * sizeof(rct_object_entry));
+				sawyercoding_reader_read_chunk(&reader, (uint8*)entries);
+
+				sawyercoding_reader objectReader;
+				sawyercoding_reader_init(&objectReader, fm.data + sizeof(scenario_bundle_header), bundleHeader->scenarioOffset - sizeof(scenario_bundle_header));
+				load_success = object_load_bundled_entries(&objectReader, entries, bundleHeader->numObjects);
+				free(entries);
+			} else {
+				load_success = object_read_and_load_entries(&reader);
+			}
 
 			// Read flags (16 bytes). Loads:
 			//	RCT2_ADDRESS_CURRENT_MONTH_YEAR
 			//	RCT2_ADDRESS_CURRENT_MONTH_TICKS
 			//	RCT2_ADDRESS_SCENARIO_TICKS
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_CURRENT_MONTH_YEAR);
 
 			// Read map elements
 			memset((void*)RCT2_ADDRESS_MAP_ELEMENTS, 0, MAX_MAP_ELEMENTS * sizeof(rct_map_element));
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_MAP_ELEMENTS);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_MAP_ELEMENTS);
 
 			// Read game data, including sprites
-			sawyercoding_read_chunk(file, (uint8*)0x010E63B8);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)0x010E63B8);
 
 			// Read number of guests in park and something else
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_GUESTS_IN_PARK);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_GUESTS_IN_PARK);
 
 			// Read ?
-			sawyercoding_read_chunk(file, (uint8*)0x01357BC8);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)0x01357BC8);
 
 			// Read park rating
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_CURRENT_PARK_RATING);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_CURRENT_PARK_RATING);
 
 			// Read ?
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_ACTIVE_RESEARCH_TYPES);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_ACTIVE_RESEARCH_TYPES);
 
 			// Read ?
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_CURRENT_EXPENDITURE);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_CURRENT_EXPENDITURE);
 
 			// Read ?
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_CURRENT_PARK_VALUE);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_CURRENT_PARK_VALUE);
 
 			// Read more game data, including research items and rides
-			sawyercoding_read_chunk(file, (uint8*)RCT2_ADDRESS_COMPLETED_COMPANY_VALUE);
+			sawyercoding_reader_read_chunk(&reader, (uint8*)RCT2_ADDRESS_COMPLETED_COMPANY_VALUE);
 
-			fclose(file);
+			platform_file_unmap(&fm);
 			if (!load_success){
 				log_error("failed to load all entries.");
 				set_load_objects_fail_reason();
@@ -177,10 +225,22 @@ int scenario_load(const char *path)
 			reset_loaded_objects();
 			map_update_tile_pointers();
 			reset_0x69EBE4();
+			game_state_sync_from_legacy();
+			peep_thought_counters_invalidate();
+			staff_patrol_index_invalidate();
+			user_string_table_invalidate();
+			finance_history_invalidate();
+			editor_object_flags_invalidate();
+			ride_stats_invalidate();
+			ride_station_element_hints_invalidate();
+			ride_index_cache_invalidate();
+			park_size_invalidate();
+			park_appeal_invalidate();
+			statehash_invalidate();
 			return 1;
 		}
 
-		fclose(file);
+		platform_file_unmap(&fm);
 	}
 
 	log_error("failed to find scenario file.");
@@ -347,6 +407,91 @@ int scenario_load_and_play_from_path(const char *path)
 	return 1;
 }
 
+/**
+ * Packs a scenario and the exact object data it requires into one
+ * sequentially readable bundle, so loading it resolves nothing against the
+ * installed object library and opens no further files. Requires the installed
+ * object list; any objects the scenario itself packs must have been installed
+ * by opening the scenario once. The classic scenario stream is embedded
+ * unmodified after the bundled objects.
+ */
+int scenario_bundle_export(const char *scenarioPath, const char *bundlePath)
+{
+	file_mapping fm;
+	sawyercoding_reader reader;
+	scenario_bundle_header bundleHeader;
+	rct_s6_header s6Header;
+	rct_s6_info s6Info;
+	rct_object_entry packedEntry;
+	rct_object_entry *entries;
+	FILE *file;
+	int i, numObjects;
+
+	if (!platform_file_map(scenarioPath, &fm)) {
+		log_error("failed to open scenario, %s", scenarioPath);
+		return 0;
+	}
+	if (!sawyercoding_validate_checksum_buffer(fm.data, fm.size)) {
+		log_error("failed to bundle scenario, invalid checksum");
+		platform_file_unmap(&fm);
+		return 0;
+	}
+
+	sawyercoding_reader_init(&reader, fm.data, fm.size);
+	sawyercoding_reader_read_chunk(&reader, (uint8*)&s6Header);
+	if (s6Header.type != S6_TYPE_SCENARIO) {
+		log_error("not a scenario, %s", scenarioPath);
+		platform_file_unmap(&fm);
+		return 0;
+	}
+	sawyercoding_reader_read_chunk(&reader, (uint8*)&s6Info);
+
+	// Walk over any packed objects to reach the entry table; their data is
+	// bundled from the installed library like everything else
+	for (i = 0; i < s6Header.num_packed_objects; i++) {
+		sawyercoding_reader_read(&reader, &packedEntry, sizeof(packedEntry));
+		sawyercoding_reader_skip_chunk(&reader);
+	}
+
+	entries = malloc(721 * sizeof(rct_object_entry));
+	sawyercoding_reader_read_chunk(&reader, (uint8*)entries);
+
+	file = fopen(bundlePath, "wb");
+	if (file == NULL) {
+		log_error("failed to create bundle, %s", bundlePath);
+		free(entries);
+		platform_file_unmap(&fm);
+		return 0;
+	}
+
+	// The header is rewritten once the object count and offset are known
+	memset(&bundleHeader, 0, sizeof(bundleHeader));
+	fwrite(&bundleHeader, sizeof(bundleHeader), 1, file);
+
+	numObjects = object_write_bundled_entries(file, entries);
+	free(entries);
+	if (numObjects < 0) {
+		fclose(file);
+		platform_file_delete(bundlePath);
+		platform_file_unmap(&fm);
+		return 0;
+	}
+
+	bundleHeader.magic = SCENARIO_BUNDLE_MAGIC;
+	bundleHeader.numObjects = numObjects;
+	bundleHeader.scenarioOffset = ftell(file);
+
+	// The classic stream goes in unmodified, final checksum and all
+	fwrite(fm.data, 1, fm.size, file);
+
+	fseek(file, 0, SEEK_SET);
+	fwrite(&bundleHeader, sizeof(bundleHeader), 1, file);
+	fclose(file);
+	platform_file_unmap(&fm);
+
+	log_verbose("bundled %d objects with %s into %s", numObjects, scenarioPath, bundlePath);
+	return 1;
+}
 
 void scenario_end()
 {
@@ -655,6 +800,15 @@ static void scenario_autosave_check()
 		game_autosave();
 }
 
+// Jobs remaining from the last day/week boundary. The analysis-only parts
+// of the periodic work are staggered over the ticks following the boundary
+// so the boundary frame does not pay for all of them at once. Jobs that move
+// money or consume scenario_rand (wages, interest, marketing, awards, duck
+// spawning) must stay on the boundary tick itself, as moving them would
+// change the random stream interleaving.
+static uint8 _scenarioDailyJobPhase = 0;
+static uint8 _scenarioWeeklyJobPhase = 0;
+
 /*
  * Scenario and finance related update iteration.
  * rct2: 0x006C44B1
@@ -676,7 +830,6 @@ void scenario_update()
 	if ((current_days_in_month * next_month_tick) >> 16 != (current_days_in_month * month_tick) >> 16) {
 		// daily checks
 		finance_update_daily_profit();
-		peep_update_days_in_queue();
 		get_local_time();
 		RCT2_CALLPROC_EBPSAFE(0x0066A13C); // objective 6 dragging
 		switch (objective_type) {
@@ -690,6 +843,10 @@ void scenario_update()
 		}
 
 		window_invalidate_by_class(WC_BOTTOM_TOOLBAR);
+		_scenarioDailyJobPhase = 1;
+	} else if (_scenarioDailyJobPhase != 0) {
+		_scenarioDailyJobPhase--;
+		peep_update_days_in_queue();
 	}
 
 	if (next_month_tick % 0x4000 == 0) {
@@ -698,9 +855,6 @@ void scenario_update()
 		finance_pay_research();
 		finance_pay_interest();
 		marketing_update();
-		peep_problem_warnings_update();
-		ride_check_all_reachable();
-		ride_update_favourited_stat();
 
 		rct_water_type* water_type = (rct_water_type*)object_entry_groups[OBJECT_TYPE_WATER].chunks[0];
 
@@ -712,7 +866,21 @@ void scenario_update()
 			}
 		}
 		park_update_histories();
-		park_calculate_size();
+		_scenarioWeeklyJobPhase = 3;
+	} else if (_scenarioWeeklyJobPhase != 0) {
+		// Analysis-only weekly jobs, one per tick after the boundary
+		switch (_scenarioWeeklyJobPhase--) {
+		case 3:
+			peep_problem_warnings_update();
+			break;
+		case 2:
+			ride_check_all_reachable();
+			break;
+		case 1:
+			ride_update_favourited_stat();
+			park_calculate_size();
+			break;
+		}
 	}
 
 	if (next_month_tick % 0x8000 == 0) {
@@ -806,20 +974,23 @@ void scenario_prepare_rides_for_save()
 {
 	int i;
 	rct_ride *ride;
-	map_element_iterator it;
+	rct_map_element *element;
+	map_tile_span_iterator it;
 
 	int isFiveCoasterObjective = RCT2_GLOBAL(RCT2_ADDRESS_OBJECTIVE_TYPE, uint8) == OBJECTIVE_FINISH_5_ROLLERCOASTERS;
 
 	// Set all existing track to be indestructible
-	map_element_iterator_begin(&it);
-	do {
-		if (map_element_get_type(it.element) == MAP_ELEMENT_TYPE_TRACK) {
-			if (isFiveCoasterObjective)
-				it.element->flags |= 0x40;
-			else
-				it.element->flags &= ~0x40;
+	map_tile_span_iterator_begin(&it);
+	while (map_tile_span_iterator_next(&it)) {
+		for (element = it.first; element <= it.last; element++) {
+			if (map_element_get_type(element) == MAP_ELEMENT_TYPE_TRACK) {
+				if (isFiveCoasterObjective)
+					element->flags |= 0x40;
+				else
+					element->flags &= ~0x40;
+			}
 		}
-	} while (map_element_iterator_next(&it));
+	}
 
 	// Set all existing rides to have indestructible track
 	FOR_ALL_RIDES(i, ride) {
@@ -903,6 +1074,22 @@ int scenario_write_packed_objects(FILE *file)
 	return 1;
 }
 
+void scenario_get_available_objects(rct_object_entry *dstEntry)
+{
+	int i;
+
+	rct_object_entry_extended *srcEntry = (rct_object_entry_extended*)0x00F3F03C;
+	for (i = 0; i < 721; i++) {
+		if (RCT2_ADDRESS(0x009ACFA4, uint32)[i] == 0xFFFFFFFF)
+			memset(dstEntry, 0xFF, sizeof(rct_object_entry));
+		else
+			*dstEntry = *((rct_object_entry*)srcEntry);
+
+		srcEntry++;
+		dstEntry++;
+	}
+}
+
 /**
  *
  *  rct2: 0x006AA039
@@ -910,7 +1097,7 @@ int scenario_write_packed_objects(FILE *file)
 int scenario_write_available_objects(FILE *file)
 {
 	char *buffer, *dstBuffer;
-	int i, encodedLength;
+	int encodedLength;
 	sawyercoding_chunk_header chunkHeader;
 
 	const int totalEntries = 721;
@@ -923,17 +1110,7 @@ int scenario_write_available_objects(FILE *file)
 		return 0;
 
 	// Write entries
-	rct_object_entry_extended *srcEntry = (rct_object_entry_extended*)0x00F3F03C;
-	rct_object_entry *dstEntry = (rct_object_entry*)buffer;
-	for (i = 0; i < 721; i++) {
-		if (RCT2_ADDRESS(0x009ACFA4, uint32)[i] == 0xFFFFFFFF)
-			memset(dstEntry, 0xFF, sizeof(rct_object_entry));
-		else
-			*dstEntry = *((rct_object_entry*)srcEntry);
-		
-		srcEntry++;
-		dstEntry++;
-	}
+	scenario_get_available_objects((rct_object_entry*)buffer);
 
 	// Write chunk
 	chunkHeader.encoding = CHUNK_ENCODING_ROTATE;
@@ -947,6 +1124,79 @@ int scenario_write_available_objects(FILE *file)
 	return 1;
 }
 
+void scenario_set_saved_view()
+{
+	rct_window *w;
+	rct_viewport *viewport;
+	int viewX, viewY, viewZoom, viewRotation;
+
+	w = window_get_main();
+	if (w != NULL) {
+		viewport = w->viewport;
+
+		viewX = viewport->view_width / 2 + viewport->view_x;
+		viewY = viewport->view_height / 2 + viewport->view_y;
+		viewZoom = viewport->zoom;
+		viewRotation = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_ROTATION, uint8);
+	} else {
+		viewX = 0;
+		viewY = 0;
+		viewZoom = 0;
+		viewRotation = 0;
+	}
+
+	RCT2_GLOBAL(RCT2_ADDRESS_SAVED_VIEW_X, uint16) = viewX;
+	RCT2_GLOBAL(RCT2_ADDRESS_SAVED_VIEW_Y, uint16) = viewY;
+	RCT2_GLOBAL(RCT2_ADDRESS_SAVED_VIEW_ZOOM_AND_ROTATION, uint16) = viewZoom | (viewRotation << 8);
+}
+
+/**
+ * Writes a saved game as a chunked container: a section directory followed by
+ * the same data scenario_save writes, but with each chunk independently
+ * encoded and checksummed so loading can decode the large sections in
+ * parallel and tools can read the header section alone for a preview.
+ */
+static int scenario_save_container(const char *path)
+{
+	rct_s6_header *s6Header = (rct_s6_header*)0x009E34E4;
+	save_container_writer writer;
+	rct_object_entry *availableObjects;
+	int availableObjectsLength, result;
+	FILE *file;
+
+	file = fopen(path, "wb");
+	if (file == NULL) {
+		log_error("Unable to write to %s", path);
+		return 0;
+	}
+	if (!save_container_writer_begin(&writer, file)) {
+		log_error("Unable to allocate enough space for a write buffer.");
+		fclose(file);
+		return 0;
+	}
+
+	availableObjectsLength = 721 * sizeof(rct_object_entry);
+	availableObjects = malloc(availableObjectsLength);
+	if (availableObjects == NULL) {
+		free(writer.encodeBuffer);
+		fclose(file);
+		return 0;
+	}
+	scenario_get_available_objects(availableObjects);
+
+	// Same data and encodings as the classic saved game chunk stream
+	result = save_container_writer_add(&writer, SAVE_SECTION_S6_HEADER, CHUNK_ENCODING_ROTATE, (uint8*)s6Header, sizeof(rct_s6_header));
+	result &= save_container_writer_add(&writer, SAVE_SECTION_OBJECTS, CHUNK_ENCODING_ROTATE, (uint8*)availableObjects, availableObjectsLength);
+	result &= save_container_writer_add(&writer, SAVE_SECTION_GAME_TIME, CHUNK_ENCODING_RLECOMPRESSED, (uint8*)0x00F663A8, 16);
+	result &= save_container_writer_add(&writer, SAVE_SECTION_MAP_ELEMENTS, CHUNK_ENCODING_RLECOMPRESSED, (uint8*)0x00F663B8, 0x4A85EC);
+	result &= save_container_writer_add(&writer, SAVE_SECTION_GAME_DATA, CHUNK_ENCODING_RLECOMPRESSED, (uint8*)0x010E63B8, 0x2E8570);
+	result &= save_container_writer_finish(&writer);
+
+	free(availableObjects);
+	fclose(file);
+	return result;
+}
+
 /**
  *
  *  rct2: 0x006754F5
@@ -964,10 +1214,6 @@ int scenario_save(char *path, int flags)
 	long fileSize;
 	uint32 checksum;
 
-	rct_window *w;
-	rct_viewport *viewport;
-	int viewX, viewY, viewZoom, viewRotation;
-
 	if (flags & 2)
 		log_verbose("saving scenario, %s", path);
 	else
@@ -984,24 +1230,7 @@ int scenario_save(char *path, int flags)
 	RCT2_CALLPROC_EBPSAFE(0x00674BCF);
 
 	// Set saved view
-	w = window_get_main();
-	if (w != NULL) {
-		viewport = w->viewport;
-
-		viewX = viewport->view_width / 2 + viewport->view_x;
-		viewY = viewport->view_height / 2 + viewport->view_y;
-		viewZoom = viewport->zoom;
-		viewRotation = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_ROTATION, uint8);
-	} else {
-		viewX = 0;
-		viewY = 0;
-		viewZoom = 0;
-		viewRotation = 0;
-	}
-
-	RCT2_GLOBAL(RCT2_ADDRESS_SAVED_VIEW_X, uint16) = viewX;
-	RCT2_GLOBAL(RCT2_ADDRESS_SAVED_VIEW_Y, uint16) = viewY;
-	RCT2_GLOBAL(RCT2_ADDRESS_SAVED_VIEW_ZOOM_AND_ROTATION, uint16) = viewZoom | (viewRotation << 8);
+	scenario_set_saved_view();
 
 	// 
 	memset(s6Header, 0, sizeof(rct_s6_header));
@@ -1010,6 +1239,21 @@ int scenario_save(char *path, int flags)
 	s6Header->version = S6_RCT2_VERSION;
 	s6Header->magic_number = S6_MAGIC_NUMBER;
 
+	// Optionally write saved games as a chunked container. Scenarios and
+	// saves with packed objects keep the classic stream, which other tools
+	// and the original game understand.
+	if (gConfigGeneral.chunked_saves && !(flags & 2) && s6Header->num_packed_objects == 0) {
+		if (!scenario_save_container(path))
+			return 0;
+
+		if (!(flags & 0x80000000))
+			reset_loaded_objects();
+
+		gfx_invalidate_screen();
+		RCT2_GLOBAL(0x009DEA66, uint16) = 0;
+		return 1;
+	}
+
 	file = fopen(path, "wb+");
 	if (file == NULL) {
 		log_error("Unable to write to %s", path);
@@ -1141,3 +1385,311 @@ int scenario_save(char *path, int flags)
 	RCT2_GLOBAL(0x009DEA66, uint16) = 0;
 	return 1;
 }
+
+// Snapshot of the saved game data, copied on the game thread so that the
+// encoding and file I/O of an autosave can run on a background thread
+// without the game state changing underneath them.
+typedef struct {
+	char path[MAX_PATH];
+	char deltaPath[MAX_PATH];
+	rct_s6_header header;
+	uint8 *availableObjects;
+	int availableObjectsLength;
+	uint8 gameTimeData[16];		// 0x00F663A8
+	uint8 *mapElements;			// 0x00F663B8
+	uint8 *gameData;			// 0x010E63B8
+	uint8 writeContainer;		// write the full save as a chunked container
+	uint8 deltaEligible;		// may be written as a delta against the base
+} scenario_autosave_snapshot;
+
+static SDL_Thread *_autosaveThread = NULL;
+static volatile int _autosaveActive = 0;
+
+// The last full autosave is kept in memory as the base for delta autosaves,
+// along with the sum of its container section checksums, which pairs a delta
+// file with the exact base it applies to. Both are only touched by the
+// autosave thread once the first autosave has been kicked off.
+static scenario_autosave_snapshot *_autosaveBase = NULL;
+static uint32 _autosaveBaseChecksum;
+static int _autosaveDeltaCount;
+
+// Write a fresh full autosave after this many deltas so a corrupt base never
+// costs more than one rebase interval of progress
+#define AUTOSAVE_DELTA_REBASE_INTERVAL 16
+
+static void scenario_autosave_snapshot_dispose(scenario_autosave_snapshot *snapshot)
+{
+	SafeFree(snapshot->availableObjects);
+	SafeFree(snapshot->mapElements);
+	SafeFree(snapshot->gameData);
+	free(snapshot);
+}
+
+static void scenario_autosave_write_chunk(FILE *file, uint8 *dstBuffer, uint8 encoding, uint8 *data, int length, uint32 *checksum)
+{
+	sawyercoding_chunk_header chunkHeader;
+	int encodedLength;
+
+	chunkHeader.encoding = encoding;
+	chunkHeader.length = length;
+	encodedLength = sawyercoding_write_chunk_buffer(dstBuffer, data, chunkHeader);
+	*checksum += sawyercoding_calculate_checksum(dstBuffer, encodedLength);
+	fwrite(dstBuffer, encodedLength, 1, file);
+}
+
+/**
+ * Writes a delta autosave: the changed byte spans of the map elements and
+ * game data against the in-memory base, plus the game time whole. Returns 0
+ * when there is no point (the object list changed, or the spans grew past a
+ * quarter of the full data), in which case the caller rebases instead.
+ */
+static int scenario_autosave_write_delta(scenario_autosave_snapshot *snapshot)
+{
+	save_container_writer writer;
+	FILE *file;
+	uint8 *mapDelta, *gameDelta;
+	int mapDeltaLength, gameDeltaLength, result;
+
+	// A changed object list would change what the map element and sprite
+	// bytes mean; the delta loader reuses the base's objects, so rebase
+	if (snapshot->availableObjectsLength != _autosaveBase->availableObjectsLength)
+		return 0;
+	if (memcmp(snapshot->availableObjects, _autosaveBase->availableObjects, snapshot->availableObjectsLength) != 0)
+		return 0;
+
+	mapDelta = malloc(0x4A85EC / 4);
+	gameDelta = malloc(0x2E8570 / 4);
+	if (mapDelta == NULL || gameDelta == NULL) {
+		SafeFree(mapDelta);
+		SafeFree(gameDelta);
+		return 0;
+	}
+
+	mapDeltaLength = save_delta_build(mapDelta, 0x4A85EC / 4, _autosaveBase->mapElements, snapshot->mapElements, 0x4A85EC);
+	gameDeltaLength = save_delta_build(gameDelta, 0x2E8570 / 4, _autosaveBase->gameData, snapshot->gameData, 0x2E8570);
+	if (mapDeltaLength < 0 || gameDeltaLength < 0) {
+		free(mapDelta);
+		free(gameDelta);
+		return 0;
+	}
+
+	file = fopen(snapshot->deltaPath, "wb");
+	if (file == NULL) {
+		log_error("Unable to write to %s", snapshot->deltaPath);
+		free(mapDelta);
+		free(gameDelta);
+		return 0;
+	}
+	if (!save_delta_writer_begin(&writer, file, _autosaveBaseChecksum)) {
+		fclose(file);
+		free(mapDelta);
+		free(gameDelta);
+		return 0;
+	}
+
+	result = save_container_writer_add(&writer, SAVE_SECTION_S6_HEADER, CHUNK_ENCODING_ROTATE, (uint8*)&snapshot->header, sizeof(rct_s6_header));
+	result &= save_container_writer_add(&writer, SAVE_SECTION_GAME_TIME, CHUNK_ENCODING_RLECOMPRESSED, snapshot->gameTimeData, 16);
+	result &= save_container_writer_add(&writer, SAVE_SECTION_MAP_ELEMENTS | SAVE_SECTION_DELTA_FLAG, CHUNK_ENCODING_RLECOMPRESSED, mapDelta, mapDeltaLength);
+	result &= save_container_writer_add(&writer, SAVE_SECTION_GAME_DATA | SAVE_SECTION_DELTA_FLAG, CHUNK_ENCODING_RLECOMPRESSED, gameDelta, gameDeltaLength);
+	result &= save_container_writer_finish(&writer);
+
+	fclose(file);
+	free(mapDelta);
+	free(gameDelta);
+	return result;
+}
+
+/**
+ * Writes a full autosave as a chunked container from the snapshot, the same
+ * sections scenario_save_container writes from live state. On success
+ * outChecksum holds the sum of the section checksums, the identity deltas
+ * bind to.
+ */
+static int scenario_autosave_write_container(scenario_autosave_snapshot *snapshot, uint32 *outChecksum)
+{
+	save_container_writer writer;
+	FILE *file;
+	int i, result;
+	uint32 checksum;
+
+	file = fopen(snapshot->path, "wb");
+	if (file == NULL) {
+		log_error("Unable to write to %s", snapshot->path);
+		return 0;
+	}
+	if (!save_container_writer_begin(&writer, file)) {
+		log_error("Unable to allocate enough space for a write buffer.");
+		fclose(file);
+		return 0;
+	}
+
+	result = save_container_writer_add(&writer, SAVE_SECTION_S6_HEADER, CHUNK_ENCODING_ROTATE, (uint8*)&snapshot->header, sizeof(rct_s6_header));
+	result &= save_container_writer_add(&writer, SAVE_SECTION_OBJECTS, CHUNK_ENCODING_ROTATE, snapshot->availableObjects, snapshot->availableObjectsLength);
+	result &= save_container_writer_add(&writer, SAVE_SECTION_GAME_TIME, CHUNK_ENCODING_RLECOMPRESSED, snapshot->gameTimeData, 16);
+	result &= save_container_writer_add(&writer, SAVE_SECTION_MAP_ELEMENTS, CHUNK_ENCODING_RLECOMPRESSED, snapshot->mapElements, 0x4A85EC);
+	result &= save_container_writer_add(&writer, SAVE_SECTION_GAME_DATA, CHUNK_ENCODING_RLECOMPRESSED, snapshot->gameData, 0x2E8570);
+	result &= save_container_writer_finish(&writer);
+
+	fclose(file);
+	if (!result)
+		return 0;
+
+	checksum = 0;
+	for (i = 0; i < writer.numSections; i++)
+		checksum += writer.sections[i].checksum;
+	*outChecksum = checksum;
+	return 1;
+}
+
+static int scenario_autosave_thread(void *ptr)
+{
+	scenario_autosave_snapshot *snapshot = (scenario_autosave_snapshot*)ptr;
+	FILE *file;
+	uint8 *buffer;
+	uint32 checksum = 0;
+
+	if (snapshot->deltaEligible && scenario_autosave_write_delta(snapshot)) {
+		_autosaveDeltaCount++;
+		scenario_autosave_snapshot_dispose(snapshot);
+		_autosaveActive = 0;
+		return 1;
+	}
+
+	if (snapshot->writeContainer) {
+		if (scenario_autosave_write_container(snapshot, &checksum)) {
+			// The snapshot becomes the base the following deltas diff
+			// against; the previous base is no longer referenced by any file
+			// a delta loader would pick up
+			if (_autosaveBase != NULL)
+				scenario_autosave_snapshot_dispose(_autosaveBase);
+			_autosaveBase = snapshot;
+			_autosaveBaseChecksum = checksum;
+			_autosaveDeltaCount = 0;
+		} else {
+			scenario_autosave_snapshot_dispose(snapshot);
+		}
+		_autosaveActive = 0;
+		return 1;
+	}
+
+	file = fopen(snapshot->path, "wb");
+	if (file == NULL) {
+		log_error("Unable to write to %s", snapshot->path);
+		scenario_autosave_snapshot_dispose(snapshot);
+		_autosaveActive = 0;
+		return 0;
+	}
+
+	buffer = malloc(0x600000);
+	if (buffer == NULL) {
+		log_error("Unable to allocate enough space for a write buffer.");
+		fclose(file);
+		scenario_autosave_snapshot_dispose(snapshot);
+		_autosaveActive = 0;
+		return 0;
+	}
+
+	// Write the same chunks scenario_save writes for a saved game, summing
+	// the checksum as each chunk is encoded instead of reading the whole
+	// file back afterwards
+	scenario_autosave_write_chunk(file, buffer, CHUNK_ENCODING_ROTATE, (uint8*)&snapshot->header, sizeof(rct_s6_header), &checksum);
+	scenario_autosave_write_chunk(file, buffer, CHUNK_ENCODING_ROTATE, snapshot->availableObjects, snapshot->availableObjectsLength, &checksum);
+	scenario_autosave_write_chunk(file, buffer, CHUNK_ENCODING_RLECOMPRESSED, snapshot->gameTimeData, 16, &checksum);
+	scenario_autosave_write_chunk(file, buffer, CHUNK_ENCODING_RLECOMPRESSED, snapshot->mapElements, 0x4A85EC, &checksum);
+	scenario_autosave_write_chunk(file, buffer, CHUNK_ENCODING_RLECOMPRESSED, snapshot->gameData, 0x2E8570, &checksum);
+
+	// Append the checksum
+	fwrite(&checksum, sizeof(uint32), 1, file);
+
+	free(buffer);
+	fclose(file);
+	scenario_autosave_snapshot_dispose(snapshot);
+	_autosaveActive = 0;
+	return 1;
+}
+
+/**
+ * Saves the game to path like scenario_save, but only copies the game state
+ * on the calling thread; compression and file I/O happen on a background
+ * thread so the game does not hitch on the autosave interval.
+ */
+int scenario_save_async(const char *path)
+{
+	scenario_autosave_snapshot *snapshot;
+
+	// Still writing the previous autosave; try again next interval
+	if (_autosaveActive)
+		return 0;
+	if (_autosaveThread != NULL) {
+		SDL_WaitThread(_autosaveThread, NULL);
+		_autosaveThread = NULL;
+	}
+
+	log_verbose("autosaving game, %s", path);
+
+	// Same live state preparation scenario_save performs
+	map_reorganise_elements();
+	RCT2_CALLPROC_EBPSAFE(0x0069EBE4);
+	RCT2_CALLPROC_EBPSAFE(0x0069EBA4);
+	RCT2_CALLPROC_EBPSAFE(0x00677552);
+	RCT2_CALLPROC_EBPSAFE(0x00674BCF);
+
+	scenario_set_saved_view();
+
+	snapshot = malloc(sizeof(scenario_autosave_snapshot));
+	if (snapshot == NULL)
+		return scenario_save((char*)path, 0x80000000);
+	memset(snapshot, 0, sizeof(scenario_autosave_snapshot));
+	strcpy(snapshot->path, path);
+
+	// With delta autosaves on, full autosaves are chunked containers (the
+	// delta loader needs the base's section directory) and all but every
+	// AUTOSAVE_DELTA_REBASE_INTERVAL-th write is a compact diff against the
+	// retained base, to a _delta sibling file so the base stays on disk
+	if (gConfigGeneral.delta_autosaves) {
+		int pathLength = strlen(path);
+
+		snapshot->writeContainer = 1;
+		if (pathLength + 7 < MAX_PATH) {
+			strcpy(snapshot->deltaPath, path);
+			if (pathLength > 4 && _stricmp(path + pathLength - 4, ".sv6") == 0)
+				pathLength -= 4;
+			strcpy(snapshot->deltaPath + pathLength, "_delta.sv6");
+			if (_autosaveBase != NULL && _autosaveDeltaCount < AUTOSAVE_DELTA_REBASE_INTERVAL)
+				snapshot->deltaEligible = 1;
+		}
+	} else {
+		snapshot->writeContainer = gConfigGeneral.chunked_saves;
+	}
+
+	snapshot->header.type = S6_TYPE_SAVEDGAME;
+	snapshot->header.num_packed_objects = 0;
+	snapshot->header.version = S6_RCT2_VERSION;
+	snapshot->header.magic_number = S6_MAGIC_NUMBER;
+
+	snapshot->availableObjectsLength = 721 * sizeof(rct_object_entry);
+	snapshot->availableObjects = malloc(snapshot->availableObjectsLength);
+	snapshot->mapElements = malloc(0x4A85EC);
+	snapshot->gameData = malloc(0x2E8570);
+	if (snapshot->availableObjects == NULL || snapshot->mapElements == NULL || snapshot->gameData == NULL) {
+		scenario_autosave_snapshot_dispose(snapshot);
+		return scenario_save((char*)path, 0x80000000);
+	}
+
+	scenario_get_available_objects((rct_object_entry*)snapshot->availableObjects);
+	memcpy(snapshot->gameTimeData, (uint8*)0x00F663A8, 16);
+	memcpy(snapshot->mapElements, (uint8*)0x00F663B8, 0x4A85EC);
+	memcpy(snapshot->gameData, (uint8*)0x010E63B8, 0x2E8570);
+
+	_autosaveActive = 1;
+	_autosaveThread = SDL_CreateThread(scenario_autosave_thread, "OpenRCT2 autosave", snapshot);
+	if (_autosaveThread == NULL) {
+		_autosaveActive = 0;
+		scenario_autosave_snapshot_dispose(snapshot);
+		return scenario_save((char*)path, 0x80000000);
+	}
+
+	gfx_invalidate_screen();
+	RCT2_GLOBAL(0x009DEA66, uint16) = 0;
+	return 1;
+}
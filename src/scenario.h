@@ -36,6 +36,19 @@ typedef struct {
 	uint8 pad_0C[0x14];
 } rct_s6_header;
 
+// Scenario bundle: a scenario and the exact object data it requires in one
+// sequentially readable file, see scenario_bundle_export. The header and the
+// bundled objects precede an unmodified classic scenario stream; loaders tell
+// the formats apart by the leading magic, which can never begin a classic
+// file since chunk encoding bytes stop at CHUNK_ENCODING_ROTATE.
+#define SCENARIO_BUNDLE_MAGIC 0x36425253	// "SRB6"
+
+typedef struct {
+	uint32 magic;
+	uint32 numObjects;
+	uint32 scenarioOffset;	// of the embedded classic scenario stream
+} scenario_bundle_header;
+
 /**
  * SC6 information chunk
  * size: 0x198
@@ -406,10 +419,14 @@ int scenario_load_basic(const char *path, rct_s6_header *header, rct_s6_info *in
 int scenario_load(const char *path);
 int scenario_load_and_play(const rct_scenario_basic *scenario);
 int scenario_load_and_play_from_path(const char *path);
+int scenario_bundle_export(const char *scenarioPath, const char *bundlePath);
 void scenario_update();
 unsigned int scenario_rand();
 int scenario_prepare_for_save();
 int scenario_save(char *path, int flags);
+int scenario_save_async(const char *path);
+void scenario_get_available_objects(rct_object_entry *dstEntry);
+void scenario_set_saved_view();
 void scenario_set_filename(const char *value);
 void scenario_failure();
 void scenario_success();
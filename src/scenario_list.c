@@ -21,16 +21,60 @@
 #include "addresses.h"
 #include "platform/platform.h"
 #include "scenario.h"
+#include "util/memtrack.h"
 
 // Scenario list
 int gScenarioListCount = 0;
 int gScenarioListCapacity = 0;
 rct_scenario_basic *gScenarioList = NULL;
 
-static void scenario_list_add(const char *path);
+// Layout version of scenarios.idx; bump whenever the header or entry shape
+// changes so stale caches are rebuilt.
+#define SCENARIO_INDEX_VERSION 2
+
+typedef struct {
+	uint32 version;
+	uint32 count;
+} rct_scenario_index_header;
+
+// One record per file in the Scenarios directory, holding the information
+// scenario_load_basic would otherwise have to parse out of the file. Records
+// whose size and modified date still match are used without opening the
+// scenario, so a launch only parses new or changed files.
+typedef struct {
+	uint64 last_modified;
+	uint32 size;
+	uint8 valid; // 0 if the file failed to parse last time
+	char path[256];
+	uint8 category;
+	uint8 objective_type;
+	uint8 objective_arg_1;
+	sint32 objective_arg_2;
+	sint16 objective_arg_3;
+	char name[64];
+	char details[256];
+	// Flag byte from the scenario text object (RCT2_GLOBAL 0x009AA00C); the
+	// name and details above are already the localised text resolved through
+	// that object, so together these make a cached record fully reproduce
+	// scenario_load_basic without any file access
+	uint8 stex_flags;
+} rct_scenario_index_entry;
+
+static rct_scenario_index_entry *_scenarioIndex = NULL;
+static int _scenarioIndexCount = 0;
+static int _scenarioIndexCapacity = 0;
+
+// Index read from disk at the start of a scan, used for lookups while the
+// new index is rebuilt
+static rct_scenario_index_entry *_oldScenarioIndex = NULL;
+static int _oldScenarioIndexCount = 0;
+
+static void scenario_list_add(const file_info *fileInfo);
 static void scenario_list_sort();
 static int scenario_list_sort_compare(const void *a, const void *b);
 static int scenario_scores_load();
+static void scenario_index_load();
+static void scenario_index_save();
 
 static rct_scenario_basic *get_scenario_by_filename(const char *filename)
 {
@@ -58,15 +102,25 @@ void scenario_load_list()
 	for (i = 0; i < gScenarioListCount; i++)
 		gScenarioList[i].flags &= ~SCENARIO_FLAGS_VISIBLE;
 
+	// Load the previous index so unchanged files need not be parsed again
+	scenario_index_load();
+	_scenarioIndexCount = 0;
+
 	// Enumerate through each scenario in the directory
 	enumFileHandle = platform_enumerate_files_begin(RCT2_ADDRESS(RCT2_ADDRESS_SCENARIOS_PATH, char));
 	if (enumFileHandle != INVALID_HANDLE) {
 		while (platform_enumerate_files_next(enumFileHandle, &enumFileInfo)) {
-			scenario_list_add(enumFileInfo.path);
+			scenario_list_add(&enumFileInfo);
 		}
 		platform_enumerate_files_end(enumFileHandle);
 	}
 
+	// Save the rebuilt index, dropping records for removed files
+	memtrack_free(_oldScenarioIndex);
+	_oldScenarioIndex = NULL;
+	_oldScenarioIndexCount = 0;
+	scenario_index_save();
+
 	// Sort alphabetically
 	scenario_list_sort();
 
@@ -74,42 +128,92 @@ void scenario_load_list()
 	scenario_scores_save();
 }
 
-static void scenario_list_add(const char *path)
+static rct_scenario_index_entry *scenario_index_find(const file_info *fileInfo)
+{
+	int i;
+	rct_scenario_index_entry *indexEntry;
+
+	for (i = 0; i < _oldScenarioIndexCount; i++) {
+		indexEntry = &_oldScenarioIndex[i];
+		if (_stricmp(indexEntry->path, fileInfo->path) != 0)
+			continue;
+		if (indexEntry->last_modified != fileInfo->last_modified || indexEntry->size != (uint32)fileInfo->size)
+			return NULL;
+		return indexEntry;
+	}
+	return NULL;
+}
+
+static void scenario_index_append(const rct_scenario_index_entry *indexEntry)
+{
+	if (_scenarioIndexCount >= _scenarioIndexCapacity) {
+		_scenarioIndexCapacity = max(64, _scenarioIndexCapacity * 2);
+		_scenarioIndex = memtrack_realloc(MEMTRACK_TAG_SCENARIOS, _scenarioIndex, _scenarioIndexCapacity * sizeof(rct_scenario_index_entry));
+	}
+	_scenarioIndex[_scenarioIndexCount++] = *indexEntry;
+}
+
+static void scenario_list_add(const file_info *fileInfo)
 {
 	char scenarioPath[MAX_PATH];
 	rct_scenario_basic *scenario;
+	rct_scenario_index_entry info;
+	rct_scenario_index_entry *cached;
 	rct_s6_header s6Header;
 	rct_s6_info s6Info;
 
-	// Get absolute path
-	subsitute_path(scenarioPath, RCT2_ADDRESS(RCT2_ADDRESS_SCENARIOS_PATH, char), path);
+	cached = scenario_index_find(fileInfo);
+	if (cached != NULL) {
+		// File unchanged since it was last indexed, skip parsing it
+		info = *cached;
+	} else {
+		// Get absolute path
+		subsitute_path(scenarioPath, RCT2_ADDRESS(RCT2_ADDRESS_SCENARIOS_PATH, char), fileInfo->path);
+
+		memset(&info, 0, sizeof(rct_scenario_index_entry));
+
+		// Load the basic scenario information
+		// Ignore scenarios where first header byte is not 255
+		if (scenario_load_basic(scenarioPath, &s6Header, &s6Info) && s6Info.var_000 == 255) {
+			info.valid = 1;
+			info.category = s6Info.category;
+			info.objective_type = s6Info.objective_type;
+			info.objective_arg_1 = s6Info.objective_arg_1;
+			info.objective_arg_2 = s6Info.objective_arg_2;
+			info.objective_arg_3 = s6Info.objective_arg_3;
+			info.stex_flags = RCT2_GLOBAL(0x009AA00C, uint8);
+			strcpy(info.name, s6Info.name);
+			strcpy(info.details, s6Info.details);
+		}
+	}
 
-	// Load the basic scenario information
-	if (!scenario_load_basic(scenarioPath, &s6Header, &s6Info))
-		return;
+	info.last_modified = fileInfo->last_modified;
+	info.size = (uint32)fileInfo->size;
+	strncpy(info.path, fileInfo->path, sizeof(info.path) - 1);
+	info.path[sizeof(info.path) - 1] = 0;
+	scenario_index_append(&info);
 
-	// Ignore scenarios where first header byte is not 255
-	if (s6Info.var_000 != 255)
+	if (!info.valid)
 		return;
 
 	// Check if scenario already exists in list, likely if in scores
-	scenario = get_scenario_by_filename(path);
+	scenario = get_scenario_by_filename(fileInfo->path);
 	if (scenario != NULL) {
 		// Update the scenario information
 		scenario->flags |= SCENARIO_FLAGS_VISIBLE;
-		scenario->category = s6Info.category;
-		scenario->objective_type = s6Info.objective_type;
-		scenario->objective_arg_1 = s6Info.objective_arg_1;
-		scenario->objective_arg_2 = s6Info.objective_arg_2;
-		scenario->objective_arg_3 = s6Info.objective_arg_3;
-		strcpy(scenario->name, s6Info.name);
-		strcpy(scenario->details, s6Info.details);
+		scenario->category = info.category;
+		scenario->objective_type = info.objective_type;
+		scenario->objective_arg_1 = info.objective_arg_1;
+		scenario->objective_arg_2 = info.objective_arg_2;
+		scenario->objective_arg_3 = info.objective_arg_3;
+		strcpy(scenario->name, info.name);
+		strcpy(scenario->details, info.details);
 	} else {
 		// Check if the scenario list buffer has room for another scenario
 		if (gScenarioListCount >= gScenarioListCapacity) {
 			// Allocate more room
 			gScenarioListCapacity += 16;
-			gScenarioList = realloc(gScenarioList, gScenarioListCapacity * sizeof(rct_scenario_basic));
+			gScenarioList = memtrack_realloc(MEMTRACK_TAG_SCENARIOS, gScenarioList, gScenarioListCapacity * sizeof(rct_scenario_basic));
 		}
 
 		// Increment the number of scenarios
@@ -117,20 +221,84 @@ static void scenario_list_add(const char *path)
 		gScenarioListCount++;
 
 		// Add this new scenario to the list
-		strcpy(scenario->path, path);
+		strcpy(scenario->path, fileInfo->path);
 		scenario->flags = SCENARIO_FLAGS_VISIBLE;
-		if (RCT2_GLOBAL(0x009AA00C, uint8) & 1)
+		// Use the indexed flag byte rather than RCT2_GLOBAL(0x009AA00C), which
+		// only holds a value for freshly parsed files
+		if (info.stex_flags & 1)
 			scenario->flags |= SCENARIO_FLAGS_SIXFLAGS;
-		scenario->category = s6Info.category;
-		scenario->objective_type = s6Info.objective_type;
-		scenario->objective_arg_1 = s6Info.objective_arg_1;
-		scenario->objective_arg_2 = s6Info.objective_arg_2;
-		scenario->objective_arg_3 = s6Info.objective_arg_3;
-		strcpy(scenario->name, s6Info.name);
-		strcpy(scenario->details, s6Info.details);
+		scenario->category = info.category;
+		scenario->objective_type = info.objective_type;
+		scenario->objective_arg_1 = info.objective_arg_1;
+		scenario->objective_arg_2 = info.objective_arg_2;
+		scenario->objective_arg_3 = info.objective_arg_3;
+		strcpy(scenario->name, info.name);
+		strcpy(scenario->details, info.details);
 	}
 }
 
+/**
+ * Gets the path for the scenario index cache file.
+ */
+static void scenario_index_get_path(char *outPath)
+{
+	platform_get_user_directory(outPath, NULL);
+	strcat(outPath, "scenarios.idx");
+}
+
+static void scenario_index_load()
+{
+	FILE *file;
+	char path[MAX_PATH];
+	rct_scenario_index_header header;
+
+	memtrack_free(_oldScenarioIndex);
+	_oldScenarioIndex = NULL;
+	_oldScenarioIndexCount = 0;
+
+	scenario_index_get_path(path);
+	file = fopen(path, "rb");
+	if (file == NULL)
+		return;
+
+	if (fread(&header, sizeof(rct_scenario_index_header), 1, file) != 1 || header.version != SCENARIO_INDEX_VERSION || header.count == 0) {
+		fclose(file);
+		return;
+	}
+
+	_oldScenarioIndex = memtrack_alloc(MEMTRACK_TAG_SCENARIOS, header.count * sizeof(rct_scenario_index_entry));
+	if (fread(_oldScenarioIndex, sizeof(rct_scenario_index_entry), header.count, file) == header.count) {
+		_oldScenarioIndexCount = header.count;
+	} else {
+		memtrack_free(_oldScenarioIndex);
+		_oldScenarioIndex = NULL;
+	}
+
+	fclose(file);
+}
+
+static void scenario_index_save()
+{
+	FILE *file;
+	char path[MAX_PATH];
+	rct_scenario_index_header header;
+
+	scenario_index_get_path(path);
+	file = fopen(path, "wb");
+	if (file == NULL) {
+		RCT2_ERROR("Unable to save scenario index.");
+		return;
+	}
+
+	header.version = SCENARIO_INDEX_VERSION;
+	header.count = _scenarioIndexCount;
+
+	fwrite(&header, sizeof(rct_scenario_index_header), 1, file);
+	if (_scenarioIndexCount > 0)
+		fwrite(_scenarioIndex, sizeof(rct_scenario_index_entry), _scenarioIndexCount, file);
+	fclose(file);
+}
+
 /**
 * Sort the list of scenarios. This used to be an insertion sort which took
 * place as each scenario loaded. It has now been changed to a quicksort which
@@ -173,7 +341,7 @@ static int scenario_scores_load()
 
 	// Free scenario list if already allocated
 	if (gScenarioList != NULL) {
-		free(gScenarioList);
+		memtrack_free(gScenarioList);
 		gScenarioList = NULL;
 	}
 
@@ -201,7 +369,7 @@ static int scenario_scores_load()
 	// Load scenario information with scores
 	int scenarioListBufferSize = gScenarioListCount * sizeof(rct_scenario_basic);
 	gScenarioListCapacity = gScenarioListCount;
-	gScenarioList = malloc(scenarioListBufferSize);
+	gScenarioList = memtrack_alloc(MEMTRACK_TAG_SCENARIOS, scenarioListBufferSize);
 	if (fread(gScenarioList, scenarioListBufferSize, 1, file) == 1) {
 		fclose(file);
 		return 1;
@@ -211,7 +379,7 @@ static int scenario_scores_load()
 	fclose(file);
 	gScenarioListCount = 0;
 	gScenarioListCapacity = 0;
-	free(gScenarioList);
+	memtrack_free(gScenarioList);
 	gScenarioList = NULL;
 	return 0;
 }
@@ -0,0 +1,174 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "addresses.h"
+#include "ride/ride.h"
+#include "statehash.h"
+#include "world/map.h"
+#include "world/sprite.h"
+
+// Rolling hashes over the major simulation state blocks, cheap enough to stay
+// on in production. The state is mutated from the original game code as much
+// as from ours, so there is no single set of mutation points to hook;
+// instead each block is split into buckets and a fixed slice of buckets is
+// rehashed every tick, keyed off the tick counter alone. A mutation shows up
+// in the digest within one coverage period, and because the schedule is
+// deterministic a replayed run rehashes the same regions on the same ticks,
+// so equal ticks with unequal digests mean the simulations have diverged.
+//
+// Each block hash is the xor of its bucket hashes and is maintained
+// incrementally: rehashing a bucket folds out the old value and folds in the
+// new one, so the per tick cost is just hashing the slice itself.
+
+// Map rows rehashed per tick; all 256 rows every 32 ticks
+#define STATEHASH_MAP_ROWS_PER_TICK	8
+
+// One sprite bucket per tick; all of g_sprite_list every 50 ticks
+#define STATEHASH_SPRITE_BUCKETS	50
+#define STATEHASH_SPRITES_PER_BUCKET	(MAX_SPRITES / STATEHASH_SPRITE_BUCKETS)
+
+// One ride bucket per tick; the whole ride array every 16 ticks
+#define STATEHASH_RIDE_BUCKETS		16
+#define STATEHASH_RIDES_PER_BUCKET	((MAX_RIDES + STATEHASH_RIDE_BUCKETS - 1) / STATEHASH_RIDE_BUCKETS)
+
+// Ticks after an invalidation before every bucket has been rehashed; the
+// longest of the three coverage periods above
+#define STATEHASH_VALID_TICKS		STATEHASH_SPRITE_BUCKETS
+
+// Digest logged every this many ticks (verbose only), so record and replay
+// logs can be diffed directly
+#define STATEHASH_LOG_INTERVAL		1024
+
+static uint32 _mapRowHash[256];
+static uint32 _spriteBucketHash[STATEHASH_SPRITE_BUCKETS];
+static uint32 _rideBucketHash[STATEHASH_RIDE_BUCKETS];
+static int _staleTicks = STATEHASH_VALID_TICKS;
+
+uint32 gStateHashMap = 0;
+uint32 gStateHashSprites = 0;
+uint32 gStateHashRides = 0;
+uint32 gStateHashDigest = 0;
+
+static uint32 statehash_fnv1a(uint32 hash, const uint8 *data, int length)
+{
+	for (int i = 0; i < length; i++) {
+		hash ^= data[i];
+		hash *= 0x01000193;
+	}
+	return hash;
+}
+
+// Buckets are seeded with their index so identical contents in different
+// buckets do not cancel out of the xor fold
+static uint32 statehash_seed(int index)
+{
+	return 0x811C9DC5 ^ (index * 0x9E3779B9);
+}
+
+static uint32 statehash_map_row(int y)
+{
+	uint32 hash = statehash_seed(y);
+
+	for (int x = 0; x < 256; x++) {
+		rct_map_element *element = map_get_first_element_at(x, y);
+		do {
+			hash = statehash_fnv1a(hash, (uint8*)element, 8);
+		} while (!map_element_is_last_for_tile(element++));
+	}
+	return hash;
+}
+
+static uint32 statehash_sprite_bucket(int index)
+{
+	int first = index * STATEHASH_SPRITES_PER_BUCKET;
+	int count = min(STATEHASH_SPRITES_PER_BUCKET, MAX_SPRITES - first);
+
+	return statehash_fnv1a(statehash_seed(index), (uint8*)&g_sprite_list[first], count * sizeof(rct_sprite));
+}
+
+static uint32 statehash_ride_bucket(int index)
+{
+	int first = index * STATEHASH_RIDES_PER_BUCKET;
+	int count = min(STATEHASH_RIDES_PER_BUCKET, MAX_RIDES - first);
+
+	return statehash_fnv1a(statehash_seed(index), (uint8*)&g_ride_list[first], count * sizeof(rct_ride));
+}
+
+/**
+ * Marks the hashes stale after a different park has been loaded over the
+ * state. The buckets converge back over the next coverage period instead of
+ * being rehashed in full here, so invalidation is free at the call site.
+ */
+void statehash_invalidate()
+{
+	memset(_mapRowHash, 0, sizeof(_mapRowHash));
+	memset(_spriteBucketHash, 0, sizeof(_spriteBucketHash));
+	memset(_rideBucketHash, 0, sizeof(_rideBucketHash));
+	gStateHashMap = 0;
+	gStateHashSprites = 0;
+	gStateHashRides = 0;
+	gStateHashDigest = 0;
+	_staleTicks = STATEHASH_VALID_TICKS;
+}
+
+int statehash_valid()
+{
+	return _staleTicks == 0;
+}
+
+/**
+ * Rehashes this tick's slice of each state block. Called once per logic tick;
+ * not called for headless background park ticks, whose state is byte
+ * identical again once the active park is swapped back in.
+ */
+void statehash_update()
+{
+	uint32 tick = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
+	uint32 hash;
+	int i, index;
+
+	index = (tick * STATEHASH_MAP_ROWS_PER_TICK) % 256;
+	for (i = 0; i < STATEHASH_MAP_ROWS_PER_TICK; i++) {
+		hash = statehash_map_row(index + i);
+		gStateHashMap ^= _mapRowHash[index + i] ^ hash;
+		_mapRowHash[index + i] = hash;
+	}
+
+	index = tick % STATEHASH_SPRITE_BUCKETS;
+	hash = statehash_sprite_bucket(index);
+	gStateHashSprites ^= _spriteBucketHash[index] ^ hash;
+	_spriteBucketHash[index] = hash;
+
+	index = tick % STATEHASH_RIDE_BUCKETS;
+	hash = statehash_ride_bucket(index);
+	gStateHashRides ^= _rideBucketHash[index] ^ hash;
+	_rideBucketHash[index] = hash;
+
+	// Rotate the blocks apart so a change moving between blocks cannot cancel
+	gStateHashDigest = gStateHashMap
+		^ ((gStateHashSprites << 11) | (gStateHashSprites >> 21))
+		^ ((gStateHashRides << 22) | (gStateHashRides >> 10));
+
+	if (_staleTicks > 0)
+		_staleTicks--;
+	else if (tick % STATEHASH_LOG_INTERVAL == 0)
+		log_verbose("state hash %08x (map %08x sprites %08x rides %08x) at tick %u",
+			gStateHashDigest, gStateHashMap, gStateHashSprites, gStateHashRides, tick);
+}
@@ -25,16 +25,25 @@
 #include "drawing/drawing.h"
 #include "editor.h"
 #include "game.h"
+#include "game_state.h"
 #include "input.h"
 #include "localisation/date.h"
 #include "localisation/localisation.h"
 #include "interface/screenshot.h"
 #include "interface/viewport.h"
 #include "intro.h"
+#include "management/finance.h"
 #include "management/news_item.h"
 #include "management/research.h"
+#include "object.h"
+#include "peep/staff.h"
+#include "platform/platform.h"
 #include "ride/ride.h"
+#include "ride/ride_stats.h"
+#include "ride/station.h"
 #include "scenario.h"
+#include "statehash.h"
+#include "util/sawyercoding.h"
 #include "world/climate.h"
 #include "world/map.h"
 #include "world/park.h"
@@ -84,6 +93,179 @@ static uint8 *generate_random_script();
 
 #pragma endregion
 
+#pragma region Title park prefetch
+
+// The showcase park used to be loaded synchronously by the first LOAD opcode,
+// which held up the menu while the scenario decoded and its objects loaded.
+// Instead the script is scanned ahead for the park its LOAD opcodes will
+// need and that park is decoded on a background thread into a shadow copy of
+// the saved game state span; the LOAD opcode then only loads the objects and
+// memcpys the shadow over the live state. While the decode is still running
+// the menu stays up over the empty placeholder park title_load builds.
+
+enum {
+	PREFETCH_STATE_IDLE,
+	PREFETCH_STATE_LOADING,
+	PREFETCH_STATE_READY,
+	PREFETCH_STATE_FAILED
+};
+
+// The scenario state chunks all decode inside [0x00F663A8, 0x00F663A8 + 16 +
+// 0x4A85EC): 16 bytes of game time, then the map element chunk whose span
+// also covers the region the game data chunks rewrite, see scenario_save
+#define PREFETCH_SHADOW_BASE 0x00F663A8
+#define PREFETCH_SHADOW_SIZE (16 + 0x4A85EC)
+#define PREFETCH_SHADOW(address) (_parkPrefetch.shadow + ((address) - PREFETCH_SHADOW_BASE))
+
+typedef struct {
+	volatile int state;
+	char path[MAX_PATH];
+	rct_s6_header header;
+	rct_s6_info info;
+	rct_object_entry objects[721];
+	uint8 *shadow;
+} title_park_prefetch;
+
+static title_park_prefetch _parkPrefetch;
+static SDL_Thread *_prefetchThread = NULL;
+
+static int title_park_prefetch_thread(void *ptr)
+{
+	file_mapping fm;
+	sawyercoding_reader reader;
+
+	if (!platform_file_map(_parkPrefetch.path, &fm)) {
+		_parkPrefetch.state = PREFETCH_STATE_FAILED;
+		return 0;
+	}
+	if (!sawyercoding_validate_checksum_buffer(fm.data, fm.size)) {
+		platform_file_unmap(&fm);
+		_parkPrefetch.state = PREFETCH_STATE_FAILED;
+		return 0;
+	}
+
+	sawyercoding_reader_init(&reader, fm.data, fm.size);
+	sawyercoding_reader_read_chunk(&reader, (uint8*)&_parkPrefetch.header);
+
+	// Packed objects would have to be written out to the object directory;
+	// leave that to the synchronous loader
+	if (_parkPrefetch.header.type != S6_TYPE_SCENARIO || _parkPrefetch.header.num_packed_objects > 0) {
+		platform_file_unmap(&fm);
+		_parkPrefetch.state = PREFETCH_STATE_FAILED;
+		return 0;
+	}
+
+	sawyercoding_reader_read_chunk(&reader, (uint8*)&_parkPrefetch.info);
+	sawyercoding_reader_read_chunk(&reader, (uint8*)_parkPrefetch.objects);
+
+	// Decode the state chunks into the shadow at the same offsets
+	// scenario_load decodes them to, in the same order
+	memset(_parkPrefetch.shadow, 0, PREFETCH_SHADOW_SIZE);
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(RCT2_ADDRESS_CURRENT_MONTH_YEAR));
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(RCT2_ADDRESS_MAP_ELEMENTS));
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(0x010E63B8));
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(RCT2_ADDRESS_GUESTS_IN_PARK));
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(0x01357BC8));
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(RCT2_ADDRESS_CURRENT_PARK_RATING));
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(RCT2_ADDRESS_ACTIVE_RESEARCH_TYPES));
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(RCT2_ADDRESS_CURRENT_EXPENDITURE));
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(RCT2_ADDRESS_CURRENT_PARK_VALUE));
+	sawyercoding_reader_read_chunk(&reader, PREFETCH_SHADOW(RCT2_ADDRESS_COMPLETED_COMPANY_VALUE));
+
+	platform_file_unmap(&fm);
+	_parkPrefetch.state = PREFETCH_STATE_READY;
+	return 1;
+}
+
+static void title_park_prefetch_begin(const char *path)
+{
+	if (_parkPrefetch.state == PREFETCH_STATE_LOADING)
+		return;
+	if (_prefetchThread != NULL) {
+		SDL_WaitThread(_prefetchThread, NULL);
+		_prefetchThread = NULL;
+	}
+
+	if (_parkPrefetch.shadow == NULL) {
+		_parkPrefetch.shadow = malloc(PREFETCH_SHADOW_SIZE);
+		if (_parkPrefetch.shadow == NULL)
+			return;
+	}
+
+	strcpy(_parkPrefetch.path, path);
+	_parkPrefetch.state = PREFETCH_STATE_LOADING;
+	_prefetchThread = SDL_CreateThread(title_park_prefetch_thread, "OpenRCT2 title park", NULL);
+	if (_prefetchThread == NULL)
+		_parkPrefetch.state = PREFETCH_STATE_IDLE;
+}
+
+/**
+ * Loads the prefetched park's objects and copies the decoded state over the
+ * live game state, completing what scenario_load would have done. Returns 0
+ * if the objects cannot be loaded, in which case the caller falls back to
+ * the synchronous loader.
+ */
+static int title_park_prefetch_apply()
+{
+	_parkPrefetch.state = PREFETCH_STATE_IDLE;
+
+	if (!object_load_entries(_parkPrefetch.objects))
+		return 0;
+
+	memcpy((void*)0x009E34E4, &_parkPrefetch.header, sizeof(rct_s6_header));
+	memcpy((void*)0x0141F570, &_parkPrefetch.info, sizeof(rct_s6_info));
+	memcpy((void*)PREFETCH_SHADOW_BASE, _parkPrefetch.shadow, PREFETCH_SHADOW_SIZE);
+
+	reset_loaded_objects();
+	map_update_tile_pointers();
+	reset_0x69EBE4();
+	game_state_sync_from_legacy();
+	peep_thought_counters_invalidate();
+	staff_patrol_index_invalidate();
+	user_string_table_invalidate();
+	finance_history_invalidate();
+	editor_object_flags_invalidate();
+	ride_stats_invalidate();
+	ride_station_element_hints_invalidate();
+	ride_index_cache_invalidate();
+	park_size_invalidate();
+	park_appeal_invalidate();
+	statehash_invalidate();
+	return 1;
+}
+
+/**
+ * Scans a showcase script for the parks its LOAD opcodes will need and
+ * starts prefetching. Every LOAD today loads the showcase park, so a single
+ * prefetch slot covers the whole sequence; called again after each load so
+ * the next loop's park decodes while the current one is on show.
+ */
+static void title_sequence_prefetch_parks(const uint8 *script)
+{
+	const uint8 *position = script;
+
+	for (;;) {
+		switch (*position++) {
+		case TITLE_SCRIPT_WAIT:
+			position++;
+			break;
+		case TITLE_SCRIPT_LOAD:
+			title_park_prefetch_begin(get_file_path(PATH_ID_SIXFLAGS_MAGICMOUNTAIN));
+			return;
+		case TITLE_SCRIPT_LOCATION:
+			position += 2;
+			break;
+		case TITLE_SCRIPT_ROTATE:
+			position++;
+			break;
+		case TITLE_SCRIPT_RESTART:
+			return;
+		}
+	}
+}
+
+#pragma endregion
+
 static void title_create_windows();
 
 /**
@@ -150,6 +332,7 @@ static void title_init_showcase()
 	if (gRandomShowcase)
 		_currentScript = generate_random_script();
 	_scriptWaitCounter = 0;
+	title_sequence_prefetch_parks(_currentScript);
 	title_update_showcase();
 }
 
@@ -172,13 +355,26 @@ static void title_update_showcase()
 				_scriptWaitCounter = (*_currentScript++) * 32;
 				break;
 			case TITLE_SCRIPT_LOAD:
-				if (scenario_load(get_file_path(PATH_ID_SIXFLAGS_MAGICMOUNTAIN))) {
+				// Keep the menu up over the placeholder park until the
+				// background decode finishes; re-run this opcode next tick
+				if (_parkPrefetch.state == PREFETCH_STATE_LOADING) {
+					_currentScript--;
+					_scriptWaitCounter = 1;
+					break;
+				}
+
+				if (_parkPrefetch.state == PREFETCH_STATE_READY && title_park_prefetch_apply()) {
+					log_verbose("loaded prefetched title scenario");
+				} else if (scenario_load(get_file_path(PATH_ID_SIXFLAGS_MAGICMOUNTAIN))) {
 					log_verbose("loaded title scenario");
 				} else {
 					load_palette();
 					title_create_windows();
 				}
 
+				// Start decoding the park the next LOAD will show
+				title_sequence_prefetch_parks(_currentScript);
+
 				w = window_get_main();
 				w->viewport_target_sprite = -1;
 				w->saved_view_x = RCT2_GLOBAL(RCT2_ADDRESS_SAVED_VIEW_X, sint16);
@@ -239,6 +435,9 @@ static void title_update_showcase()
 						free((uint8*)_currentScript);
 					_currentScript = generate_random_script();
 				}
+				// The sequence loops back to its LOAD, decode the park again
+				// while the current state is still on show
+				title_sequence_prefetch_parks(_currentScript);
 				break;
 			}
 		} while (_scriptWaitCounter == 0);
@@ -0,0 +1,154 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <SDL.h>
+#include "../platform/platform.h"
+#include "memtrack.h"
+
+// Tagged allocation tracking. Every tracked block is prefixed with a small
+// header recording its size and tag, so frees and reallocs adjust the
+// per-subsystem counters without the caller repeating either. The counters
+// are guarded by a spinlock since the audio subsystem allocates from its own
+// threads. The live figures are drawn on the profiler overlay and exported
+// to memory.csv alongside the profiler history.
+
+typedef struct {
+	uint32 size;
+	uint32 tag;
+} memtrack_header;
+
+typedef struct {
+	uint32 currentBytes;
+	uint32 peakBytes;
+	uint32 blockCount;
+} memtrack_stats;
+
+static memtrack_stats _stats[MEMTRACK_TAG_COUNT];
+static SDL_SpinLock _statsLock;
+
+static const char *_tagNames[MEMTRACK_TAG_COUNT] = {
+	"objects",
+	"audio",
+	"scenarios",
+	"drawing",
+	"windows"
+};
+
+static void memtrack_adjust(int tag, sint32 sizeDelta, sint32 blockDelta)
+{
+	memtrack_stats *stats = &_stats[tag];
+
+	SDL_AtomicLock(&_statsLock);
+	stats->currentBytes += sizeDelta;
+	stats->blockCount += blockDelta;
+	if (stats->currentBytes > stats->peakBytes)
+		stats->peakBytes = stats->currentBytes;
+	SDL_AtomicUnlock(&_statsLock);
+}
+
+void *memtrack_alloc(int tag, size_t size)
+{
+	memtrack_header *header;
+
+	header = malloc(sizeof(memtrack_header) + size);
+	if (header == NULL)
+		return NULL;
+
+	header->size = size;
+	header->tag = tag;
+	memtrack_adjust(tag, (sint32)size, 1);
+	return header + 1;
+}
+
+void *memtrack_realloc(int tag, void *ptr, size_t size)
+{
+	memtrack_header *header;
+	uint32 oldSize;
+
+	if (ptr == NULL)
+		return memtrack_alloc(tag, size);
+
+	header = (memtrack_header*)ptr - 1;
+	oldSize = header->size;
+	header = realloc(header, sizeof(memtrack_header) + size);
+	if (header == NULL)
+		return NULL;
+
+	header->size = size;
+	memtrack_adjust(header->tag, (sint32)size - (sint32)oldSize, 0);
+	return header + 1;
+}
+
+void memtrack_free(void *ptr)
+{
+	memtrack_header *header;
+
+	if (ptr == NULL)
+		return;
+
+	header = (memtrack_header*)ptr - 1;
+	memtrack_adjust(header->tag, -(sint32)header->size, -1);
+	free(header);
+}
+
+void memtrack_get_stats(int tag, uint32 *currentBytes, uint32 *peakBytes, uint32 *blockCount)
+{
+	SDL_AtomicLock(&_statsLock);
+	*currentBytes = _stats[tag].currentBytes;
+	*peakBytes = _stats[tag].peakBytes;
+	*blockCount = _stats[tag].blockCount;
+	SDL_AtomicUnlock(&_statsLock);
+}
+
+const char *memtrack_tag_name(int tag)
+{
+	return _tagNames[tag];
+}
+
+/**
+ * Dumps the per-subsystem counters to memory.csv in the user directory.
+ * Returns 1 on success.
+ */
+int memtrack_export_csv()
+{
+	char path[MAX_PATH];
+	FILE *file;
+	uint32 currentBytes, peakBytes, blockCount;
+	int i;
+
+	platform_get_user_directory(path, NULL);
+	strcat(path, "memory.csv");
+
+	file = fopen(path, "w");
+	if (file == NULL) {
+		log_error("Unable to write %s", path);
+		return 0;
+	}
+
+	fprintf(file, "subsystem,current_bytes,peak_bytes,blocks\n");
+	for (i = 0; i < MEMTRACK_TAG_COUNT; i++) {
+		memtrack_get_stats(i, &currentBytes, &peakBytes, &blockCount);
+		fprintf(file, "%s,%u,%u,%u\n", _tagNames[i], currentBytes, peakBytes, blockCount);
+	}
+
+	fclose(file);
+	log_verbose("memory statistics written to %s", path);
+	return 1;
+}
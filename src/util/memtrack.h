@@ -0,0 +1,43 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _MEMTRACK_H_
+#define _MEMTRACK_H_
+
+#include "../common.h"
+
+// Subsystems that tag their heap allocations, see memtrack.c
+enum {
+	MEMTRACK_TAG_OBJECTS,
+	MEMTRACK_TAG_AUDIO,
+	MEMTRACK_TAG_SCENARIOS,
+	MEMTRACK_TAG_DRAWING,
+	MEMTRACK_TAG_WINDOWS,
+	MEMTRACK_TAG_COUNT
+};
+
+void *memtrack_alloc(int tag, size_t size);
+void *memtrack_realloc(int tag, void *ptr, size_t size);
+void memtrack_free(void *ptr);
+void memtrack_get_stats(int tag, uint32 *currentBytes, uint32 *peakBytes, uint32 *blockCount);
+const char *memtrack_tag_name(int tag);
+int memtrack_export_csv();
+
+#endif
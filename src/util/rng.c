@@ -0,0 +1,64 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "../addresses.h"
+#include "rng.h"
+
+// Counter based random streams for parallel subsystem updates. The global
+// scenario RNG hands out values in call order, which serialises every
+// consumer: two updates running on worker pool jobs would draw different
+// values depending on which got there first. A stream draw instead is a pure
+// function of (tick seed, stream, entity index, sequence), so any number of
+// entities can draw concurrently and still reproduce exactly under replay.
+//
+// The tick seed is derived from the scenario RNG state at the start of the
+// tick without consuming it, so the streams are keyed to the same saved and
+// replayed state as everything else and need no state of their own. Draws
+// from the same entity in one tick must pass distinct sequence numbers.
+static uint32 _rngTickSeed;
+
+// 32 bit avalanche mix (the finaliser constants are from murmur3)
+static uint32 rng_mix32(uint32 x)
+{
+	x ^= x >> 16;
+	x *= 0x85EBCA6B;
+	x ^= x >> 13;
+	x *= 0xC2B2AE35;
+	x ^= x >> 16;
+	return x;
+}
+
+void rng_streams_tick_begin()
+{
+	_rngTickSeed = rng_mix32(
+		RCT2_GLOBAL(RCT2_ADDRESS_SCENARIO_SRAND_0, uint32) ^
+		rol32(RCT2_GLOBAL(RCT2_ADDRESS_SCENARIO_SRAND_1, uint32), 16) ^
+		RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32)
+	);
+}
+
+uint32 rng_stream_rand(int stream, uint32 entityIndex, uint32 sequence)
+{
+	uint32 x = _rngTickSeed;
+	x ^= (uint32)stream * 0x9E3779B9;
+	x ^= entityIndex * 0x85EBCA6B;
+	x ^= sequence * 0xC2B2AE35;
+	return rng_mix32(x);
+}
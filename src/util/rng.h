@@ -0,0 +1,37 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _RNG_H_
+#define _RNG_H_
+
+#include "../common.h"
+
+// Streams for subsystems drawing parallel safe randomness, see rng.c
+enum {
+	RNG_STREAM_PEEP,
+	RNG_STREAM_VEHICLE,
+	RNG_STREAM_MISC_SPRITE,
+	RNG_STREAM_COUNT
+};
+
+void rng_streams_tick_begin();
+uint32 rng_stream_rand(int stream, uint32 entityIndex, uint32 sequence);
+
+#endif
@@ -0,0 +1,288 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "savecontainer.h"
+#include "sawyercoding.h"
+
+int save_container_is(const uint8 *data, uint32 size)
+{
+	if (size < sizeof(save_container_header))
+		return 0;
+	return ((save_container_header*)data)->magic == SAVE_CONTAINER_MAGIC;
+}
+
+static const save_container_section *save_sections_find(const uint8 *data, uint32 size, uint32 headerSize, uint32 numSections, uint32 id)
+{
+	const save_container_section *sections, *section;
+	uint32 i;
+
+	if (numSections > SAVE_CONTAINER_MAX_SECTIONS)
+		return NULL;
+	if (size < headerSize + (SAVE_CONTAINER_MAX_SECTIONS * sizeof(save_container_section)))
+		return NULL;
+
+	sections = (const save_container_section*)(data + headerSize);
+	for (i = 0; i < numSections; i++) {
+		section = &sections[i];
+		if (section->id != id)
+			continue;
+
+		// Bounds check before anyone decodes from it
+		if (section->offset > size || section->encodedLength > size - section->offset)
+			return NULL;
+		return section;
+	}
+	return NULL;
+}
+
+const save_container_section *save_container_find(const uint8 *data, uint32 size, uint32 id)
+{
+	if (!save_container_is(data, size))
+		return NULL;
+	return save_sections_find(data, size, sizeof(save_container_header), ((save_container_header*)data)->numSections, id);
+}
+
+/**
+ * Sums the section checksums of a full container. Deltas store this sum to
+ * identify the exact base they apply to; it reads from the section directory
+ * alone, no section data needs decoding.
+ */
+uint32 save_container_checksum(const uint8 *data, uint32 size)
+{
+	const save_container_header *header = (const save_container_header*)data;
+	const save_container_section *sections;
+	uint32 i, checksum = 0;
+
+	if (!save_container_is(data, size))
+		return 0;
+	if (header->numSections > SAVE_CONTAINER_MAX_SECTIONS)
+		return 0;
+	if (size < sizeof(save_container_header) + (SAVE_CONTAINER_MAX_SECTIONS * sizeof(save_container_section)))
+		return 0;
+
+	sections = (const save_container_section*)(data + sizeof(save_container_header));
+	for (i = 0; i < header->numSections; i++)
+		checksum += sections[i].checksum;
+	return checksum;
+}
+
+/**
+ * Decodes a single section into dest, which must hold decodedLength bytes.
+ * Sections are independent, so this is safe to call from multiple worker
+ * threads at once for different sections. Returns the decoded length or -1.
+ */
+int save_container_decode(const uint8 *data, const save_container_section *section, uint8 *dest)
+{
+	sawyercoding_reader reader;
+	int decodedLength;
+
+	if (sawyercoding_calculate_checksum((uint8*)data + section->offset, section->encodedLength) != section->checksum)
+		return -1;
+
+	sawyercoding_reader_init(&reader, data + section->offset, section->encodedLength);
+	decodedLength = sawyercoding_reader_read_chunk(&reader, dest);
+	if (decodedLength != (int)section->decodedLength)
+		return -1;
+	return decodedLength;
+}
+
+static int save_writer_begin(save_container_writer *writer, FILE *file)
+{
+	uint8 reserved[sizeof(save_delta_header) + (SAVE_CONTAINER_MAX_SECTIONS * sizeof(save_container_section))];
+	uint32 headerSize;
+
+	writer->file = file;
+	writer->numSections = 0;
+	writer->encodeBuffer = malloc(0x600000);
+	if (writer->encodeBuffer == NULL)
+		return 0;
+
+	// Reserve room for the header and directory; they are rewritten with
+	// the real section table on finish
+	headerSize = writer->delta ? sizeof(save_delta_header) : sizeof(save_container_header);
+	memset(reserved, 0, sizeof(reserved));
+	fwrite(reserved, headerSize + (SAVE_CONTAINER_MAX_SECTIONS * sizeof(save_container_section)), 1, file);
+	return 1;
+}
+
+int save_container_writer_begin(save_container_writer *writer, FILE *file)
+{
+	writer->delta = 0;
+	writer->baseChecksum = 0;
+	return save_writer_begin(writer, file);
+}
+
+int save_delta_writer_begin(save_container_writer *writer, FILE *file, uint32 baseChecksum)
+{
+	writer->delta = 1;
+	writer->baseChecksum = baseChecksum;
+	return save_writer_begin(writer, file);
+}
+
+int save_container_writer_add(save_container_writer *writer, uint32 id, uint8 encoding, const uint8 *data, int length)
+{
+	sawyercoding_chunk_header chunkHeader;
+	save_container_section *section;
+	int encodedLength;
+
+	if (writer->numSections >= SAVE_CONTAINER_MAX_SECTIONS)
+		return 0;
+
+	chunkHeader.encoding = encoding;
+	chunkHeader.length = length;
+	encodedLength = sawyercoding_write_chunk_buffer(writer->encodeBuffer, (uint8*)data, chunkHeader);
+
+	section = &writer->sections[writer->numSections++];
+	section->id = id;
+	section->offset = (uint32)ftell(writer->file);
+	section->encodedLength = encodedLength;
+	section->decodedLength = length;
+	section->checksum = sawyercoding_calculate_checksum(writer->encodeBuffer, encodedLength);
+
+	fwrite(writer->encodeBuffer, encodedLength, 1, writer->file);
+	return 1;
+}
+
+int save_container_writer_finish(save_container_writer *writer)
+{
+	save_container_header header;
+	save_delta_header deltaHeader;
+
+	free(writer->encodeBuffer);
+	writer->encodeBuffer = NULL;
+
+	fseek(writer->file, 0, SEEK_SET);
+	if (writer->delta) {
+		deltaHeader.magic = SAVE_DELTA_MAGIC;
+		deltaHeader.numSections = writer->numSections;
+		deltaHeader.baseChecksum = writer->baseChecksum;
+		fwrite(&deltaHeader, sizeof(deltaHeader), 1, writer->file);
+	} else {
+		header.magic = SAVE_CONTAINER_MAGIC;
+		header.numSections = writer->numSections;
+		fwrite(&header, sizeof(header), 1, writer->file);
+	}
+	fwrite(writer->sections, writer->numSections * sizeof(save_container_section), 1, writer->file);
+	return 1;
+}
+
+int save_delta_is(const uint8 *data, uint32 size)
+{
+	if (size < sizeof(save_delta_header))
+		return 0;
+	return ((save_delta_header*)data)->magic == SAVE_DELTA_MAGIC;
+}
+
+uint32 save_delta_base_checksum(const uint8 *data)
+{
+	return ((save_delta_header*)data)->baseChecksum;
+}
+
+const save_container_section *save_delta_find(const uint8 *data, uint32 size, uint32 id)
+{
+	if (!save_delta_is(data, size))
+		return NULL;
+	return save_sections_find(data, size, sizeof(save_delta_header), ((save_delta_header*)data)->numSections, id);
+}
+
+// A span stream is a sequence of (offset, length, bytes) records terminated
+// by an offset of 0xFFFFFFFF. Nearby spans separated by fewer equal bytes
+// than a record header costs are merged into one record.
+#define SAVE_DELTA_SPAN_GAP 32
+#define SAVE_DELTA_TERMINATOR 0xFFFFFFFF
+
+/**
+ * Builds a span stream describing how to turn base into current. Returns the
+ * stream length, or -1 if it would not fit in destCapacity; the caller sizes
+ * the capacity to the largest delta still worth writing over a full save.
+ */
+int save_delta_build(uint8 *dest, int destCapacity, const uint8 *base, const uint8 *current, int length)
+{
+	int i = 0, out = 0, start, end, gap;
+
+	while (i < length) {
+		// Skip the unchanged run a word at a time
+		while (i + 4 <= length && *((uint32*)(base + i)) == *((uint32*)(current + i)))
+			i += 4;
+		if (i >= length || base[i] == current[i]) {
+			if (i < length)
+				i++;
+			continue;
+		}
+
+		// Extend the span until a gap of equal bytes long enough that a new
+		// record would be cheaper than carrying them
+		start = i;
+		end = i + 1;
+		gap = 0;
+		for (i++; i < length && gap < SAVE_DELTA_SPAN_GAP; i++) {
+			if (base[i] != current[i]) {
+				end = i + 1;
+				gap = 0;
+			} else {
+				gap++;
+			}
+		}
+
+		if (out + 8 + (end - start) + 4 > destCapacity)
+			return -1;
+		*((uint32*)(dest + out)) = start;
+		*((uint32*)(dest + out + 4)) = end - start;
+		memcpy(dest + out + 8, current + start, end - start);
+		out += 8 + (end - start);
+	}
+
+	if (out + 4 > destCapacity)
+		return -1;
+	*((uint32*)(dest + out)) = SAVE_DELTA_TERMINATOR;
+	return out + 4;
+}
+
+/**
+ * Applies a span stream over dest, which holds the base section's decoded
+ * bytes. Every record is bounds checked; returns 0 on a malformed stream,
+ * which may leave dest partially written.
+ */
+int save_delta_apply(const uint8 *delta, int deltaLength, uint8 *dest, int destLength)
+{
+	int pos = 0;
+	uint32 offset, length;
+
+	for (;;) {
+		if (pos + 4 > deltaLength)
+			return 0;
+		offset = *((uint32*)(delta + pos));
+		pos += 4;
+		if (offset == SAVE_DELTA_TERMINATOR)
+			return 1;
+
+		if (pos + 4 > deltaLength)
+			return 0;
+		length = *((uint32*)(delta + pos));
+		pos += 4;
+		if (length > (uint32)(deltaLength - pos))
+			return 0;
+		if (offset > (uint32)destLength || length > (uint32)destLength - offset)
+			return 0;
+
+		memcpy(dest + offset, delta + pos, length);
+		pos += length;
+	}
+}
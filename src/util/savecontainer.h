@@ -0,0 +1,98 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _SAVECONTAINER_H_
+#define _SAVECONTAINER_H_
+
+#include <stdio.h>
+#include "../common.h"
+
+// Chunked save container: a directory of independently encoded sections
+// instead of one serial chunk stream. Each section is a standard sawyer
+// chunk with its own checksum, so sections decode independently (the two
+// large ones in parallel) and tools can read just the header section for a
+// preview without touching the rest. Files keep the .sv6 extension; loaders
+// tell the formats apart by the leading magic, which can never begin a
+// classic file since chunk encoding bytes stop at CHUNK_ENCODING_ROTATE.
+#define SAVE_CONTAINER_MAGIC 0x36435253			// "SRC6"
+#define SAVE_CONTAINER_MAX_SECTIONS 8
+
+enum {
+	SAVE_SECTION_S6_HEADER,
+	SAVE_SECTION_OBJECTS,
+	SAVE_SECTION_GAME_TIME,
+	SAVE_SECTION_MAP_ELEMENTS,
+	SAVE_SECTION_GAME_DATA
+};
+
+typedef struct {
+	uint32 magic;
+	uint32 numSections;
+} save_container_header;
+
+// Delta save: the autosave path keeps the last full container it wrote in
+// memory and writes only the byte spans that changed since. A delta file
+// carries the same section directory as a container, but sections flagged
+// with SAVE_SECTION_DELTA_FLAG decode to a span stream that is applied over
+// the base container's decoded bytes rather than replacing them. The header
+// binds the delta to its base by the sum of the base's section checksums.
+#define SAVE_DELTA_MAGIC 0x36445253				// "SRD6"
+#define SAVE_SECTION_DELTA_FLAG 0x80000000
+
+typedef struct {
+	uint32 magic;
+	uint32 numSections;
+	uint32 baseChecksum;
+} save_delta_header;
+
+typedef struct {
+	uint32 id;
+	uint32 offset;
+	uint32 encodedLength;
+	uint32 decodedLength;
+	uint32 checksum;
+} save_container_section;
+
+typedef struct {
+	FILE *file;
+	save_container_section sections[SAVE_CONTAINER_MAX_SECTIONS];
+	int numSections;
+	uint8 *encodeBuffer;
+	uint8 delta;
+	uint32 baseChecksum;
+} save_container_writer;
+
+int save_container_is(const uint8 *data, uint32 size);
+const save_container_section *save_container_find(const uint8 *data, uint32 size, uint32 id);
+int save_container_decode(const uint8 *data, const save_container_section *section, uint8 *dest);
+uint32 save_container_checksum(const uint8 *data, uint32 size);
+
+int save_container_writer_begin(save_container_writer *writer, FILE *file);
+int save_container_writer_add(save_container_writer *writer, uint32 id, uint8 encoding, const uint8 *data, int length);
+int save_container_writer_finish(save_container_writer *writer);
+
+int save_delta_is(const uint8 *data, uint32 size);
+uint32 save_delta_base_checksum(const uint8 *data);
+const save_container_section *save_delta_find(const uint8 *data, uint32 size, uint32 id);
+int save_delta_build(uint8 *dest, int destCapacity, const uint8 *base, const uint8 *current, int length);
+int save_delta_apply(const uint8 *delta, int deltaLength, uint8 *dest, int destLength);
+int save_delta_writer_begin(save_container_writer *writer, FILE *file, uint32 baseChecksum);
+
+#endif
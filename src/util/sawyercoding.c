@@ -20,8 +20,14 @@
 
 #include "../addresses.h"
 #include "sawyercoding.h"
+#include "util.h"
+
+#ifdef __SSE2__
+	#include <emmintrin.h>
+#endif
 
 static int decode_chunk_rle(uint8* src_buffer, uint8* dst_buffer, int length);
+static int decode_chunk_rle_file(FILE *file, uint8 *dst_buffer, int length);
 static int decode_chunk_repeat(char *buffer, int length);
 static void decode_chunk_rotate(char *buffer, int length);
 
@@ -78,6 +84,21 @@ int sawyercoding_validate_checksum(FILE *file)
 	return checksum == fileChecksum;
 }
 
+/**
+ * Same as sawyercoding_validate_checksum, but for a file already in memory.
+ */
+int sawyercoding_validate_checksum_buffer(const uint8 *data, uint32 size)
+{
+	uint32 checksum, fileChecksum;
+
+	if (size < 8)
+		return 0;
+
+	checksum = sawyercoding_calculate_checksum((uint8*)data, size - 4);
+	fileChecksum = *((uint32*)&data[size - 4]);
+	return checksum == fileChecksum;
+}
+
 /**
  * 
  *  rct2: 0x0067685F
@@ -93,86 +114,154 @@ int sawyercoding_read_chunk(FILE *file, uint8 *buffer)
 		return -1;
 	}
 
-	uint8* src_buffer = malloc(chunkHeader.length);
-
-	// Read chunk data
-	if (fread(src_buffer, chunkHeader.length, 1, file) != 1) {
-		free(src_buffer);
+	// Decode chunk data, streaming it from the file in fixed size pieces
+	// rather than staging the whole compressed chunk in a temporary buffer
+	int decodedLength = chunkHeader.length;
+	switch (chunkHeader.encoding) {
+	case CHUNK_ENCODING_NONE:
+	case CHUNK_ENCODING_ROTATE:
+		if (chunkHeader.length != 0 && fread(buffer, chunkHeader.length, 1, file) != 1)
+			decodedLength = -1;
+		else if (chunkHeader.encoding == CHUNK_ENCODING_ROTATE)
+			decode_chunk_rotate(buffer, chunkHeader.length);
+		break;
+	case CHUNK_ENCODING_RLE:
+		decodedLength = decode_chunk_rle_file(file, buffer, chunkHeader.length);
+		break;
+	case CHUNK_ENCODING_RLECOMPRESSED:
+		decodedLength = decode_chunk_rle_file(file, buffer, chunkHeader.length);
+		if (decodedLength != -1)
+			decodedLength = decode_chunk_repeat(buffer, decodedLength);
+		break;
+	}
+	if (decodedLength == -1) {
 		RCT2_ERROR("Unable to read chunk data!");
 		return -1;
 	}
+	// Set length
+	RCT2_GLOBAL(0x009E3828, uint32) = decodedLength;
+	return decodedLength;
+}
+
+void sawyercoding_reader_init(sawyercoding_reader *reader, const uint8 *data, uint32 size)
+{
+	reader->pos = data;
+	reader->end = data + size;
+}
 
-	// Decode chunk data
+/**
+ * Copies raw bytes out of the mapping. Returns 1 on success.
+ */
+int sawyercoding_reader_read(sawyercoding_reader *reader, void *dest, uint32 length)
+{
+	if ((uint32)(reader->end - reader->pos) < length) {
+		RCT2_ERROR("Unable to read past the end of the file!");
+		return 0;
+	}
+
+	memcpy(dest, reader->pos, length);
+	reader->pos += length;
+	return 1;
+}
+
+/**
+ * Same as sawyercoding_read_chunk, but decodes straight from the memory
+ * mapped file instead of streaming the compressed data through fread.
+ */
+int sawyercoding_reader_read_chunk(sawyercoding_reader *reader, uint8 *buffer)
+{
+	sawyercoding_chunk_header chunkHeader;
+	int decodedLength;
+
+	// Read chunk header
+	if ((uint32)(reader->end - reader->pos) < sizeof(sawyercoding_chunk_header)) {
+		RCT2_ERROR("Unable to read chunk header!");
+		return -1;
+	}
+	memcpy(&chunkHeader, reader->pos, sizeof(sawyercoding_chunk_header));
+	reader->pos += sizeof(sawyercoding_chunk_header);
+
+	if ((uint32)(reader->end - reader->pos) < chunkHeader.length) {
+		RCT2_ERROR("Chunk extends past the end of the file!");
+		return -1;
+	}
+
+	// Decode chunk data directly from the mapping into the destination
+	decodedLength = chunkHeader.length;
 	switch (chunkHeader.encoding) {
 	case CHUNK_ENCODING_NONE:
-		memcpy(buffer, src_buffer, chunkHeader.length);
+		memcpy(buffer, reader->pos, chunkHeader.length);
+		break;
+	case CHUNK_ENCODING_ROTATE:
+		memcpy(buffer, reader->pos, chunkHeader.length);
+		decode_chunk_rotate(buffer, chunkHeader.length);
 		break;
 	case CHUNK_ENCODING_RLE:
-		chunkHeader.length = decode_chunk_rle(src_buffer, buffer, chunkHeader.length);
+		decodedLength = decode_chunk_rle((uint8*)reader->pos, buffer, chunkHeader.length);
 		break;
 	case CHUNK_ENCODING_RLECOMPRESSED:
-		chunkHeader.length = decode_chunk_rle(src_buffer, buffer, chunkHeader.length);
-		chunkHeader.length = decode_chunk_repeat(buffer, chunkHeader.length);
-		break;
-	case CHUNK_ENCODING_ROTATE:
-		memcpy(buffer, src_buffer, chunkHeader.length);
-		decode_chunk_rotate(buffer, chunkHeader.length);
+		decodedLength = decode_chunk_rle((uint8*)reader->pos, buffer, chunkHeader.length);
+		decodedLength = decode_chunk_repeat(buffer, decodedLength);
 		break;
 	}
-	free(src_buffer);
+	reader->pos += chunkHeader.length;
+
 	// Set length
-	RCT2_GLOBAL(0x009E3828, uint32) = chunkHeader.length;
-	return chunkHeader.length;
+	RCT2_GLOBAL(0x009E3828, uint32) = decodedLength;
+	return decodedLength;
+}
+
+/**
+ * Advances the reader past the current chunk without decoding it, so the
+ * offsets of later chunks can be scanned ahead of decoding them. Returns 1
+ * on success; the reader is left untouched when the chunk header or data
+ * would run past the end of the file.
+ */
+int sawyercoding_reader_skip_chunk(sawyercoding_reader *reader)
+{
+	sawyercoding_chunk_header chunkHeader;
+
+	if ((uint32)(reader->end - reader->pos) < sizeof(sawyercoding_chunk_header))
+		return 0;
+	memcpy(&chunkHeader, reader->pos, sizeof(sawyercoding_chunk_header));
+
+	if ((uint32)(reader->end - reader->pos - sizeof(sawyercoding_chunk_header)) < chunkHeader.length)
+		return 0;
+
+	reader->pos += sizeof(sawyercoding_chunk_header) + chunkHeader.length;
+	return 1;
 }
 
 /**
 *
 *  rct2: 0x006762E1
-* 
+*
 */
 int sawyercoding_write_chunk_buffer(uint8 *dst_file, uint8* buffer, sawyercoding_chunk_header chunkHeader){
-	uint8 *encode_buffer, *encode_buffer2;
+	uint8 *encode_buffer, *dst_data;
 
+	// Encode straight into the output buffer after the header instead of
+	// staging the encoded chunk in a temporary buffer and copying it over
+	dst_data = dst_file + sizeof(sawyercoding_chunk_header);
 	switch (chunkHeader.encoding){
 	case CHUNK_ENCODING_NONE:
-		memcpy(dst_file, &chunkHeader, sizeof(sawyercoding_chunk_header));
-		dst_file += sizeof(sawyercoding_chunk_header);
-		memcpy(dst_file, buffer, chunkHeader.length);
-		//fwrite(&chunkHeader, sizeof(sawyercoding_chunk_header), 1, file);
-		//fwrite(buffer, 1, chunkHeader.length, file);
+		memcpy(dst_data, buffer, chunkHeader.length);
 		break;
 	case CHUNK_ENCODING_RLE:
-		encode_buffer = malloc(0x600000);
-		chunkHeader.length = encode_chunk_rle(buffer, encode_buffer, chunkHeader.length);
-		memcpy(dst_file, &chunkHeader, sizeof(sawyercoding_chunk_header));
-		dst_file += sizeof(sawyercoding_chunk_header);
-		memcpy(dst_file, encode_buffer, chunkHeader.length);
-
-		free(encode_buffer);
+		chunkHeader.length = encode_chunk_rle(buffer, dst_data, chunkHeader.length);
 		break;
 	case CHUNK_ENCODING_RLECOMPRESSED:
 		encode_buffer = malloc(chunkHeader.length * 2);
-		encode_buffer2 = malloc(0x600000);
 		chunkHeader.length = encode_chunk_repeat(buffer, encode_buffer, chunkHeader.length);
-		chunkHeader.length = encode_chunk_rle(encode_buffer, encode_buffer2, chunkHeader.length);
-		memcpy(dst_file, &chunkHeader, sizeof(sawyercoding_chunk_header));
-		dst_file += sizeof(sawyercoding_chunk_header);
-		memcpy(dst_file, encode_buffer2, chunkHeader.length);
-
-		free(encode_buffer2);
+		chunkHeader.length = encode_chunk_rle(encode_buffer, dst_data, chunkHeader.length);
 		free(encode_buffer);
 		break;
 	case CHUNK_ENCODING_ROTATE:
-		encode_buffer = malloc(chunkHeader.length);
-		memcpy(encode_buffer, buffer, chunkHeader.length);
-		encode_chunk_rotate(encode_buffer, chunkHeader.length);
-		memcpy(dst_file, &chunkHeader, sizeof(sawyercoding_chunk_header));
-		dst_file += sizeof(sawyercoding_chunk_header);
-		memcpy(dst_file, encode_buffer, chunkHeader.length);
-
-		free(encode_buffer);
+		memcpy(dst_data, buffer, chunkHeader.length);
+		encode_chunk_rotate(dst_data, chunkHeader.length);
 		break;
 	}
+	memcpy(dst_file, &chunkHeader, sizeof(sawyercoding_chunk_header));
 
 	return chunkHeader.length + sizeof(sawyercoding_chunk_header);
 }
@@ -233,7 +322,7 @@ int sawyercoding_decode_td6(char *src, char *dst, int length)
  */
 static int decode_chunk_rle(uint8* src_buffer, uint8* dst_buffer, int length)
 {
-	int i, j, count;
+	int i, count;
 	uint8 *dst, rleCodeByte;
 
 	dst = dst_buffer;
@@ -243,14 +332,68 @@ static int decode_chunk_rle(uint8* src_buffer, uint8* dst_buffer, int length)
 		if (rleCodeByte & 128) {
 			i++;
 			count = 257 - rleCodeByte;
-			for (j = 0; j < count; j++)
-				*dst++ = src_buffer[i];
+			memset(dst, src_buffer[i], count);
+			dst += count;
 		} else {
-			for (j = 0; j <= rleCodeByte; j++)
-				*dst++ = src_buffer[++i];
+			count = rleCodeByte + 1;
+			memcpy(dst, src_buffer + i + 1, count);
+			dst += count;
+			i += count;
 		}
 	}
-	
+
+	// Return final size
+	return dst - dst_buffer;
+}
+
+// A literal run is at most 121 bytes plus its code byte, so as long as this
+// many bytes are buffered a whole RLE code can always be consumed.
+#define RLE_MAX_CODE_SIZE 128
+
+/**
+ * Same as decode_chunk_rle, but streams the compressed data from the file
+ * through a small window instead of requiring it all in memory at once.
+ * Returns the decoded length, or -1 if the file could not be read.
+ */
+static int decode_chunk_rle_file(FILE *file, uint8 *dst_buffer, int length)
+{
+	uint8 srcBuffer[16384];
+	uint8 *dst, rleCodeByte;
+	int i, count, bufferLength, readSize;
+
+	dst = dst_buffer;
+	bufferLength = 0;
+	i = 0;
+
+	for (;;) {
+		// Top up the window so a whole RLE code is always available
+		if (bufferLength - i < RLE_MAX_CODE_SIZE && length > 0) {
+			bufferLength -= i;
+			memmove(srcBuffer, srcBuffer + i, bufferLength);
+			i = 0;
+
+			readSize = min(length, (int)sizeof(srcBuffer) - bufferLength);
+			if (fread(srcBuffer + bufferLength, readSize, 1, file) != 1)
+				return -1;
+			bufferLength += readSize;
+			length -= readSize;
+		}
+		if (i >= bufferLength)
+			break;
+
+		rleCodeByte = srcBuffer[i++];
+		if (rleCodeByte & 128) {
+			count = 257 - rleCodeByte;
+			memset(dst, srcBuffer[i++], count);
+			dst += count;
+		} else {
+			count = rleCodeByte + 1;
+			memcpy(dst, srcBuffer + i, count);
+			dst += count;
+			i += count;
+		}
+	}
+
 	// Return final size
 	return dst - dst_buffer;
 }
@@ -304,6 +447,34 @@ static void decode_chunk_rotate(char *buffer, int length)
 
 #pragma region Encoding
 
+/**
+ * Counts how many leading bytes of src equal *src, capped at 120 and the end
+ * of the buffer.
+ */
+static int encode_chunk_rle_run_length(char *src, char *end_src)
+{
+	int count, maxCount;
+
+	maxCount = min(120, (int)(end_src - src));
+	count = 0;
+
+#ifdef __SSE2__
+	__m128i vByte = _mm_set1_epi8(*src);
+	while (count + 16 <= maxCount) {
+		__m128i v = _mm_loadu_si128((__m128i*)(src + count));
+		int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(v, vByte));
+		if (mask != 0xFFFF)
+			return count + bitscanforward(~mask & 0xFFFF);
+		count += 16;
+	}
+#endif
+	for (; count < maxCount; count++)
+		if (src[count] != *src)
+			break;
+
+	return count;
+}
+
 /**
  * Ensure dst_buffer is bigger than src_buffer then resize afterwards
  * returns length of dst_buffer
@@ -320,14 +491,13 @@ static int encode_chunk_rle(char *src_buffer, char *dst_buffer, int length)
 
 		if ((count && *src == src[1]) || count > 120){
 			*dst++ = count - 1;
-			for (; count != 0; --count){
-				*dst++ = *src_norm_start++;
-			}
+			memcpy(dst, src_norm_start, count);
+			dst += count;
+			src_norm_start += count;
+			count = 0;
 		}
 		if (*src == src[1]){
-			for (; (count < 120) && ((src + count) < end_src); count++){
-				if (*src != src[count]) break;
-			}
+			count = encode_chunk_rle_run_length(src, end_src);
 			*dst++ = 257 - count;
 			*dst++ = *src;
 			src += count;
@@ -342,9 +512,8 @@ static int encode_chunk_rle(char *src_buffer, char *dst_buffer, int length)
 	if (src == end_src - 1)count++;
 	if (count){
 		*dst++ = count - 1;
-		for (; count != 0; --count){
-			*dst++ = *src_norm_start++;
-		}
+		memcpy(dst, src_norm_start, count);
+		dst += count;
 	}
 	return dst - dst_buffer;
 }
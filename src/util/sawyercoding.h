@@ -47,9 +47,21 @@ enum {
 	FILE_TYPE_SC4 = (2 << 2)
 };
 
+// Iterator over the chunks of a memory mapped SV6/SC6 file, so that chunks
+// decode straight from the mapping into their final destinations
+typedef struct {
+	const uint8 *pos;
+	const uint8 *end;
+} sawyercoding_reader;
+
 int sawyercoding_validate_checksum(FILE *file);
+int sawyercoding_validate_checksum_buffer(const uint8 *data, uint32 size);
 uint32 sawyercoding_calculate_checksum(uint8* buffer, uint32 length);
 int sawyercoding_read_chunk(FILE *file, uint8 *buffer);
+void sawyercoding_reader_init(sawyercoding_reader *reader, const uint8 *data, uint32 size);
+int sawyercoding_reader_read(sawyercoding_reader *reader, void *dest, uint32 length);
+int sawyercoding_reader_read_chunk(sawyercoding_reader *reader, uint8 *buffer);
+int sawyercoding_reader_skip_chunk(sawyercoding_reader *reader);
 int sawyercoding_write_chunk_buffer(uint8 *dst_file, uint8* buffer, sawyercoding_chunk_header chunkHeader);
 int sawyercoding_decode_sv4(char *src, char *dst, int length);
 int sawyercoding_decode_sc4(char *src, char *dst, int length);
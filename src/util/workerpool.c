@@ -0,0 +1,405 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include <SDL.h>
+#include "workerpool.h"
+
+#define MAX_WORKER_THREADS 16
+
+// Current synchronous batch of work, guarded by _poolMutex
+static worker_pool_job_func _jobFunc;
+static void *_jobContext;
+static int _jobCount;
+static int _jobNextIndex;
+static int _jobOutstanding;
+
+// A batch of work posted asynchronously. Item claiming and the completion
+// flag are guarded by _poolMutex; the list itself is only modified on the
+// main thread (post, pump, wait, dispose), workers just read it.
+typedef struct worker_pool_async {
+	worker_pool_job_func func;
+	void *context;
+	int count;
+	int nextIndex;
+	int outstanding;
+	// Cleared once the dependency completes; NULL means ready to run
+	struct worker_pool_async *dependency;
+	worker_pool_completion_func onComplete;
+	int completed;
+	struct worker_pool_async *next;
+} worker_pool_async;
+
+static worker_pool_async *_asyncHead = NULL;
+static worker_pool_async *_asyncTail = NULL;
+
+static SDL_Thread *_threads[MAX_WORKER_THREADS];
+static int _threadCount = 0;
+static SDL_mutex *_poolMutex = NULL;
+static SDL_cond *_workAvailable = NULL;
+static SDL_cond *_workComplete = NULL;
+static bool _shuttingDown = false;
+
+static int worker_pool_thread_entry(void *unused);
+
+static void worker_pool_lock()
+{
+	if (_poolMutex != NULL)
+		SDL_LockMutex(_poolMutex);
+}
+
+static void worker_pool_unlock()
+{
+	if (_poolMutex != NULL)
+		SDL_UnlockMutex(_poolMutex);
+}
+
+static void worker_pool_async_append(worker_pool_async *job)
+{
+	if (_asyncTail == NULL) {
+		_asyncHead = _asyncTail = job;
+	} else {
+		_asyncTail->next = job;
+		_asyncTail = job;
+	}
+}
+
+static void worker_pool_async_remove(worker_pool_async *job)
+{
+	worker_pool_async **link;
+
+	for (link = &_asyncHead; *link != NULL; link = &(*link)->next) {
+		if (*link == job) {
+			*link = job->next;
+			break;
+		}
+	}
+	if (_asyncTail == job) {
+		_asyncTail = _asyncHead;
+		while (_asyncTail != NULL && _asyncTail->next != NULL)
+			_asyncTail = _asyncTail->next;
+	}
+}
+
+/**
+ * Returns the first posted batch that still has unclaimed items and whose
+ * dependency (if any) has completed. Requires _poolMutex.
+ */
+static worker_pool_async *worker_pool_async_next()
+{
+	worker_pool_async *job;
+
+	for (job = _asyncHead; job != NULL; job = job->next)
+		if (job->nextIndex < job->count && job->dependency == NULL)
+			return job;
+	return NULL;
+}
+
+/**
+ * Marks an asynchronous batch as complete and makes any batches that were
+ * waiting on it runnable. Requires _poolMutex.
+ */
+static void worker_pool_async_complete(worker_pool_async *job)
+{
+	worker_pool_async *other;
+
+	job->completed = 1;
+
+	// Dependants only need the pointer while they are waiting; clear it now
+	// so the handle can be released without leaving dangling references
+	for (other = _asyncHead; other != NULL; other = other->next)
+		if (other->dependency == job)
+			other->dependency = NULL;
+
+	if (_poolMutex != NULL) {
+		SDL_CondBroadcast(_workComplete);
+		SDL_CondBroadcast(_workAvailable);
+	}
+}
+
+void worker_pool_initialise(int numThreads)
+{
+	int i;
+
+	if (_poolMutex != NULL)
+		return;
+
+	if (numThreads <= 0)
+		numThreads = SDL_GetCPUCount() - 1;
+	numThreads = clamp(0, numThreads, MAX_WORKER_THREADS);
+
+	_poolMutex = SDL_CreateMutex();
+	_workAvailable = SDL_CreateCond();
+	_workComplete = SDL_CreateCond();
+	_shuttingDown = false;
+	_jobFunc = NULL;
+
+	_threadCount = numThreads;
+	for (i = 0; i < numThreads; i++)
+		_threads[i] = SDL_CreateThread(worker_pool_thread_entry, "OpenRCT2 worker", NULL);
+}
+
+void worker_pool_dispose()
+{
+	int i;
+
+	if (_poolMutex == NULL)
+		return;
+
+	SDL_LockMutex(_poolMutex);
+	_shuttingDown = true;
+	SDL_CondBroadcast(_workAvailable);
+	SDL_UnlockMutex(_poolMutex);
+
+	for (i = 0; i < _threadCount; i++)
+		SDL_WaitThread(_threads[i], NULL);
+	_threadCount = 0;
+
+	// The workers drain all runnable batches before exiting; deliver any
+	// outstanding completion callbacks and release handles never waited on
+	worker_pool_pump();
+	while (_asyncHead != NULL) {
+		worker_pool_async *job = _asyncHead;
+		_asyncHead = job->next;
+		free(job);
+	}
+	_asyncTail = NULL;
+
+	SDL_DestroyCond(_workComplete);
+	SDL_DestroyCond(_workAvailable);
+	SDL_DestroyMutex(_poolMutex);
+	_poolMutex = NULL;
+}
+
+int worker_pool_get_thread_count()
+{
+	return _threadCount;
+}
+
+static int worker_pool_thread_entry(void *unused)
+{
+	worker_pool_job_func func;
+	worker_pool_async *asyncJob;
+	void *context;
+	int index;
+
+	SDL_LockMutex(_poolMutex);
+	for (;;) {
+		// Synchronous batches take priority as a caller is blocked on them
+		if (_jobFunc != NULL && _jobNextIndex < _jobCount) {
+			func = _jobFunc;
+			context = _jobContext;
+			index = _jobNextIndex++;
+
+			SDL_UnlockMutex(_poolMutex);
+			func(context, index);
+			SDL_LockMutex(_poolMutex);
+
+			if (--_jobOutstanding == 0)
+				SDL_CondBroadcast(_workComplete);
+			continue;
+		}
+
+		asyncJob = worker_pool_async_next();
+		if (asyncJob != NULL) {
+			func = asyncJob->func;
+			context = asyncJob->context;
+			index = asyncJob->nextIndex++;
+
+			SDL_UnlockMutex(_poolMutex);
+			func(context, index);
+			SDL_LockMutex(_poolMutex);
+
+			if (--asyncJob->outstanding == 0)
+				worker_pool_async_complete(asyncJob);
+			continue;
+		}
+
+		if (_shuttingDown)
+			break;
+		SDL_CondWait(_workAvailable, _poolMutex);
+	}
+	SDL_UnlockMutex(_poolMutex);
+	return 0;
+}
+
+/**
+ * Runs func(context, i) for every i in [0, count) and blocks until all items
+ * have completed. The calling thread participates in the work, so this is safe
+ * to call before worker_pool_initialise (everything runs inline).
+ */
+void worker_pool_run(worker_pool_job_func func, void *context, int count)
+{
+	int i, index;
+
+	if (count <= 0)
+		return;
+
+	if (_threadCount == 0 || count == 1) {
+		for (i = 0; i < count; i++)
+			func(context, i);
+		return;
+	}
+
+	SDL_LockMutex(_poolMutex);
+	_jobFunc = func;
+	_jobContext = context;
+	_jobCount = count;
+	_jobNextIndex = 0;
+	_jobOutstanding = count;
+	SDL_CondBroadcast(_workAvailable);
+
+	// Help out with the remaining items rather than just waiting
+	while (_jobNextIndex < _jobCount) {
+		index = _jobNextIndex++;
+		SDL_UnlockMutex(_poolMutex);
+		func(context, index);
+		SDL_LockMutex(_poolMutex);
+		if (--_jobOutstanding == 0)
+			SDL_CondBroadcast(_workComplete);
+	}
+
+	while (_jobOutstanding > 0)
+		SDL_CondWait(_workComplete, _poolMutex);
+	_jobFunc = NULL;
+	SDL_UnlockMutex(_poolMutex);
+}
+
+/**
+ * Posts func(context, i) for every i in [0, count) to run on the worker
+ * threads without blocking the caller. If dependency is not NULL, no item
+ * runs until that batch has completed; the dependency handle must still be
+ * live (not yet waited on or delivered by the pump) when passed. onComplete,
+ * if given, is called from worker_pool_pump on the main thread once all
+ * items have finished, after which the handle is freed. Without worker
+ * threads everything runs inline before returning.
+ */
+worker_pool_async *worker_pool_post(worker_pool_job_func func, void *context, int count, worker_pool_async *dependency, worker_pool_completion_func onComplete)
+{
+	worker_pool_async *job;
+	int i;
+
+	job = malloc(sizeof(worker_pool_async));
+	job->func = func;
+	job->context = context;
+	job->count = max(count, 0);
+	job->nextIndex = 0;
+	job->outstanding = job->count;
+	job->dependency = NULL;
+	job->onComplete = onComplete;
+	job->completed = (job->count == 0);
+	job->next = NULL;
+
+	if (_threadCount == 0) {
+		// No workers; run inline now. Any dependency has already completed.
+		for (i = 0; i < job->count; i++)
+			func(context, i);
+		job->nextIndex = job->count;
+		job->outstanding = 0;
+		job->completed = 1;
+		worker_pool_async_append(job);
+		return job;
+	}
+
+	SDL_LockMutex(_poolMutex);
+	if (dependency != NULL && !dependency->completed && job->count > 0)
+		job->dependency = dependency;
+	worker_pool_async_append(job);
+	SDL_CondBroadcast(_workAvailable);
+	SDL_UnlockMutex(_poolMutex);
+	return job;
+}
+
+/**
+ * Non-blocking poll of a caller owned handle. Does not release it.
+ */
+int worker_pool_async_done(worker_pool_async *job)
+{
+	int done;
+
+	worker_pool_lock();
+	done = job->completed;
+	worker_pool_unlock();
+	return done;
+}
+
+/**
+ * Blocks until the batch has completed, helping with any runnable posted
+ * work in the meantime, then releases the handle. Only valid for batches
+ * posted without a completion callback.
+ */
+void worker_pool_async_wait(worker_pool_async *job)
+{
+	worker_pool_async *helpJob;
+	worker_pool_job_func func;
+	void *context;
+	int index;
+
+	worker_pool_lock();
+	while (!job->completed) {
+		helpJob = worker_pool_async_next();
+		if (helpJob != NULL) {
+			func = helpJob->func;
+			context = helpJob->context;
+			index = helpJob->nextIndex++;
+
+			SDL_UnlockMutex(_poolMutex);
+			func(context, index);
+			SDL_LockMutex(_poolMutex);
+
+			if (--helpJob->outstanding == 0)
+				worker_pool_async_complete(helpJob);
+		} else {
+			SDL_CondWait(_workComplete, _poolMutex);
+		}
+	}
+	worker_pool_async_remove(job);
+	worker_pool_unlock();
+	free(job);
+}
+
+/**
+ * Delivers completion callbacks for finished batches on the calling (main)
+ * thread and frees their handles. Called once per pass of the main loop.
+ */
+void worker_pool_pump()
+{
+	worker_pool_async *job;
+
+	// The list is only modified on this thread, so the empty check is safe
+	// without the mutex
+	if (_asyncHead == NULL)
+		return;
+
+	worker_pool_lock();
+	for (;;) {
+		for (job = _asyncHead; job != NULL; job = job->next)
+			if (job->completed && job->onComplete != NULL)
+				break;
+		if (job == NULL)
+			break;
+
+		worker_pool_async_remove(job);
+		worker_pool_unlock();
+		job->onComplete(job->context);
+		free(job);
+		worker_pool_lock();
+	}
+	worker_pool_unlock();
+}
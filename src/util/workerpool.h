@@ -0,0 +1,45 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _WORKERPOOL_H_
+#define _WORKERPOOL_H_
+
+#include "../common.h"
+
+typedef void (*worker_pool_job_func)(void *context, int index);
+typedef void (*worker_pool_completion_func)(void *context);
+
+// Handle to a batch of work posted with worker_pool_post. If the batch was
+// posted with a completion callback the pool owns the handle and frees it
+// after the callback has been delivered by worker_pool_pump; otherwise the
+// caller owns it and must release it with worker_pool_async_wait.
+typedef struct worker_pool_async worker_pool_async;
+
+void worker_pool_initialise(int numThreads);
+void worker_pool_dispose();
+int worker_pool_get_thread_count();
+void worker_pool_run(worker_pool_job_func func, void *context, int count);
+
+worker_pool_async *worker_pool_post(worker_pool_job_func func, void *context, int count, worker_pool_async *dependency, worker_pool_completion_func onComplete);
+int worker_pool_async_done(worker_pool_async *job);
+void worker_pool_async_wait(worker_pool_async *job);
+void worker_pool_pump();
+
+#endif
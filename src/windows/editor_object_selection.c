@@ -20,14 +20,17 @@
 
 #include "../addresses.h"
 #include "../audio/audio.h"
+#include "../editor.h"
 #include "../game.h"
 #include "../interface/widget.h"
 #include "../interface/window.h"
 #include "../localisation/localisation.h"
 #include "../management/research.h"
 #include "../object.h"
+#include "../object_preview.h"
 #include "../ride/track.h"
 #include "../scenario.h"
+#include "../world/scenery.h"
 #include "error.h"
 
 enum {
@@ -149,6 +152,23 @@ static int get_object_from_object_selection(uint8 object_type, int y, uint8 *obj
 static void window_editor_object_selection_manage_tracks();
 static void editor_load_selected_objects();
 
+// The selection flags list at RCT2_ADDRESS_EDITOR_OBJECT_FLAGS_LIST embeds
+// the result of the in-use scan over the whole map and ride list. The list
+// is kept across window opens and only rebuilt once an applied game command
+// could have placed or removed something, so reopening the window does not
+// repeat the scan.
+static bool _objectFlagsListValid = false;
+
+/**
+ * Forgets the object selection flags list so the in-use scan runs again the
+ * next time the object selection window opens. Called when a park is loaded
+ * and when a game command is applied.
+ */
+void editor_object_flags_invalidate()
+{
+	_objectFlagsListValid = false;
+}
+
 static rct_object_entry DefaultSelectedObjects[] = {
 	// Objects that are always required
 	{ 0x00000087, { "SCGTREES" }, 0 },		// Scenery: Trees
@@ -202,7 +222,13 @@ void window_editor_object_selection_open()
 	if (window != NULL)
 		return;
 
-	RCT2_CALLPROC_EBPSAFE(0x006AB211);
+	if (!_objectFlagsListValid) {
+		// Throw away the stale list; the setup call below allocates a new
+		// one and runs the in-use scan to fill it
+		RCT2_CALLPROC_EBPSAFE(0x6AB316);
+		RCT2_CALLPROC_EBPSAFE(0x006AB211);
+		_objectFlagsListValid = true;
+	}
 	RCT2_CALLPROC_EBPSAFE(0x006AA770);
 
 	// Not really where its called, but easy way to change default objects for now
@@ -254,8 +280,10 @@ static void window_editor_object_selection_close()
 	RCT2_CALLPROC_EBPSAFE(0x6ABB66);
 	editor_load_selected_objects();
 	reset_loaded_objects();
+	init_scenery_invalidate();
 	object_free_scenario_text();
-	RCT2_CALLPROC_EBPSAFE(0x6AB316);
+	// The selection flags list is deliberately not freed here; it is reused
+	// by the next open unless a game command invalidates it first
 	research_populate_list_random();
 	research_remove_non_separate_vehicle_types();
 	window_new_ride_init_vars();
@@ -563,9 +591,9 @@ static void window_editor_object_selection_paint()
 		if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_TRACK_DESIGNER)
 			totalSelectable = 4;
 
-		RCT2_GLOBAL(RCT2_ADDRESS_COMMON_FORMAT_ARGS + 0, uint16) = numSelected;
-		RCT2_GLOBAL(RCT2_ADDRESS_COMMON_FORMAT_ARGS + 2, uint16) = totalSelectable;
-		gfx_draw_string_left(dpi, 3164, (void*)RCT2_ADDRESS_COMMON_FORMAT_ARGS, 0, x, y);
+		uint16 numSelectedArg = numSelected, totalSelectableArg = totalSelectable;
+		format_arg fargs[] = { FORMAT_ARG(numSelectedArg), FORMAT_ARG(totalSelectableArg) };
+		gfx_draw_string_left_args(dpi, 3164, fargs, countof(fargs), 0, x, y);
 	}
 
 	rct_stex_entry* stex_entry = RCT2_GLOBAL(RCT2_ADDRESS_SCENARIO_TEXT_TEMP_CHUNK, rct_stex_entry*);
@@ -580,7 +608,7 @@ static void window_editor_object_selection_paint()
 	widget = &w->widgets[WIDX_PREVIEW];
 	x = w->x + (widget->left + widget->right) / 2 + 1;
 	y = w->y + (widget->top + widget->bottom) / 2 + 1;
-	object_paint(type, 3, type, x, y, 0, (int)dpi, (int)stex_entry);
+	object_preview_paint(highlightedEntry, type, stex_entry, dpi, x, y);
 
 	// Draw name of object
 	x = w->x + (widget->left + widget->right) / 2 + 1;
@@ -641,9 +669,10 @@ static void window_editor_object_selection_paint()
  */
 static void window_editor_object_selection_scrollpaint()
 {
-	int x, y, i, colour, colour2, numObjects, type;
+	int x, y, i, colour, colour2, numObjects;
 	short scrollIndex;
 	rct_object_entry *entry;
+	rct_object_name_index_entry *nameIndex;
 	rct_window *w;
 	rct_drawpixelinfo *dpi;
 	uint8 *itemFlags;
@@ -654,13 +683,19 @@ static void window_editor_object_selection_scrollpaint()
 	colour = (colour << 24) | (colour << 16) | (colour << 8) | colour;
 	gfx_clear(dpi, colour);
 
-	numObjects = RCT2_GLOBAL(RCT2_ADDRESS_OBJECT_LIST_NO_ITEMS, sint32);
-	entry = RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, rct_object_entry*);
-	itemFlags = RCT2_GLOBAL(0x009ADAEC, uint8*);
+	// Only the objects of the selected tab's type are drawn, so iterate that
+	// type's partition of the name index instead of the whole installed list
+	numObjects = object_name_index_get(w->selected_tab, &nameIndex);
 	y = 0;
 	for (i = 0; i < numObjects; i++) {
-		type = entry->flags & 0x0F;
-		if (type == w->selected_tab && !(*itemFlags & 0x20)) {
+		entry = nameIndex[i].entry;
+		itemFlags = RCT2_GLOBAL(0x009ADAEC, uint8*) + nameIndex[i].flagsIndex;
+		if (!(*itemFlags & 0x20)) {
+			// Rows are drawn top to bottom, so nothing below the clip region
+			// can be visible
+			if (y > dpi->y + dpi->height)
+				break;
+
 			if (y + 12 >= dpi->y && y <= dpi->y + dpi->height) {
 				// Draw checkbox
 				if (!(RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_TRACK_MANAGER) && !(*itemFlags & 0x20))
@@ -707,9 +742,6 @@ static void window_editor_object_selection_scrollpaint()
 			}
 			y += 12;
 		}
-
-		entry = object_get_next(entry);
-		itemFlags++;
 	}
 }
 
@@ -768,21 +800,18 @@ static int window_editor_object_selection_select_object(int flags, rct_object_en
  */
 static int get_object_from_object_selection(uint8 object_type, int y, uint8 *object_selection_flags, rct_object_entry **installed_entry)
 {
-	*installed_entry = RCT2_GLOBAL(RCT2_ADDRESS_INSTALLED_OBJECT_LIST, rct_object_entry*);
+	rct_object_name_index_entry *nameIndex;
 	uint8* selection_flags = RCT2_GLOBAL(RCT2_ADDRESS_EDITOR_OBJECT_FLAGS_LIST, uint8*);
+	int numObjects = object_name_index_get(object_type, &nameIndex);
 	int object_count = 0;
-	for (int i = RCT2_GLOBAL(RCT2_ADDRESS_OBJECT_LIST_NO_ITEMS, uint32); i > 0; --i){
-		if (((*installed_entry)->flags & 0xF) == object_type){
-			if (!(*selection_flags & 0x20)){
-				y -= 12;
-				*object_selection_flags = *selection_flags;
-				if (y < 0)return object_count;
-				object_count++;
-			}
+	for (int i = 0; i < numObjects; i++){
+		*installed_entry = nameIndex[i].entry;
+		if (!(selection_flags[nameIndex[i].flagsIndex] & 0x20)){
+			y -= 12;
+			*object_selection_flags = selection_flags[nameIndex[i].flagsIndex];
+			if (y < 0)return object_count;
+			object_count++;
 		}
-
-		*installed_entry = object_get_next(*installed_entry);
-		selection_flags++;
 	}
 	return -1;
 }
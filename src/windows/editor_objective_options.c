@@ -20,6 +20,7 @@
 
 #include "../addresses.h"
 #include "../game.h"
+#include "../game_state.h"
 #include "../localisation/date.h"
 #include "../localisation/localisation.h"
 #include "../interface/widget.h"
@@ -740,6 +741,7 @@ static void window_editor_objective_options_main_dropdown()
 	case WIDX_CLIMATE_DROPDOWN:
 		if (RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE, uint8) != (uint8)dropdownIndex) {
 			RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE, uint8) = (uint8)dropdownIndex;
+			gGameState.climate.current_climate = (uint8)dropdownIndex;
 			window_invalidate(w);
 		}
 		break;
@@ -829,7 +829,7 @@ static void window_finances_financial_graph_paint()
 {
 	rct_window *w;
 	rct_drawpixelinfo *dpi;
-	int i, x, y, graphLeft, graphTop, graphRight, graphBottom;
+	int x, y, graphLeft, graphTop, graphRight, graphBottom;
 
 	window_paint_get_registers(w, dpi);
 
@@ -861,20 +861,8 @@ static void window_finances_financial_graph_paint()
 	gfx_fill_rect_inset(dpi, graphLeft, graphTop, graphRight, graphBottom, w->colours[1], 0x30);
 
 	// Calculate the Y axis scale (log2 of highest [+/-]balance)
-	int yAxisScale = 0;
 	money32 *balanceHistory = RCT2_ADDRESS(RCT2_ADDRESS_BALANCE_HISTORY, money32);
-	for (i = 0; i < 64; i++) {
-		money32 balance = balanceHistory[i];
-		if (balance == MONEY32_UNDEFINED)
-			continue;
-
-		// Modifier balance then keep halfing until less than 127 pixels
-		balance = abs(balance) >> yAxisScale;
-		while (balance > 127) {
-			balance /= 2;
-			yAxisScale++;
-		}
-	}
+	int yAxisScale = graph_get_money32_y_axis_scale(balanceHistory, 64, 127);
 
 	// Y axis labels
 	x = graphLeft + 18;
@@ -951,7 +939,7 @@ static void window_finances_park_value_graph_paint()
 {
 	rct_window *w;
 	rct_drawpixelinfo *dpi;
-	int i, x, y, graphLeft, graphTop, graphRight, graphBottom;
+	int x, y, graphLeft, graphTop, graphRight, graphBottom;
 
 	window_paint_get_registers(w, dpi);
 
@@ -979,20 +967,8 @@ static void window_finances_park_value_graph_paint()
 	gfx_fill_rect_inset(dpi, graphLeft, graphTop, graphRight, graphBottom, w->colours[1], 0x30);
 
 	// Calculate the Y axis scale (log2 of highest [+/-]balance)
-	int yAxisScale = 0;
 	money32 *parkValueHistory = RCT2_ADDRESS(RCT2_ADDRESS_PARK_VALUE_HISTORY, money32);
-	for (i = 0; i < 64; i++) {
-		money32 balance = parkValueHistory[i];
-		if (balance == MONEY32_UNDEFINED)
-			continue;
-
-		// Modifier balance then keep halfing until less than 255 pixels
-		balance = abs(balance) >> yAxisScale;
-		while (balance > 255) {
-			balance /= 2;
-			yAxisScale++;
-		}
-	}
+	int yAxisScale = graph_get_money32_y_axis_scale(parkValueHistory, 64, 255);
 
 	// Y axis labels
 	x = graphLeft + 18;
@@ -1069,7 +1045,7 @@ static void window_finances_profit_graph_paint()
 {
 	rct_window *w;
 	rct_drawpixelinfo *dpi;
-	int i, x, y, graphLeft, graphTop, graphRight, graphBottom;
+	int x, y, graphLeft, graphTop, graphRight, graphBottom;
 
 	window_paint_get_registers(w, dpi);
 
@@ -1097,20 +1073,8 @@ static void window_finances_profit_graph_paint()
 	gfx_fill_rect_inset(dpi, graphLeft, graphTop, graphRight, graphBottom, w->colours[1], 0x30);
 
 	// Calculate the Y axis scale (log2 of highest [+/-]balance)
-	int yAxisScale = 0;
 	money32 *weeklyProfitHistory = RCT2_ADDRESS(RCT2_ADDRESS_WEEKLY_PROFIT_HISTORY, money32);
-	for (i = 0; i < 64; i++) {
-		money32 balance = weeklyProfitHistory[i];
-		if (balance == MONEY32_UNDEFINED)
-			continue;
-
-		// Modifier balance then keep halfing until less than 127 pixels
-		balance = abs(balance) >> yAxisScale;
-		while (balance > 127) {
-			balance /= 2;
-			yAxisScale++;
-		}
-	}
+	int yAxisScale = graph_get_money32_y_axis_scale(weeklyProfitHistory, 64, 127);
 
 	// Y axis labels
 	x = graphLeft + 18;
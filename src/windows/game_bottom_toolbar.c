@@ -80,6 +80,28 @@ static void window_game_bottom_toolbar_update(rct_window* w);
 static void window_game_bottom_toolbar_cursor();
 static void window_game_bottom_toolbar_unknown05();
 
+// Memoized formatted output for the values the toolbar redraws every frame.
+// Cash, guest count, date and temperature change at most once per tick, so
+// when the format and arguments match the previous paint the stored text is
+// drawn directly instead of running the format interpreter again.
+typedef struct {
+	rct_string_id format;
+	uint8 args[8];
+	uint16 generation;
+	sint16 width;
+	char buffer[64];
+} memoized_string;
+
+enum {
+	MEMOIZED_STRING_MONEY,
+	MEMOIZED_STRING_GUESTS,
+	MEMOIZED_STRING_DATE,
+	MEMOIZED_STRING_TEMPERATURE,
+	MEMOIZED_STRING_COUNT
+};
+
+static memoized_string _memoizedStrings[MEMOIZED_STRING_COUNT];
+
 static void window_game_bottom_toolbar_draw_left_panel(rct_drawpixelinfo *dpi, rct_window *w);
 static void window_game_bottom_toolbar_draw_park_rating(rct_drawpixelinfo *dpi, rct_window *w, int colour, int x, int y, uint8 factor);
 static void window_game_bottom_toolbar_draw_right_panel(rct_drawpixelinfo *dpi, rct_window *w);
@@ -118,6 +140,38 @@ static void* window_game_bottom_toolbar_events[] = {
 	window_game_bottom_toolbar_emptysub
 };
 
+static memoized_string *window_game_bottom_toolbar_memoize_string(int index, rct_string_id format, void *args, int argsSize)
+{
+	memoized_string *ms = &_memoizedStrings[index];
+	uint16 generation = format_string_cache_generation();
+
+	if (ms->format != format || ms->generation != generation || memcmp(ms->args, args, argsSize) != 0) {
+		ms->format = format;
+		ms->generation = generation;
+		memcpy(ms->args, args, argsSize);
+		format_string(ms->buffer, format, args);
+		RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_FONT_SPRITE_BASE, uint16) = 0xE0;
+		ms->width = gfx_get_string_width(ms->buffer);
+	}
+	return ms;
+}
+
+static void window_game_bottom_toolbar_draw_string_centred_memoized(rct_drawpixelinfo *dpi, int index, rct_string_id format, int x, int y, int colour, void *args, int argsSize)
+{
+	memoized_string *ms = window_game_bottom_toolbar_memoize_string(index, format, args, argsSize);
+
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_FONT_SPRITE_BASE, uint16) = 0xE0;
+	gfx_draw_string(dpi, ms->buffer, colour, x - ms->width / 2, y);
+}
+
+static void window_game_bottom_toolbar_draw_string_left_memoized(rct_drawpixelinfo *dpi, int index, rct_string_id format, int x, int y, int colour, void *args, int argsSize)
+{
+	memoized_string *ms = window_game_bottom_toolbar_memoize_string(index, format, args, argsSize);
+
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_FONT_SPRITE_BASE, uint16) = 0xE0;
+	gfx_draw_string(dpi, ms->buffer, colour, x, y);
+}
+
 /**
  * Creates the main game bottom toolbar window.
  *  rct2: 0x0066B52F (part of 0x0066B3E8)
@@ -409,23 +463,27 @@ static void window_game_bottom_toolbar_draw_left_panel(rct_drawpixelinfo *dpi, r
 	// Draw money
 	if (!(RCT2_GLOBAL(RCT2_ADDRESS_PARK_FLAGS, uint32) & PARK_FLAGS_NO_MONEY)) {
 		RCT2_GLOBAL(0x013CE952, int) = DECRYPT_MONEY(RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_MONEY_ENCRYPTED, sint32));
-		gfx_draw_string_centred(
+		window_game_bottom_toolbar_draw_string_centred_memoized(
 			dpi,
+			MEMOIZED_STRING_MONEY,
 			(RCT2_GLOBAL(0x013CE952, int) < 0 ? 1391 : 1390),
 			x, y - 3,
 			(RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_OVER_WINDOWCLASS, rct_windowclass) == 2 && RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_OVER_WIDGETINDEX, sint32) == WIDX_MONEY ? 2 : w->colours[0] & 0x7F),
-			(void*)0x013CE952
+			(void*)0x013CE952,
+			sizeof(money32)
 			);
 		y += 7;
 	}
 
 	// Draw guests
-	gfx_draw_string_centred(
+	window_game_bottom_toolbar_draw_string_centred_memoized(
 		dpi,
+		MEMOIZED_STRING_GUESTS,
 		STR_NUM_GUESTS + RCT2_GLOBAL(0x013573FE, uint8),
 		x, y,
 		(RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_OVER_WINDOWCLASS, rct_windowclass) == 2 && RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_OVER_WIDGETINDEX, sint32) == WIDX_GUESTS ? 2 : w->colours[0] & 0x7F),
-		(void*)RCT2_ADDRESS_GUESTS_IN_PARK
+		(void*)RCT2_ADDRESS_GUESTS_IN_PARK,
+		sizeof(uint16)
 	);
 
 	// Draw park rating
@@ -485,13 +543,15 @@ static void window_game_bottom_toolbar_draw_right_panel(rct_drawpixelinfo *dpi,
 	RCT2_GLOBAL(0x013CE952, short) = STR_DATE_DAY_1 + day;
 	RCT2_GLOBAL(0x013CE954, short) = month;
 	RCT2_GLOBAL(0x013CE956, short) = year;
-	gfx_draw_string_centred(
+	window_game_bottom_toolbar_draw_string_centred_memoized(
 		dpi,
+		MEMOIZED_STRING_DATE,
 		2737,
 		x,
 		y,
 		(RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_OVER_WINDOWCLASS, rct_windowclass) == 2 && RCT2_GLOBAL(RCT2_ADDRESS_CURSOR_OVER_WIDGETINDEX, sint32) == WIDX_DATE ? 2 : w->colours[0] & 0x7F),
-		(void*)0x013CE952
+		(void*)0x013CE952,
+		3 * sizeof(short)
 	);
 
 	// Temperature
@@ -505,7 +565,7 @@ static void window_game_bottom_toolbar_draw_right_panel(rct_drawpixelinfo *dpi,
 		format = STR_FAHRENHEIT_VALUE;
 	}
 	RCT2_GLOBAL(0x013CE952, short) = temperature;
-	gfx_draw_string_left(dpi, format, (void*)0x013CE952, 0, x, y + 6);
+	window_game_bottom_toolbar_draw_string_left_memoized(dpi, MEMOIZED_STRING_TEMPERATURE, format, x, y + 6, 0, (void*)0x013CE952, sizeof(short));
 	x += 30;
 
 	// Current weather
@@ -605,8 +665,6 @@ static void window_game_bottom_toolbar_draw_news_item(rct_drawpixelinfo *dpi, rc
 
 			gfx_draw_sprite(cliped_dpi, image_id_base, clip_x, clip_y, 0);
 		}
-
-		rct2_free(cliped_dpi);
 		break;
 	case NEWS_ITEM_MONEY:
 		gfx_draw_sprite(dpi, SPR_FINANCE, x, y, 0);
@@ -854,8 +854,6 @@ void window_guest_overview_tab_paint(rct_window* w, rct_drawpixelinfo* dpi){
 		ebx |= (peep->hat_colour << 19) | 0x20000000;
 		gfx_draw_sprite( clip_dpi, ebx, x, y, 0);
 	}
-
-	rct2_free(clip_dpi);
 }
 
 /* rct2: 0x69869b */
@@ -952,6 +950,17 @@ void window_guest_inventory_tab_paint(rct_window* w, rct_drawpixelinfo* dpi){
 }
 
 /* rct2: 0x696887 */
+// Cached formatted overview strings. The window repaints every tick while
+// following its guest, but the action and thought text only change
+// occasionally, so the formatted output is kept and only regenerated when
+// the argument words (which encode the source action or thought) change.
+static uint16 _guestActionPeepNumber = 0xFFFF;
+static uint32 _guestActionArgs[2];
+static char _guestActionText[256];
+static uint16 _guestThoughtPeepNumber = 0xFFFF;
+static uint32 _guestThoughtArgs[2];
+static char _guestThoughtText[256];
+
 void window_guest_overview_paint(){
 	rct_window *w;
 	rct_drawpixelinfo *dpi;
@@ -979,13 +988,25 @@ void window_guest_overview_paint(){
 	uint32 argument1, argument2;
 	rct_peep* peep = GET_PEEP(w->number);
 	get_arguments_from_action(peep, &argument1, &argument2);
-	RCT2_GLOBAL(0x13CE952, uint32) = argument1;
-	RCT2_GLOBAL(0x13CE952 + 4, uint32) = argument2;
+	if (w->number != _guestActionPeepNumber || argument1 != _guestActionArgs[0] || argument2 != _guestActionArgs[1]) {
+		_guestActionPeepNumber = w->number;
+		_guestActionArgs[0] = argument1;
+		_guestActionArgs[1] = argument2;
+		RCT2_GLOBAL(0x13CE952, uint32) = argument1;
+		RCT2_GLOBAL(0x13CE952 + 4, uint32) = argument2;
+		format_string(_guestActionText, 1191, (void*)0x13CE952);
+	}
 	rct_widget* widget = &w->widgets[WIDX_ACTION_LBL];
 	int x = (widget->left + widget->right) / 2 + w->x;
 	int y = w->y + widget->top - 1;
 	int width = widget->right - widget->left;
-	gfx_draw_string_centred_clipped(dpi, 1191, (void*)0x13CE952, 0, x, y, width);
+
+	// Clipping truncates in place, so it works on a scratch copy
+	char *buffer = RCT2_ADDRESS(RCT2_ADDRESS_COMMON_STRING_FORMAT_BUFFER, char);
+	strcpy(buffer, _guestActionText);
+	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_FONT_SPRITE_BASE, uint16) = 0xE0;
+	int text_width = gfx_clip_string(buffer, width);
+	gfx_draw_string(dpi, buffer, 0, x - (text_width - 1) / 2, y);
 
 	// Draw the marquee thought
 	widget = &w->widgets[WIDX_MARQUEE];
@@ -1012,15 +1033,18 @@ void window_guest_overview_paint(){
 	}
 
 	get_arguments_from_thought(peep->thoughts[i], &argument1, &argument2);
-
-	RCT2_GLOBAL(0x13CE952, uint32) = argument1;
-	RCT2_GLOBAL(0x13CE952 + 4, uint32) = argument2;
-	RCT2_GLOBAL(0x13CE952 + 8, uint16) = 0;
+	if (w->number != _guestThoughtPeepNumber || argument1 != _guestThoughtArgs[0] || argument2 != _guestThoughtArgs[1]) {
+		_guestThoughtPeepNumber = w->number;
+		_guestThoughtArgs[0] = argument1;
+		_guestThoughtArgs[1] = argument2;
+		RCT2_GLOBAL(0x13CE952, uint32) = argument1;
+		RCT2_GLOBAL(0x13CE952 + 4, uint32) = argument2;
+		RCT2_GLOBAL(0x13CE952 + 8, uint16) = 0;
+		format_string(_guestThoughtText, 1193, (void*)0x13CE952);
+	}
 
 	x = widget->right - widget->left - w->list_information_type;
-	gfx_draw_string_left(dpi_marquee, 1193, (void*)0x13CE952, 0, x, 0);
-
-	rct2_free(dpi_marquee);
+	gfx_draw_string(dpi_marquee, _guestThoughtText, 0, x, 0);
 }
 
 /* rct2: 0x696749*/
@@ -1087,8 +1111,29 @@ void window_guest_overview_update(rct_window* w){
 	w->var_494 |= var_496 << 16;
 
 	widget_invalidate(w, WIDX_TAB_1);
-	widget_invalidate(w, WIDX_TAB_2);
-	
+
+	// The stats tab face only animates while that page is open; here it can
+	// only change with the guest's mood, so refreshing it every fourth tick
+	// is enough
+	if (!(w->var_494 & 3))
+		widget_invalidate(w, WIDX_TAB_2);
+
+	// Redraw the action label when the action changed, and keep the marquee
+	// scrolling while there is a fresh thought to show; both would otherwise
+	// only refresh with a full window invalidation
+	rct_peep* peep = GET_PEEP(w->number);
+	uint32 argument1, argument2;
+	get_arguments_from_action(peep, &argument1, &argument2);
+	if (w->number != _guestActionPeepNumber || argument1 != _guestActionArgs[0] || argument2 != _guestActionArgs[1])
+		widget_invalidate(w, WIDX_ACTION_LBL);
+
+	for (int i = 0; i < PEEP_MAX_THOUGHTS && peep->thoughts[i].type != PEEP_THOUGHT_TYPE_NONE; i++) {
+		if (peep->thoughts[i].var_2 == 1) {
+			widget_invalidate(w, WIDX_MARQUEE);
+			break;
+		}
+	}
+
 	w->list_information_type += 2;
 
 	if ((w->var_494 & 0xFFFF) == 0xFFFF)
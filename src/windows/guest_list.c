@@ -128,11 +128,50 @@ static uint32 _window_guest_list_groups_argument_1[240];
 static uint32 _window_guest_list_groups_argument_2[240];
 static uint8 _window_guest_list_groups_guest_faces[240 * 58];
 
+// Cached index of the guests currently in the park, in sprite list order.
+// Peep state changes mark it dirty and it is rebuilt the next time the
+// window needs it, so scrolling and repainting no longer rescan every guest.
+// Filtered views still scan directly; filter membership depends on actions
+// and thoughts, which change without any state event.
+static uint16 _window_guest_list_index[MAX_SPRITES];
+static int _window_guest_list_index_count = 0;
+static uint16 _window_guest_list_index_park_count = 0;
+static bool _window_guest_list_index_dirty = true;
+
 static int window_guest_list_is_peep_in_filter(rct_peep* peep);
 static void window_guest_list_find_groups();
 
 static void get_arguments_from_peep(rct_peep *peep, uint32 *argument_1, uint32* argument_2);
 
+/**
+ * Called whenever a peep state change may have altered the guest list.
+ */
+void window_guest_list_mark_dirty()
+{
+	_window_guest_list_index_dirty = true;
+}
+
+static void window_guest_list_refresh_index()
+{
+	int spriteIndex;
+	rct_peep *peep;
+
+	// Guests can also spawn or leave in code paths that send no
+	// notification, so compare against the park's guest count too
+	if (!_window_guest_list_index_dirty && _window_guest_list_index_park_count == RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16))
+		return;
+
+	_window_guest_list_index_dirty = false;
+	_window_guest_list_index_park_count = RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16);
+	_window_guest_list_index_count = 0;
+	FOR_ALL_GUESTS(spriteIndex, peep) {
+		peep->var_0C &= ~0x200;
+		if (peep->var_2A != 0)
+			continue;
+		_window_guest_list_index[_window_guest_list_index_count++] = spriteIndex;
+	}
+}
+
 /**
  * 
  *  rct2: 0x006992E3
@@ -328,6 +367,8 @@ static void window_guest_list_mousedown(int widgetIndex, rct_window*w, rct_widge
 		window_guest_list_widgets[WIDX_PAGE_DROPDOWN_BUTTON].type = WWT_EMPTY;
 		w->list_information_type = 0;
 		_window_guest_list_selected_filter = -1;
+		// Rebuild the index so flashing flags left by a filtered view are cleared
+		window_guest_list_mark_dirty();
 		window_invalidate(w);
 		w->scrolls[0].v_top = 0;
 		break;
@@ -429,15 +470,18 @@ static void window_guest_list_scrollgetsize()
 	switch (_window_guest_list_selected_tab) {
 	case PAGE_INDIVIDUAL:
 		// Count the number of guests
-		numGuests = 0;
-
-		FOR_ALL_GUESTS(spriteIndex, peep) {
-			if (peep->var_2A != 0)
-				continue;
-			if (_window_guest_list_selected_filter != -1)
+		if (_window_guest_list_selected_filter == -1) {
+			window_guest_list_refresh_index();
+			numGuests = _window_guest_list_index_count;
+		} else {
+			numGuests = 0;
+			FOR_ALL_GUESTS(spriteIndex, peep) {
+				if (peep->var_2A != 0)
+					continue;
 				if (window_guest_list_is_peep_in_filter(peep))
 					continue;
-			numGuests++;
+				numGuests++;
+			}
 		}
 		w->var_492 = numGuests;
 		y = numGuests * 10;
@@ -502,17 +546,24 @@ static void window_guest_list_scrollmousedown()
 	case PAGE_INDIVIDUAL:
 		i = y / 10;
 		i += _window_guest_list_selected_page * 3173;
+		if (_window_guest_list_selected_filter == -1) {
+			window_guest_list_refresh_index();
+			if (i < _window_guest_list_index_count) {
+				// Open guest window
+				window_guest_open(GET_PEEP(_window_guest_list_index[i]));
+			}
+			break;
+		}
 		FOR_ALL_GUESTS(spriteIndex, peep) {
 			if (peep->var_2A != 0)
 				continue;
-			if (_window_guest_list_selected_filter != -1)
-				if (window_guest_list_is_peep_in_filter(peep))
-					continue;
+			if (window_guest_list_is_peep_in_filter(peep))
+				continue;
 
 			if (i == 0) {
 				// Open guest window
 				window_guest_open(peep);
-				
+
 				break;
 			} else {
 				i--;
@@ -655,7 +706,67 @@ static void window_guest_list_paint()
 }
 
 /**
- * 
+ * Draws a single guest row on the individual tab.
+ */
+static void window_guest_list_scrollpaint_guest(rct_drawpixelinfo *dpi, rct_peep *peep, int i, int y)
+{
+	int format, j;
+	rct_peep_thought *thought;
+	uint32 argument_1, argument_2;
+
+	// Highlight backcolour and text colour (format)
+	format = 1191;
+	if (i == _window_guest_list_highlighted_index) {
+		gfx_fill_rect(dpi, 0, y, 800, y + 9, 0x02000031);
+		format = 1193;
+	}
+
+	// Guest name
+	RCT2_GLOBAL(0x013CE952, uint16) = peep->name_string_idx;
+	RCT2_GLOBAL(0x013CE954, uint32) = peep->id;
+	gfx_draw_string_left_clipped(dpi, format, (void*)0x013CE952, 0, 0, y - 1, 113);
+
+	switch (_window_guest_list_selected_view) {
+	case VIEW_ACTIONS:
+		// Guest face
+		gfx_draw_sprite(dpi, get_peep_face_sprite_small(peep), 118, y, 0);
+
+		// Tracking icon
+		if (peep->flags & PEEP_FLAGS_TRACKING)
+			gfx_draw_sprite(dpi, 5129, 112, y, 0);
+
+		// Action
+
+		get_arguments_from_action(peep, &argument_1, &argument_2);
+
+		RCT2_GLOBAL(0x013CE952, uint32) = argument_1;
+		RCT2_GLOBAL(0x013CE952 + 4, uint32) = argument_2;
+		gfx_draw_string_left_clipped(dpi, format, (void*)0x013CE952, 0, 133, y - 1, 314);
+		break;
+	case VIEW_THOUGHTS:
+		// For each thought
+		for (j = 0; j < PEEP_MAX_THOUGHTS; j++) {
+			thought = &peep->thoughts[j];
+			if (thought->type == PEEP_THOUGHT_TYPE_NONE)
+				break;
+			if (thought->var_2 == 0)
+				continue;
+			if (thought->var_2 > 5)
+				break;
+
+			get_arguments_from_thought(peep->thoughts[j], &argument_1, &argument_2);
+
+			RCT2_GLOBAL(0x013CE952, uint32) = argument_1;
+			RCT2_GLOBAL(0x013CE952 + 4, uint32) = argument_2;
+			gfx_draw_string_left_clipped(dpi, format, (void*)0x013CE952, 0, 118, y - 1, 329);
+			break;
+		}
+		break;
+	}
+}
+
+/**
+ *
  *  rct2: 0x00699701
  */
 static void window_guest_list_scrollpaint()
@@ -664,8 +775,6 @@ static void window_guest_list_scrollpaint()
 	rct_window *w;
 	rct_drawpixelinfo *dpi;
 	rct_peep *peep;
-	rct_peep_thought *thought;
-	uint32 argument_1, argument_2;
 
 	window_paint_get_registers(w, dpi);
 
@@ -674,76 +783,46 @@ static void window_guest_list_scrollpaint()
 
 	switch (_window_guest_list_selected_tab) {
 	case PAGE_INDIVIDUAL:
-		i = 0;
 		y = _window_guest_list_selected_page * -0x7BF2;
 
+		if (_window_guest_list_selected_filter == -1) {
+			window_guest_list_refresh_index();
+
+			// Skip straight to the first row that can intersect the clip area
+			i = 0;
+			if (dpi->y - 11 > y) {
+				i = (dpi->y - 11 - y) / 10;
+				y += i * 10;
+			}
+			for (; i < _window_guest_list_index_count; i++, y += 10) {
+				// Check if y is beyond the scroll control
+				if (y > dpi->y + dpi->height)
+					break;
+
+				window_guest_list_scrollpaint_guest(dpi, GET_PEEP(_window_guest_list_index[i]), i, y);
+			}
+			break;
+		}
+
+		i = 0;
+
 		// For each guest
 		FOR_ALL_GUESTS(spriteIndex, peep) {
 			peep->var_0C &= ~0x200;
 			if (peep->var_2A != 0)
 				continue;
-			if (_window_guest_list_selected_filter != -1) {
-				if (window_guest_list_is_peep_in_filter(peep))
-					continue;
-				RCT2_GLOBAL(RCT2_ADDRESS_WINDOW_MAP_FLASHING_FLAGS, uint16) |= (1 << 0);
-				peep->var_0C |= 0x200;
-			}
+			if (window_guest_list_is_peep_in_filter(peep))
+				continue;
+			RCT2_GLOBAL(RCT2_ADDRESS_WINDOW_MAP_FLASHING_FLAGS, uint16) |= (1 << 0);
+			peep->var_0C |= 0x200;
 
-			// 
+			//
 			if (y + 11 >= -0x7FFF && y + 11 > dpi->y && y < 0x7FFF) {
 				// Check if y is beyond the scroll control
 				if (y > dpi->y + dpi->height)
 					break;
 
-				// Highlight backcolour and text colour (format)
-				format = 1191;
-				if (i == _window_guest_list_highlighted_index) {
-					gfx_fill_rect(dpi, 0, y, 800, y + 9, 0x02000031);
-					format = 1193;
-				}
-
-				// Guest name
-				RCT2_GLOBAL(0x013CE952, uint16) = peep->name_string_idx;
-				RCT2_GLOBAL(0x013CE954, uint32) = peep->id;
-				gfx_draw_string_left_clipped(dpi, format, (void*)0x013CE952, 0, 0, y - 1, 113);
-
-				switch (_window_guest_list_selected_view) {
-				case VIEW_ACTIONS:
-					// Guest face
-					gfx_draw_sprite(dpi, get_peep_face_sprite_small(peep), 118, y, 0);
-
-					// Tracking icon
-					if (peep->flags & PEEP_FLAGS_TRACKING)
-						gfx_draw_sprite(dpi, 5129, 112, y, 0);
-					
-					// Action
-					
-					get_arguments_from_action(peep, &argument_1, &argument_2);
-
-					RCT2_GLOBAL(0x013CE952, uint32) = argument_1;
-					RCT2_GLOBAL(0x013CE952 + 4, uint32) = argument_2;
-					gfx_draw_string_left_clipped(dpi, format, (void*)0x013CE952, 0, 133, y - 1, 314);
-					break;
-				case VIEW_THOUGHTS:
-					// For each thought
-					for (j = 0; j < PEEP_MAX_THOUGHTS; j++) {
-						thought = &peep->thoughts[j];
-						if (thought->type == PEEP_THOUGHT_TYPE_NONE)
-							break;
-						if (thought->var_2 == 0)
-							continue;
-						if (thought->var_2 > 5)
-							break;
-						
-						get_arguments_from_thought(peep->thoughts[j], &argument_1, &argument_2);
-
-						RCT2_GLOBAL(0x013CE952, uint32) = argument_1;
-						RCT2_GLOBAL(0x013CE952 + 4, uint32) = argument_2;
-						gfx_draw_string_left_clipped(dpi, format, (void*)0x013CE952, 0, 118, y - 1, 329);
-						break;
-					}
-					break;
-				}
+				window_guest_list_scrollpaint_guest(dpi, peep, i, y);
 			}
 
 			// Increment list item index and y
@@ -114,7 +114,7 @@ void window_install_track_open(const char* path)
 	};
 	_window_install_track_item = item;
 
-	mem = malloc(1285292);
+	mem = malloc(TRACK_DESIGN_CACHE_SIZE * sizeof(rct_track_design));
 	if (mem == NULL)
 		return;
 
@@ -27,11 +27,14 @@
 #include "../localisation/localisation.h"
 #include "../scenario.h"
 #include "../title.h"
+#include "../util/savecontainer.h"
+#include "../util/sawyercoding.h"
 #include "../windows/error.h"
+#include "../world/map.h"
 
 #pragma region Widgets
 
-#define WW 340
+#define WW 500
 #define WH 400
 
 enum {
@@ -47,7 +50,7 @@ static rct_widget window_loadsave_widgets[] = {
 	{ WWT_FRAME,		0,		0,			WW - 1,			0,			WH - 1,		STR_NONE,			STR_NONE },
 	{ WWT_CAPTION,		0,		1,			WW - 2,			1,			14,			STR_NONE,			STR_WINDOW_TITLE_TIP },
 	{ WWT_CLOSEBOX,		0,		WW - 13,	WW - 3,			2,			13,			STR_CLOSE_X,		STR_CLOSE_WINDOW_TIP },
-	{ WWT_SCROLL,		0,		4,			WW - 5,			36,			WH - 40,	2,					STR_NONE },
+	{ WWT_SCROLL,		0,		4,			334,			36,			WH - 40,	2,					STR_NONE },
 	{ WWT_CLOSEBOX,		0,		4,			200,			WH - 36,	WH - 18,	2707,				STR_NONE }, // Use native browser
 	{ WIDGETS_END }
 };
@@ -113,6 +116,41 @@ char _extension[32];
 int _loadsaveType;
 int _type;
 
+// Directory contents are enumerated on a worker thread and appended to the
+// list from the update event, so opening the window no longer blocks on slow
+// (e.g. network) file systems. Finished listings are cached per directory
+// and extension, keyed by the directory's modified time, so reopening an
+// unchanged directory fills the list instantly.
+#define LOADSAVE_LISTING_CACHE_SIZE 4
+
+typedef struct {
+	char directory[MAX_PATH];
+	char extension[32];
+	uint32 generation;
+	loadsave_list_item *items;
+	int count;
+} loadsave_listing;
+
+typedef struct {
+	char directory[MAX_PATH];
+	char extension[32];
+	uint64 mtime;
+	loadsave_list_item *items;
+	int count;
+	uint32 lru;
+} loadsave_listing_cache_entry;
+
+static loadsave_listing_cache_entry _listingCache[LOADSAVE_LISTING_CACHE_SIZE];
+static uint32 _listingCacheTicks;
+
+static SDL_mutex *_listingMutex = NULL;
+static uint32 _listingGeneration;
+static bool _listingInProgress = false;
+static loadsave_listing *_completedListing = NULL;
+
+static void loadsave_listing_cache_store(const char *directory, const char *extension, const loadsave_list_item *items, int count);
+static void window_loadsave_append_items(const loadsave_list_item *items, int count);
+
 static void window_loadsave_populate_list(int includeNewItem, bool browsable, const char *directory, const char *extension);
 static void window_loadsave_select(rct_window *w, const char *path);
 
@@ -309,7 +347,26 @@ static int hasExtension(char *path, char *extension)
 
 static void window_loadsave_update(rct_window *w)
 {
+	loadsave_listing *listing;
+
+	if (!_listingInProgress)
+		return;
+
+	SDL_LockMutex(_listingMutex);
+	listing = _completedListing;
+	_completedListing = NULL;
+	if (listing != NULL)
+		_listingInProgress = false;
+	SDL_UnlockMutex(_listingMutex);
 
+	if (listing == NULL)
+		return;
+
+	window_loadsave_append_items(listing->items, listing->count);
+	loadsave_listing_cache_store(listing->directory, listing->extension, listing->items, listing->count);
+	free(listing->items);
+	free(listing);
+	window_invalidate(w);
 }
 
 static void window_loadsave_scrollgetsize()
@@ -424,6 +481,285 @@ static void window_loadsave_tooltip()
 	RCT2_GLOBAL(0x013CE952, uint16) = STR_LIST;
 }
 
+#pragma region Save preview
+
+// Preview of the highlighted save: park or scenario name, date, guest count
+// and a minimap, extracted by decoding only the chunks that hold them
+// instead of loading the park. Results are cached per (path, mtime), so a
+// file is parsed once per modification no matter how often it is highlighted.
+#define LOADSAVE_PREVIEW_CACHE_SIZE 8
+#define PREVIEW_MINIMAP_SIZE 64
+
+typedef struct {
+	char path[MAX_PATH];
+	uint64 mtime;
+	uint32 lru;
+	bool valid;
+	bool hasPark;			// date, guests and minimap were extracted
+	char parkName[64];
+	sint16 monthYear;
+	uint16 guests;
+	uint8 minimap[PREVIEW_MINIMAP_SIZE * PREVIEW_MINIMAP_SIZE];
+} loadsave_preview;
+
+static loadsave_preview _previewCache[LOADSAVE_PREVIEW_CACHE_SIZE];
+static uint32 _previewCacheTicks;
+
+// Offset of a fixed address global within the game data chunk
+#define PREVIEW_GAME_DATA_OFFSET(address) ((address) - 0x010E63B8)
+
+static void loadsave_preview_build_minimap(loadsave_preview *preview, const uint8 *mapElements, int length)
+{
+	// Palette colours approximating the map window's terrain colours
+	static const uint8 terrainColours[] = { 72, 43, 108, 11, 109, 21, 73, 139, 173, 54, 157, 99, 41, 44, 21, 10 };
+	const rct_map_element *element = (const rct_map_element*)mapElements;
+	const rct_map_element *end = (const rct_map_element*)(mapElements + length);
+	int x, y, tileIndex, last;
+	uint8 colour;
+
+	memset(preview->minimap, 10, sizeof(preview->minimap));
+
+	// The element stream is laid out in the tile pointer table's order:
+	// x ascending within each y row, see map_update_tile_pointers
+	tileIndex = 0;
+	while (tileIndex < 256 * 256 && element < end) {
+		x = tileIndex & 255;
+		y = tileIndex >> 8;
+
+		colour = 0;
+		do {
+			last = map_element_is_last_for_tile((rct_map_element*)element);
+			if (colour == 0 && map_element_get_type((rct_map_element*)element) == MAP_ELEMENT_TYPE_SURFACE) {
+				if (element->properties.surface.terrain & MAP_ELEMENT_WATER_HEIGHT_MASK)
+					colour = 195;	// water
+				else
+					colour = terrainColours[map_element_get_terrain((rct_map_element*)element)];
+			}
+			element++;
+		} while (!last && element < end);
+
+		// One pixel per 4x4 tile block
+		if ((x & 3) == 0 && (y & 3) == 0 && colour != 0)
+			preview->minimap[((y >> 2) * PREVIEW_MINIMAP_SIZE) + (x >> 2)] = colour;
+		tileIndex++;
+	}
+	preview->hasPark = true;
+}
+
+static void loadsave_preview_read_game_data(loadsave_preview *preview, const uint8 *gameData)
+{
+	uint16 parkNameId;
+	int index;
+
+	preview->guests = *((uint16*)(gameData + PREVIEW_GAME_DATA_OFFSET(RCT2_ADDRESS_GUESTS_IN_PARK)));
+
+	// A custom park name lives in the saved user string table; other ids
+	// need format arguments we do not have, so leave those to the file name
+	if (preview->parkName[0] == 0) {
+		parkNameId = *((uint16*)(gameData + PREVIEW_GAME_DATA_OFFSET(RCT2_ADDRESS_PARK_NAME)));
+		if (parkNameId >= 0x8000 && parkNameId < 0x9000) {
+			index = (parkNameId - 0x8000) & ~0xC00;
+			if (index < 1024)
+				strncpy(preview->parkName, (char*)(gameData + PREVIEW_GAME_DATA_OFFSET(0x0135A8F4) + (index * 32)), 32);
+		}
+	}
+}
+
+static bool loadsave_preview_parse_container(loadsave_preview *preview, const uint8 *data, uint32 size, uint8 *buffer)
+{
+	const save_container_section *section;
+
+	section = save_container_find(data, size, SAVE_SECTION_GAME_TIME);
+	if (section == NULL || save_container_decode(data, section, buffer) < 2)
+		return false;
+	preview->monthYear = *((sint16*)buffer);
+
+	section = save_container_find(data, size, SAVE_SECTION_MAP_ELEMENTS);
+	if (section == NULL || save_container_decode(data, section, buffer) != 0x4A85EC)
+		return false;
+	loadsave_preview_build_minimap(preview, buffer, 0x4A85EC);
+
+	section = save_container_find(data, size, SAVE_SECTION_GAME_DATA);
+	if (section == NULL || save_container_decode(data, section, buffer) != 0x2E8570)
+		return false;
+	loadsave_preview_read_game_data(preview, buffer);
+	return true;
+}
+
+static bool loadsave_preview_parse_classic(loadsave_preview *preview, const uint8 *data, uint32 size, uint8 *buffer)
+{
+	sawyercoding_reader reader;
+	rct_s6_header header;
+	int decodedLength;
+
+	sawyercoding_reader_init(&reader, data, size);
+	if (sawyercoding_reader_read_chunk(&reader, buffer) < (int)sizeof(rct_s6_header))
+		return false;
+	memcpy(&header, buffer, sizeof(header));
+	if (header.magic_number != S6_MAGIC_NUMBER)
+		return false;
+
+	// Scenarios and landscapes carry their name in the information chunk
+	if (header.type == S6_TYPE_SCENARIO) {
+		if (sawyercoding_reader_read_chunk(&reader, buffer) < (int)sizeof(rct_s6_info))
+			return false;
+		strncpy(preview->parkName, ((rct_s6_info*)buffer)->name, sizeof(preview->parkName) - 1);
+		preview->parkName[sizeof(preview->parkName) - 1] = 0;
+	}
+
+	// Packed objects interleave object entries with chunks; not worth
+	// parsing for a preview
+	if (header.num_packed_objects != 0)
+		return preview->parkName[0] != 0;
+
+	// Objects
+	if (sawyercoding_reader_read_chunk(&reader, buffer) < 0)
+		return preview->parkName[0] != 0;
+
+	// Game time
+	if (sawyercoding_reader_read_chunk(&reader, buffer) < 2)
+		return preview->parkName[0] != 0;
+	preview->monthYear = *((sint16*)buffer);
+
+	// Map elements
+	if (sawyercoding_reader_read_chunk(&reader, buffer) != 0x4A85EC)
+		return preview->parkName[0] != 0;
+	loadsave_preview_build_minimap(preview, buffer, 0x4A85EC);
+
+	// Game data
+	if (sawyercoding_reader_read_chunk(&reader, buffer) != 0x2E8570)
+		return true;
+	loadsave_preview_read_game_data(preview, buffer);
+	return true;
+}
+
+static void loadsave_preview_extract(loadsave_preview *preview)
+{
+	file_mapping fm;
+	uint8 *buffer;
+
+	preview->valid = false;
+	preview->hasPark = false;
+	preview->parkName[0] = 0;
+	preview->guests = 0;
+
+	if (!platform_file_map(preview->path, &fm))
+		return;
+
+	buffer = malloc(0x600000);
+	if (buffer == NULL) {
+		platform_file_unmap(&fm);
+		return;
+	}
+
+	if (save_container_is(fm.data, fm.size))
+		preview->valid = loadsave_preview_parse_container(preview, fm.data, fm.size, buffer);
+	else if (!save_delta_is(fm.data, fm.size))
+		preview->valid = loadsave_preview_parse_classic(preview, fm.data, fm.size, buffer);
+
+	free(buffer);
+	platform_file_unmap(&fm);
+}
+
+static loadsave_preview *loadsave_preview_get(const char *path)
+{
+	int i;
+	uint64 mtime;
+	loadsave_preview *preview, *lru;
+
+	mtime = platform_file_get_modified_time(path);
+	if (mtime == 0)
+		return NULL;
+
+	// Failed extractions are cached too, so a corrupt file is not re-read
+	// every paint while it stays highlighted
+	for (i = 0; i < LOADSAVE_PREVIEW_CACHE_SIZE; i++) {
+		preview = &_previewCache[i];
+		if (preview->lru != 0 && strcmp(preview->path, path) == 0 && preview->mtime == mtime) {
+			preview->lru = ++_previewCacheTicks;
+			return preview;
+		}
+	}
+
+	lru = &_previewCache[0];
+	for (i = 0; i < LOADSAVE_PREVIEW_CACHE_SIZE; i++) {
+		preview = &_previewCache[i];
+		if (preview->lru < lru->lru)
+			lru = preview;
+	}
+	preview = lru;
+	strncpy(preview->path, path, sizeof(preview->path));
+	preview->mtime = mtime;
+	preview->lru = ++_previewCacheTicks;
+	loadsave_preview_extract(preview);
+	return preview;
+}
+
+static void window_loadsave_draw_minimap(rct_drawpixelinfo *dpi, int x, int y, const uint8 *pixels)
+{
+	int left = max(x, dpi->x);
+	int top = max(y, dpi->y);
+	int right = min(x + (PREVIEW_MINIMAP_SIZE * 2), dpi->x + dpi->width);
+	int bottom = min(y + (PREVIEW_MINIMAP_SIZE * 2), dpi->y + dpi->height);
+	int dx, dy;
+	uint8 *dst;
+
+	// Drawn doubled, one source pixel per 2x2 screen pixels
+	for (dy = top; dy < bottom; dy++) {
+		dst = (uint8*)dpi->bits + ((dy - dpi->y) * (dpi->width + dpi->pitch)) + (left - dpi->x);
+		for (dx = left; dx < right; dx++)
+			*dst++ = pixels[(((dy - y) >> 1) * PREVIEW_MINIMAP_SIZE) + ((dx - x) >> 1)];
+	}
+}
+
+static void window_loadsave_paint_preview(rct_window *w, rct_drawpixelinfo *dpi)
+{
+	loadsave_preview *preview;
+	const char *path;
+	char buffer[256];
+	int x, y, month, year;
+
+	if (w->selected_list_item < 0 || w->selected_list_item >= _listItemsCount)
+		return;
+	path = _listItems[w->selected_list_item].path;
+	if (path[0] == 0 || path[strlen(path) - 1] == platform_get_path_separator())
+		return;
+	// Track designs use a different format
+	if (strcmp(_extension, ".td?") == 0)
+		return;
+
+	preview = loadsave_preview_get(path);
+	if (preview == NULL || !preview->valid)
+		return;
+
+	x = w->x + 342;
+	y = w->y + 40;
+
+	if (preview->parkName[0] != 0) {
+		sprintf(buffer, "%c%c%.64s", FORMAT_MEDIUMFONT, FORMAT_BLACK, preview->parkName);
+		gfx_draw_string(dpi, buffer, 0, x, y);
+	}
+	y += 12;
+
+	if (!preview->hasPark)
+		return;
+
+	month = preview->monthYear & 7;
+	year = (preview->monthYear >> 3) + 1;
+	sprintf(buffer, "%c%c%s, Year %d", FORMAT_MEDIUMFONT, FORMAT_BLACK, language_get_string(STR_MONTH_MARCH + month), year);
+	gfx_draw_string(dpi, buffer, 0, x, y);
+	y += 12;
+
+	sprintf(buffer, "%c%c%s: %d", FORMAT_MEDIUMFONT, FORMAT_BLACK, language_get_string(STR_GUESTS), preview->guests);
+	gfx_draw_string(dpi, buffer, 0, x, y);
+	y += 16;
+
+	gfx_fill_rect(dpi, x - 1, y - 1, x + (PREVIEW_MINIMAP_SIZE * 2), y + (PREVIEW_MINIMAP_SIZE * 2), 0);
+	window_loadsave_draw_minimap(dpi, x, y, preview->minimap);
+}
+
+#pragma endregion
+
 static void window_loadsave_paint()
 {
 	rct_window *w;
@@ -439,6 +775,7 @@ static void window_loadsave_paint()
 	// Draw shadow
 	gfx_draw_string(dpi, buffer, 0, w->x + 4, w->y + 20);
 
+	window_loadsave_paint_preview(w, dpi);
 }
 
 static void window_loadsave_scrollpaint()
@@ -490,21 +827,155 @@ static void window_loadsave_sort_list(int index, int endIndex)
 	qsort(_listItems + index, count, sizeof(loadsave_list_item), list_item_sort);
 }
 
-static void window_loadsave_populate_list(int includeNewItem, bool browsable, const char *directory, const char *extension)
+static void loadsave_listing_enumerate(loadsave_listing *listing)
 {
-	int i, listItemCapacity, fileEnumHandle;
+	int i, capacity, sortStartIndex, fileEnumHandle;
 	file_info fileInfo;
 	loadsave_list_item *listItem;
 	const char *src;
 	char *dst, filter[MAX_PATH], subDir[MAX_PATH];
 
+	strncpy(filter, listing->directory, sizeof(filter));
+	strncat(filter, "*", sizeof(filter));
+	strncat(filter, listing->extension, sizeof(filter));
+
+	capacity = 8;
+	listing->items = (loadsave_list_item*)malloc(capacity * sizeof(loadsave_list_item));
+	listing->count = 0;
+
+	fileEnumHandle = platform_enumerate_directories_begin(listing->directory);
+	while (platform_enumerate_directories_next(fileEnumHandle, subDir)) {
+		if (capacity <= listing->count) {
+			capacity *= 2;
+			listing->items = realloc(listing->items, capacity * sizeof(loadsave_list_item));
+		}
+
+		listItem = &listing->items[listing->count];
+		memset(listItem->path, '\0', MAX_PATH);
+		strncpy(listItem->path, listing->directory, MAX_PATH);
+		strncat(listItem->path, subDir, MAX_PATH);
+		strncpy(listItem->name, subDir, sizeof(listItem->name));
+
+		listing->count++;
+	}
+	platform_enumerate_files_end(fileEnumHandle);
+	qsort(listing->items, listing->count, sizeof(loadsave_list_item), list_item_sort);
+
+	sortStartIndex = listing->count;
+	fileEnumHandle = platform_enumerate_files_begin(filter);
+	while (platform_enumerate_files_next(fileEnumHandle, &fileInfo)) {
+		if (capacity <= listing->count) {
+			capacity *= 2;
+			listing->items = realloc(listing->items, capacity * sizeof(loadsave_list_item));
+		}
+
+		listItem = &listing->items[listing->count];
+		strncpy(listItem->path, listing->directory, sizeof(listItem->path));
+		strncat(listItem->path, fileInfo.path, sizeof(listItem->path));
+
+		src = fileInfo.path;
+		dst = listItem->name;
+		i = 0;
+		while (*src != 0 && *src != '.' && i < sizeof(listItem->name) - 1) {
+			*dst++ = *src++;
+			i++;
+		}
+		*dst = 0;
+
+		listing->count++;
+	}
+	platform_enumerate_files_end(fileEnumHandle);
+	qsort(listing->items + sortStartIndex, listing->count - sortStartIndex, sizeof(loadsave_list_item), list_item_sort);
+}
+
+static int loadsave_listing_thread(void *arg)
+{
+	loadsave_listing *listing = (loadsave_listing*)arg;
+
+	loadsave_listing_enumerate(listing);
+
+	SDL_LockMutex(_listingMutex);
+	if (listing->generation == _listingGeneration && _listingInProgress) {
+		if (_completedListing != NULL) {
+			free(_completedListing->items);
+			free(_completedListing);
+		}
+		_completedListing = listing;
+	} else {
+		// Navigated away before the scan finished, discard the results
+		free(listing->items);
+		free(listing);
+	}
+	SDL_UnlockMutex(_listingMutex);
+	return 0;
+}
+
+static loadsave_listing_cache_entry *loadsave_listing_cache_find(const char *directory, const char *extension)
+{
+	int i;
+	loadsave_listing_cache_entry *entry;
+
+	for (i = 0; i < LOADSAVE_LISTING_CACHE_SIZE; i++) {
+		entry = &_listingCache[i];
+		if (entry->lru != 0 && strcmp(entry->directory, directory) == 0 && strcmp(entry->extension, extension) == 0) {
+			entry->lru = ++_listingCacheTicks;
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+static void loadsave_listing_cache_store(const char *directory, const char *extension, const loadsave_list_item *items, int count)
+{
+	int i;
+	uint64 mtime;
+	loadsave_listing_cache_entry *entry, *lru;
+
+	mtime = platform_file_get_modified_time(directory);
+	if (mtime == 0)
+		return;
+
+	entry = loadsave_listing_cache_find(directory, extension);
+	if (entry == NULL) {
+		lru = &_listingCache[0];
+		for (i = 0; i < LOADSAVE_LISTING_CACHE_SIZE; i++) {
+			entry = &_listingCache[i];
+			if (entry->lru < lru->lru)
+				lru = entry;
+		}
+		entry = lru;
+		free(entry->items);
+		strncpy(entry->directory, directory, sizeof(entry->directory));
+		strncpy(entry->extension, extension, sizeof(entry->extension));
+		entry->lru = ++_listingCacheTicks;
+	} else {
+		free(entry->items);
+	}
+
+	entry->mtime = mtime;
+	entry->count = count;
+	entry->items = (loadsave_list_item*)malloc(count * sizeof(loadsave_list_item));
+	memcpy(entry->items, items, count * sizeof(loadsave_list_item));
+}
+
+static void window_loadsave_append_items(const loadsave_list_item *items, int count)
+{
+	_listItems = realloc(_listItems, (_listItemsCount + count) * sizeof(loadsave_list_item));
+	memcpy(_listItems + _listItemsCount, items, count * sizeof(loadsave_list_item));
+	_listItemsCount += count;
+}
+
+static void window_loadsave_populate_list(int includeNewItem, bool browsable, const char *directory, const char *extension)
+{
+	int listItemCapacity;
+	uint64 mtime;
+	loadsave_list_item *listItem;
+	loadsave_listing *listing;
+	loadsave_listing_cache_entry *cacheEntry;
+
 	strncpy(_directory, directory, sizeof(_directory));
 	strncpy(_extension, extension, sizeof(_extension));
 
-	strncpy(filter, directory, sizeof(filter));
-	strncat(filter, "*", sizeof(filter));
-	strncat(filter, extension, sizeof(filter));
-
 	if (_listItems != NULL)
 		free(_listItems);
 
@@ -545,50 +1016,37 @@ static void window_loadsave_populate_list(int includeNewItem, bool browsable, co
 		_listItemsCount++;
 	}
 
-	int sortStartIndex = _listItemsCount;
-	fileEnumHandle = platform_enumerate_directories_begin(directory);
-	while (platform_enumerate_directories_next(fileEnumHandle, subDir)){
-		if (listItemCapacity <= _listItemsCount) {
-			listItemCapacity *= 2;
-			_listItems = realloc(_listItems, listItemCapacity * sizeof(loadsave_list_item));
-		}
-
-		listItem = &_listItems[_listItemsCount];
-		memset(listItem->path, '\0', MAX_PATH);
-		strncpy(listItem->path, directory, MAX_PATH);
-		strncat(listItem->path, subDir, MAX_PATH);
-		strncpy(listItem->name, subDir, sizeof(listItem->name));
-
-		_listItemsCount++;
+	// Cancel any scan still running for the previous directory
+	if (_listingMutex == NULL)
+		_listingMutex = SDL_CreateMutex();
+	SDL_LockMutex(_listingMutex);
+	_listingGeneration++;
+	_listingInProgress = false;
+	if (_completedListing != NULL) {
+		free(_completedListing->items);
+		free(_completedListing);
+		_completedListing = NULL;
 	}
-	platform_enumerate_files_end(fileEnumHandle);
-	window_loadsave_sort_list(sortStartIndex, _listItemsCount - 1);
-
-	sortStartIndex = _listItemsCount;
-	fileEnumHandle = platform_enumerate_files_begin(filter);
-	while (platform_enumerate_files_next(fileEnumHandle, &fileInfo)) {
-		if (listItemCapacity <= _listItemsCount) {
-			listItemCapacity *= 2;
-			_listItems = realloc(_listItems, listItemCapacity * sizeof(loadsave_list_item));
-		}
+	SDL_UnlockMutex(_listingMutex);
 
-		listItem = &_listItems[_listItemsCount];
-		strncpy(listItem->path, directory, sizeof(listItem->path));
-		strncat(listItem->path, fileInfo.path, sizeof(listItem->path));
-		
-		src = fileInfo.path;
-		dst = listItem->name;
-		i = 0;
-		while (*src != 0 && *src != '.' && i < sizeof(listItem->name) - 1) {
-			*dst++ = *src++;
-			i++;
-		}
-		*dst = 0;
-
-		_listItemsCount++;
+	// An unchanged directory is answered from the listing cache
+	mtime = platform_file_get_modified_time(directory);
+	cacheEntry = loadsave_listing_cache_find(directory, extension);
+	if (cacheEntry != NULL && mtime != 0 && cacheEntry->mtime == mtime) {
+		window_loadsave_append_items(cacheEntry->items, cacheEntry->count);
+		return;
 	}
-	platform_enumerate_files_end(fileEnumHandle);
-	window_loadsave_sort_list(sortStartIndex, _listItemsCount - 1);
+
+	// Enumerate on a worker thread; results are appended from the update
+	// event when the scan finishes
+	listing = (loadsave_listing*)malloc(sizeof(loadsave_listing));
+	strncpy(listing->directory, directory, sizeof(listing->directory));
+	strncpy(listing->extension, extension, sizeof(listing->extension));
+	listing->generation = _listingGeneration;
+	listing->items = NULL;
+	listing->count = 0;
+	_listingInProgress = true;
+	SDL_CreateThread(loadsave_listing_thread, "OpenRCT2 file listing", listing);
 }
 
 static void window_loadsave_select(rct_window *w, const char *path)
@@ -384,13 +384,58 @@ static void window_map_mousedown(int widgetIndex, rct_window*w, rct_widget* widg
 	}
 }
 
+// The original update routine re-renders minimap rows round robin for as
+// long as the window is open, sweeping the whole map repeatedly even when
+// nothing changes. Sweep on demand instead: a full pass runs when the window
+// opens, when a tile is invalidated, or as a slow periodic safety net for
+// changes made by original code paths that bypass map_invalidate_tile.
+static bool _mapImageDirty = true;
+static bool _mapImageSweeping = true;
+static uint32 _mapImageSweepLastPos = 0;
+
+void window_map_invalidate_map_image()
+{
+	_mapImageDirty = true;
+}
+
 /**
 *
 *  rct2: 0x0068D7FB
 */
 static void window_map_update(rct_window *w)
 {
+	uint32 sweepPos;
+
+	// A rotated view needs a re-render; the original routine re-initialises
+	// the image itself once it runs
+	if (w->map.rotation != RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_ROTATION, uint16))
+		_mapImageDirty = true;
+
+	// Safety net sweep roughly every 13 seconds
+	if ((RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) & 0x1FF) == 0)
+		_mapImageDirty = true;
+
+	if (_mapImageDirty) {
+		_mapImageDirty = false;
+		_mapImageSweeping = true;
+		_mapImageSweepLastPos = RCT2_GLOBAL(0x00F1AD6C, uint32);
+	}
+
+	if (!_mapImageSweeping) {
+		// The image is up to date; overlays (peeps, trains, view rectangle)
+		// still animate from live game state
+		window_invalidate(w);
+		w->list_information_type = (w->list_information_type + 1) % (w->selected_tab == 0 ? 32 : 64);
+		return;
+	}
+
 	RCT2_CALLPROC_X(0x0068D7FB, 0, 0, 0, 0, (int)w, 0, 0);
+
+	// The render position wraps once a full pass over the map has completed
+	sweepPos = RCT2_GLOBAL(0x00F1AD6C, uint32);
+	if (sweepPos < _mapImageSweepLastPos)
+		_mapImageSweeping = false;
+	_mapImageSweepLastPos = sweepPos;
 }
 
 /**
@@ -859,6 +904,7 @@ static void window_map_init_map()
 {
 	memset(RCT2_GLOBAL(RCT2_ADDRESS_MAP_IMAGE_DATA, void*), 0x0A0A0A0A, 256 * 256 * sizeof(uint32));
 	RCT2_GLOBAL(0x00F1AD6C, uint32) = 0;
+	window_map_invalidate_map_image();
 }
 
 /**
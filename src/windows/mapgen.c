@@ -595,6 +595,10 @@ static void window_mapgen_base_update(rct_window *w)
 	if (++w->frame_no >= window_mapgen_tab_animation_loops[w->page])
 		w->frame_no = 0;
 	widget_invalidate(w, WIDX_TAB_1);
+
+	// Keep refining a generated map even if the user has switched tab
+	if (mapgen_progressive_update())
+		gfx_invalidate_screen();
 }
 
 static void window_mapgen_base_invalidate()
@@ -675,13 +679,15 @@ static void window_mapgen_random_mouseup()
 		mapgenSettings.simplex_base_freq = 1.75f;
 		mapgenSettings.simplex_octaves = 6;
 
-		mapgen_generate(&mapgenSettings);
+		mapgen_generate_progressive(&mapgenSettings);
 		gfx_invalidate_screen();
 		break;
 	case WIDX_RANDOM_TERRAIN:
+		mapgen_progressive_cancel();
 		_randomTerrrain ^= 1;
 		break;
 	case WIDX_PLACE_TREES:
+		mapgen_progressive_cancel();
 		_placeTrees ^= 1;
 		break;
 	}
@@ -698,6 +704,9 @@ static void window_mapgen_random_update(rct_window *w)
 	if (++w->frame_no >= window_mapgen_tab_animation_loops[w->page])
 		w->frame_no = 0;
 	widget_invalidate(w, WIDX_TAB_2);
+
+	if (mapgen_progressive_update())
+		gfx_invalidate_screen();
 }
 
 static void window_mapgen_random_invalidate()
@@ -767,7 +776,7 @@ static void window_mapgen_simplex_mouseup()
 		mapgenSettings.simplex_base_freq = ((float)_simplex_base_freq) / 100.00f;
 		mapgenSettings.simplex_octaves = _simplex_octaves;
 
-		mapgen_generate(&mapgenSettings);
+		mapgen_generate_progressive(&mapgenSettings);
 		gfx_invalidate_screen();
 		break;
 	}
@@ -777,6 +786,9 @@ static void window_mapgen_simplex_mousedown(int widgetIndex, rct_window *w, rct_
 {
 	int i;
 
+	// Changing a parameter invalidates any in-flight progressive refinement
+	mapgen_progressive_cancel();
+
 	switch (widgetIndex) {
 	case WIDX_SIMPLEX_LOW_UP:
 		_simplex_low = min(_simplex_low + 1, 24);
@@ -915,6 +927,9 @@ static void window_mapgen_simplex_update(rct_window *w)
 	if (++w->frame_no >= window_mapgen_tab_animation_loops[w->page])
 		w->frame_no = 0;
 	widget_invalidate(w, WIDX_TAB_3);
+
+	if (mapgen_progressive_update())
+		gfx_invalidate_screen();
 }
 
 static void window_mapgen_simplex_invalidate()
@@ -275,18 +275,62 @@ void window_new_ride_init_vars() {
 	RCT2_GLOBAL(RCT2_ADDRESS_WINDOW_RIDE_LIST_INFORMATION_TYPE, uint8) = 0;
 }
 
+// The list a tab shows is a pure function of the research availability
+// bitmasks and the loaded ride entries, none of which change while a park is
+// simply being played, so each tab's list is cached once built. Rather than
+// wiring invalidation into every research and object load path, the cache is
+// keyed on a digest of that state; anything that invents a ride or swaps the
+// loaded objects changes the digest and all tabs rebuild on next use.
+#define NEW_RIDE_LIST_CACHE_ITEMS 384
+
+static ride_list_item _newRideListCache[6][NEW_RIDE_LIST_CACHE_ITEMS];
+static int _newRideListCacheCount[6] = { -1, -1, -1, -1, -1, -1 };
+static uint32 _newRideListCacheDigest;
+
+static uint32 window_new_ride_research_digest()
+{
+	rct_ride_type **rideEntries = (rct_ride_type**)0x009ACFA4;
+	uint32 digest = 0;
+	int i;
+
+	for (i = 0; i < 4; i++)
+		digest = (digest * 33) ^ RCT2_ADDRESS(0x01357404, uint32)[i];
+	for (i = 0; i < 4; i++)
+		digest = (digest * 33) ^ RCT2_ADDRESS(0x01357424, uint32)[i];
+	for (i = 0; i < 128; i++)
+		digest = (digest * 33) ^ (uint32)rideEntries[i];
+
+	return digest;
+}
+
 /**
  *
  *  rct2: 0x006B6F3E
  */
 static void window_new_ride_populate_list()
 {
-	int i, quadIndex, bitIndex;
+	int i, quadIndex, bitIndex, count;
 
 	uint8 currentCategory = _window_new_ride_current_tab;
-	ride_list_item *nextListItem = (ride_list_item*)0x00F43523;
+	ride_list_item *listStart = (ride_list_item*)0x00F43523;
+	ride_list_item *nextListItem = listStart;
 	rct_ride_type **rideEntries = (rct_ride_type**)0x009ACFA4;
 
+	uint32 digest = window_new_ride_research_digest();
+	if (digest != _newRideListCacheDigest) {
+		_newRideListCacheDigest = digest;
+		for (i = 0; i < 6; i++)
+			_newRideListCacheCount[i] = -1;
+	}
+
+	if (currentCategory < 6 && _newRideListCacheCount[currentCategory] >= 0) {
+		count = _newRideListCacheCount[currentCategory];
+		memcpy(listStart, _newRideListCache[currentCategory], count * sizeof(ride_list_item));
+		listStart[count].type = 255;
+		listStart[count].entry_index = 255;
+		return;
+	}
+
 	// For each ride type in the view order list
 	for (i = 0; i < countof(RideTypeViewOrder); i++) {
 		uint8 rideType = RideTypeViewOrder[i];
@@ -339,6 +383,12 @@ static void window_new_ride_populate_list()
 
 	nextListItem->type = 255;
 	nextListItem->entry_index = 255;
+
+	count = nextListItem - listStart;
+	if (currentCategory < 6 && count <= NEW_RIDE_LIST_CACHE_ITEMS) {
+		memcpy(_newRideListCache[currentCategory], listStart, count * sizeof(ride_list_item));
+		_newRideListCacheCount[currentCategory] = count;
+	}
 }
 
 /**
@@ -866,23 +916,30 @@ static void window_new_ride_scrollpaint()
 	int y = 1;
 	ride_list_item *listItem = (ride_list_item*)0x00F43523;
 	while (listItem->type != 255 || listItem->entry_index != 255) {
-		rct_ride_type *rideEntry;
-		// Draw flat button rectangle
-		int flags = 0;
-		if (w->new_ride.selected_ride_id == *((sint16*)listItem))
-			flags |= 0x20;
-		if (w->new_ride.highlighted_ride_id == *((sint16*)listItem) || flags != 0)
-			gfx_fill_rect_inset(dpi, x, y, x + 115, y + 115, w->colours[1], 0x80 | flags);
-		
-		// Draw ride image
-		rideEntry = rideEntries[listItem->entry_index];
-		int image_id = rideEntry->images_offset;
-		if (listItem->type != rideEntry->ride_type[0]) {
-			image_id++;
-			if (listItem->type != rideEntry->ride_type[1])
+		// Rows are drawn top to bottom, so nothing below the clip region can
+		// be visible
+		if (y > dpi->y + dpi->height)
+			break;
+
+		if (y + 116 >= dpi->y) {
+			rct_ride_type *rideEntry;
+			// Draw flat button rectangle
+			int flags = 0;
+			if (w->new_ride.selected_ride_id == *((sint16*)listItem))
+				flags |= 0x20;
+			if (w->new_ride.highlighted_ride_id == *((sint16*)listItem) || flags != 0)
+				gfx_fill_rect_inset(dpi, x, y, x + 115, y + 115, w->colours[1], 0x80 | flags);
+
+			// Draw ride image
+			rideEntry = rideEntries[listItem->entry_index];
+			int image_id = rideEntry->images_offset;
+			if (listItem->type != rideEntry->ride_type[0]) {
 				image_id++;
+				if (listItem->type != rideEntry->ride_type[1])
+					image_id++;
+			}
+			RCT2_CALLPROC_X(0x00681DE2, 0, 29013, x + 2, y + 2, 0xA0, (int)dpi, image_id);
 		}
-		RCT2_CALLPROC_X(0x00681DE2, 0, 29013, x + 2, y + 2, 0xA0, (int)dpi, image_id);
 
 		// Next position
 		x += 116;
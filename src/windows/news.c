@@ -364,8 +364,6 @@ static void window_news_scrollpaint()
 				image_id |= (peep->tshirt_colour << 19) | (peep->trousers_colour << 24);
 
 				gfx_draw_sprite(cliped_dpi, image_id, clip_x, clip_y, 0);
-
-				rct2_free(cliped_dpi);
 				break; 
 			}
 			case NEWS_ITEM_MONEY:
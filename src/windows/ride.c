@@ -29,6 +29,7 @@
 #include "../peep/staff.h"
 #include "../ride/ride.h"
 #include "../ride/ride_data.h"
+#include "../ride/ride_stats.h"
 #include "../ride/track.h"
 #include "../sprites.h"
 #include "../windows/error.h"
@@ -992,6 +993,117 @@ static void window_ride_draw_tab_main(rct_drawpixelinfo *dpi, rct_window *w)
  * 
  * rct2: 0x006B2B68
  */
+// The vehicle previews in the tab and the trains list recompose their
+// remapped sprites every frame, which repeats the RLE decode and the
+// three-colour palette remap per pixel. The composed result only depends on
+// the image id and tertiary colour, so it is rendered once into a masked
+// bitmap (0 = transparent) and played back as a plain blit afterwards. The
+// cache is evicted round robin and never goes stale: sprite data is static
+// and the colours are part of the key.
+#define VEHICLE_PREVIEW_CACHE_FRAMES 64
+
+typedef struct {
+	uint32 spriteIndex;
+	uint8 tertiaryColour;
+	sint16 width, height;
+	sint16 offsetX, offsetY;
+	uint8 *bits;
+} vehicle_preview_frame;
+
+static vehicle_preview_frame _vehiclePreviewCache[VEHICLE_PREVIEW_CACHE_FRAMES];
+static int _vehiclePreviewCacheNextFrame;
+
+static vehicle_preview_frame *window_ride_vehicle_preview_frame(uint32 spriteIndex, uint8 tertiaryColour)
+{
+	rct_g1_element *g1Elements = RCT2_ADDRESS(RCT2_ADDRESS_G1_ELEMENTS, rct_g1_element);
+	rct_g1_element *g1;
+	vehicle_preview_frame *frame;
+	rct_drawpixelinfo frameDPI;
+	int i;
+
+	for (i = 0; i < VEHICLE_PREVIEW_CACHE_FRAMES; i++) {
+		frame = &_vehiclePreviewCache[i];
+		if (frame->bits != NULL && frame->spriteIndex == spriteIndex && frame->tertiaryColour == tertiaryColour)
+			return frame;
+	}
+
+	g1 = &g1Elements[spriteIndex & 0x7FFFF];
+	if (g1->width <= 0 || g1->height <= 0)
+		return NULL;
+
+	frame = &_vehiclePreviewCache[_vehiclePreviewCacheNextFrame];
+	_vehiclePreviewCacheNextFrame = (_vehiclePreviewCacheNextFrame + 1) % VEHICLE_PREVIEW_CACHE_FRAMES;
+	if (frame->bits != NULL)
+		free(frame->bits);
+
+	frame->spriteIndex = spriteIndex;
+	frame->tertiaryColour = tertiaryColour;
+	frame->width = g1->width;
+	frame->height = g1->height;
+	frame->offsetX = g1->x_offset;
+	frame->offsetY = g1->y_offset;
+	frame->bits = malloc(g1->width * g1->height);
+	memset(frame->bits, 0, g1->width * g1->height);
+
+	// With the dpi origin placed on the sprite offsets, drawing at 0,0 lands
+	// the sprite exactly at the top left of the bitmap
+	frameDPI.bits = (char*)frame->bits;
+	frameDPI.x = g1->x_offset;
+	frameDPI.y = g1->y_offset;
+	frameDPI.width = g1->width;
+	frameDPI.height = g1->height;
+	frameDPI.pitch = 0;
+	frameDPI.zoom_level = 0;
+	gfx_draw_sprite(&frameDPI, spriteIndex, 0, 0, tertiaryColour);
+
+	return frame;
+}
+
+/**
+ * Draws a composed vehicle preview sprite, through the frame cache when the
+ * target is unzoomed; zoomed tab previews fall back to the direct draw.
+ */
+static void window_ride_draw_vehicle_sprite(rct_drawpixelinfo *dpi, uint32 spriteIndex, int x, int y, uint8 tertiaryColour)
+{
+	vehicle_preview_frame *frame;
+	uint8 *src, *dst, pixel;
+	int left, top, right, bottom, width, dstStride, srcX, srcY;
+
+	frame = dpi->zoom_level == 0 ? window_ride_vehicle_preview_frame(spriteIndex, tertiaryColour) : NULL;
+	if (frame == NULL) {
+		gfx_draw_sprite(dpi, spriteIndex, x, y, tertiaryColour);
+		return;
+	}
+
+	left = x + frame->offsetX;
+	top = y + frame->offsetY;
+	right = left + frame->width;
+	bottom = top + frame->height;
+
+	srcX = max(dpi->x - left, 0);
+	srcY = max(dpi->y - top, 0);
+	left = max(left, dpi->x);
+	top = max(top, dpi->y);
+	right = min(right, dpi->x + dpi->width);
+	bottom = min(bottom, dpi->y + dpi->height);
+	if (left >= right || top >= bottom)
+		return;
+
+	width = right - left;
+	dstStride = dpi->width + dpi->pitch;
+	src = frame->bits + (srcY * frame->width) + srcX;
+	dst = (uint8*)dpi->bits + ((top - dpi->y) * dstStride) + (left - dpi->x);
+	for (; top < bottom; top++) {
+		for (x = 0; x < width; x++) {
+			pixel = src[x];
+			if (pixel != 0)
+				dst[x] = pixel;
+		}
+		src += frame->width;
+		dst += dstStride;
+	}
+}
+
 static void window_ride_draw_tab_vehicle(rct_drawpixelinfo *dpi, rct_window *w)
 {
 	rct_ride *ride;
@@ -1050,8 +1162,7 @@ static void window_ride_draw_tab_vehicle(rct_drawpixelinfo *dpi, rct_window *w)
 		spriteIndex |= (vehicleColour.additional_1 << 24) | (vehicleColour.main << 19);
 		spriteIndex |= 0x80000000;
 
-		gfx_draw_sprite(dpi, spriteIndex, x, y, vehicleColour.additional_2);
-		rct2_free(dpi);
+		window_ride_draw_vehicle_sprite(dpi, spriteIndex, x, y, vehicleColour.additional_2);
 	}
 }
 
@@ -2639,7 +2750,7 @@ static void window_ride_vehicle_scrollpaint()
 
 		current = nextSpriteToDraw;
 		while (--current >= _sprites_to_draw)
-			gfx_draw_sprite(dpi, current->sprite_index, current->x, current->y, current->tertiary_colour);
+			window_ride_draw_vehicle_sprite(dpi, current->sprite_index, current->x, current->y, current->tertiary_colour);
 
 		startX += 36;
 	}
@@ -4147,8 +4258,6 @@ static void window_ride_colour_paint()
 			// ?
 			if (terniaryColour != 0)
 				gfx_draw_sprite(clippedDpi, ((spriteIndex + 20) & 0x7FFFF) + terniaryColour, 34, 20, terniaryColour);
-
-			rct2_free(clippedDpi);
 		}
 	}
 }
@@ -4197,7 +4306,7 @@ static void window_ride_colour_scrollpaint()
 	spriteIndex += rideVehicleEntry->base_image_id;
 	spriteIndex |= (vehicleColour.additional_1 << 24) | (vehicleColour.main << 19);
 	spriteIndex |= 0x80000000;
-	gfx_draw_sprite(dpi, spriteIndex, x, y, vehicleColour.additional_2);
+	window_ride_draw_vehicle_sprite(dpi, spriteIndex, x, y, vehicleColour.additional_2);
 }
 
 #pragma endregion
@@ -5811,9 +5920,7 @@ static void window_ride_customer_paint()
 	y = w->y + window_ride_customer_widgets[WIDX_PAGE_BACKGROUND].top + 4;
 
 	// Customers per hour
-	customersPerHour = ride->var_124 + ride->var_126 + ride->var_128 + ride->var_12A + ride->var_12C +
-					   ride->var_12E + ride->age + ride->running_cost + ride->var_134 + ride->var_136;
-	customersPerHour *= 12;
+	customersPerHour = ride_stats_customers_per_hour(w->number);
 	gfx_draw_string_left(dpi, STR_CUSTOMERS_PER_HOUR, &customersPerHour, 0, x, y);
 	y += 10;
 
@@ -367,10 +367,9 @@ void window_construction_paint()
 		height);
 	if (clip_dpi != NULL)
 	{
-		rct_preview_track *trackBlock;
+		const rct_preview_track *trackBlock;
 		ecx = RCT2_GLOBAL(0xF44135, uint8_t);
-		if (RCT2_GLOBAL(0xF44064, uint32_t) & 0x80000) trackBlock = RCT2_ADDRESS(0x994A38, rct_preview_track*)[ecx];//RCT2_GLOBAL(0x994A38 + ecx * 4, rct_preview_track*);
-		else trackBlock = RCT2_ADDRESS(0x994638, rct_preview_track*)[ecx];//RCT2_GLOBAL(0x994638 + ecx * 4, rct_preview_track*);
+		trackBlock = track_block_get(ecx, RCT2_GLOBAL(0xF44064, uint32_t) & 0x80000);
 		while ((trackBlock + 1)->var_00 != 0xFF) trackBlock++;
 		short x = trackBlock->x;
 		short z = trackBlock->z;
@@ -434,7 +433,6 @@ void window_construction_paint()
 		d |= RCT2_GLOBAL(0xF44133, uint8_t);// Ride id
 		d |= RCT2_GLOBAL(0xF44135, uint8_t) << 8;
 		RCT2_CALLPROC_X(0x6CBCE2, 0x1000, (((uint16_t)bx) & 0xFF) | (RCT2_GLOBAL(0xF44134, uint8_t) << 8), 0x1000, d, width, 0x400, height);
-		rct2_free(clip_dpi);
 	}
 	short string_x = (RCT2_GLOBAL(0x9D7C02, int16_t) + RCT2_GLOBAL(0x9D7C04, int16_t)) / 2 + w->x;
 	short string_y = RCT2_GLOBAL(0x9D7C08, int16_t) + w->y - 23;
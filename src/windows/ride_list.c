@@ -454,8 +454,19 @@ static void window_ride_list_scrollpaint()
 
 	gfx_fill_rect(dpi, dpi->x, dpi->y, dpi->x + dpi->width, dpi->y + dpi->height, RCT2_GLOBAL(0x0141FC48 + (w->colours[1] * 8), uint8));
 
+	// Skip straight to the first row that can intersect the clip area
+	i = 0;
 	y = 0;
-	for (i = 0; i < w->no_list_items; i++) {
+	if (dpi->y - 11 > y) {
+		i = (dpi->y - 11 - y) / 10;
+		y += i * 10;
+	}
+	for (; i < w->no_list_items; i++) {
+		// Rows are drawn top to bottom, so nothing below the clip region can
+		// be visible
+		if (y > dpi->y + dpi->height)
+			break;
+
 		format = 1191;
 
 		// Background highlight
@@ -463,7 +474,7 @@ static void window_ride_list_scrollpaint()
 			gfx_fill_rect(dpi, 0, y, 800, y + 9, 0x02000031);
 			format = 1193;
 		}
-		
+
 		// Get ride
 		ride = &g_ride_list[w->list_item_positions[i]];
 
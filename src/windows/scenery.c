@@ -181,6 +181,11 @@ static rct_widget window_scenery_widgets[] = {
 // rct2: 0x00F64F2C
 sint16 window_scenery_tab_entries[20][SCENERY_ENTRIES_BY_TAB + 1];
 
+// Set when the inputs to the tab entry lists change (scenery objects loaded
+// or the researched scenery mask edited); init_scenery only rebuilds the
+// lists while this is set, so opening the window reuses the existing ones.
+static bool _sceneryTabEntriesInvalidated = true;
+
 void window_scenery_update_scroll(rct_window *w);
 
 /**
@@ -232,6 +237,10 @@ void init_scenery()
 {
 	bool enabledScenerySets[0x14] = { false };
 
+	if (!_sceneryTabEntriesInvalidated)
+		return;
+	_sceneryTabEntriesInvalidated = false;
+
 	for (int scenerySetIndex = 0; scenerySetIndex < 0x14; scenerySetIndex++) {
 		window_scenery_tab_entries[scenerySetIndex][0] = -1;
 		if (scenerySetIndex == 0x13)
@@ -375,6 +384,16 @@ void init_scenery()
 	window_invalidate_by_class(WC_SCENERY);
 }
 
+/**
+ * Marks the per-tab entry lists stale so the next init_scenery call rebuilds
+ * them. Called when scenery objects are loaded or unloaded and when the
+ * researched scenery mask changes.
+ */
+void init_scenery_invalidate()
+{
+	_sceneryTabEntriesInvalidated = true;
+}
+
 /**
  *
  *  rct2: 0x006DFEE4
@@ -385,6 +404,7 @@ void scenery_set_default_placement_configuration()
 	window_scenery_primary_colour = 26;
 	window_scenery_secondary_colour = 18;
 	window_scenery_tertiary_colour = 24;
+	init_scenery_invalidate();
 	init_scenery();
 
 	for (int i = 0; i < 20; i++)
@@ -1169,8 +1189,6 @@ void window_scenery_scrollpaint()
 					}
 				}
 
-
-				rct2_free(clipdpi);
 			}
 		} else if (currentSceneryGlobalId >= 0x100) {
 			sceneryEntry = g_pathBitSceneryEntries[currentSceneryGlobalId - 0x100];
@@ -1212,8 +1230,6 @@ void window_scenery_scrollpaint()
 					imageId = (sceneryEntry->image + window_scenery_rotation) + 4;
 					gfx_draw_sprite(clipdpi, imageId, 0x20, spriteTop, w->colours[1]);
 				}
-
-				rct2_free(clipdpi);
 			}
 		}
 		
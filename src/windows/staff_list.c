@@ -557,7 +557,6 @@ void window_staff_list_paint() {
 			0x0F,
 			0x17, 0
 			);
-		rct2_free(sprite_dpi);
 	}
 
 	if (!(RCT2_GLOBAL(RCT2_ADDRESS_PARK_FLAGS, uint32) & PARK_FLAGS_NO_MONEY)) {
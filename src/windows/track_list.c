@@ -53,6 +53,7 @@ static rct_widget window_track_list_widgets[] = {
 static void window_track_list_emptysub() { }
 static void window_track_list_close();
 static void window_track_list_mouseup();
+static void window_track_list_update(rct_window *w);
 static void window_track_list_scrollgetsize();
 static void window_track_list_scrollmousedown();
 static void window_track_list_scrollmouseover();
@@ -68,7 +69,7 @@ static void* window_track_list_events[] = {
 	(uint32*)window_track_list_emptysub,
 	(uint32*)window_track_list_emptysub,
 	(uint32*)window_track_list_emptysub,
-	(uint32*)window_track_list_emptysub,
+	(uint32*)window_track_list_update,
 	(uint32*)window_track_list_emptysub,
 	(uint32*)window_track_list_emptysub,
 	(uint32*)window_track_list_emptysub,
@@ -110,7 +111,7 @@ void window_track_list_open(ride_list_item item)
 	if (RCT2_GLOBAL(0x00F635ED, uint8) & 1)
 		window_error_open(STR_WARNING, STR_TOO_MANY_TRACK_DESIGNS_OF_THIS_TYPE);
 
-	mem = malloc(1285292);
+	mem = malloc(TRACK_DESIGN_CACHE_SIZE * sizeof(rct_track_design));
 	if (mem == NULL)
 		return;
 
@@ -197,6 +198,42 @@ static void window_track_list_select(rct_window *w, int index)
 	window_track_place_open();
 }
 
+/**
+ * Loads at most one not yet cached design near the current selection per
+ * update tick, so the preview cache fills in while the list is browsed and
+ * stepping onto a neighbouring design no longer hitches on load.
+ */
+static void window_track_list_update(rct_window *w)
+{
+	int i, index, offset, trackIndex, numTrackDesigns;
+	uint8 *trackDesignList = RCT2_ADDRESS(RCT2_ADDRESS_TRACK_LIST, uint8);
+
+	trackIndex = w->track_list.var_482;
+	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_TRACK_MANAGER) {
+		if (*trackDesignList == 0 || trackIndex == -1)
+			return;
+	} else if (trackIndex-- == 0) {
+		return;
+	}
+
+	numTrackDesigns = 0;
+	while (trackDesignList[numTrackDesigns * 128] != 0)
+		numTrackDesigns++;
+
+	// Walk outwards from the selection and load the first design that is
+	// not cached yet
+	for (i = 0; i < TRACK_DESIGN_CACHE_SIZE - 1; i++) {
+		offset = (i & 1) ? -((i + 1) / 2) : (i / 2);
+		index = trackIndex + offset;
+		if (index < 0 || index >= numTrackDesigns)
+			continue;
+		if (!track_design_index_is_cached(index)) {
+			track_get_info(index, NULL);
+			return;
+		}
+	}
+}
+
 static int window_track_list_get_list_item_index_from_position(int x, int y)
 {
 	int index;
@@ -610,6 +647,11 @@ static void window_track_list_scrollpaint()
 	}
 
 	while (*trackDesignItem != 0) {
+		// Rows are drawn top to bottom, so nothing below the clip region can
+		// be visible
+		if (y >= dpi->y + dpi->height)
+			break;
+
 		if (y + 10 >= dpi->y && y < dpi->y + dpi->height) {
 			if (i == w->track_list.var_482) {
 				// Highlight
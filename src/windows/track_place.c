@@ -26,6 +26,7 @@
 #include "../interface/widget.h"
 #include "../interface/window.h"
 #include "../localisation/localisation.h"
+#include "../platform/platform.h"
 #include "../sprites.h"
 #include "../ride/track.h"
 #include "../ride/track_data.h"
@@ -60,6 +61,7 @@ static void window_track_place_close();
 static void window_track_place_mouseup();
 static void window_track_place_update(rct_window *w);
 static void window_track_place_toolupdate();
+static void window_track_place_tool_update_position(rct_window *w, short x, short y);
 static void window_track_place_tooldown();
 static void window_track_place_toolabort();
 static void window_track_place_unknown14();
@@ -106,6 +108,58 @@ static sint16 _window_track_place_last_valid_y;
 static sint16 _window_track_place_last_valid_z;
 static money32 _window_track_place_last_cost;
 
+// Ghost and price updates are throttled to the frame interval; mouse move
+// events arriving faster than that only record the position, and the update
+// event applies the most recent one. Without this a fast drag floods the
+// game command path with full design validations.
+static uint32 _window_track_place_last_ghost_time;
+static bool _window_track_place_ghost_pending;
+static sint16 _window_track_place_pending_x;
+static sint16 _window_track_place_pending_y;
+
+// Every ghost update validates the whole design through the game command
+// path, once per height attempt. Tiles a drag has already passed over give
+// the same answer, so the result (or the failure) is remembered per tile and
+// rotation. The cache is dropped whenever the design or landscape changes.
+#define TRACK_PLACE_COST_CACHE_SIZE 128
+
+typedef struct {
+	uint32 key;
+	money32 cost;
+	sint16 z;
+} track_place_cost_cache_entry;
+
+static track_place_cost_cache_entry _window_track_place_cost_cache[TRACK_PLACE_COST_CACHE_SIZE];
+
+static uint32 track_place_cost_cache_key(int x, int y, int rotation)
+{
+	return 0x80000000 | (rotation << 16) | ((y >> 5) << 8) | (x >> 5);
+}
+
+static track_place_cost_cache_entry *track_place_cost_cache_slot(uint32 key)
+{
+	return &_window_track_place_cost_cache[(key ^ (key >> 7) ^ (key >> 14)) & (TRACK_PLACE_COST_CACHE_SIZE - 1)];
+}
+
+static track_place_cost_cache_entry *track_place_cost_cache_get(uint32 key)
+{
+	track_place_cost_cache_entry *entry = track_place_cost_cache_slot(key);
+	return entry->key == key ? entry : NULL;
+}
+
+static void track_place_cost_cache_set(uint32 key, money32 cost, sint16 z)
+{
+	track_place_cost_cache_entry *entry = track_place_cost_cache_slot(key);
+	entry->key = key;
+	entry->cost = cost;
+	entry->z = z;
+}
+
+static void track_place_cost_cache_clear()
+{
+	memset(_window_track_place_cost_cache, 0, sizeof(_window_track_place_cost_cache));
+}
+
 /**
  *
  *  rct2: 0x006D182E
@@ -128,7 +182,7 @@ static void window_track_place_draw_mini_preview()
 	int i, rotation, pass, x, y, pixelX, pixelY, originX, originY, minX, minY, maxX, maxY;
 	rct_maze_element *mazeElement;
 	rct_track_element *trackElement;
-	rct_preview_track *trackBlock;
+	const rct_preview_track *trackBlock;
 
 	window_track_place_clear_mini_preview();
 
@@ -161,7 +215,7 @@ static void window_track_place_draw_mini_preview()
 				colour = RCT2_ADDRESS(0x0099BA64, uint8)[trackType * 16] & 0x10 ? 222 : 218;
 
 				// Follow a single track piece shape
-				trackBlock = RCT2_ADDRESS(0x00994638, rct_preview_track*)[trackType];
+				trackBlock = track_block_get(trackType, 0);
 				while (trackBlock->var_00 != 255) {
 					x = originX;
 					y = originY;
@@ -386,6 +440,8 @@ void window_track_place_open()
 	show_gridlines();
 	_window_track_place_last_cost = MONEY32_UNDEFINED;
 	_window_track_place_last_x = 0xFFFF;
+	_window_track_place_ghost_pending = false;
+	track_place_cost_cache_clear();
 	RCT2_GLOBAL(RCT2_ADDRESS_TRACK_PREVIEW_ROTATION, uint8) = (-RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_ROTATION, uint8)) & 3;
 	window_track_place_draw_mini_preview();
 }
@@ -424,6 +480,7 @@ static void window_track_place_mouseup()
 		RCT2_GLOBAL(RCT2_ADDRESS_TRACK_PREVIEW_ROTATION, uint16) = (RCT2_GLOBAL(RCT2_ADDRESS_TRACK_PREVIEW_ROTATION, uint16) + 1) & 3;
 		window_invalidate(w);
 		_window_track_place_last_x = 0xFFFF;
+		track_place_cost_cache_clear();
 		window_track_place_draw_mini_preview();
 		break;
 	case WIDX_MIRROR:
@@ -431,6 +488,7 @@ static void window_track_place_mouseup()
 		RCT2_GLOBAL(RCT2_ADDRESS_TRACK_PREVIEW_ROTATION, uint16) = (-RCT2_GLOBAL(RCT2_ADDRESS_TRACK_PREVIEW_ROTATION, uint16)) & 3;
 		window_invalidate(w);
 		_window_track_place_last_x = 0xFFFF;
+		track_place_cost_cache_clear();
 		window_track_place_draw_mini_preview();
 		break;
 	case WIDX_SELECT_DIFFERENT_DESIGN:
@@ -446,6 +504,13 @@ static void window_track_place_mouseup()
  */
 static void window_track_place_update(rct_window *w)
 {
+	// Apply the ghost update the throttle held back
+	if (_window_track_place_ghost_pending) {
+		_window_track_place_ghost_pending = false;
+		_window_track_place_last_ghost_time = SDL_GetTicks();
+		window_track_place_tool_update_position(w, _window_track_place_pending_x, _window_track_place_pending_y);
+	}
+
 	if (!(RCT2_GLOBAL(RCT2_ADDRESS_INPUT_FLAGS, uint32) & INPUT_FLAG_TOOL_ACTIVE))
 		if (RCT2_GLOBAL(RCT2_ADDRESS_TOOL_WINDOWCLASS, rct_windowclass) != WC_TRACK_DESIGN_PLACE)
 			window_close(w);
@@ -459,12 +524,31 @@ static void window_track_place_toolupdate()
 {
 	rct_window *w;
 	short widgetIndex, x, y;
-	int i, z;
-	money32 cost;
-	uint8 rideIndex;
+	uint32 time;
 
 	window_tool_get_registers(w, widgetIndex, x, y);
 
+	time = SDL_GetTicks();
+	if (time - _window_track_place_last_ghost_time < 25) {
+		_window_track_place_ghost_pending = true;
+		_window_track_place_pending_x = x;
+		_window_track_place_pending_y = y;
+		return;
+	}
+
+	_window_track_place_last_ghost_time = time;
+	_window_track_place_ghost_pending = false;
+	window_track_place_tool_update_position(w, x, y);
+}
+
+static void window_track_place_tool_update_position(rct_window *w, short x, short y)
+{
+	int i, z, rotation;
+	money32 cost;
+	uint8 rideIndex;
+	uint32 key;
+	track_place_cost_cache_entry *entry;
+
 	map_invalidate_map_selection_tiles();
 	RCT2_GLOBAL(RCT2_ADDRESS_MAP_SELECTION_FLAGS, uint16) &= ~7;
 
@@ -487,19 +571,43 @@ static void window_track_place_toolupdate()
 	z = window_track_place_get_base_z(x, y);
 	if (RCT2_GLOBAL(RCT2_ADDRESS_GAME_PAUSED, uint8) == 0) {
 		window_track_place_clear_provisional();
-		
-		// Try increasing Z until a feasible placement is found
-		for (i = 0; i < 7; i++) {
-			window_track_place_attempt_placement(x, y, z, 105, &cost, &rideIndex);
+
+		rotation = (RCT2_GLOBAL(RCT2_ADDRESS_TRACK_PREVIEW_ROTATION, uint8) + RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_ROTATION, uint32)) & 3;
+		key = track_place_cost_cache_key(x, y, rotation);
+		entry = track_place_cost_cache_get(key);
+
+		if (entry != NULL && entry->cost == MONEY32_UNDEFINED) {
+			// Remembered as unplaceable; skip the attempts but leave z where
+			// the full search would have
+			z += 8 * 7;
+		} else {
+			if (entry != NULL) {
+				// Re-place the ghost at the remembered height
+				window_track_place_attempt_placement(x, y, entry->z, 105, &cost, &rideIndex);
+				if (cost != MONEY32_UNDEFINED)
+					z = entry->z;
+				else
+					entry = NULL; // Landscape changed under the cache
+			}
+
+			if (entry == NULL) {
+				// Try increasing Z until a feasible placement is found
+				for (i = 0; i < 7; i++) {
+					window_track_place_attempt_placement(x, y, z, 105, &cost, &rideIndex);
+					if (cost != MONEY32_UNDEFINED)
+						break;
+					z += 8;
+				}
+				track_place_cost_cache_set(key, cost, z);
+			}
+
 			if (cost != MONEY32_UNDEFINED) {
 				RCT2_GLOBAL(0x00F440EB, uint16) = rideIndex;
 				_window_track_place_last_valid_x = x;
 				_window_track_place_last_valid_y = y;
 				_window_track_place_last_valid_z = z;
 				_window_track_place_last_was_valid = 1;
-				break;
 			}
-			z += 8;
 		}
 	}
 
@@ -528,6 +636,7 @@ static void window_track_place_tooldown()
 	window_tool_get_registers(w, widgetIndex, x, y);
 
 	window_track_place_clear_provisional();
+	track_place_cost_cache_clear();
 	map_invalidate_map_selection_tiles();
 	RCT2_GLOBAL(RCT2_ADDRESS_MAP_SELECTION_FLAGS, uint16) &= ~7;
 
@@ -614,8 +723,6 @@ static void window_track_place_paint()
 		subsituteElement->flags = 0;
 		gfx_draw_sprite(clippedDpi, 0, 0, 0, 0);
 		*subsituteElement = tmpElement;
-
-		rct2_free(clippedDpi);
 	}
 
 	// Price
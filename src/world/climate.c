@@ -22,6 +22,7 @@
 #include "../audio/audio.h"
 #include "../audio/mixer.h"
 #include "../drawing/drawing.h"
+#include "../game_state.h"
 #include "../localisation/date.h"
 #include "../scenario.h"
 #include "../interface/window.h"
@@ -40,22 +41,10 @@ typedef struct {
 	sint8 distribution[24];
 } rct_weather_transition;
 
-// These still need to be read / written when loading and saving
-// int gClimateNextWeather;
-// 
-// static int _climateCurrentWeatherEffect;
-// 
-// static int _climateNextTemperature;
-// static int _climateNextWeatherEffect;
-// static int _climateNextWeatherGloom;
-// static int _climateNextRainLevel;
-
-#define _climateCurrentWeatherEffect	RCT2_GLOBAL(0x013CA74E, uint8)
-
-#define _climateNextTemperature			RCT2_GLOBAL(0x013CA74D, uint8)
-#define _climateNextWeatherEffect		RCT2_GLOBAL(0x013CA74F, uint8)
-#define _climateNextWeatherGloom		RCT2_GLOBAL(0x013CA751, uint8)
-#define _climateNextRainLevel			RCT2_GLOBAL(0x013CA753, uint8)
+// The climate state lives in gGameState.climate and is mirrored back to the
+// legacy data segment addresses with game_state_sync_to_legacy whenever it
+// changes, for the original executable and the saved game serialiser.
+#define _climate	gGameState.climate
 
 static const rct_weather_transition* climate_transitions[4];
 
@@ -90,18 +79,18 @@ int climate_celsius_to_fahrenheit(int celsius)
  */
 void climate_reset(int climate)
 {
-	RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE, sint8) = climate;
+	_climate.current_climate = climate;
 
 	sint8 month = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_MONTH_YEAR, sint16) & 7;
 	const rct_weather_transition* climate_table = climate_transitions[climate];
 	rct_weather_transition transition = climate_table[month];
 	sint8 weather = WEATHER_PARTIALLY_CLOUDY;
-	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER, sint8) = weather;
-	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TEMPERATURE, sint8) = transition.base_temperature + climate_weather_data[weather].temp_delta;
-	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_EFFECT, sint8) = climate_weather_data[weather].effect_level;
-	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_GLOOM, sint8) = climate_weather_data[weather].gloom_level;
-	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_RAIN_LEVEL, sint8) = climate_weather_data[weather].rain_level;
-	
+	_climate.current_weather = weather;
+	_climate.current_temperature = transition.base_temperature + climate_weather_data[weather].temp_delta;
+	_climate.current_weather_effect = climate_weather_data[weather].effect_level;
+	_climate.current_weather_gloom = climate_weather_data[weather].gloom_level;
+	_climate.current_rain_level = climate_weather_data[weather].rain_level;
+
 	_lightningTimer = 0;
 	_thunderTimer = 0;
 	if (_rainVolume != 1){
@@ -117,6 +106,7 @@ void climate_reset(int climate)
 	}
 
 	climate_determine_future_weather();
+	game_state_sync_to_legacy();
 }
 
 sint8 step_weather_level(sint8 cur_weather_level, sint8 next_weather_level) {
@@ -143,12 +133,12 @@ void toggle_climate_lock()
 void climate_update()
 {
 	uint8 screen_flags = RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8);
-	sint8 temperature = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TEMPERATURE, sint8),
-		target_temperature = _climateNextTemperature,
-		cur_gloom = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_GLOOM, sint8),
-		next_gloom = _climateNextWeatherGloom,
-		cur_rain = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_RAIN_LEVEL, sint8),
-		next_rain = _climateNextRainLevel;
+	sint8 temperature = _climate.current_temperature,
+		target_temperature = _climate.next_temperature,
+		cur_gloom = _climate.current_weather_gloom,
+		next_gloom = _climate.next_weather_gloom,
+		cur_rain = _climate.current_rain_level,
+		next_rain = _climate.next_rain_level;
 
 	if (g_climate_locked) //for cheats
 		return;
@@ -156,46 +146,49 @@ void climate_update()
 	if (screen_flags & (~SCREEN_FLAGS_PLAYING)) // only normal play mode gets climate
 		return;
 
-	if (RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE_UPDATE_TIMER, sint16))	{
+	if (_climate.update_timer) {
 
-		if (RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE_UPDATE_TIMER, sint16) == 960)
+		if (_climate.update_timer == 960)
 			RCT2_GLOBAL(RCT2_ADDRESS_BTM_TOOLBAR_DIRTY_FLAGS, uint32) |= BTM_TB_DIRTY_FLAG_CLIMATE;
 
-		RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE_UPDATE_TIMER, sint16)--;
+		_climate.update_timer--;
 
 	} else if (!(RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, sint32) & 0x7F)) {
-		
+
 		if (temperature == target_temperature) {
 			if (cur_gloom == next_gloom) {
-				_climateCurrentWeatherEffect = _climateNextWeatherEffect;
+				_climate.current_weather_effect = _climate.next_weather_effect;
 				_thunderTimer = 0;
 				_lightningTimer = 0;
 
 				if (cur_rain == next_rain) {
-					RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER, sint8) = gClimateNextWeather;
+					_climate.current_weather = _climate.next_weather;
 					climate_determine_future_weather();
 					RCT2_GLOBAL(RCT2_ADDRESS_BTM_TOOLBAR_DIRTY_FLAGS, uint32) |= BTM_TB_DIRTY_FLAG_CLIMATE;
 				} else if (next_rain <= 2) { // Safe-guard
-					RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_RAIN_LEVEL, sint8) = step_weather_level(cur_rain, next_rain);
+					_climate.current_rain_level = step_weather_level(cur_rain, next_rain);
 				}
 			} else {
-				RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_GLOOM, sint8) = step_weather_level(cur_gloom, next_gloom);
+				_climate.current_weather_gloom = step_weather_level(cur_gloom, next_gloom);
 				gfx_invalidate_screen();
 			}
 
 		} else {
-			RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TEMPERATURE, sint8) = step_weather_level(temperature, target_temperature);
+			_climate.current_temperature = step_weather_level(temperature, target_temperature);
 			RCT2_GLOBAL(RCT2_ADDRESS_BTM_TOOLBAR_DIRTY_FLAGS, uint32) |= BTM_TB_DIRTY_FLAG_CLIMATE;
 		}
 	}
+
+	game_state_sync_to_legacy();
 }
 
 void climate_force_weather(uint8 weather){
-	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER, sint8) = weather;
-	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_WEATHER_GLOOM, sint8) = climate_weather_data[weather].gloom_level;
-	RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_RAIN_LEVEL, sint8) = climate_weather_data[weather].rain_level;
-	_climateCurrentWeatherEffect = climate_weather_data[weather].effect_level;
-	RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE_UPDATE_TIMER, sint16) = 1920;
+	_climate.current_weather = weather;
+	_climate.current_weather_gloom = climate_weather_data[weather].gloom_level;
+	_climate.current_rain_level = climate_weather_data[weather].rain_level;
+	_climate.current_weather_effect = climate_weather_data[weather].effect_level;
+	_climate.update_timer = 1920;
+	game_state_sync_to_legacy();
 
 	climate_update();
 	
@@ -213,21 +206,21 @@ void climate_force_weather(uint8 weather){
  */
 static void climate_determine_future_weather()
 {
-	sint8 climate = RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE, sint8);
+	sint8 climate = _climate.current_climate;
 	const rct_weather_transition* climate_table = climate_transitions[climate];
 	sint8 month = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_MONTH_YEAR, sint16) & 7;
 	rct_weather_transition transition = climate_table[month];
-	
+
 	// Generate a random variable with values 0 upto distribution_size-1 and chose weather from the distribution table accordingly
 	sint8 next_weather = transition.distribution[ ((rand() & 0xFF) * transition.distribution_size) >> 8 ];
-	gClimateNextWeather = next_weather;
+	_climate.next_weather = next_weather;
 
-	_climateNextTemperature = transition.base_temperature + climate_weather_data[next_weather].temp_delta;
-	_climateNextWeatherEffect = climate_weather_data[next_weather].effect_level;
-	_climateNextWeatherGloom = climate_weather_data[next_weather].gloom_level;
-	_climateNextRainLevel = climate_weather_data[next_weather].rain_level;
-	
-	RCT2_GLOBAL(RCT2_ADDRESS_CLIMATE_UPDATE_TIMER, sint16) = 1920;
+	_climate.next_temperature = transition.base_temperature + climate_weather_data[next_weather].temp_delta;
+	_climate.next_weather_effect = climate_weather_data[next_weather].effect_level;
+	_climate.next_weather_gloom = climate_weather_data[next_weather].gloom_level;
+	_climate.next_rain_level = climate_weather_data[next_weather].rain_level;
+
+	_climate.update_timer = 1920;
 }
 
 /**
@@ -251,7 +244,7 @@ void climate_update_sound()
 
 static void climate_update_rain_sound()
 {
-	if (_climateCurrentWeatherEffect == 1 || _climateCurrentWeatherEffect == 2) {
+	if (_climate.current_weather_effect == 1 || _climate.current_weather_effect == 2) {
 		if (_rainVolume == 1) {
 			// Start playing the rain sound
 #ifdef USE_MIXER
@@ -308,7 +301,7 @@ static void climate_update_thunder_sound()
 	} else if (_thunderTimer != 0) {
 		climate_update_lightning();
 		climate_update_thunder();
-	} else if (_climateCurrentWeatherEffect == 2) {
+	} else if (_climate.current_weather_effect == 2) {
 		// Create new thunder and lightning
 		unsigned int randomNumber = scenario_rand();
 		if ((randomNumber & 0xFFFF) <= 0x1B4) {
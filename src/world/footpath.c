@@ -24,6 +24,8 @@
 #include "../util/util.h"
 #include "footpath.h"
 #include "map.h"
+#include "path_cache.h"
+#include "path_region.h"
 #include "scenery.h"
 
 void sub_673883(int x, int y, int z);
@@ -292,6 +294,7 @@ static money32 footpath_element_update(int x, int y, rct_map_element *mapElement
 static money32 footpath_place_real(int type, int x, int y, int z, int slope, int flags, uint8 path_bit_type)
 {
 	rct_map_element *mapElement;
+	money32 cost;
 
 	RCT2_GLOBAL(0x0141F56C, uint8) = 12;
 	RCT2_GLOBAL(0x009DEA5E, uint16) = x + 16;
@@ -303,8 +306,11 @@ static money32 footpath_place_real(int type, int x, int y, int z, int slope, int
 		return MONEY32_UNDEFINED;
 	}
 
-	if (flags & GAME_COMMAND_FLAG_APPLY)
+	if (flags & GAME_COMMAND_FLAG_APPLY) {
 		sub_69A48B(x, y, z * 8);
+		path_cache_invalidate();
+		path_region_invalidate();
+	}
 
 	RCT2_GLOBAL(0x00F3EFD9, money32) = 0;
 	RCT2_GLOBAL(0x00F3EFA4, uint8) = 0;
@@ -334,9 +340,12 @@ static money32 footpath_place_real(int type, int x, int y, int z, int slope, int
 	}
 
 	mapElement = map_get_footpath_element_slope((x / 32), (y / 32), z, slope);
-	return mapElement == NULL ?
+	cost = mapElement == NULL ?
 		footpath_element_insert(type, x, y, z, slope, flags) :
 		footpath_element_update(x, y, mapElement, type, flags);
+	if (cost != MONEY32_UNDEFINED && (flags & GAME_COMMAND_FLAG_APPLY))
+		map_path_wide_flags_invalidate(x, y);
+	return cost;
 }
 
 /* rct2: 0x006BA23E */
@@ -367,6 +376,8 @@ money32 footpath_remove_real(int x, int y, int z, int flags)
 	if (flags & GAME_COMMAND_FLAG_APPLY) {
 		sub_69A48B(x, y, z * 8);
 		sub_673883(x, y, z * 8);
+		path_cache_invalidate();
+		path_region_invalidate();
 	}
 
 	if (!(RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_SCENARIO_EDITOR) && !map_is_location_owned(x, y, z * 8))
@@ -380,6 +391,7 @@ money32 footpath_remove_real(int x, int y, int z, int flags)
 		map_invalidate_tile_full(x, y);
 		map_element_remove(mapElement);
 		sub_6A759F();
+		map_path_wide_flags_invalidate(x, y);
 	}
 
 	return (flags & (1 << 5)) || (RCT2_GLOBAL(RCT2_ADDRESS_PARK_FLAGS, uint32) & PARK_FLAGS_NO_MONEY) ? 0 : -MONEY(10,00);
@@ -20,7 +20,9 @@
 
 #include "../addresses.h"
 #include "../audio/audio.h"
+#include "../drawing/drawing.h"
 #include "../game.h"
+#include "../interface/viewport.h"
 #include "../interface/window.h"
 #include "../localisation/date.h"
 #include "../localisation/localisation.h"
@@ -54,6 +56,8 @@ static void tiles_init();
 static void sub_6A87BB(int x, int y);
 static void map_update_grass_length(int x, int y, rct_map_element *mapElement);
 static void map_set_grass_length(int x, int y, rct_map_element *mapElement, int length);
+static void map_grass_stable_invalidate(int x, int y);
+static void map_grass_stable_reset();
 
 void map_element_iterator_begin(map_element_iterator *it)
 {
@@ -95,6 +99,35 @@ void map_element_iterator_restart_for_tile(map_element_iterator *it)
 	it->element = NULL;
 }
 
+void map_tile_span_iterator_begin(map_tile_span_iterator *it)
+{
+	it->x = -1;
+	it->y = 0;
+	it->first = NULL;
+	it->last = NULL;
+}
+
+int map_tile_span_iterator_next(map_tile_span_iterator *it)
+{
+	rct_map_element *element;
+
+	if (it->x < 255) {
+		it->x++;
+	} else if (it->y < 255) {
+		it->x = 0;
+		it->y++;
+	} else {
+		return 0;
+	}
+
+	element = TILE_MAP_ELEMENT_POINTER(it->x + it->y * 256);
+	it->first = element;
+	while (!map_element_is_last_for_tile(element))
+		element++;
+	it->last = element;
+	return 1;
+}
+
 rct_map_element *map_get_first_element_at(int x, int y)
 {
 	if (x < 0 || y < 0 || x > 255 || y > 255)
@@ -157,24 +190,59 @@ void map_element_set_terrain_edge(rct_map_element *element, int terrain)
 	element->properties.surface.slope |= (terrain & 7) << 5;
 }
 
+// Per-tile index of each tile's surface element, so surface lookups are one
+// array load instead of a walk down the tile's element chain. Filled lazily
+// under the same generation scheme as the height cache below; anything that
+// can move elements around the arena (insert, remove, reorganise, an applied
+// game command) drops the whole index in O(1) by bumping the generation.
+static rct_map_element *_tileSurfaceCache[MAX_TILE_MAP_ELEMENT_POINTERS];
+static uint32 _tileSurfaceCacheGeneration[MAX_TILE_MAP_ELEMENT_POINTERS];
+static uint32 _tileSurfaceGeneration = 1;
+
+/**
+ * Drops every cached surface element pointer. Called whenever map elements
+ * may have moved in the arena, not just changed in place.
+ */
+void map_surface_element_cache_invalidate()
+{
+	_tileSurfaceGeneration++;
+}
+
 rct_map_element *map_get_surface_element_at(int x, int y)
 {
-	rct_map_element *mapElement = map_get_first_element_at(x, y);
+	int tileIndex = (y * 256) + x;
+	rct_map_element *mapElement;
+
+	if (_tileSurfaceCacheGeneration[tileIndex] == _tileSurfaceGeneration)
+		return _tileSurfaceCache[tileIndex];
+
+	mapElement = map_get_first_element_at(x, y);
 
 	// Find the first surface element
 	while (map_element_get_type(mapElement) != MAP_ELEMENT_TYPE_SURFACE) {
-		if (map_element_is_last_for_tile(mapElement))
-			return NULL;
+		if (map_element_is_last_for_tile(mapElement)) {
+			mapElement = NULL;
+			break;
+		}
 
 		mapElement++;
 	}
 
+	_tileSurfaceCache[tileIndex] = mapElement;
+	_tileSurfaceCacheGeneration[tileIndex] = _tileSurfaceGeneration;
 	return mapElement;
 }
 
 /**
  * 
  *  rct2: 0x0068AB4C
+ *
+ * The world is hard capped at 256x256 tiles: the tile pointer table and the
+ * element arena are fixed size structures at fixed addresses that the
+ * original exe routines (paint, pathfinding, vehicle updates) index
+ * directly. Replacing them with a native store that could grow or chunk the
+ * map is only possible once no exe code touches map memory, so any such
+ * change has to wait until the remaining map consumers are reimplemented.
  */
 void map_init(int size)
 {
@@ -203,6 +271,7 @@ void map_init(int size)
 	RCT2_GLOBAL(RCT2_ADDRESS_GRASS_SCENERY_TILEPOS, sint16) = 0;
 	_sub_6A876D_save_x = 0;
 	_sub_6A876D_save_y = 0;
+	park_size_invalidate();
 	RCT2_GLOBAL(0x01358830, sint16) = size * 32 - 32;
 	RCT2_GLOBAL(RCT2_ADDRESS_MAP_MAXIMUM_X_Y, sint16) = size * 32 - 2;
 	RCT2_GLOBAL(RCT2_ADDRESS_MAP_SIZE, sint16) = size;
@@ -236,6 +305,30 @@ void map_update_tile_pointers()
 
 	// Possible next free map element
 	RCT2_GLOBAL(0x0140E9A4, rct_map_element*) = mapElement;
+
+	map_element_height_invalidate_cache();
+	map_surface_element_cache_invalidate();
+	map_ownership_bitmaps_invalidate();
+	viewport_tile_paint_cache_reset();
+	map_grass_stable_reset();
+}
+
+// Per-tile cache of the surface fields map_element_height needs, so the hot
+// path is a single array read instead of a tile element list walk. Entries
+// are filled lazily and stamped with a generation number; bumping the
+// generation invalidates the whole cache in O(1). Packed value is
+// water height (bits 16-23), slope byte (bits 8-15), base height (bits 0-7).
+static uint32 _tileHeightCache[MAX_TILE_MAP_ELEMENT_POINTERS];
+static uint32 _tileHeightCacheGeneration[MAX_TILE_MAP_ELEMENT_POINTERS];
+static uint32 _tileHeightGeneration = 1;
+
+/**
+ * Drops every cached surface height. Called whenever the terrain may have
+ * changed, e.g. after an applied game command or a map load.
+ */
+void map_element_height_invalidate_cache()
+{
+	_tileHeightGeneration++;
 }
 
 /**
@@ -249,6 +342,7 @@ void map_update_tile_pointers()
 int map_element_height(int x, int y)
 {
 	rct_map_element *mapElement;
+	uint32 surface;
 
 	// Off the map
 	if (x >= 8192 || y >= 8192)
@@ -258,14 +352,23 @@ int map_element_height(int x, int y)
 	int x_tile = x & 0xFFFFFFE0;
 	int y_tile = y & 0xFFFFFFE0;
 
-	// Get the surface element for the tile
-	mapElement = map_get_surface_element_at(x_tile / 32, y_tile / 32);
+	// Get the surface fields for the tile, from the cache when possible
+	int tileIndex = ((y_tile / 32) * 256) + (x_tile / 32);
+	if (_tileHeightCacheGeneration[tileIndex] == _tileHeightGeneration) {
+		surface = _tileHeightCache[tileIndex];
+	} else {
+		mapElement = map_get_surface_element_at(x_tile / 32, y_tile / 32);
+		surface =
+			((mapElement->properties.surface.terrain & MAP_ELEMENT_WATER_HEIGHT_MASK) << 16) |
+			(mapElement->properties.surface.slope << 8) |
+			mapElement->base_height;
+		_tileHeightCache[tileIndex] = surface;
+		_tileHeightCacheGeneration[tileIndex] = _tileHeightGeneration;
+	}
 
-	uint32 height =
-		((mapElement->properties.surface.terrain & MAP_ELEMENT_WATER_HEIGHT_MASK) << 20) |
-		(mapElement->base_height << 3);
+	uint32 height = ((surface & 0x00FF0000) << 4) | ((surface & 0xFF) << 3);
 
-	uint32 slope = (mapElement->properties.surface.slope & MAP_ELEMENT_SLOPE_MASK);
+	uint32 slope = ((surface >> 8) & MAP_ELEMENT_SLOPE_MASK);
 	uint8 extra_height = (slope & 0x10) >> 4; // 0x10 is the 5th bit - sets slope to double height
 	// Remove the extra height bit
 	slope &= 0xF;
@@ -382,25 +485,13 @@ int map_element_height(int x, int y)
 }
 
 /**
- *
- *  rct2: 0x0068B089
+ * Slides one tile's element chain down over any free slots directly below it,
+ * keeping the arena compact. Returns whether any elements moved.
  */
-void sub_68B089()
+static bool map_element_compact_tile(int i)
 {
-	int i;
 	rct_map_element *mapElementFirst, *mapElement;
 
-	if (RCT2_GLOBAL(0x009DEA6F, uint8) & 1)
-		return;
-
-	i = RCT2_GLOBAL(0x0010E63B8, uint32);
-	do {
-		i++;
-		if (i >= MAX_TILE_MAP_ELEMENT_POINTERS)
-			i = 0;
-	} while (TILE_MAP_ELEMENT_POINTER(i) == TILE_UNDEFINED_MAP_ELEMENT);
-	RCT2_GLOBAL(0x0010E63B8, uint32) = i;
-
 	mapElementFirst = mapElement = TILE_MAP_ELEMENT_POINTER(i);
 	do {
 		mapElement--;
@@ -410,9 +501,9 @@ void sub_68B089()
 	mapElement++;
 
 	if (mapElement == mapElementFirst)
-		return;
+		return false;
 
-	// 
+	//
 	TILE_MAP_ELEMENT_POINTER(i) = mapElement;
 	do {
 		*mapElement = *mapElementFirst;
@@ -429,6 +520,37 @@ void sub_68B089()
 	} while (mapElement->base_height == 255);
 	mapElement++;
 	RCT2_GLOBAL(0x0140E9A4, rct_map_element*) = mapElement;
+	return true;
+}
+
+/**
+ * Background compaction of the map element arena.
+ *
+ *  rct2: 0x0068B089
+ */
+void sub_68B089()
+{
+	int i, visited, compacted;
+
+	if (RCT2_GLOBAL(0x009DEA6F, uint8) & 1)
+		return;
+
+	// Compact a budget of tiles per tick rather than the single tile the
+	// original did; fragmentation from construction is reclaimed quickly
+	// without a noticeable cost on the tick.
+	compacted = 0;
+	i = RCT2_GLOBAL(0x0010E63B8, uint32);
+	for (visited = 0; visited < 128 && compacted < 8; visited++) {
+		do {
+			i++;
+			if (i >= MAX_TILE_MAP_ELEMENT_POINTERS)
+				i = 0;
+		} while (TILE_MAP_ELEMENT_POINTER(i) == TILE_UNDEFINED_MAP_ELEMENT);
+
+		if (map_element_compact_tile(i))
+			compacted++;
+	}
+	RCT2_GLOBAL(0x0010E63B8, uint32) = i;
 }
 
 
@@ -464,23 +586,71 @@ int map_coord_is_connected(int x, int y, int z, uint8 faceDirection)
 	return 0;
 }
 
+// Dirty queue for path wide flag recomputation. Path edits enqueue their tile
+// here so the flags around the edit are recomputed on the next update rather
+// than whenever the background sweep happens to revisit them, which on a large
+// park can take many seconds.
+#define PATH_WIDE_FLAG_QUEUE_SIZE 64
+
+static rct_xy16 _pathWideFlagQueue[PATH_WIDE_FLAG_QUEUE_SIZE];
+static int _pathWideFlagQueueHead = 0;
+static int _pathWideFlagQueueLength = 0;
+
+void map_path_wide_flags_invalidate(int x, int y)
+{
+	int index;
+
+	// Oldest entries are dropped on overflow; the background sweep eventually
+	// repairs any tile that falls out
+	if (_pathWideFlagQueueLength == PATH_WIDE_FLAG_QUEUE_SIZE) {
+		_pathWideFlagQueueHead = (_pathWideFlagQueueHead + 1) % PATH_WIDE_FLAG_QUEUE_SIZE;
+		_pathWideFlagQueueLength--;
+	}
+	index = (_pathWideFlagQueueHead + _pathWideFlagQueueLength) % PATH_WIDE_FLAG_QUEUE_SIZE;
+	_pathWideFlagQueue[index].x = x;
+	_pathWideFlagQueue[index].y = y;
+	_pathWideFlagQueueLength++;
+}
+
 /**
  *
  *  rct2: 0x006A876D
  */
 void sub_6A876D()
 {
-	int i, x, y;
+	int i, x, y, editX, editY;
 
 	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & (SCREEN_FLAGS_TRACK_DESIGNER | SCREEN_FLAGS_TRACK_MANAGER))
 		return;
 
+	// Recompute the flags around recent path edits first. A tile's wide flag
+	// reads its neighbours and an edit also rewrites the connecting edges of
+	// its neighbours, so everything within two tiles of the edit is covered.
+	// At most 8 edits are processed per update to bound the cost of large
+	// path tool drags.
+	for (i = 0; i < 8 && _pathWideFlagQueueLength > 0; i++) {
+		editX = _pathWideFlagQueue[_pathWideFlagQueueHead].x;
+		editY = _pathWideFlagQueue[_pathWideFlagQueueHead].y;
+		_pathWideFlagQueueHead = (_pathWideFlagQueueHead + 1) % PATH_WIDE_FLAG_QUEUE_SIZE;
+		_pathWideFlagQueueLength--;
+
+		for (x = editX - 64; x <= editX + 64; x += 32) {
+			for (y = editY - 64; y <= editY + 64; y += 32) {
+				if (x < 0 || y < 0 || x >= 8192 || y >= 8192)
+					continue;
+				sub_6A87BB(x, y);
+			}
+		}
+	}
+
 	// Presumebly sub_6A87BB is too computationally expensive to call for every
 	// tile every update, so word_13CE774 and word_13CE776 store the x and y
-	// progress. A maximum of 128 calls is done per update.
+	// progress. Edits recompute their surroundings through the queue above, so
+	// the sweep is only a safety net for original code paths that modify paths
+	// without enqueueing and has been slowed from 128 calls per update to 16.
 	x = _sub_6A876D_save_x;
 	y = _sub_6A876D_save_y;
-	for (i = 0; i < 128; i++) {
+	for (i = 0; i < 16; i++) {
 		sub_6A87BB(x, y);
 
 		// Next x, y tile
@@ -527,6 +697,41 @@ int map_height_from_slope(int x, int y, int slope)
 	return 0;
 }
 
+// Ownership state mirrored into packed per-row bitmaps, one bit per tile
+// (eight words per map row), so the location permission checks hit from
+// guest decision loops and construction validation are bit tests instead of
+// surface element reads, and region queries can test a whole row of tiles
+// per word. Rebuilt lazily after anything that may have edited ownership.
+static uint32 _ownershipOwnedBitmap[256 * 8];
+static uint32 _ownershipConstructionBitmap[256 * 8];
+static bool _ownershipBitmapsValid = false;
+
+void map_ownership_bitmaps_invalidate()
+{
+	_ownershipBitmapsValid = false;
+}
+
+static void map_ownership_bitmaps_rebuild()
+{
+	int x, y;
+	rct_map_element *mapElement;
+
+	memset(_ownershipOwnedBitmap, 0, sizeof(_ownershipOwnedBitmap));
+	memset(_ownershipConstructionBitmap, 0, sizeof(_ownershipConstructionBitmap));
+	for (y = 0; y < 256; y++) {
+		for (x = 0; x < 256; x++) {
+			mapElement = map_get_surface_element_at(x, y);
+			if (mapElement == NULL)
+				continue;
+			if (mapElement->properties.surface.ownership & OWNERSHIP_OWNED)
+				_ownershipOwnedBitmap[(y * 8) + (x >> 5)] |= (1u << (x & 31));
+			if (mapElement->properties.surface.ownership & OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED)
+				_ownershipConstructionBitmap[(y * 8) + (x >> 5)] |= (1u << (x & 31));
+		}
+	}
+	_ownershipBitmapsValid = true;
+}
+
 /**
  *
  *  rct2: 0x00664F72
@@ -534,13 +739,21 @@ int map_height_from_slope(int x, int y, int slope)
 int map_is_location_owned(int x, int y, int z)
 {
 	rct_map_element *mapElement;
+	int tileX, tileY;
 
 	if (x < (256 * 32) && y < (256 * 32)) {
-		mapElement = map_get_surface_element_at(x / 32, y / 32);
-		if (mapElement->properties.surface.ownership & OWNERSHIP_OWNED)
+		if (!_ownershipBitmapsValid)
+			map_ownership_bitmaps_rebuild();
+
+		tileX = x / 32;
+		tileY = y / 32;
+		if (_ownershipOwnedBitmap[(tileY * 8) + (tileX >> 5)] & (1u << (tileX & 31)))
 			return 1;
 
-		if (mapElement->properties.surface.ownership & OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED) {
+		if (_ownershipConstructionBitmap[(tileY * 8) + (tileX >> 5)] & (1u << (tileX & 31))) {
+			// Construction rights still depend on the height band, which
+			// needs the surface element
+			mapElement = map_get_surface_element_at(tileX, tileY);
 			z /= 8;
 			if (z < mapElement->base_height || z - 2 > mapElement->base_height)
 				return 1;
@@ -557,11 +770,15 @@ int map_is_location_owned(int x, int y, int z)
  */
 int map_is_location_in_park(int x, int y)
 {
-	rct_map_element *mapElement;
+	int tileX, tileY;
 
 	if (x < (256 * 32) && y < (256 * 32)) {
-		mapElement = map_get_surface_element_at(x / 32, y / 32);
-		if (mapElement->properties.surface.ownership & OWNERSHIP_OWNED)
+		if (!_ownershipBitmapsValid)
+			map_ownership_bitmaps_rebuild();
+
+		tileX = x / 32;
+		tileY = y / 32;
+		if (_ownershipOwnedBitmap[(tileY * 8) + (tileX >> 5)] & (1u << (tileX & 31)))
 			return 1;
 	}
 
@@ -569,6 +786,174 @@ int map_is_location_in_park(int x, int y)
 	return 0;
 }
 
+/**
+ * Returns whether every tile of the region, in units inclusive, is owned
+ * park land. Each map row of the region costs at most eight word tests, so
+ * drag selections can validate the whole rectangle up front instead of tile
+ * by tile.
+ */
+int map_region_is_in_park(int x0, int y0, int x1, int y1)
+{
+	int tileX0 = x0 / 32, tileY0 = y0 / 32;
+	int tileX1 = x1 / 32, tileY1 = y1 / 32;
+	int y, i, firstWord, lastWord;
+	uint32 mask;
+
+	if (x0 < 0 || y0 < 0 || x1 >= (256 * 32) || y1 >= (256 * 32) || x0 > x1 || y0 > y1)
+		return 0;
+	if (!_ownershipBitmapsValid)
+		map_ownership_bitmaps_rebuild();
+
+	firstWord = tileX0 >> 5;
+	lastWord = tileX1 >> 5;
+	for (y = tileY0; y <= tileY1; y++) {
+		for (i = firstWord; i <= lastWord; i++) {
+			mask = 0xFFFFFFFF;
+			if (i == firstWord)
+				mask &= 0xFFFFFFFF << (tileX0 & 31);
+			if (i == lastWord)
+				mask &= 0xFFFFFFFF >> (31 - (tileX1 & 31));
+			if ((_ownershipOwnedBitmap[(y * 8) + i] & mask) != mask)
+				return 0;
+		}
+	}
+	return 1;
+}
+
+// Batched tile invalidation. Bulk operations such as surface changes over a
+// selection invalidate every affected tile individually, projecting each one
+// to screen coordinates and pushing many overlapping dirty rects. Between
+// map_invalidate_tile_batch_begin and map_invalidate_tile_batch_end the tiles
+// are merged into a single world space bounding box instead, which is
+// projected and pushed to the viewports once. Batches may nest.
+static int _tileInvalidationBatchDepth = 0;
+static bool _tileInvalidationBatchEmpty;
+static int _tileInvalidationBatchX0, _tileInvalidationBatchY0;
+static int _tileInvalidationBatchX1, _tileInvalidationBatchY1;
+static int _tileInvalidationBatchZ0, _tileInvalidationBatchZ1;
+
+/**
+ * Invalidates a world space box on every viewport it is visible in. Works the
+ * same way as the per tile original at 0x006ECB60, but projects the four
+ * corners of the box so an arbitrarily large region costs one rect.
+ */
+static void map_invalidate_region(int x0, int y0, int x1, int y1, int zLow, int zHigh)
+{
+	int i, x, y, rx, ry, left, top, right, bottom;
+	int viewLeft, viewTop, viewRight, viewBottom;
+	rct_window *w;
+	rct_viewport *viewport;
+
+	x0 += 16;
+	y0 += 16;
+	x1 += 16;
+	y1 += 16;
+
+	left = top = right = bottom = 0;
+	for (i = 0; i < 4; i++) {
+		x = (i & 1) ? x1 : x0;
+		y = (i & 2) ? y1 : y0;
+		switch (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_ROTATION, uint32)) {
+		default:
+		case 0:
+			rx = y - x;
+			ry = (y + x) / 2;
+			break;
+		case 1:
+			rx = -y - x;
+			ry = (y - x) / 2;
+			break;
+		case 2:
+			rx = x - y;
+			ry = (-y - x) / 2;
+			break;
+		case 3:
+			rx = x + y;
+			ry = (x - y) / 2;
+			break;
+		}
+		if (i == 0) {
+			left = right = rx;
+			top = bottom = ry;
+		} else {
+			left = min(left, rx);
+			right = max(right, rx);
+			top = min(top, ry);
+			bottom = max(bottom, ry);
+		}
+	}
+	left -= 32;
+	right += 32;
+	top -= 32 + zHigh;
+	bottom += 32 - zLow;
+
+	for (w = g_window_list; w < RCT2_GLOBAL(RCT2_ADDRESS_NEW_WINDOW_PTR, rct_window*); w++) {
+		viewport = w->viewport;
+		if (viewport == NULL)
+			continue;
+		if (right <= viewport->view_x || bottom <= viewport->view_y)
+			continue;
+		if (left >= viewport->view_x + viewport->view_width)
+			continue;
+		if (top >= viewport->view_y + viewport->view_height)
+			continue;
+
+		viewLeft = max(left, viewport->view_x);
+		viewTop = max(top, viewport->view_y);
+		viewRight = min(right, viewport->view_x + viewport->view_width);
+		viewBottom = min(bottom, viewport->view_y + viewport->view_height);
+		gfx_set_dirty_blocks(
+			viewport->x + ((viewLeft - viewport->view_x) >> viewport->zoom),
+			viewport->y + ((viewTop - viewport->view_y) >> viewport->zoom),
+			viewport->x + ((viewRight - viewport->view_x) >> viewport->zoom),
+			viewport->y + ((viewBottom - viewport->view_y) >> viewport->zoom)
+		);
+	}
+}
+
+static void map_invalidate_tile_batch_add(int x, int y, int zLow, int zHigh)
+{
+	if (_tileInvalidationBatchEmpty) {
+		_tileInvalidationBatchEmpty = false;
+		_tileInvalidationBatchX0 = x;
+		_tileInvalidationBatchY0 = y;
+		_tileInvalidationBatchX1 = x;
+		_tileInvalidationBatchY1 = y;
+		_tileInvalidationBatchZ0 = zLow;
+		_tileInvalidationBatchZ1 = zHigh;
+	} else {
+		_tileInvalidationBatchX0 = min(_tileInvalidationBatchX0, x);
+		_tileInvalidationBatchY0 = min(_tileInvalidationBatchY0, y);
+		_tileInvalidationBatchX1 = max(_tileInvalidationBatchX1, x);
+		_tileInvalidationBatchY1 = max(_tileInvalidationBatchY1, y);
+		_tileInvalidationBatchZ0 = min(_tileInvalidationBatchZ0, zLow);
+		_tileInvalidationBatchZ1 = max(_tileInvalidationBatchZ1, zHigh);
+	}
+}
+
+void map_invalidate_tile_batch_begin()
+{
+	if (_tileInvalidationBatchDepth == 0)
+		_tileInvalidationBatchEmpty = true;
+	_tileInvalidationBatchDepth++;
+}
+
+void map_invalidate_tile_batch_end()
+{
+	_tileInvalidationBatchDepth--;
+	if (_tileInvalidationBatchDepth > 0 || _tileInvalidationBatchEmpty)
+		return;
+
+	map_invalidate_region(
+		_tileInvalidationBatchX0,
+		_tileInvalidationBatchY0,
+		_tileInvalidationBatchX1,
+		_tileInvalidationBatchY1,
+		_tileInvalidationBatchZ0,
+		_tileInvalidationBatchZ1
+	);
+}
+
 /**
  *
  *  rct2: 0x006ECB60
@@ -576,6 +961,13 @@ int map_is_location_in_park(int x, int y)
  */
 void map_invalidate_tile(int x, int y, int zLow, int zHigh)
 {
+	window_map_invalidate_map_image();
+	viewport_tile_paint_cache_invalidate(x >> 5, y >> 5);
+	map_grass_stable_invalidate(x >> 5, y >> 5);
+	if (_tileInvalidationBatchDepth > 0) {
+		map_invalidate_tile_batch_add(x, y, zLow, zHigh);
+		return;
+	}
 	RCT2_CALLPROC_X(0x006ECB60, x, 0, y, 0, zHigh, zLow, 0);
 }
 
@@ -1272,12 +1664,17 @@ money32 map_change_surface_style(int x0, int y0, int x1, int y1, uint8 surface_s
 		return cur_cost;
 	}
 
+	// If the whole selection is owned park land the per tile ownership test
+	// is settled up front with a few word tests
+	int regionInPark = map_region_is_in_park(x0, y0, x1, y1);
+
+	map_invalidate_tile_batch_begin();
 	for (int x = x0; x <= x1; x += 32){
 		for (int y = y0; y <= y1; y += 32){
 			if (x > 0x1FFF)continue;
 			if (y > 0x1FFF)continue;
 
-			if (!(RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_SCENARIO_EDITOR)){
+			if (!regionInPark && !(RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & SCREEN_FLAGS_SCENARIO_EDITOR)){
 				if (!map_is_location_in_park(x, y))continue;
 			}
 			
@@ -1339,6 +1736,7 @@ money32 map_change_surface_style(int x0, int y0, int x1, int y1, uint8 surface_s
 			}
 		}
 	}
+	map_invalidate_tile_batch_end();
 
 	cur_cost *= 100;
 
@@ -1784,6 +2182,14 @@ void game_command_place_banner(int* eax, int* ebx, int* ecx, int* edx, int* esi,
  */
 void map_invalidate_tile_full(int x, int y)
 {
+	window_map_invalidate_map_image();
+	viewport_tile_paint_cache_invalidate(x >> 5, y >> 5);
+	map_grass_stable_invalidate(x >> 5, y >> 5);
+	if (_tileInvalidationBatchDepth > 0) {
+		// Merge as the full height column the original routine covers
+		map_invalidate_tile_batch_add(x, y, 0, 2080);
+		return;
+	}
 	RCT2_CALLPROC_X(0x006EC6D7, x, 0, y, 0, 0, 0, 0);
 }
 
@@ -1798,7 +2204,24 @@ int map_get_station(rct_map_element *mapElement)
  */
 void map_element_remove(rct_map_element *mapElement)
 {
-	RCT2_CALLPROC_X(0x0068B280, 0, 0, 0, 0, (int)mapElement, 0, 0);
+	// Replace the removed element with the elements above it so the tile's
+	// chain stays contiguous, then mark the vacated top slot as free
+	if (!map_element_is_last_for_tile(mapElement)) {
+		do {
+			*mapElement = *(mapElement + 1);
+		} while (!map_element_is_last_for_tile(++mapElement));
+	} else {
+		// The element below inherits the last-for-tile flag
+		(mapElement - 1)->flags |= MAP_ELEMENT_FLAG_LAST_TILE;
+	}
+	mapElement->base_height = 255;
+
+	if ((mapElement + 1) == RCT2_GLOBAL(0x0140E9A4, rct_map_element*))
+		RCT2_GLOBAL(0x0140E9A4, rct_map_element*) = mapElement;
+
+	// The tile's elements shifted down a slot; only the element pointer is
+	// known here, not the tile, so drop the whole surface index
+	map_surface_element_cache_invalidate();
 }
 
 /**
@@ -1855,8 +2278,10 @@ void map_invalidate_map_selection_tiles()
 	if (!(RCT2_GLOBAL(RCT2_ADDRESS_MAP_SELECTION_FLAGS, uint16) & (1 << 1)))
 		return;
 
+	map_invalidate_tile_batch_begin();
 	for (position = gMapSelectionTiles; position->x != -1; position++)
 		map_invalidate_tile_full(position->x, position->y);
+	map_invalidate_tile_batch_end();
 }
 
 /**
@@ -1875,9 +2300,11 @@ void map_invalidate_selection_rect()
 	x1 = RCT2_GLOBAL(RCT2_ADDRESS_MAP_SELECTION_B_X, uint16);
 	y1 = RCT2_GLOBAL(RCT2_ADDRESS_MAP_SELECTION_B_Y, uint16);
 
+	map_invalidate_tile_batch_begin();
 	for (x = x0; x <= x1; x++)
 		for (y = y0; y <= y1; y++)
 			map_invalidate_tile_full(x, y);
+	map_invalidate_tile_batch_end();
 }
 
 /**
@@ -1887,6 +2314,9 @@ void map_invalidate_selection_rect()
 void map_reorganise_elements()
 {
 	RCT2_CALLPROC_EBPSAFE(0x0068B111);
+
+	// Every element moved, so every cached surface pointer is stale
+	map_surface_element_cache_invalidate();
 }
 
 /**
@@ -1906,7 +2336,10 @@ rct_map_element *map_element_insert(int x, int y, int z, int flags)
 {
 	rct_map_element *originalMapElement, *newMapElement, *insertedElement;
 
+	// The free space check may reorganise the whole arena, and the insert
+	// itself moves the tile's chain to a new block
 	sub_68B044();
+	map_surface_element_cache_invalidate();
 
 	newMapElement = RCT2_GLOBAL(0x00140E9A4, rct_map_element*);
 	originalMapElement = TILE_MAP_ELEMENT_POINTER(y * 256 + x);
@@ -1971,6 +2404,69 @@ int map_can_construct_at(int x, int y, int zLow, int zHigh, uint8 bl)
 	return map_can_construct_with_clear_at(x, y, zLow, zHigh, (void*)0xFFFFFFFF, bl);
 }
 
+/**
+ * Quick read-only clearance test of a single tile against the height band
+ * [zLow, zHigh), in base_height units. Unlike map_can_construct_with_clear_at
+ * this cannot clear obstructions, charge costs or set error text; it only
+ * classifies what currently occupies the band. An obstruction is reported in
+ * preference to the surface verdicts; construction ghosts do not obstruct.
+ */
+int map_tile_get_clearance(int x, int y, int zLow, int zHigh)
+{
+	rct_map_element *mapElement;
+	int verdict = MAP_CLEARANCE_CLEAR;
+
+	mapElement = map_get_first_element_at(x / 32, y / 32);
+	do {
+		if (map_element_get_type(mapElement) == MAP_ELEMENT_TYPE_SURFACE) {
+			if (verdict != MAP_CLEARANCE_CLEAR)
+				continue;
+			int waterHeight = (mapElement->properties.surface.terrain & 0x1F) * 2;
+			if (zLow < mapElement->base_height)
+				verdict = MAP_CLEARANCE_UNDERGROUND;
+			else if (waterHeight != 0 && zLow < waterHeight)
+				verdict = MAP_CLEARANCE_UNDERWATER;
+			continue;
+		}
+		if (mapElement->base_height >= zHigh || mapElement->clearance_height <= zLow)
+			continue;
+		if (mapElement->flags & MAP_ELEMENT_FLAG_5)
+			continue;
+		return MAP_CLEARANCE_OBSTRUCTED;
+	} while (!map_element_is_last_for_tile(mapElement++));
+
+	return verdict;
+}
+
+/**
+ * Classifies every tile of a region against the height band [zLow, zHigh) in
+ * one pass, writing a verdict per tile into verdicts (x ascending within each
+ * row, verdicts may be NULL). Returns the number of clear tiles, or -1 when
+ * the region is degenerate or off the map. Placement previews over a dragged
+ * selection can use this instead of querying tile by tile, which walks each
+ * tile's element chain once per query.
+ */
+int map_region_get_clearance(int x0, int y0, int x1, int y1, int zLow, int zHigh, uint8 *verdicts)
+{
+	int x, y, numClear;
+	uint8 verdict;
+
+	if (x0 < 0 || y0 < 0 || x1 >= (256 * 32) || y1 >= (256 * 32) || x0 > x1 || y0 > y1)
+		return -1;
+
+	numClear = 0;
+	for (y = y0; y <= y1; y += 32) {
+		for (x = x0; x <= x1; x += 32) {
+			verdict = map_tile_get_clearance(x, y, zLow, zHigh);
+			if (verdict == MAP_CLEARANCE_CLEAR)
+				numClear++;
+			if (verdicts != NULL)
+				*verdicts++ = verdict;
+		}
+	}
+	return numClear;
+}
+
 /**
  *
  *  rct2: 0x006BA278
@@ -2021,6 +2517,31 @@ void map_remove_intersecting_walls(int x, int y, int z0, int z1, int direction)
 	} while (!map_element_is_last_for_tile(mapElement++));
 }
 
+// Most tiles visited by the grass sweep cannot change: the terrain is not
+// grass, the grass is fully grown, or the tile is underwater or outside the
+// park and already cleared. Those outcomes are remembered per tile so the
+// sweep skips straight past them; a tile goes active again whenever its
+// grass length is set (mowing, clearing) or the tile is invalidated for any
+// reason (terrain, water, ownership and construction changes all invalidate).
+// A full timing wheel was considered, but the sweep also drives scenery
+// aging and fountains and its visit order feeds the scenario random stream,
+// so the cadence has to stay; skipping stable tiles keeps the stream intact
+// because stable tiles never consume randomness.
+static uint8 _grassStableMap[256 * 256];
+
+static void map_grass_stable_invalidate(int x, int y)
+{
+	if (x < 0 || x >= 256 || y < 0 || y >= 256)
+		return;
+
+	_grassStableMap[(y * 256) + x] = 0;
+}
+
+static void map_grass_stable_reset()
+{
+	memset(_grassStableMap, 0, sizeof(_grassStableMap));
+}
+
 /**
  * Updates grass length, scenery age and jumping fountains.
  *
@@ -2047,7 +2568,8 @@ void map_update_tiles()
 
 		rct_map_element *mapElement = map_get_surface_element_at(x, y);
 		if (mapElement != NULL) {
-			map_update_grass_length(x * 32, y * 32, mapElement);
+			if (!_grassStableMap[(y * 256) + x])
+				map_update_grass_length(x * 32, y * 32, mapElement);
 			scenery_update_tile(x * 32, y * 32);
 		}
 
@@ -2063,8 +2585,10 @@ void map_update_tiles()
 static void map_update_grass_length(int x, int y, rct_map_element *mapElement)
 {
 	// Check if tile is grass
-	if ((mapElement->properties.surface.terrain & 0xE0) && !(mapElement->type & 3))
+	if ((mapElement->properties.surface.terrain & 0xE0) && !(mapElement->type & 3)) {
+		_grassStableMap[((y >> 5) * 256) + (x >> 5)] = 1;
 		return;
+	}
 
 	int grassLength = mapElement->properties.surface.grass_length & 7;
 
@@ -2073,13 +2597,17 @@ static void map_update_grass_length(int x, int y, rct_map_element *mapElement)
 	if (waterHeight > mapElement->base_height || !map_is_location_in_park(x, y)) {
 		if (grassLength != GRASS_LENGTH_CLEAR_0)
 			map_set_grass_length(x, y, mapElement, GRASS_LENGTH_CLEAR_0);
+		else
+			_grassStableMap[((y >> 5) * 256) + (x >> 5)] = 1;
 
 		return;
 	}
 
 	// Grass can't grow any further
-	if (grassLength == GRASS_LENGTH_CLUMPS_2)
+	if (grassLength == GRASS_LENGTH_CLUMPS_2) {
+		_grassStableMap[((y >> 5) * 256) + (x >> 5)] = 1;
 		return;
+	}
 
 	int z0 = mapElement->base_height;
 	int z1 = mapElement->base_height + 2;
@@ -2121,6 +2649,7 @@ static void map_set_grass_length(int x, int y, rct_map_element *mapElement, int
 {
 	int z0, z1;
 
+	map_grass_stable_invalidate(x >> 5, y >> 5);
 	mapElement->properties.surface.grass_length = length;
 	z0 = mapElement->base_height * 8;
 	z1 = z0 + 16;
@@ -254,14 +254,21 @@ void map_element_set_terrain(rct_map_element *element, int terrain);
 void map_element_set_terrain_edge(rct_map_element *element, int terrain);
 int map_height_from_slope(int x, int y, int slope);
 rct_map_element *map_get_surface_element_at(int x, int y);
+void map_surface_element_cache_invalidate();
 int map_element_height(int x, int y);
+void map_element_height_invalidate_cache();
 void sub_68B089();
 int map_coord_is_connected(int x, int y, int z, uint8 faceDirection);
 void sub_6A876D();
+void map_path_wide_flags_invalidate(int x, int y);
 int map_is_location_owned(int x, int y, int z);
 int map_is_location_in_park(int x, int y);
+int map_region_is_in_park(int x0, int y0, int x1, int y1);
+void map_ownership_bitmaps_invalidate();
 void map_invalidate_tile(int x, int y, int zLow, int zHigh);
 void map_invalidate_tile_full(int x, int y);
+void map_invalidate_tile_batch_begin();
+void map_invalidate_tile_batch_end();
 int map_get_station(rct_map_element *mapElement);
 void map_element_remove(rct_map_element *mapElement);
 void sub_6A6AA7(int x, int y, rct_map_element *mapElement);
@@ -273,6 +280,17 @@ int sub_68B044();
 rct_map_element *map_element_insert(int x, int y, int z, int flags);
 int map_can_construct_with_clear_at(int x, int y, int zLow, int zHigh, void *clearFunc, uint8 bl);
 int map_can_construct_at(int x, int y, int zLow, int zHigh, uint8 bl);
+
+// Verdicts returned by the read-only clearance queries
+enum {
+	MAP_CLEARANCE_CLEAR = 0,
+	MAP_CLEARANCE_UNDERGROUND,	// the band starts below the surface
+	MAP_CLEARANCE_UNDERWATER,	// the band starts below the water surface
+	MAP_CLEARANCE_OBSTRUCTED	// another element intersects the band
+};
+
+int map_tile_get_clearance(int x, int y, int zLow, int zHigh);
+int map_region_get_clearance(int x0, int y0, int x1, int y1, int zLow, int zHigh, uint8 *verdicts);
 int sub_6BA278(int ebx);
 
 void game_command_remove_scenery(int* eax, int* ebx, int* ecx, int* edx, int* esi, int* edi, int* ebp);
@@ -304,6 +322,21 @@ void map_element_iterator_begin(map_element_iterator *it);
 int map_element_iterator_next(map_element_iterator *it);
 void map_element_iterator_restart_for_tile(map_element_iterator *it);
 
+// Yields the contiguous element span of one tile at a time so whole-map
+// consumers can run a tight loop over [first, last] instead of paying the
+// per-element iterator call. Spans are only valid while no elements are
+// inserted or removed; structural passes should keep using
+// map_element_iterator.
+typedef struct {
+	int x;
+	int y;
+	rct_map_element *first;
+	rct_map_element *last;
+} map_tile_span_iterator;
+
+void map_tile_span_iterator_begin(map_tile_span_iterator *it);
+int map_tile_span_iterator_next(map_tile_span_iterator *it);
+
 void map_remove_intersecting_walls(int x, int y, int z0, int z1, int direction);
 void map_update_tiles();
 
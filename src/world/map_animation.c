@@ -19,6 +19,8 @@
  *****************************************************************************/
 
 #include "../addresses.h"
+#include "../interface/viewport.h"
+#include "../interface/window.h"
 #include "../ride/ride.h"
 #include "../ride/ride_data.h"
 #include "../ride/track.h"
@@ -69,15 +71,107 @@ void map_animation_create(int type, int x, int y, int z)
 	aobj->baseZ = z;
 }
 
+// More than enough for every window to have a viewport
+#define MAX_VIEWPORT_RECTS 16
+
+typedef struct {
+	sint16 left, top, right, bottom;
+} viewport_rect;
+
+/**
+ * Gathers the view rects, in viewport coordinates, of every open viewport.
+ * Returns the number of rects written.
+ */
+static int map_animation_get_viewport_rects(viewport_rect *rects, int maxRects)
+{
+	rct_window *w;
+	rct_viewport *viewport;
+	int count = 0;
+
+	for (w = g_window_list; w < RCT2_GLOBAL(RCT2_ADDRESS_NEW_WINDOW_PTR, rct_window*); w++) {
+		viewport = w->viewport;
+		if (viewport == NULL || viewport->width == 0)
+			continue;
+		if (count == maxRects)
+			break;
+
+		rects[count].left = viewport->view_x;
+		rects[count].top = viewport->view_y;
+		rects[count].right = viewport->view_x + viewport->view_width;
+		rects[count].bottom = viewport->view_y + viewport->view_height;
+		count++;
+	}
+	return count;
+}
+
+/**
+ * Tests whether an animated tile can be seen by any open viewport. This is
+ * the inverse of the transform in viewport_coord_to_map_coord, padded a tile
+ * to the sides and generously at the bottom, as the handlers invalidate
+ * elements well above their base height.
+ */
+static bool map_animation_is_visible(rct_map_animation *aobj, const viewport_rect *rects, int numRects)
+{
+	sint16 x2d, y2d;
+	int i, x, y, z;
+
+	x = aobj->x + 16;
+	y = aobj->y + 16;
+	z = aobj->baseZ * 8;
+
+	switch (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_ROTATION, uint32)) {
+	case 0:
+		x2d = y - x;
+		y2d = ((y + x) / 2) - z;
+		break;
+	case 1:
+		x2d = -x - y;
+		y2d = ((y - x) / 2) - z;
+		break;
+	case 2:
+		x2d = x - y;
+		y2d = ((-y - x) / 2) - z;
+		break;
+	default:
+		x2d = x + y;
+		y2d = ((x - y) / 2) - z;
+		break;
+	}
+
+	for (i = 0; i < numRects; i++) {
+		if (x2d >= rects[i].left - 64 && x2d <= rects[i].right + 64 &&
+			y2d >= rects[i].top - 64 && y2d <= rects[i].bottom + 320
+		)
+			return true;
+	}
+	return false;
+}
+
 /**
  *
  *  rct2: 0x0068AFAD
  */
 void map_animation_invalidate_all()
 {
+	viewport_rect viewportRects[MAX_VIEWPORT_RECTS];
+	int numViewportRects;
+	bool fullSweep;
+	static uint8 _sweepCounter = 0;
+
+	// Animations that cannot be seen are normally skipped, but their handlers
+	// are also how dead animations (handler returns true) get removed, so
+	// every so often everything is processed regardless of visibility
+	fullSweep = (++_sweepCounter & 0x3F) == 0;
+	numViewportRects = map_animation_get_viewport_rects(viewportRects, countof(viewportRects));
+
 	rct_map_animation *aobj = &gAnimatedObjects[0];
 	int numAnimatedObjects = RCT2_GLOBAL(0x0138B580, uint16);
 	while (numAnimatedObjects > 0) {
+		if (!fullSweep && !map_animation_is_visible(aobj, viewportRects, numViewportRects)) {
+			numAnimatedObjects--;
+			aobj++;
+			continue;
+		}
 		if (map_animation_invalidate(aobj)) {
 			// Remove animated object
 			RCT2_GLOBAL(0x0138B580, uint16)--;
@@ -25,6 +25,7 @@
 #include <time.h>
 #include "../addresses.h"
 #include "../object.h"
+#include "../util/workerpool.h"
 #include "map.h"
 #include "map_helpers.h"
 #include "mapgen.h"
@@ -85,7 +86,9 @@ static void mapgen_blob(int cx, int cy, int size, int height);
 static void mapgen_smooth_height(int iterations);
 static void mapgen_set_height();
 
+static void noise_rand();
 static void mapgen_simplex();
+static void mapgen_simplex_strided(mapgen_settings *settings, int stride);
 
 static int _heightSize;
 static uint8 *_height;
@@ -109,6 +112,8 @@ void mapgen_generate_blank(mapgen_settings *settings)
 	int x, y;
 	rct_map_element *mapElement;
 
+	mapgen_progressive_cancel();
+
 	map_init(settings->mapSize);
 	for (y = 1; y < settings->mapSize - 1; y++) {
 		for (x = 1; x < settings->mapSize - 1; x++) {
@@ -128,6 +133,8 @@ void mapgen_generate(mapgen_settings *settings)
 	int x, y, mapSize, floorTexture, wallTexture, waterLevel;
 	rct_map_element *mapElement;
 
+	mapgen_progressive_cancel();
+
 	srand((unsigned int)time(NULL));
 
 	mapSize = settings->mapSize;
@@ -225,6 +232,152 @@ void mapgen_generate(mapgen_settings *settings)
 	map_reorganise_elements();
 }
 
+#pragma region Progressive generation
+
+// In-flight state for the progressive preview. A stride of zero means no
+// refinement is pending. The random choices (textures, smoothing iterations
+// and the noise permutation table) are made once up front so every pass
+// refines the same map rather than generating a new one.
+static mapgen_settings _progressiveSettings;
+static int _progressiveStride = 0;
+static int _progressiveFloorTexture;
+static int _progressiveWallTexture;
+static int _progressiveBeachTexture;
+static int _progressiveSmoothIterations;
+
+static void mapgen_progressive_pass()
+{
+	int x, y, mapSize, waterLevel;
+	rct_map_element *mapElement;
+
+	mapSize = _progressiveSettings.mapSize;
+	waterLevel = _progressiveSettings.waterLevel;
+
+	// Rebuild the base map so slope and beach changes from the previous pass
+	// do not accumulate into this one
+	map_init(mapSize);
+	for (y = 1; y < mapSize - 1; y++) {
+		for (x = 1; x < mapSize - 1; x++) {
+			mapElement = map_get_surface_element_at(x, y);
+			map_element_set_terrain(mapElement, _progressiveFloorTexture);
+			map_element_set_terrain_edge(mapElement, _progressiveWallTexture);
+			mapElement->base_height = _progressiveSettings.height;
+			mapElement->clearance_height = _progressiveSettings.height;
+		}
+	}
+
+	mapgen_simplex_strided(&_progressiveSettings, _progressiveStride);
+	mapgen_smooth_height(_progressiveSmoothIterations);
+	mapgen_set_height();
+
+	while (map_smooth(1, 1, mapSize - 1, mapSize - 1)) { }
+
+	mapgen_set_water_level(waterLevel);
+	for (y = 1; y < mapSize - 1; y++) {
+		for (x = 1; x < mapSize - 1; x++) {
+			mapElement = map_get_surface_element_at(x, y);
+			if (mapElement->base_height < waterLevel + 6)
+				map_element_set_terrain(mapElement, _progressiveBeachTexture);
+		}
+	}
+}
+
+/**
+ * Generates the same terrain as mapgen_generate, but the first pass samples
+ * the noise field at an eighth of the final resolution so a preview appears
+ * immediately. The remaining detail arrives through mapgen_progressive_update,
+ * converging on exactly the map a plain mapgen_generate would have produced.
+ */
+void mapgen_generate_progressive(mapgen_settings *settings)
+{
+	mapgen_progressive_cancel();
+
+	srand((unsigned int)time(NULL));
+
+	_progressiveSettings = *settings;
+	_progressiveFloorTexture = settings->floor;
+	_progressiveWallTexture = settings->wall;
+
+	if (_progressiveFloorTexture == -1)
+		_progressiveFloorTexture = BaseTerrain[rand() % countof(BaseTerrain)];
+
+	if (_progressiveWallTexture == -1) {
+		// Base edge type on surface type
+		switch (_progressiveFloorTexture) {
+		case TERRAIN_DIRT:
+			_progressiveWallTexture = TERRAIN_EDGE_WOOD_RED;
+			break;
+		case TERRAIN_ICE:
+			_progressiveWallTexture = TERRAIN_EDGE_ICE;
+			break;
+		default:
+			_progressiveWallTexture = TERRAIN_EDGE_ROCK;
+			break;
+		}
+	}
+
+	_progressiveBeachTexture = _progressiveFloorTexture;
+	if (settings->floor == -1 && _progressiveFloorTexture == TERRAIN_GRASS) {
+		switch (rand() % 4) {
+		case 0:
+			_progressiveBeachTexture = TERRAIN_SAND;
+			break;
+		case 1:
+			_progressiveBeachTexture = TERRAIN_SAND_LIGHT;
+			break;
+		}
+	}
+
+	noise_rand();
+	_progressiveSmoothIterations = 2 + (rand() % 6);
+
+	// The height map persists between passes as each one regenerates it in full
+	_heightSize = settings->mapSize * 2;
+	_height = (uint8*)malloc(_heightSize * _heightSize * sizeof(uint8));
+	memset(_height, 0, _heightSize * _heightSize * sizeof(uint8));
+
+	_progressiveStride = 8;
+	mapgen_progressive_pass();
+}
+
+/**
+ * Runs the next refinement pass if one is pending. Returns 1 if the map
+ * changed and should be redrawn.
+ */
+int mapgen_progressive_update()
+{
+	if (_progressiveStride == 0)
+		return 0;
+
+	_progressiveStride >>= 1;
+	mapgen_progressive_pass();
+
+	if (_progressiveStride == 1) {
+		// Full resolution reached; finish the same way mapgen_generate does
+		if (_progressiveSettings.trees != 0)
+			mapgen_place_trees();
+		map_reorganise_elements();
+		mapgen_progressive_cancel();
+	}
+	return 1;
+}
+
+/**
+ * Discards any pending refinement passes, leaving the map at whatever
+ * resolution the last pass produced.
+ */
+void mapgen_progressive_cancel()
+{
+	if (_progressiveStride == 0)
+		return;
+
+	_progressiveStride = 0;
+	free(_height);
+	_height = NULL;
+}
+
+#pragma endregion
+
 static void mapgen_place_tree(int type, int x, int y)
 {
 	int surfaceZ;
@@ -577,24 +730,34 @@ static void mapgen_blob(int cx, int cy, int size, int height)
 /**
  * Smooths the height map.
  */
+static void mapgen_smooth_height_row_job(void *context, int index)
+{
+	uint8 *copyHeight = (uint8*)context;
+	int x, xx, yy, avg;
+	int y = index + 1;
+
+	for (x = 1; x < _heightSize - 1; x++) {
+		avg = 0;
+		for (yy = -1; yy <= 1; yy++)
+			for (xx = -1; xx <= 1; xx++)
+				avg += copyHeight[(y + yy) * _heightSize + (x + xx)];
+		avg /= 9;
+		set_height(x, y, avg);
+	}
+}
+
 static void mapgen_smooth_height(int iterations)
 {
-	int i, x, y, xx, yy, avg;
+	int i;
 	int arraySize = _heightSize * _heightSize * sizeof(uint8);
 	uint8 *copyHeight = malloc(arraySize);
 
+	// Each pass reads from the copy and writes its own rows of the height
+	// map, so the rows within a pass are independent and can be dispatched
+	// to the worker pool.
 	for (i = 0; i < iterations; i++) {
 		memcpy(copyHeight, _height, arraySize);
-		for (y = 1; y < _heightSize - 1; y++) {
-			for (x = 1; x < _heightSize - 1; x++) {
-				avg = 0;
-				for (yy = -1; yy <= 1; yy++)
-					for (xx = -1; xx <= 1; xx++)
-						avg += copyHeight[(y + yy) * _heightSize + (x + xx)];
-				avg /= 9;
-				set_height(x, y, avg);
-			}
-		}
+		worker_pool_run(mapgen_smooth_height_row_job, copyHeight, _heightSize - 2);
 	}
 
 	free(copyHeight);
@@ -755,25 +918,78 @@ static float grad(int hash, float x, float y)
 	return ((h & 1) != 0 ? -u : u) + ((h & 2) != 0 ? -2.0f * v : 2.0f * v);
 }
 
-static void mapgen_simplex(mapgen_settings *settings)
+typedef struct {
+	float freq;
+	int octaves;
+	int low;
+	int high;
+	int stride;
+} mapgen_simplex_args;
+
+static void mapgen_simplex_row_job(void *context, int index)
 {
+	mapgen_simplex_args *args = (mapgen_simplex_args*)context;
 	int x, y;
 
-	float freq = settings->simplex_base_freq * (1.0f / _heightSize);
-	int octaves = settings->simplex_octaves;
+	y = index;
+	for (x = 0; x < _heightSize; x++) {
+		float noiseValue = clamp(-1.0f, fractal_noise(x, y, args->freq, args->octaves, 2.0f, 0.65f), 1.0f);
+		float normalisedNoiseValue = (noiseValue + 1.0f) / 2.0f;
+
+		set_height(x, y, args->low + (int)(normalisedNoiseValue * args->high));
+	}
+}
+
+static void mapgen_simplex(mapgen_settings *settings)
+{
+	mapgen_simplex_args args;
 
-	int low = settings->simplex_low;
-	int high = settings->simplex_high;
+	args.freq = settings->simplex_base_freq * (1.0f / _heightSize);
+	args.octaves = settings->simplex_octaves;
+	args.low = settings->simplex_low;
+	args.high = settings->simplex_high;
 
+	// The permutation table is read only once seeded and each row writes a
+	// disjoint slice of the height map, so rows can be evaluated in parallel.
 	noise_rand();
-	for (y = 0; y < _heightSize; y++) {
-		for (x = 0; x < _heightSize; x++) {
-			float noiseValue = clamp(-1.0f, fractal_noise(x, y, freq, octaves, 2.0f, 0.65f), 1.0f);
-			float normalisedNoiseValue = (noiseValue + 1.0f) / 2.0f;
+	worker_pool_run(mapgen_simplex_row_job, &args, _heightSize);
+}
 
-			set_height(x, y, low + (int)(normalisedNoiseValue * high));
-		}
+static void mapgen_simplex_strided_row_job(void *context, int index)
+{
+	mapgen_simplex_args *args = (mapgen_simplex_args*)context;
+	int x, y, xx, yy, height, stride;
+
+	stride = args->stride;
+	y = index * stride;
+	for (x = 0; x < _heightSize; x += stride) {
+		float noiseValue = clamp(-1.0f, fractal_noise(x, y, args->freq, args->octaves, 2.0f, 0.65f), 1.0f);
+		float normalisedNoiseValue = (noiseValue + 1.0f) / 2.0f;
+		height = args->low + (int)(normalisedNoiseValue * args->high);
+
+		for (yy = 0; yy < stride; yy++)
+			for (xx = 0; xx < stride; xx++)
+				set_height(x + xx, y + yy, height);
 	}
 }
 
+/**
+ * Evaluates the noise field at every stride-th cell and block fills the gaps;
+ * at a stride of one every cell gets its own sample, matching mapgen_simplex
+ * exactly. Assumes the permutation table has already been seeded so repeated
+ * calls refine the same field.
+ */
+static void mapgen_simplex_strided(mapgen_settings *settings, int stride)
+{
+	mapgen_simplex_args args;
+
+	args.freq = settings->simplex_base_freq * (1.0f / _heightSize);
+	args.octaves = settings->simplex_octaves;
+	args.low = settings->simplex_low;
+	args.high = settings->simplex_high;
+	args.stride = stride;
+
+	worker_pool_run(mapgen_simplex_strided_row_job, &args, (_heightSize + stride - 1) / stride);
+}
+
 #pragma endregion
\ No newline at end of file
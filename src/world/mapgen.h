@@ -42,5 +42,8 @@ typedef struct {
 void mapgen_generate_blank(mapgen_settings *settings);
 void mapgen_generate(mapgen_settings *settings);
 void mapgen_generate_custom_simplex(mapgen_settings *settings);
+void mapgen_generate_progressive(mapgen_settings *settings);
+int mapgen_progressive_update();
+void mapgen_progressive_cancel();
 
 #endif
\ No newline at end of file
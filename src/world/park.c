@@ -28,6 +28,7 @@
 #include "../management/news_item.h"
 #include "../management/research.h"
 #include "../peep/peep.h"
+#include "scenery.h"
 #include "../ride/ride.h"
 #include "../scenario.h"
 #include "../world/map.h"
@@ -85,6 +86,7 @@ void park_init()
 
 	for (i = 0; i < 56; i++)
 		RCT2_ADDRESS(0x01357BD0, sint32)[i] = -1;
+	init_scenery_invalidate();
 
 	RCT2_GLOBAL(RCT2_ADDRESS_PARK_ENTRANCE_FEE, money16) = MONEY(10, 00);
 	RCT2_GLOBAL(RCT2_ADDRESS_PEEP_SPAWNS, sint16) = -1;
@@ -125,6 +127,17 @@ void park_reset_history()
 	}
 }
 
+// Land ownership only changes through game commands (buy land, buy
+// construction rights, the editor's set-land-owned tool) or a map reset, so
+// between those the counted park size cannot change and the full map sweep
+// is skipped.
+static bool _parkSizeDirty = true;
+
+void park_size_invalidate()
+{
+	_parkSizeDirty = true;
+}
+
 /**
  * 
  *  rct2: 0x0066A348
@@ -132,17 +145,24 @@ void park_reset_history()
 int park_calculate_size()
 {
 	int tiles;
-	map_element_iterator it;
+	rct_map_element *element;
+	map_tile_span_iterator it;
+
+	if (!_parkSizeDirty)
+		return RCT2_GLOBAL(RCT2_ADDRESS_PARK_SIZE, sint16);
+	_parkSizeDirty = false;
 
 	tiles = 0;
-	map_element_iterator_begin(&it);
-	do {
-		if (map_element_get_type(it.element) == MAP_ELEMENT_TYPE_SURFACE) {
-			if (it.element->properties.surface.ownership & (OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED | OWNERSHIP_OWNED)) {
-				tiles++;
+	map_tile_span_iterator_begin(&it);
+	while (map_tile_span_iterator_next(&it)) {
+		for (element = it.first; element <= it.last; element++) {
+			if (map_element_get_type(element) == MAP_ELEMENT_TYPE_SURFACE) {
+				if (element->properties.surface.ownership & (OWNERSHIP_CONSTRUCTION_RIGHTS_OWNED | OWNERSHIP_OWNED)) {
+					tiles++;
+				}
 			}
 		}
-	} while (map_element_iterator_next(&it));
+	}
 
 	if (tiles != RCT2_GLOBAL(RCT2_ADDRESS_PARK_SIZE, sint16)) {
 		RCT2_GLOBAL(RCT2_ADDRESS_PARK_SIZE, sint16) = tiles;
@@ -168,24 +188,29 @@ int calculate_park_rating()
 	{
 		rct_peep* peep;
 		uint16 spriteIndex;
-		int num_happy_peeps;
+		int num_happy_peeps, num_lost_peeps;
 		short _bp;
-		
+
 		// -150 to +3 based on a range of guests from 0 to 2000
 		result -= 150 - (min(2000, RCT2_GLOBAL(RCT2_ADDRESS_GUESTS_IN_PARK, uint16)) / 13);
 
-		// Guests, happiness, ?
-		num_happy_peeps = 0;
-		_bp = 0;
-		FOR_ALL_GUESTS(spriteIndex, peep) {
-			if (peep->var_2A != 0)
-				continue;
-			if (peep->happiness > 128)
-				num_happy_peeps++;
-			if (!(peep->flags & PEEP_FLAGS_LEAVING_PARK))
-				continue;
-			if (peep->var_C6 <= 89)
-				_bp++;
+		// Guests, happiness, ?; the peep tick tallies these while it has
+		// the guests in cache, so only sweep them when that is stale
+		if (peep_rating_totals_get(&num_happy_peeps, &num_lost_peeps)) {
+			_bp = num_lost_peeps;
+		} else {
+			num_happy_peeps = 0;
+			_bp = 0;
+			FOR_ALL_GUESTS(spriteIndex, peep) {
+				if (peep->var_2A != 0)
+					continue;
+				if (peep->happiness > 128)
+					num_happy_peeps++;
+				if (!(peep->flags & PEEP_FLAGS_LEAVING_PARK))
+					continue;
+				if (peep->var_C6 <= 89)
+					_bp++;
+			}
 		}
 		
 		// Peep happiness -500 to +0
@@ -203,20 +228,28 @@ int calculate_park_rating()
 	// Rides
 	{
 		int i;
-		short total_ride_uptime = 0, total_ride_intensity = 0, total_ride_excitement = 0, average_intensity, average_excitement;
-		int num_rides, num_exciting_rides = 0;
+		int total_ride_uptime, total_ride_intensity, total_ride_excitement;
+		short average_intensity, average_excitement;
+		int num_rides, num_exciting_rides;
 		rct_ride* ride;
 
-		num_rides = 0;
-		FOR_ALL_RIDES(i, ride) {
-			total_ride_uptime += 100 - ride->downtime;
-
-			if (ride->excitement != -1){
-				total_ride_excitement += ride->excitement / 8;
-				total_ride_intensity += ride->intensity / 8;
-				num_exciting_rides++;
+		// ride_update_all keeps these totals while it walks the rides
+		if (!ride_rating_totals_get(&num_rides, &total_ride_uptime, &num_exciting_rides, &total_ride_excitement, &total_ride_intensity)) {
+			num_rides = 0;
+			num_exciting_rides = 0;
+			total_ride_uptime = 0;
+			total_ride_excitement = 0;
+			total_ride_intensity = 0;
+			FOR_ALL_RIDES(i, ride) {
+				total_ride_uptime += 100 - ride->downtime;
+
+				if (ride->excitement != -1){
+					total_ride_excitement += ride->excitement / 8;
+					total_ride_intensity += ride->intensity / 8;
+					num_exciting_rides++;
+				}
+				num_rides++;
 			}
-			num_rides++;
 		}
 		result -= 200;
 		if (num_rides > 0)
@@ -339,6 +372,104 @@ void reset_park_entrances()
 	RCT2_GLOBAL(0x013573F8, uint16) = 0xFFFF;
 }
 
+// Per-ride contributions to the guest generation appeal inputs (base guest
+// score, difficult-generation bonus score and ride value), kept so the totals
+// can be maintained incrementally instead of sweeping the ride table every
+// time the probability is recalculated. The C side ride events (status
+// changes, breakdowns and fixes, rating updates) refresh their ride's entry
+// directly; mutations that still happen in the original code (crashes, price
+// changes) are caught by a one-ride-per-tick round robin sweep, so the whole
+// table is reverified every 6.4 seconds without a bunched full scan.
+static uint16 _parkAppealSuggestedGuests[MAX_RIDES];
+static uint16 _parkAppealBonusGuests[MAX_RIDES];
+static sint32 _parkAppealRideValue[MAX_RIDES];
+static sint32 _parkAppealSuggestedGuestsTotal;
+static sint32 _parkAppealBonusGuestsTotal;
+static sint32 _parkAppealRideValueTotal;
+static bool _parkAppealDirty = true;
+static int _parkAppealSweepIndex = 0;
+
+void park_appeal_invalidate()
+{
+	_parkAppealDirty = true;
+}
+
+/**
+ * Recomputes one ride's appeal contributions and folds the difference into
+ * the running totals. The conditions mirror the original probability
+ * calculation's two ride sweeps exactly.
+ */
+void park_appeal_ride_update(int rideIndex)
+{
+	rct_ride *ride = GET_RIDE(rideIndex);
+	int suggestedGuests = 0, bonusGuests = 0, rideValue = 0;
+
+	if (_parkAppealDirty)
+		return;
+
+	if (ride->type != RIDE_TYPE_NULL &&
+		!(ride->lifecycle_flags & (RIDE_LIFECYCLE_BROKEN_DOWN | RIDE_LIFECYCLE_CRASHED))
+	) {
+		if (ride->status == RIDE_STATUS_OPEN) {
+			// Guest score for ride type
+			suggestedGuests = RCT2_GLOBAL(0x0097D21E + (ride->type * 8), uint8);
+
+			// Ride value
+			if (ride->value != RIDE_VALUE_UNDEFINED) {
+				int value = ride->value - ride->price;
+				if (value > 0)
+					rideValue = value * 2;
+			}
+		}
+
+		// Bonus guests for a good ride under difficult guest generation
+		if (ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_HAS_TRACK) &&
+			ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_HAS_DATA_LOGGING) &&
+			(ride->lifecycle_flags & RIDE_LIFECYCLE_TESTED) &&
+			ride->length[0] >= (600 << 16) &&
+			ride->excitement >= RIDE_RATING(6,00)
+		) {
+			bonusGuests = RCT2_GLOBAL(0x0097D21E + (ride->type * 8), uint8) * 2;
+		}
+	}
+
+	_parkAppealSuggestedGuestsTotal += suggestedGuests - _parkAppealSuggestedGuests[rideIndex];
+	_parkAppealBonusGuestsTotal += bonusGuests - _parkAppealBonusGuests[rideIndex];
+	_parkAppealRideValueTotal += rideValue - _parkAppealRideValue[rideIndex];
+	_parkAppealSuggestedGuests[rideIndex] = suggestedGuests;
+	_parkAppealBonusGuests[rideIndex] = bonusGuests;
+	_parkAppealRideValue[rideIndex] = rideValue;
+}
+
+static void park_appeal_rebuild()
+{
+	int i;
+
+	memset(_parkAppealSuggestedGuests, 0, sizeof(_parkAppealSuggestedGuests));
+	memset(_parkAppealBonusGuests, 0, sizeof(_parkAppealBonusGuests));
+	memset(_parkAppealRideValue, 0, sizeof(_parkAppealRideValue));
+	_parkAppealSuggestedGuestsTotal = 0;
+	_parkAppealBonusGuestsTotal = 0;
+	_parkAppealRideValueTotal = 0;
+	_parkAppealDirty = false;
+
+	for (i = 0; i < MAX_RIDES; i++)
+		park_appeal_ride_update(i);
+}
+
+/**
+ * Verifies one ride's cached appeal per tick, catching mutations made by
+ * code paths without an explicit park_appeal_ride_update call.
+ */
+static void park_appeal_sweep()
+{
+	if (_parkAppealDirty)
+		return;
+
+	park_appeal_ride_update(_parkAppealSweepIndex);
+	_parkAppealSweepIndex = (_parkAppealSweepIndex + 1) % MAX_RIDES;
+}
+
 /**
  * Calculates the probability of a new guest. Also sets total ride value and suggested guest maximum.
  * Total ride value should probably be set else where, as its not just used for guest generation.
@@ -350,53 +481,19 @@ static int park_calculate_guest_generation_probability()
 {
 	unsigned int probability;
 	int i, suggestedMaxGuests, totalRideValue;
-	rct_ride *ride;
-
-	// Calculate suggested guest maximum (based on ride type) and total ride value
-	suggestedMaxGuests = 0;
-	totalRideValue = 0;
-	FOR_ALL_RIDES(i, ride) {
-		if (ride->status != RIDE_STATUS_OPEN)
-			continue;
-		if (ride->lifecycle_flags & RIDE_LIFECYCLE_BROKEN_DOWN)
-			continue;
-		if (ride->lifecycle_flags & RIDE_LIFECYCLE_CRASHED)
-			continue;
 
-		// Add guest score for ride type
-		suggestedMaxGuests += RCT2_GLOBAL(0x0097D21E + (ride->type * 8), uint8);
+	if (_parkAppealDirty)
+		park_appeal_rebuild();
 
-		// Add ride value
-		if (ride->value != RIDE_VALUE_UNDEFINED) {
-			int rideValue = ride->value - ride->price;
-			if (rideValue > 0)
-				totalRideValue += rideValue * 2;
-		}
-	}
+	// Suggested guest maximum (based on ride type) and total ride value from
+	// the incrementally maintained per-ride contributions
+	suggestedMaxGuests = _parkAppealSuggestedGuestsTotal;
+	totalRideValue = _parkAppealRideValueTotal;
 
 	// If difficult guest generation, extra guests are available for good rides
 	if (RCT2_GLOBAL(RCT2_ADDRESS_PARK_FLAGS, uint32) & PARK_FLAGS_DIFFICULT_GUEST_GENERATION) {
 		suggestedMaxGuests = min(suggestedMaxGuests, 1000);
-		FOR_ALL_RIDES(i, ride) {
-			if (ride->lifecycle_flags & RIDE_LIFECYCLE_BROKEN_DOWN)
-				continue;
-			if (ride->lifecycle_flags & RIDE_LIFECYCLE_CRASHED)
-				continue;
-
-			if (!ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_HAS_TRACK))
-				continue;
-			if (!ride_type_has_flag(ride->type, RIDE_TYPE_FLAG_HAS_DATA_LOGGING))
-				continue;
-			if (!(ride->lifecycle_flags & RIDE_LIFECYCLE_TESTED))
-				continue;
-			if (ride->length[0] < (600 << 16))
-				continue;
-			if (ride->excitement < RIDE_RATING(6,00))
-				continue;
-
-			// Bonus guests for good ride
-			suggestedMaxGuests += RCT2_GLOBAL(0x0097D21E + (ride->type * 8), uint8) * 2;
-		}
+		suggestedMaxGuests += _parkAppealBonusGuestsTotal;
 	}
 
 	suggestedMaxGuests = min(suggestedMaxGuests, 65535);
@@ -529,6 +626,9 @@ void park_update()
 	if (RCT2_GLOBAL(RCT2_ADDRESS_SCREEN_FLAGS, uint8) & 0x0E)
 		return;
 
+	// Reverify one ride's cached appeal contribution per tick
+	park_appeal_sweep();
+
 	// Every 5 seconds approximately
 	if (RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint8) % 512 == 0) {
 		RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_PARK_RATING, uint16) = calculate_park_rating();
@@ -575,6 +675,7 @@ uint8 calculate_guest_initial_happiness(uint8 percentage) {
 void park_update_histories()
 {
 	RCT2_CALLPROC_EBPSAFE(0x0066A231);
+	finance_history_invalidate();
 }
 
 void park_set_entrance_fee(money32 value)
@@ -49,6 +49,9 @@ int park_is_open();
 void park_init();
 void park_reset_history();
 int park_calculate_size();
+void park_size_invalidate();
+void park_appeal_invalidate();
+void park_appeal_ride_update(int rideIndex);
 
 int calculate_park_rating();
 money32 calculate_park_value();
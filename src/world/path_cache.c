@@ -0,0 +1,91 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "path_cache.h"
+#include "path_heat.h"
+
+// Shared pathfinding result cache. Once one guest has worked out which way to
+// leave a path junction for a given goal, every other guest arriving at that
+// junction with the same goal can reuse the direction instead of repeating
+// the search.
+//
+// Entries are stamped with a generation number and any footpath edit bumps
+// the generation, which invalidates the entire cache in O(1). Connectivity
+// changes rarely compared to the thousands of lookups per tick a busy park
+// performs, and a full flush can never leave a stale direction behind after
+// the network changed.
+#define PATH_CACHE_SIZE 8192 // entries, power of two
+
+typedef struct {
+	uint32 position;
+	uint16 goal;
+	uint32 generation;
+	uint8 direction;
+} path_cache_entry;
+
+static path_cache_entry _pathCache[PATH_CACHE_SIZE];
+static uint32 _pathCacheGeneration = 1;
+
+static uint32 path_cache_position(int x, int y, int z)
+{
+	// x and y are world units, z is in small (8 unit) steps
+	return ((x >> 5) & 0xFF) | (((y >> 5) & 0xFF) << 8) | (((z >> 3) & 0xFF) << 16);
+}
+
+static path_cache_entry *path_cache_slot(uint32 position, uint16 goal)
+{
+	uint32 hash = (position ^ ((uint32)goal * 2654435761u)) * 2246822519u;
+	return &_pathCache[(hash >> 16) & (PATH_CACHE_SIZE - 1)];
+}
+
+bool path_cache_get(int x, int y, int z, uint16 goal, uint8 *outDirection)
+{
+	uint32 position = path_cache_position(x, y, z);
+	path_cache_entry *entry = path_cache_slot(position, goal);
+
+	if (entry->position != position || entry->goal != goal || entry->generation != _pathCacheGeneration) {
+		path_heat_record_lookup(x >> 5, y >> 5, false);
+		return false;
+	}
+
+	path_heat_record_lookup(x >> 5, y >> 5, true);
+	*outDirection = entry->direction;
+	return true;
+}
+
+void path_cache_set(int x, int y, int z, uint16 goal, uint8 direction)
+{
+	uint32 position = path_cache_position(x, y, z);
+	path_cache_entry *entry = path_cache_slot(position, goal);
+
+	entry->position = position;
+	entry->goal = goal;
+	entry->generation = _pathCacheGeneration;
+	entry->direction = direction;
+}
+
+/**
+ * Drops every cached result. Called whenever footpath construction or removal
+ * changes the path network.
+ */
+void path_cache_invalidate()
+{
+	_pathCacheGeneration++;
+}
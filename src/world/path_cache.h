@@ -0,0 +1,35 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef _PATH_CACHE_H_
+#define _PATH_CACHE_H_
+
+#include "../common.h"
+
+// Goal identifiers pack a ride index and entrance station so that guests
+// heading for the same entrance share cache entries.
+#define PATH_CACHE_GOAL(rideIndex, entranceIndex) (((rideIndex) << 3) | (entranceIndex))
+#define PATH_CACHE_GOAL_PARK_EXIT 0x7F8
+
+bool path_cache_get(int x, int y, int z, uint16 goal, uint8 *outDirection);
+void path_cache_set(int x, int y, int z, uint16 goal, uint8 direction);
+void path_cache_invalidate();
+
+#endif
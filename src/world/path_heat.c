@@ -0,0 +1,116 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "../addresses.h"
+#include "path_heat.h"
+
+// Per tile pathfinding cost counters backing the heat overlay
+// (VIEWPORT_FLAG_PATH_HEAT). Search expansions and shared cache misses are
+// accumulated per tile and halved on a fixed tick interval, so the overlay
+// shows where pathfinding is burning time now rather than since the park
+// loaded. Cache hits are counted but weigh nothing; a tile that answers
+// everything from the cache is exactly the cold colour we want to see.
+#define PATH_HEAT_DECAY_TICKS 2048
+
+static uint16 _pathHeatExpansions[256 * 256];
+static uint16 _pathHeatMisses[256 * 256];
+static uint32 _pathHeatLastDecay;
+
+static void path_heat_decay()
+{
+	uint32 ticks = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
+	int i;
+
+	if (ticks - _pathHeatLastDecay < PATH_HEAT_DECAY_TICKS)
+		return;
+	_pathHeatLastDecay = ticks;
+
+	for (i = 0; i < 256 * 256; i++) {
+		_pathHeatExpansions[i] >>= 1;
+		_pathHeatMisses[i] >>= 1;
+	}
+}
+
+/**
+ * Counts one tile visited by a pathfinding search. x and y are tile
+ * coordinates.
+ */
+void path_heat_record_expansion(int x, int y)
+{
+	uint16 *counter;
+
+	if (x < 0 || x >= 256 || y < 0 || y >= 256)
+		return;
+
+	path_heat_decay();
+	counter = &_pathHeatExpansions[(y * 256) + x];
+	if (*counter != 0xFFFF)
+		(*counter)++;
+}
+
+/**
+ * Counts one shared cache lookup at a junction tile. Only misses heat the
+ * tile; they are what a search has to be run for.
+ */
+void path_heat_record_lookup(int x, int y, bool hit)
+{
+	uint16 *counter;
+
+	if (hit || x < 0 || x >= 256 || y < 0 || y >= 256)
+		return;
+
+	path_heat_decay();
+	counter = &_pathHeatMisses[(y * 256) + x];
+	if (*counter != 0xFFFF)
+		(*counter)++;
+}
+
+/**
+ * Returns the remap colour the overlay should tint the path at the given tile
+ * coordinates with, or -1 for a tile with no recorded cost.
+ */
+int path_heat_tile_colour(int x, int y)
+{
+	int heat;
+
+	if (x < 0 || x >= 256 || y < 0 || y >= 256)
+		return -1;
+
+	// A miss costs a full search where an expansion is one step of one, so
+	// misses weigh heavier
+	heat = _pathHeatExpansions[(y * 256) + x] + (_pathHeatMisses[(y * 256) + x] * 4);
+	if (heat == 0)
+		return -1;
+
+	// Green through yellow and orange to red as the per tile cost grows
+	if (heat >= 96)
+		return 28; // bright red
+	if (heat >= 32)
+		return 21; // dark orange
+	if (heat >= 8)
+		return 18; // yellow
+	return 14; // bright green
+}
+
+void path_heat_reset()
+{
+	memset(_pathHeatExpansions, 0, sizeof(_pathHeatExpansions));
+	memset(_pathHeatMisses, 0, sizeof(_pathHeatMisses));
+}
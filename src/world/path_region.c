@@ -0,0 +1,307 @@
+/*****************************************************************************
+ * Copyright (c) 2014 Ted John
+ * OpenRCT2, an open source clone of Roller Coaster Tycoon 2.
+ *
+ * This file is part of OpenRCT2.
+ *
+ * OpenRCT2 is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#include "map.h"
+#include "path_heat.h"
+#include "path_region.h"
+
+// Hierarchical abstraction over the footpath network, sitting above the flat
+// per-junction result cache in path_cache.c. The map is carved into 8x8 tile
+// blocks and the path tiles within each block are grouped into connected
+// regions. Regions that touch across a block border form a coarse graph, so
+// a guest crossing the park can be steered region to region and only the
+// entry and exit regions ever need a tile level search.
+//
+// The graph is a guidance heuristic: a tile column with stacked paths is
+// represented by its first path element, so the graph can merge levels that
+// a bridge keeps apart. Routing answers are therefore advisory and the tile
+// level search stays authoritative; if the graph cannot answer (overflow,
+// unreachable goal) callers simply fall back to a full search.
+//
+// Rebuilds are lazy. Footpath edits bump a generation counter and the next
+// query reconstructs the graph, so a burst of construction costs one rebuild.
+
+#define PATH_REGION_BLOCK_SIZE 8
+#define PATH_REGION_MAX 4096
+#define PATH_REGION_MAX_NEIGHBOURS 12
+
+typedef struct {
+	uint16 neighbours[PATH_REGION_MAX_NEIGHBOURS];
+	uint8 numNeighbours;
+} path_region;
+
+static uint16 _pathRegionMap[256 * 256];
+static path_region _pathRegions[PATH_REGION_MAX];
+static int _numPathRegions;
+static bool _pathRegionOverflow;
+
+// Generation the built graph reflects (0 = never built) and the generation
+// the footpath network is currently on.
+static uint32 _pathRegionBuiltGeneration = 0;
+static uint32 _pathRegionGeneration = 1;
+
+// Distance field cache for the most recent routing goal. Guests share goals
+// (ride entrances, the park exit), so one field answers many queries.
+static uint16 _pathRegionGoal = PATH_REGION_NULL;
+static uint32 _pathRegionGoalGeneration;
+static uint16 _pathRegionDistance[PATH_REGION_MAX];
+
+static rct_map_element *path_region_get_path_element(int x, int y)
+{
+	rct_map_element *mapElement;
+
+	mapElement = map_get_first_element_at(x, y);
+	do {
+		if (map_element_get_type(mapElement) == MAP_ELEMENT_TYPE_PATH)
+			return mapElement;
+	} while (!map_element_is_last_for_tile(mapElement++));
+
+	return NULL;
+}
+
+static void path_region_add_neighbour(uint16 regionIndex, uint16 neighbourIndex)
+{
+	path_region *region = &_pathRegions[regionIndex];
+	int i;
+
+	for (i = 0; i < region->numNeighbours; i++)
+		if (region->neighbours[i] == neighbourIndex)
+			return;
+
+	if (region->numNeighbours == PATH_REGION_MAX_NEIGHBOURS) {
+		// A missing edge could route guests the long way round; disable the
+		// graph rather than hand out worse answers than the flat search.
+		_pathRegionOverflow = true;
+		return;
+	}
+	region->neighbours[region->numNeighbours++] = neighbourIndex;
+}
+
+/**
+ * Assigns every unassigned path tile in the given block to a region by
+ * flood filling along connected path edges, staying within the block.
+ */
+static void path_region_flood_block(int blockX, int blockY)
+{
+	uint16 stack[PATH_REGION_BLOCK_SIZE * PATH_REGION_BLOCK_SIZE];
+	int startX, startY, x, y, nextX, nextY, direction, stackSize;
+	uint16 regionIndex;
+	rct_map_element *mapElement;
+
+	for (startY = blockY; startY < blockY + PATH_REGION_BLOCK_SIZE; startY++) {
+		for (startX = blockX; startX < blockX + PATH_REGION_BLOCK_SIZE; startX++) {
+			if (_pathRegionMap[(startY * 256) + startX] != PATH_REGION_NULL)
+				continue;
+			if (path_region_get_path_element(startX, startY) == NULL)
+				continue;
+
+			if (_numPathRegions == PATH_REGION_MAX) {
+				_pathRegionOverflow = true;
+				return;
+			}
+			regionIndex = _numPathRegions++;
+			_pathRegions[regionIndex].numNeighbours = 0;
+
+			stack[0] = (startY * 256) + startX;
+			stackSize = 1;
+			_pathRegionMap[stack[0]] = regionIndex;
+			while (stackSize > 0) {
+				stackSize--;
+				x = stack[stackSize] & 0xFF;
+				y = stack[stackSize] >> 8;
+				path_heat_record_expansion(x, y);
+
+				mapElement = path_region_get_path_element(x, y);
+				for (direction = 0; direction < 4; direction++) {
+					if (!(mapElement->properties.path.edges & (1 << direction)))
+						continue;
+
+					nextX = x + (TileDirectionDelta[direction].x / 32);
+					nextY = y + (TileDirectionDelta[direction].y / 32);
+					if (nextX < blockX || nextX >= blockX + PATH_REGION_BLOCK_SIZE)
+						continue;
+					if (nextY < blockY || nextY >= blockY + PATH_REGION_BLOCK_SIZE)
+						continue;
+					if (_pathRegionMap[(nextY * 256) + nextX] != PATH_REGION_NULL)
+						continue;
+					if (path_region_get_path_element(nextX, nextY) == NULL)
+						continue;
+
+					_pathRegionMap[(nextY * 256) + nextX] = regionIndex;
+					stack[stackSize++] = (nextY * 256) + nextX;
+				}
+			}
+		}
+	}
+}
+
+static void path_region_rebuild()
+{
+	int x, y, nextX, nextY, direction;
+	uint16 regionIndex, neighbourIndex;
+	rct_map_element *mapElement;
+
+	memset(_pathRegionMap, 0xFF, sizeof(_pathRegionMap));
+	_numPathRegions = 0;
+	_pathRegionOverflow = false;
+	_pathRegionGoal = PATH_REGION_NULL;
+	_pathRegionBuiltGeneration = _pathRegionGeneration;
+
+	for (y = 0; y < 256; y += PATH_REGION_BLOCK_SIZE)
+		for (x = 0; x < 256; x += PATH_REGION_BLOCK_SIZE)
+			path_region_flood_block(x, y);
+
+	if (_pathRegionOverflow)
+		return;
+
+	// Connect regions that touch through a path edge. Only directions 1 and
+	// 2 need checking; the opposite directions are covered from the other
+	// tile and the edge is recorded both ways.
+	for (y = 0; y < 256; y++) {
+		for (x = 0; x < 256; x++) {
+			regionIndex = _pathRegionMap[(y * 256) + x];
+			if (regionIndex == PATH_REGION_NULL)
+				continue;
+
+			mapElement = path_region_get_path_element(x, y);
+			for (direction = 1; direction <= 2; direction++) {
+				if (!(mapElement->properties.path.edges & (1 << direction)))
+					continue;
+
+				nextX = x + (TileDirectionDelta[direction].x / 32);
+				nextY = y + (TileDirectionDelta[direction].y / 32);
+				if (nextX >= 256 || nextY >= 256)
+					continue;
+
+				neighbourIndex = _pathRegionMap[(nextY * 256) + nextX];
+				if (neighbourIndex == PATH_REGION_NULL || neighbourIndex == regionIndex)
+					continue;
+
+				path_region_add_neighbour(regionIndex, neighbourIndex);
+				path_region_add_neighbour(neighbourIndex, regionIndex);
+			}
+		}
+	}
+}
+
+/**
+ * Returns the region containing the path at the given tile coordinates, or
+ * PATH_REGION_NULL if there is no path there or the graph is unavailable.
+ */
+uint16 path_region_at(int x, int y)
+{
+	if (x < 0 || x >= 256 || y < 0 || y >= 256)
+		return PATH_REGION_NULL;
+
+	if (_pathRegionBuiltGeneration != _pathRegionGeneration)
+		path_region_rebuild();
+
+	if (_pathRegionOverflow)
+		return PATH_REGION_NULL;
+
+	return _pathRegionMap[(y * 256) + x];
+}
+
+/**
+ * Computes the distance in regions from every region to the goal region with
+ * a breadth first search over the region graph. The field is cached so that
+ * consecutive queries for the same goal only pay for the search once.
+ */
+static void path_region_compute_distances(uint16 goalRegion)
+{
+	uint16 queue[PATH_REGION_MAX];
+	int head, tail, i;
+	path_region *region;
+	uint16 regionIndex, neighbourIndex;
+
+	memset(_pathRegionDistance, 0xFF, _numPathRegions * sizeof(uint16));
+	_pathRegionDistance[goalRegion] = 0;
+	queue[0] = goalRegion;
+	head = 0;
+	tail = 1;
+	while (head < tail) {
+		regionIndex = queue[head++];
+		region = &_pathRegions[regionIndex];
+		for (i = 0; i < region->numNeighbours; i++) {
+			neighbourIndex = region->neighbours[i];
+			if (_pathRegionDistance[neighbourIndex] != 0xFFFF)
+				continue;
+
+			_pathRegionDistance[neighbourIndex] = _pathRegionDistance[regionIndex] + 1;
+			queue[tail++] = neighbourIndex;
+		}
+	}
+
+	_pathRegionGoal = goalRegion;
+	_pathRegionGoalGeneration = _pathRegionBuiltGeneration;
+}
+
+/**
+ * Picks the neighbouring region to move into next on the way from fromRegion
+ * to goalRegion. Returns false when the two regions are the same, the goal is
+ * unreachable or the graph is unavailable; callers then run a tile level
+ * search instead.
+ */
+bool path_region_route(uint16 fromRegion, uint16 goalRegion, uint16 *outNextRegion)
+{
+	path_region *region;
+	uint16 bestRegion, bestDistance;
+	int i;
+
+	if (_pathRegionBuiltGeneration != _pathRegionGeneration)
+		path_region_rebuild();
+
+	if (_pathRegionOverflow)
+		return false;
+	if (fromRegion >= _numPathRegions || goalRegion >= _numPathRegions)
+		return false;
+	if (fromRegion == goalRegion)
+		return false;
+
+	if (_pathRegionGoal != goalRegion || _pathRegionGoalGeneration != _pathRegionBuiltGeneration)
+		path_region_compute_distances(goalRegion);
+
+	if (_pathRegionDistance[fromRegion] == 0xFFFF)
+		return false;
+
+	region = &_pathRegions[fromRegion];
+	bestRegion = PATH_REGION_NULL;
+	bestDistance = _pathRegionDistance[fromRegion];
+	for (i = 0; i < region->numNeighbours; i++) {
+		if (_pathRegionDistance[region->neighbours[i]] < bestDistance) {
+			bestDistance = _pathRegionDistance[region->neighbours[i]];
+			bestRegion = region->neighbours[i];
+		}
+	}
+	if (bestRegion == PATH_REGION_NULL)
+		return false;
+
+	*outNextRegion = bestRegion;
+	return true;
+}
+
+/**
+ * Marks the region graph stale. Called whenever footpath construction or
+ * removal changes the path network; the rebuild happens on the next query.
+ */
+void path_region_invalidate()
+{
+	_pathRegionGeneration++;
+}
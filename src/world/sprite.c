@@ -20,10 +20,12 @@
 
 #include "../addresses.h"
 #include "../audio/audio.h"
+#include "../config.h"
 #include "../interface/viewport.h"
 #include "../localisation/date.h"
 #include "../localisation/localisation.h"
 #include "../scenario.h"
+#include "../util/rng.h"
 #include "fountain.h"
 #include "sprite.h"
 
@@ -37,6 +39,176 @@ enum {
 
 rct_sprite* g_sprite_list = RCT2_ADDRESS(RCT2_ADDRESS_SPRITE_LIST, rct_sprite);
 
+// Native spatial index over the sprite table. The original quadrant table at
+// 0x00F1EF60 threads linked lists through the sprites which the vanilla paint
+// code still reads, so that stays authoritative; this grid keeps contiguous
+// per-cell index arrays for native code so enumerating an area touches a few
+// cache lines instead of chasing pointers across the 10000 entry table.
+// Removals can still happen inside original code, so queries must skip
+// entries whose sprite no longer hashes to the cell (see
+// sprite_spatial_cell_get).
+#define SPATIAL_CELL_SHIFT 7 // 128 world unit cells
+#define SPATIAL_GRID_SIZE 64
+#define SPATIAL_CELL_NULL 0xFFFF
+
+static sprite_spatial_cell _spatialGrid[SPATIAL_GRID_SIZE * SPATIAL_GRID_SIZE];
+static uint16 _spriteSpatialCell[MAX_SPRITES];
+
+static int sprite_spatial_cell_index(int x, int y)
+{
+	if ((uint16)x == SPRITE_LOCATION_NULL)
+		return SPATIAL_CELL_NULL;
+	x = clamp(0, x >> SPATIAL_CELL_SHIFT, SPATIAL_GRID_SIZE - 1);
+	y = clamp(0, y >> SPATIAL_CELL_SHIFT, SPATIAL_GRID_SIZE - 1);
+	return (y * SPATIAL_GRID_SIZE) + x;
+}
+
+static void sprite_spatial_cell_remove(sprite_spatial_cell *cell, uint16 spriteIndex)
+{
+	int i;
+
+	for (i = 0; i < cell->count; i++) {
+		if (cell->indices[i] == spriteIndex) {
+			cell->indices[i] = cell->indices[--cell->count];
+			return;
+		}
+	}
+}
+
+static void sprite_spatial_cell_add(sprite_spatial_cell *cell, uint16 spriteIndex)
+{
+	if (cell->count == cell->capacity) {
+		cell->capacity = max(8, cell->capacity * 2);
+		cell->indices = realloc(cell->indices, cell->capacity * sizeof(uint16));
+	}
+	cell->indices[cell->count++] = spriteIndex;
+}
+
+static void sprite_spatial_index_move(rct_sprite *sprite, int newX, int newY)
+{
+	uint16 spriteIndex = sprite->unknown.sprite_index;
+	int newCell = sprite_spatial_cell_index(newX, newY);
+	int currentCell = _spriteSpatialCell[spriteIndex];
+
+	if (newCell == currentCell)
+		return;
+	if (currentCell != SPATIAL_CELL_NULL)
+		sprite_spatial_cell_remove(&_spatialGrid[currentCell], spriteIndex);
+	if (newCell != SPATIAL_CELL_NULL)
+		sprite_spatial_cell_add(&_spatialGrid[newCell], spriteIndex);
+	_spriteSpatialCell[spriteIndex] = newCell;
+}
+
+/**
+ * Rebuilds the spatial index from the sprite table, mirroring what
+ * reset_0x69EBE4 does for the original quadrant lists.
+ */
+void sprite_spatial_index_reset()
+{
+	int i;
+	rct_sprite *sprite;
+
+	for (i = 0; i < SPATIAL_GRID_SIZE * SPATIAL_GRID_SIZE; i++)
+		_spatialGrid[i].count = 0;
+	for (i = 0; i < MAX_SPRITES; i++)
+		_spriteSpatialCell[i] = SPATIAL_CELL_NULL;
+
+	for (i = 0; i < MAX_SPRITES; i++) {
+		sprite = &g_sprite_list[i];
+		if (sprite->unknown.sprite_identifier == 0xFF)
+			continue;
+		sprite_spatial_index_move(sprite, sprite->unknown.x, sprite->unknown.y);
+	}
+}
+
+/**
+ * Returns the contiguous sprite index array covering the 128x128 cell that
+ * contains (x, y). Callers must ignore entries whose sprite has since been
+ * removed or moved by original code paths (sprite_identifier of 0xFF or a
+ * position outside the cell).
+ */
+const sprite_spatial_cell *sprite_spatial_cell_get(int x, int y)
+{
+	static const sprite_spatial_cell emptyCell = { NULL, 0, 0 };
+	int cellIndex = sprite_spatial_cell_index(x, y);
+
+	if (cellIndex == SPATIAL_CELL_NULL)
+		return &emptyCell;
+	return &_spatialGrid[cellIndex];
+}
+
+// Shadow predecessor for each sprite's quadrant list entry. The quadrant
+// lists at 0xF1EF60 are singly linked, so unlinking a sprite normally means
+// walking its old quadrant from the head. Original code paths still relink
+// quadrants without maintaining this table, so an entry is only a hint and
+// must be verified against the live list before it is used.
+static uint16 _spritePrevInQuadrant[MAX_SPRITES];
+
+static int sprite_quadrant_index(int x, int y)
+{
+	if ((uint16)x == SPRITE_LOCATION_NULL)
+		return 0x10000;
+	return ((x & 0x1FE0) << 3) | (y >> 5);
+}
+
+static void sprite_quadrant_insert(rct_sprite *sprite, int quadrantIndex)
+{
+	uint16 *head = &RCT2_ADDRESS(0xF1EF60, uint16)[quadrantIndex];
+
+	sprite->unknown.next_in_quadrant = *head;
+	if (*head != SPRITE_INDEX_NULL)
+		_spritePrevInQuadrant[*head] = sprite->unknown.sprite_index;
+	_spritePrevInQuadrant[sprite->unknown.sprite_index] = SPRITE_INDEX_NULL;
+	*head = sprite->unknown.sprite_index;
+}
+
+static void sprite_quadrant_unlink(rct_sprite *sprite, int quadrantIndex)
+{
+	uint16 spriteIndex = sprite->unknown.sprite_index;
+	uint16 next = sprite->unknown.next_in_quadrant;
+	uint16 *head = &RCT2_ADDRESS(0xF1EF60, uint16)[quadrantIndex];
+	uint16 prev;
+	rct_sprite *prevSprite;
+
+	if (*head == spriteIndex) {
+		*head = next;
+		if (next != SPRITE_INDEX_NULL)
+			_spritePrevInQuadrant[next] = SPRITE_INDEX_NULL;
+		return;
+	}
+
+	// O(1) unlink when the shadow predecessor still holds. A stale hint can
+	// only pass these checks if it is an active sprite in the same quadrant
+	// whose link points at us, in which case it really is our predecessor.
+	prev = _spritePrevInQuadrant[spriteIndex];
+	if (prev != SPRITE_INDEX_NULL) {
+		prevSprite = &g_sprite_list[prev];
+		if (
+			prevSprite->unknown.sprite_identifier != 0xFF &&
+			prevSprite->unknown.next_in_quadrant == spriteIndex &&
+			sprite_quadrant_index(prevSprite->unknown.x, prevSprite->unknown.y) == quadrantIndex
+		) {
+			prevSprite->unknown.next_in_quadrant = next;
+			if (next != SPRITE_INDEX_NULL)
+				_spritePrevInQuadrant[next] = prev;
+			return;
+		}
+	}
+
+	// Hint was stale, fall back to walking the quadrant list and repair the
+	// shadow links on the way past.
+	prev = SPRITE_INDEX_NULL;
+	uint16 idx = *head;
+	while (idx != spriteIndex) {
+		_spritePrevInQuadrant[idx] = prev;
+		prev = idx;
+		idx = g_sprite_list[idx].unknown.next_in_quadrant;
+	}
+	g_sprite_list[prev].unknown.next_in_quadrant = next;
+	if (next != SPRITE_INDEX_NULL)
+		_spritePrevInQuadrant[next] = prev;
+}
+
 static void duck_update_fly_to_water(rct_duck *duck);
 static void duck_update_swim(rct_duck *duck);
 static void duck_update_drink(rct_duck *duck);
@@ -277,7 +449,10 @@ static void duck_update_swim(rct_duck *duck)
 	if ((RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32) + duck->var_0A) & 3)
 		return;
 
-	uint32 randomNumber = scenario_rand();
+	// Drawn from the misc sprite stream rather than the scenario RNG so the
+	// misc sprite update can move onto the worker pool without the ducks'
+	// draw order changing the values every other consumer sees
+	uint32 randomNumber = rng_stream_rand(RNG_STREAM_MISC_SPRITE, (uint32)((rct_sprite*)duck - g_sprite_list), 0);
 	if ((randomNumber & 0xFFFF) < 0x666) {
 		if (randomNumber & 0x80000000) {
 			duck->state = DUCK_STATE_DOUBLE_DRINK;
@@ -310,7 +485,7 @@ static void duck_update_swim(rct_duck *duck)
 	}
 
 	duck->z = waterZ;
-	randomNumber = scenario_rand();
+	randomNumber = rng_stream_rand(RNG_STREAM_MISC_SPRITE, (uint32)((rct_sprite*)duck - g_sprite_list), 1);
 	if ((randomNumber & 0xFFFF) <= 0xAAA) {
 		randomNumber >>= 16;
 		duck->sprite_direction = randomNumber & 0x18;
@@ -521,6 +696,92 @@ void money_effect_update(rct_money_effect *moneyEffect)
 	sprite_remove((rct_sprite*)moneyEffect);
 }
 
+// Sprites are numerous and spatially clustered - peeps crowd the same paths,
+// fountain drops share an arc - so invalidating them one by one makes the
+// per-sprite viewport walk and dirty block marking the dominant cost of
+// movement. While a sprite update pass runs, invalidations are instead
+// merged per map quadrant: every sprite that moved within a quadrant grows
+// that quadrant's view space rectangle, and the set is pushed through the
+// viewports once at the end of the pass. Thousands of per-sprite rectangle
+// walks collapse into a few hundred region operations.
+#define SPRITE_QUADRANT_DIRTY_SIZE 64 // slots, power of two
+
+typedef struct {
+	int quadrant;		// quadrant the rectangle covers, -1 when empty
+	sint16 left, top, right, bottom;
+} sprite_quadrant_dirty_entry;
+
+static bool _spriteInvalidateBatchActive;
+static sprite_quadrant_dirty_entry _spriteQuadrantDirty[SPRITE_QUADRANT_DIRTY_SIZE];
+
+static void invalidate_viewport_rect(sint16 spriteLeft, sint16 spriteTop, sint16 spriteRight, sint16 spriteBottom);
+
+static void sprite_invalidate_batch_flush()
+{
+	sprite_quadrant_dirty_entry *entry;
+	int i;
+
+	for (i = 0; i < SPRITE_QUADRANT_DIRTY_SIZE; i++) {
+		entry = &_spriteQuadrantDirty[i];
+		if (entry->quadrant == -1)
+			continue;
+
+		invalidate_viewport_rect(entry->left, entry->top, entry->right, entry->bottom);
+		entry->quadrant = -1;
+	}
+}
+
+static void sprite_invalidate_batch_add(int quadrant, sint16 left, sint16 top, sint16 right, sint16 bottom)
+{
+	sprite_quadrant_dirty_entry *entry;
+
+	// Direct mapped by quadrant; a collision flushes the previous
+	// quadrant's rectangle and claims the slot
+	entry = &_spriteQuadrantDirty[((quadrant >> 8) ^ quadrant) & (SPRITE_QUADRANT_DIRTY_SIZE - 1)];
+	if (entry->quadrant == quadrant) {
+		entry->left = min(entry->left, left);
+		entry->top = min(entry->top, top);
+		entry->right = max(entry->right, right);
+		entry->bottom = max(entry->bottom, bottom);
+		return;
+	}
+
+	if (entry->quadrant != -1)
+		invalidate_viewport_rect(entry->left, entry->top, entry->right, entry->bottom);
+
+	entry->quadrant = quadrant;
+	entry->left = left;
+	entry->top = top;
+	entry->right = right;
+	entry->bottom = bottom;
+}
+
+/**
+ * Starts merging sprite invalidations per map quadrant instead of pushing
+ * each one through the viewports; paired with sprite_invalidate_batch_end
+ * around a sprite update pass.
+ */
+void sprite_invalidate_batch_begin()
+{
+	int i;
+
+	if (_spriteInvalidateBatchActive)
+		return;
+
+	for (i = 0; i < SPRITE_QUADRANT_DIRTY_SIZE; i++)
+		_spriteQuadrantDirty[i].quadrant = -1;
+	_spriteInvalidateBatchActive = true;
+}
+
+void sprite_invalidate_batch_end()
+{
+	if (!_spriteInvalidateBatchActive)
+		return;
+
+	_spriteInvalidateBatchActive = false;
+	sprite_invalidate_batch_flush();
+}
+
 /*
  *
  * rct2: 0x006EC473
@@ -528,13 +789,37 @@ void money_effect_update(rct_money_effect *moneyEffect)
 void invalidate_sprite(rct_sprite* sprite){
 	if (sprite->unknown.sprite_left == (sint16)0x8000) return;
 
+	if (_spriteInvalidateBatchActive) {
+		sprite_invalidate_batch_add(
+			sprite_quadrant_index(sprite->unknown.x, sprite->unknown.y),
+			sprite->unknown.sprite_left,
+			sprite->unknown.sprite_top,
+			sprite->unknown.sprite_right,
+			sprite->unknown.sprite_bottom
+		);
+		return;
+	}
+
+	invalidate_viewport_rect(
+		sprite->unknown.sprite_left,
+		sprite->unknown.sprite_top,
+		sprite->unknown.sprite_right,
+		sprite->unknown.sprite_bottom
+	);
+}
+
+/**
+ * Marks the given view space rectangle dirty on every viewport it intersects.
+ */
+static void invalidate_viewport_rect(sint16 spriteLeft, sint16 spriteTop, sint16 spriteRight, sint16 spriteBottom)
+{
 	for (rct_viewport** viewport_p = RCT2_ADDRESS(RCT2_ADDRESS_ACTIVE_VIEWPORT_PTR_ARRAY, rct_viewport*); *viewport_p != NULL; viewport_p++){
 		rct_viewport* viewport = *viewport_p;
 		int left, right, top, bottom;
-		left = sprite->unknown.sprite_left;
-		right = sprite->unknown.sprite_right;
-		top = sprite->unknown.sprite_top;
-		bottom = sprite->unknown.sprite_bottom;
+		left = spriteLeft;
+		right = spriteRight;
+		top = spriteTop;
+		bottom = spriteBottom;
 
 		if (viewport->zoom >= 3)continue;
 		if (right <= viewport->view_x)continue;
@@ -562,7 +847,19 @@ void invalidate_sprite(rct_sprite* sprite){
 		right /= zoom;
 		bottom /= zoom;
 
-		gfx_set_dirty_blocks(left + viewport->x, top + viewport->y, right + viewport->x, bottom + viewport->y);
+		left += viewport->x;
+		top += viewport->y;
+		right += viewport->x;
+		bottom += viewport->y;
+
+		// Don't mark blocks dirty when the sprite is entirely hidden behind
+		// opaque windows, otherwise those windows get repainted every frame
+		// just because something moved underneath them.
+		rct_window *owner = window_get_viewport_owner(viewport);
+		if (owner != NULL && window_is_region_occluded(owner, left, top, right, bottom))
+			continue;
+
+		gfx_set_dirty_blocks(left, top, right, bottom);
 	}
 }
 
@@ -625,27 +922,36 @@ void reset_0x69EBE4(){
 	//RCT2_CALLPROC_EBPSAFE(0x0069EBE4);
 	//return;
 	memset((uint16*)0xF1EF60, -1, 0x10001*2);
+	memset(_spritePrevInQuadrant, -1, sizeof(_spritePrevInQuadrant));
 
 	rct_sprite* spr = g_sprite_list;
 	for (; spr < (rct_sprite*)RCT2_ADDRESS_SPRITES_NEXT_INDEX; spr++){
 
 		if (spr->unknown.sprite_identifier != 0xFF){
-			uint32 edi = spr->unknown.x;
-			if ((uint16)(spr->unknown.x) == SPRITE_LOCATION_NULL){
-				edi = 0x10000;
-			}
-			else{
-				int ecx = spr->unknown.y;
-				ecx >>= 5;
-				edi &= 0x1FE0;
-				edi <<= 3;
-				edi |= ecx;
-			}
-			uint16 ax = RCT2_ADDRESS(0xF1EF60,uint16)[edi];
-			RCT2_ADDRESS(0xF1EF60,uint16)[edi] = spr->unknown.sprite_index;
-			spr->unknown.next_in_quadrant = ax;
+			int edi = sprite_quadrant_index(spr->unknown.x, spr->unknown.y);
+			sprite_quadrant_insert(spr, edi);
 		}
 	}
+
+	sprite_spatial_index_reset();
+}
+
+/**
+ * Logs when the sprite table runs dry, at most once every 30 seconds of game
+ * time. Creation failing is otherwise silent (callers just get NULL), which
+ * makes exhaustion in big parks very hard to diagnose; the free entry count
+ * is also exported through the performance counters.
+ */
+static void sprite_warn_exhausted()
+{
+	static uint32 lastWarnTick = 0;
+	uint32 tick = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
+
+	if (lastWarnTick != 0 && tick - lastWarnTick < 1200)
+		return;
+
+	lastWarnTick = tick;
+	log_warning("sprite table exhausted (%d entries), no more entities can be created", MAX_SPRITES);
 }
 
 /*
@@ -662,6 +968,8 @@ rct_sprite *create_sprite(uint8 bl)
 		uint16 cx = 0x12C - RCT2_GLOBAL(0x13573CE, uint16);
 		if (cx >= RCT2_GLOBAL(0x13573C8, uint16))
 		{
+			// Misc sprites keep a headroom of free entries; running into it
+			// is routine (rain drops, crash particles) and not worth a log
 			return NULL;
 		}
 
@@ -669,6 +977,7 @@ rct_sprite *create_sprite(uint8 bl)
 	}
 	else if (RCT2_GLOBAL(0x13573C8, uint16) <= 0)
 	{
+		sprite_warn_exhausted();
 		return NULL;
 	}
 
@@ -686,8 +995,7 @@ rct_sprite *create_sprite(uint8 bl)
 	sprite->var_0C = 0;
 	sprite->sprite_left = SPRITE_LOCATION_NULL;
 
-	sprite->next_in_quadrant = RCT2_ADDRESS(0xF1EF60, uint16)[0x10000];
-	RCT2_ADDRESS(0xF1EF60, uint16)[0x10000] = sprite->sprite_index;
+	sprite_quadrant_insert((rct_sprite*)sprite, 0x10000);
 
 	return (rct_sprite*)sprite;
 }
@@ -782,6 +1090,77 @@ void sprite_misc_update(rct_sprite *sprite)
 	}
 }
 
+// Tail of the litter linked list. New litter is prepended to its list, so
+// the list is insertion ordered and the tail is always the oldest piece.
+// Caching it makes eviction O(1) instead of a walk over all litter.
+static uint16 _litterOldestIndex = SPRITE_INDEX_NULL;
+
+/**
+ * Limits the amount of litter on the map to the configured cap by removing
+ * the oldest pieces first. Keeping litter well below the size of the sprite
+ * table stops the original game's create path from degrading into full
+ * table searches when a big park fills up with rubbish.
+ */
+void litter_enforce_cap()
+{
+	rct_litter *litter;
+	uint16 spriteIndex;
+	int evictions;
+
+	if (gConfigGeneral.litter_cap == 0)
+		return;
+
+	// Spread mass evictions over several ticks
+	evictions = 4;
+	while (RCT2_GLOBAL(0x13573C8 + SPRITE_LINKEDLIST_OFFSET_LITTER, uint16) > gConfigGeneral.litter_cap) {
+		// Validate the cached tail; litter can be removed (sweeping,
+		// demolition) without coming through here
+		spriteIndex = _litterOldestIndex;
+		if (spriteIndex != SPRITE_INDEX_NULL) {
+			litter = &g_sprite_list[spriteIndex].litter;
+			if (litter->linked_list_type_offset != SPRITE_LINKEDLIST_OFFSET_LITTER || litter->next != SPRITE_INDEX_NULL)
+				spriteIndex = SPRITE_INDEX_NULL;
+		}
+
+		if (spriteIndex == SPRITE_INDEX_NULL) {
+			spriteIndex = RCT2_GLOBAL(RCT2_ADDRESS_SPRITES_NEXT_INDEX + SPRITE_LINKEDLIST_OFFSET_LITTER, uint16);
+			if (spriteIndex == SPRITE_INDEX_NULL)
+				break;
+			while (g_sprite_list[spriteIndex].litter.next != SPRITE_INDEX_NULL)
+				spriteIndex = g_sprite_list[spriteIndex].litter.next;
+		}
+
+		litter = &g_sprite_list[spriteIndex].litter;
+		_litterOldestIndex = litter->previous;
+		invalidate_sprite((rct_sprite*)litter);
+		sprite_remove((rct_sprite*)litter);
+
+		if (--evictions == 0)
+			break;
+	}
+}
+
+/**
+ * Returns whether any open viewport can currently see the sprite.
+ */
+static bool sprite_is_on_screen(rct_sprite *sprite)
+{
+	rct_viewport *viewport;
+
+	if (sprite->unknown.sprite_left == (sint16)0x8000)
+		return false;
+
+	for (rct_viewport** viewport_p = RCT2_ADDRESS(RCT2_ADDRESS_ACTIVE_VIEWPORT_PTR_ARRAY, rct_viewport*); *viewport_p != NULL; viewport_p++){
+		viewport = *viewport_p;
+		if (sprite->unknown.sprite_right <= viewport->view_x) continue;
+		if (sprite->unknown.sprite_bottom <= viewport->view_y) continue;
+		if (sprite->unknown.sprite_left >= viewport->view_x + viewport->view_width) continue;
+		if (sprite->unknown.sprite_top >= viewport->view_y + viewport->view_height) continue;
+		return true;
+	}
+	return false;
+}
+
 /**
  *
  *  rct: 0x00672AA4
@@ -790,13 +1169,32 @@ void sprite_misc_update_all()
 {
 	rct_sprite *sprite;
 	uint16 spriteIndex;
+	uint8 offscreenRate;
+	uint32 tick;
 
+	offscreenRate = gConfigGeneral.offscreen_misc_update_rate;
+	tick = RCT2_GLOBAL(RCT2_ADDRESS_CURRENT_TICKS, uint32);
+
+	sprite_invalidate_batch_begin();
 	spriteIndex = RCT2_GLOBAL(RCT2_ADDRESS_SPRITES_START_MISC, uint16);
 	while (spriteIndex != SPRITE_INDEX_NULL) {
 		sprite = &g_sprite_list[spriteIndex];
 		spriteIndex = sprite->unknown.next;
+
+		// Misc sprites are purely cosmetic, so the ones no open viewport can
+		// see may be stepped at a reduced rate. The sprite index spreads the
+		// updates so they do not all land on the same tick.
+		if (
+			offscreenRate > 1 &&
+			!sprite_is_on_screen(sprite) &&
+			((tick + sprite->unknown.sprite_index) % offscreenRate) != 0
+		) {
+			continue;
+		}
+
 		sprite_misc_update(sprite);
 	}
+	sprite_invalidate_batch_end();
 }
 
 /**
@@ -807,34 +1205,16 @@ void sprite_misc_update_all()
  * dx: z
  */
 void sprite_move(int x, int y, int z, rct_sprite* sprite){
-	int new_position = x;
-	if ((uint16)x == 0x8000)new_position = 0x10000;
-	else{
-		new_position &= 0x1FE0;
-		new_position = (y >> 5) | (new_position << 3);
-	}
-
-	int current_position = sprite->unknown.x;
-	if ((uint16)sprite->unknown.x == 0x8000)current_position = 0x10000;
-	else{
-		current_position &= 0x1FE0;
-		current_position = (sprite->unknown.y >> 5) | (current_position << 3);
-	}
+	int new_position = sprite_quadrant_index(x, y);
+	int current_position = sprite_quadrant_index(sprite->unknown.x, sprite->unknown.y);
 
 	if (new_position != current_position){
-		uint16* sprite_idx = &RCT2_ADDRESS(0xF1EF60, uint16)[current_position];
-		rct_sprite* sprite2 = &g_sprite_list[*sprite_idx];
-		while (sprite != sprite2){
-			sprite_idx = &sprite2->unknown.next_in_quadrant;
-			sprite2 = &g_sprite_list[*sprite_idx];
-		}
-		*sprite_idx = sprite->unknown.next_in_quadrant;
-
-		int temp_sprite_idx = RCT2_ADDRESS(0xF1EF60, uint16)[new_position];
-		RCT2_ADDRESS(0xF1EF60, uint16)[new_position] = sprite->unknown.sprite_index;
-		sprite->unknown.next_in_quadrant = temp_sprite_idx;
+		sprite_quadrant_unlink(sprite, current_position);
+		sprite_quadrant_insert(sprite, new_position);
 	}
 
+	sprite_spatial_index_move(sprite, x, y);
+
 	if (x == 0x8000){
 		sprite->unknown.sprite_left = 0x8000;
 		sprite->unknown.x = x;
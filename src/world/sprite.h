@@ -27,6 +27,11 @@
 
 #define SPRITE_INDEX_NULL    0xFFFF
 #define SPRITE_LOCATION_NULL 0x8000
+// The sprite table cannot be grown beyond this: it lives at a fixed address
+// inside the original exe's data segment, the exe addresses entries by uint16
+// index directly, and the whole table is serialized as part of the game data
+// chunk of the SV6 format. Raising the capacity has to wait until the entity
+// code no longer runs in the exe.
 #define MAX_SPRITES          10000
 
 enum SPRITE_IDENTIFIER{
@@ -234,6 +239,16 @@ enum {
 // rct2: 0x010E63BC
 extern rct_sprite* g_sprite_list;
 
+// Contiguous sprite indices for one cell of the native spatial index
+typedef struct {
+	uint16 *indices;
+	uint16 count;
+	uint16 capacity;
+} sprite_spatial_cell;
+
+void sprite_spatial_index_reset();
+const sprite_spatial_cell *sprite_spatial_cell_get(int x, int y);
+
 void create_balloon(int x, int y, int z, int colour, uint8 bl);
 void balloon_press(rct_balloon *balloon);
 void create_duck(int targetX, int targetY);
@@ -245,8 +260,11 @@ void reset_sprite_list();
 void reset_0x69EBE4();
 void move_sprite_to_list(rct_sprite *sprite, uint8 cl);
 void sprite_misc_update_all();
+void litter_enforce_cap();
 void sprite_move(int x, int y, int z, rct_sprite* sprite);
 void invalidate_sprite(rct_sprite *sprite);
+void sprite_invalidate_batch_begin();
+void sprite_invalidate_batch_end();
 void sub_6EC60B(rct_sprite* sprite);
 void sprite_remove(rct_sprite *sprite);
 